@@ -251,6 +251,8 @@ ComplexFunc dftN(ComplexFunc x, int N, int sign, const string &prefix) {
     return X;
 }
 
+}  // namespace
+
 ComplexFunc dft1d_c2c(ComplexFunc x, int N, int sign,
                       const string &prefix) {
     switch (N) {
@@ -267,6 +269,8 @@ ComplexFunc dft1d_c2c(ComplexFunc x, int N, int sign,
     }
 }
 
+namespace {
+
 // Map to remember previously computed twiddle factors.
 typedef std::map<int, ComplexFunc> TwiddleFactorSet;
 
@@ -478,6 +482,19 @@ std::pair<FuncType, FuncType> tiled_transpose(FuncType f, int max_tile_size,
 
 }  // namespace
 
+ComplexFunc fft_dim1(ComplexFunc x,
+                     const vector<int> &NR,
+                     int sign,
+                     int extent_0,
+                     Expr gain,
+                     bool parallel,
+                     const string &prefix,
+                     const Target &target) {
+    TwiddleFactorSet twiddle_cache;
+    return fft_dim1(x, NR, sign, extent_0, gain, parallel, prefix, target,
+                    &twiddle_cache);
+}
+
 ComplexFunc fft2d_c2c(ComplexFunc x,
                       vector<int> R0,
                       vector<int> R1,
@@ -1061,8 +1078,6 @@ Func fft2d_c2r(ComplexFunc c,
     return unzipped;
 }
 
-namespace {
-
 // Compute a factorization of N suitable for use in the FFT.
 vector<int> radix_factor(int N) {
     // Some special cases to optimize.
@@ -1097,8 +1112,6 @@ vector<int> radix_factor(int N) {
     return R;
 }
 
-}  // namespace
-
 ComplexFunc fft2d_c2c(ComplexFunc x,
                       int N0, int N1,
                       int sign,
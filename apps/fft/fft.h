@@ -38,6 +38,38 @@ struct Fft2dDesc {
     std::string name = "";
 };
 
+// Compute a factorization of N into the radices the kernels below implement
+// directly (8, 6, 4, 2, with a generic fallback for leftover factors). The
+// fft2d_* overloads taking N0, N1 use this factorization; it is exposed so
+// callers of the building blocks below can use the same pre-tuned
+// decompositions.
+std::vector<int> radix_factor(int N);
+
+// Compute the N point complex DFT of dimension 0 of x as a single fully
+// unrolled stage, using the specialized radix-2/4/6/8 butterflies where they
+// exist. sign = -1 indicates a forward DFT, sign = 1 an inverse DFT (without
+// normalization). This is the innermost building block of the FFTs below, and
+// can be used directly inside a larger fused pipeline when the transform size
+// is one radix kernel. prefix is prepended to the names of the Funcs defined.
+ComplexFunc dft1d_c2c(ComplexFunc x, int N, int sign,
+                      const std::string &prefix);
+
+// Compute the N point DFT of dimension 1 (columns) of x, where N is the
+// product of the radices NR, decomposed into one pass per radix with twiddle
+// factors applied between passes. The result is scheduled for target: columns
+// are transformed in vectorized groups of extent_0 columns, optionally
+// parallelized across groups. gain is folded into the first pass. This is the
+// per-dimension building block the 2D transforms below are composed from;
+// transpose between two calls to transform the rows instead.
+ComplexFunc fft_dim1(ComplexFunc x,
+                     const std::vector<int> &NR,
+                     int sign,
+                     int extent_0,
+                     Halide::Expr gain,
+                     bool parallel,
+                     const std::string &prefix,
+                     const Halide::Target &target);
+
 // Compute the N0 x N1 2D complex DFT of the first 2 dimensions of a complex
 // valued function x. The first 2 dimensions of x should be defined on at least
 // [0, N0) and [0, N1) for dimensions 0, 1, respectively. sign = -1 indicates a
@@ -50,6 +50,11 @@ void define_enums(py::module &m) {
         .value("GuardWithIf", PrefetchBoundStrategy::GuardWithIf)
         .value("NonFaulting", PrefetchBoundStrategy::NonFaulting);
 
+    py::enum_<PrefetchLocality>(m, "PrefetchLocality")
+        .value("NTA", PrefetchLocality::NTA)
+        .value("L2", PrefetchLocality::L2)
+        .value("L1", PrefetchLocality::L1);
+
     py::enum_<StmtOutputFormat>(m, "StmtOutputFormat")
         .value("Text", StmtOutputFormat::Text)
         .value("HTML", StmtOutputFormat::HTML);
@@ -57,6 +62,7 @@ void define_enums(py::module &m) {
     py::enum_<TailStrategy>(m, "TailStrategy")
         .value("RoundUp", TailStrategy::RoundUp)
         .value("GuardWithIf", TailStrategy::GuardWithIf)
+        .value("Predicate", TailStrategy::Predicate)
         .value("ShiftInwards", TailStrategy::ShiftInwards)
         .value("Auto", TailStrategy::Auto);
 
@@ -129,6 +135,7 @@ void define_enums(py::module &m) {
         .value("AVX512_Skylake", Target::Feature::AVX512_Skylake)
         .value("AVX512_Cannonlake", Target::Feature::AVX512_Cannonlake)
         .value("AVX512_SapphireRapids", Target::Feature::AVX512_SapphireRapids)
+        .value("AVX512_VNNI", Target::Feature::AVX512_VNNI)
         .value("TraceLoads", Target::Feature::TraceLoads)
         .value("TraceStores", Target::Feature::TraceStores)
         .value("TraceRealizations", Target::Feature::TraceRealizations)
@@ -149,8 +156,15 @@ void define_enums(py::module &m) {
         .value("SVE", Target::Feature::SVE)
         .value("SVE2", Target::Feature::SVE2)
         .value("ARMDotProd", Target::Feature::ARMDotProd)
+        .value("AVX512_FP16", Target::Feature::AVX512_FP16)
+        .value("ARMBf16", Target::Feature::ARMBf16)
         .value("LLVMLargeCodeModel", Target::Feature::LLVMLargeCodeModel)
         .value("RVV", Target::Feature::RVV)
+        .value("AsyncRoot", Target::Feature::AsyncRoot)
+        .value("ARMSME", Target::Feature::ARMSME)
+        .value("StripRuntime", Target::Feature::StripRuntime)
+        .value("Telemetry", Target::Feature::Telemetry)
+        .value("SpecializeStrides", Target::Feature::SpecializeStrides)
         .value("FeatureEnd", Target::Feature::FeatureEnd);
 
     py::enum_<halide_type_code_t>(m, "TypeCode")
@@ -204,12 +204,17 @@ void define_func(py::module &m) {
             .def("store_at", (Func & (Func::*)(LoopLevel)) & Func::store_at, py::arg("loop_level"))
 
             .def("async_", &Func::async)
+            .def("store_streaming", &Func::store_streaming)
+            .def("fuse_gpu_stages", &Func::fuse_gpu_stages)
+            .def("fuse_tuple_stores", &Func::fuse_tuple_stores)
+            .def("store_persistent", &Func::store_persistent)
             .def("memoize", &Func::memoize)
             .def("compute_inline", &Func::compute_inline)
             .def("compute_root", &Func::compute_root)
             .def("store_root", &Func::store_root)
 
-            .def("store_in", &Func::store_in, py::arg("memory_type"))
+            .def("store_in", (Func & (Func::*)(MemoryType)) & Func::store_in, py::arg("memory_type"))
+            .def("store_in", (Func & (Func::*)(MemoryType, int)) & Func::store_in, py::arg("memory_type"), py::arg("budget_bytes"))
 
             .def("compile_to", &Func::compile_to, py::arg("outputs"), py::arg("arguments"), py::arg("fn_name"), py::arg("target") = get_target_from_environment())
 
@@ -277,6 +282,8 @@ void define_func(py::module &m) {
 
             .def("define_extern", (void (Func::*)(const std::string &, const std::vector<ExternFuncArgument> &, Type, const std::vector<Var> &, NameMangling, DeviceAPI)) & Func::define_extern, py::arg("function_name"), py::arg("params"), py::arg("type"), py::arg("arguments"), py::arg("mangling") = NameMangling::Default, py::arg("device_api") = DeviceAPI::Host)
 
+            .def("async_extern", &Func::async_extern)
+
             .def("output_buffer", &Func::output_buffer)
             .def("output_buffers", &Func::output_buffers)
 
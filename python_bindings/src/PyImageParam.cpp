@@ -17,8 +17,10 @@ void define_image_param(py::module &m) {
             .def("set_min", &Dimension::set_min, py::arg("min"))
             .def("set_extent", &Dimension::set_extent, py::arg("extent"))
             .def("set_stride", &Dimension::set_stride, py::arg("stride"))
+            .def("set_stride_alignment", &Dimension::set_stride_alignment, py::arg("alignment"))
             .def("set_bounds", &Dimension::set_bounds, py::arg("min"), py::arg("extent"))
             .def("set_estimate", &Dimension::set_estimate, py::arg("min"), py::arg("extent"))
+            .def("set_hot_extents", &Dimension::set_hot_extents, py::arg("extents"))
             .def("dim", (Dimension(Dimension::*)(int)) & Dimension::dim, py::arg("dimension"), py::keep_alive<0, 1>());
 
     auto output_image_param_class =
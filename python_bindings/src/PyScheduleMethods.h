@@ -40,6 +40,12 @@ HALIDE_NEVER_INLINE void add_schedule_methods(PythonClass &class_instance) {
              py::arg("previous"), py::arg("outers"), py::arg("inners"), py::arg("factors"), py::arg("tail") = TailStrategy::Auto)
         .def("tile", (T & (T::*)(const std::vector<VarOrRVar> &, const std::vector<VarOrRVar> &, const std::vector<Expr> &, TailStrategy)) & T::tile,
              py::arg("previous"), py::arg("inners"), py::arg("factors"), py::arg("tail") = TailStrategy::Auto)
+        .def("tile_morton", &T::tile_morton,
+             py::arg("x"), py::arg("y"), py::arg("t"), py::arg("xi"), py::arg("yi"), py::arg("xfactor"), py::arg("yfactor"), py::arg("tail") = TailStrategy::Auto)
+        .def("register_tile", &T::register_tile,
+             py::arg("x"), py::arg("y"), py::arg("xi"), py::arg("yi"), py::arg("xfactor"), py::arg("yfactor"), py::arg("tail") = TailStrategy::Auto)
+        .def("transpose_tile", &T::transpose_tile,
+             py::arg("x"), py::arg("y"), py::arg("xi"), py::arg("yi"), py::arg("factor"), py::arg("tail") = TailStrategy::Auto)
         .def("reorder", (T & (T::*)(const std::vector<VarOrRVar> &)) & T::reorder, py::arg("vars"))
         .def("reorder", [](T &t, const py::args &args) -> T & {
             return t.reorder(args_to_vector<VarOrRVar>(args));
@@ -88,13 +94,21 @@ HALIDE_NEVER_INLINE void add_schedule_methods(PythonClass &class_instance) {
 
         .def("hexagon", &T::hexagon, py::arg("x") = Var::outermost())
 
-        .def("prefetch", (T & (T::*)(const Func &, const VarOrRVar &, Expr, PrefetchBoundStrategy)) & T::prefetch, py::arg("func"), py::arg("var"), py::arg("offset") = 1, py::arg("strategy") = PrefetchBoundStrategy::GuardWithIf)
+        .def("prefetch", (T & (T::*)(const Func &, const VarOrRVar &, Expr, PrefetchBoundStrategy, PrefetchLocality, bool)) & T::prefetch, py::arg("func"), py::arg("var"), py::arg("offset") = 1, py::arg("strategy") = PrefetchBoundStrategy::GuardWithIf, py::arg("locality") = PrefetchLocality::L1, py::arg("for_write") = false)
+        .def(
+            "prefetch", [](T &t, const ImageParam &image, const VarOrRVar &var, const Expr &offset, PrefetchBoundStrategy strategy, PrefetchLocality locality, bool for_write) -> T & {
+                // Templated function; specializing only on ImageParam for now
+                return t.prefetch(image, var, offset, strategy, locality, for_write);
+            },
+            py::arg("image"), py::arg("var"), py::arg("offset") = 1, py::arg("strategy") = PrefetchBoundStrategy::GuardWithIf, py::arg("locality") = PrefetchLocality::L1, py::arg("for_write") = false)
+
+        .def("prefetch_adaptive", (T & (T::*)(const Func &, const VarOrRVar &, Expr, PrefetchBoundStrategy, PrefetchLocality, bool)) & T::prefetch_adaptive, py::arg("func"), py::arg("var"), py::arg("initial_offset") = 1, py::arg("strategy") = PrefetchBoundStrategy::GuardWithIf, py::arg("locality") = PrefetchLocality::L1, py::arg("for_write") = false)
         .def(
-            "prefetch", [](T &t, const ImageParam &image, const VarOrRVar &var, const Expr &offset, PrefetchBoundStrategy strategy) -> T & {
+            "prefetch_adaptive", [](T &t, const ImageParam &image, const VarOrRVar &var, const Expr &initial_offset, PrefetchBoundStrategy strategy, PrefetchLocality locality, bool for_write) -> T & {
                 // Templated function; specializing only on ImageParam for now
-                return t.prefetch(image, var, offset, strategy);
+                return t.prefetch_adaptive(image, var, initial_offset, strategy, locality, for_write);
             },
-            py::arg("image"), py::arg("var"), py::arg("offset") = 1, py::arg("strategy") = PrefetchBoundStrategy::GuardWithIf)
+            py::arg("image"), py::arg("var"), py::arg("initial_offset") = 1, py::arg("strategy") = PrefetchBoundStrategy::GuardWithIf, py::arg("locality") = PrefetchLocality::L1, py::arg("for_write") = false)
 
         .def("source_location", &T::source_location);
 }
@@ -16,6 +16,9 @@ void define_stage(py::module &m) {
             .def("rfactor", (Func(Stage::*)(const RVar &, const Var &)) & Stage::rfactor,
                  py::arg("r"), py::arg("v"))
 
+            .def("parallel_reduce", &Stage::parallel_reduce,
+                 py::arg("r"), py::arg("v"), py::arg("num_tasks"))
+
             // These two variants of compute_with are specific to Stage
             .def("compute_with", (Stage & (Stage::*)(LoopLevel, const std::vector<std::pair<VarOrRVar, LoopAlignStrategy>> &)) & Stage::compute_with,
                  py::arg("loop_level"), py::arg("align"))
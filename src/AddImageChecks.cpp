@@ -1,4 +1,5 @@
 #include "AddImageChecks.h"
+#include "Debug.h"
 #include "ExternFuncArgument.h"
 #include "Function.h"
 #include "IRMutator.h"
@@ -764,5 +765,73 @@ Stmt add_image_checks(const Stmt &s,
     return injector.mutate(s);
 }
 
+namespace {
+
+class CollectChecks : public IRVisitor {
+    using IRVisitor::visit;
+
+    void visit(const AssertStmt *op) override {
+        IRVisitor::visit(op);
+        const Call *c = op->message.as<Call>();
+        if (!c || !starts_with(c->name, "halide_error")) {
+            return;
+        }
+        std::ostringstream key;
+        key << c->name << "(";
+        const char *sep = "";
+        for (const Expr &a : c->args) {
+            key << sep;
+            sep = ", ";
+            // Only the constant arguments: the computed ones are
+            // rewritten during lowering, but the buffer names and
+            // dimension numbers that identify a check are not.
+            if (const StringImm *s = a.as<StringImm>()) {
+                key << "\"" << s->value << "\"";
+            } else if (const IntImm *i = a.as<IntImm>()) {
+                key << i->value;
+            } else {
+                key << "_";
+            }
+        }
+        key << ")";
+        checks->emplace(key.str(), op->condition);
+    }
+
+public:
+    map<string, Expr> *checks;
+};
+
+}  // namespace
+
+void collect_injected_checks(const Stmt &s, map<string, Expr> *checks) {
+    CollectChecks collector;
+    collector.checks = checks;
+    s.accept(&collector);
+}
+
+void report_injected_checks(const map<string, Expr> &injected,
+                            const Stmt &final_stmt,
+                            const string &pipeline_name) {
+    map<string, Expr> remaining;
+    collect_injected_checks(final_stmt, &remaining);
+    size_t proved = 0;
+    for (const auto &p : injected) {
+        if (!remaining.count(p.first)) {
+            proved++;
+        }
+    }
+    debug(1) << "Checks injected for pipeline " << pipeline_name << ": "
+             << injected.size() << " total, "
+             << proved << " proved redundant at compile time, "
+             << (injected.size() - proved) << " remain in the generated code\n";
+    for (const auto &p : injected) {
+        if (remaining.count(p.first)) {
+            debug(1) << "  kept:   " << p.first << " checking " << p.second << "\n";
+        } else {
+            debug(1) << "  proved: " << p.first << "\n";
+        }
+    }
+}
+
 }  // namespace Internal
 }  // namespace Halide
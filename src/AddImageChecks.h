@@ -34,6 +34,20 @@ Stmt add_image_checks(const Stmt &s,
                       const FuncValueBounds &fb,
                       bool will_inject_host_copies);
 
+/** Collect the checks present in a statement, keyed on a rendering of
+ * the halide_error_* call they guard (the call name plus its constant
+ * arguments, which survive later lowering unchanged). The value is
+ * the condition checked. Used to report which injected checks the
+ * simplifier proved away during lowering. */
+void collect_injected_checks(const Stmt &s, std::map<std::string, Expr> *checks);
+
+/** Print (at debug level 1) each check that was injected during
+ * lowering, and whether it was proved redundant at compile time or
+ * survives into the generated code. */
+void report_injected_checks(const std::map<std::string, Expr> &injected,
+                            const Stmt &final_stmt,
+                            const std::string &pipeline_name);
+
 }  // namespace Internal
 }  // namespace Halide
 
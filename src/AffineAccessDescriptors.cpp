@@ -0,0 +1,198 @@
+#include "AffineAccessDescriptors.h"
+#include "IROperator.h"
+#include "IRVisitor.h"
+#include "Simplify.h"
+#include "Substitute.h"
+
+namespace Halide {
+namespace Internal {
+
+namespace {
+
+struct LoopVar {
+    std::string name;
+    Expr min;
+    Expr extent;
+};
+
+class ExtractAffineAccesses : public IRVisitor {
+    using IRVisitor::visit;
+
+    std::vector<LoopVar> loops;
+    std::vector<std::string> stages;
+
+    void visit(const For *op) override {
+        loops.push_back({op->name, op->min, op->extent});
+        IRVisitor::visit(op);
+        loops.pop_back();
+    }
+
+    void visit(const ProducerConsumer *op) override {
+        if (op->is_producer) {
+            stages.push_back(op->name);
+            IRVisitor::visit(op);
+            stages.pop_back();
+        } else {
+            IRVisitor::visit(op);
+        }
+    }
+
+    void visit(const Load *op) override {
+        IRVisitor::visit(op);
+        record(op->name, op->index, op->type, false);
+    }
+
+    void visit(const Store *op) override {
+        IRVisitor::visit(op);
+        record(op->name, op->index, op->value.type(), true);
+    }
+
+    void record(const std::string &buffer, const Expr &index, Type type, bool is_write) {
+        AffineAccessDescriptor d;
+        d.stage = stages.empty() ? std::string("<output>") : stages.back();
+        d.buffer = buffer;
+        d.is_write = is_write;
+        d.element_bytes = type.element_of().bytes();
+
+        Expr idx = index;
+        if (const Ramp *r = idx.as<Ramp>()) {
+            AffineAccessTerm lanes;
+            lanes.extent = r->lanes;
+            if (const int64_t *stride = as_const_int(r->stride)) {
+                lanes.stride_bytes = *stride * d.element_bytes;
+            }
+            d.terms.push_back(lanes);
+            idx = r->base;
+        } else if (const Broadcast *b = idx.as<Broadcast>()) {
+            AffineAccessTerm lanes;
+            lanes.extent = b->lanes;
+            lanes.stride_bytes = 0;
+            d.terms.push_back(lanes);
+            idx = b->value;
+        } else if (idx.type().is_vector()) {
+            // A gather/scatter or shuffled access; describe the lanes
+            // as a term of unknown stride so consumers know a
+            // descriptor-driven engine can't express it.
+            AffineAccessTerm lanes;
+            lanes.extent = idx.type().lanes();
+            d.terms.push_back(lanes);
+            for (int i = (int)loops.size() - 1; i >= 0; i--) {
+                AffineAccessTerm t;
+                if (const int64_t *e = as_const_int(loops[i].extent)) {
+                    t.extent = *e;
+                }
+                d.terms.push_back(t);
+            }
+            add(d);
+            return;
+        }
+
+        // The per-loop stride is the finite difference of the index
+        // with respect to the loop variable; for an affine index it
+        // simplifies to a constant.
+        Expr base = idx;
+        for (int i = (int)loops.size() - 1; i >= 0; i--) {
+            const LoopVar &l = loops[i];
+            Expr v = Variable::make(Int(32), l.name);
+            Expr diff = simplify(substitute(l.name, v + 1, idx) - idx);
+            const int64_t *stride = as_const_int(diff);
+            if (stride && *stride == 0) {
+                // The address doesn't vary with this loop; the
+                // engine doesn't need a term for it.
+            } else {
+                AffineAccessTerm t;
+                if (stride) {
+                    t.stride_bytes = *stride * d.element_bytes;
+                }
+                if (const int64_t *e = as_const_int(simplify(l.extent))) {
+                    t.extent = *e;
+                }
+                d.terms.push_back(t);
+            }
+            // Loop mins may refer to outer loop variables, so reduce
+            // the base innermost-first.
+            base = substitute(l.name, l.min, base);
+        }
+        if (const int64_t *b = as_const_int(simplify(base))) {
+            d.base_bytes = *b * d.element_bytes;
+        }
+        add(d);
+    }
+
+    bool same(const AffineAccessDescriptor &a, const AffineAccessDescriptor &b) const {
+        if (a.stage != b.stage ||
+            a.buffer != b.buffer ||
+            a.is_write != b.is_write ||
+            a.element_bytes != b.element_bytes ||
+            a.base_bytes != b.base_bytes ||
+            a.terms.size() != b.terms.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < a.terms.size(); i++) {
+            if (a.terms[i].stride_bytes != b.terms[i].stride_bytes ||
+                a.terms[i].extent != b.terms[i].extent) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void add(const AffineAccessDescriptor &d) {
+        for (const AffineAccessDescriptor &existing : result) {
+            if (same(existing, d)) {
+                return;
+            }
+        }
+        result.push_back(d);
+    }
+
+public:
+    std::vector<AffineAccessDescriptor> result;
+};
+
+}  // namespace
+
+std::vector<AffineAccessDescriptor> extract_affine_access_descriptors(const Stmt &body) {
+    // Flattened indices typically refer to let-bound strides and
+    // mins; inline them so the finite differences can fold.
+    Stmt s = substitute_in_all_lets(body);
+    ExtractAffineAccesses extractor;
+    s.accept(&extractor);
+    return extractor.result;
+}
+
+void write_affine_access_descriptors(std::ostream &out, const std::string &fn_name,
+                                     const std::vector<AffineAccessDescriptor> &descriptors) {
+    out << "// Affine access descriptors for the Halide pipeline " << fn_name << ".\n"
+        << "// One entry per distinct load or store of each buffer; strides and\n"
+        << "// bases are in bytes, innermost term first, -1 where not a\n"
+        << "// compile-time constant. Regenerate this file when the schedule\n"
+        << "// changes rather than editing it.\n"
+        << "\n"
+        << "#include \"HalideRuntime.h\"\n"
+        << "\n"
+        << "static const struct halide_affine_access_descriptor_t " << fn_name << "_access_descriptors[] = {\n";
+    for (const AffineAccessDescriptor &d : descriptors) {
+        out << "    {\"" << d.stage << "\", \"" << d.buffer << "\", "
+            << "/*is_write*/ " << (d.is_write ? 1 : 0) << ", "
+            << "/*element_bytes*/ " << d.element_bytes << ", "
+            << "/*dimensions*/ " << d.terms.size() << ", "
+            << "/*base*/ " << d.base_bytes << ",\n"
+            << "     {";
+        for (size_t i = 0; i < d.terms.size(); i++) {
+            out << (i > 0 ? ", " : "") << d.terms[i].stride_bytes;
+        }
+        out << "}, {";
+        for (size_t i = 0; i < d.terms.size(); i++) {
+            out << (i > 0 ? ", " : "") << d.terms[i].extent;
+        }
+        out << "}},\n";
+    }
+    out << "};\n"
+        << "\n"
+        << "static const int32_t " << fn_name << "_access_descriptor_count = "
+        << descriptors.size() << ";\n";
+}
+
+}  // namespace Internal
+}  // namespace Halide
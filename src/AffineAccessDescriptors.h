@@ -0,0 +1,59 @@
+#ifndef HALIDE_AFFINE_ACCESS_DESCRIPTORS_H
+#define HALIDE_AFFINE_ACCESS_DESCRIPTORS_H
+
+/** \file
+ *
+ * Defines the analysis that extracts affine access descriptors from a
+ * lowered pipeline, for programming DMA and prefetch engines from the
+ * schedule instead of from hand-maintained tables.
+ */
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Expr.h"
+
+namespace Halide {
+namespace Internal {
+
+/** One loop of an affine access: the distance in bytes between the
+ * addresses touched by consecutive iterations, and the trip count.
+ * Either is -1 if it is not a compile-time constant. */
+struct AffineAccessTerm {
+    int64_t stride_bytes = -1;
+    int64_t extent = -1;
+};
+
+/** The affine access pattern of one load or store in a lowered
+ * pipeline: the buffer touched, the stage touching it, the constant
+ * byte offset of the first element (or -1 if symbolic), and one term
+ * per enclosing loop the address varies with, innermost first.
+ * Vector accesses contribute a term for the lanes. */
+struct AffineAccessDescriptor {
+    std::string stage;
+    std::string buffer;
+    bool is_write = false;
+    int element_bytes = 0;
+    int64_t base_bytes = -1;
+    std::vector<AffineAccessTerm> terms;
+};
+
+/** Walk a fully-lowered pipeline body and describe every distinct
+ * load and store of each buffer as an affine function of the
+ * enclosing loop variables. Accesses whose address is not affine in
+ * some loop get a -1 stride for that loop, so consumers can tell
+ * exactly which patterns a descriptor-driven engine can handle. */
+std::vector<AffineAccessDescriptor> extract_affine_access_descriptors(const Stmt &body);
+
+/** Write descriptors as a C table of halide_affine_access_descriptor_t
+ * (see HalideRuntime.h), named after the pipeline, suitable for
+ * inclusion in code that programs a DMA or prefetch engine. */
+void write_affine_access_descriptors(std::ostream &out, const std::string &fn_name,
+                                     const std::vector<AffineAccessDescriptor> &descriptors);
+
+}  // namespace Internal
+}  // namespace Halide
+
+#endif
@@ -11,6 +11,21 @@ using std::map;
 using std::string;
 using std::vector;
 
+namespace {
+
+// Gather the even-indexed bits of e (bit 0, bit 2, bit 4, ...) into
+// the low half of the result.
+Expr compact_even_bits(Expr e) {
+    e = e & 0x55555555;
+    e = (e | (e >> 1)) & 0x33333333;
+    e = (e | (e >> 2)) & 0x0f0f0f0f;
+    e = (e | (e >> 4)) & 0x00ff00ff;
+    e = (e | (e >> 8)) & 0x0000ffff;
+    return e;
+}
+
+}  // namespace
+
 vector<ApplySplitResult> apply_split(const Split &split, bool is_update, const string &prefix,
                                      map<string, Expr> &dim_extent_alignment) {
     vector<ApplySplitResult> result;
@@ -49,7 +64,8 @@ vector<ApplySplitResult> apply_split(const Split &split, bool is_update, const s
         } else if (is_const_one(split.factor)) {
             // The split factor trivially divides the old extent,
             // but we know nothing new about the outer dimension.
-        } else if (tail == TailStrategy::GuardWithIf) {
+        } else if (tail == TailStrategy::GuardWithIf ||
+                   tail == TailStrategy::Predicate) {
             // It's an exact split but we failed to prove that the
             // extent divides the factor. Use predication to avoid
             // running off the end of the original loop.
@@ -68,8 +84,16 @@ vector<ApplySplitResult> apply_split(const Split &split, bool is_update, const s
             result.emplace_back(guarded_var_name, guarded, ApplySplitResult::LetStmt);
 
             // Inject the if condition *after* doing the substitution
-            // for the guarded version.
-            Expr cond = likely(old_var <= old_max);
+            // for the guarded version. For GuardWithIf the condition
+            // is marked likely, which makes loop partitioning peel
+            // the tail off into an epilogue. For Predicate it is left
+            // unmarked, so the loop is not partitioned and the
+            // vectorizer instead folds the guard into predicated
+            // loads and stores.
+            Expr cond = old_var <= old_max;
+            if (tail == TailStrategy::GuardWithIf) {
+                cond = likely(cond);
+            }
             result.emplace_back(cond);
 
         } else if (tail == TailStrategy::ShiftInwards) {
@@ -89,6 +113,45 @@ vector<ApplySplitResult> apply_split(const Split &split, bool is_update, const s
         result.emplace_back(old_var_name, base_var + inner, ApplySplitResult::LetStmt);
         result.emplace_back(base_name, base, ApplySplitResult::LetStmt);
 
+    } else if (split.is_morton_fuse()) {
+        // Define the inner and outer in terms of the fused var by
+        // deinterleaving its bits, so that the fused loop traverses
+        // the inner/outer space along a Morton (Z-order) curve. The
+        // curve covers the power-of-two bounding box of the original
+        // bounds, so guard against the iterations that fall outside
+        // them, in the same way as a GuardWithIf split above.
+        Expr fused = Variable::make(Int(32), prefix + split.old_var);
+        Expr inner_min = Variable::make(Int(32), prefix + split.inner + ".loop_min");
+        Expr outer_min = Variable::make(Int(32), prefix + split.outer + ".loop_min");
+        Expr inner_max = Variable::make(Int(32), prefix + split.inner + ".loop_max");
+        Expr outer_max = Variable::make(Int(32), prefix + split.outer + ".loop_max");
+
+        Expr inner = compact_even_bits(fused) + inner_min;
+        Expr outer = compact_even_bits(fused >> 1) + outer_min;
+
+        string inner_name = prefix + split.inner;
+        string outer_name = prefix + split.outer;
+        Expr inner_var = Variable::make(Int(32), inner_name);
+        Expr outer_var = Variable::make(Int(32), outer_name);
+
+        // Tell bounds inference that the deinterleaved vars stay
+        // within the original bounds, which it can't deduce from the
+        // bit manipulation above.
+        string guarded_inner_name = inner_name + ".guarded";
+        string guarded_outer_name = outer_name + ".guarded";
+        result.emplace_back(inner_name, Variable::make(Int(32), guarded_inner_name), ApplySplitResult::Substitution);
+        result.emplace_back(outer_name, Variable::make(Int(32), guarded_outer_name), ApplySplitResult::Substitution);
+        result.emplace_back(guarded_inner_name, promise_clamped(inner_var, inner_min, inner_max), ApplySplitResult::LetStmt);
+        result.emplace_back(guarded_outer_name, promise_clamped(outer_var, outer_min, outer_max), ApplySplitResult::LetStmt);
+
+        // Inject the if conditions *after* doing the substitutions
+        // for the guarded versions.
+        result.emplace_back(likely(inner_var <= inner_max));
+        result.emplace_back(likely(outer_var <= outer_max));
+
+        result.emplace_back(inner_name, inner, ApplySplitResult::LetStmt);
+        result.emplace_back(outer_name, outer, ApplySplitResult::LetStmt);
+
     } else if (split.is_fuse()) {
         // Define the inner and outer in terms of the fused var
         Expr fused = Variable::make(Int(32), prefix + split.old_var);
@@ -141,6 +204,21 @@ vector<std::pair<string, Expr>> compute_loop_bounds_after_split(const Split &spl
         let_stmts.emplace_back(prefix + split.outer + ".loop_min", 0);
         let_stmts.emplace_back(prefix + split.outer + ".loop_max", outer_extent - 1);
         let_stmts.emplace_back(prefix + split.outer + ".loop_extent", outer_extent);
+    } else if (split.is_morton_fuse()) {
+        // The Morton curve traverses the power-of-two bounding box of
+        // the inner/outer space, so round each extent up to a power
+        // of two. The iterations that land outside the original
+        // bounds are skipped by the predicates injected in
+        // apply_split.
+        Expr inner_extent = Variable::make(Int(32), prefix + split.inner + ".loop_extent");
+        Expr outer_extent = Variable::make(Int(32), prefix + split.outer + ".loop_extent");
+        auto round_up_to_power_of_two = [](const Expr &e) {
+            return 1 << (32 - count_leading_zeros(max(e, 1) - 1));
+        };
+        Expr fused_extent = round_up_to_power_of_two(inner_extent) * round_up_to_power_of_two(outer_extent);
+        let_stmts.emplace_back(prefix + split.old_var + ".loop_min", 0);
+        let_stmts.emplace_back(prefix + split.old_var + ".loop_max", fused_extent - 1);
+        let_stmts.emplace_back(prefix + split.old_var + ".loop_extent", fused_extent);
     } else if (split.is_fuse()) {
         // Define bounds on the fused var using the bounds on the inner and outer
         Expr inner_extent = Variable::make(Int(32), prefix + split.inner + ".loop_extent");
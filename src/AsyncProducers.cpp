@@ -106,9 +106,40 @@ protected:
     }
 };
 
+// Point an asynchronous extern stage's trailing completion-semaphore
+// argument (a null placeholder until now) at the given semaphore, so
+// that the extern stage itself signals its consumers when the output
+// is ready.
+class SetExternCompletionSemaphore : public IRMutator {
+    using IRMutator::visit;
+
+    const string &extern_name;
+    Expr sema;
+
+    Expr visit(const Call *op) override {
+        if (op->name == extern_name &&
+            (op->call_type == Call::Extern ||
+             op->call_type == Call::ExternCPlusPlus)) {
+            vector<Expr> args = op->args;
+            internal_assert(!args.empty());
+            args.back() = sema;
+            return Call::make(op->type, op->name, args, op->call_type,
+                              op->func, op->value_index, op->image, op->param);
+        }
+        return IRMutator::visit(op);
+    }
+
+public:
+    SetExternCompletionSemaphore(const string &e, const Expr &s)
+        : extern_name(e), sema(s) {
+    }
+};
+
 class GenerateProducerBody : public NoOpCollapsingMutator {
     const string &func;
     vector<Expr> sema;
+    string extern_name;
+    Expr extern_completion;
 
     using NoOpCollapsingMutator::visit;
 
@@ -118,6 +149,13 @@ class GenerateProducerBody : public NoOpCollapsingMutator {
             // Add post-synchronization
             internal_assert(!sema.empty()) << "Duplicate produce node: " << op->name << "\n";
             Stmt body = op->body;
+            if (extern_completion.defined()) {
+                // The extern stage releases the completion semaphore
+                // from wherever its asynchronous work finishes, so
+                // the producer task just initiates it and returns.
+                body = SetExternCompletionSemaphore(extern_name, extern_completion).mutate(body);
+                sema.clear();
+            }
             while (!sema.empty()) {
                 Expr release = Call::make(Int(32), "halide_semaphore_release", {sema.back(), 1}, Call::Extern);
                 body = Block::make(body, Evaluate::make(release));
@@ -196,8 +234,9 @@ class GenerateProducerBody : public NoOpCollapsingMutator {
     set<string> inner_semaphores;
 
 public:
-    GenerateProducerBody(const string &f, const vector<Expr> &s, map<string, vector<string>> &a)
-        : func(f), sema(s), cloned_acquires(a) {
+    GenerateProducerBody(const string &f, const vector<Expr> &s, map<string, vector<string>> &a,
+                         const string &e = "", const Expr &completion = Expr())
+        : func(f), sema(s), extern_name(e), extern_completion(completion), cloned_acquires(a) {
     }
 };
 
@@ -306,6 +345,221 @@ public:
     int count = 0;
 };
 
+// Expand the storage of a Func scheduled with ring_buffer() along its
+// outermost storage dimension, and rotate successive productions
+// through the copies. A credit semaphore initialized to the depth of
+// the ring buffer lets an async producer run that many iterations
+// ahead of its consumer before blocking. The semaphore is named like a
+// storage-folding semaphore so that ForkAsyncProducers places the
+// acquires on the producer side of the fork and the releases on the
+// consumer side.
+class InjectRingBuffering : public IRMutator {
+    using IRMutator::visit;
+
+    const map<string, Function> &env;
+
+    // Rewrite accesses to the given func to land in a particular copy
+    // of its storage.
+    class SelectSlot : public IRMutator {
+        using IRMutator::visit;
+
+        const string &func;
+        int dim;
+        Expr offset;  // The slot times the unexpanded extent of dim
+
+        Expr visit(const Call *op) override {
+            Expr expr = IRMutator::visit(op);
+            op = expr.as<Call>();
+            internal_assert(op);
+            if (op->name == func && op->call_type == Call::Halide) {
+                vector<Expr> args = op->args;
+                internal_assert(dim < (int)args.size());
+                args[dim] = args[dim] + offset;
+                expr = Call::make(op->type, op->name, args, op->call_type,
+                                  op->func, op->value_index, op->image, op->param);
+            } else if (op->name == Call::buffer_crop) {
+                Expr source = op->args[2];
+                const Variable *buf_var = source.as<Variable>();
+                if (buf_var &&
+                    starts_with(buf_var->name, func + ".") &&
+                    ends_with(buf_var->name, ".buffer")) {
+                    // An extern stage is taking a crop of the
+                    // buffer. Move the crop into the current slot,
+                    // then restore the logical coordinates afterwards
+                    // so that the extern stage is oblivious to the
+                    // ring buffering.
+                    internal_assert(op->args.size() >= 5);
+                    const Call *mins_call = op->args[3].as<Call>();
+                    const Call *extents_call = op->args[4].as<Call>();
+                    internal_assert(mins_call && extents_call);
+                    vector<Expr> mins = mins_call->args;
+                    const vector<Expr> &extents = extents_call->args;
+                    internal_assert(dim < (int)mins.size() && dim < (int)extents.size());
+                    Expr old_min = mins[dim];
+                    Expr old_extent = extents[dim];
+                    mins[dim] = mins[dim] + offset;
+                    Expr new_mins = Call::make(type_of<int *>(), Call::make_struct, mins, Call::Intrinsic);
+                    vector<Expr> new_args = op->args;
+                    new_args[3] = new_mins;
+                    expr = Call::make(op->type, op->name, new_args, op->call_type);
+                    expr = Call::make(op->type, Call::buffer_set_bounds,
+                                      {expr, dim, old_min, old_extent}, Call::Extern);
+                }
+            }
+            return expr;
+        }
+
+        Stmt visit(const Provide *op) override {
+            Stmt stmt = IRMutator::visit(op);
+            op = stmt.as<Provide>();
+            internal_assert(op);
+            if (op->name == func) {
+                vector<Expr> args = op->args;
+                internal_assert(dim < (int)args.size());
+                args[dim] = args[dim] + offset;
+                stmt = Provide::make(op->name, op->values, args);
+            }
+            return stmt;
+        }
+
+    public:
+        SelectSlot(const string &func, int dim, const Expr &offset)
+            : func(func), dim(dim), offset(offset) {
+        }
+    };
+
+    // Rotate the produce and consume nodes of a single func through
+    // the slots of its ring buffer and inject the credit semaphore
+    // operations.
+    class RingBufferFunc : public IRMutator {
+        using IRMutator::visit;
+
+        const Function &func;
+        Expr depth;
+        int dim;
+        Expr dim_extent;
+        Expr sema_var;
+        int consume_nodes_remaining;
+
+        struct Loop {
+            string name;
+            Expr min, extent;
+        };
+        vector<Loop> loops;
+
+        // The copy of the storage the current loop iteration should
+        // use: the number of iterations of the enclosing loops since
+        // the storage was allocated, modulo the depth of the ring
+        // buffer.
+        Expr current_slot() {
+            Expr idx = 0;
+            for (const Loop &l : loops) {
+                idx = idx * l.extent + (Variable::make(Int(32), l.name) - l.min);
+            }
+            return idx % depth;
+        }
+
+        Stmt visit(const For *op) override {
+            loops.push_back({op->name, op->min, op->extent});
+            Stmt stmt = IRMutator::visit(op);
+            loops.pop_back();
+            return stmt;
+        }
+
+        Stmt visit(const ProducerConsumer *op) override {
+            if (op->name != func.name()) {
+                return IRMutator::visit(op);
+            }
+            Expr offset = current_slot() * dim_extent;
+            Stmt body = SelectSlot(func.name(), dim, offset).mutate(op->body);
+            if (op->is_producer) {
+                // Take a credit before producing into the slot.
+                body = Acquire::make(sema_var, 1, body);
+                return ProducerConsumer::make_produce(op->name, body);
+            } else {
+                Stmt stmt = ProducerConsumer::make_consume(op->name, body);
+                consume_nodes_remaining--;
+                if (consume_nodes_remaining == 0) {
+                    // Return the credit once the last consumer is
+                    // done with the slot.
+                    Expr release = Call::make(Int(32), "halide_semaphore_release",
+                                              {sema_var, 1}, Call::Extern);
+                    stmt = Block::make(stmt, Evaluate::make(release));
+                }
+                return stmt;
+            }
+        }
+
+    public:
+        RingBufferFunc(const Function &func, const Expr &depth,
+                       int dim, const Expr &dim_extent,
+                       const Expr &sema_var, int consume_nodes)
+            : func(func), depth(depth), dim(dim), dim_extent(dim_extent),
+              sema_var(sema_var), consume_nodes_remaining(consume_nodes) {
+        }
+    };
+
+    Stmt visit(const Realize *op) override {
+        auto it = env.find(op->name);
+        if (it == env.end() || !it->second.schedule().ring_buffer().defined()) {
+            return IRMutator::visit(op);
+        }
+        Function f = it->second;
+        Expr depth = f.schedule().ring_buffer();
+
+        user_assert(f.schedule().async())
+            << "Func " << f.name() << " is scheduled with ring_buffer(), "
+            << "which requires that it is also scheduled with async().\n";
+
+        // Find the dimension of the realization corresponding to the
+        // outermost storage dimension, so that the copies are
+        // contiguous in memory.
+        const vector<StorageDim> &storage_dims = f.schedule().storage_dims();
+        user_assert(!storage_dims.empty())
+            << "Func " << f.name() << " is scheduled with ring_buffer(), "
+            << "but is zero-dimensional, so it has no storage to expand.\n";
+        const string &outermost = storage_dims.back().var;
+        int dim = -1;
+        for (int i = 0; i < (int)f.args().size(); i++) {
+            if (f.args()[i] == outermost) {
+                dim = i;
+                break;
+            }
+        }
+        internal_assert(dim >= 0 && dim < (int)op->bounds.size());
+
+        Region bounds = op->bounds;
+        Expr dim_extent = bounds[dim].extent;
+        bounds[dim] = Range(bounds[dim].min, dim_extent * depth);
+
+        string sema_name = op->name + ".folding_semaphore.ring_buffer";
+        Expr sema_var = Variable::make(type_of<halide_semaphore_t *>(), sema_name);
+
+        CountConsumeNodes consumes(op->name);
+        op->body.accept(&consumes);
+
+        Stmt body = RingBufferFunc(f, depth, dim, dim_extent,
+                                   sema_var, consumes.count)
+                        .mutate(op->body);
+
+        // Handle any nested ring-buffered realizations.
+        body = mutate(body);
+
+        Stmt stmt = Realize::make(op->name, op->types, op->memory_type,
+                                  bounds, op->condition, body);
+
+        // The semaphore starts with one credit per copy of the storage.
+        Expr sema_space = Call::make(type_of<halide_semaphore_t *>(), "halide_make_semaphore",
+                                     {depth}, Call::Extern);
+        return LetStmt::make(sema_name, sema_space, stmt);
+    }
+
+public:
+    InjectRingBuffering(const map<string, Function> &e)
+        : env(e) {
+    }
+};
+
 class ForkAsyncProducers : public IRMutator {
     using IRMutator::visit;
 
@@ -336,13 +590,46 @@ class ForkAsyncProducers : public IRMutator {
                 sema_vars.push_back(Variable::make(Handle(), sema_names.back()));
             }
 
-            Stmt producer = GenerateProducerBody(op->name, sema_vars, cloned_acquires).mutate(body);
+            // An asynchronous extern stage signals its own
+            // completion, so its consumers' semaphore becomes the
+            // completion semaphore passed to the extern call rather
+            // than being released at the end of the producer task.
+            bool async_extern = f.has_extern_definition() && f.extern_definition_is_async();
+            string extern_name = async_extern ? f.extern_function_name() : "";
+            string completion_name = op->name + ".completion_semaphore";
+            Expr completion;
+            Stmt relay;
+            if (async_extern && sema_vars.size() == 1) {
+                completion = sema_vars[0];
+            } else if (async_extern && sema_vars.size() > 1) {
+                // With multiple consume nodes, the extern stage
+                // releases a single completion semaphore, and a tiny
+                // relay task fans it out to the per-consumer
+                // semaphores. The relay starts with an Acquire, so
+                // the task system waits on it without occupying a
+                // thread.
+                completion = Variable::make(Handle(), completion_name);
+                for (const Expr &s : sema_vars) {
+                    Expr release = Call::make(Int(32), "halide_semaphore_release", {s, 1}, Call::Extern);
+                    Stmt release_stmt = Evaluate::make(release);
+                    relay = relay.defined() ? Block::make(relay, release_stmt) : release_stmt;
+                }
+                relay = Acquire::make(completion, 1, relay);
+            }
+
+            Stmt producer = GenerateProducerBody(op->name, sema_vars, cloned_acquires,
+                                                 extern_name, completion)
+                                .mutate(body);
             Stmt consumer = GenerateConsumerBody(op->name, sema_vars).mutate(body);
 
             // Recurse on both sides
             producer = mutate(producer);
             consumer = mutate(consumer);
 
+            if (relay.defined()) {
+                consumer = Fork::make(relay, consumer);
+            }
+
             // Run them concurrently
             body = Fork::make(producer, consumer);
 
@@ -363,6 +650,12 @@ class ForkAsyncProducers : public IRMutator {
                 body = LetStmt::make(sema_name, sema_space, body);
             }
 
+            if (relay.defined()) {
+                Expr sema_space = Call::make(type_of<halide_semaphore_t *>(), "halide_make_semaphore",
+                                             {0}, Call::Extern);
+                body = LetStmt::make(completion_name, sema_space, body);
+            }
+
             return Realize::make(op->name, op->types, op->memory_type,
                                  op->bounds, op->condition, body);
         } else {
@@ -656,6 +949,7 @@ class TightenForkNodes : public IRMutator {
 }  // namespace
 
 Stmt fork_async_producers(Stmt s, const map<string, Function> &env) {
+    s = InjectRingBuffering(env).mutate(s);
     s = TightenProducerConsumerNodes(env).mutate(s);
     s = ForkAsyncProducers(env).mutate(s);
     s = ExpandAcquireNodes().mutate(s);
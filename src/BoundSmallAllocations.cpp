@@ -1,8 +1,10 @@
 #include "BoundSmallAllocations.h"
 #include "Bounds.h"
 #include "CodeGen_Internal.h"
+#include "Function.h"
 #include "IRMutator.h"
 #include "IROperator.h"
+#include "IRVisitor.h"
 #include "Simplify.h"
 
 namespace Halide {
@@ -10,13 +12,86 @@ namespace Internal {
 
 namespace {
 
+// Verify that an allocation placed in MemoryType::Register is
+// genuinely promotable to registers: every access to it must be at a
+// constant index, and its address must not escape. LLVM's scalar
+// replacement reliably promotes a fixed-size alloca satisfying these;
+// without them it silently spills to the stack, which is precisely
+// what MemoryType::Register is meant to rule out. Non-constant
+// indices usually mean a loop over the allocation was not unrolled.
+class CheckRegisterAccesses : public IRVisitor {
+    using IRVisitor::visit;
+
+    const std::string &alloc_name;
+
+    bool is_constant_index(const Expr &index) const {
+        if (const Ramp *r = index.as<Ramp>()) {
+            return is_const(r->base) && is_const(r->stride);
+        } else if (const Broadcast *b = index.as<Broadcast>()) {
+            return is_const(b->value);
+        } else {
+            return is_const(index);
+        }
+    }
+
+    void visit(const Load *op) override {
+        IRVisitor::visit(op);
+        user_assert(op->name != alloc_name || is_constant_index(op->index))
+            << "Allocation " << alloc_name << " is stored in MemoryType::Register, "
+            << "but is loaded from at the non-constant index " << op->index << ". "
+            << "All accesses to a register allocation must be at constant indices; "
+            << "unroll the loops that index it, or store it on the stack instead.\n";
+    }
+
+    void visit(const Store *op) override {
+        IRVisitor::visit(op);
+        user_assert(op->name != alloc_name || is_constant_index(op->index))
+            << "Allocation " << alloc_name << " is stored in MemoryType::Register, "
+            << "but is stored to at the non-constant index " << op->index << ". "
+            << "All accesses to a register allocation must be at constant indices; "
+            << "unroll the loops that index it, or store it on the stack instead.\n";
+    }
+
+    void visit(const Variable *op) override {
+        user_assert(op->name != alloc_name)
+            << "Allocation " << alloc_name << " is stored in MemoryType::Register, "
+            << "but its address is taken, so it cannot be promoted to registers. "
+            << "Store it on the stack instead.\n";
+    }
+
+public:
+    CheckRegisterAccesses(const std::string &alloc_name)
+        : alloc_name(alloc_name) {
+    }
+};
+
 // Find a constant upper bound on the size of each thread-local allocation
 class BoundSmallAllocations : public IRMutator {
     using IRMutator::visit;
 
+    const std::map<std::string, Function> &env;
+
     // Track constant bounds
     Scope<Interval> scope;
 
+    // Look up the stack budget the schedule gives the Func backing an
+    // allocation, if any. Returns zero if there is no budget.
+    int stack_budget(const std::string &allocation_name) const {
+        auto it = env.find(allocation_name);
+        if (it == env.end()) {
+            // Allocations for Tuple-valued Funcs are named
+            // func_name.tuple_index
+            size_t off = allocation_name.rfind('.');
+            if (off != std::string::npos) {
+                it = env.find(allocation_name.substr(0, off));
+            }
+        }
+        if (it == env.end()) {
+            return 0;
+        }
+        return it->second.schedule().stack_budget_bytes();
+    }
+
     template<typename T, typename Body>
     Body visit_let(const T *op) {
         // Visit an entire chain of lets in a single method to conserve stack space.
@@ -109,6 +184,20 @@ class BoundSmallAllocations : public IRMutator {
     }
 
     Stmt visit(const Allocate *op) override {
+        // On the CPU this pass runs again late in lowering, after
+        // unrolling, at which point every access to a register
+        // allocation must have resolved to a constant index for
+        // promotion to be guaranteed. Register allocations in device
+        // code are exempt: lane-indexed accesses there are handled
+        // later (e.g. by lower_warp_shuffles).
+        if (op->memory_type == MemoryType::Register &&
+            device_api == DeviceAPI::None &&
+            !in_thread_loop &&
+            after_unrolling) {
+            CheckRegisterAccesses check(op->name);
+            op->body.accept(&check);
+        }
+
         Expr total_extent = make_const(Int(64), 1);
         for (const Expr &e : op->extents) {
             total_extent *= e;
@@ -138,6 +227,37 @@ class BoundSmallAllocations : public IRMutator {
                                   mutate(op->body), op->new_expr, op->free_function);
         }
 
+        // An explicit stack budget from the schedule lets us place
+        // allocations on the stack even when no constant upper bound
+        // on the size can be inferred, by allocating the full budget
+        // and checking the true size against it at runtime.
+        // Constant-size allocations already within budget fall
+        // through to the usual treatment below, which allocates the
+        // exact size and needs no check.
+        int budget_bytes =
+            op->memory_type == MemoryType::Stack ? stack_budget(op->name) : 0;
+        if (budget_bytes > 0 &&
+            !op->new_expr.defined() &&
+            (!size_ptr || size * op->type.bytes() > budget_bytes)) {
+            int64_t budget_elems = budget_bytes / op->type.bytes();
+            user_assert(budget_elems > 0)
+                << "Stack budget of " << budget_bytes << " bytes for allocation "
+                << op->name << " is smaller than a single element of type "
+                << op->type << "\n";
+            Expr actual_bytes = make_const(UInt(64), op->type.bytes());
+            for (const Expr &e : op->extents) {
+                actual_bytes *= cast<uint64_t>(e);
+            }
+            actual_bytes = simplify(actual_bytes);
+            Expr budget = make_const(UInt(64), (uint64_t)budget_bytes);
+            Expr fits = simplify(actual_bytes <= budget || !op->condition);
+            Expr error = Call::make(Int(32), "halide_error_buffer_allocation_too_large",
+                                    {op->name, actual_bytes, budget}, Call::Extern);
+            Stmt body = Block::make(AssertStmt::make(fits, error), mutate(op->body));
+            return Allocate::make(op->name, op->type, op->memory_type, {(int32_t)budget_elems},
+                                  op->condition, body, op->new_expr, op->free_function);
+        }
+
         // 128 bytes is a typical minimum allocation size in
         // halide_malloc. For now we are very conservative, and only
         // round sizes up to a constant if they're smaller than that.
@@ -155,12 +275,20 @@ class BoundSmallAllocations : public IRMutator {
             return IRMutator::visit(op);
         }
     }
+    bool after_unrolling;
+
+public:
+    BoundSmallAllocations(const std::map<std::string, Function> &env, bool after_unrolling)
+        : env(env), after_unrolling(after_unrolling) {
+    }
 };
 
 }  // namespace
 
-Stmt bound_small_allocations(const Stmt &s) {
-    return BoundSmallAllocations().mutate(s);
+Stmt bound_small_allocations(const Stmt &s,
+                             const std::map<std::string, Function> &env,
+                             bool after_unrolling) {
+    return BoundSmallAllocations(env, after_unrolling).mutate(s);
 }
 
 }  // namespace Internal
@@ -1,6 +1,9 @@
 #ifndef HALIDE_BOUND_SMALL_ALLOCATIONS
 #define HALIDE_BOUND_SMALL_ALLOCATIONS
 
+#include <map>
+#include <string>
+
 #include "Expr.h"
 
 /** \file
@@ -11,13 +14,25 @@
 namespace Halide {
 namespace Internal {
 
+class Function;
+
 /** \file
  *
  * Use bounds analysis to attempt to bound the sizes of small
  * allocations. Inside GPU kernels this is necessary in order to
  * compile. On the CPU this is also useful, because it prevents malloc
- * calls for (provably) tiny allocations. */
-Stmt bound_small_allocations(const Stmt &s);
+ * calls for (provably) tiny allocations. Funcs scheduled with an
+ * explicit stack budget (see \ref Func::store_in) are looked up in
+ * the environment and bounded to their budget, with a runtime check
+ * on the true size.
+ *
+ * If 'after_unrolling' is true, this pass additionally verifies that
+ * CPU allocations in MemoryType::Register are promotable: every
+ * access must be at a constant index and the address must not escape,
+ * and it is an error otherwise. */
+Stmt bound_small_allocations(const Stmt &s,
+                             const std::map<std::string, Function> &env,
+                             bool after_unrolling);
 
 }  // namespace Internal
 }  // namespace Halide
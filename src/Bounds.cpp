@@ -1,4 +1,6 @@
 #include <iostream>
+#include <mutex>
+#include <sstream>
 #include <utility>
 
 #include "Bounds.h"
@@ -7,6 +9,7 @@
 #include "Debug.h"
 #include "Deinterleave.h"
 #include "ExprUsesVar.h"
+#include "FindCalls.h"
 #include "Func.h"
 #include "IR.h"
 #include "IREquality.h"
@@ -19,6 +22,7 @@
 #include "PurifyIndexMath.h"
 #include "Simplify.h"
 #include "Solve.h"
+#include "ThreadPool.h"
 #include "Util.h"
 #include "Var.h"
 
@@ -1638,10 +1642,124 @@ private:
     }
 };
 
+// Bounds inference and allocation bounds inference re-query the
+// bounds of the same subexpressions many times as they walk wide
+// pipelines, so repeated queries are memoized below. A cached result
+// is only reused when the expression is the same node, const_bound
+// matches, and every variable the expression references is bound to
+// the same Interval (compared by identity) as when the result was
+// computed. Expressions whose bounds consult state not covered by
+// that key are never cached: calls may consult the FuncValueBounds
+// map, and scalar parameters have a declared range that can change
+// between compilations. Cache keys hold references to the Exprs they
+// compare by address, so an address cannot be recycled for a
+// different node while its entry is live. The cache is thread_local
+// because lowering passes may run on a thread pool.
+class BoundsQueryAnalyzer : public IRGraphVisitor {
+public:
+    bool cacheable = true;
+    set<string> vars;
+
+private:
+    using IRGraphVisitor::visit;
+
+    void visit(const Call *op) override {
+        cacheable = false;
+        IRGraphVisitor::visit(op);
+    }
+
+    void visit(const Variable *op) override {
+        if (op->param.defined() && !op->param.is_buffer()) {
+            cacheable = false;
+        }
+        vars.insert(op->name);
+    }
+};
+
+struct BoundsQueryCache {
+    struct Entry {
+        bool const_bound;
+        // The min/max each var was bound to in the scope, by
+        // identity. Undefined Exprs record a var that was unbound.
+        vector<pair<Expr, Expr>> bindings;
+        Interval result;
+    };
+
+    struct ExprQueries {
+        Expr expr;  // Holds a reference so the node's address stays unique
+        bool cacheable = false;
+        vector<string> vars;  // The variables the bounds may depend on
+        vector<Entry> entries;
+    };
+
+    map<const BaseExprNode *, ExprQueries> queries;
+    size_t num_entries = 0;
+
+    // Past this many cached results the cache is dropped wholesale;
+    // lowering cycles through distinct scopes, and an occasional cold
+    // restart is cheaper than tracking recency for an eviction policy.
+    static constexpr size_t max_entries = 65536;
+
+    ExprQueries &get_queries(const Expr &e) {
+        auto it = queries.find(e.get());
+        if (it == queries.end()) {
+            BoundsQueryAnalyzer analyzer;
+            e.accept(&analyzer);
+            ExprQueries q;
+            q.expr = e;
+            q.cacheable = analyzer.cacheable;
+            q.vars.assign(analyzer.vars.begin(), analyzer.vars.end());
+            it = queries.emplace(e.get(), std::move(q)).first;
+        }
+        return it->second;
+    }
+
+    static bool same_bindings(const vector<pair<Expr, Expr>> &a,
+                              const vector<pair<Expr, Expr>> &b) {
+        if (a.size() != b.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < a.size(); i++) {
+            if (a[i].first.get() != b[i].first.get() ||
+                a[i].second.get() != b[i].second.get()) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+thread_local BoundsQueryCache bounds_query_cache;
+
 }  // namespace
 
 Interval bounds_of_expr_in_scope(const Expr &expr, const Scope<Interval> &scope, const FuncValueBounds &fb, bool const_bound) {
     //debug(3) << "computing bounds_of_expr_in_scope " << expr << "\n";
+    BoundsQueryCache &cache = bounds_query_cache;
+    bool cacheable;
+    vector<pair<Expr, Expr>> bindings;
+    {
+        BoundsQueryCache::ExprQueries &q = cache.get_queries(expr);
+        cacheable = q.cacheable;
+        if (cacheable) {
+            bindings.reserve(q.vars.size());
+            for (const string &v : q.vars) {
+                if (scope.contains(v)) {
+                    const Interval in = scope.get(v);
+                    bindings.emplace_back(in.min, in.max);
+                } else {
+                    bindings.emplace_back(Expr(), Expr());
+                }
+            }
+            for (const auto &e : q.entries) {
+                if (e.const_bound == const_bound &&
+                    BoundsQueryCache::same_bindings(e.bindings, bindings)) {
+                    return e.result;
+                }
+            }
+        }
+    }
+
     Bounds b(&scope, fb, const_bound);
     expr.accept(&b);
     //debug(3) << "bounds_of_expr_in_scope " << expr << " = " << simplify(b.interval.min) << ", " << simplify(b.interval.max) << "\n";
@@ -1658,6 +1776,20 @@ Interval bounds_of_expr_in_scope(const Expr &expr, const Scope<Interval> &scope,
             << " should have been a scalar of type " << expected
             << ": " << b.interval.max << "\n";
     }
+
+    if (cacheable) {
+        if (cache.num_entries >= BoundsQueryCache::max_entries) {
+            cache.queries.clear();
+            cache.num_entries = 0;
+        }
+        // Re-find rather than holding a reference across the
+        // computation above: computing bounds can recurse into
+        // bounds_of_expr_in_scope, which may have grown or dropped
+        // the cache in the meantime.
+        BoundsQueryCache::ExprQueries &q = cache.get_queries(expr);
+        q.entries.push_back({const_bound, std::move(bindings), b.interval});
+        cache.num_entries++;
+    }
     return b.interval;
 }
 
@@ -2881,55 +3013,324 @@ Interval compute_pure_function_definition_value_bounds(
     return result;
 }
 
-FuncValueBounds compute_function_value_bounds(const vector<string> &order,
-                                              const map<string, Function> &env) {
-    FuncValueBounds fb;
+namespace {
 
-    for (size_t i = 0; i < order.size(); i++) {
-        Function f = env.find(order[i])->second;
-        const vector<string> f_args = f.args();
-        for (int j = 0; j < f.outputs(); j++) {
-            pair<string, int> key = {f.name(), j};
+// Compute the value bounds of all outputs of a single Function. Only
+// reads the bounds of the Functions it calls from fb, so distinct
+// Functions at the same depth in the call graph can be processed
+// concurrently.
+vector<Interval> compute_single_function_value_bounds(const Function &f,
+                                                      const FuncValueBounds &fb) {
+    const vector<string> f_args = f.args();
+    vector<Interval> results(f.outputs());
+    for (int j = 0; j < f.outputs(); j++) {
+        Interval result;
 
-            Interval result;
+        if (f.is_pure()) {
 
-            if (f.is_pure()) {
+            // Make a scope that says the args could be anything.
+            Scope<Interval> arg_scope;
+            for (size_t k = 0; k < f.args().size(); k++) {
+                arg_scope.push(f_args[k], Interval::everything());
+            }
 
-                // Make a scope that says the args could be anything.
-                Scope<Interval> arg_scope;
-                for (size_t k = 0; k < f.args().size(); k++) {
-                    arg_scope.push(f_args[k], Interval::everything());
-                }
+            result = compute_pure_function_definition_value_bounds(f.definition(), arg_scope, fb, j);
+            // These can expand combinatorially as we go down the
+            // pipeline if we don't run CSE on them.
+            if (result.has_lower_bound()) {
+                result.min = simplify(common_subexpression_elimination(result.min));
+            }
 
-                result = compute_pure_function_definition_value_bounds(f.definition(), arg_scope, fb, j);
-                // These can expand combinatorially as we go down the
-                // pipeline if we don't run CSE on them.
-                if (result.has_lower_bound()) {
-                    result.min = simplify(common_subexpression_elimination(result.min));
-                }
+            if (result.has_upper_bound()) {
+                result.max = simplify(common_subexpression_elimination(result.max));
+            }
+        } else {
+            // If the Func is impure, we may still be able to specify a bounds-of-type here
+            Type t = f.output_types()[j].element_of();
+            if ((t.is_uint() || t.is_int()) && t.bits() <= 16) {
+                result = Interval(t.min(), t.max());
+            } else {
+                result = Interval::everything();
+            }
 
-                if (result.has_upper_bound()) {
-                    result.max = simplify(common_subexpression_elimination(result.max));
-                }
+            // TODO: if a Function is impure, but the RDoms used by the update functions
+            // are all constant, it may be profitable to calculate the bounds here too
+        }
+
+        debug(2) << "Bounds on value " << j
+                 << " for func " << f.name()
+                 << " are: " << result.min << ", " << result.max << "\n";
+
+        results[j] = result;
+    }
+    return results;
+}
+
+// With HL_INCREMENTAL_BOUNDS set, the per-Function value bounds are
+// memoized across compilations. Value bounds depend only on a
+// Function's definitions and on the bounds of its callees, never on
+// schedules, so interactive tools that repeatedly re-lower a pipeline
+// while exploring schedules can skip recomputing them entirely; only
+// Functions whose definitions have changed, and everything downstream
+// of them, miss the cache. Each entry is keyed by a signature built
+// from the printed definitions, the identities of any Parameters and
+// embedded images they reference, and the keys of the direct callees,
+// so a definition edit changes the key of exactly the affected
+// Functions.
+struct BoundsCache {
+    std::mutex mutex;
+
+    struct Entry {
+        string signature;
+        vector<Interval> bounds;
+    };
 
-                fb[key] = result;
+    // Entries are indexed by a hash of their signature, and verified
+    // against the full signature on lookup, so a hash collision costs
+    // time rather than correctness.
+    map<uint64_t, vector<Entry>> entries;
+
+    // Distinct Parameters and embedded images are assigned persistent
+    // ids for use in signatures. Holding a reference to each ensures
+    // an id is never reassigned to a recycled object.
+    map<Parameter, uint64_t> param_ids;
+    map<const void *, pair<Buffer<>, uint64_t>> image_ids;
+    uint64_t next_id = 0;
+};
+
+BoundsCache &bounds_cache() {
+    static BoundsCache cache;
+    return cache;
+}
+
+// Record the Parameters and embedded images a definition references.
+// They are part of the cache key: the printed form only captures them
+// by name, and two pipelines may use distinct objects with the same
+// name.
+class CollectBoundsDependencies : public IRGraphVisitor {
+    BoundsCache &cache;
+    std::ostream &sig;
+
+    using IRGraphVisitor::visit;
+
+    void visit(const Variable *op) override {
+        record(op->param, op->image);
+    }
+
+    void visit(const Call *op) override {
+        IRGraphVisitor::visit(op);
+        record(op->param, op->image);
+    }
+
+    void record(const Parameter &param, const Buffer<> &image) {
+        if (param.defined()) {
+            auto it = cache.param_ids.emplace(param, cache.next_id);
+            if (it.second) {
+                cache.next_id++;
+            }
+            sig << "param " << it.first->second;
+            if (!param.is_buffer()) {
+                // Scalar parameter ranges feed the bounds (see
+                // bounds_of_expr_in_scope), and may be changed by the
+                // user between compilations without touching the
+                // definition.
+                sig << " in [" << param.min_value() << ", " << param.max_value() << "]";
+            }
+            sig << "\n";
+        }
+        if (image.defined()) {
+            auto it = cache.image_ids.emplace(image.get(), std::make_pair(image, cache.next_id));
+            if (it.second) {
+                cache.next_id++;
+            }
+            sig << "image " << it.first->second.second << "\n";
+        }
+    }
+
+public:
+    CollectBoundsDependencies(BoundsCache &c, std::ostream &s)
+        : cache(c), sig(s) {
+    }
+};
+
+void add_definition_to_signature(const Definition &def,
+                                 CollectBoundsDependencies &deps,
+                                 std::ostream &sig) {
+    for (const Expr &e : def.args()) {
+        sig << e << "\n";
+        e.accept(&deps);
+    }
+    for (const Expr &e : def.values()) {
+        sig << e << "\n";
+        e.accept(&deps);
+    }
+    for (const Specialization &s : def.specializations()) {
+        sig << "when " << s.condition << "\n";
+        s.condition.accept(&deps);
+        add_definition_to_signature(s.definition, deps, sig);
+    }
+}
+
+// Build the cache signature and key for a Function given the keys of
+// everything that precedes it in the realization order. Returns false
+// if the Function calls something whose key is unknown, in which case
+// its bounds must not be cached. Holds the cache lock, because
+// assigning param/image ids mutates the cache.
+bool function_bounds_key(const Function &f,
+                         const map<string, uint64_t> &callee_keys,
+                         string *signature,
+                         uint64_t *key) {
+    std::ostringstream sig;
+    for (const Type &t : f.output_types()) {
+        sig << t << " ";
+    }
+    sig << "\n";
+    if (f.is_pure()) {
+        for (const string &a : f.args()) {
+            sig << a << " ";
+        }
+        sig << "\n";
+        BoundsCache &cache = bounds_cache();
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        CollectBoundsDependencies deps(cache, sig);
+        add_definition_to_signature(f.definition(), deps, sig);
+        for (const auto &p : find_direct_calls(f)) {
+            auto it = callee_keys.find(p.first);
+            if (it == callee_keys.end()) {
+                return false;
+            }
+            sig << "calls " << p.first << " " << it->second << "\n";
+        }
+    } else {
+        // Impure Functions get bounds-of-type only (see above), which
+        // the output types alone determine.
+        sig << "impure\n";
+    }
+    *signature = sig.str();
+    *key = std::hash<string>{}(*signature);
+    return true;
+}
+
+bool lookup_cached_bounds(uint64_t key, const string &signature, vector<Interval> *bounds) {
+    BoundsCache &cache = bounds_cache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    auto it = cache.entries.find(key);
+    if (it == cache.entries.end()) {
+        return false;
+    }
+    for (const BoundsCache::Entry &e : it->second) {
+        if (e.signature == signature) {
+            *bounds = e.bounds;
+            return true;
+        }
+    }
+    return false;
+}
+
+void insert_cached_bounds(uint64_t key, const string &signature, const vector<Interval> &bounds) {
+    BoundsCache &cache = bounds_cache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    vector<BoundsCache::Entry> &bucket = cache.entries[key];
+    for (const BoundsCache::Entry &e : bucket) {
+        if (e.signature == signature) {
+            // Another compilation got here first.
+            return;
+        }
+    }
+    bucket.push_back({signature, bounds});
+}
+
+}  // namespace
+
+FuncValueBounds compute_function_value_bounds(const vector<string> &order,
+                                              const map<string, Function> &env) {
+    FuncValueBounds fb;
+
+    // With HL_INCREMENTAL_BOUNDS set, reuse cached bounds for any
+    // Function whose definition (and whose callees' definitions) are
+    // unchanged since a previous compilation, and recompute only the
+    // rest. This takes precedence over HL_PARALLEL_LOWERING; a warm
+    // cache makes this loop mostly lookups.
+    if (!get_env_variable("HL_INCREMENTAL_BOUNDS").empty()) {
+        map<string, uint64_t> keys;
+        for (const string &name : order) {
+            Function f = env.find(name)->second;
+            string signature;
+            uint64_t key = 0;
+            vector<Interval> results;
+            if (function_bounds_key(f, keys, &signature, &key)) {
+                keys[name] = key;
+                if (!lookup_cached_bounds(key, signature, &results)) {
+                    results = compute_single_function_value_bounds(f, fb);
+                    insert_cached_bounds(key, signature, results);
+                }
             } else {
-                // If the Func is impure, we may still be able to specify a bounds-of-type here
-                Type t = f.output_types()[j].element_of();
-                if ((t.is_uint() || t.is_int()) && t.bits() <= 16) {
-                    result = Interval(t.min(), t.max());
-                } else {
-                    result = Interval::everything();
+                results = compute_single_function_value_bounds(f, fb);
+            }
+            for (int j = 0; j < (int)results.size(); j++) {
+                fb[{f.name(), j}] = results[j];
+            }
+        }
+        return fb;
+    }
+
+    // A Function's value bounds only depend on the bounds of the
+    // Functions it calls, so with HL_PARALLEL_LOWERING set we walk the
+    // realization order in waves of Functions whose callees have all
+    // been handled and farm each wave out to a thread pool. Large
+    // pipelines are typically wide rather than deep, so most of the
+    // work lands in a few big waves.
+    const bool parallel = !get_env_variable("HL_PARALLEL_LOWERING").empty();
+    if (parallel && order.size() > 1) {
+        // Depth of each Function in the call graph, considering only
+        // calls to things in env. The realization order is a
+        // topological sort, so callees are assigned a depth before
+        // their callers, and a Function at depth d only calls
+        // Functions at strictly smaller depths.
+        map<string, int> depth;
+        int max_depth = 0;
+        for (const string &name : order) {
+            Function f = env.find(name)->second;
+            int d = 0;
+            for (const auto &p : find_direct_calls(f)) {
+                auto it = depth.find(p.first);
+                if (it != depth.end()) {
+                    d = std::max(d, it->second + 1);
                 }
-                fb[key] = result;
+            }
+            depth[name] = d;
+            max_depth = std::max(max_depth, d);
+        }
 
-                // TODO: if a Function is impure, but the RDoms used by the update functions
-                // are all constant, it may be profitable to calculate the bounds here too
+        ThreadPool<vector<Interval>> pool;
+        for (int d = 0; d <= max_depth; d++) {
+            vector<pair<Function, std::future<vector<Interval>>>> wave;
+            for (const string &name : order) {
+                if (depth[name] == d) {
+                    Function f = env.find(name)->second;
+                    wave.emplace_back(f, pool.async([f, &fb]() {
+                        return compute_single_function_value_bounds(f, fb);
+                    }));
+                }
+            }
+            // fb is read concurrently by the workers, so it must not
+            // be touched until the whole wave has drained.
+            for (auto &task : wave) {
+                vector<Interval> results = task.second.get();
+                for (int j = 0; j < (int)results.size(); j++) {
+                    fb[{task.first.name(), j}] = results[j];
+                }
             }
+        }
+
+        return fb;
+    }
 
-            debug(2) << "Bounds on value " << j
-                     << " for func " << order[i]
-                     << " are: " << result.min << ", " << result.max << "\n";
+    for (const string &name : order) {
+        Function f = env.find(name)->second;
+        vector<Interval> results = compute_single_function_value_bounds(f, fb);
+        for (int j = 0; j < (int)results.size(); j++) {
+            fb[{f.name(), j}] = results[j];
         }
     }
 
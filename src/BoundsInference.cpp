@@ -170,28 +170,52 @@ bool is_fused_with_others(const vector<vector<Function>> &fused_groups,
 
     const vector<Dim> &dims = (producing_stage_index == 0) ? producing_func.definition().schedule().dims() : producing_func.update(producing_stage_index - 1).schedule().dims();
 
-    size_t var_index;
-    {
+    const auto &find_dim = [](const vector<Dim> &dims, const string &var) -> int {
         const auto &iter = std::find_if(dims.begin(), dims.end(),
                                         [&var](const Dim &d) { return var_name_match(d.var, var); });
-        if (iter == dims.end()) {
-            return false;
-        }
-        var_index = iter - dims.begin();
-    }
+        return (iter == dims.end()) ? -1 : (int)(iter - dims.begin());
+    };
+
+    int var_index = find_dim(dims, var);
 
     // Iterate over the fused pair list to check if the producer stage
     // is fused with the consumer stage at 'var'
     for (const auto &pair : fused_pairs_in_groups[index]) {
         if (((pair.func_1 == consumer_name) && ((int)pair.stage_1 == consumer_stage)) ||
             ((pair.func_2 == consumer_name) && ((int)pair.stage_2 == consumer_stage))) {
-            const auto &iter = std::find_if(dims.begin(), dims.end(),
-                                            [&pair](const Dim &d) { return var_name_match(d.var, pair.var_name); });
-            if (iter == dims.end()) {
-                continue;
+            int idx = find_dim(dims, pair.var_name);
+            int producing_var_index = var_index;
+            if ((idx < 0) || (producing_var_index < 0)) {
+                // The fused dims of this stage may be RVars of an
+                // update definition, which never match the parent's
+                // loop variable names. Align positionally with the
+                // parent's fused dims instead.
+                const vector<Function> &group = fused_groups[index];
+                const auto &parent_iter = std::find_if(group.begin(), group.end(),
+                                                       [&pair](const Function &f) { return f.name() == pair.func_1; });
+                if (parent_iter == group.end()) {
+                    continue;
+                }
+                const vector<Dim> &parent_dims = (pair.stage_1 == 0) ? parent_iter->definition().schedule().dims() : parent_iter->update((int)pair.stage_1 - 1).schedule().dims();
+                if (idx < 0) {
+                    int parent_idx = find_dim(parent_dims, pair.var_name);
+                    if (parent_idx < 0) {
+                        continue;
+                    }
+                    idx = (int)dims.size() - 1 - ((int)parent_dims.size() - 1 - parent_idx);
+                }
+                if (producing_var_index < 0) {
+                    int parent_var_idx = find_dim(parent_dims, var);
+                    if (parent_var_idx < 0) {
+                        continue;
+                    }
+                    producing_var_index = (int)dims.size() - 1 - ((int)parent_dims.size() - 1 - parent_var_idx);
+                }
+                if ((idx < 0) || (producing_var_index < 0)) {
+                    continue;
+                }
             }
-            size_t idx = iter - dims.begin();
-            if (var_index >= idx) {
+            if (producing_var_index >= idx) {
                 return true;
             }
         }
@@ -756,6 +780,12 @@ public:
                 }
             }
 
+            if (func.extern_definition_is_async()) {
+                // Bounds queries are always synchronous; pass a null
+                // completion semaphore.
+                bounds_inference_args.push_back(make_zero(type_of<struct halide_semaphore_t *>()));
+            }
+
             // Make the extern call
             Expr e = func.make_call_to_extern_definition(bounds_inference_args, target);
 
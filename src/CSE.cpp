@@ -1,6 +1,7 @@
 #include <map>
 
 #include "CSE.h"
+#include "HashCons.h"
 #include "IREquality.h"
 #include "IRMutator.h"
 #include "IROperator.h"
@@ -279,6 +280,13 @@ Expr common_subexpression_elimination(const Expr &e_in, bool lift_all) {
 
     debug(4) << "\n\n\nInput to CSE " << e << "\n";
 
+    // With hash-consing on, collapse value-equal subtrees to shared
+    // nodes up front, so the deep comparisons done by the maps below
+    // mostly terminate at their pointer-equality fast paths.
+    if (hash_consing_enabled()) {
+        e = hash_cons(e);
+    }
+
     e = RemoveLets().mutate(e);
 
     debug(4) << "After removing lets: " << e << "\n";
@@ -45,6 +45,7 @@ protected:
     /** Assuming 'inner' is a function that takes two vector arguments, define a wrapper that
      * takes one vector argument and splits it into two to call inner. */
     llvm::Function *define_concat_args_wrapper(llvm::Function *inner, const string &name);
+    void declare_bf16_intrinsics();
     void init_module() override;
 
     /** Nodes for which we want to emit specific neon intrinsics */
@@ -194,6 +195,11 @@ CodeGen_ARM::CodeGen_ARM(const Target &target)
     casts.emplace_back("saturating_narrow", u32_sat(wild_u64x_));
     casts.emplace_back("saturating_narrow", u32_sat(wild_i64x_));
 
+    // BFCVTN - Convert to bfloat16. The intrinsic is only declared
+    // when the target has the bf16 feature, so the pattern is
+    // harmless elsewhere.
+    casts.emplace_back("f32_to_bf16", bf16(wild_f32x_));
+
     // SQNEG - Saturating negate
     negations.emplace_back("saturating_negate", -max(wild_i8x_, -127));
     negations.emplace_back("saturating_negate", -max(wild_i16x_, -32767));
@@ -694,6 +700,96 @@ void CodeGen_ARM::init_module() {
             }
         }
     }
+
+    if (target.bits == 64 && target.has_feature(Target::ARMBf16)) {
+        declare_bf16_intrinsics();
+    }
+}
+
+// The ARMv8.6 bfloat16 intrinsics take and return LLVM's bfloat type, but
+// Halide represents bf16 vectors as vectors of 16-bit integers, so each
+// intrinsic gets a wrapper that bitcasts the bf16 operands. The wrappers are
+// built here rather than in the .ll runtime modules because the bfloat type
+// does not parse under older LLVMs.
+void CodeGen_ARM::declare_bf16_intrinsics() {
+#if LLVM_VERSION >= 110
+    llvm::Type *bf16_t = llvm::Type::getBFloatTy(module->getContext());
+
+    IRBuilderBase::InsertPoint here = builder->saveIP();
+
+    // bfdot accumulates adjacent pairs of bf16 products into f32 lanes.
+    for (int lanes : {2, 4}) {
+        Type ret_type = Float(32, lanes);
+        Type arg_type = BFloat(16, lanes * 2);
+        llvm::Type *acc_ty = llvm_type_of(ret_type);
+        llvm::Type *i16_vec_ty = llvm_type_of(arg_type);
+        llvm::Type *bf16_vec_ty = get_vector_type(bf16_t, lanes * 2);
+
+        std::stringstream intrin_name;
+        intrin_name << "llvm.aarch64.neon.bfdot.v" << lanes << "f32.v" << lanes * 2 << "bf16";
+        llvm::FunctionCallee inner = module->getOrInsertFunction(
+            intrin_name.str(),
+            llvm::FunctionType::get(acc_ty, {acc_ty, bf16_vec_ty, bf16_vec_ty}, false));
+
+        llvm::FunctionType *wrapper_ty =
+            llvm::FunctionType::get(acc_ty, {acc_ty, i16_vec_ty, i16_vec_ty}, false);
+        llvm::Function *wrapper =
+            llvm::Function::Create(wrapper_ty, llvm::GlobalValue::InternalLinkage,
+                                   "bfdot" + unique_name("_wrapper"), module.get());
+        llvm::BasicBlock *block = llvm::BasicBlock::Create(module->getContext(), "entry", wrapper);
+        builder->SetInsertPoint(block);
+        Value *a = builder->CreateBitCast(wrapper->getArg(1), bf16_vec_ty);
+        Value *b = builder->CreateBitCast(wrapper->getArg(2), bf16_vec_ty);
+        Value *ret = builder->CreateCall(inner, {wrapper->getArg(0), a, b});
+        builder->CreateRet(ret);
+        wrapper->addFnAttr(llvm::Attribute::AlwaysInline);
+        llvm::verifyFunction(*wrapper);
+
+        declare_intrin_overload("dot_product", ret_type, wrapper, {ret_type, arg_type, arg_type});
+    }
+
+    // bfcvtn (followed by bfcvtn2 for the upper half) narrows f32 vectors to
+    // bf16 with round-to-nearest-even, unlike the truncating shift used when
+    // emulating the cast.
+    llvm::Type *f32x4_ty = llvm_type_of(Float(32, 4));
+    llvm::Type *bf16x8_ty = get_vector_type(bf16_t, 8);
+    llvm::FunctionCallee bfcvtn = module->getOrInsertFunction(
+        "llvm.aarch64.neon.bfcvtn",
+        llvm::FunctionType::get(bf16x8_ty, {f32x4_ty}, false));
+    llvm::FunctionCallee bfcvtn2 = module->getOrInsertFunction(
+        "llvm.aarch64.neon.bfcvtn2",
+        llvm::FunctionType::get(bf16x8_ty, {bf16x8_ty, f32x4_ty}, false));
+
+    for (int lanes : {4, 8}) {
+        Type ret_type = BFloat(16, lanes);
+        Type arg_type = Float(32, lanes);
+        llvm::FunctionType *wrapper_ty =
+            llvm::FunctionType::get(llvm_type_of(ret_type), {llvm_type_of(arg_type)}, false);
+        llvm::Function *wrapper =
+            llvm::Function::Create(wrapper_ty, llvm::GlobalValue::InternalLinkage,
+                                   "bfcvtn" + unique_name("_wrapper"), module.get());
+        llvm::BasicBlock *block = llvm::BasicBlock::Create(module->getContext(), "entry", wrapper);
+        builder->SetInsertPoint(block);
+        Value *ret;
+        if (lanes == 4) {
+            Value *cvt = builder->CreateCall(bfcvtn, {wrapper->getArg(0)});
+            ret = slice_vector(builder->CreateBitCast(cvt, llvm_type_of(BFloat(16, 8))), 0, 4);
+        } else {
+            Value *low = slice_vector(wrapper->getArg(0), 0, 4);
+            Value *high = slice_vector(wrapper->getArg(0), 4, 4);
+            Value *cvt = builder->CreateCall(bfcvtn, {low});
+            cvt = builder->CreateCall(bfcvtn2, {cvt, high});
+            ret = builder->CreateBitCast(cvt, llvm_type_of(ret_type));
+        }
+        builder->CreateRet(ret);
+        wrapper->addFnAttr(llvm::Attribute::AlwaysInline);
+        llvm::verifyFunction(*wrapper);
+
+        declare_intrin_overload("f32_to_bf16", ret_type, wrapper, {arg_type});
+    }
+
+    builder->restoreIP(here);
+#endif
 }
 
 void CodeGen_ARM::visit(const Cast *op) {
@@ -1132,12 +1228,14 @@ void CodeGen_ARM::codegen_vector_reduce(const VectorReduce *op, const Expr &init
         Expr pattern;
         const char *intrin;
         Target::Feature required_feature;
+        Type narrow_type;  // If defined, narrow the matched operands to this type
     };
     // clang-format off
     static const Pattern patterns[] = {
         {VectorReduce::Add, 4, i32(widening_mul(wild_i8x_, wild_i8x_)), "dot_product", Target::ARMDotProd},
         {VectorReduce::Add, 4, i32(widening_mul(wild_u8x_, wild_u8x_)), "dot_product", Target::ARMDotProd},
         {VectorReduce::Add, 4, u32(widening_mul(wild_u8x_, wild_u8x_)), "dot_product", Target::ARMDotProd},
+        {VectorReduce::Add, 2, wild_f32x_ * wild_f32x_, "dot_product", Target::ARMBf16, BFloat(16)},
     };
     // clang-format on
 
@@ -1151,8 +1249,17 @@ void CodeGen_ARM::codegen_vector_reduce(const VectorReduce *op, const Expr &init
             continue;
         }
         if (expr_match(p.pattern, op->value, matches)) {
-            if (factor != 4) {
-                Expr equiv = VectorReduce::make(op->op, op->value, op->value.type().lanes() / 4);
+            Expr a = matches[0];
+            Expr b = matches[1];
+            if (p.narrow_type.bits() > 0) {
+                a = lossless_cast(p.narrow_type.with_lanes(a.type().lanes()), a);
+                b = lossless_cast(p.narrow_type.with_lanes(b.type().lanes()), b);
+                if (!a.defined() || !b.defined()) {
+                    continue;
+                }
+            }
+            if (factor != p.factor) {
+                Expr equiv = VectorReduce::make(op->op, op->value, op->value.type().lanes() / p.factor);
                 equiv = VectorReduce::make(op->op, equiv, op->type.lanes());
                 codegen_vector_reduce(equiv.as<VectorReduce>(), init);
                 return;
@@ -1162,14 +1269,14 @@ void CodeGen_ARM::codegen_vector_reduce(const VectorReduce *op, const Expr &init
             if (!i.defined()) {
                 i = make_zero(op->type);
             }
-            if (const Shuffle *s = matches[0].as<Shuffle>()) {
+            if (const Shuffle *s = a.as<Shuffle>()) {
                 if (s->is_broadcast()) {
                     // LLVM wants the broadcast as the second operand for the broadcasting
                     // variant of udot/sdot.
-                    std::swap(matches[0], matches[1]);
+                    std::swap(a, b);
                 }
             }
-            value = call_overloaded_intrin(op->type, p.intrin, {i, matches[0], matches[1]});
+            value = call_overloaded_intrin(op->type, p.intrin, {i, a, b});
             if (value) {
                 return;
             }
@@ -1290,6 +1397,24 @@ string CodeGen_ARM::mattrs() const {
             separator = ",";
         }
 
+        if (target.has_feature(Target::ARMBf16)) {
+#if LLVM_VERSION >= 110
+            arch_flags += separator + "+bf16";
+            separator = ",";
+#else
+            user_error << "ARM bf16 support requires LLVM 11 or later.";
+#endif
+        }
+
+        if (target.has_feature(Target::ARMSME)) {
+#if LLVM_VERSION >= 160
+            arch_flags += separator + "+sme";
+            separator = ",";
+#else
+            user_error << "ARM SME support requires LLVM 16 or later.";
+#endif
+        }
+
         if (target.os == Target::IOS || target.os == Target::OSX) {
             return arch_flags + separator + "+reserve-x18";
         } else {
@@ -1308,6 +1433,27 @@ bool CodeGen_ARM::use_soft_float_abi() const {
 }
 
 int CodeGen_ARM::native_vector_bits() const {
+    if (target.bits == 64 && target.has_feature(Target::ARMSME)) {
+        // The streaming engine operates on much wider vectors than the
+        // core's NEON/SVE units; current implementations use a 512-bit
+        // streaming vector length. Outer-product-shaped updates (a
+        // vectorized row accumulate against a broadcast scalar, the shape
+        // rfactor produces for matmuls) then become one streaming fma per
+        // row slice.
+        return 512;
+    }
+    if (target.bits == 64 &&
+        (target.has_feature(Target::SVE) ||
+         target.has_feature(Target::SVE2))) {
+        // We compile for SVE using the fixed-length model, assuming
+        // the 256-bit vector length of the implementations we care
+        // about. The generated code is correct for any hardware
+        // vector length (LLVM legalizes wider-than-native vectors),
+        // but for the backend to actually place these vectors in the
+        // SVE registers it must be told the minimum vector length,
+        // e.g. HL_LLVM_ARGS="-aarch64-sve-vector-bits-min=256".
+        return 256;
+    }
     return 128;
 }
 
@@ -374,6 +374,20 @@ CodeGen_C::CodeGen_C(ostream &s, const Target &t, OutputKind output_kind, const
     stream << "#ifndef HALIDE_FUNCTION_ATTRS\n";
     stream << "#define HALIDE_FUNCTION_ATTRS\n";
     stream << "#endif\n";
+
+    // A restrict qualifier spelled portably. Halide buffer host
+    // pointers and internal allocations never alias each other, and
+    // telling the downstream compiler so is what lets it vectorize
+    // and pipeline the emitted loops.
+    stream << "#ifndef HALIDE_RESTRICT\n";
+    stream << "#if defined(__GNUC__) || defined(__clang__)\n";
+    stream << "#define HALIDE_RESTRICT __restrict__\n";
+    stream << "#elif defined(_MSC_VER)\n";
+    stream << "#define HALIDE_RESTRICT __restrict\n";
+    stream << "#else\n";
+    stream << "#define HALIDE_RESTRICT\n";
+    stream << "#endif\n";
+    stream << "#endif\n";
 }
 
 CodeGen_C::~CodeGen_C() {
@@ -1565,7 +1579,7 @@ void CodeGen_C::compile(const LoweredFunc &f) {
     stream << "int " << simple_name << "(";
     for (size_t i = 0; i < args.size(); i++) {
         if (args[i].is_buffer()) {
-            stream << "struct halide_buffer_t *"
+            stream << "struct halide_buffer_t *HALIDE_RESTRICT "
                    << print_name(args[i].name)
                    << "_buffer";
         } else {
@@ -2069,6 +2083,41 @@ void CodeGen_C::visit(const Call *op) {
         internal_assert(op->args.size() == 1);
         Expr a0 = op->args[0];
         rhs << print_expr(cast(op->type, select(a0 > 0, a0, -a0)));
+    } else if (op->is_intrinsic(Call::copy_memory)) {
+        internal_assert(op->args.size() == 6);
+        // The last arg is a sentinel carrying the element type being
+        // copied; the offsets and count are in units of it.
+        string elem = print_type(op->args[5].type());
+        string dst = print_expr(op->args[0]);
+        string dst_offset = print_expr(op->args[1]);
+        string src = print_expr(op->args[2]);
+        string src_offset = print_expr(op->args[3]);
+        string count = print_expr(op->args[4]);
+        rhs << "(memcpy((" << elem << " *)" << dst << " + " << dst_offset
+            << ", (const " << elem << " *)" << src << " + " << src_offset
+            << ", (size_t)" << count << " * sizeof(" << elem << ")), 0)";
+    } else if (op->is_intrinsic(Call::streaming_store)) {
+        // The C backend has no non-temporal stores; emit a regular one.
+        internal_assert(op->args.size() == 3);
+        Type t = op->args[2].type();
+        string id_value = print_expr(op->args[2]);
+        string name = print_expr(op->args[0]);
+        if (t.is_vector()) {
+            Expr dense_ramp_base = strided_ramp_base(op->args[1], 1);
+            internal_assert(dense_ramp_base.defined());
+            string id_ramp_base = print_expr(dense_ramp_base);
+            stream << get_indent() << print_type(t) << "_ops::store("
+                   << id_value << ", " << name << ", " << id_ramp_base << ");\n";
+        } else {
+            string id_index = print_expr(op->args[1]);
+            stream << get_indent() << "((" << print_type(t) << " *)" << name
+                   << ")[" << id_index << "] = " << id_value << ";\n";
+        }
+        cache.clear();
+        rhs << "0";
+    } else if (op->is_intrinsic(Call::streaming_fence)) {
+        // Nothing to order without non-temporal stores.
+        rhs << "0";
     } else if (op->is_intrinsic(Call::memoize_expr)) {
         internal_assert(!op->args.empty());
         string arg = print_expr(op->args[0]);
@@ -2226,13 +2275,18 @@ void CodeGen_C::visit(const Call *op) {
                       " integer overflow for int32 and int64 is undefined behavior in"
                       " Halide.\n";
     } else if (op->is_intrinsic(Call::prefetch)) {
-        user_assert((op->args.size() == 4) && is_const_one(op->args[2]))
+        user_assert((op->args.size() == 6) && is_const_one(op->args[4]))
             << "Only prefetch of 1 cache line is supported in C backend.\n";
         const Variable *base = op->args[0].as<Variable>();
         internal_assert(base && base->type.is_handle());
+        // __builtin_prefetch requires constant rw/locality arguments.
+        const int64_t *rw = as_const_int(op->args[2]);
+        const int64_t *locality = as_const_int(op->args[3]);
+        internal_assert(rw && locality);
         rhs << "__builtin_prefetch("
             << "((" << print_type(op->type) << " *)" << print_name(base->name)
-            << " + " << print_expr(op->args[1]) << "), 1)";
+            << " + " << print_expr(op->args[1]) << "), "
+            << *rw << ", " << *locality << ")";
     } else if (op->is_intrinsic(Call::size_of_halide_buffer_t)) {
         rhs << "(sizeof(halide_buffer_t))";
     } else if (op->is_intrinsic(Call::strict_float)) {
@@ -2437,8 +2491,13 @@ void CodeGen_C::visit(const LetStmt *op) {
     if (op->value.type().is_handle()) {
         // The body might contain a Load or Store that references this
         // directly by name, so we can't rewrite the name.
+        // Buffer host pointers never alias each other, so qualify
+        // them to let the downstream compiler vectorize.
+        const Call *call = op->value.as<Call>();
+        const bool is_buffer_host =
+            call && call->name == Call::buffer_get_host;
         stream << get_indent() << print_type(op->value.type())
-               << " " << print_name(op->name)
+               << (is_buffer_host ? " HALIDE_RESTRICT " : " ") << print_name(op->name)
                << " = " << id_value << ";\n";
     } else {
         Expr new_var = Variable::make(op->value.type(), id_value);
@@ -2535,9 +2594,14 @@ void CodeGen_C::visit(const For *op) {
 
     if (op->for_type == ForType::Parallel) {
         stream << get_indent() << "#pragma omp parallel for\n";
+    } else if (op->for_type == ForType::Vectorized) {
+        // Vectorized loops normally reach codegen as vector-typed
+        // Exprs; any that survive as loops have independent
+        // iterations, so say so to the downstream compiler.
+        stream << get_indent() << "#pragma omp simd\n";
     } else {
         internal_assert(op->for_type == ForType::Serial)
-            << "Can only emit serial or parallel for loops to C\n";
+            << "Can only emit serial, parallel, or vectorized for loops to C\n";
     }
 
     stream << get_indent() << "for (int "
@@ -2673,7 +2737,7 @@ void CodeGen_C::visit(const Allocate *op) {
             stream << op_name
                    << "[" << size_id << "];\n";
         } else {
-            stream << "*"
+            stream << "*HALIDE_RESTRICT "
                    << op_name
                    << " = ("
                    << op_type
@@ -2842,6 +2906,15 @@ void CodeGen_C::test() {
 #ifndef HALIDE_FUNCTION_ATTRS
 #define HALIDE_FUNCTION_ATTRS
 #endif
+#ifndef HALIDE_RESTRICT
+#if defined(__GNUC__) || defined(__clang__)
+#define HALIDE_RESTRICT __restrict__
+#elif defined(_MSC_VER)
+#define HALIDE_RESTRICT __restrict
+#else
+#define HALIDE_RESTRICT
+#endif
+#endif
 
 
 
@@ -2850,10 +2923,10 @@ extern "C" {
 #endif
 
 HALIDE_FUNCTION_ATTRS
-int test1(struct halide_buffer_t *_buf_buffer, float _alpha, int32_t _beta, void const *__user_context) {
+int test1(struct halide_buffer_t *HALIDE_RESTRICT _buf_buffer, float _alpha, int32_t _beta, void const *__user_context) {
  void * const _ucon = const_cast<void *>(__user_context);
  void *_0 = _halide_buffer_get_host(_buf_buffer);
- void * _buf = _0;
+ void * HALIDE_RESTRICT _buf = _0;
  {
   int64_t _1 = 43;
   int64_t _2 = _1 * _beta;
@@ -2863,7 +2936,7 @@ int test1(struct halide_buffer_t *_buf_buffer, float _alpha, int32_t _beta, void
    return -1;
   } // overflow test tmp.heap
   int64_t _3 = _2;
-  int32_t *_tmp_heap = (int32_t  *)halide_malloc(_ucon, sizeof(int32_t )*_3);
+  int32_t *HALIDE_RESTRICT _tmp_heap = (int32_t  *)halide_malloc(_ucon, sizeof(int32_t )*_3);
   if (!_tmp_heap)
   {
    int32_t _4 = halide_error_out_of_memory(_ucon);
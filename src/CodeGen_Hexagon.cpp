@@ -192,7 +192,9 @@ bool is_dense_ramp(const Expr &x) {
 
 // In Hexagon, we assume that we can read one vector past the end of
 // buffers. Using this assumption, this mutator replaces vector
-// predicated dense loads with scalar predicated dense loads.
+// predicated dense loads with scalar predicated dense loads. Dense
+// predicated stores are left alone (they become native predicated HVX
+// stores); non-dense predicated loads and stores are scalarized.
 class SloppyUnpredicateLoadsAndStores : public IRMutator {
     using IRMutator::visit;
 
@@ -312,6 +314,21 @@ class SloppyUnpredicateLoadsAndStores : public IRMutator {
         if (const Broadcast *scalar_pred = predicate.as<Broadcast>()) {
             Stmt unpredicated_store = Store::make(op->name, value, index, op->param, const_true(lanes), op->alignment);
             return IfThenElse::make(scalar_pred->value, unpredicated_store);
+        } else if (is_dense_ramp(index)) {
+            // HVX has native vector predicates (Q registers), and LLVM
+            // lowers a masked store of an HVX vector to a predicated
+            // vS32b_qpred store, so keep dense predicated stores as-is
+            // and let codegen emit them as masked stores (see
+            // CodeGen_LLVM::codegen_predicated_vector_store). Element
+            // types LLVM can't predicate natively get scalarized by
+            // its masked-intrinsic legalization, which is no worse
+            // than scalarizing here.
+            if (predicate.same_as(op->predicate) &&
+                value.same_as(op->value) &&
+                index.same_as(op->index)) {
+                return op;
+            }
+            return Store::make(op->name, value, index, op->param, predicate, op->alignment);
         } else {
             string value_name = unique_name("scalarized_store_value");
             string index_name = unique_name("scalarized_store_index");
@@ -518,13 +535,20 @@ void CodeGen_Hexagon::compile_func(const LoweredFunc &f,
 
     debug(1) << "Unpredicating loads and stores...\n";
     // Replace dense vector predicated loads with sloppy scalarized
-    // predicates, and scalarize predicated stores
+    // predicates, and scalarize non-dense predicated loads and stores.
+    // Dense predicated stores are kept for codegen as native
+    // predicated HVX stores.
     body = sloppy_unpredicate_loads_and_stores(body);
 
     debug(2) << "Lowering after unpredicating loads/stores:\n"
              << body << "\n\n";
 
     if (is_hvx_v65_or_later()) {
+        // Spill the coldest VTCM allocations to DDR if the schedule
+        // asks for more VTCM than the target has.
+        debug(1) << "Planning VTCM usage...\n";
+        body = plan_vtcm_budget(body);
+
         // Generate vscatter-vgathers before optimize_hexagon_shuffles.
         debug(1) << "Looking for vscatter-vgather...\n";
         body = scatter_gather_generator(body);
@@ -1966,24 +1990,26 @@ void CodeGen_Hexagon::visit(const Call *op) {
     }
 
     if (op->is_intrinsic(Call::prefetch)) {
-        internal_assert((op->args.size() == 4) || (op->args.size() == 6))
+        internal_assert((op->args.size() == 6) || (op->args.size() == 8))
             << "Hexagon only supports 1D or 2D prefetch\n";
 
+        // The read/write and locality hints (args 2 and 3) have no
+        // equivalent in Hexagon's l2fetch, so they are ignored here.
         vector<llvm::Value *> args;
         args.push_back(
             codegen_buffer_pointer(codegen(op->args[0]), op->type, op->args[1]));
 
-        Expr extent_0_bytes = op->args[2] * op->args[3] * op->type.bytes();
+        Expr extent_0_bytes = op->args[4] * op->args[5] * op->type.bytes();
         args.push_back(codegen(extent_0_bytes));
 
         llvm::Function *prefetch_fn = nullptr;
         if (op->args.size() ==
-            4) {  // 1D prefetch: {base, offset, extent0, stride0}
+            6) {  // 1D prefetch: {base, offset, rw, locality, extent0, stride0}
             prefetch_fn = module->getFunction("_halide_prefetch");
-        } else {  // 2D prefetch: {base, offset, extent0, stride0, extent1, stride1}
+        } else {  // 2D prefetch: {base, offset, rw, locality, extent0, stride0, extent1, stride1}
             prefetch_fn = module->getFunction("_halide_prefetch_2d");
-            args.push_back(codegen(op->args[4]));
-            Expr stride_1_bytes = op->args[5] * op->type.bytes();
+            args.push_back(codegen(op->args[6]));
+            Expr stride_1_bytes = op->args[7] * op->type.bytes();
             args.push_back(codegen(stride_1_bytes));
         }
         internal_assert(prefetch_fn);
@@ -206,6 +206,7 @@ bool function_takes_user_context(const std::string &name) {
         "halide_error",
         "halide_free",
         "halide_malloc",
+        "halide_prefetch_distance",
         "halide_print",
         "halide_profiler_memory_allocate",
         "halide_profiler_memory_free",
@@ -756,6 +757,14 @@ void set_function_attributes_for_target(llvm::Function *fn, const Target &t) {
     // Turn off approximate reciprocals for division. It's too
     // inaccurate even for us.
     fn->addFnAttr("reciprocal-estimates", "none");
+
+    if (t.arch == Target::ARM && t.bits == 64 && t.has_feature(Target::ARMSME)) {
+        // Run the function body in streaming mode so that vector code
+        // executes on the SME/streaming engine. LLVM wraps the body in an
+        // smstart/smstop pair and legalizes fixed-width vectors through
+        // streaming-compatible SVE (NEON is not available while streaming).
+        fn->addFnAttr("aarch64_pstate_sm_body");
+    }
 }
 
 void embed_bitcode(llvm::Module *M, const string &halide_command) {
@@ -37,8 +37,9 @@
 
 namespace Halide {
 
-std::unique_ptr<llvm::Module> codegen_llvm(const Module &module, llvm::LLVMContext &context) {
+std::unique_ptr<llvm::Module> codegen_llvm(const Module &module, llvm::LLVMContext &context, bool fast_compile) {
     std::unique_ptr<Internal::CodeGen_LLVM> cg(Internal::CodeGen_LLVM::new_for_target(module.target(), context));
+    cg->set_fast_compile(fast_compile);
     return cg->compile(module);
 }
 
@@ -515,8 +516,12 @@ std::unique_ptr<llvm::Module> CodeGen_LLVM::finish_codegen() {
     internal_assert(!verifyModule(*module, &llvm::errs()));
     debug(2) << "Done generating llvm bitcode\n";
 
-    // Optimize
-    CodeGen_LLVM::optimize_module();
+    // Optimize, unless we're the fast tier of a tiered JIT compile,
+    // in which case getting a runnable module quickly matters more
+    // than code quality.
+    if (!fast_compile) {
+        CodeGen_LLVM::optimize_module();
+    }
 
     if (target.has_feature(Target::EmbedBitcode)) {
         std::string halide_command = "halide target=" + target.to_string();
@@ -781,7 +786,10 @@ void CodeGen_LLVM::compile_buffer(const Buffer<> &buf) {
     Constant *fields[] = {
         ConstantInt::get(i64_t, 0),                                         // device
         ConstantPointerNull::get(device_interface_t_type->getPointerTo()),  // device_interface
-        create_binary_blob(data_blob, buf.name() + ".data", constant),      // host
+        // Constant data is deduplicated by content, so that identical
+        // embedded images (e.g. weights repeated across the per-target
+        // variants of a multitarget compile) are stored once per binary.
+        create_binary_blob(data_blob, buf.name() + ".data", constant, constant),  // host
         ConstantInt::get(i64_t, halide_buffer_flag_host_dirty),             // flags
         ConstantStruct::get(type_t_type, type_fields),                      // type
         ConstantInt::get(i32_t, buf.dimensions()),                          // dimensions
@@ -1989,6 +1997,8 @@ void CodeGen_LLVM::visit(const Load *op) {
             }
 
             value = shuffle_vectors(flipped, indices);
+        } else if (use_native_vector_gather(op->type)) {
+            value = codegen_vector_gather(op->type, op->name, op->index);
         } else if (ramp) {
             // Gather without generating the indices as a vector
             Value *ptr = codegen_buffer_pointer(op->name, op->type.element_of(), ramp->base);
@@ -2220,6 +2230,11 @@ void CodeGen_LLVM::codegen_predicated_vector_store(const Store *op) {
 #endif
             add_tbaa_metadata(store_inst, op->name, slice_index);
         }
+    } else if (use_native_vector_scatter(op->value.type())) {
+        debug(4) << "Predicated vector scatter\n\t" << Stmt(op) << "\n";
+        Value *vpred = codegen(op->predicate);
+        Value *val = codegen(op->value);
+        codegen_vector_scatter(op->value.type(), op->name, op->index, val, vpred);
     } else {  // It's not dense vector store, we need to scalarize it
         debug(4) << "Scalarize predicated vector store\n";
         Type value_type = op->value.type().element_of();
@@ -2332,6 +2347,63 @@ Value *CodeGen_LLVM::codegen_dense_vector_load(const Load *load, Value *vpred, b
                                      load->alignment, vpred, slice_to_native);
 }
 
+llvm::Value *CodeGen_LLVM::codegen_vector_gather(const Type &type, const std::string &name,
+                                                 const Expr &index, llvm::Value *vpred) {
+    debug(4) << "Native vector gather:\n\t"
+             << "(" << type << ")" << name << "[" << index << "]\n";
+
+    internal_assert(type.is_vector());
+
+    // Compute a vector of pointers to the elements to load.
+    Value *vindex = codegen(index);
+    Value *base = codegen_buffer_pointer(name, type.element_of(), ConstantInt::get(i32_t, 0));
+    Value *vptr = builder->CreateInBoundsGEP(base, vindex);
+
+    if (vpred == nullptr) {
+        // An all-true mask.
+        vpred = ConstantInt::get(get_vector_type(i1_t, type.lanes()), 1);
+    }
+
+    // We only know the elements themselves are in bounds, so use the
+    // element alignment.
+    int align_bytes = type.element_of().bytes();
+    Value *passthru = UndefValue::get(llvm_type_of(type));
+#if LLVM_VERSION >= 110
+    Instruction *gather = builder->CreateMaskedGather(vptr, llvm::Align(align_bytes), vpred, passthru);
+#else
+    Instruction *gather = builder->CreateMaskedGather(vptr, align_bytes, vpred, passthru);
+#endif
+    add_tbaa_metadata(gather, name, index);
+    value = gather;
+    return value;
+}
+
+void CodeGen_LLVM::codegen_vector_scatter(const Type &type, const std::string &name,
+                                          const Expr &index, llvm::Value *val, llvm::Value *vpred) {
+    debug(4) << "Native vector scatter:\n\t"
+             << "(" << type << ")" << name << "[" << index << "]\n";
+
+    internal_assert(type.is_vector());
+
+    // Compute a vector of pointers to the elements to store to.
+    Value *vindex = codegen(index);
+    Value *base = codegen_buffer_pointer(name, type.element_of(), ConstantInt::get(i32_t, 0));
+    Value *vptr = builder->CreateInBoundsGEP(base, vindex);
+
+    if (vpred == nullptr) {
+        // An all-true mask.
+        vpred = ConstantInt::get(get_vector_type(i1_t, type.lanes()), 1);
+    }
+
+    int align_bytes = type.element_of().bytes();
+#if LLVM_VERSION >= 110
+    Instruction *scatter = builder->CreateMaskedScatter(val, vptr, llvm::Align(align_bytes), vpred);
+#else
+    Instruction *scatter = builder->CreateMaskedScatter(val, vptr, align_bytes, vpred);
+#endif
+    add_tbaa_metadata(scatter, name, index);
+}
+
 void CodeGen_LLVM::codegen_predicated_vector_load(const Load *op) {
     const Ramp *ramp = op->index.as<Ramp>();
     const IntImm *stride = ramp ? ramp->stride.as<IntImm>() : nullptr;
@@ -2362,6 +2434,9 @@ void CodeGen_LLVM::codegen_predicated_vector_load(const Load *op) {
 
         Value *flipped = codegen_dense_vector_load(flipped_load.as<Load>(), vpred);
         value = shuffle_vectors(flipped, indices);
+    } else if (use_native_vector_gather(op->type)) {
+        Value *vpred = codegen(op->predicate);
+        value = codegen_vector_gather(op->type, op->name, op->index, vpred);
     } else {  // It's not dense vector load, we need to scalarize it
         Expr load_expr = Load::make(op->type, op->name, op->index, op->image,
                                     op->param, const_true(op->type.lanes()), op->alignment);
@@ -3124,11 +3199,25 @@ void CodeGen_LLVM::visit(const Call *op) {
         llvm::CallInst *call = builder->CreateCall(base_fn->getFunctionType(), phi, call_args);
         value = call;
     } else if (op->is_intrinsic(Call::prefetch)) {
-        user_assert((op->args.size() == 4) && is_const_one(op->args[2]))
+        user_assert((op->args.size() == 6) && is_const_one(op->args[4]))
             << "Only prefetch of 1 cache line is supported.\n";
 
-        llvm::Function *prefetch_fn = module->getFunction("_halide_prefetch");
-        internal_assert(prefetch_fn);
+        // Select the runtime helper matching the read/write and locality
+        // hints. The plain _halide_prefetch is the read-to-L1 default.
+        const int64_t *rw = as_const_int(op->args[2]);
+        const int64_t *locality = as_const_int(op->args[3]);
+        internal_assert(rw && locality);
+        string fn_name = "_halide_prefetch";
+        if (*rw) {
+            fn_name += "_write";
+        }
+        if (*locality == 2) {
+            fn_name += "_l2";
+        } else if (*locality == 0) {
+            fn_name += "_nta";
+        }
+        llvm::Function *prefetch_fn = module->getFunction(fn_name);
+        internal_assert(prefetch_fn) << fn_name;
 
         vector<llvm::Value *> args;
         args.push_back(codegen_buffer_pointer(codegen(op->args[0]), op->type, op->args[1]));
@@ -3140,6 +3229,47 @@ void CodeGen_LLVM::visit(const Call *op) {
 
         value = builder->CreateCall(prefetch_fn, args);
 
+    } else if (op->is_intrinsic(Call::copy_memory)) {
+        internal_assert(op->args.size() == 6);
+        // The last arg is a sentinel carrying the element type being
+        // copied; the offsets and count are in units of it.
+        Type t = op->args[5].type();
+        llvm::Value *dst = codegen_buffer_pointer(codegen(op->args[0]), t, op->args[1]);
+        llvm::Value *src = codegen_buffer_pointer(codegen(op->args[2]), t, op->args[3]);
+        llvm::Value *count = builder->CreateIntCast(codegen(op->args[4]), i64_t, true);
+        llvm::Value *bytes = builder->CreateMul(count, ConstantInt::get(i64_t, t.bytes()));
+        builder->CreateMemCpy(dst, llvm::MaybeAlign(), src, llvm::MaybeAlign(), bytes);
+        value = ConstantInt::get(i32_t, 0);
+    } else if (op->is_intrinsic(Call::streaming_store)) {
+        internal_assert(op->args.size() == 3);
+        const Expr &index = op->args[1];
+        const Expr &val = op->args[2];
+        Type t = val.type();
+        llvm::Value *base = codegen(op->args[0]);
+        llvm::Value *v = codegen(val);
+        llvm::Value *ptr;
+        if (t.is_scalar()) {
+            ptr = codegen_buffer_pointer(base, t, index);
+        } else {
+            Expr dense_base = strided_ramp_base(index, 1);
+            internal_assert(dense_base.defined());
+            ptr = codegen_buffer_pointer(base, t.element_of(), dense_base);
+            ptr = builder->CreatePointerCast(ptr, llvm_type_of(t)->getPointerTo());
+        }
+        StoreInst *store = builder->CreateAlignedStore(v, ptr, llvm::Align(t.element_of().bytes()));
+        // The nontemporal metadata makes the backends select
+        // write-around stores (movnt on x86, stnp on aarch64) where
+        // they can.
+        llvm::MDNode *md = llvm::MDNode::get(*context,
+                                             llvm::ConstantAsMetadata::get(ConstantInt::get(i32_t, 1)));
+        store->setMetadata(llvm::LLVMContext::MD_nontemporal, md);
+        value = ConstantInt::get(i32_t, 0);
+    } else if (op->is_intrinsic(Call::streaming_fence)) {
+        // Non-temporal stores are not ordered with respect to later
+        // loads by the usual memory model; a release fence (or
+        // stronger, see CodeGen_X86) makes them visible.
+        builder->CreateFence(llvm::AtomicOrdering::Release);
+        value = ConstantInt::get(i32_t, 0);
     } else if (op->is_intrinsic(Call::signed_integer_overflow)) {
         user_error << "Signed integer overflow occurred during constant-folding. Signed"
                       " integer overflow for int32 and int64 is undefined behavior in"
@@ -3421,20 +3551,54 @@ Constant *CodeGen_LLVM::create_string_constant(const string &s) {
     }
 }
 
-Constant *CodeGen_LLVM::create_binary_blob(const vector<char> &data, const string &name, bool constant) {
+Constant *CodeGen_LLVM::create_binary_blob(const vector<char> &data, const string &name, bool constant, bool shared) {
     internal_assert(!data.empty());
     llvm::Type *type = ArrayType::get(i8_t, data.size());
-    GlobalVariable *global = new GlobalVariable(*module, type,
-                                                constant, GlobalValue::PrivateLinkage,
-                                                nullptr, name);
-    ArrayRef<unsigned char> data_array((const unsigned char *)&data[0], data.size());
-    global->setInitializer(ConstantDataArray::get(*context, data_array));
-    size_t alignment = 32;
-    size_t native_vector_bytes = (size_t)(native_vector_bits() / 8);
-    if (data.size() > alignment && native_vector_bytes > alignment) {
-        alignment = native_vector_bytes;
-    }
-    global->setAlignment(llvm::Align(alignment));
+    GlobalVariable *global;
+    if (shared) {
+        internal_assert(constant);
+        // Name the global after its contents and give it linkonce_odr
+        // linkage with an insignificant address, so that identical
+        // copies embedded in several objects -- notably the per-target
+        // variants produced by compile_multitarget -- collapse to a
+        // single copy at link time. The size is part of the name, so
+        // two blobs only share a symbol if a hash collision occurs on
+        // equal-length data.
+        uint64_t hash = 0xcbf29ce484222325ULL;  // FNV-1a
+        for (char c : data) {
+            hash ^= (uint8_t)c;
+            hash *= 0x100000001b3ULL;
+        }
+        std::ostringstream shared_name;
+        shared_name << "_halide_shared_constant_" << data.size() << "_" << std::hex << hash;
+        global = module->getNamedGlobal(shared_name.str());
+        if (global) {
+            internal_assert(global->getValueType() == type);
+        } else {
+            global = new GlobalVariable(*module, type,
+                                        constant, GlobalValue::LinkOnceODRLinkage,
+                                        nullptr, shared_name.str());
+            ArrayRef<unsigned char> data_array((const unsigned char *)&data[0], data.size());
+            global->setInitializer(ConstantDataArray::get(*context, data_array));
+            global->setUnnamedAddr(GlobalValue::UnnamedAddr::Global);
+            // The linker keeps whichever copy it sees first, so the
+            // alignment must not depend on this variant's vector
+            // width. 64 bytes covers every x86 tier.
+            global->setAlignment(llvm::Align(64));
+        }
+    } else {
+        global = new GlobalVariable(*module, type,
+                                    constant, GlobalValue::PrivateLinkage,
+                                    nullptr, name);
+        ArrayRef<unsigned char> data_array((const unsigned char *)&data[0], data.size());
+        global->setInitializer(ConstantDataArray::get(*context, data_array));
+        size_t alignment = 32;
+        size_t native_vector_bytes = (size_t)(native_vector_bits() / 8);
+        if (data.size() > alignment && native_vector_bytes > alignment) {
+            alignment = native_vector_bytes;
+        }
+        global->setAlignment(llvm::Align(alignment));
+    }
 
     Constant *zero = ConstantInt::get(i32_t, 0);
     Constant *zeros[] = {zero, zero};
@@ -4048,6 +4212,8 @@ void CodeGen_LLVM::visit(const Store *op) {
                 StoreInst *store = builder->CreateAlignedStore(slice_val, vec_ptr, llvm::Align(alignment));
                 add_tbaa_metadata(store, op->name, slice_index);
             }
+        } else if (use_native_vector_scatter(value_type)) {
+            codegen_vector_scatter(value_type, op->name, op->index, val);
         } else if (ramp) {
             Type ptr_type = value_type.element_of();
             Value *ptr = codegen_buffer_pointer(op->name, ptr_type, ramp->base);
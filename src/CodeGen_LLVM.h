@@ -72,6 +72,13 @@ public:
     /** Tell the code generator which LLVM context to use. */
     void set_context(llvm::LLVMContext &context);
 
+    /** Skip the LLVM mid-end optimization passes when compiling, to
+     * produce a module as quickly as possible at the cost of code
+     * quality. Used for the fast tier of tiered JIT compilation. */
+    void set_fast_compile(bool fast) {
+        fast_compile = fast;
+    }
+
     /** Initialize internal llvm state for the enabled targets. */
     static void initialize_llvm();
 
@@ -165,6 +172,9 @@ protected:
     /** Run all of llvm's optimization passes on the module. */
     void optimize_module();
 
+    /** See \ref set_fast_compile. */
+    bool fast_compile = false;
+
     /** Add an entry to the symbol table, hiding previous entries with
      * the same name. Call this when new values come into scope. */
     void sym_push(const std::string &name, llvm::Value *value);
@@ -287,8 +297,11 @@ protected:
     /** Put a string constant in the module as a global variable and return a pointer to it. */
     llvm::Constant *create_string_constant(const std::string &str);
 
-    /** Put a binary blob in the module as a global variable and return a pointer to it. */
-    llvm::Constant *create_binary_blob(const std::vector<char> &data, const std::string &name, bool constant = true);
+    /** Put a binary blob in the module as a global variable and return a
+     * pointer to it. If shared is true, the global is named by a hash of
+     * its contents and given linkonce_odr linkage, so identical blobs in
+     * separately-compiled objects fold to one copy at link time. */
+    llvm::Constant *create_binary_blob(const std::vector<char> &data, const std::string &name, bool constant = true, bool shared = false);
 
     /** Widen an llvm scalar into an llvm vector with the given number of lanes. */
     llvm::Value *create_broadcast(llvm::Value *, int lanes);
@@ -557,6 +570,31 @@ private:
                                            llvm::Value *vpred = nullptr, bool slice_to_native = true);
     llvm::Value *codegen_dense_vector_load(const Load *load, llvm::Value *vpred = nullptr, bool slice_to_native = true);
 
+    /** Emit a vector load with arbitrary indices as a single
+     * llvm.masked.gather, or a vector store with arbitrary indices as
+     * a single llvm.masked.scatter. vpred may be null, in which case
+     * an all-true mask is used. Only called when the target reports
+     * that the operation maps to a native instruction (see
+     * use_native_vector_gather and use_native_vector_scatter). */
+    // @{
+    llvm::Value *codegen_vector_gather(const Type &type, const std::string &name,
+                                       const Expr &index, llvm::Value *vpred = nullptr);
+    void codegen_vector_scatter(const Type &type, const std::string &name,
+                                const Expr &index, llvm::Value *val, llvm::Value *vpred = nullptr);
+    // @}
+
+    /** Can a vector load or store of the given type with arbitrary
+     * indices be lowered to a native gather or scatter instruction on
+     * this target? If not, such accesses are scalarized. */
+    // @{
+    virtual bool use_native_vector_gather(const Type &t) const {
+        return false;
+    }
+    virtual bool use_native_vector_scatter(const Type &t) const {
+        return false;
+    }
+    // @}
+
     virtual void codegen_predicated_vector_load(const Load *op);
     virtual void codegen_predicated_vector_store(const Store *op);
 
@@ -572,9 +610,12 @@ private:
 
 }  // namespace Internal
 
-/** Given a Halide module, generate an llvm::Module. */
+/** Given a Halide module, generate an llvm::Module. If fast_compile
+ * is true, skip the LLVM mid-end optimization passes; see
+ * CodeGen_LLVM::set_fast_compile. */
 std::unique_ptr<llvm::Module> codegen_llvm(const Module &module,
-                                           llvm::LLVMContext &context);
+                                           llvm::LLVMContext &context,
+                                           bool fast_compile = false);
 
 }  // namespace Halide
 
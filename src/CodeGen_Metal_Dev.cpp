@@ -419,6 +419,45 @@ void CodeGen_Metal_Dev::CodeGen_Metal_C::visit(const Load *op) {
 }
 
 void CodeGen_Metal_Dev::CodeGen_Metal_C::visit(const Store *op) {
+    // A store of a simdgroup multiply-accumulate (see
+    // GPUMatrixOps.cpp) stands for a cooperative operation on a
+    // whole 8x8 tile; the store itself is performed by
+    // simdgroup_store.
+    if (const Call *mma = op->value.as<Call>()) {
+        if (mma->call_type == Call::Extern &&
+            mma->name == "metal_simdgroup_mma") {
+            internal_assert(mma->args.size() == 6);
+            const Load *a = mma->args[2].as<Load>();
+            const Load *b = mma->args[4].as<Load>();
+            internal_assert(a && b);
+            const char *frag_type =
+                (op->value.type().bits() == 16) ? "simdgroup_half8x8" : "simdgroup_float8x8";
+            string c_ptr = print_name(op->name) + " + " + print_expr(op->index);
+            string c_stride = print_expr(mma->args[1]);
+            string a_ptr = print_name(a->name) + " + " + print_expr(a->index);
+            string a_stride = print_expr(mma->args[3]);
+            string b_ptr = print_name(b->name) + " + " + print_expr(b->index);
+            string b_stride = print_expr(mma->args[5]);
+            string a_frag = print_name(unique_name("A_frag"));
+            string b_frag = print_name(unique_name("B_frag"));
+            string c_frag = print_name(unique_name("C_frag"));
+            stream << get_indent() << frag_type << " "
+                   << a_frag << ", " << b_frag << ", " << c_frag << ";\n";
+            stream << get_indent() << "simdgroup_load(" << a_frag << ", "
+                   << a_ptr << ", " << a_stride << ");\n";
+            stream << get_indent() << "simdgroup_load(" << b_frag << ", "
+                   << b_ptr << ", " << b_stride << ");\n";
+            stream << get_indent() << "simdgroup_load(" << c_frag << ", "
+                   << c_ptr << ", " << c_stride << ");\n";
+            stream << get_indent() << "simdgroup_multiply_accumulate(" << c_frag << ", "
+                   << a_frag << ", " << b_frag << ", " << c_frag << ");\n";
+            stream << get_indent() << "simdgroup_store(" << c_frag << ", "
+                   << c_ptr << ", " << c_stride << ");\n";
+            cache.clear();
+            return;
+        }
+    }
+
     user_assert(is_const_one(op->predicate)) << "Predicated store is not supported inside Metal kernel.\n";
     user_assert(op->value.type().lanes() <= 4) << "Vectorization by widths greater than 4 is not supported by Metal -- type is " << op->value.type() << ".\n";
 
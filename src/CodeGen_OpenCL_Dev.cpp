@@ -989,7 +989,21 @@ void CodeGen_OpenCL_Dev::CodeGen_OpenCL_C::add_kernel(Stmt s,
                 stream << print_type(args[i].type) << " *"
                        << "restrict ";
             }
-            stream << print_name(args[i].name);
+            if (args[i].memory_type == MemoryType::GPUTexture) {
+                stream << print_name(args[i].name);
+            } else {
+                stream << print_name(args[i].name + "_raw");
+            }
+            // The runtime dispatches crops of device buffers by
+            // passing the byte offset of the crop within the
+            // allocation; the kernel preamble rebases the pointer.
+            // (Sub-buffers can't be used for this: many drivers
+            // reject offsets not aligned to
+            // CL_DEVICE_MEM_BASE_ADDR_ALIGN.) Unused for textures,
+            // but always present to keep the argument protocol
+            // uniform.
+            stream << ",\n const ulong "
+                   << print_name(args[i].name + "_byte_offset");
             Allocation alloc;
             alloc.type = args[i].type;
             allocations.push(args[i].name, alloc);
@@ -1043,6 +1057,23 @@ void CodeGen_OpenCL_Dev::CodeGen_OpenCL_C::add_kernel(Stmt s,
 
     open_scope();
 
+    // Rebase the buffer pointers by their crop offsets.
+    for (size_t i = 0; i < args.size(); i++) {
+        if (args[i].is_buffer &&
+            args[i].memory_type != MemoryType::GPUTexture) {
+            const char *const_flag = args[i].write ? "" : "const ";
+            stream << " " << get_memory_space(args[i].name) << " "
+                   << const_flag << print_type(args[i].type) << " *restrict "
+                   << print_name(args[i].name)
+                   << " = (" << get_memory_space(args[i].name) << " "
+                   << const_flag << print_type(args[i].type) << " *)"
+                   << "((" << get_memory_space(args[i].name) << " "
+                   << const_flag << "char *)"
+                   << print_name(args[i].name + "_raw")
+                   << " + " << print_name(args[i].name + "_byte_offset") << ");\n";
+        }
+    }
+
     // Reinterpret half args passed as uint16 back to half
     for (size_t i = 0; i < args.size(); i++) {
         if (!args[i].is_buffer &&
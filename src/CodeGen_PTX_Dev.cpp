@@ -90,6 +90,10 @@ protected:
     void codegen_vector_reduce(const VectorReduce *op, const Expr &init) override;
     // @}
 
+    /** Emit a warp-cooperative tensor core multiply-accumulate for a
+     * store of a cuda_warp_mma call (see GPUMatrixOps.cpp). */
+    void codegen_warp_mma(const Store *op, const Call *mma);
+
     std::string march() const;
     std::string mcpu() const override;
     std::string mattrs() const override;
@@ -268,6 +272,31 @@ void CodeGen_PTX_Dev::visit(const Call *op) {
         internal_assert(barrier0) << "Could not find PTX barrier intrinsic (llvm.nvvm.barrier0)\n";
         builder->CreateCall(barrier0);
         value = ConstantInt::get(i32_t, 0);
+    } else if (op->is_intrinsic(Call::gpu_named_barrier)) {
+        // A named barrier (bar.sync id, count) synchronizes a subset
+        // of a block's threads, which is what lets producer and
+        // consumer warps rendezvous without involving the rest of the
+        // block in a warp-specialized pipeline.
+        internal_assert(op->args.size() == 2) << "gpu_named_barrier() intrinsic takes a barrier id and a thread count.\n";
+        const auto *id_ptr = as_const_int(op->args[0]);
+        internal_assert(id_ptr && *id_ptr >= 0 && *id_ptr < 16) << "gpu_named_barrier() id must be a constant integer in [0, 15].\n";
+
+        llvm::Value *id = codegen(op->args[0]);
+        if (is_const_zero(op->args[1])) {
+            // A zero count means every thread in the block
+            // participates.
+            llvm::Function *barrier = module->getFunction("llvm.nvvm.barrier.sync");
+            internal_assert(barrier) << "Could not find PTX named barrier intrinsic (llvm.nvvm.barrier.sync)\n";
+            builder->CreateCall(barrier, {id});
+        } else {
+            // The count must be a multiple of the warp size at
+            // runtime; ptxas rejects bar.sync with other counts.
+            llvm::Value *count = codegen(op->args[1]);
+            llvm::Function *barrier = module->getFunction("llvm.nvvm.barrier.sync.cnt");
+            internal_assert(barrier) << "Could not find PTX named barrier intrinsic (llvm.nvvm.barrier.sync.cnt)\n";
+            builder->CreateCall(barrier, {id, count});
+        }
+        value = ConstantInt::get(i32_t, 0);
     } else if (op->name == "dp2a" || op->name == "dp4a") {
         // TODO: It would be better if CodeGen_LLVM could handle overloaded intrin calls by default.
         value = call_overloaded_intrin(op->type, op->name, op->args);
@@ -375,6 +404,17 @@ void CodeGen_PTX_Dev::visit(const Load *op) {
 }
 
 void CodeGen_PTX_Dev::visit(const Store *op) {
+    // A store of a warp multiply-accumulate (see GPUMatrixOps.cpp)
+    // stands for a cooperative operation on a whole 16x16 tile; the
+    // store itself is performed by wmma.store.d.
+    if (const Call *mma = op->value.as<Call>()) {
+        if (mma->call_type == Call::Extern &&
+            mma->name == "cuda_warp_mma") {
+            codegen_warp_mma(op, mma);
+            return;
+        }
+    }
+
     // Issue atomic store if we are inside an Atomic node.
     if (emit_atomic_stores) {
         user_assert(is_const_one(op->predicate)) << "Atomic update does not support predicated store.\n";
@@ -398,6 +438,74 @@ void CodeGen_PTX_Dev::visit(const Store *op) {
     CodeGen_LLVM::visit(op);
 }
 
+void CodeGen_PTX_Dev::codegen_warp_mma(const Store *op, const Call *mma) {
+    internal_assert(mma->args.size() == 6);
+    user_assert(target.get_cuda_capability_lower_bound() >= 70)
+        << "gpu_tensor_core requires a target with cuda_capability_70 "
+        << "or greater.\n";
+
+    // The arguments describe each operand as a load of its first
+    // element plus a row stride in elements.
+    const Load *load_c = mma->args[0].as<Load>();
+    const Load *load_a = mma->args[2].as<Load>();
+    const Load *load_b = mma->args[4].as<Load>();
+    internal_assert(load_c && load_a && load_b);
+
+    Type acc = mma->type;
+    internal_assert(acc == Float(32) || acc == Float(16));
+    const char *acc_suffix = acc.bits() == 32 ? "f32" : "f16";
+    // The f32 accumulator fragment holds eight floats; the f16 one
+    // holds four <2 x half> vectors.
+    const int acc_regs = acc.bits() == 32 ? 8 : 4;
+
+    auto wmma_intrin = [&](const string &name) {
+        llvm::Function *fn = module->getFunction(name);
+        internal_assert(fn) << "Could not find PTX tensor core intrinsic (" << name << ")\n";
+        return fn;
+    };
+    llvm::Function *wmma_load_a = wmma_intrin("llvm.nvvm.wmma.m16n16k16.load.a.row.stride.f16.p0i8");
+    llvm::Function *wmma_load_b = wmma_intrin("llvm.nvvm.wmma.m16n16k16.load.b.row.stride.f16.p0i8");
+    llvm::Function *wmma_load_c = wmma_intrin(string("llvm.nvvm.wmma.m16n16k16.load.c.row.stride.") + acc_suffix + ".p0i8");
+    llvm::Function *wmma_mma = wmma_intrin(string("llvm.nvvm.wmma.m16n16k16.mma.row.row.") + acc_suffix + "." + acc_suffix);
+    llvm::Function *wmma_store_d = wmma_intrin(string("llvm.nvvm.wmma.m16n16k16.store.d.row.stride.") + acc_suffix + ".p0i8");
+
+    auto operand_ptr = [&](const Load *load) {
+        Value *ptr = codegen_buffer_pointer(load->name, load->type, load->index);
+        return builder->CreatePointerBitCastOrAddrSpaceCast(ptr, i8_t->getPointerTo());
+    };
+    Value *c_ptr = operand_ptr(load_c);
+    Value *a_ptr = operand_ptr(load_a);
+    Value *b_ptr = operand_ptr(load_b);
+    Value *c_stride = codegen(mma->args[1]);
+    Value *a_stride = codegen(mma->args[3]);
+    Value *b_stride = codegen(mma->args[5]);
+
+    Value *a_frag = builder->CreateCall(wmma_load_a, {a_ptr, a_stride});
+    Value *b_frag = builder->CreateCall(wmma_load_b, {b_ptr, b_stride});
+    Value *c_frag = builder->CreateCall(wmma_load_c, {c_ptr, c_stride});
+
+    // The mma intrinsic takes the fragments as scalar arguments
+    // rather than as aggregates.
+    vector<Value *> mma_args;
+    for (unsigned i = 0; i < 8; i++) {
+        mma_args.push_back(builder->CreateExtractValue(a_frag, i));
+    }
+    for (unsigned i = 0; i < 8; i++) {
+        mma_args.push_back(builder->CreateExtractValue(b_frag, i));
+    }
+    for (unsigned i = 0; i < (unsigned)acc_regs; i++) {
+        mma_args.push_back(builder->CreateExtractValue(c_frag, i));
+    }
+    Value *d_frag = builder->CreateCall(wmma_mma, mma_args);
+
+    vector<Value *> store_args = {c_ptr};
+    for (unsigned i = 0; i < (unsigned)acc_regs; i++) {
+        store_args.push_back(builder->CreateExtractValue(d_frag, i));
+    }
+    store_args.push_back(c_stride);
+    builder->CreateCall(wmma_store_d, store_args);
+}
+
 void CodeGen_PTX_Dev::visit(const Atomic *op) {
     // CUDA requires all the threads in a warp to perform the same operations,
     // which means our mutex will lead to deadlock.
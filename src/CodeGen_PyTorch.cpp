@@ -49,15 +49,12 @@ void CodeGen_PyTorch::compile(const Module &module) {
     }
 
     for (const auto &f : module.functions()) {
-        if (target.has_feature(Target::CUDA)) {
-            compile(f, true);
-        } else {
-            compile(f, false);
-        }
+        compile(f, target.has_feature(Target::CUDA),
+                target.has_feature(Target::SpecializeStrides));
     }
 }
 
-void CodeGen_PyTorch::compile(const LoweredFunc &f, bool is_cuda) {
+void CodeGen_PyTorch::compile(const LoweredFunc &f, bool is_cuda, bool is_strided) {
     // Don't put non-external function declarations in headers.
     std::vector<std::string> namespaces;
     std::string simple_name = extract_namespaces(f.name, namespaces);
@@ -106,13 +103,23 @@ void CodeGen_PyTorch::compile(const LoweredFunc &f, bool is_cuda) {
         stream << get_indent() << "void* __user_context = (void*) &user_ctx;\n\n";
     }
 
-    stream << get_indent() << "// Check tensors have contiguous memory and are on the correct device\n";
+    // Pipelines built with specialize_strides accept tensors of any
+    // layout and dispatch to a dense fast path internally, so the
+    // wrapper passes the tensor's own strides through instead of
+    // demanding contiguous memory.
+    if (is_strided) {
+        stream << get_indent() << "// Check tensors are on the correct device\n";
+    } else {
+        stream << get_indent() << "// Check tensors have contiguous memory and are on the correct device\n";
+    }
     for (size_t i = 0; i < buffer_args.size(); i++) {
-        stream << get_indent();
-        stream
-            << "HLPT_CHECK_CONTIGUOUS("
-            << c_print_name(buffer_args[i].name)
-            << ");\n";
+        if (!is_strided) {
+            stream << get_indent();
+            stream
+                << "HLPT_CHECK_CONTIGUOUS("
+                << c_print_name(buffer_args[i].name)
+                << ");\n";
+        }
 
         if (is_cuda) {
             stream << get_indent();
@@ -135,7 +142,9 @@ void CodeGen_PyTorch::compile(const LoweredFunc &f, bool is_cuda) {
         stream
             << "Halide::Runtime::Buffer<" << tp << "> "
             << c_print_name(buffer_args[i].name)
-            << "_buffer = Halide::PyTorch::wrap<" << tp << ">("
+            << "_buffer = Halide::PyTorch::"
+            << (is_strided ? "wrap_strided" : "wrap")
+            << "<" << tp << ">("
             << c_print_name(buffer_args[i].name)
             << ");\n";
     }
@@ -314,6 +323,72 @@ inline int test1_th_(at::Tensor &_buf, float _alpha, int32_t _beta) {
         compare_src(src.str(), correct_src);
     }
 
+    {
+        // With specialize_strides the wrapper must accept tensors of
+        // any layout rather than demanding contiguous memory.
+        Module m("", Target("host-specialize_strides"));
+        m.append(LoweredFunc("test1", args, s, LinkageType::External));
+
+        std::ostringstream src;
+        CodeGen_PyTorch(src).compile(m);
+
+        std::string correct_src =
+            R"GOLDEN_CODE(#include "HalideBuffer.h"
+#include "HalidePyTorchHelpers.h"
+#include "torch/extension.h"
+
+struct halide_buffer_t;
+struct halide_filter_metadata_t;
+
+#ifndef HALIDE_MUST_USE_RESULT
+#ifdef __has_attribute
+#if __has_attribute(nodiscard)
+#define HALIDE_MUST_USE_RESULT [[nodiscard]]
+#elif __has_attribute(warn_unused_result)
+#define HALIDE_MUST_USE_RESULT __attribute__((warn_unused_result))
+#else
+#define HALIDE_MUST_USE_RESULT
+#endif
+#else
+#define HALIDE_MUST_USE_RESULT
+#endif
+#endif
+
+#ifndef HALIDE_FUNCTION_ATTRS
+#define HALIDE_FUNCTION_ATTRS
+#endif
+
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+HALIDE_FUNCTION_ATTRS
+int test1(struct halide_buffer_t *_buf_buffer, float _alpha, int32_t _beta);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+HALIDE_FUNCTION_ATTRS
+inline int test1_th_(at::Tensor &_buf, float _alpha, int32_t _beta) {
+    // Check tensors are on the correct device
+
+    // Wrap tensors in Halide buffers
+    Halide::Runtime::Buffer<int32_t> _buf_buffer = Halide::PyTorch::wrap_strided<int32_t>(_buf);
+
+    // Run Halide pipeline
+    int err = test1(_buf_buffer, _alpha, _beta);
+
+    AT_ASSERTM(err == 0, "Halide call failed");
+    return 0;
+}
+)GOLDEN_CODE";
+
+        compare_src(src.str(), correct_src);
+    }
+
     Target host_cuda("host-cuda-user_context");
     if (host_supports_target_device(host_cuda)) {
         Module m("", host_cuda);
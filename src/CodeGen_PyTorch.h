@@ -37,7 +37,7 @@ public:
     static void test();
 
 private:
-    void compile(const LoweredFunc &func, bool is_cuda);
+    void compile(const LoweredFunc &func, bool is_cuda, bool is_strided);
 };
 
 }  // namespace Internal
@@ -97,6 +97,9 @@ const WasmIntrinsic intrinsic_defs[] = {
     // Basically like ARM's SQRDMULH
     {"llvm.wasm.q15mulr.sat.signed", Int(16, 8), "q15mulr_sat_s", {Int(16, 8), Int(16, 8)}, Target::WasmSimd128},
 
+    // i32x4.dot_i16x8_s
+    {"llvm.wasm.dot", Int(32, 4), "dot_product", {Int(16, 8), Int(16, 8)}, Target::WasmSimd128},
+
     // Note that the inputs are *always* treated as signed, regardless of the output
     {"saturating_narrow_i16x16_to_i8x16", Int(8, 16), "saturating_narrow", {Int(16, 16)}, Target::WasmSimd128},
     {"saturating_narrow_i16x16_to_u8x16", UInt(8, 16), "saturating_narrow", {Int(16, 16)}, Target::WasmSimd128},
@@ -185,6 +188,8 @@ void CodeGen_WebAssembly::codegen_vector_reduce(const VectorReduce *op, const Ex
         {VectorReduce::Add, 2, i32(wild_i16x_), "pairwise_widening_add", Target::WasmSimd128},
         {VectorReduce::Add, 2, u32(wild_u16x_), "pairwise_widening_add", Target::WasmSimd128},
         {VectorReduce::Add, 2, i32(wild_u16x_), "pairwise_widening_add", Target::WasmSimd128},
+
+        {VectorReduce::Add, 2, i32(wild_i16x_) * i32(wild_i16x_), "dot_product", Target::WasmSimd128},
     };
     // clang-format on
 
@@ -264,11 +269,15 @@ string CodeGen_WebAssembly::mattrs() const {
     }
 
     if (target.has_feature(Target::WasmThreads)) {
-        s << sep << ",+atomics";
+        s << sep << "+atomics";
         sep = ",";
     }
 
-    if (target.has_feature(Target::WasmBulkMemory)) {
+    // Objects built with atomics can only be linked into a shared memory,
+    // and shared memories require bulk-memory for thread-safe
+    // initialization, so wasm_threads implies wasm_bulk_memory.
+    if (target.has_feature(Target::WasmBulkMemory) ||
+        target.has_feature(Target::WasmThreads)) {
         s << sep << "+bulk-memory";
         sep = ",";
     }
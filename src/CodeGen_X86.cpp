@@ -1,3 +1,4 @@
+#include "CodeGen_Internal.h"
 #include "CodeGen_Posix.h"
 #include "ConciseCasts.h"
 #include "Debug.h"
@@ -25,12 +26,23 @@ namespace {
 // existing flags, so that instruction patterns can just check for the
 // oldest feature flag that supports an instruction.
 Target complete_x86_target(Target t) {
+    if (t.has_feature(Target::AVX512_FP16)) {
+        // AVX512-FP16 first appears on Sapphire Rapids, and implies
+        // the scalar/conversion-only fp16 support that came before it.
+        t.set_feature(Target::AVX512_SapphireRapids);
+        t.set_feature(Target::F16C);
+        t.set_feature(Target::FMA);
+    }
     if (t.has_feature(Target::AVX512_SapphireRapids)) {
         t.set_feature(Target::AVX512_Cannonlake);
+        t.set_feature(Target::AVX512_VNNI);
     }
     if (t.has_feature(Target::AVX512_Cannonlake)) {
         t.set_feature(Target::AVX512_Skylake);
     }
+    if (t.has_feature(Target::AVX512_VNNI)) {
+        t.set_feature(Target::AVX512_Skylake);
+    }
     if (t.has_feature(Target::AVX512_Cannonlake) ||
         t.has_feature(Target::AVX512_Skylake) ||
         t.has_feature(Target::AVX512_KNL)) {
@@ -58,10 +70,15 @@ protected:
     bool use_soft_float_abi() const override;
     int native_vector_bits() const override;
 
+    bool use_native_vector_gather(const Type &t) const override;
+    bool use_native_vector_scatter(const Type &t) const override;
+
     int vector_lanes_for_slice(const Type &t) const;
 
     llvm::Type *llvm_type_of(const Type &t) const override;
 
+    Type upgrade_type_for_arithmetic(const Type &t) const override;
+
     using CodeGen_Posix::visit;
 
     void init_module() override;
@@ -179,21 +196,21 @@ const x86Intrinsic intrinsic_defs[] = {
     {"dpbf16psx8", Float(32, 8), "dot_product", {Float(32, 8), BFloat(16, 16), BFloat(16, 16)}, Target::AVX512_SapphireRapids},
     {"dpbf16psx4", Float(32, 4), "dot_product", {Float(32, 4), BFloat(16, 8), BFloat(16, 8)}, Target::AVX512_SapphireRapids},
 
-    {"dpbusdx16", Int(32, 16), "dot_product", {Int(32, 16), UInt(8, 64), Int(8, 64)}, Target::AVX512_SapphireRapids},
-    {"dpbusdx8", Int(32, 8), "dot_product", {Int(32, 8), UInt(8, 32), Int(8, 32)}, Target::AVX512_SapphireRapids},
-    {"dpbusdx4", Int(32, 4), "dot_product", {Int(32, 4), UInt(8, 16), Int(8, 16)}, Target::AVX512_SapphireRapids},
+    {"dpbusdx16", Int(32, 16), "dot_product", {Int(32, 16), UInt(8, 64), Int(8, 64)}, Target::AVX512_VNNI},
+    {"dpbusdx8", Int(32, 8), "dot_product", {Int(32, 8), UInt(8, 32), Int(8, 32)}, Target::AVX512_VNNI},
+    {"dpbusdx4", Int(32, 4), "dot_product", {Int(32, 4), UInt(8, 16), Int(8, 16)}, Target::AVX512_VNNI},
 
-    {"dpwssdx16", Int(32, 16), "dot_product", {Int(32, 16), Int(16, 32), Int(16, 32)}, Target::AVX512_SapphireRapids},
-    {"dpwssdx8", Int(32, 8), "dot_product", {Int(32, 8), Int(16, 16), Int(16, 16)}, Target::AVX512_SapphireRapids},
-    {"dpwssdx4", Int(32, 4), "dot_product", {Int(32, 4), Int(16, 8), Int(16, 8)}, Target::AVX512_SapphireRapids},
+    {"dpwssdx16", Int(32, 16), "dot_product", {Int(32, 16), Int(16, 32), Int(16, 32)}, Target::AVX512_VNNI},
+    {"dpwssdx8", Int(32, 8), "dot_product", {Int(32, 8), Int(16, 16), Int(16, 16)}, Target::AVX512_VNNI},
+    {"dpwssdx4", Int(32, 4), "dot_product", {Int(32, 4), Int(16, 8), Int(16, 8)}, Target::AVX512_VNNI},
 
-    {"dpbusdsx16", Int(32, 16), "saturating_dot_product", {Int(32, 16), UInt(8, 64), Int(8, 64)}, Target::AVX512_SapphireRapids},
-    {"dpbusdsx8", Int(32, 8), "saturating_dot_product", {Int(32, 8), UInt(8, 32), Int(8, 32)}, Target::AVX512_SapphireRapids},
-    {"dpbusdsx4", Int(32, 4), "saturating_dot_product", {Int(32, 4), UInt(8, 16), Int(8, 16)}, Target::AVX512_SapphireRapids},
+    {"dpbusdsx16", Int(32, 16), "saturating_dot_product", {Int(32, 16), UInt(8, 64), Int(8, 64)}, Target::AVX512_VNNI},
+    {"dpbusdsx8", Int(32, 8), "saturating_dot_product", {Int(32, 8), UInt(8, 32), Int(8, 32)}, Target::AVX512_VNNI},
+    {"dpbusdsx4", Int(32, 4), "saturating_dot_product", {Int(32, 4), UInt(8, 16), Int(8, 16)}, Target::AVX512_VNNI},
 
-    {"dpwssdsx16", Int(32, 16), "saturating_dot_product", {Int(32, 16), Int(16, 32), Int(16, 32)}, Target::AVX512_SapphireRapids},
-    {"dpwssdsx8", Int(32, 8), "saturating_dot_product", {Int(32, 8), Int(16, 16), Int(16, 16)}, Target::AVX512_SapphireRapids},
-    {"dpwssdsx4", Int(32, 4), "saturating_dot_product", {Int(32, 4), Int(16, 8), Int(16, 8)}, Target::AVX512_SapphireRapids},
+    {"dpwssdsx16", Int(32, 16), "saturating_dot_product", {Int(32, 16), Int(16, 32), Int(16, 32)}, Target::AVX512_VNNI},
+    {"dpwssdsx8", Int(32, 8), "saturating_dot_product", {Int(32, 8), Int(16, 16), Int(16, 16)}, Target::AVX512_VNNI},
+    {"dpwssdsx4", Int(32, 4), "saturating_dot_product", {Int(32, 4), Int(16, 8), Int(16, 8)}, Target::AVX512_VNNI},
 };
 // clang-format on
 
@@ -403,6 +420,43 @@ void CodeGen_X86::visit(const Select *op) {
 }
 
 void CodeGen_X86::visit(const Cast *op) {
+    Type src = op->value.type();
+    Type dst = op->type;
+
+    // With F16C we have native conversion instructions between float16
+    // and float32, so there's no need to lower these casts to bitwise
+    // math. Note that bfloat16 is deliberately excluded; it has no
+    // conversion-to instruction before Sapphire Rapids, and the
+    // f32_to_bf16 pattern below handles that case.
+    if (target.has_feature(Target::F16C) &&
+        src.is_float() && !src.is_bfloat() &&
+        dst.is_float() && !dst.is_bfloat() &&
+        (src.bits() == 16 || dst.bits() == 16)) {
+        if (src == dst) {
+            value = codegen(op->value);
+        } else if (src.bits() == 16 && dst.bits() == 32) {
+            llvm::Type *half = op->type.is_vector() ? get_vector_type(f16_t, dst.lanes()) : f16_t;
+            Value *v = codegen(op->value);
+            // Values of type float16 are represented as uint16 unless
+            // AVX512-FP16 makes them a native arithmetic type.
+            if (v->getType() != half) {
+                v = builder->CreateBitCast(v, half);
+            }
+            value = builder->CreateFPExt(v, llvm_type_of(dst));
+        } else if (src.bits() == 32 && dst.bits() == 16) {
+            llvm::Type *half = op->type.is_vector() ? get_vector_type(f16_t, dst.lanes()) : f16_t;
+            Value *v = builder->CreateFPTrunc(codegen(op->value), half);
+            if (llvm_type_of(dst) != half) {
+                v = builder->CreateBitCast(v, llvm_type_of(dst));
+            }
+            value = v;
+        } else {
+            // float16 <-> float64 and other widths round-trip through
+            // float32, which matches what the emulation does.
+            codegen(cast(dst, cast(Float(32, dst.lanes()), op->value)));
+        }
+        return;
+    }
 
     if (!op->type.is_vector()) {
         // We only have peephole optimizations for vectors in here.
@@ -478,6 +532,16 @@ void CodeGen_X86::visit(const Cast *op) {
 }
 
 void CodeGen_X86::visit(const Call *op) {
+    if (op->is_intrinsic(Call::streaming_fence)) {
+        // A release fence compiles to nothing on x86, but
+        // non-temporal stores are only ordered by sfence.
+        llvm::Function *sfence =
+            llvm::Intrinsic::getDeclaration(module.get(), llvm::Intrinsic::x86_sse_sfence);
+        builder->CreateCall(sfence);
+        value = ConstantInt::get(i32_t, 0);
+        return;
+    }
+
 #if LLVM_VERSION < 110
     if (op->is_intrinsic(Call::widening_mul) && (op->type.is_int() || op->type.is_uint())) {
         // Widening integer multiply of non-power-of-two vector sizes is
@@ -648,11 +712,21 @@ string CodeGen_X86::mattrs() const {
         if (target.has_feature(Target::AVX512_Cannonlake)) {
             features += ",+avx512ifma,+avx512vbmi";
         }
+        if (target.has_feature(Target::AVX512_VNNI)) {
+            features += ",+avx512vnni";
+        }
         if (target.has_feature(Target::AVX512_SapphireRapids)) {
 #if LLVM_VERSION >= 120
-            features += ",+avx512bf16,+avx512vnni";
+            features += ",+avx512bf16";
 #else
             user_error << "AVX512 SapphireRapids requires LLVM 12 or later.";
+#endif
+        }
+        if (target.has_feature(Target::AVX512_FP16)) {
+#if LLVM_VERSION >= 140
+            features += ",+avx512fp16";
+#else
+            user_error << "AVX512 FP16 requires LLVM 14 or later.";
 #endif
         }
     }
@@ -677,6 +751,33 @@ int CodeGen_X86::native_vector_bits() const {
     }
 }
 
+bool CodeGen_X86::use_native_vector_gather(const Type &t) const {
+    if (!t.is_vector() || (t.bits() != 32 && t.bits() != 64)) {
+        // vgather only handles 32- and 64-bit elements.
+        return false;
+    }
+    if (target.has_feature(Target::AVX512) ||
+        target.has_feature(Target::AVX512_KNL) ||
+        target.has_feature(Target::AVX512_Skylake) ||
+        target.has_feature(Target::AVX512_Cannonlake)) {
+        return true;
+    }
+    // AVX2 gathers are microcoded on some chips and only a clear win
+    // over scalar loads at full vector width.
+    return target.has_feature(Target::AVX2) && t.bits() * t.lanes() >= 256;
+}
+
+bool CodeGen_X86::use_native_vector_scatter(const Type &t) const {
+    // vscatter requires AVX-512.
+    if (!t.is_vector() || (t.bits() != 32 && t.bits() != 64)) {
+        return false;
+    }
+    return target.has_feature(Target::AVX512) ||
+           target.has_feature(Target::AVX512_KNL) ||
+           target.has_feature(Target::AVX512_Skylake) ||
+           target.has_feature(Target::AVX512_Cannonlake);
+}
+
 int CodeGen_X86::vector_lanes_for_slice(const Type &t) const {
     // We don't want to pad all the way out to natural_vector_size,
     // because llvm generates crappy code. Better to use a smaller
@@ -693,6 +794,11 @@ int CodeGen_X86::vector_lanes_for_slice(const Type &t) const {
 
 llvm::Type *CodeGen_X86::llvm_type_of(const Type &t) const {
     if (t.is_float() && t.bits() < 32) {
+        if (!t.is_bfloat() && target.has_feature(Target::AVX512_FP16)) {
+            // With AVX512-FP16, float16 is a native arithmetic type
+            // and the workaround below would only get in the way.
+            return CodeGen_Posix::llvm_type_of(t);
+        }
         // LLVM as of August 2019 has all sorts of issues in the x86
         // backend for half types. It injects expensive calls to
         // convert between float and half for seemingly no reason
@@ -706,6 +812,16 @@ llvm::Type *CodeGen_X86::llvm_type_of(const Type &t) const {
     }
 }
 
+Type CodeGen_X86::upgrade_type_for_arithmetic(const Type &t) const {
+    if (t.is_float() && !t.is_bfloat() && t.bits() == 16 &&
+        target.has_feature(Target::AVX512_FP16)) {
+        // AVX512-FP16 has native float16 vector arithmetic, so there's
+        // no need to promote float16 math to float32.
+        return t;
+    }
+    return CodeGen_Posix::upgrade_type_for_arithmetic(t);
+}
+
 }  // namespace
 
 std::unique_ptr<CodeGen_Posix> new_CodeGen_X86(const Target &target) {
@@ -120,6 +120,23 @@ void JSONCompilerLogger::record_compilation_time(Phase phase, double duration) {
     compilation_time[phase] += duration;
 }
 
+void JSONCompilerLogger::record_lowering_pass_time(const std::string &pass_name, double duration,
+                                                   int64_t ir_nodes_before, int64_t ir_nodes_after) {
+    auto &t = lowering_pass_times[pass_name];
+    t.duration += duration;
+    t.ir_nodes_before = ir_nodes_before;
+    t.ir_nodes_after = ir_nodes_after;
+    t.invocations++;
+}
+
+void JSONCompilerLogger::record_ir_complexity(const std::string &pass_name, int64_t ir_nodes,
+                                              int64_t max_depth, int64_t max_let_depth) {
+    auto &t = lowering_pass_times[pass_name];
+    t.ir_nodes_after = ir_nodes;
+    t.max_depth = max_depth;
+    t.max_let_depth = max_let_depth;
+}
+
 void JSONCompilerLogger::obfuscate() {
     {
         std::map<std::string, std::vector<Expr>> n;
@@ -282,6 +299,24 @@ std::ostream &JSONCompilerLogger::emit_to_stream(std::ostream &o) {
         emit_key_value(o, indent, "compilation_time_llvm", compilation_time[Phase::LLVM]);
     }
 
+    if (!lowering_pass_times.empty()) {
+        emit_object_key_open(o, indent, "lowering_passes");
+
+        int commas_to_emit = (int)lowering_pass_times.size() - 1;
+        for (const auto &it : lowering_pass_times) {
+            emit_object_key_open(o, indent + 1, it.first);
+            emit_key_value(o, indent + 2, "time", it.second.duration);
+            emit_key_value(o, indent + 2, "invocations", it.second.invocations);
+            emit_key_value(o, indent + 2, "ir_nodes_before", it.second.ir_nodes_before);
+            emit_key_value(o, indent + 2, "ir_nodes_after", it.second.ir_nodes_after);
+            emit_key_value(o, indent + 2, "ir_max_depth", it.second.max_depth);
+            emit_key_value(o, indent + 2, "ir_max_let_depth", it.second.max_let_depth, false);
+            emit_object_key_close(o, indent + 1, commas_to_emit-- > 0);
+        }
+
+        emit_object_key_close(o, indent);
+    }
+
     if (!matched_simplifier_rules.empty()) {
         emit_object_key_open(o, indent, "matched_simplifier_rules");
 
@@ -53,6 +53,28 @@ public:
      */
     virtual void record_compilation_time(Phase phase, double duration) = 0;
 
+    /** Record the time (in seconds) spent in a single pass in lower(),
+     * along with the number of IR nodes in the stmt before and after
+     * the pass ran. Only called when per-pass timing is enabled (by
+     * setting the HL_TIME_LOWERING_PASSES env var); deliberately not
+     * pure virtual, so that existing custom implementations keep
+     * working. The default implementation ignores the record.
+     */
+    virtual void record_lowering_pass_time(const std::string &pass_name, double duration,
+                                           int64_t ir_nodes_before, int64_t ir_nodes_after) {
+    }
+
+    /** Record the structural complexity of the stmt after a single pass
+     * in lower(): the number of distinct IR nodes, the maximum
+     * expression depth, and the deepest Let/LetStmt nesting. Only
+     * called when per-pass instrumentation is enabled (by setting the
+     * HL_TIME_LOWERING_PASSES or HL_IR_COMPLEXITY_BUDGET env vars);
+     * not pure virtual for the same reason as above.
+     */
+    virtual void record_ir_complexity(const std::string &pass_name, int64_t ir_nodes,
+                                      int64_t max_depth, int64_t max_let_depth) {
+    }
+
     /**
      * Emit all the gathered data to the given stream. This may be called multiple times.
      */
@@ -90,6 +112,10 @@ public:
     void record_failed_to_prove(Expr failed_to_prove, Expr original_expr) override;
     void record_object_code_size(uint64_t bytes) override;
     void record_compilation_time(Phase phase, double duration) override;
+    void record_lowering_pass_time(const std::string &pass_name, double duration,
+                                   int64_t ir_nodes_before, int64_t ir_nodes_after) override;
+    void record_ir_complexity(const std::string &pass_name, int64_t ir_nodes,
+                              int64_t max_depth, int64_t max_let_depth) override;
 
     std::ostream &emit_to_stream(std::ostream &o) override;
 
@@ -116,6 +142,19 @@ protected:
     // Map of the time take for each phase of compilation.
     std::map<Phase, double> compilation_time;
 
+    // Per-pass timing and IR size info gathered during lower(), keyed by
+    // pass name. Times and invocations accumulate if lower() runs more
+    // than once; the node counts are those of the most recent run.
+    struct LoweringPassTime {
+        double duration{0};
+        int64_t ir_nodes_before{0};
+        int64_t ir_nodes_after{0};
+        int64_t max_depth{0};
+        int64_t max_let_depth{0};
+        int64_t invocations{0};
+    };
+    std::map<std::string, LoweringPassTime> lowering_pass_times;
+
     void obfuscate();
     void emit();
 };
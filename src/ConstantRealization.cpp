@@ -0,0 +1,587 @@
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Buffer.h"
+#include "ConstantRealization.h"
+#include "Debug.h"
+#include "Function.h"
+#include "IRMutator.h"
+#include "IROperator.h"
+#include "IRVisitor.h"
+#include "Simplify.h"
+#include "Substitute.h"
+#include "Util.h"
+
+namespace Halide {
+namespace Internal {
+
+using std::map;
+using std::pair;
+using std::string;
+using std::vector;
+
+namespace {
+
+// Caps on the size of a realization we're willing to evaluate at
+// compile time. The byte cap bounds the size of the constant buffer
+// embedded in the object; the element cap bounds the number of calls
+// to the simplifier we make while evaluating it.
+constexpr int64_t max_embedded_bytes = 64 * 1024;
+constexpr int64_t max_embedded_elems = 4096;
+
+bool scalar_type_supported(const Type &t) {
+    if (t.lanes() != 1 || t.bits() < 8) {
+        return false;
+    }
+    if (t.is_float()) {
+        // No compile-time evaluation of float16/bfloat16 values.
+        return t.bits() >= 32;
+    }
+    return t.is_int() || t.is_uint();
+}
+
+bool is_scalar_const(const Expr &e) {
+    return e.as<IntImm>() || e.as<UIntImm>() || e.as<FloatImm>();
+}
+
+// Get a constant integer, accepting both signed and unsigned
+// immediates.
+bool const_int_value(const Expr &e, int64_t *value) {
+    if (const IntImm *i = e.as<IntImm>()) {
+        *value = i->value;
+        return true;
+    } else if (const UIntImm *u = e.as<UIntImm>()) {
+        *value = (int64_t)u->value;
+        return true;
+    }
+    return false;
+}
+
+// Read the element of a host-allocated buffer at the given absolute
+// coordinates as a literal. Returns an undefined Expr if the
+// coordinates are out of range or the type is unsupported.
+Expr literal_from_buffer(const Buffer<> &im, const vector<int> &pos) {
+    const halide_buffer_t *b = im.raw_buffer();
+    if (b->host == nullptr || (int)pos.size() != im.dimensions()) {
+        return Expr();
+    }
+    int64_t offset = 0;
+    for (int i = 0; i < im.dimensions(); i++) {
+        if (pos[i] < b->dim[i].min ||
+            pos[i] >= b->dim[i].min + b->dim[i].extent) {
+            return Expr();
+        }
+        offset += (int64_t)(pos[i] - b->dim[i].min) * b->dim[i].stride;
+    }
+    Type t = im.type();
+    const uint8_t *ptr = b->host + offset * t.bytes();
+    if (t.is_int()) {
+        int64_t v = 0;
+        switch (t.bits()) {
+        case 8:
+            v = *(const int8_t *)ptr;
+            break;
+        case 16:
+            v = *(const int16_t *)ptr;
+            break;
+        case 32:
+            v = *(const int32_t *)ptr;
+            break;
+        case 64:
+            v = *(const int64_t *)ptr;
+            break;
+        default:
+            return Expr();
+        }
+        return IntImm::make(t, v);
+    } else if (t.is_uint()) {
+        uint64_t v = 0;
+        switch (t.bits()) {
+        case 8:
+            v = *(const uint8_t *)ptr;
+            break;
+        case 16:
+            v = *(const uint16_t *)ptr;
+            break;
+        case 32:
+            v = *(const uint32_t *)ptr;
+            break;
+        case 64:
+            v = *(const uint64_t *)ptr;
+            break;
+        default:
+            return Expr();
+        }
+        return UIntImm::make(t, v);
+    } else if (t.is_float()) {
+        if (t.bits() == 32) {
+            return FloatImm::make(t, *(const float *)ptr);
+        } else if (t.bits() == 64) {
+            return FloatImm::make(t, *(const double *)ptr);
+        }
+    }
+    return Expr();
+}
+
+// Write a literal into a buffer at the given zero-based coordinates.
+bool store_literal_in_buffer(Buffer<> &im, const vector<int> &pos, const Expr &val) {
+    halide_buffer_t *b = im.raw_buffer();
+    Type t = im.type();
+    if (val.type() != t) {
+        return false;
+    }
+    int64_t offset = 0;
+    for (int i = 0; i < im.dimensions(); i++) {
+        if (pos[i] < 0 || pos[i] >= b->dim[i].extent) {
+            return false;
+        }
+        offset += (int64_t)pos[i] * b->dim[i].stride;
+    }
+    uint8_t *ptr = b->host + offset * t.bytes();
+    if (const IntImm *i = val.as<IntImm>()) {
+        switch (t.bits()) {
+        case 8:
+            *(int8_t *)ptr = (int8_t)i->value;
+            break;
+        case 16:
+            *(int16_t *)ptr = (int16_t)i->value;
+            break;
+        case 32:
+            *(int32_t *)ptr = (int32_t)i->value;
+            break;
+        case 64:
+            *(int64_t *)ptr = i->value;
+            break;
+        default:
+            return false;
+        }
+        return true;
+    } else if (const UIntImm *u = val.as<UIntImm>()) {
+        switch (t.bits()) {
+        case 8:
+            *(uint8_t *)ptr = (uint8_t)u->value;
+            break;
+        case 16:
+            *(uint16_t *)ptr = (uint16_t)u->value;
+            break;
+        case 32:
+            *(uint32_t *)ptr = (uint32_t)u->value;
+            break;
+        case 64:
+            *(uint64_t *)ptr = u->value;
+            break;
+        default:
+            return false;
+        }
+        return true;
+    } else if (const FloatImm *f = val.as<FloatImm>()) {
+        if (t.bits() == 32) {
+            *(float *)ptr = (float)f->value;
+        } else if (t.bits() == 64) {
+            *(double *)ptr = f->value;
+        } else {
+            return false;
+        }
+        return true;
+    }
+    return false;
+}
+
+// Replace loads from host-allocated images at constant coordinates
+// with the literal value loaded. This is what makes chains of
+// constant LUTs foldable: once one Func has been embedded, producers
+// downstream of it see image loads rather than Func calls.
+class FoldConstantImageLoads : public IRMutator {
+    using IRMutator::visit;
+
+    Expr visit(const Call *op) override {
+        Expr e = IRMutator::visit(op);
+        op = e.as<Call>();
+        internal_assert(op);
+        if (op->call_type != Call::Image || !op->image.defined()) {
+            return e;
+        }
+        vector<int> pos;
+        for (const Expr &arg : op->args) {
+            int64_t c;
+            if (!const_int_value(arg, &c)) {
+                return e;
+            }
+            pos.push_back((int)c);
+        }
+        Expr lit = literal_from_buffer(op->image, pos);
+        if (lit.defined()) {
+            folded_something = true;
+            return lit;
+        }
+        return e;
+    }
+
+public:
+    bool folded_something = false;
+};
+
+// Evaluates the produce section of one realization, element by
+// element, using the simplifier as the interpreter. Any construct it
+// doesn't recognize, or any value that doesn't fold to a literal,
+// makes the whole evaluation fail.
+class RealizationEvaluator {
+public:
+    RealizationEvaluator(const string &func,
+                         const map<string, Expr> &constant_lets,
+                         Buffer<> &dst,
+                         const vector<int64_t> &mins)
+        : func(func), bindings(constant_lets), dst(dst), mins(mins) {
+        int64_t total = 1;
+        for (int i = 0; i < dst.dimensions(); i++) {
+            total *= dst.raw_buffer()->dim[i].extent;
+        }
+        covered.resize((size_t)total, false);
+    }
+
+    bool evaluate(const Stmt &produce) {
+        if (!eval_stmt(produce)) {
+            return false;
+        }
+        // Every element must have been stored, or the buffer would
+        // contain garbage where the runtime version would have had
+        // values.
+        for (bool c : covered) {
+            if (!c) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    const string &func;
+    map<string, Expr> bindings;
+    Buffer<> &dst;
+    const vector<int64_t> &mins;
+    vector<bool> covered;
+
+    bool eval_expr(const Expr &e, Expr *result) {
+        Expr v = simplify(substitute(bindings, e));
+        // Fold away any loads from already-embedded buffers, then
+        // give the simplifier another go, until a fixed point.
+        while (true) {
+            FoldConstantImageLoads folder;
+            Expr v2 = folder.mutate(v);
+            if (!folder.folded_something) {
+                break;
+            }
+            v = simplify(v2);
+        }
+        if (!is_scalar_const(v)) {
+            return false;
+        }
+        *result = v;
+        return true;
+    }
+
+    bool eval_stmt(const Stmt &s) {
+        if (const Block *op = s.as<Block>()) {
+            return eval_stmt(op->first) && eval_stmt(op->rest);
+        } else if (const LetStmt *op = s.as<LetStmt>()) {
+            Expr value;
+            if (!eval_expr(op->value, &value)) {
+                return false;
+            }
+            return eval_with_binding(op->name, value, op->body);
+        } else if (const For *op = s.as<For>()) {
+            if (op->for_type != ForType::Serial ||
+                op->device_api != DeviceAPI::None) {
+                return false;
+            }
+            Expr min_e, extent_e;
+            int64_t min_v, extent_v;
+            if (!eval_expr(op->min, &min_e) ||
+                !eval_expr(op->extent, &extent_e) ||
+                !const_int_value(min_e, &min_v) ||
+                !const_int_value(extent_e, &extent_v)) {
+                return false;
+            }
+            for (int64_t i = min_v; i < min_v + extent_v; i++) {
+                if (!eval_with_binding(op->name, IntImm::make(Int(32), i), op->body)) {
+                    return false;
+                }
+            }
+            return true;
+        } else if (const IfThenElse *op = s.as<IfThenElse>()) {
+            Expr cond;
+            if (!eval_expr(op->condition, &cond)) {
+                return false;
+            }
+            if (is_const_one(cond)) {
+                return eval_stmt(op->then_case);
+            } else if (op->else_case.defined()) {
+                return eval_stmt(op->else_case);
+            } else {
+                return true;
+            }
+        } else if (const AssertStmt *op = s.as<AssertStmt>()) {
+            Expr cond;
+            return eval_expr(op->condition, &cond) && is_const_one(cond);
+        } else if (const Provide *op = s.as<Provide>()) {
+            if (op->name != func || op->values.size() != 1) {
+                return false;
+            }
+            vector<int> pos;
+            int64_t linear = 0;
+            for (size_t i = 0; i < op->args.size(); i++) {
+                Expr arg;
+                int64_t c;
+                if (!eval_expr(op->args[i], &arg) ||
+                    !const_int_value(arg, &c)) {
+                    return false;
+                }
+                pos.push_back((int)(c - mins[i]));
+                linear += (int64_t)dst.raw_buffer()->dim[i].stride * pos.back();
+            }
+            Expr value;
+            if (!eval_expr(op->values[0], &value) ||
+                !store_literal_in_buffer(dst, pos, value)) {
+                return false;
+            }
+            covered[(size_t)linear] = true;
+            return true;
+        } else {
+            // Anything else (nested realizations, acquires, parallel
+            // or device loops, ...) means this producer isn't a
+            // compile-time constant.
+            return false;
+        }
+    }
+
+    bool eval_with_binding(const string &name, const Expr &value, const Stmt &body) {
+        auto it = bindings.find(name);
+        Expr old;
+        bool had_old = it != bindings.end();
+        if (had_old) {
+            old = it->second;
+        }
+        bindings[name] = value;
+        bool result = eval_stmt(body);
+        if (had_old) {
+            bindings[name] = old;
+        } else {
+            bindings.erase(name);
+        }
+        return result;
+    }
+};
+
+// Returns true if any Variable in the stmt refers to one of the
+// symbols derived from the given realization's name (e.g. its
+// .buffer, used when the Func is consumed by an extern stage).
+class UsesBufferSymbols : public IRVisitor {
+    using IRVisitor::visit;
+
+    void visit(const Variable *op) override {
+        if (starts_with(op->name, prefix)) {
+            result = true;
+        }
+    }
+
+    const string &prefix;
+
+public:
+    bool result = false;
+    UsesBufferSymbols(const string &prefix)
+        : prefix(prefix) {
+    }
+};
+
+class FoldConstantRealizations : public IRMutator {
+    using IRMutator::visit;
+
+    const map<string, Function> &env;
+
+    // Enclosing let bindings that have compile-time-constant values.
+    map<string, Expr> constant_lets;
+
+    // Funcs that have been replaced with embedded buffers.
+    map<string, Buffer<>> folded;
+
+    Stmt visit(const LetStmt *op) override {
+        Expr value = mutate(op->value);
+        Expr folded_value = simplify(substitute(constant_lets, value));
+        if (is_scalar_const(folded_value)) {
+            auto it = constant_lets.find(op->name);
+            Expr old;
+            bool had_old = it != constant_lets.end();
+            if (had_old) {
+                old = it->second;
+            }
+            constant_lets[op->name] = folded_value;
+            Stmt body = mutate(op->body);
+            if (had_old) {
+                constant_lets[op->name] = old;
+            } else {
+                constant_lets.erase(op->name);
+            }
+            return LetStmt::make(op->name, value, body);
+        }
+        return LetStmt::make(op->name, value, mutate(op->body));
+    }
+
+    Expr visit(const Call *op) override {
+        if (op->call_type == Call::Halide) {
+            auto it = folded.find(op->name);
+            if (it != folded.end()) {
+                vector<Expr> args;
+                args.reserve(op->args.size());
+                for (const Expr &arg : op->args) {
+                    args.push_back(mutate(arg));
+                }
+                return Call::make(it->second, args);
+            }
+        }
+        return IRMutator::visit(op);
+    }
+
+    Stmt visit(const ProducerConsumer *op) override {
+        if (folded.count(op->name)) {
+            if (op->is_producer) {
+                // The producer has already been evaluated.
+                return Evaluate::make(0);
+            } else {
+                return mutate(op->body);
+            }
+        }
+        return IRMutator::visit(op);
+    }
+
+    Stmt visit(const Realize *op) override {
+        Buffer<> buf = try_fold(op);
+        if (!buf.defined()) {
+            return IRMutator::visit(op);
+        }
+        debug(1) << "Realizing " << op->name << " at compile time as "
+                 << buf.name() << "\n";
+        folded[op->name] = buf;
+        Stmt stmt = mutate(op->body);
+        folded.erase(op->name);
+        return stmt;
+    }
+
+    // Attempt to evaluate one realization at compile time. Returns an
+    // undefined Buffer if it isn't a small compile-time constant.
+    Buffer<> try_fold(const Realize *op) {
+        auto env_it = env.find(op->name);
+        if (env_it == env.end()) {
+            return Buffer<>();
+        }
+        const Function &f = env_it->second;
+
+        if (!f.updates().empty() ||
+            f.has_extern_definition() ||
+            !f.definition().defined() ||
+            !f.definition().specializations().empty() ||
+            !f.schedule().compute_level().is_root() ||
+            !f.schedule().store_level().is_root() ||
+            f.schedule().memoized() ||
+            f.schedule().async() ||
+            f.is_tracing_loads() ||
+            f.is_tracing_stores() ||
+            f.is_tracing_realizations()) {
+            return Buffer<>();
+        }
+
+        if (op->types.size() != 1 ||
+            !scalar_type_supported(op->types[0]) ||
+            op->memory_type != MemoryType::Auto) {
+            return Buffer<>();
+        }
+
+        Expr condition = simplify(substitute(constant_lets, op->condition));
+        if (!is_const_one(condition)) {
+            return Buffer<>();
+        }
+
+        // The realized region must be a compile-time constant of
+        // modest size.
+        vector<int64_t> mins;
+        vector<int> extents;
+        int64_t elems = 1;
+        for (const Range &r : op->bounds) {
+            Expr min = simplify(substitute(constant_lets, r.min));
+            Expr extent = simplify(substitute(constant_lets, r.extent));
+            int64_t min_v, extent_v;
+            if (!const_int_value(min, &min_v) ||
+                !const_int_value(extent, &extent_v) ||
+                extent_v <= 0) {
+                return Buffer<>();
+            }
+            mins.push_back(min_v);
+            extents.push_back((int)extent_v);
+            elems *= extent_v;
+        }
+        if (elems > max_embedded_elems ||
+            elems * op->types[0].bytes() > max_embedded_bytes) {
+            return Buffer<>();
+        }
+
+        // If anything refers to the realization's buffer symbols
+        // (e.g. an extern consumer), it needs the allocation to
+        // exist.
+        UsesBufferSymbols uses_symbols(op->name + ".");
+        op->body.accept(&uses_symbols);
+        if (uses_symbols.result) {
+            return Buffer<>();
+        }
+
+        // Split the body into the producer and everything else. Any
+        // let bindings wrapping the block apply to both.
+        map<string, Expr> local_lets = constant_lets;
+        Stmt body = op->body;
+        while (const LetStmt *let = body.as<LetStmt>()) {
+            Expr value = simplify(substitute(local_lets, let->value));
+            if (is_scalar_const(value)) {
+                local_lets[let->name] = value;
+            }
+            body = let->body;
+        }
+        Stmt produce;
+        if (const Block *block = body.as<Block>()) {
+            body = block->first;
+        }
+        if (const ProducerConsumer *pc = body.as<ProducerConsumer>()) {
+            if (pc->is_producer && pc->name == op->name) {
+                produce = pc->body;
+            }
+        }
+        if (!produce.defined()) {
+            return Buffer<>();
+        }
+
+        Buffer<> buf(op->types[0], extents, unique_name(op->name + "_const"));
+        RealizationEvaluator evaluator(op->name, local_lets, buf, mins);
+        if (!evaluator.evaluate(produce)) {
+            return Buffer<>();
+        }
+        vector<int> min_coords;
+        for (int64_t m : mins) {
+            min_coords.push_back((int)m);
+        }
+        buf.set_min(min_coords);
+        return buf;
+    }
+
+public:
+    FoldConstantRealizations(const map<string, Function> &env)
+        : env(env) {
+    }
+};
+
+}  // namespace
+
+Stmt fold_constant_realizations(const Stmt &s, const map<string, Function> &env) {
+    return FoldConstantRealizations(env).mutate(s);
+}
+
+}  // namespace Internal
+}  // namespace Halide
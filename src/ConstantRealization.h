@@ -0,0 +1,31 @@
+#ifndef HALIDE_CONSTANT_REALIZATION_H
+#define HALIDE_CONSTANT_REALIZATION_H
+
+/** \file
+ * Defines a lowering pass that evaluates small constant realizations
+ * at compile time and embeds the results as static buffers.
+ */
+
+#include <map>
+#include <string>
+
+#include "Expr.h"
+
+namespace Halide {
+namespace Internal {
+
+class Function;
+
+/** Evaluate realizations of small pure compute_root Funcs at compile
+ * time when their bounds are compile-time constants and their values
+ * depend only on compile-time constants (e.g. an
+ * algorithmically-defined gamma LUT). The realization is replaced
+ * with loads from a constant buffer embedded in the generated object,
+ * saving the work of filling it at the start of every pipeline
+ * invocation, and the runtime allocation that would have held it. */
+Stmt fold_constant_realizations(const Stmt &s, const std::map<std::string, Function> &env);
+
+}  // namespace Internal
+}  // namespace Halide
+
+#endif
@@ -1946,6 +1946,69 @@ Func Derivative::operator()(const Param<> &param) const {
     return it->second;
 }
 
+void Derivative::default_schedule(const std::vector<Func> &outputs,
+                                  const Target &target) const {
+    std::map<std::string, Func> adjoint_by_name;
+    for (const auto &p : adjoints) {
+        adjoint_by_name[p.second.name()] = p.second;
+    }
+
+    std::map<std::string, Internal::Function> env;
+    for (const Func &output : outputs) {
+        std::map<std::string, Internal::Function> calls =
+            Internal::find_transitive_calls(output.function());
+        env.insert(calls.begin(), calls.end());
+        env[output.name()] = output.function();
+    }
+
+    for (const auto &p : env) {
+        auto it = adjoint_by_name.find(p.first);
+        if (it == adjoint_by_name.end()) {
+            continue;
+        }
+        Func func = it->second;
+        func.compute_root();
+        int vector_size = target.natural_vector_size(func.output_types()[0]);
+
+        vector<Var> args = func.args();
+        if (!args.empty()) {
+            func.vectorize(args[0], vector_size, TailStrategy::GuardWithIf);
+            if (args.size() > 1) {
+                func.parallel(args.back());
+            }
+        }
+
+        for (int id = 0; id < func.num_update_definitions(); id++) {
+            // The pure dimensions the scatter-to-gather conversion
+            // left in the update can be parallelized and vectorized;
+            // the adjoint accumulates with += over them, so recursive
+            // references are pure in the same dimensions. The
+            // reduction dimensions stay serial to keep the converted
+            // gathers race-free.
+            vector<Var> pure_args;
+            for (const Expr &arg : func.update_args(id)) {
+                const Internal::Variable *v = arg.as<Internal::Variable>();
+                if (v && !v->reduction_domain.defined() && !v->param.defined()) {
+                    pure_args.emplace_back(v->name);
+                }
+            }
+            if (pure_args.empty()) {
+                continue;
+            }
+            // Only vectorize if the innermost storage dimension is
+            // iterated purely, so the vector loads are dense.
+            if (!func.update_args(id).empty() &&
+                func.update_args(id)[0].as<Internal::Variable>() &&
+                pure_args.front().name() == args[0].name()) {
+                func.update(id).vectorize(pure_args.front(), vector_size, TailStrategy::GuardWithIf);
+            }
+            if (pure_args.back().name() != pure_args.front().name()) {
+                func.update(id).parallel(pure_args.back());
+            }
+        }
+    }
+}
+
 Derivative propagate_adjoints(const Func &output,
                               const Func &adjoint,
                               const Region &output_bounds) {
@@ -7,6 +7,7 @@
 
 #include "Expr.h"
 #include "Func.h"
+#include "Target.h"
 
 #include <map>
 #include <string>
@@ -36,6 +37,19 @@ public:
     Func operator()(const Buffer<> &buffer) const;
     Func operator()(const Param<> &param) const;
 
+    /** Apply a schedule tuned for the structure propagate_adjoints
+     * generates to every adjoint Func that the given outputs
+     * transitively call: each is computed at root, with the pure
+     * definition vectorized over the innermost dimension and
+     * parallelized over the outermost, and each update vectorized and
+     * parallelized over whatever pure dimensions the scatter-to-gather
+     * conversion left in it. Reduction dimensions are left serial, so
+     * the converted gathers stay race-free. Funcs the outputs don't
+     * reach, and non-adjoint Funcs, are untouched; schedules already
+     * present on an adjoint Func are overwritten. */
+    void default_schedule(const std::vector<Func> &outputs,
+                          const Target &target = get_target_from_environment()) const;
+
 private:
     const std::map<FuncKey, Func> adjoints;
 };
@@ -73,6 +73,20 @@ Dimension Dimension::set_stride(Expr stride) {
     return *this;
 }
 
+Dimension Dimension::set_stride_alignment(int alignment) {
+    user_assert(alignment > 0)
+        << "Stride alignment for dimension " << d
+        << " of Parameter " << param.name() << " must be positive\n";
+    // Constrain the stride to the nearest multiple of the alignment,
+    // which is only equal to the stride itself when the stride is a
+    // multiple of the alignment. Alignment inference
+    // (ModulusRemainder) can then prove the multiple-of property for
+    // addresses built from the constrained stride.
+    Expr s = stride();
+    param.set_stride_constraint(d, (s / alignment) * alignment);
+    return *this;
+}
+
 Dimension Dimension::set_bounds(Expr min, Expr extent) {
     return set_min(std::move(min)).set_extent(std::move(extent));
 }
@@ -89,6 +103,11 @@ Dimension Dimension::set_estimate(Expr min, Expr extent) {
     return *this;
 }
 
+Dimension Dimension::set_hot_extents(const std::vector<int> &extents) {
+    param.set_hot_extents(d, extents);
+    return *this;
+}
+
 Dimension Dimension::dim(int i) const {
     return Dimension(param, i, f);
 }
@@ -65,6 +65,23 @@ public:
      * generate better code. */
     Dimension set_stride(Expr stride);
 
+    /** Declare that the stride in a given dimension is a multiple of
+     * the given number of elements, without pinning it to a specific
+     * value. Combined with set_host_alignment, this lets codegen
+     * prove that vector loads and stores along lower dimensions stay
+     * aligned as outer loop variables advance, so aligned vector
+     * instructions get used instead of their unaligned forms. E.g.
+     * for a guaranteed-64-byte-aligned frame buffer of floats:
+     \code
+     im.set_host_alignment(64);
+     im.dim(1).set_stride_alignment(16);
+     \endcode
+     * A buffer whose stride is not a multiple of the given alignment
+     * will fail the generated runtime check. The alignment is in
+     * elements, not bytes, like set_stride. Replaces any constraint
+     * previously set with set_stride. */
+    Dimension set_stride_alignment(int alignment);
+
     /** Set the min and extent in one call. */
     Dimension set_bounds(Expr min, Expr extent);
 
@@ -72,6 +89,20 @@ public:
      * used by the auto-scheduler and/or the RunGen tool/ */
     Dimension set_estimate(Expr min, Expr extent);
 
+    /** Declare a set of "hot" extents for this dimension: sizes the
+     * pipeline is most frequently run at. Lowering emits a
+     * specialized copy of the pipeline body for each hot extent, in
+     * which the extent is a compile-time constant (so boundary
+     * checks, loop partitioning, and vector tails all fold), plus a
+     * generic fallback, with dispatch on the actual extent at
+     * entry. Unlike set_extent with a constant, this does not
+     * constrain the sizes the pipeline accepts. Each hot extent
+     * multiplies code size, so list only the sizes that matter. E.g:
+     \code
+     im.dim(1).set_hot_extents({1080, 2160});
+     \endcode */
+    Dimension set_hot_extents(const std::vector<int> &extents);
+
     Expr min_estimate() const;
     Expr extent_estimate() const;
 
@@ -5,6 +5,7 @@
  * Base classes for Halide expressions (\ref Halide::Expr) and statements (\ref Halide::Internal::Stmt)
  */
 
+#include <atomic>
 #include <string>
 #include <vector>
 
@@ -91,6 +92,16 @@ struct IRNode {
     }
     virtual ~IRNode() = default;
 
+    /** IR nodes are small, allocated in enormous numbers during
+     * lowering, and mostly die young, so when HL_IR_NODE_POOL is set
+     * they are allocated from a pool of recycled nodes instead of
+     * going to the system allocator for every make/destroy. See
+     * IR.cpp for the implementation. */
+    // @{
+    static void *operator new(size_t size);
+    static void operator delete(void *ptr, size_t size);
+    // @}
+
     /** These classes are all managed with intrusive reference
      * counting, so we also track a reference count. It's mutable
      * so that we can do reference counting even through const
@@ -127,13 +138,22 @@ inline void destroy<IRNode>(const IRNode *t) {
    statements are side-effecting pieces of code that do not
    represent a value (e.g. assert(x > 3)) */
 
-/** A base class for statement nodes. They have no properties or
-   methods beyond base IR nodes for now. */
+/** A base class for statement nodes. */
 struct BaseStmtNode : public IRNode {
     BaseStmtNode(IRNodeType t)
         : IRNode(t) {
     }
     virtual Stmt mutate_stmt(IRMutator *v) const = 0;
+
+    /** Nonzero if a simplifier pass has already put this statement
+     * into canonical form, so that the repeated whole-program
+     * simplify() calls during lowering can skip subtrees that no
+     * pass has rebuilt in the meantime. Mutators invalidate the
+     * stamp implicitly: rewriting a node allocates a fresh,
+     * unstamped one. Mutable and atomic for the same reason
+     * ref_count is: the simplifier sees IR through const handles,
+     * and those handles may be shared between threads. */
+    mutable std::atomic<uint32_t> simplify_stamp{0};
 };
 
 /** A base class for expression nodes. They all contain their types
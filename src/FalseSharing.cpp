@@ -0,0 +1,169 @@
+#include <algorithm>
+#include <set>
+#include <sstream>
+#include <utility>
+
+#include "Bounds.h"
+#include "Error.h"
+#include "FalseSharing.h"
+#include "IROperator.h"
+#include "IRVisitor.h"
+#include "Scope.h"
+#include "Simplify.h"
+#include "Substitute.h"
+
+namespace Halide {
+namespace Internal {
+
+using std::string;
+using std::vector;
+
+namespace {
+
+constexpr int64_t cache_line_bytes = 64;
+
+class FindFalseSharing : public IRVisitor {
+    using IRVisitor::visit;
+
+    // Bounds of every loop variable and let in scope, except the
+    // innermost parallel loop variable, which we want store indices
+    // to remain functions of.
+    Scope<Interval> scope;
+
+    // The innermost enclosing parallel loop, and its bounds.
+    string cur_par;
+    Interval par_interval;
+
+    // Product of the constant extents of the serial loops inside the
+    // parallel loop, for estimating per-iteration store volume.
+    int64_t iter_count = 1;
+    bool iter_count_known = true;
+
+    std::set<std::pair<string, string>> reported;
+
+    void visit(const For *op) override {
+        if (op->device_api != DeviceAPI::None &&
+            op->device_api != DeviceAPI::Host) {
+            // Device threads don't share the host cache hierarchy;
+            // leave device loops to the GPU-specific passes.
+            return;
+        }
+
+        op->min.accept(this);
+        op->extent.accept(this);
+
+        Interval iv(op->min, simplify(op->min + op->extent - 1));
+        if (op->is_unordered_parallel()) {
+            // The previous parallel variable becomes just another
+            // bounded variable for the analysis of deeper stores.
+            if (!cur_par.empty()) {
+                scope.push(cur_par, par_interval);
+            }
+            string old_par = cur_par;
+            Interval old_interval = par_interval;
+            int64_t old_count = iter_count;
+            bool old_known = iter_count_known;
+            cur_par = op->name;
+            par_interval = iv;
+            iter_count = 1;
+            iter_count_known = true;
+            op->body.accept(this);
+            cur_par = old_par;
+            par_interval = old_interval;
+            iter_count = old_count;
+            iter_count_known = old_known;
+            if (!cur_par.empty()) {
+                scope.pop(cur_par);
+            }
+        } else {
+            int64_t old_count = iter_count;
+            bool old_known = iter_count_known;
+            if (const int64_t *e = as_const_int(op->extent)) {
+                iter_count *= *e;
+            } else {
+                iter_count_known = false;
+            }
+            ScopedBinding<Interval> bind(scope, op->name, iv);
+            op->body.accept(this);
+            iter_count = old_count;
+            iter_count_known = old_known;
+        }
+    }
+
+    void visit(const LetStmt *op) override {
+        op->value.accept(this);
+        Interval vi = bounds_of_expr_in_scope(op->value, scope);
+        ScopedBinding<Interval> bind(scope, op->name, vi);
+        op->body.accept(this);
+    }
+
+    void visit(const Store *op) override {
+        IRVisitor::visit(op);
+
+        if (cur_par.empty() ||
+            reported.count({op->name, cur_par})) {
+            return;
+        }
+
+        Interval idx = bounds_of_expr_in_scope(op->index, scope);
+        if (!idx.has_lower_bound()) {
+            return;
+        }
+
+        // How far does the start of the stored region move between
+        // consecutive iterations of the parallel loop?
+        Expr next_min = substitute(cur_par, Variable::make(Int(32), cur_par) + 1, idx.min);
+        const int64_t *stride = as_const_int(simplify(next_min - idx.min));
+        if (!stride || *stride == 0) {
+            return;
+        }
+
+        int64_t stride_bytes = std::abs(*stride) * op->value.type().bytes();
+        if (stride_bytes >= cache_line_bytes) {
+            return;
+        }
+
+        int64_t volume = 0;
+        if (iter_count_known) {
+            volume = iter_count * op->value.type().bytes() * op->value.type().lanes();
+        }
+        reported.insert({op->name, cur_par});
+        warnings.push_back({op->name, cur_par, stride_bytes, volume});
+    }
+
+public:
+    vector<FalseSharingWarning> warnings;
+};
+
+}  // namespace
+
+vector<FalseSharingWarning> find_false_sharing(const Stmt &s) {
+    FindFalseSharing finder;
+    s.accept(&finder);
+    std::stable_sort(finder.warnings.begin(), finder.warnings.end(),
+                     [](const FalseSharingWarning &a, const FalseSharingWarning &b) {
+                         return a.bytes_per_iteration > b.bytes_per_iteration;
+                     });
+    return finder.warnings;
+}
+
+void report_false_sharing(const Stmt &s) {
+    for (const FalseSharingWarning &w : find_false_sharing(s)) {
+        std::ostringstream msg;
+        msg << "Stores to \"" << w.buffer << "\" advance only "
+            << w.stride_bytes << " bytes per iteration of the parallel loop \""
+            << w.loop << "\", so iterations running on different threads "
+            << "write to the same cache line (false sharing)";
+        if (w.bytes_per_iteration > 0) {
+            msg << "; roughly " << w.bytes_per_iteration
+                << " bytes are stored per iteration";
+        }
+        msg << ". Consider splitting the parallel loop so each task "
+            << "covers at least one cache line, or padding the storage "
+            << "(e.g. with align_storage).\n";
+        user_warning << msg.str();
+    }
+}
+
+}  // namespace Internal
+}  // namespace Halide
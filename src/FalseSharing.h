@@ -0,0 +1,49 @@
+#ifndef HALIDE_FALSE_SHARING_H
+#define HALIDE_FALSE_SHARING_H
+
+/** \file
+ * Defines an analysis that detects parallel loops whose iterations
+ * store to the same cache line (false sharing).
+ */
+
+#include <string>
+#include <vector>
+
+#include "Expr.h"
+
+namespace Halide {
+namespace Internal {
+
+/** A parallel loop whose consecutive iterations store within the same
+ * cache line, so the threads executing them will contend on it. */
+struct FalseSharingWarning {
+    /** The buffer being stored to. */
+    std::string buffer;
+    /** The parallel loop whose iterations share a line. */
+    std::string loop;
+    /** Bytes between the stores of consecutive iterations. */
+    int64_t stride_bytes;
+    /** Estimated bytes stored per iteration, when the enclosing loop
+     * extents are known at compile time; used to weight severity.
+     * Zero if unknown. */
+    int64_t bytes_per_iteration;
+};
+
+/** Scan a lowered statement (post storage flattening, so store
+ * indices are in flat element coordinates) for stores inside parallel
+ * loops where consecutive iterations -- which may run on different
+ * threads -- write within the same cache line. Returns the findings
+ * sorted by decreasing store volume. The usual fixes are splitting
+ * the parallel loop so each task covers whole lines, or padding the
+ * storage (e.g. with align_storage). */
+std::vector<FalseSharingWarning> find_false_sharing(const Stmt &s);
+
+/** Run the analysis above and report each finding with a
+ * user_warning. Enabled in lowering by setting the
+ * HL_CHECK_FALSE_SHARING environment variable. */
+void report_false_sharing(const Stmt &s);
+
+}  // namespace Internal
+}  // namespace Halide
+
+#endif
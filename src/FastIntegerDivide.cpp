@@ -111,6 +111,65 @@ Buffer<uint32_t> integer_divide_table_s32() {
         return im;
     }
 }
+
+// Shared evaluation of the multiply-and-shift forms, given a magic
+// multiplier and post-shift. These match the "runtime" methods from
+// find_inverse.cpp (methods 2 and 1 respectively from "Division by
+// Invariant Integers using Multiplication" by Granlund and Montgomery).
+Expr unsigned_divide_by_multiply_shift(const Expr &numerator, const Expr &mul, const Expr &shift) {
+    Type t = numerator.type();
+    Type wide = t.widen();
+
+    // Multiply-keep-high-half
+    Expr result = (cast(wide, mul) * numerator);
+
+    if (t.bits() < 32) {
+        result = result / (1 << t.bits());
+    } else {
+        result = result >> Internal::make_const(result.type(), t.bits());
+    }
+
+    result = cast(t, result);
+
+    // Add half the difference between input and output so far
+    result = result + (numerator - result) / 2;
+
+    // Do a final shift
+    result = result >> cast(result.type(), shift);
+
+    return result;
+}
+
+Expr signed_divide_by_multiply_shift(const Expr &numerator, const Expr &mul, const Expr &shift) {
+    Type t = numerator.type();
+    Type wide = t.widen();
+
+    // Extract sign bit
+    //Expr xsign = (t.bits() < 32) ? (numerator / (1 << (t.bits()-1))) : (numerator >> (t.bits()-1));
+    Expr xsign = select(numerator > 0, cast(t, 0), cast(t, -1));
+
+    // If it's negative, flip the bits of the
+    // numerator. Equivalent to:
+    // select(numerator < 0, -(numerator+1), numerator);
+    Expr num = xsign ^ numerator;
+
+    // Multiply-keep-high-half
+    Expr result = (cast(wide, mul) * num);
+    if (t.bits() < 32) {
+        result = result / (1 << t.bits());
+    } else {
+        result = result >> Internal::make_const(result.type(), t.bits());
+    }
+    result = cast(t, result);
+
+    // Do the final shift
+    result = result >> cast(result.type(), shift);
+
+    // Maybe flip the bits again
+    result = xsign ^ result;
+
+    return result;
+}
 }  // namespace
 
 Expr fast_integer_divide(Expr numerator, Expr denominator) {
@@ -126,8 +185,6 @@ Expr fast_integer_divide(Expr numerator, Expr denominator) {
     user_assert(t.bits() == 8 || t.bits() == 16 || t.bits() == 32)
         << "Fast integer divide requires a numerator with 8, 16, or 32 bits\n";
 
-    Type wide = t.widen();
-
     Expr result;
     if (t.is_uint()) {
         Expr mul, shift;
@@ -153,22 +210,7 @@ Expr fast_integer_divide(Expr numerator, Expr denominator) {
         }
         }
 
-        // Multiply-keep-high-half
-        result = (cast(wide, mul) * numerator);
-
-        if (t.bits() < 32) {
-            result = result / (1 << t.bits());
-        } else {
-            result = result >> Internal::make_const(result.type(), t.bits());
-        }
-
-        result = cast(t, result);
-
-        // Add half the difference between input and output so far
-        result = result + (numerator - result) / 2;
-
-        // Do a final shift
-        result = result >> cast(result.type(), shift);
+        result = unsigned_divide_by_multiply_shift(numerator, mul, shift);
 
     } else {
 
@@ -195,29 +237,7 @@ Expr fast_integer_divide(Expr numerator, Expr denominator) {
         }
         }
 
-        // Extract sign bit
-        //Expr xsign = (t.bits() < 32) ? (numerator / (1 << (t.bits()-1))) : (numerator >> (t.bits()-1));
-        Expr xsign = select(numerator > 0, cast(t, 0), cast(t, -1));
-
-        // If it's negative, flip the bits of the
-        // numerator. Equivalent to:
-        // select(numerator < 0, -(numerator+1), numerator);
-        numerator = xsign ^ numerator;
-
-        // Multiply-keep-high-half
-        result = (cast(wide, mul) * numerator);
-        if (t.bits() < 32) {
-            result = result / (1 << t.bits());
-        } else {
-            result = result >> Internal::make_const(result.type(), t.bits());
-        }
-        result = cast(t, result);
-
-        // Do the final shift
-        result = result >> cast(result.type(), shift);
-
-        // Maybe flip the bits again
-        result = xsign ^ result;
+        result = signed_divide_by_multiply_shift(numerator, mul, shift);
     }
 
     // The tables don't work for denominator == 1
@@ -233,4 +253,69 @@ Expr fast_integer_modulo(Expr numerator, Expr denominator) {
     return std::move(numerator) - ratio * std::move(denominator);
 }
 
+Expr fast_integer_divide_invariant(Expr numerator, Expr denominator) {
+    Type t = numerator.type();
+    user_assert(t.is_uint() || t.is_int())
+        << "Fast invariant integer divide requires an integer numerator\n";
+    user_assert(t.bits() == 8 || t.bits() == 16 || t.bits() == 32)
+        << "Fast invariant integer divide requires a numerator with 8, 16, or 32 bits\n";
+    user_assert(denominator.type() == UInt(t.bits()))
+        << "Fast invariant integer divide requires a UInt(" << t.bits() << ") denominator\n";
+
+    if (is_const(denominator)) {
+        // There's code elsewhere for this case.
+        return numerator / cast(t, std::move(denominator));
+    }
+
+    Type ut = t.with_code(halide_type_uint);
+    Type uwide = ut.widen();
+
+    // Compute the magic multiplier and post-shift from the divisor
+    // using the same formulas find_inverse.cpp uses to build the
+    // static tables. The computation involves a widening division,
+    // but it only depends on the divisor, so when the divisor is
+    // loop-invariant (e.g. an image stride passed as a Param), loop
+    // invariant code motion hoists it and the inner loop is just the
+    // multiply-and-shift form, which vectorizes cleanly.
+
+    // The formulas are not defined for divisors less than two. Clamp
+    // the divisor, and fix up division by one with the select
+    // below. Division by zero gives an unspecified result.
+    Expr d = max(denominator, Internal::make_const(ut, 2));
+
+    // clz(d - 1) == bits - ceil(log2(d)) for d >= 2
+    Expr clz = count_leading_zeros(d - 1);
+    Expr shift = cast(ut, t.bits() - 1) - clz;
+
+    Expr result;
+    if (t.is_uint()) {
+        // Method 2: mul = 2^(bits + shift + 1) / d - 2^bits + 1. We
+        // compute 2^(bits + shift + 1) - 1 instead by shifting down a
+        // wide all-ones value, so that the power doesn't overflow the
+        // wide type when d is large. That changes the quotient only
+        // when d is a power of two, for which the multiplier is
+        // irrelevant (the multiply-high produces zero either way, and
+        // the correction steps reduce to the right shift). The
+        // subtraction of 2^bits disappears in the narrowing cast.
+        Expr mul = cast(ut, (Internal::make_const(uwide, -1) >> cast(uwide, clz)) / cast(uwide, d) + 1);
+        result = unsigned_divide_by_multiply_shift(numerator, mul, shift);
+    } else {
+        // Method 1: mul = 2^(bits + shift) / d + 1
+        Expr mul = cast(ut, (Internal::make_one(uwide) << cast(uwide, shift + cast(ut, t.bits()))) / cast(uwide, d) + 1);
+        result = signed_divide_by_multiply_shift(numerator, mul, shift);
+    }
+
+    // The multiply-and-shift forms don't work for denominator == 1
+    result = select(std::move(denominator) == 1, std::move(numerator), result);
+
+    internal_assert(result.type() == t);
+
+    return result;
+}
+
+Expr fast_integer_modulo_invariant(Expr numerator, Expr denominator) {
+    Expr ratio = fast_integer_divide_invariant(numerator, denominator);
+    return std::move(numerator) - ratio * cast(numerator.type(), std::move(denominator));
+}
+
 }  // namespace Halide
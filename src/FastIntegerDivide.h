@@ -33,6 +33,27 @@ Expr fast_integer_divide(Expr numerator, Expr denominator);
  */
 Expr fast_integer_modulo(Expr numerator, Expr denominator);
 
+/** Integer division by a runtime divisor that is invariant over the
+ * inner loops, e.g. an image stride passed as a Param. Instead of
+ * looking up a table (which limits the divisor to a uint8), this
+ * computes a magic multiplier and shift directly from the divisor
+ * using the method of Granlund and Montgomery. The computation only
+ * depends on the divisor, so loop invariant code motion hoists it out
+ * of any loops over the numerator, and the multiply-and-shift that
+ * remains in the inner loop vectorizes well.
+ *
+ * The numerator may be any 8, 16, or 32 bit integer type, and the
+ * denominator must be the unsigned type of the same width. The type
+ * of the result is the type of the numerator. Division by zero gives
+ * an unspecified result.
+ */
+Expr fast_integer_divide_invariant(Expr numerator, Expr denominator);
+
+/** Use the invariant-divisor division above to implement a modulo
+ * operation via the Euclidean identity: a%b = a - (a/b)*b
+ */
+Expr fast_integer_modulo_invariant(Expr numerator, Expr denominator);
+
 }  // namespace Halide
 
 #endif
@@ -187,6 +187,49 @@ void Func::define_extern(const std::string &function_name,
                        device_api);
 }
 
+Func &Func::async_extern() {
+    invalidate_cache();
+    user_assert(func.has_extern_definition())
+        << "Func " << name() << " has no extern definition. "
+        << "Call define_extern before async_extern.\n";
+    user_assert(func.extern_function_device_api() == DeviceAPI::Host)
+        << "In async_extern for Func " << name()
+        << ": only host-side extern stages may be asynchronous.\n";
+    func.extern_definition_is_async() = true;
+    return *this;
+}
+
+Func &Func::raw_pointer_extern(const Expr &bounds_proxy) {
+    invalidate_cache();
+    user_assert(func.has_extern_definition())
+        << "Func " << name() << " has no extern definition. "
+        << "Call define_extern before raw_pointer_extern.\n";
+    user_assert(func.extern_function_device_api() == DeviceAPI::Host)
+        << "In raw_pointer_extern for Func " << name()
+        << ": only host-side extern stages may use the raw-pointer ABI.\n";
+    user_assert(!func.extern_definition_is_async())
+        << "In raw_pointer_extern for Func " << name()
+        << ": async extern stages may not use the raw-pointer ABI.\n";
+    user_assert(bounds_proxy.defined())
+        << "In raw_pointer_extern for Func " << name()
+        << ": the bounds proxy expression must be defined.\n";
+    func.extern_definition_proxy_expr() = bounds_proxy;
+    func.extern_definition_uses_raw_pointers() = true;
+    return *this;
+}
+
+Func &Func::extern_definition_proxy(const Expr &proxy) {
+    invalidate_cache();
+    user_assert(func.has_extern_definition())
+        << "Func " << name() << " has no extern definition. "
+        << "Call define_extern before extern_definition_proxy.\n";
+    user_assert(proxy.defined())
+        << "In extern_definition_proxy for Func " << name()
+        << ": the proxy expression must be defined.\n";
+    func.extern_definition_proxy_expr() = proxy;
+    return *this;
+}
+
 /** Get the types of the buffers returned by an extern definition. */
 const std::vector<Type> &Func::output_types() const {
     return func.output_types();
@@ -917,6 +960,73 @@ Func Stage::rfactor(vector<pair<RVar, Var>> preserved) {
     return intm;
 }
 
+Func Stage::parallel_reduce(const RVar &r, const Var &v, const Expr &num_tasks) {
+    user_assert(!definition.is_init()) << "parallel_reduce() must be called on an update definition\n";
+    user_assert(num_tasks.defined())
+        << "In schedule for " << name()
+        << ", parallel_reduce() requires a defined number of tasks\n";
+
+    // Find the extent of the reduction variable, so we can size the
+    // tasks to cover it.
+    const vector<ReductionVariable> &rvars = definition.schedule().rvars();
+    const auto &iter = std::find_if(rvars.begin(), rvars.end(),
+                                    [&r](const ReductionVariable &rv) { return var_name_match(rv.var, r.name()); });
+    user_assert(iter != rvars.end())
+        << "In schedule for " << name()
+        << ", can't perform parallel_reduce() on " << r.name()
+        << " since it is not in the reduction domain\n"
+        << dump_argument_list();
+
+    Expr task_size = simplify((iter->extent + num_tasks - 1) / num_tasks);
+
+    // Split the reduction into per-task chunks and lift each chunk's
+    // partial result into an intermediate Func indexed by the task
+    // id. rfactor() checks that the operator is associative.
+    RVar ro(unique_name(r.name() + "_po")), ri(unique_name(r.name() + "_pi"));
+    split(r, ro, ri, task_size, TailStrategy::GuardWithIf);
+    Func intm = rfactor(ro, v);
+
+    // Each task accumulates into its own slice of the intermediate.
+    // Pad the slices out to cache lines so that concurrent tasks
+    // don't falsely share them. Scalar reductions have no storage
+    // dimension to pad, but also keep their partial in a register for
+    // the duration of the task, so they don't suffer much from this.
+    const auto &storage = storage_dims();
+    if (!storage.empty()) {
+        int bytes = definition.values()[0].type().bytes();
+        int alignment = 64 / bytes;
+        if (alignment > 1) {
+            intm.align_storage(Var(storage[0].var), alignment);
+        }
+    }
+
+    intm.compute_root().parallel(v);
+    intm.update().parallel(v);
+
+    // This Stage is now the merge stage, combining the per-task
+    // partials over a reduction of extent num_tasks. If there are
+    // many tasks, combine them with a log-depth tree instead of a
+    // single serial chain: repeatedly lift the reduction over groups
+    // of partials into another parallel intermediate.
+    const int tree_arity = 8;
+    if (const int64_t *n = as_const_int(num_tasks)) {
+        int64_t remaining = *n;
+        RVar combine = ro;
+        while (remaining > tree_arity) {
+            RVar co(unique_name(r.name() + "_to")), ci(unique_name(r.name() + "_ti"));
+            Var vc(unique_name(v.name() + "_t"));
+            split(combine, co, ci, tree_arity, TailStrategy::GuardWithIf);
+            Func partial = rfactor(co, vc);
+            partial.compute_root().parallel(vc);
+            partial.update().parallel(vc);
+            combine = co;
+            remaining = (remaining + tree_arity - 1) / tree_arity;
+        }
+    }
+
+    return intm;
+}
+
 void Stage::split(const string &old, const string &outer, const string &inner, const Expr &factor, bool exact, TailStrategy tail) {
     debug(4) << "In schedule for " << name() << ", split " << old << " into "
              << outer << " and " << inner << " with factor of " << factor << "\n";
@@ -1057,9 +1167,10 @@ void Stage::split(const string &old, const string &outer, const string &inner, c
     }
 
     if (exact) {
-        user_assert(tail == TailStrategy::GuardWithIf)
+        user_assert(tail == TailStrategy::GuardWithIf ||
+                    tail == TailStrategy::Predicate)
             << "When splitting Var " << old_name
-            << " the tail strategy must be GuardWithIf or Auto. "
+            << " the tail strategy must be GuardWithIf, Predicate, or Auto. "
             << "Anything else may change the meaning of the algorithm\n";
     }
 
@@ -1080,7 +1191,8 @@ Stage &Stage::split(const VarOrRVar &old, const VarOrRVar &outer, const VarOrRVa
     return *this;
 }
 
-Stage &Stage::fuse(const VarOrRVar &inner, const VarOrRVar &outer, const VarOrRVar &fused) {
+Stage &Stage::fuse_impl(const VarOrRVar &inner, const VarOrRVar &outer,
+                        const VarOrRVar &fused, Internal::Split::SplitType split_type) {
     if (!fused.is_rvar) {
         user_assert(!outer.is_rvar) << "Can't fuse Var " << fused.name()
                                     << " from RVar " << outer.name() << "\n";
@@ -1141,11 +1253,15 @@ Stage &Stage::fuse(const VarOrRVar &inner, const VarOrRVar &outer, const VarOrRV
     }
 
     // Add the fuse to the splits list
-    Split split = {fused_name, outer_name, inner_name, Expr(), true, TailStrategy::RoundUp, Split::FuseVars};
+    Split split = {fused_name, outer_name, inner_name, Expr(), true, TailStrategy::RoundUp, split_type};
     definition.schedule().splits().push_back(split);
     return *this;
 }
 
+Stage &Stage::fuse(const VarOrRVar &inner, const VarOrRVar &outer, const VarOrRVar &fused) {
+    return fuse_impl(inner, outer, fused, Split::FuseVars);
+}
+
 namespace Internal {
 class CheckForFreeVars : public IRGraphVisitor {
 public:
@@ -1455,6 +1571,51 @@ Stage &Stage::unroll(const VarOrRVar &var) {
     return *this;
 }
 
+Stage &Stage::unroll_and_jam(const VarOrRVar &var, const Expr &factor, TailStrategy tail) {
+    // Split off the iterations to jam. The "__jam" suffix tells the
+    // unroller to hoist loads shared between the jammed bodies (see
+    // UnrollLoops.cpp).
+    VarOrRVar inner(var.name() + "__jam", var.is_rvar);
+    if (var.is_rvar) {
+        split(var.rvar, var.rvar, inner.rvar, factor, tail);
+    } else {
+        split(var.var, var.var, inner.var, factor, tail);
+    }
+
+    // Sink the jammed dimension to the innermost position, keeping
+    // the relative order of the dimensions it moves inside.
+    const vector<Dim> &dims = definition.schedule().dims();
+    vector<VarOrRVar> order;
+    order.push_back(inner);
+    for (const Dim &dim : dims) {
+        if (var_name_match(dim.var, inner.name())) {
+            break;
+        }
+        order.emplace_back(dim.var, dim.is_rvar());
+    }
+    reorder(order);
+    unroll(inner);
+    return *this;
+}
+
+Stage &Stage::partition(const VarOrRVar &var, Partition policy) {
+    bool found = false;
+    vector<Dim> &dims = definition.schedule().dims();
+    for (auto &dim : dims) {
+        if (var_name_match(dim.var, var.name())) {
+            found = true;
+            dim.partition_policy = policy;
+        }
+    }
+    user_assert(found)
+        << "In schedule for " << name()
+        << ", could not find dimension "
+        << var.name()
+        << " to set loop partition policy for\n"
+        << dump_argument_list();
+    return *this;
+}
+
 Stage &Stage::parallel(const VarOrRVar &var, const Expr &factor, TailStrategy tail) {
     if (var.is_rvar) {
         RVar tmp;
@@ -1515,6 +1676,22 @@ Stage &Stage::tile(const VarOrRVar &x, const VarOrRVar &y,
     return *this;
 }
 
+Stage &Stage::tile_morton(const VarOrRVar &x, const VarOrRVar &y,
+                          const VarOrRVar &t,
+                          const VarOrRVar &xi, const VarOrRVar &yi,
+                          const Expr &xfactor, const Expr &yfactor,
+                          TailStrategy tail) {
+    user_assert(!x.is_rvar && !y.is_rvar && !t.is_rvar)
+        << "In schedule for " << name()
+        << ", tile_morton does not support RVars, because it reorders "
+        << "the traversal of the tiles\n";
+    split(x, x, xi, xfactor, tail);
+    split(y, y, yi, yfactor, tail);
+    reorder(xi, yi, x, y);
+    fuse_impl(x, y, t, Split::FuseVarsMorton);
+    return *this;
+}
+
 Stage &Stage::tile(const std::vector<VarOrRVar> &previous,
                    const std::vector<VarOrRVar> &outers,
                    const std::vector<VarOrRVar> &inners,
@@ -1552,6 +1729,125 @@ Stage &Stage::tile(const std::vector<VarOrRVar> &previous,
     return tile(previous, previous, inners, factors, tail);
 }
 
+Stage &Stage::register_tile(const VarOrRVar &x, const VarOrRVar &y,
+                            const VarOrRVar &xi, const VarOrRVar &yi,
+                            const Expr &xfactor, const Expr &yfactor,
+                            TailStrategy tail) {
+    split(x, x, xi, xfactor, tail);
+    split(y, y, yi, yfactor, tail);
+
+    // Build the loop order for an outer-product register tile: the
+    // tile body innermost, then any reduction loops, then the loops
+    // over tiles. The reduction loops keep their existing relative
+    // order, so no associativity proof is required. With the
+    // accumulator addresses invariant to the reduction loops, their
+    // loads and stores get hoisted into registers for the whole
+    // accumulation.
+    std::vector<VarOrRVar> new_order = {xi, yi};
+    for (const Dim &d : definition.schedule().dims()) {
+        if (!d.is_rvar()) {
+            continue;
+        }
+        if (var_name_match(d.var, x.name()) ||
+            var_name_match(d.var, y.name()) ||
+            var_name_match(d.var, xi.name()) ||
+            var_name_match(d.var, yi.name())) {
+            continue;
+        }
+        new_order.emplace_back(RVar(d.var));
+    }
+    new_order.emplace_back(x);
+    new_order.emplace_back(y);
+    reorder(new_order);
+
+    vectorize(xi);
+    unroll(yi);
+    return *this;
+}
+
+Stage &Stage::transpose_tile(const VarOrRVar &x, const VarOrRVar &y,
+                             const VarOrRVar &xi, const VarOrRVar &yi,
+                             const Expr &factor,
+                             TailStrategy tail) {
+    tile(x, y, xi, yi, factor, factor, tail);
+    vectorize(xi);
+    unroll(yi);
+    return *this;
+}
+
+Stage &Stage::metal_simdgroup_tile(const VarOrRVar &x, const VarOrRVar &y,
+                                   const VarOrRVar &r,
+                                   const VarOrRVar &xi, const VarOrRVar &yi,
+                                   const VarOrRVar &ri,
+                                   DeviceAPI device_api) {
+    user_assert(!x.is_rvar && !y.is_rvar)
+        << "In metal_simdgroup_tile for " << name()
+        << ": the output tile dimensions must be pure Vars.\n";
+    user_assert(r.is_rvar)
+        << "In metal_simdgroup_tile for " << name()
+        << ": the accumulation dimension must be an RVar.\n";
+
+    split(x, x, xi, 8, TailStrategy::RoundUp);
+    split(y, y, yi, 8, TailStrategy::RoundUp);
+    // The accumulation extent must divide evenly; a tail case would
+    // break the tile structure the Metal backend pattern-matches.
+    split(r, r, ri, 8, TailStrategy::Auto);
+    reorder({xi, yi, ri, x, y, r});
+
+    // Marking the innermost tile loop as a loop over gpu lanes is
+    // what tells lowering to collapse the tile into cooperative
+    // simdgroup matrix operations (see GPUMatrixOps.cpp).
+    gpu_lanes(xi, device_api);
+    return *this;
+}
+
+Stage &Stage::gpu_tensor_core(const VarOrRVar &x, const VarOrRVar &y,
+                              const VarOrRVar &r,
+                              const VarOrRVar &xi, const VarOrRVar &yi,
+                              const VarOrRVar &ri,
+                              DeviceAPI device_api) {
+    user_assert(!x.is_rvar && !y.is_rvar)
+        << "In gpu_tensor_core for " << name()
+        << ": the output tile dimensions must be pure Vars.\n";
+    user_assert(r.is_rvar)
+        << "In gpu_tensor_core for " << name()
+        << ": the accumulation dimension must be an RVar.\n";
+
+    split(x, x, xi, 16, TailStrategy::RoundUp);
+    split(y, y, yi, 16, TailStrategy::RoundUp);
+    // The accumulation extent must divide evenly; a tail case would
+    // break the tile structure the PTX backend pattern-matches.
+    split(r, r, ri, 16, TailStrategy::Auto);
+    reorder({xi, yi, ri, x, y, r});
+
+    // Marking the innermost tile loop as a loop over gpu lanes is
+    // what tells lowering to collapse the tile into warp-cooperative
+    // WMMA operations (see GPUMatrixOps.cpp).
+    gpu_lanes(xi, device_api);
+    return *this;
+}
+
+Stage &Stage::warp_reduce(const VarOrRVar &r, const VarOrRVar &ri,
+                          DeviceAPI device_api) {
+    user_assert(r.is_rvar)
+        << "In warp_reduce for " << name()
+        << ": the reduction dimension must be an RVar.\n";
+
+    // atomic() proves the update associative and permits placing the
+    // reduction dimension on the warp lanes. The atomic update this
+    // implies is then rewritten into a tree of warp shuffles during
+    // lowering (see LowerWarpShuffles.cpp), leaving one store per
+    // warp rather than one per lane.
+    atomic();
+
+    // If the extent does not divide evenly this becomes a guarded
+    // split, and the resulting lane-dependent predicate makes the
+    // shuffle lowering fall back to plain atomic updates.
+    split(r, r, ri, 32, TailStrategy::Auto);
+    gpu_lanes(ri, device_api);
+    return *this;
+}
+
 Stage &Stage::reorder(const std::vector<VarOrRVar> &vars) {
     const string &func_name = function.name();
     vector<Expr> &args = definition.args();
@@ -1786,23 +2082,113 @@ Stage &Stage::gpu_tile(const VarOrRVar &x, const VarOrRVar &y, const VarOrRVar &
     return gpu_tile(x, y, z, x, y, z, tx, ty, tz, x_size, y_size, z_size, tail, device_api);
 }
 
+Stage &Stage::gpu_tile_occupancy(const VarOrRVar &x, const VarOrRVar &bx, const VarOrRVar &tx,
+                                 DeviceAPI device_api) {
+    user_assert(device_api == DeviceAPI::Default_GPU ||
+                device_api == DeviceAPI::CUDA)
+        << "In gpu_tile_occupancy for " << name()
+        << ": the occupancy API is only available on CUDA.\n";
+
+    // The block size is not known until the compiled kernel has been
+    // loaded on a particular device, so the split factor is a
+    // placeholder naming this stage. OffloadGPULoops resolves it to a
+    // runtime occupancy query against the kernel the stage compiles
+    // to (see there, and halide_cuda_occupancy_block_size in
+    // src/runtime/cuda.cpp).
+    Expr block_size =
+        Call::make(Int(32), "halide_cuda_occupancy_block_size",
+                   {function.name() + ".s" + std::to_string(stage_index) + "."},
+                   Call::PureExtern);
+    split(x, bx, tx, block_size, TailStrategy::GuardWithIf);
+    set_dim_device_api(bx, device_api);
+    set_dim_device_api(tx, device_api);
+    set_dim_type(bx, ForType::GPUBlock);
+    set_dim_type(tx, ForType::GPUThread);
+    return *this;
+}
+
 Stage &Stage::hexagon(const VarOrRVar &x) {
     set_dim_device_api(x, DeviceAPI::Hexagon);
     return *this;
 }
 
-Stage &Stage::prefetch(const Func &f, const VarOrRVar &var, Expr offset, PrefetchBoundStrategy strategy) {
-    PrefetchDirective prefetch = {f.name(), var.name(), std::move(offset), strategy, Parameter()};
+Stage &Stage::prefetch(const Func &f, const VarOrRVar &var, Expr offset, PrefetchBoundStrategy strategy,
+                       PrefetchLocality locality, bool for_write) {
+    PrefetchDirective prefetch = {f.name(), var.name(), std::move(offset), strategy, locality, for_write, false, Parameter()};
     definition.schedule().prefetches().push_back(prefetch);
     return *this;
 }
 
-Stage &Stage::prefetch(const Internal::Parameter &param, const VarOrRVar &var, Expr offset, PrefetchBoundStrategy strategy) {
-    PrefetchDirective prefetch = {param.name(), var.name(), std::move(offset), strategy, param};
+Stage &Stage::prefetch(const Internal::Parameter &param, const VarOrRVar &var, Expr offset, PrefetchBoundStrategy strategy,
+                       PrefetchLocality locality, bool for_write) {
+    PrefetchDirective prefetch = {param.name(), var.name(), std::move(offset), strategy, locality, for_write, false, param};
     definition.schedule().prefetches().push_back(prefetch);
     return *this;
 }
 
+Stage &Stage::prefetch_adaptive(const Func &f, const VarOrRVar &var, Expr initial_offset, PrefetchBoundStrategy strategy,
+                                PrefetchLocality locality, bool for_write) {
+    PrefetchDirective prefetch = {f.name(), var.name(), std::move(initial_offset), strategy, locality, for_write, true, Parameter()};
+    definition.schedule().prefetches().push_back(prefetch);
+    return *this;
+}
+
+Stage &Stage::prefetch_adaptive(const Internal::Parameter &param, const VarOrRVar &var, Expr initial_offset, PrefetchBoundStrategy strategy,
+                                PrefetchLocality locality, bool for_write) {
+    PrefetchDirective prefetch = {param.name(), var.name(), std::move(initial_offset), strategy, locality, for_write, true, param};
+    definition.schedule().prefetches().push_back(prefetch);
+    return *this;
+}
+
+Stage &Stage::pipeline_loop(const VarOrRVar &var, int stages) {
+    user_assert(stages >= 2)
+        << "In schedule for " << name()
+        << ", pipeline_loop() requires at least two stages: " << stages << "\n";
+    PipelineLoopDirective p = {var.name(), stages};
+    definition.schedule().pipeline_loops().push_back(p);
+    return *this;
+}
+
+namespace {
+
+// skip_when() conditions are evaluated in the middle of the loop nest,
+// outside of bounds inference's view of the producer-consumer graph, so
+// they may not call other Funcs.
+class CheckNoFuncCalls : public IRVisitor {
+    using IRVisitor::visit;
+
+    void visit(const Call *op) override {
+        if (op->call_type == Call::Halide || op->func.defined()) {
+            result = true;
+        }
+        IRVisitor::visit(op);
+    }
+
+public:
+    bool result = false;
+};
+
+}  // namespace
+
+Stage &Stage::skip_when(const Expr &condition) {
+    user_assert(condition.defined())
+        << "In schedule for " << name()
+        << ", skip_when() requires a defined condition\n";
+    user_assert(condition.type().is_bool() && condition.type().is_scalar())
+        << "In schedule for " << name()
+        << ", the condition passed to skip_when() must be a scalar boolean: "
+        << condition << "\n";
+    CheckNoFuncCalls checker;
+    condition.accept(&checker);
+    user_assert(!checker.result)
+        << "In schedule for " << name()
+        << ", the condition passed to skip_when() may not call other Funcs: "
+        << condition << "\n"
+        << "Pass the mask in as an ImageParam instead.\n";
+    definition.schedule().skip_conditions().push_back(condition);
+    return *this;
+}
+
 Stage &Stage::compute_with(LoopLevel loop_level, const map<string, LoopAlignStrategy> &align) {
     loop_level.lock();
     user_assert(!loop_level.is_inlined() && !loop_level.is_root())
@@ -2112,12 +2498,62 @@ Func &Func::store_in(MemoryType t) {
     return *this;
 }
 
+Func &Func::store_in(MemoryType t, int budget_bytes) {
+    user_assert(t == MemoryType::Stack)
+        << "In schedule for " << name()
+        << ", a memory budget can only be given for MemoryType::Stack\n";
+    user_assert(budget_bytes > 0)
+        << "In schedule for " << name()
+        << ", the stack budget passed to store_in() must be positive\n";
+    invalidate_cache();
+    func.schedule().memory_type() = t;
+    func.schedule().stack_budget_bytes() = budget_bytes;
+    return *this;
+}
+
 Func &Func::async() {
     invalidate_cache();
     func.schedule().async() = true;
     return *this;
 }
 
+Func &Func::store_streaming() {
+    invalidate_cache();
+    func.schedule().store_streaming() = true;
+    return *this;
+}
+
+Func &Func::fuse_gpu_stages() {
+    invalidate_cache();
+    func.schedule().fuse_gpu_stages() = true;
+    return *this;
+}
+
+Func &Func::fuse_tuple_stores() {
+    invalidate_cache();
+    func.schedule().fuse_tuple_stores() = true;
+    return *this;
+}
+
+Func &Func::store_persistent() {
+    invalidate_cache();
+    func.schedule().store_persistent() = true;
+    return *this;
+}
+
+Func &Func::ring_buffer(const Expr &extent) {
+    user_assert(extent.defined())
+        << "In schedule for " << name()
+        << ", the extent passed to ring_buffer() must be defined\n";
+    user_assert(extent.type().is_int() || extent.type().is_uint())
+        << "In schedule for " << name()
+        << ", the extent passed to ring_buffer() must be an integer: "
+        << extent << "\n";
+    invalidate_cache();
+    func.schedule().ring_buffer() = cast<int32_t>(extent);
+    return *this;
+}
+
 Stage Func::specialize(const Expr &c) {
     invalidate_cache();
     return Stage(func, func.definition(), 0).specialize(c);
@@ -2152,6 +2588,18 @@ Func &Func::unroll(const VarOrRVar &var) {
     return *this;
 }
 
+Func &Func::unroll_and_jam(const VarOrRVar &var, const Expr &factor, TailStrategy tail) {
+    invalidate_cache();
+    Stage(func, func.definition(), 0).unroll_and_jam(var, factor, tail);
+    return *this;
+}
+
+Func &Func::partition(const VarOrRVar &var, Partition policy) {
+    invalidate_cache();
+    Stage(func, func.definition(), 0).partition(var, policy);
+    return *this;
+}
+
 Func &Func::parallel(const VarOrRVar &var, const Expr &factor, TailStrategy tail) {
     invalidate_cache();
     Stage(func, func.definition(), 0).parallel(var, factor, tail);
@@ -2317,6 +2765,34 @@ Func &Func::tile(const VarOrRVar &x, const VarOrRVar &y,
     return *this;
 }
 
+Func &Func::register_tile(const VarOrRVar &x, const VarOrRVar &y,
+                          const VarOrRVar &xi, const VarOrRVar &yi,
+                          const Expr &xfactor, const Expr &yfactor,
+                          TailStrategy tail) {
+    invalidate_cache();
+    Stage(func, func.definition(), 0).register_tile(x, y, xi, yi, xfactor, yfactor, tail);
+    return *this;
+}
+
+Func &Func::transpose_tile(const VarOrRVar &x, const VarOrRVar &y,
+                           const VarOrRVar &xi, const VarOrRVar &yi,
+                           const Expr &factor,
+                           TailStrategy tail) {
+    invalidate_cache();
+    Stage(func, func.definition(), 0).transpose_tile(x, y, xi, yi, factor, tail);
+    return *this;
+}
+
+Func &Func::tile_morton(const VarOrRVar &x, const VarOrRVar &y,
+                        const VarOrRVar &t,
+                        const VarOrRVar &xi, const VarOrRVar &yi,
+                        const Expr &xfactor, const Expr &yfactor,
+                        TailStrategy tail) {
+    invalidate_cache();
+    Stage(func, func.definition(), 0).tile_morton(x, y, t, xi, yi, xfactor, yfactor, tail);
+    return *this;
+}
+
 Func &Func::tile(const std::vector<VarOrRVar> &previous,
                  const std::vector<VarOrRVar> &outers,
                  const std::vector<VarOrRVar> &inners,
@@ -2473,21 +2949,56 @@ Func &Func::gpu_tile(const VarOrRVar &x, const VarOrRVar &y, const VarOrRVar &z,
     return *this;
 }
 
+Func &Func::gpu_tile_occupancy(const VarOrRVar &x, const VarOrRVar &bx, const VarOrRVar &tx,
+                               DeviceAPI device_api) {
+    invalidate_cache();
+    Stage(func, func.definition(), 0).gpu_tile_occupancy(x, bx, tx, device_api);
+    return *this;
+}
+
 Func &Func::hexagon(const VarOrRVar &x) {
     invalidate_cache();
     Stage(func, func.definition(), 0).hexagon(x);
     return *this;
 }
 
-Func &Func::prefetch(const Func &f, const VarOrRVar &var, Expr offset, PrefetchBoundStrategy strategy) {
+Func &Func::prefetch(const Func &f, const VarOrRVar &var, Expr offset, PrefetchBoundStrategy strategy,
+                     PrefetchLocality locality, bool for_write) {
+    invalidate_cache();
+    Stage(func, func.definition(), 0).prefetch(f, var, std::move(offset), strategy, locality, for_write);
+    return *this;
+}
+
+Func &Func::prefetch(const Internal::Parameter &param, const VarOrRVar &var, Expr offset, PrefetchBoundStrategy strategy,
+                     PrefetchLocality locality, bool for_write) {
+    invalidate_cache();
+    Stage(func, func.definition(), 0).prefetch(param, var, std::move(offset), strategy, locality, for_write);
+    return *this;
+}
+
+Func &Func::prefetch_adaptive(const Func &f, const VarOrRVar &var, Expr initial_offset, PrefetchBoundStrategy strategy,
+                              PrefetchLocality locality, bool for_write) {
     invalidate_cache();
-    Stage(func, func.definition(), 0).prefetch(f, var, std::move(offset), strategy);
+    Stage(func, func.definition(), 0).prefetch_adaptive(f, var, std::move(initial_offset), strategy, locality, for_write);
     return *this;
 }
 
-Func &Func::prefetch(const Internal::Parameter &param, const VarOrRVar &var, Expr offset, PrefetchBoundStrategy strategy) {
+Func &Func::prefetch_adaptive(const Internal::Parameter &param, const VarOrRVar &var, Expr initial_offset, PrefetchBoundStrategy strategy,
+                              PrefetchLocality locality, bool for_write) {
     invalidate_cache();
-    Stage(func, func.definition(), 0).prefetch(param, var, std::move(offset), strategy);
+    Stage(func, func.definition(), 0).prefetch_adaptive(param, var, std::move(initial_offset), strategy, locality, for_write);
+    return *this;
+}
+
+Func &Func::pipeline_loop(const VarOrRVar &var, int stages) {
+    invalidate_cache();
+    Stage(func, func.definition(), 0).pipeline_loop(var, stages);
+    return *this;
+}
+
+Func &Func::skip_when(const Expr &condition) {
+    invalidate_cache();
+    Stage(func, func.definition(), 0).skip_when(condition);
     return *this;
 }
 
@@ -2555,6 +3066,30 @@ Func &Func::align_storage(const Var &dim, const Expr &alignment) {
     return *this;
 }
 
+Func &Func::store_interleaved(const Var &dim, const Expr &lanes) {
+    invalidate_cache();
+
+    vector<StorageDim> &dims = func.schedule().storage_dims();
+    for (size_t i = 0; i < dims.size(); i++) {
+        if (var_name_match(dims[i].var, dim.name())) {
+            user_assert(i == 1)
+                << "In schedule for " << name()
+                << ", store_interleaved requires " << dim.name()
+                << " to be the second-innermost storage dimension, since it "
+                << "interleaves it into tiles of the innermost one. "
+                << "Use reorder_storage first.\n"
+                << dump_dim_list(dims);
+            dims[i].interleave_lanes = lanes;
+            return *this;
+        }
+    }
+    user_error << "In schedule for " << name()
+               << ", could not find var " << dim.name()
+               << " to interleave the storage of.\n"
+               << dump_dim_list(dims);
+    return *this;
+}
+
 Func &Func::fold_storage(const Var &dim, const Expr &factor, bool fold_forward) {
     invalidate_cache();
 
@@ -3169,6 +3704,14 @@ void Func::compile_to_lowered_stmt(const string &filename,
     pipeline().compile_to_lowered_stmt(filename, args, fmt, target);
 }
 
+void Func::compile_to_access_descriptors(const string &filename,
+                                         const vector<Argument> &args,
+                                         const string &fn_name,
+                                         const Target &target) {
+    pipeline().compile_to_access_descriptors(filename, args,
+                                             fn_name.empty() ? name() : fn_name, target);
+}
+
 void Func::print_loop_nest() {
     pipeline().print_loop_nest();
 }
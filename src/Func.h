@@ -83,6 +83,8 @@ class Stage {
                const Expr &factor, bool exact, TailStrategy tail);
     void remove(const std::string &var);
     Stage &purify(const VarOrRVar &old_name, const VarOrRVar &new_name);
+    Stage &fuse_impl(const VarOrRVar &inner, const VarOrRVar &outer,
+                     const VarOrRVar &fused, Internal::Split::SplitType split_type);
 
     const std::vector<Internal::StorageDim> &storage_dims() const {
         return function.schedule().storage_dims();
@@ -139,7 +141,11 @@ public:
      * order of the original Func's init definition followed by the new pure Vars.
      *
      * The intermediate Func also inherits storage order from the original Func
-     * with the new pure Vars added to the outermost.
+     * with the new pure Vars added to the outermost. This is only a default:
+     * the returned intermediate accepts the full storage scheduling language
+     * (reorder_storage, align_storage, fold_storage) like any other Func.
+     * When the partial-result dimension is vectorized, reordering it to be
+     * innermost in storage avoids strided stores of the partial results.
      *
      * For example, f.update(0).rfactor({{r.y, u}}) would rewrite a pipeline like this:
      \code
@@ -190,6 +196,28 @@ public:
     Func rfactor(const RVar &r, const Var &v);
     // @}
 
+    /** Parallelize an associative reduction over the reduction variable
+     * 'r' by splitting it into 'num_tasks' contiguous chunks and using
+     * rfactor() to compute each chunk's partial result independently. The
+     * partial results are stored in an intermediate Func indexed by the
+     * new pure Var 'v', which is computed at root and parallelized over
+     * 'v'. The intermediate is returned so that further scheduling (e.g.
+     * vectorizing the per-task loop) can be applied to it. This Stage
+     * becomes the stage that merges the partial results, as with
+     * rfactor(), and the same restrictions apply: the update must be an
+     * associative reduction that the associativity prover can recognize.
+     *
+     * Storage for the per-task partial results is padded out to cache
+     * lines, so that concurrent tasks accumulating into adjacent slices
+     * do not falsely share them.
+     *
+     * If 'num_tasks' is a compile-time constant much larger than the
+     * number of cores (e.g. to get a finer-grained task decomposition
+     * for load balancing), the partial results are merged with a
+     * log-depth tree of parallel reductions rather than a single serial
+     * loop. */
+    Func parallel_reduce(const RVar &r, const Var &v, const Expr &num_tasks);
+
     /** Schedule the iteration over this stage to be fused with another
      * stage 's' from outermost loop to a given LoopLevel. 'this' stage will
      * be computed AFTER 's' in the innermost fused dimension. There should not
@@ -201,6 +229,14 @@ public:
      * the stage we are calling compute_with on should not have specializations,
      * e.g. f2.compute_with(f1, x) is allowed only if f2 has no specializations.
      *
+     * The fused dimensions do not need to have matching extents; the fused
+     * loop iterates over the union of the bounds, and each stage is guarded
+     * to its own range. An update stage whose fused dimensions are pure RVars
+     * may be fused with another stage's pure loops: since RVar names can
+     * never match the other stage's variable names, the fused dimensions are
+     * matched positionally instead. Impure RVars (those whose iteration order
+     * matters) may only be fused with each other.
+     *
      * Also, if a producer is desired to be computed at the fused loop level,
      * the function passed to the compute_at() needs to be the "parent". Consider
      * the following code:
@@ -350,6 +386,8 @@ public:
     Stage &parallel(const VarOrRVar &var, const Expr &task_size, TailStrategy tail = TailStrategy::Auto);
     Stage &vectorize(const VarOrRVar &var, const Expr &factor, TailStrategy tail = TailStrategy::Auto);
     Stage &unroll(const VarOrRVar &var, const Expr &factor, TailStrategy tail = TailStrategy::Auto);
+    Stage &unroll_and_jam(const VarOrRVar &var, const Expr &factor, TailStrategy tail = TailStrategy::Auto);
+    Stage &partition(const VarOrRVar &var, Partition policy);
     Stage &tile(const VarOrRVar &x, const VarOrRVar &y,
                 const VarOrRVar &xo, const VarOrRVar &yo,
                 const VarOrRVar &xi, const VarOrRVar &yi, const Expr &xfactor, const Expr &yfactor,
@@ -358,6 +396,11 @@ public:
                 const VarOrRVar &xi, const VarOrRVar &yi,
                 const Expr &xfactor, const Expr &yfactor,
                 TailStrategy tail = TailStrategy::Auto);
+    Stage &tile_morton(const VarOrRVar &x, const VarOrRVar &y,
+                       const VarOrRVar &t,
+                       const VarOrRVar &xi, const VarOrRVar &yi,
+                       const Expr &xfactor, const Expr &yfactor,
+                       TailStrategy tail = TailStrategy::Auto);
     Stage &tile(const std::vector<VarOrRVar> &previous,
                 const std::vector<VarOrRVar> &outers,
                 const std::vector<VarOrRVar> &inners,
@@ -372,6 +415,65 @@ public:
                 const std::vector<VarOrRVar> &inners,
                 const std::vector<Expr> &factors,
                 TailStrategy tail = TailStrategy::Auto);
+    Stage &register_tile(const VarOrRVar &x, const VarOrRVar &y,
+                         const VarOrRVar &xi, const VarOrRVar &yi,
+                         const Expr &xfactor, const Expr &yfactor,
+                         TailStrategy tail = TailStrategy::Auto);
+    Stage &transpose_tile(const VarOrRVar &x, const VarOrRVar &y,
+                          const VarOrRVar &xi, const VarOrRVar &yi,
+                          const Expr &factor,
+                          TailStrategy tail = TailStrategy::Auto);
+    /** Schedule a multiply-accumulate update to use Metal simdgroup
+     * matrix operations. Tiles the two output dimensions x and y and
+     * the accumulation dimension r by 8, and arranges for the
+     * resulting 8x8x8 tile to be computed cooperatively by one
+     * simdgroup using simdgroup_multiply_accumulate, instead of
+     * scalar code. The update must have the form C(x, y) += A(r, y) *
+     * B(x, r) with float or half values, x must be the innermost
+     * storage dimension of C and B, r the innermost storage dimension
+     * of A, and r's extent must be a multiple of 8. The loops over
+     * tiles are left to be scheduled as usual, e.g. with gpu_blocks;
+     * staging A or B through threadgroup memory can be composed via
+     * in() and store_in(MemoryType::GPUShared). Only supported by the
+     * Metal backend. */
+    Stage &metal_simdgroup_tile(const VarOrRVar &x, const VarOrRVar &y,
+                                const VarOrRVar &r,
+                                const VarOrRVar &xi, const VarOrRVar &yi,
+                                const VarOrRVar &ri,
+                                DeviceAPI device_api = DeviceAPI::Default_GPU);
+
+    /** Schedule a multiply-accumulate update to use CUDA tensor
+     * cores. The CUDA analog of metal_simdgroup_tile: tiles the two
+     * output dimensions x and y and the accumulation dimension r by
+     * 16, and computes each 16x16x16 tile with a single warp-wide
+     * WMMA operation. The update must have the form C(x, y) +=
+     * f32(A(r, y)) * f32(B(x, r)) with half-precision A and B and a
+     * float accumulator (or all three in half), with the same layout
+     * requirements as metal_simdgroup_tile, and r's extent must be a
+     * multiple of 16. Requires a target with cuda_capability_70 or
+     * greater. The loops over tiles are scheduled as usual with
+     * gpu_blocks; staging A or B through shared memory can be
+     * composed via in() and store_in(MemoryType::GPUShared). */
+    Stage &gpu_tensor_core(const VarOrRVar &x, const VarOrRVar &y,
+                           const VarOrRVar &r,
+                           const VarOrRVar &xi, const VarOrRVar &yi,
+                           const VarOrRVar &ri,
+                           DeviceAPI device_api = DeviceAPI::Default_GPU);
+
+    /** Schedule an associative reduction to be computed cooperatively
+     * by the lanes of a CUDA warp. Splits the reduction dimension r
+     * by the warp width of 32, placing the inner piece ri on the warp
+     * lanes, so each lane accumulates a partial result in a
+     * register. Lowering then combines the partials with a tree of
+     * warp shuffles and a single lane commits each result, instead of
+     * every lane contending for the same address through shared
+     * memory or global atomics. The update must be a reduction that
+     * atomic() can prove associative, over scalar 32-bit values. If
+     * r's extent is not a multiple of 32, or the update is not of a
+     * form the shuffle lowering recognizes, the schedule degrades to
+     * plain atomic updates rather than failing. */
+    Stage &warp_reduce(const VarOrRVar &r, const VarOrRVar &ri,
+                       DeviceAPI device_api = DeviceAPI::Default_GPU);
     Stage &reorder(const std::vector<VarOrRVar> &vars);
 
     template<typename... Args>
@@ -437,19 +539,51 @@ public:
                     TailStrategy tail = TailStrategy::Auto,
                     DeviceAPI device_api = DeviceAPI::Default_GPU);
 
+    /** Like the one-dimensional gpu_tile, but instead of baking a
+     * block size in at compile time, pick one per device on first run
+     * using the CUDA occupancy API, so the same compiled pipeline
+     * adapts to whichever architecture it lands on. The tail is
+     * guarded, so any block size the driver suggests is valid. CUDA
+     * only. */
+    Stage &gpu_tile_occupancy(const VarOrRVar &x, const VarOrRVar &bx, const VarOrRVar &tx,
+                              DeviceAPI device_api = DeviceAPI::Default_GPU);
+
     Stage &allow_race_conditions();
     Stage &atomic(bool override_associativity_test = false);
 
     Stage &hexagon(const VarOrRVar &x = Var::outermost());
     Stage &prefetch(const Func &f, const VarOrRVar &var, Expr offset = 1,
-                    PrefetchBoundStrategy strategy = PrefetchBoundStrategy::GuardWithIf);
+                    PrefetchBoundStrategy strategy = PrefetchBoundStrategy::GuardWithIf,
+                    PrefetchLocality locality = PrefetchLocality::L1,
+                    bool for_write = false);
     Stage &prefetch(const Internal::Parameter &param, const VarOrRVar &var, Expr offset = 1,
-                    PrefetchBoundStrategy strategy = PrefetchBoundStrategy::GuardWithIf);
+                    PrefetchBoundStrategy strategy = PrefetchBoundStrategy::GuardWithIf,
+                    PrefetchLocality locality = PrefetchLocality::L1,
+                    bool for_write = false);
     template<typename T>
     Stage &prefetch(const T &image, VarOrRVar var, Expr offset = 1,
-                    PrefetchBoundStrategy strategy = PrefetchBoundStrategy::GuardWithIf) {
-        return prefetch(image.parameter(), var, offset, strategy);
+                    PrefetchBoundStrategy strategy = PrefetchBoundStrategy::GuardWithIf,
+                    PrefetchLocality locality = PrefetchLocality::L1,
+                    bool for_write = false) {
+        return prefetch(image.parameter(), var, offset, strategy, locality, for_write);
+    }
+    Stage &prefetch_adaptive(const Func &f, const VarOrRVar &var, Expr initial_offset = 1,
+                             PrefetchBoundStrategy strategy = PrefetchBoundStrategy::GuardWithIf,
+                             PrefetchLocality locality = PrefetchLocality::L1,
+                             bool for_write = false);
+    Stage &prefetch_adaptive(const Internal::Parameter &param, const VarOrRVar &var, Expr initial_offset = 1,
+                             PrefetchBoundStrategy strategy = PrefetchBoundStrategy::GuardWithIf,
+                             PrefetchLocality locality = PrefetchLocality::L1,
+                             bool for_write = false);
+    template<typename T>
+    Stage &prefetch_adaptive(const T &image, VarOrRVar var, Expr initial_offset = 1,
+                             PrefetchBoundStrategy strategy = PrefetchBoundStrategy::GuardWithIf,
+                             PrefetchLocality locality = PrefetchLocality::L1,
+                             bool for_write = false) {
+        return prefetch_adaptive(image.parameter(), var, initial_offset, strategy, locality, for_write);
     }
+    Stage &pipeline_loop(const VarOrRVar &var, int stages);
+    Stage &skip_when(const Expr &condition);
     // @}
 
     /** Attempt to get the source file and line where this stage was
@@ -946,6 +1080,15 @@ public:
                                  StmtOutputFormat fmt = Text,
                                  const Target &target = get_target_from_environment());
 
+    /** Write out the affine access descriptors of the lowered
+     * pipeline as a C table of halide_affine_access_descriptor_t
+     * (see HalideRuntime.h). Useful for programming DMA and prefetch
+     * engines from the schedule itself. */
+    void compile_to_access_descriptors(const std::string &filename,
+                                       const std::vector<Argument> &args,
+                                       const std::string &fn_name = "",
+                                       const Target &target = get_target_from_environment());
+
     /** Write out the loop nests specified by the schedule for this
      * Function. Helpful for understanding what a schedule is
      * doing. */
@@ -1267,6 +1410,61 @@ public:
                        DeviceAPI device_api = DeviceAPI::Host);
     // @}
 
+    /** Declare that this Func's extern definition follows the
+     * asynchronous extern protocol: the extern function takes a
+     * trailing `halide_semaphore_t *completion` argument, may return
+     * as soon as it has *initiated* the work (e.g. handed an I/O
+     * request to the OS), and must arrange for
+     * halide_semaphore_release(completion, 1) to be called once the
+     * output buffers are fully written. This lets an I/O-bound extern
+     * stage overlap with compute without a worker thread blocking
+     * inside it: when the stage is also scheduled with async(), the
+     * completion semaphore is the one its consumers wait on through
+     * the task system, so no thread sits idle between initiation and
+     * completion.
+     *
+     * The completion argument is null during bounds queries, and when
+     * the stage is not scheduled with async(); in both cases the
+     * extern function must do its work synchronously before
+     * returning. A non-zero return value still signals an error, but
+     * only failures detected at initiation can be reported this way;
+     * after a successful return the extern stage must always release
+     * the semaphore, even if the asynchronous work fails. Only
+     * host-side extern stages may be marked async. */
+    Func &async_extern();
+
+    /** Declare that this Func's extern definition uses the
+     * raw-pointer ABI instead of taking halide_buffer_t pointers.
+     * Each buffer argument (inputs in order, then outputs) is passed
+     * as a host pointer pre-resolved to the min of the required
+     * region, followed by an int32 extent and int32 stride for each
+     * dimension. Scalar arguments are passed unchanged, and the
+     * extern function still returns an int32 error code. This skips
+     * the per-call construction of bounds structs and crops, which
+     * matters for small per-tile extern calls.
+     *
+     * Because no halide_buffer_t is passed, the extern function
+     * cannot answer bounds queries. Instead, bounds_proxy must be a
+     * pure Expr in the Func's arguments that consumes each input the
+     * way the extern stage does (e.g. `in(x - 1) + in(x + 1)` for a
+     * stage that needs one element of padding); bounds inference uses
+     * it in place of the bounds query protocol. Only host-side,
+     * non-async extern stages may use the raw-pointer ABI, and inputs
+     * with folded storage are not supported. */
+    Func &raw_pointer_extern(const Expr &bounds_proxy);
+
+    /** Annotate this Func's extern definition with a proxy
+     * expression: a pure Expr in the Func's arguments that consumes
+     * each input the way the extern stage does and has roughly the
+     * same arithmetic cost per output element. Bounds inference uses
+     * it in place of the bounds query protocol, and autoschedulers
+     * (currently adams2019) use it to model the stage's cost and
+     * footprint, so producers and consumers of the extern stage can
+     * be scheduled around it instead of being pinned at the root
+     * level. The proxy is never compiled into the pipeline; only its
+     * structure is inspected. */
+    Func &extern_definition_proxy(const Expr &proxy);
+
     /** Get the types of the outputs of this Func. */
     const std::vector<Type> &output_types() const;
 
@@ -1520,6 +1718,29 @@ public:
      * dimension of the split. 'factor' must be an integer. */
     Func &unroll(const VarOrRVar &var, const Expr &factor, TailStrategy tail = TailStrategy::Auto);
 
+    /** Split a dimension by the given factor, then move the inner
+     * dimension to the innermost position and unroll it there,
+     * fusing ("jamming") the unrolled bodies together. Loads shared
+     * between the jammed bodies are guaranteed to be hoisted into
+     * common subexpressions, so this is profitable for stencils in
+     * which adjacent iterations of var share most of their input
+     * taps. After this call, var refers to the outer dimension of the
+     * split. 'factor' must be an integer. */
+    Func &unroll_and_jam(const VarOrRVar &var, const Expr &factor, TailStrategy tail = TailStrategy::Auto);
+
+    /** Pin the loop partitioning decision for a dimension, instead of
+     * leaving it to the heuristic. Loops over a boundary condition
+     * are normally partitioned into a prologue, a simplified steady
+     * state, and an epilogue. Use Partition::Never to suppress this
+     * (e.g. to reduce code size when the steady state would cover few
+     * iterations), or Partition::Always to force it in places where
+     * the heuristic declines (e.g. inside the prologue or epilogue of
+     * an enclosing partitioned loop). It is an error to use
+     * Partition::Always on a loop in which partitioning enables no
+     * simplifications. Compile with HL_DEBUG_CODEGEN=2 for a report
+     * of what was partitioned and why. */
+    Func &partition(const VarOrRVar &var, Partition policy);
+
     /** Statically declare that the range over which a function should
      * be evaluated is given by the second and third arguments. This
      * can let Halide perform some optimizations. E.g. if you know
@@ -1588,6 +1809,23 @@ public:
                const Expr &xfactor, const Expr &yfactor,
                TailStrategy tail = TailStrategy::Auto);
 
+    /** Like the shorter form of tile, but additionally fuse the two
+     * tile loops into a single loop 't' that walks the tiles in
+     * Morton (Z-curve) order instead of row-major order. Nearby
+     * iterations of 't' touch nearby tiles in both x and y, which
+     * keeps recently-used rows *and* columns of any stencil inputs
+     * resident in cache when the image is much larger than the
+     * cache. The traversal covers the power-of-two bounding box of
+     * the tile grid, so when the number of tiles in a dimension is
+     * not a power of two, a branch per tile skips the tiles that fall
+     * outside the image. Not supported for RVars, because it reorders
+     * the traversal of the tiles. */
+    Func &tile_morton(const VarOrRVar &x, const VarOrRVar &y,
+                      const VarOrRVar &t,
+                      const VarOrRVar &xi, const VarOrRVar &yi,
+                      const Expr &xfactor, const Expr &yfactor,
+                      TailStrategy tail = TailStrategy::Auto);
+
     /** A more general form of tile, which defines tiles of any dimensionality. */
     Func &tile(const std::vector<VarOrRVar> &previous,
                const std::vector<VarOrRVar> &outers,
@@ -1608,6 +1846,48 @@ public:
                const std::vector<Expr> &factors,
                TailStrategy tail = TailStrategy::Auto);
 
+    /** Schedule an xfactor x yfactor register tile, the blocking
+     * idiom used by matrix-multiply-like stages. Splits x and y by
+     * the given factors, reusing the old names for the loops over
+     * tiles, then vectorizes xi and unrolls yi to form an unrolled
+     * outer-product body. Any reduction loops in the stage are placed
+     * between the tile body and the loops over tiles, so the loads
+     * and stores of the accumulators are invariant to the reduction
+     * and get hoisted into registers for the whole accumulation. For
+     * a GEMM update C(x, y) += A(r, y) * B(x, r), calling
+     * register_tile(x, y, xi, yi, 8, 6) on the update stage is
+     * equivalent to:
+     \code
+     C.update()
+      .split(x, x, xi, 8)
+      .split(y, y, yi, 6)
+      .reorder(xi, yi, r, x, y)
+      .vectorize(xi)
+      .unroll(yi);
+     \endcode
+     * The xfactor should typically be a small multiple of the natural
+     * vector width of the accumulator type, and xfactor * yfactor
+     * vectors must fit in the register file. */
+    Func &register_tile(const VarOrRVar &x, const VarOrRVar &y,
+                        const VarOrRVar &xi, const VarOrRVar &yi,
+                        const Expr &xfactor, const Expr &yfactor,
+                        TailStrategy tail = TailStrategy::Auto);
+
+    /** Schedule a transpose-shaped stage as square register tiles:
+     * tile x and y by the given factor, vectorize xi, and unroll
+     * yi. For a stage that reads its input transposed (e.g.
+     * out(x, y) = in(y, x)) the unrolled body is a block of strided
+     * vector loads that collectively read a dense square of the
+     * input, which lowering rewrites into dense loads of the rows
+     * followed by an in-register shuffle transpose, instead of the
+     * gathers or scalar loads the strided form would produce. The
+     * factor should be the natural vector width of the type, e.g. 8
+     * for 32-bit data on AVX2. */
+    Func &transpose_tile(const VarOrRVar &x, const VarOrRVar &y,
+                         const VarOrRVar &xi, const VarOrRVar &yi,
+                         const Expr &factor,
+                         TailStrategy tail = TailStrategy::Auto);
+
     /** Reorder variables to have the given nesting order, from
      * innermost out */
     Func &reorder(const std::vector<VarOrRVar> &vars);
@@ -1974,6 +2254,13 @@ public:
                    DeviceAPI device_api = DeviceAPI::Default_GPU);
     // @}
 
+    /** Like the one-dimensional gpu_tile, but the block size is
+     * chosen per device at runtime with the CUDA occupancy API
+     * instead of being baked in at compile time. See
+     * Stage::gpu_tile_occupancy. */
+    Func &gpu_tile_occupancy(const VarOrRVar &x, const VarOrRVar &bx, const VarOrRVar &tx,
+                             DeviceAPI device_api = DeviceAPI::Default_GPU);
+
     /** Schedule for execution on Hexagon. When a loop is marked with
      * Hexagon, that loop is executed on a Hexagon DSP. */
     Func &hexagon(const VarOrRVar &x = Var::outermost());
@@ -2007,19 +2294,113 @@ public:
      *   for x = ...
      *     prefetch(&f[x + 2, y], 1, 16);
      *     g(x, y) = 2 * f(x, y)
+     *
+     * 'locality' chooses which cache levels to populate (see
+     * \ref PrefetchLocality); use PrefetchLocality::NTA for data read
+     * once and PrefetchLocality::L2 for data not needed until a later
+     * iteration. Setting 'for_write' prefetches with intent to write
+     * (prefetchw on x86), which acquires the cache line in an
+     * exclusive state; use it to prefetch the output tile of a future
+     * loop iteration. When the prefetched region spans a handful of
+     * cache lines with a constant stride between them (the rows of a
+     * vertical stencil, say), the per-line prefetches are emitted as
+     * straight-line code rather than a loop.
      */
     // @{
     Func &prefetch(const Func &f, const VarOrRVar &var, Expr offset = 1,
-                   PrefetchBoundStrategy strategy = PrefetchBoundStrategy::GuardWithIf);
+                   PrefetchBoundStrategy strategy = PrefetchBoundStrategy::GuardWithIf,
+                   PrefetchLocality locality = PrefetchLocality::L1,
+                   bool for_write = false);
     Func &prefetch(const Internal::Parameter &param, const VarOrRVar &var, Expr offset = 1,
-                   PrefetchBoundStrategy strategy = PrefetchBoundStrategy::GuardWithIf);
+                   PrefetchBoundStrategy strategy = PrefetchBoundStrategy::GuardWithIf,
+                   PrefetchLocality locality = PrefetchLocality::L1,
+                   bool for_write = false);
     template<typename T>
     Func &prefetch(const T &image, VarOrRVar var, Expr offset = 1,
-                   PrefetchBoundStrategy strategy = PrefetchBoundStrategy::GuardWithIf) {
-        return prefetch(image.parameter(), var, offset, strategy);
+                   PrefetchBoundStrategy strategy = PrefetchBoundStrategy::GuardWithIf,
+                   PrefetchLocality locality = PrefetchLocality::L1,
+                   bool for_write = false) {
+        return prefetch(image.parameter(), var, offset, strategy, locality, for_write);
     }
     // @}
 
+    /** Like \ref Func::prefetch, but instead of baking in a fixed
+     * iteration offset, the prefetch distance is fetched from the
+     * runtime on each entry to the loop nest containing the prefetch.
+     * The default runtime implementation (halide_prefetch_distance)
+     * hill-climbs the distance using the time between successive
+     * entries as feedback, so the distance adapts to the machine and
+     * input size instead of going stale when they change. It can be
+     * replaced to supply a distance computed by other means.
+     * 'initial_offset' seeds the search. */
+    // @{
+    Func &prefetch_adaptive(const Func &f, const VarOrRVar &var, Expr initial_offset = 1,
+                            PrefetchBoundStrategy strategy = PrefetchBoundStrategy::GuardWithIf,
+                            PrefetchLocality locality = PrefetchLocality::L1,
+                            bool for_write = false);
+    Func &prefetch_adaptive(const Internal::Parameter &param, const VarOrRVar &var, Expr initial_offset = 1,
+                            PrefetchBoundStrategy strategy = PrefetchBoundStrategy::GuardWithIf,
+                            PrefetchLocality locality = PrefetchLocality::L1,
+                            bool for_write = false);
+    template<typename T>
+    Func &prefetch_adaptive(const T &image, VarOrRVar var, Expr initial_offset = 1,
+                            PrefetchBoundStrategy strategy = PrefetchBoundStrategy::GuardWithIf,
+                            PrefetchLocality locality = PrefetchLocality::L1,
+                            bool for_write = false) {
+        return prefetch_adaptive(image.parameter(), var, initial_offset, strategy, locality, for_write);
+    }
+    // @}
+
+    /** Software-pipeline the loop over the given var by rotating the
+     * top-level statements of its body into the given number of
+     * stages. In the rotated loop, stage k works on loop iteration
+     * i - k, so the statements of the body overlap across iterations:
+     * while one statement finishes iteration i, the next has already
+     * begun iteration i + 1. This gives the backend's instruction
+     * scheduler independent work to interleave, hiding load and
+     * operation latency in tight inner loops (e.g. so stencil kernels
+     * dual-issue on in-order cores like Hexagon). The loop runs for
+     * stages - 1 extra iterations, with the rotated statements
+     * guarded; loop partitioning peels these guards into a prologue
+     * and epilogue, leaving the steady state unguarded.
+     *
+     * The loop must be serial. The rotation executes every statement
+     * on every iteration exactly once, and preserves dependencies
+     * carried through values indexed by the loop var. For storage
+     * that is reused across iterations, a statement runs ahead of a
+     * statement in a later stage by one iteration per stage of
+     * separation, so such dependencies must tolerate that much skew;
+     * do not request more stages than the dependency structure of
+     * the loop body permits. If the body has fewer top-level
+     * statements than the requested number of stages, the extra
+     * stages are dropped. */
+    Func &pipeline_loop(const VarOrRVar &var, int stages);
+
+    /** Skip iterations of this stage for which the given boolean
+     * condition holds. The condition may reference scheduled loop
+     * variables of this stage (including variables introduced by
+     * splits), scalar params, and ImageParams, but may not call other
+     * Funcs. It is checked just inside the innermost loop over a
+     * variable it references, so a condition that only mentions tile
+     * indices is tested once per tile and skips the whole tile. For
+     * example:
+     \code
+     ImageParam mask(UInt(8), 2);
+     f(x, y) = 0;
+     f(x, y) += in(x, y);
+     f.update().tile(x, y, xo, yo, xi, yi, 64, 64);
+     f.update().skip_when(mask(xo, yo) == 0);
+     \endcode
+     * only accumulates tiles whose entry in the caller-provided
+     * activity mask is nonzero, so the cost of a sparse frame is
+     * proportional to its active area. This differs from RDom::where,
+     * which is evaluated at every point of the iteration domain.
+     *
+     * Skipped iterations leave the destination unmodified, as if the
+     * right-hand side were undef(); when used on a pure definition it
+     * is up to you to ensure the skipped values are never read. */
+    Func &skip_when(const Expr &condition);
+
     /** Specify how the storage for the function is laid out. These
      * calls let you specify the nesting order of the dimensions. For
      * example, foo.reorder_storage(y, x) tells Halide to use
@@ -2058,6 +2439,32 @@ public:
      * aligned to multiples of 16, use foo.align_storage(x, 16). */
     Func &align_storage(const Var &dim, const Expr &alignment);
 
+    /** Store the given dimension interleaved into the innermost
+     * storage dimension in tiles of the given number of elements,
+     * giving an array-of-structures-of-arrays (AoSoA) layout. The
+     * dimension must be the second-innermost storage dimension (use
+     * reorder_storage first if it is not), and the innermost storage
+     * extent is padded up to a whole number of tiles.
+     *
+     * For example, for a function foo(x, y, c) representing an RGB
+     * image:
+     \code
+     foo.reorder_storage(x, c, y).store_interleaved(c, 8);
+     \endcode
+     * stores eight red values, then the eight green values for the
+     * same pixels, then the eight blue values, and then moves on to
+     * the next eight pixels. A consumer vectorized by the tile width
+     * then sees dense vector loads for every channel, where fully
+     * interleaved storage would need shuffles and planar storage
+     * would touch three distant scanlines. The tile width should
+     * match the natural vector width of the target for the type.
+     *
+     * Only internal allocations can be stored this way; it is an
+     * error to use this directive on a pipeline output, since the
+     * layout is not expressible with the strides in a
+     * halide_buffer_t. */
+    Func &store_interleaved(const Var &dim, const Expr &lanes);
+
     /** Store realizations of this function in a circular buffer of a
      * given extent. This is more efficient when the extent of the
      * circular buffer is a power of 2. If the fold factor is too
@@ -2237,7 +2644,11 @@ public:
      * producer has computed. If storage is folded, then the producer
      * will additionally not be permitted to run too far ahead of the
      * consumer, to avoid clobbering data that has not yet been
-     * used.
+     * used. When storage is folded automatically, the fold factor is
+     * doubled so that the producer works on the next fold (e.g. a DMA
+     * engine fetching the next tile) while the consumer reads the
+     * current one; use an explicit fold_storage() directive to get a
+     * tighter memory bound instead.
      *
      * Take special care when combining this with custom thread pool
      * implementations, as avoiding deadlock with producer-consumer
@@ -2248,6 +2659,108 @@ public:
      */
     Func &async();
 
+    /** Mark this Func's storage as written with streaming
+     * (non-temporal) stores where possible. Stages that write each
+     * value exactly once and never read it back while producing
+     * (pure definitions, not updates) otherwise pay read-for-
+     * ownership traffic to pull each output cache line in before
+     * overwriting it. Streaming stores write around the cache,
+     * roughly halving the DRAM traffic of pure output stages, at the
+     * cost of evicting nothing useful and of the values not being
+     * cache-resident afterwards -- so this only pays off when the
+     * consumer runs much later (e.g. the final output of a large
+     * pipeline), not for small producers feeding an adjacent
+     * consumer. Lowering only converts stores it can prove safe:
+     * dense unpredicated stores in stages that do not re-read their
+     * own output; everything else, and anything on a device API, is
+     * left as a normal store. A store fence is inserted after the
+     * production so later reads observe the written values. */
+    Func &store_streaming();
+
+    /** Ask for this Func's GPU kernel to be fused into the kernel of
+     * the stage that consumes it, instead of being launched
+     * separately. Pipelines built from many small gpu_tile'd stages
+     * are often dominated by kernel launch overhead and the memory
+     * round-trip between stages; fusing a producer-consumer pair
+     * into one kernel removes a launch and lets the intermediate
+     * values be consumed while still hot in cache. Fusion happens
+     * during lowering when the producer's kernel is immediately
+     * followed by a kernel that reads it and both kernels have the
+     * same number of block dimensions with identical bounds; the two
+     * bodies then run in the same blocks with a barrier between
+     * them, and thread structure may differ freely. By marking a
+     * Func with this directive you assert that each block of the
+     * consumer only reads values produced by the same block of the
+     * producer: there is no synchronization between blocks within a
+     * kernel, so fusing a stage whose consumer reads across block
+     * boundaries (e.g. a stencil reaching into a neighboring block's
+     * output) would produce garbage. If no compatible consumer
+     * kernel is found the hint is quietly ignored. To instead stage
+     * the intermediate in shared memory or registers, use
+     * compute_at() at the consumer's gpu_blocks() or gpu_threads()
+     * level; this directive is for stages whose schedules you want
+     * to keep independent. */
+    Func &fuse_gpu_stages();
+
+    /** Compute every element of this Func's Tuple value before
+     * storing any of them, instead of letting non-aliasing elements
+     * lower to independent store statements with independently
+     * computed values. When the elements share subexpressions —
+     * e.g. luma and chroma both derived from the same input pixels —
+     * the independent form reloads and recomputes the shared work
+     * per element, traversing the input once per Tuple component;
+     * the fused form computes all the values into scalars first and
+     * then performs the stores, so the shared loads are done once
+     * per iteration regardless of where each element's buffer lives.
+     * This is the lowering the compiler already uses when the
+     * elements might alias; the directive forces it
+     * unconditionally. Has no effect on Funcs with scalar values. */
+    Func &fuse_tuple_stores();
+
+    /** Keep the contents of this Func's buffer, and a record of the
+     * region that was computed, alive across pipeline invocations.
+     * On the next invocation, previously-computed slices along the
+     * outermost storage dimension are restored instead of
+     * recomputed, and only the slices not covered by the prior
+     * invocation are produced. This suits pipelines invoked once per
+     * video frame whose state is indexed by absolute frame number: a
+     * temporal stencil or scan that consumes frames [n-k, n] gets
+     * the first k slices back for free each call. Like memoize(),
+     * this is only sound if the Func's value at a given coordinate
+     * never changes across invocations, so state shared between
+     * frames must be indexed by something that advances with the
+     * frames. The Func must be a single-valued (non-Tuple) pure Func
+     * stored at root; restored slices are not re-run, so update
+     * definitions would be applied twice and are rejected. Slices
+     * are restored only when the realized shape matches the previous
+     * call in all inner dimensions and the requested region does not
+     * start below the recorded one; any mismatch falls back to
+     * computing everything. Call halide_persistent_state_clear (or
+     * Internal::JITSharedRuntime::persistent_state_clear under the
+     * JIT) to drop the retained state. */
+    Func &store_persistent();
+
+    /** Expand the storage of this Func along its outermost storage
+     * dimension so that it holds the given number of copies of its
+     * realization, and rotate the producer and consumer through the
+     * copies on successive iterations of the loop the storage is
+     * hoisted above. Must be combined with async(): the producer may
+     * then run up to the given number of iterations ahead of the
+     * consumer before blocking, which smooths over jitter in the
+     * production rate that would stall the consumer of a
+     * double-buffered (depth-two) pipeline. Unlike storage folding,
+     * this also applies to Funcs whose storage cannot be folded, such
+     * as those with extern definitions. Each iteration of the
+     * consumer must only read values produced in the corresponding
+     * iteration of the producer, so do not combine this with
+     * schedules that reuse values across iterations, such as sliding
+     * window schedules. Automatic storage folding is disabled for
+     * ring-buffered Funcs, because the credit limit it imposes on an
+     * async producer would defeat the deeper run-ahead; explicit
+     * fold_storage() directives are still honored. Uses memory
+     * proportional to the depth of the ring buffer. */
+    Func &ring_buffer(const Expr &extent);
+
     /** Allocate storage for this function within f's loop over
      * var. Scheduling storage is optional, and can be used to
      * separate the loop level at which storage occurs from the loop
@@ -2393,6 +2906,18 @@ public:
      * on MemoryType for more detail. */
     Func &store_in(MemoryType memory_type);
 
+    /** Set the type of memory this Func should be stored in, and
+     * additionally promise that its allocations will never exceed the
+     * given number of bytes. Only supported for MemoryType::Stack.
+     * Allocations whose sizes depend on parameters cannot normally be
+     * placed on the stack, because no constant size can be inferred
+     * at compile time; with a budget they are emitted as fixed-size
+     * allocations of budget_bytes, avoiding a call to halide_malloc
+     * per realization. The actual required size is checked against
+     * the budget at runtime, and exceeding it raises
+     * halide_error_buffer_allocation_too_large. */
+    Func &store_in(MemoryType memory_type, int budget_bytes);
+
     /** Trace all loads from this Func by emitting calls to
      * halide_trace. If the Func is inlined, this has no
      * effect. */
@@ -88,6 +88,8 @@ struct FunctionContents {
     NameMangling extern_mangling = NameMangling::Default;
     DeviceAPI extern_function_device_api = DeviceAPI::Host;
     Expr extern_proxy_expr;
+    bool extern_is_async = false;
+    bool extern_uses_raw_pointers = false;
 
     bool trace_loads = false, trace_stores = false, trace_realizations = false;
     std::vector<string> trace_tags;
@@ -349,6 +351,8 @@ void Function::deep_copy(const FunctionPtr &copy, DeepCopyMap &copied_map) const
     copy->extern_mangling = contents->extern_mangling;
     copy->extern_function_device_api = contents->extern_function_device_api;
     copy->extern_proxy_expr = contents->extern_proxy_expr;
+    copy->extern_is_async = contents->extern_is_async;
+    copy->extern_uses_raw_pointers = contents->extern_uses_raw_pointers;
     copy->trace_loads = contents->trace_loads;
     copy->trace_stores = contents->trace_stores;
     copy->trace_realizations = contents->trace_realizations;
@@ -681,6 +685,32 @@ void Function::define_update(const vector<Expr> &_args, vector<Expr> values) {
         r.schedule().dims().push_back(d);
     }
 
+    // Apply any deferred tilings recorded on the reduction domain
+    // (see RDom::tile): the original rvar becomes the inner variable
+    // in place, and the outer variable is hoisted to just inside
+    // __outermost, so each block of reduction iterations is applied
+    // to every pure loop point before the next block begins.
+    if (check.reduction_domain.defined()) {
+        for (const ReductionTile &t : check.reduction_domain.tiles()) {
+            vector<Dim> &sched_dims = r.schedule().dims();
+            for (size_t i = 0; i < sched_dims.size(); i++) {
+                if (sched_dims[i].var == t.old_var) {
+                    string inner_name = t.old_var + "." + t.inner;
+                    string outer_name = t.old_var + "." + t.outer;
+                    Dim outer_dim = sched_dims[i];
+                    sched_dims[i].var = inner_name;
+                    outer_dim.var = outer_name;
+                    sched_dims.insert(sched_dims.end() - 1, outer_dim);
+                    Split split = {t.old_var, outer_name, inner_name,
+                                   t.factor, true, TailStrategy::GuardWithIf,
+                                   Split::SplitVar};
+                    r.schedule().splits().push_back(split);
+                    break;
+                }
+            }
+        }
+    }
+
     // If there's no recursive reference, no reduction domain, and all
     // the args are pure, then this definition completely hides
     // earlier ones!
@@ -883,6 +913,22 @@ Expr &Function::extern_definition_proxy_expr() {
     return contents->extern_proxy_expr;
 }
 
+bool Function::extern_definition_is_async() const {
+    return contents->extern_is_async;
+}
+
+bool &Function::extern_definition_is_async() {
+    return contents->extern_is_async;
+}
+
+bool Function::extern_definition_uses_raw_pointers() const {
+    return contents->extern_uses_raw_pointers;
+}
+
+bool &Function::extern_definition_uses_raw_pointers() {
+    return contents->extern_uses_raw_pointers;
+}
+
 const std::vector<ExternFuncArgument> &Function::extern_arguments() const {
     return contents->extern_arguments;
 }
@@ -200,6 +200,23 @@ public:
     Expr &extern_definition_proxy_expr();
     // @}
 
+    /** Get or set whether the extern definition follows the
+     * asynchronous extern protocol, taking a completion semaphore as
+     * a trailing argument. See Func::async_extern. */
+    // @{
+    bool extern_definition_is_async() const;
+    bool &extern_definition_is_async();
+    // @}
+
+    /** Get or set whether the extern definition uses the raw-pointer
+     * ABI, taking a pre-resolved host pointer plus extent/stride
+     * scalars per buffer argument instead of halide_buffer_t
+     * pointers. See Func::raw_pointer_extern. */
+    // @{
+    bool extern_definition_uses_raw_pointers() const;
+    bool &extern_definition_uses_raw_pointers();
+    // @}
+
     /** Add an external definition of this Func. */
     void define_extern(const std::string &function_name,
                        const std::vector<ExternFuncArgument> &args,
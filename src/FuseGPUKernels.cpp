@@ -0,0 +1,226 @@
+#include "FuseGPUKernels.h"
+#include "CodeGen_GPU_Dev.h"
+#include "Debug.h"
+#include "Function.h"
+#include "IREquality.h"
+#include "IRMutator.h"
+#include "IRVisitor.h"
+#include "Substitute.h"
+#include "Util.h"
+
+#include <set>
+
+namespace Halide {
+namespace Internal {
+
+namespace {
+
+bool buffer_of_func(const std::string &buffer, const std::string &func) {
+    return buffer == func || starts_with(buffer, func + ".");
+}
+
+// Find any reference to a Func's storage: loads, stores, or host-side
+// handles like f.buffer.
+class ReferencesFunc : public IRVisitor {
+    using IRVisitor::visit;
+
+    void visit(const Load *op) override {
+        if (buffer_of_func(op->name, func)) {
+            result = true;
+        }
+        IRVisitor::visit(op);
+    }
+
+    void visit(const Store *op) override {
+        if (buffer_of_func(op->name, func)) {
+            result = true;
+        }
+        IRVisitor::visit(op);
+    }
+
+    void visit(const Variable *op) override {
+        if (buffer_of_func(op->name, func)) {
+            result = true;
+        }
+    }
+
+    const std::string &func;
+
+public:
+    bool result = false;
+    ReferencesFunc(const std::string &func)
+        : func(func) {
+    }
+};
+
+template<typename StmtOrExpr>
+bool references_func(const StmtOrExpr &s, const std::string &func) {
+    ReferencesFunc refs(func);
+    s.accept(&refs);
+    return refs.result;
+}
+
+class LoadsFromFunc : public IRVisitor {
+    using IRVisitor::visit;
+
+    void visit(const Load *op) override {
+        if (buffer_of_func(op->name, func)) {
+            result = true;
+        }
+        IRVisitor::visit(op);
+    }
+
+    const std::string &func;
+
+public:
+    bool result = false;
+    LoadsFromFunc(const std::string &func)
+        : func(func) {
+    }
+};
+
+// A kernel, as seen at this stage of lowering: a nest of GPU block
+// loops and whatever is inside the innermost one.
+struct BlockNest {
+    std::vector<const For *> loops;
+    Stmt inner;
+};
+
+bool get_block_nest(const Stmt &s, BlockNest *nest) {
+    Stmt cur = s;
+    while (const For *loop = cur.as<For>()) {
+        if (!CodeGen_GPU_Dev::is_gpu_block_var(loop->name)) {
+            break;
+        }
+        nest->loops.push_back(loop);
+        cur = loop->body;
+    }
+    nest->inner = cur;
+    return !nest->loops.empty();
+}
+
+class FuseGPUKernels : public IRMutator {
+    using IRMutator::visit;
+
+    const std::set<std::string> &flagged;
+
+    // Walk forwards from the statement following the producer's
+    // kernel, looking for the next kernel, and fuse the producer into
+    // it if it consumes 'func' and has a compatible block
+    // structure. Returns an undefined Stmt if fusion is impossible;
+    // nothing referencing 'func' may be crossed on the way.
+    Stmt fuse_into_consumer(const Stmt &s, const std::string &func, const BlockNest &producer) {
+        if (const For *loop = s.as<For>()) {
+            if (!CodeGen_GPU_Dev::is_gpu_block_var(loop->name)) {
+                // A host-side loop; launching the producer inside it
+                // would change how many times it runs.
+                return Stmt();
+            }
+            BlockNest consumer;
+            get_block_nest(s, &consumer);
+            LoadsFromFunc loads(func);
+            consumer.inner.accept(&loads);
+            if (!loads.result ||
+                consumer.loops.size() != producer.loops.size()) {
+                return Stmt();
+            }
+            std::map<std::string, Expr> replacement;
+            for (size_t i = 0; i < producer.loops.size(); i++) {
+                if (!equal(producer.loops[i]->extent, consumer.loops[i]->extent) ||
+                    !equal(producer.loops[i]->min, consumer.loops[i]->min)) {
+                    return Stmt();
+                }
+                replacement[producer.loops[i]->name] =
+                    Variable::make(Int(32), consumer.loops[i]->name);
+            }
+            // Run the producer's body in the consumer's blocks. The
+            // later thread-loop fusion normalizes the differing
+            // thread structures and places a barrier between the two
+            // stages.
+            Stmt body = Block::make(substitute(replacement, producer.inner),
+                                    consumer.inner);
+            for (size_t i = consumer.loops.size(); i > 0; i--) {
+                const For *c = consumer.loops[i - 1];
+                body = For::make(c->name, c->min, c->extent,
+                                 c->for_type, c->device_api, body);
+            }
+            debug(1) << "Fused gpu kernel producing " << func
+                     << " into its consumer's kernel\n";
+            return body;
+        } else if (const ProducerConsumer *pc = s.as<ProducerConsumer>()) {
+            Stmt body = fuse_into_consumer(pc->body, func, producer);
+            if (!body.defined()) {
+                return Stmt();
+            }
+            return ProducerConsumer::make(pc->name, pc->is_producer, body);
+        } else if (const LetStmt *let = s.as<LetStmt>()) {
+            if (references_func(let->value, func)) {
+                return Stmt();
+            }
+            Stmt body = fuse_into_consumer(let->body, func, producer);
+            if (!body.defined()) {
+                return Stmt();
+            }
+            return LetStmt::make(let->name, let->value, body);
+        } else if (const Block *block = s.as<Block>()) {
+            Stmt first = fuse_into_consumer(block->first, func, producer);
+            if (first.defined()) {
+                return Block::make(first, block->rest);
+            }
+            // The kernel isn't in the first statement; we may step
+            // over it only if it doesn't touch the intermediate.
+            if (references_func(block->first, func)) {
+                return Stmt();
+            }
+            Stmt rest = fuse_into_consumer(block->rest, func, producer);
+            if (!rest.defined()) {
+                return Stmt();
+            }
+            return Block::make(block->first, rest);
+        }
+        return Stmt();
+    }
+
+    Stmt visit(const Block *op) override {
+        const ProducerConsumer *pc = op->first.as<ProducerConsumer>();
+        if (pc && pc->is_producer && flagged.count(pc->name)) {
+            BlockNest producer;
+            if (get_block_nest(pc->body, &producer)) {
+                Stmt fused = fuse_into_consumer(op->rest, pc->name, producer);
+                if (fused.defined()) {
+                    // The producer's kernel now lives inside the
+                    // fused one; re-mutate to fuse any further
+                    // flagged stages into the result.
+                    return mutate(fused);
+                }
+                debug(1) << "Not fusing gpu kernel producing " << pc->name
+                         << ": no immediate consumer kernel with a compatible"
+                         << " block structure\n";
+            }
+        }
+        return IRMutator::visit(op);
+    }
+
+public:
+    FuseGPUKernels(const std::set<std::string> &flagged)
+        : flagged(flagged) {
+    }
+};
+
+}  // namespace
+
+Stmt fuse_gpu_kernels(const Stmt &s, const std::map<std::string, Function> &env) {
+    std::set<std::string> flagged;
+    for (const auto &it : env) {
+        if (it.second.schedule().fuse_gpu_stages()) {
+            flagged.insert(it.first);
+        }
+    }
+    if (flagged.empty()) {
+        return s;
+    }
+    return FuseGPUKernels(flagged).mutate(s);
+}
+
+}  // namespace Internal
+}  // namespace Halide
@@ -0,0 +1,39 @@
+#ifndef HALIDE_FUSE_GPU_KERNELS_H
+#define HALIDE_FUSE_GPU_KERNELS_H
+
+/** \file
+ * Defines the lowering pass that fuses producer-consumer pairs of
+ * GPU kernels into single kernels.
+ */
+
+#include <map>
+#include <string>
+
+#include "Expr.h"
+
+namespace Halide {
+namespace Internal {
+
+class Function;
+
+/** For each Func scheduled with Func::fuse_gpu_stages, find the
+ * kernel (nest of GPU block loops) that produces it and the next
+ * kernel that consumes it, and merge them into one kernel when both
+ * have the same number of block dimensions with identical bounds:
+ * the producer's body runs first within each block, followed by the
+ * consumer's, and the later thread-loop fusion inserts the barrier
+ * between them. This removes a kernel launch per fused pair; the
+ * intermediate stays in global memory, but is read back while still
+ * hot. The caller has asserted, by using the directive, that each
+ * block of the consumer only reads values written by the same block
+ * of the producer. Pairs whose block structures differ, or with
+ * anything referencing the intermediate between the two kernels, are
+ * left unfused. Runs on the lowered statement after host/device
+ * buffer copies are injected and before the per-kernel thread loops
+ * are fused. */
+Stmt fuse_gpu_kernels(const Stmt &s, const std::map<std::string, Function> &env);
+
+}  // namespace Internal
+}  // namespace Halide
+
+#endif
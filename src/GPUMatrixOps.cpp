@@ -0,0 +1,313 @@
+#include "GPUMatrixOps.h"
+#include "IRMutator.h"
+#include "IROperator.h"
+#include "Simplify.h"
+#include "Substitute.h"
+
+namespace Halide {
+namespace Internal {
+
+using std::string;
+
+namespace {
+
+// The coefficients of a flattened index that is affine in the three
+// tile loop variables.
+struct TileAffineIndex {
+    Expr base, cx, cy, ck;
+};
+
+// Decompose a flattened index as base + x*cx + y*cy + k*ck, where the
+// coefficients may be arbitrary expressions in the outer loop
+// variables but must not involve the tile variables themselves.
+bool tile_affine(const Expr &index,
+                 const string &vx, const string &vy, const string &vk,
+                 TileAffineIndex *result) {
+    Expr zero = make_zero(index.type());
+    Expr one = make_one(index.type());
+    auto at = [&](const Expr &x, const Expr &y, const Expr &k) {
+        return substitute(vk, k, substitute(vy, y, substitute(vx, x, index)));
+    };
+    Expr base = at(zero, zero, zero);
+    Expr cx = simplify(at(one, zero, zero) - base);
+    Expr cy = simplify(at(zero, one, zero) - base);
+    Expr ck = simplify(at(zero, zero, one) - base);
+    Expr reconstructed = (base +
+                          Variable::make(index.type(), vx) * cx +
+                          Variable::make(index.type(), vy) * cy +
+                          Variable::make(index.type(), vk) * ck);
+    if (!can_prove(index == reconstructed)) {
+        return false;
+    }
+    result->base = simplify(base);
+    result->cx = cx;
+    result->cy = cy;
+    result->ck = ck;
+    return true;
+}
+
+// How to map a tile onto a cooperative matrix operation for one
+// device API.
+struct MatrixOpTarget {
+    // Edge length of the square tiles, which is also the accumulation
+    // depth of one operation.
+    int tile_size;
+    // The scheduling directive that produces the nest, for diagnostics.
+    const char *directive;
+    // The name of the call the device backend emits as the
+    // cooperative operation.
+    const char *call_name;
+};
+
+const MatrixOpTarget metal_target = {8, "metal_simdgroup_tile", "metal_simdgroup_mma"};
+const MatrixOpTarget cuda_target = {16, "gpu_tensor_core", "cuda_warp_mma"};
+
+class InjectGPUMatrixOps : public IRMutator {
+    using IRMutator::visit;
+
+    // The device API of the innermost enclosing device loop.
+    DeviceAPI current_device = DeviceAPI::None;
+
+    // Rebuild a load from the same buffer at a different index.
+    static Expr load_at(const Load *orig, const Expr &index) {
+        return Load::make(orig->type, orig->name, index,
+                          orig->image, orig->param,
+                          const_true(), ModulusRemainder());
+    }
+
+    // If e is a load usable as a matrix multiplicand for the given
+    // accumulator type, return it, otherwise nullptr. On CUDA the
+    // tensor cores multiply half-precision operands into a float or
+    // half accumulator, so a widening cast to the accumulator type is
+    // peeled off and checked; Metal simdgroups multiply at the
+    // accumulator precision directly.
+    const Load *as_matrix_operand(const Expr &e, Type acc) const {
+        Expr v = e;
+        if (current_device == DeviceAPI::CUDA) {
+            if (const Cast *cast = v.as<Cast>()) {
+                if (cast->type != acc) {
+                    return nullptr;
+                }
+                v = cast->value;
+            }
+            if (v.type() != Float(16)) {
+                return nullptr;
+            }
+        } else if (v.type() != acc) {
+            return nullptr;
+        }
+        const Load *load = v.as<Load>();
+        if (load && is_const_one(load->predicate)) {
+            return load;
+        }
+        return nullptr;
+    }
+
+    // Whether a loop nest looks like the product of a matrix tile
+    // directive: three loops of the device's tile extent around a
+    // multiply-accumulate of suitably typed operands. On CUDA a loop
+    // over gpu lanes is an ordinary schedule in its own right, so
+    // only nests that pass this test are claimed for tensor cores;
+    // the checks in build_matrix_mma that come after this are hard
+    // errors.
+    bool plausible_matrix_tile(const For *lk, const For *ly, const For *lx,
+                               const MatrixOpTarget &mt) const {
+        auto has_tile_extent = [&](const For *l) {
+            const int64_t *e = as_const_int(l->extent);
+            return e && *e == mt.tile_size && is_const_zero(l->min);
+        };
+        if (!has_tile_extent(lk) || !has_tile_extent(ly) || !has_tile_extent(lx)) {
+            return false;
+        }
+        const Store *store = lx->body.as<Store>();
+        if (!store) {
+            return false;
+        }
+        Type t = store->value.type();
+        if (t != Float(32) && t != Float(16)) {
+            return false;
+        }
+        const Add *add = store->value.as<Add>();
+        if (!add) {
+            return false;
+        }
+        const Mul *mul = add->b.as<Mul>();
+        if (!mul) {
+            mul = add->a.as<Mul>();
+        }
+        return mul &&
+               as_matrix_operand(mul->a, t) &&
+               as_matrix_operand(mul->b, t);
+    }
+
+    // Turn the loop nest k { y { x { C(x, y) += A(k, y) * B(x, k) } } }
+    // into a single cooperative matrix multiply-accumulate.
+    Stmt build_matrix_mma(const For *lk, const For *ly, const For *lx,
+                          const MatrixOpTarget &mt) {
+        const int ts = mt.tile_size;
+        std::ostringstream diag;
+        diag << "In the loop nest over " << lx->name
+             << " scheduled with " << mt.directive << ": ";
+
+        auto has_tile_extent = [&](const For *l) {
+            const int64_t *e = as_const_int(l->extent);
+            return e && *e == ts && is_const_zero(l->min);
+        };
+        user_assert(has_tile_extent(lk) && has_tile_extent(ly) && has_tile_extent(lx))
+            << diag.str()
+            << "all three tile loops must have constant extent " << ts << ". "
+            << "The accumulation domain's extent must be a multiple of " << ts
+            << ", so that splitting it requires no tail case.\n";
+        user_assert(lk->for_type == ForType::Serial &&
+                    ly->for_type == ForType::Serial)
+            << diag.str()
+            << "the tile loops must not be unrolled, vectorized, or "
+            << "mapped to GPU blocks or threads.\n";
+
+        const Store *store = lx->body.as<Store>();
+        user_assert(store && is_const_one(store->predicate))
+            << diag.str()
+            << "the innermost tile loop must contain a single "
+            << "unpredicated store.\n";
+
+        Type t = store->value.type();
+        user_assert(t == Float(32) || t == Float(16))
+            << diag.str()
+            << "cooperative matrix operations support float and half "
+            << "accumulators only, not " << t << ".\n";
+
+        // The stored value must be an accumulation of a product into
+        // the stored-to address.
+        const Add *add = store->value.as<Add>();
+        const Load *c_load = nullptr;
+        const Mul *mul = nullptr;
+        if (add) {
+            c_load = add->a.as<Load>();
+            mul = add->b.as<Mul>();
+            if (!mul) {
+                c_load = add->b.as<Load>();
+                mul = add->a.as<Mul>();
+            }
+        }
+        user_assert(c_load && mul &&
+                    c_load->name == store->name &&
+                    is_const_one(c_load->predicate) &&
+                    can_prove(c_load->index == store->index))
+            << diag.str()
+            << "the stored value must accumulate a product into the "
+            << "stored-to address, i.e. C(x, y) = C(x, y) + A * B.\n";
+
+        const Load *load_a = as_matrix_operand(mul->a, t);
+        const Load *load_b = as_matrix_operand(mul->b, t);
+        user_assert(load_a && load_b)
+            << diag.str()
+            << "both multiplicands must be unpredicated loads"
+            << (current_device == DeviceAPI::CUDA
+                    ? " of half-precision values, optionally widened to "
+                      "the accumulator type"
+                    : " at the accumulator type")
+            << ".\n";
+
+        const string &vx = lx->name;
+        const string &vy = ly->name;
+        const string &vk = lk->name;
+
+        TileAffineIndex c, a, b;
+        bool ok = tile_affine(store->index, vx, vy, vk, &c);
+        // One multiplicand spans the x and k dimensions of the tile,
+        // the other spans k and y. Decide which is which by looking
+        // for the one that is invariant to x.
+        ok = ok && tile_affine(load_a->index, vx, vy, vk, &a);
+        ok = ok && tile_affine(load_b->index, vx, vy, vk, &b);
+        user_assert(ok)
+            << diag.str()
+            << "all loads and stores must be affine in the tile "
+            << "loop variables.\n";
+        if (!is_const_zero(a.cx)) {
+            std::swap(load_a, load_b);
+            std::swap(a, b);
+        }
+
+        // The tiles must be dense along their fastest dimension, so
+        // that each can be described to the cooperative load by a
+        // base pointer and a row stride.
+        user_assert(is_const_zero(c.ck) && is_const_one(c.cx))
+            << diag.str()
+            << "the output must be invariant to the accumulation "
+            << "dimension and dense along the tile's x dimension.\n";
+        user_assert(is_const_zero(a.cx) && is_const_one(a.ck))
+            << diag.str()
+            << "the first multiplicand must be invariant to the "
+            << "tile's x dimension and dense along the accumulation "
+            << "dimension.\n";
+        user_assert(is_const_zero(b.cy) && is_const_one(b.cx))
+            << diag.str()
+            << "the second multiplicand must be invariant to the "
+            << "tile's y dimension and dense along the tile's x "
+            << "dimension.\n";
+
+        // The arguments describe each operand as a load of its first
+        // element plus a row stride in elements. The call is wrapped
+        // in a store of the output tile's first element, so that
+        // closure analysis still sees the output buffer as written;
+        // the device backend emits the whole thing as a single
+        // load/multiply-accumulate/store sequence.
+        Expr call = Call::make(t, mt.call_name,
+                               {load_at(c_load, c.base), c.cy,
+                                load_at(load_a, a.base), a.cy,
+                                load_at(load_b, b.base), b.ck},
+                               Call::Extern);
+        Stmt mma = Store::make(store->name, call, c.base, store->param,
+                               const_true(), ModulusRemainder());
+
+        // All 32 threads of a simdgroup (or warp) execute the
+        // cooperative operation together, so replace the tile loops
+        // with a loop over one full simdgroup. It reuses the
+        // canonical thread name the innermost tile loop was given,
+        // and its variable is deliberately unused in the body.
+        return For::make(lx->name, 0, 32, ForType::GPUThread,
+                         lx->device_api, mma);
+    }
+
+    Stmt visit(const For *op) override {
+        DeviceAPI old_device = current_device;
+        if (op->device_api != DeviceAPI::None) {
+            current_device = op->device_api;
+        }
+        const MatrixOpTarget *mt = nullptr;
+        if (current_device == DeviceAPI::Metal) {
+            mt = &metal_target;
+        } else if (current_device == DeviceAPI::CUDA) {
+            mt = &cuda_target;
+        }
+        Stmt result;
+        const For *ly = op->body.as<For>();
+        const For *lx = ly ? ly->body.as<For>() : nullptr;
+        if (mt && lx && lx->for_type == ForType::GPULane &&
+            (current_device == DeviceAPI::Metal ||
+             plausible_matrix_tile(op, ly, lx, *mt))) {
+            result = build_matrix_mma(op, ly, lx, *mt);
+        } else if (mt && op->for_type == ForType::GPULane &&
+                   current_device == DeviceAPI::Metal) {
+            user_error
+                << "Loop over " << op->name << " is scheduled as a loop "
+                << "over gpu lanes, which the Metal backend only supports "
+                << "as part of the multiply-accumulate tile structure "
+                << "produced by the metal_simdgroup_tile directive.\n";
+            result = op;
+        } else {
+            result = IRMutator::visit(op);
+        }
+        current_device = old_device;
+        return result;
+    }
+};
+
+}  // namespace
+
+Stmt inject_gpu_matrix_ops(const Stmt &s) {
+    return InjectGPUMatrixOps().mutate(s);
+}
+
+}  // namespace Internal
+}  // namespace Halide
@@ -0,0 +1,26 @@
+#ifndef HALIDE_GPU_MATRIX_OPS_H
+#define HALIDE_GPU_MATRIX_OPS_H
+
+/** \file
+ * Defines the lowering pass that maps marked multiply-accumulate
+ * tiles onto cooperative GPU matrix operations: simdgroup matrix
+ * operations on Metal, and tensor core (WMMA) operations on CUDA.
+ */
+
+#include "Expr.h"
+
+namespace Halide {
+namespace Internal {
+
+/** Rewrite the multiply-accumulate loop nests produced by the
+ * metal_simdgroup_tile and gpu_tensor_core scheduling directives into
+ * single cooperative matrix operations: 8x8x8 simdgroup tiles on
+ * Metal, and 16x16x16 WMMA tiles on CUDA. Must run after storage
+ * flattening and GPU API selection, and before the GPU thread loops
+ * are fused. */
+Stmt inject_gpu_matrix_ops(const Stmt &s);
+
+}  // namespace Internal
+}  // namespace Halide
+
+#endif
@@ -1,4 +1,5 @@
 #include <cmath>
+#include <cstdio>
 #include <fstream>
 #include <unordered_map>
 #include <utility>
@@ -747,6 +748,118 @@ std::string halide_type_to_c_type(const Type &t) {
     return m.at(encode(t));
 }
 
+namespace {
+
+// Content-hash-based reuse of generator outputs, enabled by setting
+// HL_GENERATOR_CACHE_DIR to an existing writable directory. The key
+// covers the generator executable itself along with everything that
+// selects what gets generated, so editing generator source or
+// upgrading Halide invalidates stale entries, while re-running an
+// unchanged (generator, args, target) triple skips lowering and
+// codegen entirely.
+
+uint64_t fnv1a_hash(const void *data, size_t size, uint64_t h) {
+    const uint8_t *p = (const uint8_t *)data;
+    for (size_t i = 0; i < size; i++) {
+        h = (h ^ p[i]) * 0x100000001b3ULL;
+    }
+    return h;
+}
+
+uint64_t fnv1a_hash(const std::string &s, uint64_t h) {
+    return fnv1a_hash(s.data(), s.size(), h);
+}
+
+bool hash_file_contents(const std::string &path, uint64_t &h) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+    char buf[65536];
+    while (in.read(buf, sizeof(buf)) || in.gcount()) {
+        h = fnv1a_hash(buf, (size_t)in.gcount(), h);
+    }
+    return true;
+}
+
+std::string generator_cache_key(const std::string &generator_name,
+                                const std::string &function_name,
+                                const GeneratorParamsMap &generator_args,
+                                const std::vector<std::string> &target_strings,
+                                const std::set<Output> &outputs) {
+    std::string exe = running_program_path();
+    uint64_t h = 0xcbf29ce484222325ULL;
+    if (exe.empty() || !hash_file_contents(exe, h)) {
+        // Without a hash of the generator binary, the cache would
+        // return stale outputs after a source change.
+        return "";
+    }
+    h = fnv1a_hash(generator_name + "|" + function_name + "|", h);
+    for (const auto &arg : generator_args) {
+        h = fnv1a_hash(arg.first + "=" + arg.second.string_value + "|", h);
+    }
+    for (const auto &t : target_strings) {
+        h = fnv1a_hash(t + "|", h);
+    }
+    for (Output o : outputs) {
+        h = fnv1a_hash(std::to_string((int)o) + "|", h);
+    }
+    char key[32];
+    snprintf(key, sizeof(key), "%016llx", (unsigned long long)h);
+    return key;
+}
+
+std::string generator_cache_path(const std::string &cache_dir, const std::string &key, Output o) {
+    return cache_dir + "/halide_generator_" + key + "_" + std::to_string((int)o);
+}
+
+bool copy_file_contents(const std::string &src, const std::string &dst) {
+    std::ifstream in(src, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+    // Write to a temporary file and rename it into place, so a
+    // concurrent process never observes a partial copy.
+    std::string tmp = dst + "." + unique_name('t') + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary);
+        char buf[65536];
+        while (in.read(buf, sizeof(buf)) || in.gcount()) {
+            out.write(buf, in.gcount());
+        }
+        if (!out.good()) {
+            file_unlink(tmp);
+            return false;
+        }
+    }
+    if (std::rename(tmp.c_str(), dst.c_str()) != 0) {
+        file_unlink(tmp);
+        return false;
+    }
+    return true;
+}
+
+bool restore_cached_outputs(const std::string &cache_dir, const std::string &key,
+                            const std::map<Output, std::string> &output_files) {
+    for (const auto &it : output_files) {
+        if (!copy_file_contents(generator_cache_path(cache_dir, key, it.first), it.second)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void store_cached_outputs(const std::string &cache_dir, const std::string &key,
+                          const std::map<Output, std::string> &output_files) {
+    for (const auto &it : output_files) {
+        // Failure to populate the cache (e.g. a read-only or missing
+        // directory) is not an error; the outputs were generated.
+        copy_file_contents(it.second, generator_cache_path(cache_dir, key, it.first));
+    }
+}
+
+}  // namespace
+
 int generate_filter_main_inner(int argc, char **argv, std::ostream &error_output) {
     const char kUsage[] =
         "gengen\n"
@@ -1030,7 +1143,21 @@ int generate_filter_main_inner(int argc, char **argv, std::ostream &error_output
                 gen->set_generator_param_values(sub_generator_args);
                 return build_gradient_module ? gen->build_gradient_module(name) : gen->build_module(name);
             };
-            compile_multitarget(function_name, output_files, targets, target_strings, module_factory, compiler_logger_factory);
+            std::string cache_dir = get_env_variable("HL_GENERATOR_CACHE_DIR");
+            std::string cache_key;
+            if (!cache_dir.empty()) {
+                cache_key = generator_cache_key(generator_name, function_name,
+                                                generator_args, target_strings, outputs);
+            }
+            if (!cache_key.empty() &&
+                restore_cached_outputs(cache_dir, cache_key, output_files)) {
+                debug(1) << "Generator output cache hit for " << generator_name << "\n";
+            } else {
+                compile_multitarget(function_name, output_files, targets, target_strings, module_factory, compiler_logger_factory);
+                if (!cache_key.empty()) {
+                    store_cached_outputs(cache_dir, cache_key, output_files);
+                }
+            }
         }
     }
 
@@ -2294,6 +2421,52 @@ void generator_test() {
         static_assert(std::is_same<decltype(tester_instance.buffer_array_output[0]), const Func &>::value, "type mismatch");
     }
 
+    // Verify that Generators compose: a parent context can create a
+    // child Generator, bind its inputs to local Funcs with
+    // apply_unscheduled() (which skips the child's schedule()), and
+    // then fuse the child's output into its own loop nest with
+    // compute_at, so no full-sized intermediate is materialized at
+    // the boundary.
+    {
+        class Doubler : public Generator<Doubler> {
+        public:
+            Input<Func> input{"input", Int(32), 1};
+            Output<Func> output{"output", Int(32), 1};
+
+            void generate() {
+                Var x;
+                output(x) = input(x) * 2;
+            }
+            void schedule() {
+                // Deliberately hostile to fusion; skipped by
+                // apply_unscheduled() below.
+                output.compute_root();
+            }
+        };
+
+        auto child = context.create<Doubler>();
+
+        Var x;
+        Func source("source");
+        source(x) = cast<int32_t>(x);
+        child->apply_unscheduled(source);
+        internal_assert(child->phase == GeneratorBase::GenerateCalled);
+
+        Func sink("sink");
+        sink(x) = child->output(x) + 1;
+
+        // Schedule the child's output inside the consumer's loops,
+        // across the Generator boundary.
+        Var xo, xi;
+        sink.split(x, xo, xi, 8);
+        child->output.compute_at(sink, xo);
+
+        Buffer<int> im = sink.realize({32});
+        for (int i = 0; i < im.dim(0).extent(); i++) {
+            internal_assert(im(i) == i * 2 + 1) << "Expected " << i * 2 + 1 << " but saw " << im(i);
+        }
+    }
+
     class GPTester : public Generator<GPTester> {
     public:
         GeneratorParam<int> gp{"gp", 0};
@@ -3505,6 +3505,28 @@ public:
         call_schedule();
     }
 
+    /** Like apply(), but stops after the generate() method: the
+     * inputs are bound and the output Funcs are defined, but the
+     * Generator's schedule() method is not run. This is the intended
+     * way to compose Generators when the enclosing Generator wants to
+     * schedule the child's Funcs into its own loop nest -- e.g.
+     * compute_at'ing the child's output at one of its own loops so
+     * that no full-sized intermediate is materialized at the library
+     * boundary -- where the child's standalone schedule would fight
+     * the enclosing one. The child's Funcs keep their default
+     * (inline or root) schedules until the caller says otherwise;
+     * schedule-related methods on the child's Output<> members
+     * forward to the underlying Funcs. */
+    template<typename... Args>
+    void apply_unscheduled(const Args &...args) {
+#ifndef _MSC_VER
+        static_assert(has_generate_method<T>::value, "apply_unscheduled() is not supported for old-style Generators.");
+#endif
+        call_configure();
+        set_inputs(args...);
+        call_generate();
+    }
+
 private:
     // std::is_member_function_pointer will fail if there is no member of that name,
     // so we use a little SFINAE to detect if there are method-shaped members.
@@ -0,0 +1,170 @@
+#include "GraphRewrite.h"
+
+#include "Debug.h"
+#include "FindCalls.h"
+#include "Function.h"
+#include "IRMutator.h"
+#include "IRVisitor.h"
+#include "Inline.h"
+#include "RealizationOrder.h"
+#include "Simplify.h"
+
+namespace Halide {
+namespace Internal {
+
+using std::map;
+using std::set;
+using std::string;
+using std::vector;
+
+namespace {
+
+// Measure a group of Exprs by the number of unique IR nodes reachable
+// and the number of distinct calls to other Funcs. Shared subtrees are
+// counted once, so this is stable under the common-subexpression
+// sharing that inlining introduces.
+class MeasureIR : public IRGraphVisitor {
+    using IRGraphVisitor::include;
+    using IRGraphVisitor::visit;
+
+    void include(const Expr &e) override {
+        size++;
+        IRGraphVisitor::include(e);
+    }
+
+    void visit(const Call *op) override {
+        if (op->call_type == Call::Halide) {
+            halide_calls++;
+        }
+        IRGraphVisitor::visit(op);
+    }
+
+public:
+    int size = 0;
+    int halide_calls = 0;
+
+    void measure(const vector<Expr> &exprs) {
+        for (const Expr &e : exprs) {
+            if (e.defined()) {
+                include(e);
+            }
+        }
+    }
+};
+
+// Replace all calls to a given producer with its definition, then
+// re-simplify. Applied to each root Expr of a consumer's definitions.
+class ComposeCalls : public IRMutator {
+    const Function &producer;
+
+    using IRMutator::mutate;
+
+    Expr mutate(const Expr &e) override {
+        if (!e.defined()) {
+            return e;
+        }
+        return simplify(inline_function(e, producer));
+    }
+
+public:
+    ComposeCalls(const Function &producer)
+        : producer(producer) {
+    }
+};
+
+// The root Exprs of a consumer that composing a producer would affect,
+// and on which profitability is judged.
+vector<Expr> root_exprs(const Function &f) {
+    vector<Expr> result = f.definition().values();
+    for (const Definition &def : f.updates()) {
+        result.insert(result.end(), def.args().begin(), def.args().end());
+        result.insert(result.end(), def.values().begin(), def.values().end());
+    }
+    return result;
+}
+
+// Is this Func cheap and unconstrained enough that substituting it
+// into a consumer could be worthwhile?
+bool is_composable_producer(const Function &f, const set<string> &outputs) {
+    if (outputs.count(f.name())) {
+        return false;
+    }
+    if (!f.can_be_inlined() ||
+        f.has_update_definition() ||
+        f.has_extern_definition()) {
+        return false;
+    }
+    if (f.schedule().memoized() ||
+        !f.schedule().wrappers().empty() ||
+        !f.schedule().compute_level().is_inlined()) {
+        // Respect explicit schedules; lowering will honor them.
+        return false;
+    }
+    MeasureIR m;
+    m.measure(f.definition().values());
+    return m.halide_calls <= 2 && m.size <= 32;
+}
+
+// Speculatively compose the producer into the consumer's definitions
+// and keep the rewrite only if simplification leaves the consumer no
+// more expensive than it was.
+bool compose_is_profitable(const Function &consumer, const Function &producer) {
+    vector<Expr> before = root_exprs(consumer);
+    vector<Expr> after;
+    after.reserve(before.size());
+    for (const Expr &e : before) {
+        after.push_back(e.defined() ? simplify(inline_function(e, producer)) : e);
+    }
+    MeasureIR before_m, after_m;
+    before_m.measure(before);
+    after_m.measure(after);
+    return (after_m.halide_calls <= before_m.halide_calls &&
+            after_m.size <= before_m.size + 8);
+}
+
+}  // namespace
+
+void graph_rewrite(const vector<Function> &outputs,
+                   map<string, Function> &env) {
+    set<string> output_names;
+    for (const Function &f : outputs) {
+        output_names.insert(f.name());
+    }
+
+    // Visit producers before their consumers, so that rewrites compose
+    // along chains: once a producer has been folded into a mid-pipeline
+    // shim, the shim itself may become foldable into its consumers.
+    vector<string> order = topological_order(outputs, env);
+
+    for (const string &name : order) {
+        auto producer_iter = env.find(name);
+        if (producer_iter == env.end()) {
+            continue;
+        }
+        const Function &producer = producer_iter->second;
+        if (!is_composable_producer(producer, output_names)) {
+            continue;
+        }
+        for (auto &consumer_iter : env) {
+            Function &consumer = consumer_iter.second;
+            if (consumer.same_as(producer) ||
+                consumer.has_extern_definition() ||
+                !consumer.definition().defined()) {
+                continue;
+            }
+            if (find_direct_calls(consumer).count(name) == 0) {
+                continue;
+            }
+            if (!compose_is_profitable(consumer, producer)) {
+                continue;
+            }
+            debug(2) << "Graph rewrite: composing " << name
+                     << " into " << consumer.name() << "\n";
+            ComposeCalls compose(producer);
+            consumer.mutate(&compose);
+        }
+    }
+}
+
+}  // namespace Internal
+}  // namespace Halide
@@ -0,0 +1,38 @@
+#ifndef HALIDE_GRAPH_REWRITE_H
+#define HALIDE_GRAPH_REWRITE_H
+
+/** \file
+ * Defines an optional pre-lowering pass that simplifies across Func
+ * boundaries by composing cheap producers into their consumers.
+ */
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace Halide {
+namespace Internal {
+
+class Function;
+
+/** Rewrite the Function DAG by substituting cheap, pure producers
+ * into the definitions of their consumers and re-simplifying. This
+ * catches algebraic simplifications that Simplify cannot see from
+ * within a single Expr: constant-valued Funcs fold away entirely,
+ * chains of affine reindexings (e.g. a resize followed by a crop)
+ * compose into a single coordinate transform, and slices of
+ * concat-style Funcs collapse to the branch that is actually read.
+ * Each substitution is first attempted speculatively and only kept if
+ * the simplified consumer is no more expensive than before, so
+ * expensive producers are never duplicated into their callers.
+ *
+ * Only Funcs with a single pure definition, no specializations or
+ * wrappers, and a default (inlined) schedule are considered; pipeline
+ * outputs and explicitly-scheduled Funcs are left alone. */
+void graph_rewrite(const std::vector<Function> &outputs,
+                   std::map<std::string, Function> &env);
+
+}  // namespace Internal
+}  // namespace Halide
+
+#endif
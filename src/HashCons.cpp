@@ -0,0 +1,301 @@
+#include <unordered_set>
+
+#include "HashCons.h"
+#include "IR.h"
+#include "IRMutator.h"
+#include "Util.h"
+
+namespace Halide {
+namespace Internal {
+
+namespace {
+
+uint64_t hash_combine(uint64_t h, uint64_t v) {
+    return h * 0x9e3779b97f4a7c15ULL + v;
+}
+
+uint64_t hash_type(Type t) {
+    return (((uint64_t)t.code()) << 32) | (((uint64_t)t.bits()) << 16) | (uint64_t)t.lanes();
+}
+
+uint64_t hash_string(const std::string &s) {
+    return std::hash<std::string>()(s);
+}
+
+uint64_t hash_ptr(const IRNode *p) {
+    return (uint64_t)(uintptr_t)p;
+}
+
+// A shallow hash of a single node. Children contribute only their
+// identity, so this is only a structural hash if the children have
+// already been interned. Handles to things outside the IR (Parameters,
+// Buffers, Functions, ReductionDomains) are compared by identity below
+// rather than hashed, so they only contribute their names here.
+uint64_t shallow_hash(const Expr &e) {
+    uint64_t h = hash_combine((uint64_t)e->node_type, hash_type(e.type()));
+    switch (e->node_type) {
+    case IRNodeType::IntImm:
+        return hash_combine(h, (uint64_t)e.as<IntImm>()->value);
+    case IRNodeType::UIntImm:
+        return hash_combine(h, e.as<UIntImm>()->value);
+    case IRNodeType::FloatImm:
+        return hash_combine(h, std::hash<double>()(e.as<FloatImm>()->value));
+    case IRNodeType::StringImm:
+        return hash_combine(h, hash_string(e.as<StringImm>()->value));
+    case IRNodeType::Cast:
+        return hash_combine(h, hash_ptr(e.as<Cast>()->value.get()));
+    case IRNodeType::Variable:
+        return hash_combine(h, hash_string(e.as<Variable>()->name));
+    case IRNodeType::Add:
+    case IRNodeType::Sub:
+    case IRNodeType::Mul:
+    case IRNodeType::Div:
+    case IRNodeType::Mod:
+    case IRNodeType::Min:
+    case IRNodeType::Max:
+    case IRNodeType::EQ:
+    case IRNodeType::NE:
+    case IRNodeType::LT:
+    case IRNodeType::LE:
+    case IRNodeType::GT:
+    case IRNodeType::GE:
+    case IRNodeType::And:
+    case IRNodeType::Or: {
+        // All the binary operators lay out their operands
+        // identically, but there's no common base class, so pick one.
+        const Add *op = (const Add *)e.get();
+        h = hash_combine(h, hash_ptr(op->a.get()));
+        return hash_combine(h, hash_ptr(op->b.get()));
+    }
+    case IRNodeType::Not:
+        return hash_combine(h, hash_ptr(e.as<Not>()->a.get()));
+    case IRNodeType::Select: {
+        const Select *op = e.as<Select>();
+        h = hash_combine(h, hash_ptr(op->condition.get()));
+        h = hash_combine(h, hash_ptr(op->true_value.get()));
+        return hash_combine(h, hash_ptr(op->false_value.get()));
+    }
+    case IRNodeType::Load: {
+        const Load *op = e.as<Load>();
+        h = hash_combine(h, hash_string(op->name));
+        h = hash_combine(h, hash_ptr(op->predicate.get()));
+        return hash_combine(h, hash_ptr(op->index.get()));
+    }
+    case IRNodeType::Ramp: {
+        const Ramp *op = e.as<Ramp>();
+        h = hash_combine(h, hash_ptr(op->base.get()));
+        return hash_combine(h, hash_ptr(op->stride.get()));
+    }
+    case IRNodeType::Broadcast:
+        return hash_combine(h, hash_ptr(e.as<Broadcast>()->value.get()));
+    case IRNodeType::Call: {
+        const Call *op = e.as<Call>();
+        h = hash_combine(h, hash_string(op->name));
+        h = hash_combine(h, (uint64_t)op->call_type);
+        h = hash_combine(h, (uint64_t)op->value_index);
+        for (const Expr &arg : op->args) {
+            h = hash_combine(h, hash_ptr(arg.get()));
+        }
+        return h;
+    }
+    case IRNodeType::Let: {
+        const Let *op = e.as<Let>();
+        h = hash_combine(h, hash_string(op->name));
+        h = hash_combine(h, hash_ptr(op->value.get()));
+        return hash_combine(h, hash_ptr(op->body.get()));
+    }
+    case IRNodeType::Shuffle: {
+        const Shuffle *op = e.as<Shuffle>();
+        for (const Expr &v : op->vectors) {
+            h = hash_combine(h, hash_ptr(v.get()));
+        }
+        for (int i : op->indices) {
+            h = hash_combine(h, (uint64_t)i);
+        }
+        return h;
+    }
+    case IRNodeType::VectorReduce: {
+        const VectorReduce *op = e.as<VectorReduce>();
+        h = hash_combine(h, (uint64_t)op->op);
+        return hash_combine(h, hash_ptr(op->value.get()));
+    }
+    default:
+        internal_error << "shallow_hash on non-Expr node\n";
+        return h;
+    }
+}
+
+// Shallow structural equality of two nodes with interned children:
+// children and external handles are compared by identity only.
+bool shallow_equal(const Expr &a, const Expr &b) {
+    if (a->node_type != b->node_type || a.type() != b.type()) {
+        return false;
+    }
+    switch (a->node_type) {
+    case IRNodeType::IntImm:
+        return a.as<IntImm>()->value == b.as<IntImm>()->value;
+    case IRNodeType::UIntImm:
+        return a.as<UIntImm>()->value == b.as<UIntImm>()->value;
+    case IRNodeType::FloatImm:
+        return a.as<FloatImm>()->value == b.as<FloatImm>()->value;
+    case IRNodeType::StringImm:
+        return a.as<StringImm>()->value == b.as<StringImm>()->value;
+    case IRNodeType::Cast:
+        return a.as<Cast>()->value.same_as(b.as<Cast>()->value);
+    case IRNodeType::Variable: {
+        const Variable *va = a.as<Variable>(), *vb = b.as<Variable>();
+        // Distinguish variables that carry different handles even if
+        // they somehow share a name; merging them would drop
+        // references the backends rely on.
+        return (va->name == vb->name &&
+                va->param.same_as(vb->param) &&
+                va->image.same_as(vb->image) &&
+                va->reduction_domain.same_as(vb->reduction_domain));
+    }
+    case IRNodeType::Add:
+    case IRNodeType::Sub:
+    case IRNodeType::Mul:
+    case IRNodeType::Div:
+    case IRNodeType::Mod:
+    case IRNodeType::Min:
+    case IRNodeType::Max:
+    case IRNodeType::EQ:
+    case IRNodeType::NE:
+    case IRNodeType::LT:
+    case IRNodeType::LE:
+    case IRNodeType::GT:
+    case IRNodeType::GE:
+    case IRNodeType::And:
+    case IRNodeType::Or: {
+        const Add *oa = (const Add *)a.get(), *ob = (const Add *)b.get();
+        return oa->a.same_as(ob->a) && oa->b.same_as(ob->b);
+    }
+    case IRNodeType::Not:
+        return a.as<Not>()->a.same_as(b.as<Not>()->a);
+    case IRNodeType::Select: {
+        const Select *oa = a.as<Select>(), *ob = b.as<Select>();
+        return (oa->condition.same_as(ob->condition) &&
+                oa->true_value.same_as(ob->true_value) &&
+                oa->false_value.same_as(ob->false_value));
+    }
+    case IRNodeType::Load: {
+        const Load *oa = a.as<Load>(), *ob = b.as<Load>();
+        return (oa->name == ob->name &&
+                oa->predicate.same_as(ob->predicate) &&
+                oa->index.same_as(ob->index) &&
+                oa->image.same_as(ob->image) &&
+                oa->param.same_as(ob->param) &&
+                oa->alignment == ob->alignment);
+    }
+    case IRNodeType::Ramp: {
+        const Ramp *oa = a.as<Ramp>(), *ob = b.as<Ramp>();
+        return oa->base.same_as(ob->base) && oa->stride.same_as(ob->stride);
+    }
+    case IRNodeType::Broadcast:
+        return a.as<Broadcast>()->value.same_as(b.as<Broadcast>()->value);
+    case IRNodeType::Call: {
+        const Call *oa = a.as<Call>(), *ob = b.as<Call>();
+        if (oa->name != ob->name ||
+            oa->call_type != ob->call_type ||
+            oa->value_index != ob->value_index ||
+            !oa->func.same_as(ob->func) ||
+            !oa->image.same_as(ob->image) ||
+            !oa->param.same_as(ob->param) ||
+            oa->args.size() != ob->args.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < oa->args.size(); i++) {
+            if (!oa->args[i].same_as(ob->args[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+    case IRNodeType::Let: {
+        const Let *oa = a.as<Let>(), *ob = b.as<Let>();
+        return (oa->name == ob->name &&
+                oa->value.same_as(ob->value) &&
+                oa->body.same_as(ob->body));
+    }
+    case IRNodeType::Shuffle: {
+        const Shuffle *oa = a.as<Shuffle>(), *ob = b.as<Shuffle>();
+        if (oa->vectors.size() != ob->vectors.size() ||
+            oa->indices != ob->indices) {
+            return false;
+        }
+        for (size_t i = 0; i < oa->vectors.size(); i++) {
+            if (!oa->vectors[i].same_as(ob->vectors[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+    case IRNodeType::VectorReduce: {
+        const VectorReduce *oa = a.as<VectorReduce>(), *ob = b.as<VectorReduce>();
+        return oa->op == ob->op && oa->value.same_as(ob->value);
+    }
+    default:
+        internal_error << "shallow_equal on non-Expr node\n";
+        return false;
+    }
+}
+
+struct ShallowHash {
+    size_t operator()(const Expr &e) const {
+        return (size_t)shallow_hash(e);
+    }
+};
+
+struct ShallowEqual {
+    bool operator()(const Expr &a, const Expr &b) const {
+        return shallow_equal(a, b);
+    }
+};
+
+// Rewrites bottom-up, replacing each node with the canonical
+// representative of its equivalence class. Because interning proceeds
+// bottom-up, by the time a node is looked up its children are already
+// canonical, so the shallow hash and equality above are structural.
+// IRGraphMutator's replacement map doubles as the done-set for nasty
+// graphs, and interning is scoped to one instance of this mutator, so
+// the table doesn't pin nodes beyond the pass.
+class HashConser : public IRGraphMutator {
+    std::unordered_set<Expr, ShallowHash, ShallowEqual> table;
+
+    Expr intern(const Expr &e) {
+        auto p = table.insert(e);
+        return *p.first;
+    }
+
+public:
+    using IRGraphMutator::mutate;
+
+    Expr mutate(const Expr &e) override {
+        if (!e.defined()) {
+            return e;
+        }
+        auto p = expr_replacements.emplace(e, Expr());
+        if (p.second) {
+            p.first->second = intern(IRMutator::mutate(e));
+        }
+        return p.first->second;
+    }
+};
+
+}  // namespace
+
+bool hash_consing_enabled() {
+    static const bool enabled = !get_env_variable("HL_HASH_CONS").empty();
+    return enabled;
+}
+
+Expr hash_cons(const Expr &e) {
+    return HashConser().mutate(e);
+}
+
+Stmt hash_cons(const Stmt &s) {
+    return HashConser().mutate(s);
+}
+
+}  // namespace Internal
+}  // namespace Halide
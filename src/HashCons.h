@@ -0,0 +1,35 @@
+#ifndef HALIDE_HASH_CONS_H
+#define HALIDE_HASH_CONS_H
+
+/** \file
+ * Defines a pass that rewrites Exprs so that structurally identical
+ * subexpressions are represented by a single shared node.
+ */
+
+#include "Expr.h"
+
+namespace Halide {
+namespace Internal {
+
+/** Is the HL_HASH_CONS environment variable set? When it is, lower()
+ * and common_subexpression_elimination run hash_cons on their inputs. */
+bool hash_consing_enabled();
+
+/** Rewrite an Expr (or all the Exprs within a Stmt) so that
+ * structurally identical subexpressions are represented by a single
+ * shared node. Within the result, equality of value coincides with
+ * equality of identity, so the deep comparisons in equal() and the
+ * compare-cached maps used by CSE terminate at their same_as fast
+ * paths instead of walking whole subtrees. Sharing is only
+ * established between nodes interned by the same call; passes that
+ * construct fresh nodes dilute it, so apply this where a burst of
+ * deep comparisons is about to happen. */
+// @{
+Expr hash_cons(const Expr &e);
+Stmt hash_cons(const Stmt &s);
+// @}
+
+}  // namespace Internal
+}  // namespace Halide
+
+#endif
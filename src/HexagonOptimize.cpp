@@ -14,6 +14,8 @@
 #include "Scope.h"
 #include "Simplify.h"
 #include "Substitute.h"
+#include "Util.h"
+#include <algorithm>
 #include <unordered_map>
 #include <utility>
 
@@ -331,6 +333,54 @@ Expr replace_pattern(Expr x, const vector<Expr> &matches, const Pattern &p) {
     return x;
 }
 
+// A table of patterns, bucketed by the root IR node so that matching
+// only tries the patterns that could possibly apply. expr_match
+// rejects a pattern immediately unless the root node types agree
+// (and, for calls, the callee names), so instead of walking the whole
+// table linearly per expression we index it once at construction: a
+// lookup dispatches on the root of the expression and returns just
+// the candidate patterns, preserving their original priority
+// order. For the big mul/add/cast tables this is the difference
+// between a handful of match attempts per node and hundreds.
+class PatternTable {
+    vector<Pattern> patterns;
+    // Patterns with a Call root, bucketed by callee name.
+    std::map<string, vector<size_t>> call_buckets;
+    // All other patterns, bucketed by root node type.
+    std::map<IRNodeType, vector<size_t>> node_buckets;
+    static const vector<size_t> empty_bucket;
+
+public:
+    PatternTable(std::initializer_list<Pattern> init)
+        : patterns(init) {
+        for (size_t i = 0; i < patterns.size(); i++) {
+            const Expr &p = patterns[i].pattern;
+            if (const Call *c = p.as<Call>()) {
+                call_buckets[c->name].push_back(i);
+            } else {
+                node_buckets[p.node_type()].push_back(i);
+            }
+        }
+    }
+
+    const Pattern &operator[](size_t i) const {
+        return patterns[i];
+    }
+
+    /** The indices of the patterns whose root could match x, in table
+     * order. */
+    const vector<size_t> &candidates(const Expr &x) const {
+        if (const Call *c = x.as<Call>()) {
+            auto it = call_buckets.find(c->name);
+            return it != call_buckets.end() ? it->second : empty_bucket;
+        }
+        auto it = node_buckets.find(x.node_type());
+        return it != node_buckets.end() ? it->second : empty_bucket;
+    }
+};
+
+const vector<size_t> PatternTable::empty_bucket;
+
 bool is_double_vector(const Expr &x, const Target &target) {
     int native_vector_lanes = target.natural_vector_size(x.type());
     return x.type().lanes() % (2 * native_vector_lanes) == 0;
@@ -340,11 +390,12 @@ bool is_double_vector(const Expr &x, const Target &target) {
 // successful, the expression is replaced with a call using the
 // matched operands. Prior to substitution, the matches are mutated
 // with op_mutator.
-Expr apply_patterns(Expr x, const vector<Pattern> &patterns, const Target &target, IRMutator *op_mutator) {
+Expr apply_patterns(Expr x, const PatternTable &patterns, const Target &target, IRMutator *op_mutator) {
     constexpr int debug_level = 3;
     debug(debug_level) << "apply_patterns " << x << "\n";
     vector<Expr> matches;
-    for (const Pattern &p : patterns) {
+    for (size_t idx : patterns.candidates(x)) {
+        const Pattern &p = patterns[idx];
         if (!check_pattern_target(p.flags, target)) {
             continue;
         }
@@ -380,7 +431,7 @@ Expr apply_patterns(Expr x, const vector<Pattern> &patterns, const Target &targe
 }
 
 template<typename T>
-Expr apply_commutative_patterns(const T *op, const vector<Pattern> &patterns, const Target &target, IRMutator *mutator) {
+Expr apply_commutative_patterns(const T *op, const PatternTable &patterns, const Target &target, IRMutator *mutator) {
     Expr ret = apply_patterns(op, patterns, target, mutator);
     if (!ret.same_as(op)) {
         return ret;
@@ -502,7 +553,7 @@ private:
     const Target &target;
 
     Expr visit(const Mul *op) override {
-        static const vector<Pattern> scalar_muls = {
+        static const PatternTable scalar_muls = {
             // Non-widening scalar multiplication.
             {"halide.hexagon.mul.vh.b", wild_i16x * bc(wild_i16), Pattern::NarrowOp1},
             {"halide.hexagon.mul.vw.h", wild_i32x * bc(wild_i32), Pattern::NarrowOp1},
@@ -512,7 +563,7 @@ private:
             // 32 bits.
         };
 
-        static const vector<Pattern> muls = {
+        static const PatternTable muls = {
             // One operand widening multiplication.
             {"halide.hexagon.mul.vw.vh", wild_i32x * wild_i32x, Pattern::ReinterleaveOp0 | Pattern::NarrowOp1},
             {"halide.hexagon.mul.vw.vuh", wild_i32x * wild_i32x, Pattern::ReinterleaveOp0 | Pattern::NarrowUnsignedOp1},
@@ -742,7 +793,7 @@ private:
         if (mpyadd.defined()) {
             return mpyadd;
         }
-        static const vector<Pattern> adds = {
+        static const PatternTable adds = {
             // Use accumulating versions of vmpa, vdmpy, vrmpy instructions when possible.
             {"halide.hexagon.acc_add_2mpy.vh.vub.vub.b.b", wild_i16x + halide_hexagon_add_2mpy(Int(16, 0), ".vub.vub.b.b", wild_u8x, wild_u8x, wild_i8, wild_i8), Pattern::ReinterleaveOp0},
             {"halide.hexagon.acc_add_2mpy.vw.vh.vh.b.b", wild_i32x + halide_hexagon_add_2mpy(Int(32, 0), ".vh.vh.b.b", wild_i16x, wild_i16x, wild_i8, wild_i8), Pattern::ReinterleaveOp0},
@@ -860,7 +911,7 @@ private:
             {"halide.hexagon.trunc_satdw_mpy2.vw.vw", i32_sat(widening_mul(wild_i32x, wild_i32x) >> wild_u64)},
         };
 
-        static const vector<Pattern> casts = {
+        static const PatternTable casts = {
             // Halving unsigned subtract.
             {"halide.hexagon.navg.vub.vub", i8(widening_sub(wild_u8x, wild_u8x) >> u16(1))},
 
@@ -1058,7 +1109,7 @@ private:
             }
         }
 
-        static const vector<Pattern> calls = {
+        static const PatternTable calls = {
             // Vector by scalar widening multiplies. These need to happen before the ones below, to avoid
             // using vector versions when scalar versions would suffice.
             {"halide.hexagon.mpy.vub.ub", widening_mul(wild_u8x, bc(wild_u8)), Pattern::InterleaveResult},
@@ -2487,6 +2538,138 @@ Stmt scatter_gather_generator(Stmt s) {
     return s;
 }
 
+// Collect the VTCM-scheduled allocations in a function, along with
+// their sizes and an estimate of how often each one is accessed.
+class FindVtcmAllocations : public IRVisitor {
+public:
+    struct VtcmAllocation {
+        string name;
+        int64_t size = 0;
+        bool constant_size = false;
+        double accesses = 0;
+    };
+    vector<VtcmAllocation> allocations;
+
+private:
+    using IRVisitor::visit;
+
+    // An estimate of how many times the statement currently being
+    // visited runs.
+    double trip_count = 1;
+
+    // Assume loops of unknown extent run for a while.
+    static constexpr double assumed_extent = 64;
+
+    void visit(const For *op) override {
+        const int64_t *extent = as_const_int(op->extent);
+        double old_trip_count = trip_count;
+        trip_count = std::min(trip_count * (extent ? (double)*extent : assumed_extent), 1e30);
+        IRVisitor::visit(op);
+        trip_count = old_trip_count;
+    }
+
+    void visit(const Allocate *op) override {
+        if (op->memory_type == MemoryType::VTCM) {
+            VtcmAllocation alloc;
+            alloc.name = op->name;
+            int32_t elems = op->constant_allocation_size();
+            alloc.size = (int64_t)elems * op->type.bytes();
+            alloc.constant_size = elems != 0;
+            allocations.push_back(alloc);
+        }
+        IRVisitor::visit(op);
+    }
+
+    void count_access(const string &name) {
+        for (VtcmAllocation &a : allocations) {
+            if (a.name == name) {
+                a.accesses += trip_count;
+            }
+        }
+    }
+
+    void visit(const Load *op) override {
+        IRVisitor::visit(op);
+        count_access(op->name);
+    }
+
+    void visit(const Store *op) override {
+        IRVisitor::visit(op);
+        count_access(op->name);
+    }
+};
+
+// Demote the given VTCM-scheduled allocations to plain memory.
+class SpillVtcmAllocations : public IRMutator {
+    const set<string> &spill;
+
+    using IRMutator::visit;
+
+    Stmt visit(const Allocate *op) override {
+        Stmt s = IRMutator::visit(op);
+        if (spill.count(op->name)) {
+            op = s.as<Allocate>();
+            internal_assert(op);
+            return Allocate::make(op->name, op->type, MemoryType::Auto,
+                                  op->extents, op->condition, op->body,
+                                  op->new_expr, op->free_function);
+        }
+        return s;
+    }
+
+public:
+    SpillVtcmAllocations(const set<string> &spill)
+        : spill(spill) {
+    }
+};
+
+Stmt plan_vtcm_budget(Stmt s) {
+    int64_t budget = 256 * 1024;
+    string budget_str = get_env_variable("HL_VTCM_BUDGET");
+    if (!budget_str.empty()) {
+        budget = std::atoll(budget_str.c_str());
+    }
+
+    FindVtcmAllocations finder;
+    s.accept(&finder);
+
+    // We can't budget for allocations of unknown size; leave those in
+    // VTCM and let the runtime report failure for them as before.
+    vector<FindVtcmAllocations::VtcmAllocation> candidates;
+    for (const auto &a : finder.allocations) {
+        if (a.constant_size) {
+            candidates.push_back(a);
+        }
+    }
+
+    // Hand the budget out hottest-first, by estimated accesses per
+    // byte. This is conservative in that it assumes all the
+    // allocations are live at once.
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [](const FindVtcmAllocations::VtcmAllocation &a,
+                        const FindVtcmAllocations::VtcmAllocation &b) {
+                         return a.accesses * (double)b.size > b.accesses * (double)a.size;
+                     });
+
+    set<string> spill;
+    int64_t remaining = budget;
+    for (const auto &a : candidates) {
+        if (a.size <= remaining) {
+            remaining -= a.size;
+        } else {
+            debug(1) << "Spilling " << a.name << " (" << a.size
+                     << " bytes) from VTCM to DDR to stay within the VTCM budget of "
+                     << budget << " bytes\n";
+            spill.insert(a.name);
+        }
+    }
+
+    if (spill.empty()) {
+        return s;
+    }
+    return SpillVtcmAllocations(spill).mutate(s);
+}
+
 Stmt optimize_hexagon_instructions(Stmt s, const Target &t) {
     // We need to redo intrinsic matching due to simplification that has
     // happened after the end of target independent lowering.
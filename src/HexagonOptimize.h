@@ -24,6 +24,15 @@ Stmt optimize_hexagon_shuffles(const Stmt &s, int lut_alignment);
  *     2. out(idx(x)) = foo(x) -> vscatter */
 Stmt scatter_gather_generator(Stmt s);
 
+/** Rank the VTCM-scheduled allocations in a function against a fixed
+ * VTCM budget (256KB by default, overridable in bytes via the
+ * HL_VTCM_BUDGET environment variable), and spill the least
+ * frequently accessed ones to DDR when the budget is exceeded, rather
+ * than failing at runtime. Must run before scatter_gather_generator,
+ * so that gathers are only generated against buffers that stayed in
+ * VTCM. */
+Stmt plan_vtcm_budget(Stmt s);
+
 /** Hexagon deinterleaves when performing widening operations, and
  * interleaves when performing narrowing operations. This pass
  * rewrites widenings/narrowings to be explicit in the IR, and
@@ -3,12 +3,90 @@
 #include "IRMutator.h"
 #include "IRPrinter.h"
 #include "IRVisitor.h"
+#include "Util.h"
 #include <numeric>
 #include <utility>
 
 namespace Halide {
 namespace Internal {
 
+namespace {
+
+// With HL_IR_NODE_POOL set, IR nodes are carved out of large slabs
+// and recycled through per-thread free lists binned by size class,
+// so the steady-state cost of IRNode::operator new/delete is pushing
+// and popping a singly-linked list instead of a trip through the
+// system allocator. Exprs routinely outlive both lower() and the
+// thread that made them (the lowered Module holds them, and
+// HL_PARALLEL_LOWERING builds them on pool workers), so there is no
+// point at which a slab is provably dead; slabs are retained for the
+// life of the process and compile memory plateaus at its high-water
+// mark. That's the price of the mode, and why it's opt-in.
+constexpr size_t ir_pool_granularity = 16;
+constexpr size_t ir_pool_max_size = 256;
+constexpr size_t ir_pool_size_classes = ir_pool_max_size / ir_pool_granularity;
+constexpr size_t ir_pool_slab_size = 1 << 16;
+
+struct FreeIRNode {
+    FreeIRNode *next;
+};
+
+struct IRNodePool {
+    FreeIRNode *free_list[ir_pool_size_classes] = {};
+    char *slab_cursor = nullptr;
+    size_t slab_remaining = 0;
+
+    void *allocate(size_t size) {
+        size_t size_class = (size - 1) / ir_pool_granularity;
+        if (FreeIRNode *node = free_list[size_class]) {
+            free_list[size_class] = node->next;
+            return node;
+        }
+        size_t bytes = (size_class + 1) * ir_pool_granularity;
+        if (slab_remaining < bytes) {
+            // Deliberately never freed; any thread's free list may
+            // hand this memory to any other thread later.
+            slab_cursor = (char *)::operator new(ir_pool_slab_size);
+            slab_remaining = ir_pool_slab_size;
+        }
+        void *result = slab_cursor;
+        slab_cursor += bytes;
+        slab_remaining -= bytes;
+        return result;
+    }
+
+    void release(void *ptr, size_t size) {
+        size_t size_class = (size - 1) / ir_pool_granularity;
+        FreeIRNode *node = (FreeIRNode *)ptr;
+        node->next = free_list[size_class];
+        free_list[size_class] = node;
+    }
+};
+
+thread_local IRNodePool ir_node_pool;
+
+bool use_ir_node_pool() {
+    static const bool use = !get_env_variable("HL_IR_NODE_POOL").empty();
+    return use;
+}
+
+}  // namespace
+
+void *IRNode::operator new(size_t size) {
+    if (size <= ir_pool_max_size && use_ir_node_pool()) {
+        return ir_node_pool.allocate(size);
+    }
+    return ::operator new(size);
+}
+
+void IRNode::operator delete(void *ptr, size_t size) {
+    if (size <= ir_pool_max_size && use_ir_node_pool()) {
+        ir_node_pool.release(ptr, size);
+        return;
+    }
+    ::operator delete(ptr);
+}
+
 Expr Cast::make(Type t, Expr v) {
     internal_assert(v.defined()) << "Cast of undefined\n";
     internal_assert(t.lanes() == v.type().lanes()) << "Cast may not change vector widths\n";
@@ -590,6 +668,7 @@ const char *const intrinsic_op_names[] = {
     "bundle",
     "call_cached_indirect_function",
     "cast_mask",
+    "copy_memory",
     "count_leading_zeros",
     "count_trailing_zeros",
     "declare_box_touched",
@@ -597,6 +676,7 @@ const char *const intrinsic_op_names[] = {
     "div_round_to_zero",
     "dynamic_shuffle",
     "extract_mask_element",
+    "gpu_named_barrier",
     "gpu_thread_barrier",
     "halving_add",
     "halving_sub",
@@ -639,6 +719,8 @@ const char *const intrinsic_op_names[] = {
     "signed_integer_overflow",
     "size_of_halide_buffer_t",
     "sorted_avg",
+    "streaming_fence",
+    "streaming_store",
     "strict_float",
     "stringify",
     "undef",
@@ -670,8 +752,8 @@ Expr Call::make(Type type, const std::string &name, const std::vector<Expr> &arg
                 FunctionPtr func, int value_index,
                 Buffer<> image, Parameter param) {
     if (name == intrinsic_op_names[Call::prefetch] && call_type == Call::Intrinsic) {
-        internal_assert(args.size() % 2 == 0)
-            << "Number of args to a prefetch call should be even: {base, offset, extent0, stride0, extent1, stride1, ...}\n";
+        internal_assert(args.size() >= 4 && args.size() % 2 == 0)
+            << "Number of args to a prefetch call should be even and at least 4: {base, offset, rw, locality, extent0, stride0, extent1, stride1, ...}\n";
     }
     for (size_t i = 0; i < args.size(); i++) {
         internal_assert(args[i].defined()) << "Call of " << name << " with argument " << i << " undefined.\n";
@@ -502,6 +502,7 @@ struct Call : public ExprNode<Call> {
         bundle,  // Bundle multiple exprs together temporarily for analysis (e.g. CSE)
         call_cached_indirect_function,
         cast_mask,
+        copy_memory,
         count_leading_zeros,
         count_trailing_zeros,
         declare_box_touched,
@@ -509,6 +510,7 @@ struct Call : public ExprNode<Call> {
         div_round_to_zero,
         dynamic_shuffle,
         extract_mask_element,
+        gpu_named_barrier,
         gpu_thread_barrier,
         halving_add,
         halving_sub,
@@ -551,6 +553,8 @@ struct Call : public ExprNode<Call> {
         signed_integer_overflow,
         size_of_halide_buffer_t,
         sorted_avg,  // Compute (arg[0] + arg[1]) / 2, assuming arg[0] < arg[1].
+        streaming_fence,
+        streaming_store,
         strict_float,
         stringify,
         undef,
@@ -13,6 +13,18 @@ Stmt IRMutator::mutate(const Stmt &s) {
     return s.defined() ? s.get()->mutate_stmt(this) : Stmt();
 }
 
+namespace {
+// Claim a uniquely-referenced stmt node for in-place rewriting. Its
+// content is about to change, so any already-simplified stamp it
+// carries no longer holds.
+template<typename T>
+T *reuse_node(const T *op) {
+    T *mut = const_cast<T *>(op);
+    mut->simplify_stamp = 0;
+    return mut;
+}
+}  // namespace
+
 Expr IRMutator::visit(const IntImm *op) {
     return op;
 }
@@ -183,6 +195,12 @@ Stmt IRMutator::visit(const LetStmt *op) {
         body.same_as(op->body)) {
         return op;
     }
+    if (can_reuse(op)) {
+        LetStmt *mut = reuse_node(op);
+        mut->value = std::move(value);
+        mut->body = std::move(body);
+        return op;
+    }
     return LetStmt::make(op->name, std::move(value), std::move(body));
 }
 
@@ -201,6 +219,10 @@ Stmt IRMutator::visit(const ProducerConsumer *op) {
     if (body.same_as(op->body)) {
         return op;
     }
+    if (can_reuse(op)) {
+        reuse_node(op)->body = std::move(body);
+        return op;
+    }
     return ProducerConsumer::make(op->name, op->is_producer, std::move(body));
 }
 
@@ -213,6 +235,13 @@ Stmt IRMutator::visit(const For *op) {
         body.same_as(op->body)) {
         return op;
     }
+    if (can_reuse(op)) {
+        For *mut = reuse_node(op);
+        mut->min = std::move(min);
+        mut->extent = std::move(extent);
+        mut->body = std::move(body);
+        return op;
+    }
     return For::make(op->name, std::move(min), std::move(extent),
                      op->for_type, op->device_api, std::move(body));
 }
@@ -276,6 +305,14 @@ Stmt IRMutator::visit(const Allocate *op) {
         new_expr.same_as(op->new_expr)) {
         return op;
     }
+    if (can_reuse(op)) {
+        Allocate *mut = reuse_node(op);
+        mut->extents = std::move(new_extents);
+        mut->condition = std::move(condition);
+        mut->body = std::move(body);
+        mut->new_expr = std::move(new_expr);
+        return op;
+    }
     return Allocate::make(op->name, op->type, op->memory_type,
                           new_extents, std::move(condition),
                           std::move(body), std::move(new_expr), op->free_function);
@@ -299,6 +336,13 @@ Stmt IRMutator::visit(const Realize *op) {
         condition.same_as(op->condition)) {
         return op;
     }
+    if (can_reuse(op)) {
+        Realize *mut = reuse_node(op);
+        mut->bounds = std::move(new_bounds);
+        mut->condition = std::move(condition);
+        mut->body = std::move(body);
+        return op;
+    }
     return Realize::make(op->name, op->types, op->memory_type, new_bounds,
                          std::move(condition), std::move(body));
 }
@@ -329,6 +373,12 @@ Stmt IRMutator::visit(const Block *op) {
         rest.same_as(op->rest)) {
         return op;
     }
+    if (can_reuse(op)) {
+        Block *mut = reuse_node(op);
+        mut->first = std::move(first);
+        mut->rest = std::move(rest);
+        return op;
+    }
     return Block::make(std::move(first), std::move(rest));
 }
 
@@ -341,6 +391,13 @@ Stmt IRMutator::visit(const IfThenElse *op) {
         else_case.same_as(op->else_case)) {
         return op;
     }
+    if (can_reuse(op)) {
+        IfThenElse *mut = reuse_node(op);
+        mut->condition = std::move(condition);
+        mut->then_case = std::move(then_case);
+        mut->else_case = std::move(else_case);
+        return op;
+    }
     return IfThenElse::make(std::move(condition), std::move(then_case), std::move(else_case));
 }
 
@@ -385,6 +442,11 @@ Stmt IRMutator::visit(const Fork *op) {
     if (first.same_as(op->first) &&
         rest.same_as(op->rest)) {
         return op;
+    } else if (can_reuse(op)) {
+        Fork *mut = reuse_node(op);
+        mut->first = std::move(first);
+        mut->rest = std::move(rest);
+        return op;
     } else {
         return Fork::make(first, rest);
     }
@@ -398,6 +460,12 @@ Stmt IRMutator::visit(const Acquire *op) {
         body.same_as(op->body) &&
         count.same_as(op->count)) {
         return op;
+    } else if (can_reuse(op)) {
+        Acquire *mut = reuse_node(op);
+        mut->semaphore = std::move(sema);
+        mut->count = std::move(count);
+        mut->body = std::move(body);
+        return op;
     } else {
         return Acquire::make(std::move(sema), std::move(count), std::move(body));
     }
@@ -407,6 +475,9 @@ Stmt IRMutator::visit(const Atomic *op) {
     Stmt body = mutate(op->body);
     if (body.same_as(op->body)) {
         return op;
+    } else if (can_reuse(op)) {
+        reuse_node(op)->body = std::move(body);
+        return op;
     } else {
         return Atomic::make(op->producer_name,
                             op->mutex_name,
@@ -36,6 +36,28 @@ public:
     virtual Stmt mutate(const Stmt &stmt);
 
 protected:
+    /** Whether the default visit methods may rewrite a
+     * uniquely-referenced Stmt node in place instead of allocating a
+     * replacement and copying the unchanged fields. This keeps a pass
+     * from duplicating the entire spine of Blocks, LetStmts and loops
+     * above every leaf it changes, which dominates peak compiler
+     * memory when lowering very large pipelines. Off by default;
+     * opt in from a subclass constructor only after checking that
+     * neither the pass nor its callers hold raw pointers into the
+     * tree or use pointer identity of the result to detect whether
+     * anything changed (an in-place rewrite returns the node it was
+     * given). Anything that holds a subtree through an Expr or Stmt
+     * handle protects itself automatically, because the extra
+     * reference makes the node ineligible for reuse. */
+    bool mutate_in_place_when_unique = false;
+
+    /** Whether an in-place rewrite of the given node is permitted:
+     * the subclass opted in above and nothing else holds a reference
+     * to the node. */
+    bool can_reuse(const IRNode *op) const {
+        return mutate_in_place_when_unique && op->ref_count.is_one();
+    }
+
     // ExprNode<> and StmtNode<> are allowed to call visit (to implement mutate_expr/mutate_stmt())
     template<typename T>
     friend struct ExprNode;
@@ -1144,7 +1144,7 @@ Expr rounding_halving_sub(Expr a, Expr b) {
 
 }  // namespace Internal
 
-Expr fast_log(const Expr &x) {
+Expr fast_log(const Expr &x, ApproximationPrecision precision) {
     user_assert(x.type() == Float(32)) << "fast_log only works for Float(32)";
 
     Expr reduced, exponent;
@@ -1152,17 +1152,42 @@ Expr fast_log(const Expr &x) {
 
     Expr x1 = reduced - 1.0f;
 
-    float coeff[] = {
-        0.07640318789187280912f,
-        -0.16252961013874300811f,
-        0.20625219040645212387f,
-        -0.25110261010892864775f,
-        0.33320464908377461777f,
-        -0.49997513376789826101f,
-        1.0f,
-        0.0f};
-
-    Expr result = evaluate_polynomial(x1, coeff, sizeof(coeff) / sizeof(coeff[0]));
+    // Minimax polynomials of increasing degree. The worst-case
+    // absolute error of each, measured against double-precision log
+    // over [e^-5, e^5], is noted in units of 2^-24.
+    Expr result;
+    if (precision.max_ulp_error >= 8500) {
+        // Max error 8460 ulps.
+        float coeff[] = {
+            -0.20769642082334458f,
+            0.34624550831730017f,
+            -0.50135446943532125f,
+            1.0f,
+            0.0f};
+        result = evaluate_polynomial(x1, coeff, sizeof(coeff) / sizeof(coeff[0]));
+    } else if (precision.max_ulp_error >= 1250) {
+        // Max error 1218 ulps.
+        float coeff[] = {
+            0.15302586937122012f,
+            -0.26096392739183116f,
+            0.33624674696451973f,
+            -0.49986055673878177f,
+            1.0f,
+            0.0f};
+        result = evaluate_polynomial(x1, coeff, sizeof(coeff) / sizeof(coeff[0]));
+    } else {
+        // Max error 16 ulps.
+        float coeff[] = {
+            0.07640318789187280912f,
+            -0.16252961013874300811f,
+            0.20625219040645212387f,
+            -0.25110261010892864775f,
+            0.33320464908377461777f,
+            -0.49997513376789826101f,
+            1.0f,
+            0.0f};
+        result = evaluate_polynomial(x1, coeff, sizeof(coeff) / sizeof(coeff[0]));
+    }
     result = result + cast<float>(exponent) * logf(2);
     result = common_subexpression_elimination(result);
     return result;
@@ -1172,7 +1197,7 @@ namespace {
 
 // A vectorizable sine and cosine implementation. Based on syrah fast vector math
 // https://github.com/boulos/syrah/blob/master/src/include/syrah/FixedVectorMath.h#L55
-Expr fast_sin_cos(const Expr &x_full, bool is_sin) {
+Expr fast_sin_cos(const Expr &x_full, bool is_sin, ApproximationPrecision precision) {
     const float two_over_pi = 0.636619746685028076171875f;
     const float pi_over_two = 1.57079637050628662109375f;
     Expr scaled = x_full * two_over_pi;
@@ -1185,41 +1210,78 @@ Expr fast_sin_cos(const Expr &x_full, bool is_sin) {
     // Reduce the angle modulo pi/2.
     Expr x = x_full - k_real * pi_over_two;
 
-    const float sin_c2 = -0.16666667163372039794921875f;
-    const float sin_c4 = 8.333347737789154052734375e-3;
-    const float sin_c6 = -1.9842604524455964565277099609375e-4;
-    const float sin_c8 = 2.760012648650445044040679931640625e-6;
-    const float sin_c10 = -2.50293279435709337121807038784027099609375e-8;
-
-    const float cos_c2 = -0.5f;
-    const float cos_c4 = 4.166664183139801025390625e-2;
-    const float cos_c6 = -1.388833043165504932403564453125e-3;
-    const float cos_c8 = 2.47562347794882953166961669921875e-5;
-    const float cos_c10 = -2.59630184018533327616751194000244140625e-7;
+    // Coefficients on x^2, x^4, ... of polynomials of increasing
+    // length. The shorter ones are refits, not truncations. The
+    // worst-case absolute error of each, measured against
+    // double-precision sin/cos, is noted in units of 2^-24.
+    static const float sin_terms5[] = {
+        -0.16666667163372039794921875f,
+        8.333347737789154052734375e-3f,
+        -1.9842604524455964565277099609375e-4f,
+        2.760012648650445044040679931640625e-6f,
+        -2.50293279435709337121807038784027099609375e-8f};
+    static const float cos_terms5[] = {
+        -0.5f,
+        4.166664183139801025390625e-2f,
+        -1.388833043165504932403564453125e-3f,
+        2.47562347794882953166961669921875e-5f,
+        -2.59630184018533327616751194000244140625e-7f};
+    static const float sin_terms4[] = {
+        -0.16666665969478994f,
+        0.0083332425430316919f,
+        -0.00019822783465295868f,
+        2.6348750778267851e-06f};
+    static const float cos_terms4[] = {
+        -0.49999992384670433f,
+        0.041665674381789329f,
+        -0.0013868667196838857f,
+        2.3477611105491245e-05f};
+    static const float sin_terms3[] = {
+        -0.16666542977088525f,
+        0.0083242419101494623f,
+        -0.00018848505653968294f};
+    static const float cos_terms3[] = {
+        -0.49998897877053966f,
+        0.041585521157198234f,
+        -0.0013000737558040395f};
+
+    // Max error 16 ulps.
+    const float *sin_terms = sin_terms5;
+    const float *cos_terms = cos_terms5;
+    int terms = 5;
+    if (precision.max_ulp_error >= 500) {
+        // Max error 469 ulps.
+        sin_terms = sin_terms3;
+        cos_terms = cos_terms3;
+        terms = 3;
+    } else if (precision.max_ulp_error >= 16) {
+        // Max error 16 ulps.
+        sin_terms = sin_terms4;
+        cos_terms = cos_terms4;
+        terms = 4;
+    }
 
     Expr outside = select(sin_usecos, 1, x);
-    Expr c2 = select(sin_usecos, cos_c2, sin_c2);
-    Expr c4 = select(sin_usecos, cos_c4, sin_c4);
-    Expr c6 = select(sin_usecos, cos_c6, sin_c6);
-    Expr c8 = select(sin_usecos, cos_c8, sin_c8);
-    Expr c10 = select(sin_usecos, cos_c10, sin_c10);
-
     Expr x2 = x * x;
-    Expr tri_func = outside * (x2 * (x2 * (x2 * (x2 * (x2 * c10 + c8) + c6) + c4) + c2) + 1);
+    Expr poly = select(sin_usecos, cos_terms[terms - 1], sin_terms[terms - 1]);
+    for (int i = terms - 2; i >= 0; i--) {
+        poly = x2 * poly + select(sin_usecos, cos_terms[i], sin_terms[i]);
+    }
+    Expr tri_func = outside * (x2 * poly + 1);
     return select(flip_sign, -tri_func, tri_func);
 }
 
 }  // namespace
 
-Expr fast_sin(const Expr &x_full) {
-    return fast_sin_cos(x_full, true);
+Expr fast_sin(const Expr &x_full, ApproximationPrecision precision) {
+    return fast_sin_cos(x_full, true, precision);
 }
 
-Expr fast_cos(const Expr &x_full) {
-    return fast_sin_cos(x_full, false);
+Expr fast_cos(const Expr &x_full, ApproximationPrecision precision) {
+    return fast_sin_cos(x_full, false, precision);
 }
 
-Expr fast_exp(const Expr &x_full) {
+Expr fast_exp(const Expr &x_full, ApproximationPrecision precision) {
     user_assert(x_full.type() == Float(32)) << "fast_exp only works for Float(32)";
 
     Expr scaled = x_full / logf(2.0);
@@ -1227,14 +1289,38 @@ Expr fast_exp(const Expr &x_full) {
     Expr k = cast<int>(k_real);
     Expr x = x_full - k_real * logf(2.0);
 
-    float coeff[] = {
-        0.01314350012789660196f,
-        0.03668965196652099192f,
-        0.16873890085469545053f,
-        0.49970514590562437052f,
-        1.0f,
-        1.0f};
-    Expr result = evaluate_polynomial(x, coeff, sizeof(coeff) / sizeof(coeff[0]));
+    // Minimax polynomials of increasing degree. The worst-case
+    // relative error of each, measured against double-precision exp
+    // over [-20, 20], is noted in units of 2^-24.
+    Expr result;
+    if (precision.max_ulp_error >= 13000) {
+        // Max error 12532 ulps.
+        float coeff[] = {
+            0.20006051868519431f,
+            0.49689703696039017f,
+            1.0f,
+            1.0f};
+        result = evaluate_polynomial(x, coeff, sizeof(coeff) / sizeof(coeff[0]));
+    } else if (precision.max_ulp_error >= 500) {
+        // Max error 461 ulps.
+        float coeff[] = {
+            0.051688923363663562f,
+            0.16391876561275215f,
+            0.50011005555739485f,
+            1.0f,
+            1.0f};
+        result = evaluate_polynomial(x, coeff, sizeof(coeff) / sizeof(coeff[0]));
+    } else {
+        // Max error 45 ulps.
+        float coeff[] = {
+            0.01314350012789660196f,
+            0.03668965196652099192f,
+            0.16873890085469545053f,
+            0.49970514590562437052f,
+            1.0f,
+            1.0f};
+        result = evaluate_polynomial(x, coeff, sizeof(coeff) / sizeof(coeff[0]));
+    }
 
     // Compute 2^k.
     int fpbias = 127;
@@ -1248,6 +1334,56 @@ Expr fast_exp(const Expr &x_full) {
     return result;
 }
 
+Expr fast_tanh(const Expr &x, ApproximationPrecision precision) {
+    user_assert(x.type() == Float(32)) << "fast_tanh only works for Float(32)";
+
+    // tanh(x) = sign(x) * (1 - 2 / (e^(2|x|) + 1)). tanh saturates to
+    // within half a float ulp of +/-1 by |x| = 9, so clamp the
+    // argument there to keep the exp finite.
+    Expr abs_x = min(abs(x), 9.0f);
+    Expr e = fast_exp(2.0f * abs_x, precision);
+    Expr t = 1.0f - 2.0f / (e + 1.0f);
+    Expr result = select(x < 0, -t, t);
+    result = common_subexpression_elimination(result);
+    return result;
+}
+
+Expr fast_erf(const Expr &x, ApproximationPrecision precision) {
+    user_assert(x.type() == Float(32)) << "fast_erf only works for Float(32)";
+
+    // Rational approximations 7.1.25 and 7.1.26 from Abramowitz &
+    // Stegun. The worst-case absolute error of each, measured against
+    // double-precision erf over [-4, 4] and including the error of
+    // the underlying fast_exp, is noted in units of 2^-24.
+    Expr abs_x = abs(x);
+    Expr e = fast_exp(-abs_x * abs_x, precision);
+    Expr r;
+    if (precision.max_ulp_error >= 750) {
+        // Max error 728 ulps.
+        Expr t = 1.0f / (abs_x * 0.47047f + 1.0f);
+        float coeff[] = {
+            0.7478556f,
+            -0.0958798f,
+            0.3480242f,
+            0.0f};
+        r = 1.0f - evaluate_polynomial(t, coeff, sizeof(coeff) / sizeof(coeff[0])) * e;
+    } else {
+        // Max error 23 ulps.
+        Expr t = 1.0f / (abs_x * 0.3275911f + 1.0f);
+        float coeff[] = {
+            1.061405429f,
+            -1.453152027f,
+            1.421413741f,
+            -0.284496736f,
+            0.254829592f,
+            0.0f};
+        r = 1.0f - evaluate_polynomial(t, coeff, sizeof(coeff) / sizeof(coeff[0])) * e;
+    }
+    Expr result = select(x < 0, -r, r);
+    result = common_subexpression_elimination(result);
+    return result;
+}
+
 Expr print(const std::vector<Expr> &args) {
     Expr combined_string = combine_strings(args);
 
@@ -2051,14 +2187,14 @@ Expr erf(const Expr &x) {
     return Internal::halide_erf(x);
 }
 
-Expr fast_pow(Expr x, Expr y) {
+Expr fast_pow(Expr x, Expr y, ApproximationPrecision precision) {
     if (const int64_t *i = as_const_int(y)) {
         return raise_to_integer_power(std::move(x), *i);
     }
 
     x = cast<float>(std::move(x));
     y = cast<float>(std::move(y));
-    return select(x == 0.0f, 0.0f, fast_exp(fast_log(x) * std::move(y)));
+    return select(x == 0.0f, 0.0f, fast_exp(fast_log(x, precision) * std::move(y), precision));
 }
 
 Expr fast_inverse(Expr x) {
@@ -2380,6 +2516,30 @@ Expr count_trailing_zeros(Expr x) {
                                 {std::move(x)}, Internal::Call::PureIntrinsic);
 }
 
+Expr extract_low_nibble(Expr packed) {
+    user_assert(packed.defined()) << "extract_low_nibble of undefined Expr\n";
+    Type t = packed.type();
+    user_assert((t.is_uint() || t.is_int()) && t.bits() == 8)
+        << "Argument to extract_low_nibble must be an 8-bit integer\n";
+    if (t.is_int()) {
+        // Shift up then arithmetic-shift back down to sign-extend the
+        // low 4 bits.
+        return (std::move(packed) << Internal::make_const(t, 4)) >> Internal::make_const(t, 4);
+    } else {
+        return std::move(packed) & Internal::make_const(t, 0x0f);
+    }
+}
+
+Expr extract_high_nibble(Expr packed) {
+    user_assert(packed.defined()) << "extract_high_nibble of undefined Expr\n";
+    Type t = packed.type();
+    user_assert((t.is_uint() || t.is_int()) && t.bits() == 8)
+        << "Argument to extract_high_nibble must be an 8-bit integer\n";
+    // An arithmetic shift sign-extends for signed types; a logical
+    // shift zero-extends for unsigned ones.
+    return std::move(packed) >> Internal::make_const(t, 4);
+}
+
 Expr div_round_to_zero(Expr x, Expr y) {
     user_assert(x.defined()) << "div_round_to_zero of undefined dividend\n";
     user_assert(y.defined()) << "div_round_to_zero of undefined divisor\n";
@@ -945,29 +945,63 @@ Expr pow(Expr x, Expr y);
  * mantissa. Vectorizes cleanly. */
 Expr erf(const Expr &x);
 
+/** An error tolerance for the fast transcendental approximations
+ * below. Each of those functions has several polynomial
+ * approximations of increasing degree to choose from; the cheapest
+ * one whose measured worst-case error is within the requested
+ * tolerance is used. The tolerance is expressed in units in the last
+ * place (ulps) of a float of magnitude one, i.e. multiples of 2^-24:
+ * for fast_exp and fast_pow it bounds the relative error of the
+ * result, and for the other functions (whose results have magnitude
+ * at most a few) it bounds the absolute error. The default of zero
+ * asks for the most accurate approximation available, which matches
+ * the historical behavior of these functions. Tolerances looser than
+ * the least accurate approximation just select that approximation. */
+struct ApproximationPrecision {
+    int max_ulp_error = 0;
+};
+
 /** Fast vectorizable approximation to some trigonometric functions for Float(32).
- * Absolute approximation error is less than 1e-5. */
+ * With the default precision the absolute approximation error is less
+ * than 1e-5; a tolerance of 500 ulps or more selects a cheaper,
+ * shorter polynomial. */
 // @{
-Expr fast_sin(const Expr &x);
-Expr fast_cos(const Expr &x);
+Expr fast_sin(const Expr &x, ApproximationPrecision precision = {});
+Expr fast_cos(const Expr &x, ApproximationPrecision precision = {});
 // @}
 
 /** Fast approximate cleanly vectorizable log for Float(32). Returns
- * nonsense for x <= 0.0f. Accurate up to the last 5 bits of the
- * mantissa. Vectorizes cleanly. */
-Expr fast_log(const Expr &x);
+ * nonsense for x <= 0.0f. With the default precision, accurate up to
+ * the last 5 bits of the mantissa; looser tolerances select shorter
+ * polynomials. Vectorizes cleanly. */
+Expr fast_log(const Expr &x, ApproximationPrecision precision = {});
 
 /** Fast approximate cleanly vectorizable exp for Float(32). Returns
- * nonsense for inputs that would overflow or underflow. Typically
- * accurate up to the last 5 bits of the mantissa. Gets worse when
- * approaching overflow. Vectorizes cleanly. */
-Expr fast_exp(const Expr &x);
+ * nonsense for inputs that would overflow or underflow. With the
+ * default precision, typically accurate up to the last 5 bits of the
+ * mantissa; looser tolerances select shorter polynomials. Gets worse
+ * when approaching overflow. Vectorizes cleanly. */
+Expr fast_exp(const Expr &x, ApproximationPrecision precision = {});
 
 /** Fast approximate cleanly vectorizable pow for Float(32). Returns
  * nonsense for x < 0.0f. Accurate up to the last 5 bits of the
  * mantissa for typical exponents. Gets worse when approaching
- * overflow. Vectorizes cleanly. */
-Expr fast_pow(Expr x, Expr y);
+ * overflow. The tolerance is forwarded to the underlying fast_log and
+ * fast_exp. Vectorizes cleanly. */
+Expr fast_pow(Expr x, Expr y, ApproximationPrecision precision = {});
+
+/** Fast approximate cleanly vectorizable tanh for Float(32), computed
+ * from fast_exp. With the default precision the absolute error is at
+ * most a few times 1e-6; looser tolerances select a shorter
+ * polynomial for the underlying exp. Vectorizes cleanly. */
+Expr fast_tanh(const Expr &x, ApproximationPrecision precision = {});
+
+/** Fast approximate cleanly vectorizable erf for Float(32), using the
+ * rational approximations of Abramowitz & Stegun. With the default
+ * precision the absolute error is less than 1.5e-6; a tolerance of
+ * 750 ulps or more selects a shorter approximation. Vectorizes
+ * cleanly. */
+Expr fast_erf(const Expr &x, ApproximationPrecision precision = {});
 
 /** Fast approximate inverse for Float(32). Corresponds to the rcpps
  * instruction on x86, and the vrecpe instruction on ARM. Vectorizes
@@ -1184,6 +1218,25 @@ Expr count_leading_zeros(Expr x);
  * zero, the result is the number of bits in the type. */
 Expr count_trailing_zeros(Expr x);
 
+/** Treat an 8-bit integer as two packed 4-bit values and extract the
+ * low or high one, widened to the full 8 bits. For unsigned types the
+ * 4-bit value is zero-extended; for signed types it is sign-extended,
+ * so an int8 of packed int4 values round-trips correctly. These lower
+ * to shift-and-mask idioms that vectorize well on every backend,
+ * which makes them suitable for streaming quantized 4-bit weights
+ * packed two-to-a-byte without a separate unpacking stage:
+ *
+ \code
+ weight(x) = select((x % 2) == 0,
+                    extract_low_nibble(packed(x / 2)),
+                    extract_high_nibble(packed(x / 2)));
+ \endcode
+ */
+// @{
+Expr extract_low_nibble(Expr packed);
+Expr extract_high_nibble(Expr packed);
+// @}
+
 /** Divide two integers, rounding towards zero. This is the typical
  * behavior of most hardware architectures, which differs from
  * Halide's division operator, which is Euclidean (rounds towards
@@ -7,6 +7,7 @@
 #include "IROperator.h"
 #include "IRPrinter.h"
 #include "Substitute.h"
+#include "Util.h"
 
 #include <map>
 #include <utility>
@@ -809,6 +810,130 @@ public:
     }
 };
 
+// Optionally move the injected halide_copy_to_device calls earlier
+// within their enclosing Block, so host-to-device transfers are
+// issued as soon as their source data is ready instead of immediately
+// before the consuming kernel. When the runtime's copy path is
+// asynchronous with respect to the device (e.g. pinned host memory on
+// a non-default stream, where the consuming kernel orders after the
+// copy on the same stream), this overlaps the transfer with whatever
+// CPU stages sit between the producer and the kernel. A copy is only
+// hoisted past statements that make no reference to the buffer being
+// copied, so the data transferred (and the existence of the host
+// allocation) is unchanged; the only observable difference is that a
+// failing copy reports its error before, rather than after, the
+// unrelated work it was hoisted past.
+class HoistCopiesToDevice : public IRMutator {
+    using IRMutator::visit;
+
+    // Does this stmt refer to the given buffer at all, on any device?
+    class UsesBuffer : public IRVisitor {
+        using IRVisitor::visit;
+
+        void visit(const Load *op) override {
+            IRVisitor::visit(op);
+            if (op->name == buffer) {
+                result = true;
+            }
+        }
+
+        void visit(const Store *op) override {
+            IRVisitor::visit(op);
+            if (op->name == buffer) {
+                result = true;
+            }
+        }
+
+        void visit(const Variable *op) override {
+            if (op->name == buffer || op->name == buffer + ".buffer") {
+                result = true;
+            }
+        }
+
+        void visit(const Allocate *op) override {
+            IRVisitor::visit(op);
+            if (op->name == buffer) {
+                result = true;
+            }
+        }
+
+        void visit(const Free *op) override {
+            if (op->name == buffer) {
+                result = true;
+            }
+        }
+
+        string buffer;
+
+    public:
+        bool result = false;
+
+        UsesBuffer(const string &b)
+            : buffer(b) {
+        }
+    };
+
+    // If s is one of the copy-to-device calls injected above, return
+    // the name of the buffer being copied, otherwise the empty string.
+    static string copy_to_device_buffer(const Stmt &s) {
+        const LetStmt *let = s.as<LetStmt>();
+        if (!let) {
+            return "";
+        }
+        const Call *call = let->value.as<Call>();
+        if (!call || call->name != "halide_copy_to_device") {
+            return "";
+        }
+        const Variable *v = call->args[0].as<Variable>();
+        if (!v || !ends_with(v->name, ".buffer")) {
+            return "";
+        }
+        return v->name.substr(0, v->name.size() - 7);
+    }
+
+    Stmt visit(const Block *op) override {
+        // Flatten the serial sequence of stmts in this block.
+        vector<Stmt> stmts;
+        bool changed = false;
+        Stmt rest;
+        for (const Block *b = op; b; b = rest.as<Block>()) {
+            Stmt first = mutate(b->first);
+            changed = changed || !first.same_as(b->first);
+            stmts.push_back(first);
+            rest = b->rest;
+        }
+        {
+            Stmt last = mutate(rest);
+            changed = changed || !last.same_as(rest);
+            stmts.push_back(last);
+        }
+
+        // Bubble each copy backwards past any preceding stmts that
+        // don't mention the buffer it copies.
+        for (size_t i = 1; i < stmts.size(); i++) {
+            string buf = copy_to_device_buffer(stmts[i]);
+            if (buf.empty()) {
+                continue;
+            }
+            for (size_t j = i; j > 0; j--) {
+                UsesBuffer uses(buf);
+                stmts[j - 1].accept(&uses);
+                if (uses.result) {
+                    break;
+                }
+                std::swap(stmts[j], stmts[j - 1]);
+                changed = true;
+            }
+        }
+
+        if (changed) {
+            return Block::make(stmts);
+        } else {
+            return op;
+        }
+    }
+};
+
 }  // namespace
 
 Stmt inject_host_dev_buffer_copies(Stmt s, const Target &t) {
@@ -834,6 +959,12 @@ Stmt inject_host_dev_buffer_copies(Stmt s, const Target &t) {
         s = InjectBufferCopiesForInputsAndOutputs(outermost.result).mutate(s);
     }
 
+    // Optionally issue copies to device as early as data dependencies
+    // allow, instead of immediately before the consuming kernel.
+    if (!get_env_variable("HL_HOIST_DEVICE_COPIES").empty()) {
+        s = HoistCopiesToDevice().mutate(s);
+    }
+
     return s;
 }
 
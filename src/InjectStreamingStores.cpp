@@ -0,0 +1,130 @@
+#include "InjectStreamingStores.h"
+#include "Debug.h"
+#include "Function.h"
+#include "IRMutator.h"
+#include "IROperator.h"
+#include "IRVisitor.h"
+#include "Util.h"
+
+#include <set>
+
+namespace Halide {
+namespace Internal {
+
+namespace {
+
+bool buffer_of_func(const std::string &buffer, const std::string &func) {
+    // Tuple-valued Funcs store to "f.0", "f.1", ...
+    return buffer == func || starts_with(buffer, func + ".");
+}
+
+// Does the production of a Func read back from its own buffer? If so
+// the values are live in cache while producing, and writing around
+// the cache would be both slower and (without a fence per store)
+// unsound.
+class ReadsOwnBuffer : public IRVisitor {
+    using IRVisitor::visit;
+
+    void visit(const Load *op) override {
+        if (buffer_of_func(op->name, func)) {
+            result = true;
+        }
+        IRVisitor::visit(op);
+    }
+
+    const std::string &func;
+
+public:
+    bool result = false;
+    ReadsOwnBuffer(const std::string &func)
+        : func(func) {
+    }
+};
+
+class InjectStreamingStores : public IRMutator {
+    using IRMutator::visit;
+
+    const std::set<std::string> &streaming_funcs;
+
+    // Funcs whose production we are currently inside, and which have
+    // been proven safe to stream.
+    std::set<std::string> active;
+    bool in_device_loop = false;
+    int converted = 0;
+
+    Stmt visit(const For *op) override {
+        if (op->device_api != DeviceAPI::None) {
+            ScopedValue<bool> old(in_device_loop, true);
+            return IRMutator::visit(op);
+        }
+        return IRMutator::visit(op);
+    }
+
+    Stmt visit(const ProducerConsumer *op) override {
+        if (!op->is_producer || !streaming_funcs.count(op->name)) {
+            return IRMutator::visit(op);
+        }
+        ReadsOwnBuffer reads(op->name);
+        op->body.accept(&reads);
+        if (reads.result) {
+            debug(1) << "Not streaming stores to " << op->name
+                     << " because its production reads its own buffer\n";
+            return IRMutator::visit(op);
+        }
+        active.insert(op->name);
+        int before = converted;
+        Stmt result = IRMutator::visit(op);
+        active.erase(op->name);
+        if (converted > before) {
+            // Make sure the streamed values are visible to later
+            // reads, which are not ordered with respect to
+            // non-temporal stores.
+            Expr fence = Call::make(Int(32), Call::streaming_fence, {}, Call::Intrinsic);
+            result = Block::make(result, Evaluate::make(fence));
+        }
+        return result;
+    }
+
+    Stmt visit(const Store *op) override {
+        bool matches = false;
+        for (const std::string &f : active) {
+            matches |= buffer_of_func(op->name, f);
+        }
+        if (!matches ||
+            in_device_loop ||
+            !is_const_one(op->predicate) ||
+            (op->value.type().is_vector() &&
+             !strided_ramp_base(op->index, 1).defined())) {
+            return IRMutator::visit(op);
+        }
+        converted++;
+        Expr store = Call::make(Int(32), Call::streaming_store,
+                                {Variable::make(Handle(), op->name),
+                                 mutate(op->index), mutate(op->value)},
+                                Call::Intrinsic);
+        return Evaluate::make(store);
+    }
+
+public:
+    InjectStreamingStores(const std::set<std::string> &streaming_funcs)
+        : streaming_funcs(streaming_funcs) {
+    }
+};
+
+}  // namespace
+
+Stmt inject_streaming_stores(const Stmt &s, const std::map<std::string, Function> &env) {
+    std::set<std::string> streaming_funcs;
+    for (const auto &it : env) {
+        if (it.second.schedule().store_streaming()) {
+            streaming_funcs.insert(it.first);
+        }
+    }
+    if (streaming_funcs.empty()) {
+        return s;
+    }
+    return InjectStreamingStores(streaming_funcs).mutate(s);
+}
+
+}  // namespace Internal
+}  // namespace Halide
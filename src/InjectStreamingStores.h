@@ -0,0 +1,33 @@
+#ifndef HALIDE_INJECT_STREAMING_STORES_H
+#define HALIDE_INJECT_STREAMING_STORES_H
+
+/** \file
+ * Defines the lowering pass that converts stores to Funcs scheduled
+ * with Func::store_streaming into streaming (non-temporal) stores.
+ */
+
+#include <map>
+#include <string>
+
+#include "Expr.h"
+
+namespace Halide {
+namespace Internal {
+
+class Function;
+
+/** For each Func scheduled with store_streaming, rewrite the dense
+ * unpredicated stores to its buffer as streaming_store intrinsics,
+ * which the backends emit as non-temporal stores, and insert a
+ * streaming_fence after its production so later reads observe the
+ * written values. Funcs whose production re-reads their own buffer
+ * (update definitions, sliding windows) are left alone, as are
+ * predicated or scattering stores and anything inside a device
+ * loop. Runs after vectorization so whole cache lines are written
+ * per store where the schedule allows it. */
+Stmt inject_streaming_stores(const Stmt &s, const std::map<std::string, Function> &env);
+
+}  // namespace Internal
+}  // namespace Halide
+
+#endif
@@ -6,6 +6,7 @@
 #include "IRMutator.h"
 #include "IROperator.h"
 #include "Scope.h"
+#include <algorithm>
 #include <utility>
 
 namespace Halide {
@@ -112,14 +113,59 @@ Expr sum(Expr e, const std::string &name) {
     return sum(RDom(), std::move(e), name);
 }
 
+Expr sum(Expr e, Reduction mode, const std::string &name) {
+    return sum(RDom(), std::move(e), mode, name);
+}
+
 Expr sum(const RDom &r, Expr e, const std::string &name) {
+    return sum(r, std::move(e), Reduction::Serial, name);
+}
+
+Expr sum(const RDom &r, Expr e, Reduction mode, const std::string &name) {
     Internal::FindFreeVars v(r, name);
     e = v.mutate(common_subexpression_elimination(e));
 
     user_assert(v.rdom.defined()) << "Expression passed to sum must reference a reduction domain";
 
+    if (mode == Reduction::Compensated) {
+        user_assert(e.type().is_float())
+            << "Compensated sum is only defined for floating-point expressions, "
+            << "but the expression passed to sum has type " << e.type() << "\n";
+
+        // Kahan summation. The compensation arithmetic is exactly the
+        // sort of thing the simplifier is entitled to fold away under
+        // default float semantics, so wrap each step in strict_float.
+        Func f(name);
+        Expr zero = Internal::make_zero(e.type());
+        f(v.free_vars) = Tuple(zero, zero);
+        Expr s = f(v.free_vars)[0];
+        Expr c = f(v.free_vars)[1];
+        Expr y = strict_float(e - c);
+        Expr t = strict_float(s + y);
+        Expr new_c = strict_float(strict_float(t - s) - y);
+        f(v.free_vars) = Tuple(t, new_c);
+        return f(v.call_args)[0];
+    }
+
     Func f(name);
     f(v.free_vars) += e;
+
+    if (mode == Reduction::Pairwise) {
+        // Break the loop-carried dependence by lifting the innermost
+        // reduction dimension into a fixed number of interleaved
+        // partial sums, then combining them in a fixed order. Enough
+        // lanes to fill a 512-bit accumulator, so the partial sums
+        // vectorize on any current target.
+        const int lanes = std::max(4, 64 / e.type().bytes());
+        RVar rxo, rxi;
+        Var u;
+        Stage update = f.update();
+        update.split(v.rdom.x, rxo, rxi, lanes, TailStrategy::GuardWithIf);
+        Func partial = update.rfactor(rxi, u);
+        partial.vectorize(u);
+        partial.update().vectorize(u);
+    }
+
     return f(v.call_args);
 }
 
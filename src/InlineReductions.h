@@ -34,8 +34,33 @@ namespace Halide {
  * sum is being computed by an anonymous reduction function that is
  * scheduled innermost within g.
  */
+/** The accumulation strategy used by \ref sum. */
+enum class Reduction {
+    /** A single serial accumulator, updated once per reduction domain
+     * point. This is the default, and matches the order of a naive
+     * loop, but the loop-carried dependence limits vectorization and
+     * rounding error grows linearly in the domain size for floats. */
+    Serial,
+
+    /** Split the innermost reduction dimension into a fixed number of
+     * interleaved partial sums, accumulated as a vector and combined
+     * in a fixed order at the end. This both breaks the loop-carried
+     * dependence (so the accumulation vectorizes) and reduces float
+     * rounding error. The split order does not depend on how the
+     * consumer is scheduled, so results are bit-stable across thread
+     * counts. */
+    Pairwise,
+
+    /** Kahan compensated summation: a serial accumulator plus a
+     * running compensation term, combined with strict float
+     * semantics. Slower than Serial, but rounding error stays O(1)
+     * in the domain size. Only defined for floating-point sums. */
+    Compensated,
+};
+
 //@{
 Expr sum(Expr, const std::string &s = "sum");
+Expr sum(Expr, Reduction mode, const std::string &s = "sum");
 Expr saturating_sum(Expr, const std::string &s = "saturating_sum");
 Expr product(Expr, const std::string &s = "product");
 Expr maximum(Expr, const std::string &s = "maximum");
@@ -53,6 +78,7 @@ Expr minimum(Expr, const std::string &s = "minimum");
 */
 // @{
 Expr sum(const RDom &, Expr, const std::string &s = "sum");
+Expr sum(const RDom &, Expr, Reduction mode, const std::string &s = "sum");
 Expr saturating_sum(const RDom &r, Expr e, const std::string &s = "saturating_sum");
 Expr product(const RDom &, Expr, const std::string &s = "product");
 Expr maximum(const RDom &, Expr, const std::string &s = "maximum");
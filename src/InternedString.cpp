@@ -0,0 +1,54 @@
+#include "InternedString.h"
+#include "Error.h"
+
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+namespace Halide {
+namespace Internal {
+
+namespace {
+
+struct StringTable {
+    std::mutex mutex;
+    // The deque gives entries stable addresses; handles point into it.
+    std::deque<InternedString::Entry> entries;
+    std::unordered_map<std::string, const InternedString::Entry *> index;
+
+    const InternedString::Entry *intern(const std::string &s) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = index.find(s);
+        if (it != index.end()) {
+            return it->second;
+        }
+        // Ids start at one so that zero can mean "no string".
+        entries.push_back({s, entries.size() + 1});
+        const InternedString::Entry *e = &entries.back();
+        index.emplace(s, e);
+        return e;
+    }
+};
+
+StringTable &string_table() {
+    static StringTable table;
+    return table;
+}
+
+}  // namespace
+
+InternedString::InternedString(const std::string &s)
+    : entry(string_table().intern(s)) {
+}
+
+InternedString::InternedString(const char *s)
+    : entry(string_table().intern(s)) {
+}
+
+const std::string &InternedString::str() const {
+    internal_assert(entry) << "str() called on an undefined InternedString\n";
+    return entry->str;
+}
+
+}  // namespace Internal
+}  // namespace Halide
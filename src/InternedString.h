@@ -0,0 +1,76 @@
+#ifndef HALIDE_INTERNED_STRING_H
+#define HALIDE_INTERNED_STRING_H
+
+/** \file
+ * Defines InternedString, a cheap-to-compare handle to a string in a
+ * global table.
+ */
+
+#include <cstdint>
+#include <string>
+
+namespace Halide {
+namespace Internal {
+
+/** A handle to a string stored in a process-global table. Each
+ * distinct string is stored once, so equality is a pointer comparison
+ * and ordering compares small integer ids instead of characters. Use
+ * this to key containers that are looked up with variable names many
+ * times (see Scope), where hashing and comparing names like
+ * "f.s0.x.x" repeatedly is measurable. Interning a string costs one
+ * hash plus a lock, so intern once and reuse the handle where
+ * possible. Interned strings are never freed.
+ *
+ * Ordering is by interning order, not lexicographic, so it is
+ * deterministic for a deterministic compilation but, like the
+ * unique_name counters, depends on process history. */
+class InternedString {
+public:
+    /** One slot in the global table. Public only so that the table
+     * implementation can construct it; not for direct use. */
+    struct Entry {
+        std::string str;
+        uint64_t id;
+    };
+
+private:
+    const Entry *entry = nullptr;
+
+public:
+    /** A default-constructed InternedString refers to no string and
+     * may only be assigned to or compared. */
+    InternedString() = default;
+
+    /** Intern a string, adding it to the global table if it has not
+     * been seen before. */
+    InternedString(const std::string &s);
+    InternedString(const char *s);
+
+    /** Get the string this handle refers to. The reference stays
+     * valid for the life of the process. */
+    const std::string &str() const;
+
+    /** Does this handle refer to a string? */
+    bool defined() const {
+        return entry != nullptr;
+    }
+
+    bool operator==(const InternedString &other) const {
+        return entry == other.entry;
+    }
+
+    bool operator!=(const InternedString &other) const {
+        return entry != other.entry;
+    }
+
+    bool operator<(const InternedString &other) const {
+        uint64_t a = entry ? entry->id : 0;
+        uint64_t b = other.entry ? other.entry->id : 0;
+        return a < b;
+    }
+};
+
+}  // namespace Internal
+}  // namespace Halide
+
+#endif
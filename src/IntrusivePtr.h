@@ -32,6 +32,9 @@ public:
     bool is_const_zero() const {
         return count == 0;
     }
+    bool is_one() const {
+        return count == 1;
+    }
 };
 
 /**
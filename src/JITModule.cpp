@@ -1,7 +1,9 @@
+#include <atomic>
 #include <cstdint>
 #include <mutex>
 #include <set>
 #include <string>
+#include <thread>
 
 #ifdef _WIN32
 #ifdef _MSC_VER
@@ -126,6 +128,7 @@ public:
     JITModuleContents() = default;
 
     ~JITModuleContents() {
+        join_tier_thread();
         if (execution_engine != nullptr) {
             execution_engine->runStaticConstructorsDestructors(true);
             delete execution_engine;
@@ -134,12 +137,29 @@ public:
 
     std::map<std::string, JITModule::Symbol> exports;
     llvm::LLVMContext context;
+    // Must outlive the execution engine, which holds a raw pointer to it.
+    std::unique_ptr<llvm::ObjectCache> object_cache;
     ExecutionEngine *execution_engine = nullptr;
     std::vector<JITModule> dependencies;
     JITModule::Symbol entrypoint;
     JITModule::Symbol argv_entrypoint;
 
+    // Tiered compilation state. While tier_thread builds the fully
+    // optimized version of the module, calls are served by the
+    // fast-tier entrypoints above. Once it finishes, optimized_argv
+    // holds the optimized argv entrypoint and optimized_module keeps
+    // the engine that owns it alive.
+    std::thread tier_thread;
+    std::atomic<void *> optimized_argv{nullptr};
+    IntrusivePtr<JITModuleContents> optimized_module;
+
     std::string name;
+
+    void join_tier_thread() {
+        if (tier_thread.joinable()) {
+            tier_thread.join();
+        }
+    }
 };
 
 template<>
@@ -224,6 +244,70 @@ public:
     }
 };
 
+// A persistent on-disk cache of JIT-compiled machine code, enabled by
+// setting HL_JIT_CACHE_DIR to a writable directory. Entries are keyed
+// on a hash of the module bitcode and everything that affects code
+// generation, so a hit skips LLVM entirely and just relocates the
+// stored object.
+class JITObjectCache : public llvm::ObjectCache {
+public:
+    JITObjectCache(const std::string &dir, const std::string &key)
+        : path(dir + "/halide_jit_" + key + ".o") {
+    }
+
+    void notifyObjectCompiled(const llvm::Module *, llvm::MemoryBufferRef obj) override {
+        // Write to a unique temporary file and rename it into place,
+        // so concurrent processes never observe a partial object.
+        llvm::SmallString<128> tmp;
+        int fd;
+        if (llvm::sys::fs::createUniqueFile(path + ".tmp%%%%%%", fd, tmp)) {
+            return;
+        }
+        {
+            llvm::raw_fd_ostream out(fd, /*shouldClose=*/true);
+            out.write(obj.getBufferStart(), obj.getBufferSize());
+        }
+        if (llvm::sys::fs::rename(tmp, path)) {
+            llvm::sys::fs::remove(tmp);
+        }
+    }
+
+    std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module *) override {
+        // getFile memory-maps the object when it's large enough to be
+        // worthwhile.
+        auto buffer = llvm::MemoryBuffer::getFile(path);
+        if (!buffer) {
+            return nullptr;
+        }
+        debug(1) << "JIT object cache hit: " << path << "\n";
+        return std::move(*buffer);
+    }
+
+private:
+    std::string path;
+};
+
+// Compute the cache key for a module about to be JIT-compiled: a hash
+// of its bitcode plus the inputs to target machine selection.
+std::string jit_cache_key(const llvm::Module &m, const Target &target,
+                          const std::string &mcpu, const std::string &mattrs,
+                          bool fast_compile) {
+    llvm::SmallVector<char, 4096> bitcode;
+    llvm::raw_svector_ostream s(bitcode);
+    llvm::WriteBitcodeToFile(m, s);
+    llvm::MD5 md5;
+    md5.update(llvm::StringRef(bitcode.data(), bitcode.size()));
+    md5.update(target.to_string());
+    md5.update(mcpu);
+    md5.update(mattrs);
+    md5.update(std::to_string(LLVM_VERSION));
+    // Fast-tier and fully optimized objects must not collide.
+    md5.update(fast_compile ? "fast" : "opt");
+    llvm::MD5::MD5Result result;
+    md5.final(result);
+    return result.digest().str().str();
+}
+
 }  // namespace
 
 JITModule::JITModule() {
@@ -231,20 +315,39 @@ JITModule::JITModule() {
 }
 
 JITModule::JITModule(const Module &m, const LoweredFunc &fn,
-                     const std::vector<JITModule> &dependencies) {
+                     const std::vector<JITModule> &dependencies,
+                     bool tiered) {
     jit_module = new JITModuleContents();
-    std::unique_ptr<llvm::Module> llvm_module(compile_module_to_llvm_module(m, jit_module->context));
+    std::unique_ptr<llvm::Module> llvm_module(compile_module_to_llvm_module(m, jit_module->context, tiered));
     std::vector<JITModule> deps_with_runtime = dependencies;
     std::vector<JITModule> shared_runtime = JITSharedRuntime::get(llvm_module.get(), m.target());
     deps_with_runtime.insert(deps_with_runtime.end(), shared_runtime.begin(), shared_runtime.end());
-    compile_module(std::move(llvm_module), fn.name, m.target(), deps_with_runtime);
+    compile_module(std::move(llvm_module), fn.name, m.target(), deps_with_runtime, std::vector<std::string>(), tiered);
     // If -time-passes is in HL_LLVM_ARGS, this will print llvm passes time statstics otherwise its no-op.
     llvm::reportAndResetTimings();
+
+    if (tiered) {
+        // Kick off the fully optimized compile on a background
+        // thread. The thread writes only to the tiered-compilation
+        // fields of the contents object, and the contents destructor
+        // joins it before tearing anything down, so holding a raw
+        // pointer here is safe.
+        JITModuleContents *contents = jit_module.get();
+        Module module_copy = m;
+        LoweredFunc fn_copy = fn;
+        contents->tier_thread = std::thread([contents, module_copy, fn_copy, dependencies]() {
+            JITModule optimized(module_copy, fn_copy, dependencies);
+            contents->optimized_module = optimized.jit_module;
+            contents->optimized_argv.store(optimized.jit_module->argv_entrypoint.address,
+                                           std::memory_order_release);
+        });
+    }
 }
 
 void JITModule::compile_module(std::unique_ptr<llvm::Module> m, const string &function_name, const Target &target,
                                const std::vector<JITModule> &dependencies,
-                               const std::vector<std::string> &requested_exports) {
+                               const std::vector<std::string> &requested_exports,
+                               bool fast_compile) {
 
     // Ensure that LLVM is initialized
     CodeGen_LLVM::initialize_llvm();
@@ -262,6 +365,16 @@ void JITModule::compile_module(std::unique_ptr<llvm::Module> m, const string &fu
     DataLayout initial_module_data_layout = m->getDataLayout();
     string module_name = m->getModuleIdentifier();
 
+    // Optionally consult a persistent on-disk cache of compiled
+    // objects, so that processes which JIT many pipelines at startup
+    // skip LLVM codegen entirely on later runs.
+    string jit_cache_dir = get_env_variable("HL_JIT_CACHE_DIR");
+    if (!jit_cache_dir.empty()) {
+        llvm::sys::fs::create_directories(jit_cache_dir);
+        jit_module->object_cache = std::make_unique<JITObjectCache>(
+            jit_cache_dir, jit_cache_key(*m, target, mcpu, mattrs, fast_compile));
+    }
+
     llvm::EngineBuilder engine_builder((std::move(m)));
     engine_builder.setTargetOptions(options);
     engine_builder.setErrorStr(&error_string);
@@ -269,7 +382,7 @@ void JITModule::compile_module(std::unique_ptr<llvm::Module> m, const string &fu
     HalideJITMemoryManager *memory_manager = new HalideJITMemoryManager(dependencies);
     engine_builder.setMCJITMemoryManager(std::unique_ptr<RTDyldMemoryManager>(memory_manager));
 
-    engine_builder.setOptLevel(CodeGenOpt::Aggressive);
+    engine_builder.setOptLevel(fast_compile ? CodeGenOpt::None : CodeGenOpt::Aggressive);
     if (!mcpu.empty()) {
         engine_builder.setMCPU(mcpu);
     }
@@ -292,6 +405,10 @@ void JITModule::compile_module(std::unique_ptr<llvm::Module> m, const string &fu
     }
     internal_assert(ee) << "Couldn't create execution engine\n";
 
+    if (jit_module->object_cache) {
+        ee->setObjectCache(jit_module->object_cache.get());
+    }
+
     // Do any target-specific initialization
     std::vector<llvm::JITEventListener *> listeners;
 
@@ -401,6 +518,12 @@ JITModule::Symbol JITModule::entrypoint_symbol() const {
 }
 
 int (*JITModule::argv_function() const)(const void **) {
+    // Under tiered compilation, switch to the optimized entrypoint as
+    // soon as the background compile has published it.
+    void *optimized = jit_module->optimized_argv.load(std::memory_order_acquire);
+    if (optimized) {
+        return (int (*)(const void **))optimized;
+    }
     return (int (*)(const void **))jit_module->argv_entrypoint.address;
 }
 
@@ -457,6 +580,14 @@ void JITModule::memoization_cache_evict(uint64_t eviction_key) const {
     }
 }
 
+void JITModule::persistent_state_clear(const char *key) const {
+    std::map<std::string, Symbol>::const_iterator f =
+        exports().find("halide_persistent_state_clear");
+    if (f != exports().end()) {
+        (reinterpret_bits<int (*)(void *, const char *)>(f->second.address))(nullptr, key);
+    }
+}
+
 void JITModule::reuse_device_allocations(bool b) const {
     std::map<std::string, Symbol>::const_iterator f =
         exports().find("halide_reuse_device_allocations");
@@ -465,6 +596,55 @@ void JITModule::reuse_device_allocations(bool b) const {
     }
 }
 
+void JITModule::set_work_stealing(int mode) const {
+    std::map<std::string, Symbol>::const_iterator f =
+        exports().find("halide_set_work_stealing");
+    if (f != exports().end()) {
+        (reinterpret_bits<int (*)(int)>(f->second.address))(mode);
+    }
+}
+
+void JITModule::set_cancellation_token(void *user_context, halide_cancellation_token_t *token) const {
+    std::map<std::string, Symbol>::const_iterator f =
+        exports().find("halide_set_cancellation_token");
+    if (f != exports().end()) {
+        (reinterpret_bits<int (*)(void *, halide_cancellation_token_t *)>(f->second.address))(user_context, token);
+    }
+}
+
+void JITModule::cancel(halide_cancellation_token_t *token) const {
+    std::map<std::string, Symbol>::const_iterator f =
+        exports().find("halide_cancel");
+    if (f != exports().end()) {
+        (reinterpret_bits<void (*)(halide_cancellation_token_t *)>(f->second.address))(token);
+    }
+}
+
+void JITModule::cancellation_token_init(halide_cancellation_token_t *token) const {
+    std::map<std::string, Symbol>::const_iterator f =
+        exports().find("halide_cancellation_token_init");
+    if (f != exports().end()) {
+        (reinterpret_bits<int (*)(halide_cancellation_token_t *)>(f->second.address))(token);
+    }
+}
+
+void JITModule::set_deadline(halide_cancellation_token_t *token, int64_t budget_ns) const {
+    std::map<std::string, Symbol>::const_iterator f =
+        exports().find("halide_set_deadline");
+    if (f != exports().end()) {
+        (reinterpret_bits<int (*)(halide_cancellation_token_t *, int64_t)>(f->second.address))(token, budget_ns);
+    }
+}
+
+bool JITModule::deadline_progress(halide_cancellation_token_t *token, int *first_skipped) const {
+    std::map<std::string, Symbol>::const_iterator f =
+        exports().find("halide_deadline_progress");
+    if (f != exports().end()) {
+        return (reinterpret_bits<bool (*)(halide_cancellation_token_t *, int *)>(f->second.address))(token, first_skipped);
+    }
+    return false;
+}
+
 bool JITModule::compiled() const {
     return jit_module->execution_engine != nullptr;
 }
@@ -475,6 +655,7 @@ JITHandlers runtime_internal_handlers;
 JITHandlers default_handlers;
 JITHandlers active_handlers;
 int64_t default_cache_size;
+int default_work_stealing_mode = halide_work_stealing_off;
 
 void merge_handlers(JITHandlers &base, const JITHandlers &addins) {
     if (addins.custom_print) {
@@ -595,6 +776,8 @@ function_t hook_function(const std::map<std::string, JITModule::Symbol> &exports
     return (*hook_setter)(hook);
 }
 
+// Called from JITted code on entry and exit to each pipeline. RefCount
+// is a std::atomic, so this per-call path takes no locks.
 void adjust_module_ref_count(void *arg, int32_t count) {
     JITModuleContents *module = (JITModuleContents *)arg;
 
@@ -637,7 +820,7 @@ enum RuntimeKind {
 };
 
 JITModule &shared_runtimes(RuntimeKind k) {
-    // We're already guarded by the shared_runtimes_mutex
+    // Callers must hold the shared_runtimes_mutex
     static JITModule *m = nullptr;
     if (!m) {
         // Note that this is never freed. On windows this would invoke
@@ -648,12 +831,55 @@ JITModule &shared_runtimes(RuntimeKind k) {
     return m[k];
 }
 
-JITModule &make_module(llvm::Module *for_module, Target target,
-                       RuntimeKind runtime_kind, const std::vector<JITModule> &deps,
-                       bool create) {
+// Once a runtime is installed in the table above, its contents pointer
+// is also published here so that the common case - the runtime already
+// exists - can be served without taking shared_runtimes_mutex. The
+// entry in the table keeps a reference alive, so a pointer loaded from
+// here can safely be increffed; release_all unpublishes before it
+// drops the table's references, and must not be called concurrently
+// with compilation or execution of JITted code (it never has been - it
+// resets the handler hooks out from under running pipelines too).
+std::atomic<JITModuleContents *> published_runtimes[MaxRuntimeKind] = {};
+
+// Building a runtime module is slow, so it is done outside the
+// shared_runtimes_mutex, serialized per runtime kind: independent JIT
+// compiles (and first-time compiles of distinct device runtimes) can
+// then proceed concurrently.
+std::mutex runtime_compile_mutex[MaxRuntimeKind];
+
+JITModule make_module(llvm::Module *for_module, Target target,
+                      RuntimeKind runtime_kind, const std::vector<JITModule> &deps,
+                      bool create) {
+    // Lock-free fast path: if this runtime has already been built and
+    // published, just take a new reference to it.
+    if (JITModuleContents *p = published_runtimes[runtime_kind].load(std::memory_order_acquire)) {
+        JITModule runtime;
+        runtime.jit_module = IntrusivePtr<JITModuleContents>(p);
+        return runtime;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(shared_runtimes_mutex);
+        JITModule &runtime = shared_runtimes(runtime_kind);
+        if (runtime.compiled() || !create) {
+            return runtime;
+        }
+    }
+
+    std::lock_guard<std::mutex> compile_lock(runtime_compile_mutex[runtime_kind]);
+    {
+        std::lock_guard<std::mutex> lock(shared_runtimes_mutex);
+        JITModule &runtime = shared_runtimes(runtime_kind);
+        if (runtime.compiled()) {
+            // Another thread built this runtime while we waited.
+            return runtime;
+        }
+    }
 
-    JITModule &runtime = shared_runtimes(runtime_kind);
-    if (!runtime.compiled() && create) {
+    // Compile into a local module, and only install it in the shared
+    // table once it is complete.
+    JITModule runtime;
+    {
         // Ensure that JIT feature is set on target as it must be in
         // order for the right runtime components to be added.
         target.set_feature(Target::JIT);
@@ -784,13 +1010,13 @@ JITModule &make_module(llvm::Module *for_module, Target target,
                 hook_function(runtime.exports(), "halide_set_custom_trace", trace_handler);
 
             runtime_internal_handlers.custom_get_symbol =
-                hook_function(shared_runtimes(MainShared).exports(), "halide_set_custom_get_symbol", get_symbol_handler);
+                hook_function(runtime.exports(), "halide_set_custom_get_symbol", get_symbol_handler);
 
             runtime_internal_handlers.custom_load_library =
-                hook_function(shared_runtimes(MainShared).exports(), "halide_set_custom_load_library", load_library_handler);
+                hook_function(runtime.exports(), "halide_set_custom_load_library", load_library_handler);
 
             runtime_internal_handlers.custom_get_library_symbol =
-                hook_function(shared_runtimes(MainShared).exports(), "halide_set_custom_get_library_symbol", get_library_symbol_handler);
+                hook_function(runtime.exports(), "halide_set_custom_get_library_symbol", get_library_symbol_handler);
 
             active_handlers = runtime_internal_handlers;
             merge_handlers(active_handlers, default_handlers);
@@ -799,6 +1025,10 @@ JITModule &make_module(llvm::Module *for_module, Target target,
                 runtime.memoization_cache_set_size(default_cache_size);
             }
 
+            if (default_work_stealing_mode != halide_work_stealing_off) {
+                runtime.set_work_stealing(default_work_stealing_mode);
+            }
+
             runtime.jit_module->name = "MainShared";
         } else {
             runtime.jit_module->name = "GPU";
@@ -814,6 +1044,12 @@ JITModule &make_module(llvm::Module *for_module, Target target,
         internal_assert(fun_addr != 0);
         *(void (**)(void *arg, int32_t count))fun_addr = &adjust_module_ref_count;
     }
+
+    {
+        std::lock_guard<std::mutex> lock(shared_runtimes_mutex);
+        shared_runtimes(runtime_kind) = runtime;
+        published_runtimes[runtime_kind].store(runtime.jit_module.get(), std::memory_order_release);
+    }
     return runtime;
 }
 
@@ -828,8 +1064,10 @@ JITModule &make_module(llvm::Module *for_module, Target target,
  * JITSharedRuntime::release_all is called, the global state is reset
  * and any newly compiled Funcs will get a new runtime. */
 std::vector<JITModule> JITSharedRuntime::get(llvm::Module *for_module, const Target &target, bool create) {
-    std::lock_guard<std::mutex> lock(shared_runtimes_mutex);
-
+    // No lock here: make_module does its own locking, and holds the
+    // shared_runtimes_mutex only while consulting or updating the
+    // table, not while compiling a runtime. Concurrent calls for
+    // different runtime kinds can therefore compile in parallel.
     std::vector<JITModule> result;
 
     JITModule m = make_module(for_module, target, MainShared, result, create);
@@ -901,6 +1139,9 @@ void JITSharedRuntime::release_all() {
     std::lock_guard<std::mutex> lock(shared_runtimes_mutex);
 
     for (int i = MaxRuntimeKind; i > 0; i--) {
+        // Unpublish before dropping the table's reference, so the
+        // lock-free path in make_module can no longer hand it out.
+        published_runtimes[i - 1].store(nullptr, std::memory_order_release);
         shared_runtimes((RuntimeKind)(i - 1)) = JITModule();
     }
 }
@@ -927,10 +1168,48 @@ void JITSharedRuntime::memoization_cache_evict(uint64_t eviction_key) {
     shared_runtimes(MainShared).memoization_cache_evict(eviction_key);
 }
 
+void JITSharedRuntime::persistent_state_clear(const char *key) {
+    std::lock_guard<std::mutex> lock(shared_runtimes_mutex);
+    shared_runtimes(MainShared).persistent_state_clear(key);
+}
+
 void JITSharedRuntime::reuse_device_allocations(bool b) {
     std::lock_guard<std::mutex> lock(shared_runtimes_mutex);
     shared_runtimes(MainShared).reuse_device_allocations(b);
 }
 
+int JITSharedRuntime::set_work_stealing(int mode) {
+    std::lock_guard<std::mutex> lock(shared_runtimes_mutex);
+    int old = default_work_stealing_mode;
+    default_work_stealing_mode = mode;
+    shared_runtimes(MainShared).set_work_stealing(mode);
+    return old;
+}
+
+void JITSharedRuntime::set_cancellation_token(void *user_context, halide_cancellation_token_t *token) {
+    std::lock_guard<std::mutex> lock(shared_runtimes_mutex);
+    shared_runtimes(MainShared).set_cancellation_token(user_context, token);
+}
+
+void JITSharedRuntime::cancel(halide_cancellation_token_t *token) {
+    std::lock_guard<std::mutex> lock(shared_runtimes_mutex);
+    shared_runtimes(MainShared).cancel(token);
+}
+
+void JITSharedRuntime::cancellation_token_init(halide_cancellation_token_t *token) {
+    std::lock_guard<std::mutex> lock(shared_runtimes_mutex);
+    shared_runtimes(MainShared).cancellation_token_init(token);
+}
+
+void JITSharedRuntime::set_deadline(halide_cancellation_token_t *token, int64_t budget_ns) {
+    std::lock_guard<std::mutex> lock(shared_runtimes_mutex);
+    shared_runtimes(MainShared).set_deadline(token, budget_ns);
+}
+
+bool JITSharedRuntime::deadline_progress(halide_cancellation_token_t *token, int *first_skipped) {
+    std::lock_guard<std::mutex> lock(shared_runtimes_mutex);
+    return shared_runtimes(MainShared).deadline_progress(token, first_skipped);
+}
+
 }  // namespace Internal
 }  // namespace Halide
@@ -41,8 +41,15 @@ struct JITModule {
     };
 
     JITModule();
+    /** Compile a Halide Module into runnable code. If tiered is
+     * true, the initial compile runs with LLVM optimization disabled
+     * so the module is usable as quickly as possible, and a fully
+     * optimized replacement is compiled on a background thread;
+     * argv_function() switches over to the optimized code once it is
+     * ready. */
     JITModule(const Module &m, const LoweredFunc &fn,
-              const std::vector<JITModule> &dependencies = std::vector<JITModule>());
+              const std::vector<JITModule> &dependencies = std::vector<JITModule>(),
+              bool tiered = false);
 
     /** Take a list of JITExterns and generate trampoline functions
      * which can be called dynamically via a function pointer that
@@ -118,11 +125,14 @@ struct JITModule {
     Symbol find_symbol_by_name(const std::string &) const;
 
     /** Take an llvm module and compile it. The requested exports will
-        be available via the exports method. */
+        be available via the exports method. If fast_compile is true,
+        instruction selection runs at minimum optimization, trading
+        code quality for compile time. */
     void compile_module(std::unique_ptr<llvm::Module> mod,
                         const std::string &function_name, const Target &target,
                         const std::vector<JITModule> &dependencies = std::vector<JITModule>(),
-                        const std::vector<std::string> &requested_exports = std::vector<std::string>());
+                        const std::vector<std::string> &requested_exports = std::vector<std::string>(),
+                        bool fast_compile = false);
 
     /** See JITSharedRuntime::memoization_cache_set_size */
     void memoization_cache_set_size(int64_t size) const;
@@ -130,9 +140,30 @@ struct JITModule {
     /** See JITSharedRuntime::memoization_cache_evict */
     void memoization_cache_evict(uint64_t eviction_key) const;
 
+    /** See JITSharedRuntime::persistent_state_clear */
+    void persistent_state_clear(const char *key) const;
+
     /** See JITSharedRuntime::reuse_device_allocations */
     void reuse_device_allocations(bool) const;
 
+    /** See JITSharedRuntime::set_work_stealing */
+    void set_work_stealing(int mode) const;
+
+    /** See JITSharedRuntime::set_cancellation_token */
+    void set_cancellation_token(void *user_context, halide_cancellation_token_t *token) const;
+
+    /** See JITSharedRuntime::cancel */
+    void cancel(halide_cancellation_token_t *token) const;
+
+    /** See JITSharedRuntime::cancellation_token_init */
+    void cancellation_token_init(halide_cancellation_token_t *token) const;
+
+    /** See JITSharedRuntime::set_deadline */
+    void set_deadline(halide_cancellation_token_t *token, int64_t budget_ns) const;
+
+    /** See JITSharedRuntime::deadline_progress */
+    bool deadline_progress(halide_cancellation_token_t *token, int *first_skipped) const;
+
     /** Return true if compile_module has been called on this module. */
     bool compiled() const;
 };
@@ -177,6 +208,12 @@ public:
      */
     static void memoization_cache_evict(uint64_t eviction_key);
 
+    /** Free the state retained for Funcs scheduled with
+     * store_persistent in JIT-compiled pipelines. A null key clears
+     * all retained state. If you are compiling statically, call
+     * halide_persistent_state_clear instead. */
+    static void persistent_state_clear(const char *key);
+
     /** Set whether or not Halide may hold onto and reuse device
      * allocations to avoid calling expensive device API allocation
      * functions. If you are compiling statically, you should include
@@ -184,6 +221,43 @@ public:
      * instead. */
     static void reuse_device_allocations(bool);
 
+    /** Set the work-stealing mode of the shared runtime's thread
+     * pool. Takes one of the halide_work_stealing_mode_t values and
+     * returns the previous setting. If you are compiling statically,
+     * you should include HalideRuntime.h and call
+     * halide_set_work_stealing instead. */
+    static int set_work_stealing(int mode);
+
+    /** Associate a cancellation token with a user context pointer in
+     * the shared runtime's thread pool, so pipelines invoked with
+     * that user context poll the token. Pass a null token to remove
+     * the association. If you are compiling statically, you should
+     * include HalideRuntime.h and call halide_set_cancellation_token
+     * instead. */
+    static void set_cancellation_token(void *user_context, halide_cancellation_token_t *token);
+
+    /** Cancel pipeline invocations polling the given token, waking
+     * any sleeping thread pool threads so the cancellation is noticed
+     * promptly. If you are compiling statically, call halide_cancel
+     * instead. */
+    static void cancel(halide_cancellation_token_t *token);
+
+    /** Return a cancellation token to the not-cancelled state. If you
+     * are compiling statically, call halide_cancellation_token_init
+     * instead. */
+    static void cancellation_token_init(halide_cancellation_token_t *token);
+
+    /** Arm a deadline on a cancellation token, measured on the shared
+     * runtime's clock: budget_ns from now, pipeline invocations
+     * polling the token cancel themselves. If you are compiling
+     * statically, call halide_set_deadline instead. */
+    static void set_deadline(halide_cancellation_token_t *token, int64_t budget_ns);
+
+    /** Report how far a cancelled invocation got; see
+     * halide_deadline_progress. If you are compiling statically, call
+     * that instead. */
+    static bool deadline_progress(halide_cancellation_token_t *token, int *first_skipped);
+
     static void release_all();
 };
 
@@ -399,8 +399,8 @@ void emit_file(const llvm::Module &module_in, Internal::LLVMOStream &out,
     llvm::reportAndResetTimings();
 }
 
-std::unique_ptr<llvm::Module> compile_module_to_llvm_module(const Module &module, llvm::LLVMContext &context) {
-    return codegen_llvm(module, context);
+std::unique_ptr<llvm::Module> compile_module_to_llvm_module(const Module &module, llvm::LLVMContext &context, bool fast_compile) {
+    return codegen_llvm(module, context, fast_compile);
 }
 
 void compile_llvm_module_to_object(llvm::Module &module, Internal::LLVMOStream &out) {
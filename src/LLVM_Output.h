@@ -27,8 +27,10 @@ namespace Internal {
 typedef llvm::raw_pwrite_stream LLVMOStream;
 }
 
-/** Generate an LLVM module. */
-std::unique_ptr<llvm::Module> compile_module_to_llvm_module(const Module &module, llvm::LLVMContext &context);
+/** Generate an LLVM module. If fast_compile is true, the LLVM
+ * optimization passes are skipped, trading code quality for compile
+ * time. */
+std::unique_ptr<llvm::Module> compile_module_to_llvm_module(const Module &module, llvm::LLVMContext &context, bool fast_compile = false);
 
 /** Construct an llvm output stream for writing to files. */
 std::unique_ptr<llvm::raw_fd_ostream> make_raw_fd_ostream(const std::string &filename);
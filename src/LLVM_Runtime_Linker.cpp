@@ -77,6 +77,7 @@ std::unique_ptr<llvm::Module> parse_bitcode_file(llvm::StringRef buf, llvm::LLVM
 DECLARE_CPP_INITMOD(alignment_128)
 DECLARE_CPP_INITMOD(alignment_32)
 DECLARE_CPP_INITMOD(allocation_cache)
+DECLARE_CPP_INITMOD(buffer_prefault)
 DECLARE_CPP_INITMOD(alignment_64)
 DECLARE_CPP_INITMOD(android_clock)
 DECLARE_CPP_INITMOD(android_host_cpu_count)
@@ -116,6 +117,7 @@ DECLARE_CPP_INITMOD(osx_get_symbol)
 DECLARE_CPP_INITMOD(osx_host_cpu_count)
 DECLARE_CPP_INITMOD(osx_opengl_context)
 DECLARE_CPP_INITMOD(osx_yield)
+DECLARE_CPP_INITMOD(persistent_state)
 DECLARE_CPP_INITMOD(posix_allocator)
 DECLARE_CPP_INITMOD(posix_clock)
 DECLARE_CPP_INITMOD(posix_error_handler)
@@ -139,6 +141,7 @@ DECLARE_CPP_INITMOD(qurt_threads_tsan)
 DECLARE_CPP_INITMOD(qurt_yield)
 DECLARE_CPP_INITMOD(runtime_api)
 DECLARE_CPP_INITMOD(ssp)
+DECLARE_CPP_INITMOD(telemetry)
 DECLARE_CPP_INITMOD(to_string)
 DECLARE_CPP_INITMOD(trace_helper)
 DECLARE_CPP_INITMOD(tracing)
@@ -764,6 +767,7 @@ std::unique_ptr<llvm::Module> link_with_wasm_jit_runtime(llvm::LLVMContext *c, c
     // modules.push_back(get_initmod_wasm_math_ll(c));
     modules.push_back(get_initmod_tracing(c, bits_64, debug));
     modules.push_back(get_initmod_cache(c, bits_64, debug));
+    modules.push_back(get_initmod_persistent_state(c, bits_64, debug));
     modules.push_back(get_initmod_to_string(c, bits_64, debug));
     modules.push_back(get_initmod_alignment_32(c, bits_64, debug));
     modules.push_back(get_initmod_device_interface(c, bits_64, debug));
@@ -997,6 +1001,7 @@ std::unique_ptr<llvm::Module> get_initial_module_for_target(Target t, llvm::LLVM
             }
 
             modules.push_back(get_initmod_allocation_cache(c, bits_64, debug));
+            modules.push_back(get_initmod_buffer_prefault(c, bits_64, debug));
             modules.push_back(get_initmod_device_interface(c, bits_64, debug));
             modules.push_back(get_initmod_metadata(c, bits_64, debug));
             modules.push_back(get_initmod_float16_t(c, bits_64, debug));
@@ -1009,6 +1014,8 @@ std::unique_ptr<llvm::Module> get_initial_module_for_target(Target t, llvm::LLVM
                 } else {
                     modules.push_back(get_initmod_profiler(c, bits_64, debug));
                 }
+                // The telemetry counters need the same atomics.
+                modules.push_back(get_initmod_telemetry(c, bits_64, debug));
             }
 
             if (t.has_feature(Target::MSAN)) {
@@ -1183,7 +1190,16 @@ std::unique_ptr<llvm::Module> get_initial_module_for_target(Target t, llvm::LLVM
         modules.push_back(get_initmod_runtime_api(c, bits_64, debug));
     }
 
-    link_modules(modules, t);
+    // With strip_runtime, runtime functions become linkonce rather
+    // than weak, so once the generated pipeline code has been added
+    // to this module, global dead-code elimination discards every
+    // runtime subsystem the pipeline doesn't actually reference
+    // instead of shipping all of them in the object. The runtime has
+    // no static constructors, so the subsystems that remain still
+    // cost nothing until first use.
+    bool strip_unreferenced_runtime =
+        module_type == ModuleAOT && t.has_feature(Target::StripRuntime);
+    link_modules(modules, t, strip_unreferenced_runtime);
 
     if (t.os == Target::Windows &&
         t.bits == 32 &&
@@ -17,32 +17,43 @@
 #include "CSE.h"
 #include "CanonicalizeGPUVars.h"
 #include "CompilerLogger.h"
+#include "ConstantRealization.h"
 #include "Debug.h"
 #include "DebugArguments.h"
 #include "DebugToFile.h"
 #include "Deinterleave.h"
 #include "EarlyFree.h"
+#include "FalseSharing.h"
 #include "FindCalls.h"
 #include "FindIntrinsics.h"
 #include "FlattenNestedRamps.h"
 #include "Func.h"
 #include "Function.h"
+#include "FuseGPUKernels.h"
 #include "FuseGPUThreadLoops.h"
 #include "FuzzFloatStores.h"
+#include "GraphRewrite.h"
+#include "HashCons.h"
 #include "HexagonOffload.h"
 #include "IRMutator.h"
 #include "IROperator.h"
 #include "IRPrinter.h"
 #include "InferArguments.h"
 #include "InjectHostDevBufferCopies.h"
+#include "InjectStreamingStores.h"
 #include "Inline.h"
 #include "LICM.h"
 #include "LoopCarry.h"
 #include "LowerWarpShuffles.h"
+#include "GPUMatrixOps.h"
 #include "Memoization.h"
+#include "PersistentState.h"
 #include "OffloadGPULoops.h"
 #include "PartitionLoops.h"
+#include "PredicateClampedLoads.h"
+#include "PipelineLoops.h"
 #include "Prefetch.h"
+#include "PrivatizeAtomics.h"
 #include "Profiling.h"
 #include "PurifyIndexMath.h"
 #include "Qualify.h"
@@ -51,6 +62,7 @@
 #include "RemoveDeadAllocations.h"
 #include "RemoveExternLoops.h"
 #include "RemoveUndef.h"
+#include "ReplaceCopyLoops.h"
 #include "ScheduleFunctions.h"
 #include "SelectGPUAPI.h"
 #include "Simplify.h"
@@ -58,12 +70,16 @@
 #include "SimplifySpecializations.h"
 #include "SkipStages.h"
 #include "SlidingWindow.h"
+#include "SpecializeHotExtents.h"
 #include "SplitTuples.h"
+#include "StorageAliasing.h"
 #include "StorageFlattening.h"
 #include "StorageFolding.h"
+#include "StrengthReduceDivMod.h"
 #include "StrictifyFloat.h"
 #include "Substitute.h"
 #include "Tracing.h"
+#include "TransposeVectors.h"
 #include "TrimNoOps.h"
 #include "UnifyDuplicateLets.h"
 #include "UniquifyVariableNames.h"
@@ -71,6 +87,7 @@
 #include "UnrollLoops.h"
 #include "UnsafePromises.h"
 #include "VectorizeLoops.h"
+#include "WorkingSetReport.h"
 #include "WrapCalls.h"
 
 namespace Halide {
@@ -83,11 +100,168 @@ using std::vector;
 
 namespace {
 
+// Measures the structural complexity of a stmt, to report how much
+// each lowering pass grew or shrank it and to enforce the complexity
+// budget below. Node counts are of distinct nodes; shared subtrees are
+// traversed (and their depth measured) only where first encountered,
+// which keeps the measurement linear in the number of distinct nodes.
+class MeasureIRComplexity : public IRGraphVisitor {
+    using IRGraphVisitor::include;
+    using IRGraphVisitor::visit;
+
+    void include(const Expr &e) override {
+        if (seen.insert((const void *)e.get()).second) {
+            count_node();
+        }
+        depth++;
+        max_depth = std::max(max_depth, depth);
+        IRGraphVisitor::include(e);
+        depth--;
+    }
+
+    void include(const Stmt &s) override {
+        if (seen.insert((const void *)s.get()).second) {
+            count_node();
+        }
+        IRGraphVisitor::include(s);
+    }
+
+    void visit(const Let *op) override {
+        let_depth++;
+        max_let_depth = std::max(max_let_depth, let_depth);
+        IRGraphVisitor::visit(op);
+        let_depth--;
+    }
+
+    void visit(const LetStmt *op) override {
+        let_depth++;
+        max_let_depth = std::max(max_let_depth, let_depth);
+        IRGraphVisitor::visit(op);
+        let_depth--;
+    }
+
+    void visit(const ProducerConsumer *op) override {
+        if (op->is_producer) {
+            producers.push_back(op->name);
+            IRGraphVisitor::visit(op);
+            producers.pop_back();
+        } else {
+            IRGraphVisitor::visit(op);
+        }
+    }
+
+    void count_node() {
+        nodes++;
+        if (!producers.empty()) {
+            producer_nodes[producers.back()]++;
+        }
+    }
+
+    // IRGraphVisitor's visited set is private, so keep our own.
+    std::set<const void *> seen;
+    int64_t depth = 0;
+    int64_t let_depth = 0;
+    std::vector<std::string> producers;
+
+public:
+    int64_t nodes = 0;
+    int64_t max_depth = 0;
+    int64_t max_let_depth = 0;
+
+    // Nodes attributed to the innermost enclosing producer, to name
+    // the Func responsible for a blowup.
+    std::map<std::string, int64_t> producer_nodes;
+
+    void measure(const Stmt &s) {
+        include(s);
+    }
+};
+
 class LoweringLogger {
     Stmt last_written;
 
+    // When HL_TIME_LOWERING_PASSES is set, each call to the logger
+    // also records the time since the previous call and the IR
+    // complexity on either side of it, attributed to the pass that
+    // just ran. The records go to the active CompilerLogger if there
+    // is one, and to stderr if not. When HL_IR_COMPLEXITY_BUDGET is
+    // set to a node count, exceeding it aborts compilation with a
+    // diagnostic naming the pass and the largest Func, instead of
+    // letting an exponential blowup hang the build.
+    bool time_passes;
+    int64_t complexity_budget = 0;
+    std::chrono::time_point<std::chrono::high_resolution_clock> last_time;
+    int64_t last_nodes = 0;
+
 public:
+    LoweringLogger() {
+        time_passes = !get_env_variable("HL_TIME_LOWERING_PASSES").empty();
+        string budget = get_env_variable("HL_IR_COMPLEXITY_BUDGET");
+        if (!budget.empty()) {
+            complexity_budget = std::atoll(budget.c_str());
+        }
+        if (time_passes) {
+            last_time = std::chrono::high_resolution_clock::now();
+        }
+    }
+
     void operator()(const string &message, const Stmt &s) {
+        if (time_passes || complexity_budget > 0) {
+            string pass_name = message;
+            if (starts_with(pass_name, "Lowering after ")) {
+                pass_name = pass_name.substr(strlen("Lowering after "));
+            }
+            if (ends_with(pass_name, ":")) {
+                pass_name.pop_back();
+            }
+
+            MeasureIRComplexity m;
+            m.measure(s);
+
+            if (time_passes) {
+                auto now = std::chrono::high_resolution_clock::now();
+                std::chrono::duration<double> diff = now - last_time;
+                if (auto *logger = get_compiler_logger()) {
+                    logger->record_lowering_pass_time(pass_name, diff.count(), last_nodes, m.nodes);
+                } else {
+                    debug(0) << "Lowering pass " << pass_name << ": "
+                             << (diff.count() * 1000.0) << " ms, "
+                             << last_nodes << " -> " << m.nodes << " IR nodes, "
+                             << "max depth " << m.max_depth << ", "
+                             << "max let nesting " << m.max_let_depth << "\n";
+                }
+            }
+            if (auto *logger = get_compiler_logger()) {
+                logger->record_ir_complexity(pass_name, m.nodes, m.max_depth, m.max_let_depth);
+            }
+            last_nodes = m.nodes;
+
+            if (complexity_budget > 0 && m.nodes > complexity_budget) {
+                string worst;
+                int64_t worst_nodes = 0;
+                for (const auto &p : m.producer_nodes) {
+                    if (p.second > worst_nodes) {
+                        worst = p.first;
+                        worst_nodes = p.second;
+                    }
+                }
+                std::ostringstream diag;
+                diag << "IR complexity budget exceeded after lowering pass " << pass_name
+                     << ": " << m.nodes << " IR nodes, but HL_IR_COMPLEXITY_BUDGET is "
+                     << complexity_budget
+                     << " (max expression depth " << m.max_depth
+                     << ", max let nesting " << m.max_let_depth << ").";
+                if (!worst.empty()) {
+                    diag << " The largest contributor is Func " << worst
+                         << ", with " << worst_nodes << " nodes.";
+                }
+                user_error << diag.str() << "\n";
+            }
+
+            // Don't charge the measurement above to the next pass.
+            last_time = std::chrono::high_resolution_clock::now();
+        }
+
         if (!s.same_as(last_written)) {
             debug(2) << message << "\n"
                      << s << "\n";
@@ -128,6 +302,13 @@ Module lower(const vector<Function> &output_funcs,
     bool any_strict_float = strictify_float(env, t);
     result_module.set_any_strict_float(any_strict_float);
 
+    // Optionally simplify across Func boundaries by composing cheap
+    // producers into their consumers. The graph is a private deep copy
+    // at this point, so rewriting it doesn't disturb the frontend Funcs.
+    if (!get_env_variable("HL_GRAPH_REWRITE").empty()) {
+        graph_rewrite(outputs, env);
+    }
+
     // Output functions should all be computed and stored at root.
     for (const Function &f : outputs) {
         Func(f).compute_root().store_root();
@@ -158,6 +339,15 @@ Module lower(const vector<Function> &output_funcs,
     Stmt s = schedule_functions(outputs, fused_groups, env, t, any_memoized);
     log("Lowering after creating initial loop nests:", s);
 
+    if (hash_consing_enabled()) {
+        // Unsanitized front-end Exprs are often graphs with large
+        // value-equal subtrees. Collapsing them to shared nodes here
+        // lets the deep comparisons in the passes below exit early.
+        debug(1) << "Hash-consing expressions...\n";
+        s = hash_cons(s);
+        log("Lowering after hash-consing:", s);
+    }
+
     if (any_memoized) {
         debug(1) << "Injecting memoization...\n";
         s = inject_memoization(s, env, pipeline_name, outputs);
@@ -165,6 +355,17 @@ Module lower(const vector<Function> &output_funcs,
     } else {
         debug(1) << "Skipping injecting memoization...\n";
     }
+
+    bool any_persistent = false;
+    for (const auto &p : env) {
+        any_persistent |= p.second.schedule().store_persistent();
+    }
+    if (any_persistent) {
+        debug(1) << "Injecting persistent state...\n";
+        s = inject_persistent_state(s, env, pipeline_name, outputs);
+        log("Lowering after injecting persistent state:", s);
+    }
+
     debug(1) << "Injecting tracing...\n";
     s = inject_tracing(s, pipeline_name, trace_pipeline, env, outputs, t);
     log("Lowering after injecting tracing:", s);
@@ -173,6 +374,15 @@ Module lower(const vector<Function> &output_funcs,
     s = add_parameter_checks(requirements, s, t);
     log("Lowering after injecting parameter checks:", s);
 
+    // When verbose, record the checks as they are injected (here and
+    // after add_image_checks below) so we can report at the end of
+    // lowering which of them the simplifier managed to prove away.
+    const bool report_checks = debug::debug_level() >= 1 && !t.has_feature(Target::NoAsserts);
+    std::map<string, Expr> injected_checks;
+    if (report_checks) {
+        collect_injected_checks(s, &injected_checks);
+    }
+
     // Compute the maximum and minimum possible value of each
     // function. Used in later bounds inference passes.
     debug(1) << "Computing bounds of each function's value\n";
@@ -218,10 +428,29 @@ Module lower(const vector<Function> &output_funcs,
          t.has_feature(Target::HexagonDma) ||
          (t.arch != Target::Hexagon && (t.has_feature(Target::HVX))));
 
+    debug(1) << "Specializing for hot parameter extents...\n";
+    s = specialize_hot_extents(s);
+    log("Lowering after specializing for hot parameter extents:", s);
+
+    // Skipped when tracing, so that traced pipelines still report the
+    // loads and stores that fill constant Funcs.
+    if (!t.has_feature(Target::TraceLoads) &&
+        !t.has_feature(Target::TraceStores) &&
+        !t.has_feature(Target::TraceRealizations) &&
+        !t.has_feature(Target::TracePipeline)) {
+        debug(1) << "Folding constant realizations...\n";
+        s = fold_constant_realizations(s, env);
+        log("Lowering after folding constant realizations:", s);
+    }
+
     debug(1) << "Adding checks for images\n";
     s = add_image_checks(s, outputs, t, order, env, pipeline_name, func_bounds, will_inject_host_copies);
     log("Lowering after injecting image checks:", s);
 
+    if (report_checks) {
+        collect_injected_checks(s, &injected_checks);
+    }
+
     debug(1) << "Removing code that depends on undef values...\n";
     s = remove_undef(s);
     log("Lowering after removing code that depends on undef values:", s);
@@ -265,17 +494,32 @@ Module lower(const vector<Function> &output_funcs,
 
     debug(1) << "Bounding small realizations...\n";
     s = simplify_correlated_differences(s);
-    s = bound_small_allocations(s);
+    s = bound_small_allocations(s, env, false);
     log("Lowering after bounding small realizations:", s);
 
     debug(1) << "Performing storage flattening...\n";
     s = storage_flattening(s, outputs, env, t);
     log("Lowering after storage flattening:", s);
 
+    if (t.has_feature(Target::SpecializeStrides)) {
+        debug(1) << "Specializing for dense input strides...\n";
+        s = specialize_dense_strides(s, outputs);
+        log("Lowering after specializing for dense input strides:", s);
+    }
+
+    if (!get_env_variable("HL_CHECK_FALSE_SHARING").empty()) {
+        debug(1) << "Checking for false sharing in parallel loops...\n";
+        report_false_sharing(s);
+    }
+
     debug(1) << "Adding atomic mutex allocation...\n";
     s = add_atomic_mutex(s, env);
     log("Lowering after adding atomic mutex allocation:", s);
 
+    debug(1) << "Privatizing contended atomic updates...\n";
+    s = privatize_atomics(s);
+    log("Lowering after privatizing contended atomic updates:", s);
+
     debug(1) << "Unpacking buffer arguments...\n";
     s = unpack_buffers(s);
     log("Lowering after unpacking buffer arguments:", s);
@@ -293,6 +537,12 @@ Module lower(const vector<Function> &output_funcs,
         s = select_gpu_api(s, t);
         log("Lowering after selecting a GPU API:", s);
 
+        if (t.has_feature(Target::Metal) || t.has_feature(Target::CUDA)) {
+            debug(1) << "Injecting cooperative GPU matrix ops...\n";
+            s = inject_gpu_matrix_ops(s);
+            log("Lowering after injecting cooperative GPU matrix ops:", s);
+        }
+
         debug(1) << "Injecting host <-> dev buffer copies...\n";
         s = inject_host_dev_buffer_copies(s, t);
         log("Lowering after injecting host <-> dev buffer copies:", s);
@@ -307,6 +557,10 @@ Module lower(const vector<Function> &output_funcs,
     s = unify_duplicate_lets(s);
     log("Lowering after second simplifcation:", s);
 
+    debug(1) << "Replacing copy loops with memcpy...\n";
+    s = replace_copy_loops(s);
+    log("Lowering after replacing copy loops:", s);
+
     debug(1) << "Reduce prefetch dimension...\n";
     s = reduce_prefetch_dimension(s, t);
     log("Lowering after reduce prefetch dimension:", s);
@@ -315,6 +569,10 @@ Module lower(const vector<Function> &output_funcs,
     s = simplify_correlated_differences(s);
     log("Lowering after simplifying correlated differences:", s);
 
+    debug(1) << "Software pipelining loops...\n";
+    s = pipeline_loops(s, env);
+    log("Lowering after software pipelining:", s);
+
     debug(1) << "Unrolling...\n";
     s = unroll_loops(s);
     log("Lowering after unrolling:", s);
@@ -324,8 +582,16 @@ Module lower(const vector<Function> &output_funcs,
     s = simplify(s);
     log("Lowering after vectorizing:", s);
 
+    debug(1) << "Injecting streaming stores...\n";
+    s = inject_streaming_stores(s, env);
+    log("Lowering after injecting streaming stores:", s);
+
     if (t.has_gpu_feature() ||
         t.has_feature(Target::OpenGLCompute)) {
+        debug(1) << "Fusing producer-consumer gpu kernels...\n";
+        s = fuse_gpu_kernels(s, env);
+        log("Lowering after fusing gpu kernels:", s);
+
         debug(1) << "Injecting per-block gpu synchronization...\n";
         s = fuse_gpu_thread_loops(s);
         log("Lowering after injecting per-block gpu synchronization:", s);
@@ -336,11 +602,19 @@ Module lower(const vector<Function> &output_funcs,
     s = simplify(s);
     log("Lowering after rewriting vector interleavings:", s);
 
+    debug(1) << "Rewriting blocked vector transposes...\n";
+    s = transpose_vectors(s);
+    log("Lowering after rewriting blocked vector transposes:", s);
+
     debug(1) << "Partitioning loops to simplify boundary conditions...\n";
-    s = partition_loops(s);
+    s = partition_loops(s, env);
     s = simplify(s);
     log("Lowering after partitioning loops:", s);
 
+    debug(1) << "Predicating clamped vector loads...\n";
+    s = predicate_clamped_loads(s, t);
+    log("Lowering after predicating clamped vector loads:", s);
+
     debug(1) << "Trimming loops to the region over which they do something...\n";
     s = trim_no_ops(s);
     log("Lowering after loop trimming:", s);
@@ -354,10 +628,18 @@ Module lower(const vector<Function> &output_funcs,
     s = hoist_loop_invariant_if_statements(s);
     log("Lowering after hoisting loop invariant if statements:", s);
 
+    debug(1) << "Strength-reducing fused loop indices...\n";
+    s = strength_reduce_div_mod(s);
+    log("Lowering after strength-reducing fused loop indices:", s);
+
     debug(1) << "Injecting early frees...\n";
     s = inject_early_frees(s);
     log("Lowering after injecting early frees:", s);
 
+    debug(1) << "Aliasing storage of allocations with disjoint live ranges...\n";
+    s = storage_aliasing(s);
+    log("Lowering after storage aliasing:", s);
+
     if (t.has_feature(Target::FuzzFloatStores)) {
         debug(1) << "Fuzzing floating point stores...\n";
         s = fuzz_float_stores(s);
@@ -369,13 +651,18 @@ Module lower(const vector<Function> &output_funcs,
     log("Lowering after simplifying correlated differences:", s);
 
     debug(1) << "Bounding small allocations...\n";
-    s = bound_small_allocations(s);
+    s = bound_small_allocations(s, env, true);
     log("Lowering after bounding small allocations:", s);
 
     if (t.has_feature(Target::Profile)) {
         debug(1) << "Injecting profiling...\n";
         s = inject_profiling(s, pipeline_name);
         log("Lowering after injecting profiling:", s);
+    } else if (t.has_feature(Target::Telemetry)) {
+        // Full profiling subsumes the lightweight telemetry hooks.
+        debug(1) << "Injecting telemetry...\n";
+        s = inject_telemetry(s, pipeline_name);
+        log("Lowering after injecting telemetry:", s);
     }
 
     if (t.has_feature(Target::CUDA)) {
@@ -408,6 +695,14 @@ Module lower(const vector<Function> &output_funcs,
     debug(1) << "Lowering after final simplification:\n"
              << s << "\n\n";
 
+    if (report_checks) {
+        report_injected_checks(injected_checks, s, pipeline_name);
+    }
+
+    if (debug::debug_level() >= 1) {
+        report_working_set(s, t, pipeline_name);
+    }
+
     if (t.arch != Target::Hexagon && t.has_feature(Target::HVX)) {
         debug(1) << "Splitting off Hexagon offload...\n";
         s = inject_hexagon_rpc(s, t, result_module);
@@ -780,6 +780,183 @@ class HoistWarpShuffles : public IRMutator {
     }
 };
 
+// Rewrite atomic updates that every lane of a warp performs to the
+// same address (the pattern produced by Func::warp_reduce) into a
+// tree of shuffle-down combines, so that the partial values move
+// between registers and a single lane commits each result.
+class LowerWarpReductions : public IRMutator {
+    using IRMutator::visit;
+
+    bool in_cuda_kernel = false;
+
+    enum class ReduceOp { Add,
+                          Mul,
+                          Min,
+                          Max };
+
+    static Expr combine(ReduceOp op, const Expr &a, const Expr &b) {
+        switch (op) {
+        case ReduceOp::Add:
+            return a + b;
+        case ReduceOp::Mul:
+            return a * b;
+        case ReduceOp::Min:
+            return min(a, b);
+        case ReduceOp::Max:
+            return max(a, b);
+        }
+        return Expr();
+    }
+
+    // Returns an undefined Stmt if the loop is not a warp reduction.
+    Stmt rewrite_warp_reduction(const For *op) {
+        const int64_t *extent = as_const_int(op->extent);
+        if (!extent || *extent > 32 || *extent < 2 ||
+            ((*extent & (*extent - 1)) != 0) ||
+            !is_const_zero(op->min)) {
+            return Stmt();
+        }
+
+        // Peel off lets wrapping the atomic update. They may compute
+        // the per-lane value being reduced.
+        vector<pair<string, Expr>> lets;
+        Stmt body = op->body;
+        while (const LetStmt *let = body.as<LetStmt>()) {
+            lets.emplace_back(let->name, let->value);
+            body = let->body;
+        }
+        const Atomic *atomic = body.as<Atomic>();
+        if (!atomic || !atomic->mutex_name.empty()) {
+            return Stmt();
+        }
+        const Store *store = atomic->body.as<Store>();
+        if (!store || !is_const_one(store->predicate)) {
+            return Stmt();
+        }
+
+        // The stored value must combine the previous value at the
+        // same address with a per-lane partial using an operator we
+        // can form a shuffle tree for. Associativity of the update as
+        // a whole was already proved when it was marked atomic.
+        const Load *prev = nullptr;
+        Expr partial;
+        auto match_operands = [&](const Expr &a, const Expr &b) {
+            const Load *load = a.as<Load>();
+            if (load &&
+                load->name == store->name &&
+                is_const_one(load->predicate) &&
+                equal(load->index, store->index)) {
+                prev = load;
+                partial = b;
+                return true;
+            }
+            return false;
+        };
+        ReduceOp reduce_op;
+        if (const Add *add = store->value.as<Add>()) {
+            reduce_op = ReduceOp::Add;
+            if (!match_operands(add->a, add->b) &&
+                !match_operands(add->b, add->a)) {
+                return Stmt();
+            }
+        } else if (const Mul *mul = store->value.as<Mul>()) {
+            reduce_op = ReduceOp::Mul;
+            if (!match_operands(mul->a, mul->b) &&
+                !match_operands(mul->b, mul->a)) {
+                return Stmt();
+            }
+        } else if (const Min *m = store->value.as<Min>()) {
+            reduce_op = ReduceOp::Min;
+            if (!match_operands(m->a, m->b) &&
+                !match_operands(m->b, m->a)) {
+                return Stmt();
+            }
+        } else if (const Max *m = store->value.as<Max>()) {
+            reduce_op = ReduceOp::Max;
+            if (!match_operands(m->a, m->b) &&
+                !match_operands(m->b, m->a)) {
+                return Stmt();
+            }
+        } else {
+            return Stmt();
+        }
+
+        // Warp shuffles move 32 bits at a time.
+        Type t = partial.type();
+        if (t.lanes() != 1 || t.bits() != 32) {
+            return Stmt();
+        }
+
+        // The address must be uniform across the warp. The peeled
+        // lets may hide a dependence on the lane var, so track which
+        // of them are lane-dependent.
+        Scope<int> lane_dependent;
+        auto uses_lane = [&](const Expr &e) {
+            return expr_uses_var(e, op->name) ||
+                   expr_uses_vars(e, lane_dependent);
+        };
+        for (const auto &p : lets) {
+            if (uses_lane(p.second)) {
+                lane_dependent.push(p.first, 0);
+            }
+        }
+        if (uses_lane(store->index)) {
+            return Stmt();
+        }
+
+        // Combine the partials with log2(extent) shuffle-down steps:
+        // after step d, each lane holds the reduction of its own
+        // partial and those of the next d-1 lanes, so lane zero ends
+        // up with the reduction over the whole warp.
+        string intrin_suffix = t.is_float() ? ".f32" : ".i32";
+        vector<pair<string, Expr>> tree;
+        string base_name = unique_name('t');
+        tree.emplace_back(base_name + ".0", partial);
+        Expr acc = Variable::make(t, tree.back().first);
+        int stage = 1;
+        for (int delta = (int)(*extent) / 2; delta >= 1; delta /= 2, stage++) {
+            Expr shuffled = Call::make(t, "llvm.nvvm.shfl.down" + intrin_suffix,
+                                       {acc, make_const(Int(32), delta), make_const(Int(32), 31)},
+                                       Call::PureExtern);
+            tree.emplace_back(base_name + "." + std::to_string(stage),
+                              combine(reduce_op, acc, shuffled));
+            acc = Variable::make(t, tree.back().first);
+        }
+
+        // Lane zero commits the result for the whole warp. The store
+        // stays atomic, because other warps may be accumulating into
+        // the same address.
+        Stmt result = Store::make(store->name,
+                                  combine(reduce_op, Expr(prev), acc),
+                                  store->index, store->param,
+                                  const_true(), ModulusRemainder());
+        result = Atomic::make(atomic->producer_name, atomic->mutex_name, result);
+        Expr this_lane = Variable::make(Int(32), op->name);
+        result = IfThenElse::make(this_lane == 0, result);
+        for (auto it = tree.rbegin(); it != tree.rend(); it++) {
+            result = LetStmt::make(it->first, it->second, result);
+        }
+        for (auto it = lets.rbegin(); it != lets.rend(); it++) {
+            result = LetStmt::make(it->first, it->second, result);
+        }
+        return For::make(op->name, op->min, op->extent, op->for_type,
+                         op->device_api, result);
+    }
+
+    Stmt visit(const For *op) override {
+        ScopedValue<bool> old_in_kernel(
+            in_cuda_kernel,
+            in_cuda_kernel || op->device_api == DeviceAPI::CUDA);
+        if (in_cuda_kernel && op->for_type == ForType::GPULane) {
+            Stmt s = rewrite_warp_reduction(op);
+            if (s.defined()) {
+                return s;
+            }
+        }
+        return IRMutator::visit(op);
+    }
+};
+
 class HasLaneLoop : public IRVisitor {
     using IRVisitor::visit;
 
@@ -816,6 +993,7 @@ class LowerWarpShufflesInEachKernel : public IRMutator {
 }  // namespace
 
 Stmt lower_warp_shuffles(Stmt s) {
+    s = LowerWarpReductions().mutate(s);
     s = hoist_loop_invariant_values(s);
     s = SubstituteInLaneVar().mutate(s);
     s = simplify(s);
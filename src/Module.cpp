@@ -3,6 +3,7 @@
 #include <array>
 #include <fstream>
 #include <future>
+#include <set>
 #include <utility>
 
 #include "CodeGen_C.h"
@@ -18,6 +19,7 @@
 #include "Pipeline.h"
 #include "PythonExtensionGen.h"
 #include "StmtToHtml.h"
+#include "ThreadPool.h"
 
 using Halide::Internal::debug;
 
@@ -448,6 +450,8 @@ void Module::append(const ExternalCode &external_code) {
 Module link_modules(const std::string &name, const std::vector<Module> &modules) {
     Module output(name, modules.front().target());
 
+    std::set<std::string> function_names, buffer_names;
+    bool any_strict_float = false;
     for (size_t i = 0; i < modules.size(); i++) {
         const Module &input = modules[i];
 
@@ -458,15 +462,31 @@ Module link_modules(const std::string &name, const std::vector<Module> &modules)
                        << input.name() << ", " << input.target().to_string() << ")\n";
         }
 
-        // TODO(dsharlet): Check for naming collisions, maybe rename
-        // internal linkage declarations in the case of collision.
+        // Internal-linkage functions could in principle be renamed on
+        // collision, but pipelines only reference each other by name,
+        // so renaming one would silently break its callers. Refuse
+        // all collisions instead.
         for (const auto &b : input.buffers()) {
+            user_assert(buffer_names.insert(b.name()).second)
+                << "Duplicate buffer name '" << b.name()
+                << "' in modules to link (" << output.name() << ")\n";
             output.append(b);
         }
         for (const auto &f : input.functions()) {
+            user_assert(function_names.insert(f.name).second)
+                << "Duplicate function name '" << f.name
+                << "' in modules to link (" << output.name() << ")\n";
             output.append(f);
         }
+        for (const auto &sm : input.submodules()) {
+            output.append(sm);
+        }
+        for (const auto &ec : input.external_code()) {
+            output.append(ec);
+        }
+        any_strict_float |= input.any_strict_float();
     }
+    output.set_any_strict_float(any_strict_float);
 
     return output;
 }
@@ -829,6 +849,17 @@ void compile_multitarget(const std::string &fn_name,
     std::vector<LoweredArgument> base_target_args;
     std::vector<AutoSchedulerResults> auto_scheduler_results;
 
+    // The LLVM codegen for each sub-target is independent of the
+    // others, so with HL_PARALLEL_LOWERING set we build each
+    // sub-module serially (the module factory shares front-end state
+    // between targets) but defer the calls to Module::compile() and
+    // farm them out to a thread pool afterwards. The active
+    // CompilerLogger is process-global, so if a logger factory is in
+    // use we stay serial to keep each sub-target's records separate.
+    const bool parallel_codegen = !get_env_variable("HL_PARALLEL_LOWERING").empty() &&
+                                  !compiler_logger_factory;
+    std::vector<std::pair<Module, std::map<Output, std::string>>> codegen_jobs;
+
     for (size_t i = 0; i < targets.size(); ++i) {
         const Target &target = targets[i];
 
@@ -887,7 +918,11 @@ void compile_multitarget(const std::string &fn_name,
                 sub_out[Output::compiler_log] = temp_compiler_log_dir.add_temp_file(output_files.at(Output::compiler_log), suffix, target);
             }
             debug(1) << "compile_multitarget: compile_sub_target " << sub_out[Output::object] << "\n";
-            sub_module.compile(sub_out);
+            if (parallel_codegen) {
+                codegen_jobs.emplace_back(sub_module, sub_out);
+            } else {
+                sub_module.compile(sub_out);
+            }
             const auto *r = sub_module.get_auto_scheduler_results();
             auto_scheduler_results.push_back(r ? *r : AutoSchedulerResults());
         }
@@ -920,6 +955,23 @@ void compile_multitarget(const std::string &fn_name,
         wrapper_args.emplace_back(sub_fn_name);
     }
 
+    if (!codegen_jobs.empty()) {
+        // Each Module::compile() creates its own LLVMContext, so the
+        // jobs only share the one-time LLVM initialization (which is
+        // guarded by a call_once).
+        ThreadPool<void> pool(std::min(codegen_jobs.size(), ThreadPool<void>::num_processors_online()));
+        std::vector<std::future<void>> futures;
+        futures.reserve(codegen_jobs.size());
+        for (auto &job : codegen_jobs) {
+            futures.push_back(pool.async([&job]() {
+                job.first.compile(job.second);
+            }));
+        }
+        for (auto &f : futures) {
+            f.get();
+        }
+    }
+
     // If we haven't specified "no runtime", build a runtime with the base target
     // and add that to the result.
     if (!base_target.has_feature(Target::NoRuntime)) {
@@ -1077,4 +1129,157 @@ void compile_multitarget(const std::string &fn_name,
     }
 }
 
+void compile_variants(const std::string &fn_name,
+                      const std::map<Output, std::string> &output_files,
+                      const Target &target,
+                      const std::vector<std::string> &variant_names,
+                      const VariantModuleFactory &module_factory,
+                      const CompilerLoggerFactory &compiler_logger_factory) {
+    validate_outputs(output_files);
+
+    user_assert(!fn_name.empty()) << "Function name must be specified.\n";
+    user_assert(!variant_names.empty()) << "Must specify at least one schedule variant.\n";
+    user_assert(!target.has_feature(Target::JIT)) << "JIT not allowed for compile_variants.\n";
+    std::set<std::string> unique_variants;
+    for (const auto &v : variant_names) {
+        user_assert(!v.empty()) << "Schedule variant names must not be empty.\n";
+        user_assert(unique_variants.insert(v).second)
+            << "Duplicate schedule variant name '" << v << "'.\n";
+    }
+
+    user_assert(((int)contains(output_files, Output::object) + (int)contains(output_files, Output::static_library)) == 1)
+        << "compile_variants() expects exactly one of 'object' and 'static_library' to be specified.\n";
+
+    const auto add_suffixes = [&](const std::map<Output, std::string> &in, const std::string &suffix) -> std::map<Output, std::string> {
+        // is_multi doesn't vary by Target, so we can pass an empty target here safely
+        auto output_info = get_output_info(Target());
+        std::map<Output, std::string> out = in;
+        for (auto &it : out) {
+            if (output_info[it.first].is_multi) {
+                out[it.first] = add_suffix(it.second, suffix);
+            }
+        }
+        return out;
+    };
+
+    TemporaryObjectFileDir temp_obj_dir;
+    std::vector<LoweredArgument> base_args;
+
+    // As in compile_multitarget, each variant is compiled under a
+    // suffixed name, the runtime is produced separately, and Matlab
+    // wrapping belongs on the dispatch wrapper rather than on each
+    // variant.
+    Target sub_fn_target = target
+                               .with_feature(Target::NoRuntime)
+                               .without_feature(Target::Matlab);
+
+    for (const auto &variant : variant_names) {
+        std::string suffix = "-" + variant;
+        std::string sub_fn_name = fn_name + "_" + variant;
+
+        ScopedCompilerLogger activate(compiler_logger_factory, sub_fn_name, sub_fn_target);
+        Module sub_module = module_factory(sub_fn_name, variant, sub_fn_target);
+        // Re-assign every time -- the variants only differ in schedule,
+        // so the argument lists must match.
+        base_args = sub_module.get_function_by_name(sub_fn_name).args;
+
+        auto sub_out = add_suffixes(output_files, suffix);
+        if (contains(output_files, Output::static_library)) {
+            sub_out[Output::object] = temp_obj_dir.add_temp_object_file(output_files.at(Output::static_library), suffix, target);
+            sub_out.erase(Output::static_library);
+        }
+        sub_out.erase(Output::registration);
+        sub_out.erase(Output::schedule);
+        sub_out.erase(Output::c_header);
+        debug(1) << "compile_variants: compile_variant " << sub_out[Output::object] << "\n";
+        sub_module.compile(sub_out);
+    }
+
+    // If we haven't specified "no runtime", build a runtime and add it
+    // to the result.
+    if (!target.has_feature(Target::NoRuntime)) {
+        std::string runtime_path = contains(output_files, Output::static_library) ?
+                                       temp_obj_dir.add_temp_object_file(output_files.at(Output::static_library), "_runtime", target) :
+                                       add_suffix(output_files.at(Output::object), "_runtime");
+
+        std::map<Output, std::string> runtime_out =
+            {{Output::object, runtime_path}};
+        debug(1) << "compile_variants: compile_standalone_runtime " << runtime_out.at(Output::object) << "\n";
+        compile_standalone_runtime(runtime_out, target);
+    }
+
+    // The wrapper takes a leading selector argument and forwards the
+    // rest of its arguments to the chosen variant. Unlike the
+    // multitarget wrapper, the selection varies per call, so this is a
+    // plain if-chain rather than a cached indirect call.
+    const std::string selector_name = "schedule_variant";
+    Expr selector = Variable::make(Int(32), selector_name);
+
+    std::vector<Expr> forwarded_args;
+    for (const auto &arg : base_args) {
+        if (arg.is_buffer()) {
+            forwarded_args.push_back(Variable::make(type_of<struct halide_buffer_t *>(), arg.name + ".buffer"));
+        } else {
+            forwarded_args.push_back(Variable::make(arg.type, arg.name));
+        }
+    }
+
+    Expr in_range = selector >= 0 && selector < (int)variant_names.size();
+    Stmt wrapper_body = AssertStmt::make(
+        in_range, requirement_failed_error(in_range, {StringImm::make("unknown schedule variant selected")}));
+    for (int i = (int)variant_names.size() - 1; i >= 0; i--) {
+        std::string sub_fn_name = fn_name + "_" + variant_names[i];
+        Expr call = Call::make(Int(32), sub_fn_name, forwarded_args, Call::Extern);
+        std::string private_result_name = unique_name(fn_name + "_result");
+        Expr private_result_var = Variable::make(Int(32), private_result_name);
+        Stmt branch = LetStmt::make(private_result_name, call,
+                                    AssertStmt::make(private_result_var == 0, private_result_var));
+        wrapper_body = IfThenElse::make(selector == i, branch, wrapper_body);
+    }
+
+    std::vector<LoweredArgument> wrapper_args;
+    wrapper_args.emplace_back(selector_name, Argument::InputScalar, Int(32), 0, ArgumentEstimates{});
+    wrapper_args.insert(wrapper_args.end(), base_args.begin(), base_args.end());
+
+    // Same target treatment as the multitarget wrapper: no runtime or
+    // bounds queries, but asserts enabled so a nonzero result
+    // propagates, and Matlab wrapping here if requested.
+    Target wrapper_target = target
+                                .with_feature(Target::NoRuntime)
+                                .with_feature(Target::NoBoundsQuery)
+                                .without_feature(Target::NoAsserts);
+
+    Module wrapper_module(fn_name, wrapper_target);
+    wrapper_module.append(LoweredFunc(fn_name, wrapper_args, wrapper_body, LinkageType::ExternalPlusMetadata));
+
+    std::string wrapper_path = contains(output_files, Output::static_library) ?
+                                   temp_obj_dir.add_temp_object_file(output_files.at(Output::static_library), "_wrapper", target, /* in_front*/ true) :
+                                   add_suffix(output_files.at(Output::object), "_wrapper");
+
+    std::map<Output, std::string> wrapper_out = {{Output::object, wrapper_path}};
+    debug(1) << "compile_variants: wrapper " << wrapper_out.at(Output::object) << "\n";
+    wrapper_module.compile(wrapper_out);
+
+    if (contains(output_files, Output::c_header)) {
+        Module header_module(fn_name, target);
+        header_module.append(LoweredFunc(fn_name, wrapper_args, {}, LinkageType::ExternalPlusMetadata));
+        std::map<Output, std::string> header_out = {{Output::c_header, output_files.at(Output::c_header)}};
+        debug(1) << "compile_variants: c_header " << header_out.at(Output::c_header) << "\n";
+        header_module.compile(header_out);
+    }
+
+    if (contains(output_files, Output::registration)) {
+        debug(1) << "compile_variants: registration " << output_files.at(Output::registration) << "\n";
+        Module registration_module(fn_name, target);
+        registration_module.append(LoweredFunc(fn_name, wrapper_args, {}, LinkageType::ExternalPlusMetadata));
+        std::map<Output, std::string> registration_out = {{Output::registration, output_files.at(Output::registration)}};
+        registration_module.compile(registration_out);
+    }
+
+    if (contains(output_files, Output::static_library)) {
+        debug(1) << "compile_variants: static_library " << output_files.at(Output::static_library) << "\n";
+        create_static_library(temp_obj_dir.files(), target, output_files.at(Output::static_library));
+    }
+}
+
 }  // namespace Halide
@@ -201,7 +201,16 @@ public:
     void set_any_strict_float(bool any_strict_float);
 };
 
-/** Link a set of modules together into one module. */
+/** Link a set of modules together into one module. Because every
+ * function of a Module is code-generated into a single LLVM module
+ * that is optimized as a whole, linking lowered Modules before
+ * compiling them is effectively link-time optimization: calls between
+ * the pipelines (e.g. via define_extern) become direct calls into
+ * definitions the inliner can see, instead of opaque symbols resolved
+ * by the system linker. Compile callee pipelines with
+ * LinkageType::Internal to also keep their symbols out of the linked
+ * object. Function and buffer names must be unique across the
+ * modules. */
 Module link_modules(const std::string &name, const std::vector<Module> &modules);
 
 /** Create an object file containing the Halide runtime for a given target. For
@@ -227,6 +236,27 @@ void compile_multitarget(const std::string &fn_name,
                          const ModuleFactory &module_factory,
                          const CompilerLoggerFactory &compiler_logger_factory = nullptr);
 
+using VariantModuleFactory = std::function<Module(const std::string &fn_name, const std::string &variant_name, const Target &target)>;
+
+/** Compile several differently-scheduled variants of one pipeline into
+ * a single object or static library, dispatched at runtime. The module
+ * factory is called once per entry in variant_names and should return
+ * the pipeline scheduled for that variant (e.g. a low-latency schedule
+ * using all cores vs a throughput schedule using few); each variant is
+ * compiled under the name fn_name_<variant>. A wrapper function named
+ * fn_name is also generated, with the same arguments plus a leading
+ * int32 'schedule_variant' argument that selects the variant to run by
+ * its index in variant_names; out-of-range values return an error.
+ * This is the schedule-dispatch analog of compile_multitarget, which
+ * instead selects by the features of the host processor. All variants
+ * share one target (and one copy of the runtime). */
+void compile_variants(const std::string &fn_name,
+                      const std::map<Output, std::string> &output_files,
+                      const Target &target,
+                      const std::vector<std::string> &variant_names,
+                      const VariantModuleFactory &module_factory,
+                      const CompilerLoggerFactory &compiler_logger_factory = nullptr);
+
 }  // namespace Halide
 
 #endif
@@ -15,28 +15,30 @@ ObjectInstanceRegistry &ObjectInstanceRegistry::get_registry() {
 void ObjectInstanceRegistry::register_instance(void *this_ptr, size_t size, Kind kind,
                                                void *subject_ptr, const void *introspection_helper) {
     ObjectInstanceRegistry &registry = get_registry();
-    std::lock_guard<std::mutex> lock(registry.mutex);
     uintptr_t key = (uintptr_t)this_ptr;
-    internal_assert(registry.instances.find(key) == registry.instances.end());
+    Shard &shard = registry.shard_for(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    internal_assert(shard.instances.find(key) == shard.instances.end());
     if (introspection_helper) {
-        registry.instances[key] = InstanceInfo(size, kind, subject_ptr, true);
+        shard.instances[key] = InstanceInfo(size, kind, subject_ptr, true);
         Introspection::register_heap_object(this_ptr, size, introspection_helper);
     } else {
-        registry.instances[key] = InstanceInfo(size, kind, subject_ptr, false);
+        shard.instances[key] = InstanceInfo(size, kind, subject_ptr, false);
     }
 }
 
 /* static */
 void ObjectInstanceRegistry::unregister_instance(void *this_ptr) {
     ObjectInstanceRegistry &registry = get_registry();
-    std::lock_guard<std::mutex> lock(registry.mutex);
     uintptr_t key = (uintptr_t)this_ptr;
-    std::map<uintptr_t, InstanceInfo>::iterator it = registry.instances.find(key);
-    internal_assert(it != registry.instances.end());
+    Shard &shard = registry.shard_for(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    std::map<uintptr_t, InstanceInfo>::iterator it = shard.instances.find(key);
+    internal_assert(it != shard.instances.end());
     if (it->second.registered_for_introspection) {
         Introspection::deregister_heap_object(this_ptr, it->second.size);
     }
-    registry.instances.erase(it);
+    shard.instances.erase(it);
 }
 
 /* static */
@@ -45,20 +47,30 @@ std::vector<void *> ObjectInstanceRegistry::instances_in_range(void *start, size
     std::vector<void *> results;
 
     ObjectInstanceRegistry &registry = get_registry();
-    std::lock_guard<std::mutex> lock(registry.mutex);
-
-    std::map<uintptr_t, InstanceInfo>::const_iterator it =
-        registry.instances.lower_bound((uintptr_t)start);
 
+    // Gather the entries within the range from each shard and merge
+    // them back into address order, so that the container-skipping
+    // logic below sees the same sequence it would with a single map.
     uintptr_t limit_ptr = ((uintptr_t)start) + size;
-    while (it != registry.instances.end() && it->first < limit_ptr) {
+    std::map<uintptr_t, InstanceInfo> in_range;
+    for (auto &shard : registry.shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (std::map<uintptr_t, InstanceInfo>::const_iterator it =
+                 shard.instances.lower_bound((uintptr_t)start);
+             it != shard.instances.end() && it->first < limit_ptr; ++it) {
+            in_range.insert(*it);
+        }
+    }
+
+    std::map<uintptr_t, InstanceInfo>::const_iterator it = in_range.begin();
+    while (it != in_range.end() && it->first < limit_ptr) {
         if (it->second.kind == kind) {
             results.push_back(it->second.subject_ptr);
         }
 
         if (it->first > (uintptr_t)start && it->second.size != 0) {
             // Skip over containers that we enclose
-            it = registry.instances.lower_bound(it->first + it->second.size);
+            it = in_range.lower_bound(it->first + it->second.size);
         } else {
             it++;
         }
@@ -80,8 +80,24 @@ private:
         }
     };
 
-    std::mutex mutex;
-    std::map<uintptr_t, InstanceInfo> instances;
+    // The registry is sharded by address to reduce lock contention:
+    // every Param and GeneratorParam construction takes one of these
+    // locks, which adds up when many threads build pipelines at once.
+    // Queries (instances_in_range) are rare, so they pay the cost of
+    // merging the shards back into address order.
+    static constexpr int num_shards = 16;
+
+    struct Shard {
+        std::mutex mutex;
+        std::map<uintptr_t, InstanceInfo> instances;
+    };
+    Shard shards[num_shards];
+
+    Shard &shard_for(uintptr_t key) {
+        // Hash on bits above the typical allocation alignment so that
+        // distinct objects spread evenly across the shards.
+        return shards[(key >> 6) % num_shards];
+    }
 
     ObjectInstanceRegistry() = default;
 
@@ -92,12 +92,77 @@ private:
     }
 };
 
+// Replace occupancy-block-size placeholders (see
+// Stage::gpu_tile_occupancy) with a fresh variable per stage, to be
+// bound at the launch site to a runtime occupancy query against the
+// kernel the stage compiled to.
+class ResolveOccupancyPlaceholders : public IRMutator {
+    using IRMutator::visit;
+
+    Expr visit(const Call *op) override {
+        if (op->call_type == Call::PureExtern &&
+            op->name == "halide_cuda_occupancy_block_size" &&
+            op->args.size() == 1) {
+            const StringImm *prefix = op->args[0].as<StringImm>();
+            internal_assert(prefix);
+            auto it = vars.find(prefix->value);
+            if (it == vars.end()) {
+                it = vars.emplace(prefix->value,
+                                  unique_name(prefix->value + "occupancy_block_size"))
+                         .first;
+            }
+            return Variable::make(Int(32), it->second);
+        }
+        return IRMutator::visit(op);
+    }
+
+public:
+    // Maps the stage prefix named by each placeholder to the
+    // variable it was replaced with.
+    map<string, string> vars;
+};
+
+// Replace occupancy-block-size placeholders that were hoisted outside
+// the kernel they describe (e.g. into bounds lets) with the same
+// query the launch site uses.
+class ResolveHoistedOccupancyPlaceholders : public IRMutator {
+    using IRMutator::visit;
+
+    const map<string, Expr> &choices;
+
+    Expr visit(const Call *op) override {
+        if (op->call_type == Call::PureExtern &&
+            op->name == "halide_cuda_occupancy_block_size" &&
+            op->args.size() == 1) {
+            const StringImm *prefix = op->args[0].as<StringImm>();
+            internal_assert(prefix);
+            auto it = choices.find(prefix->value);
+            user_assert(it != choices.end())
+                << "A stage with prefix " << prefix->value
+                << " was scheduled with gpu_tile_occupancy, but no CUDA "
+                << "kernel was generated for it.\n";
+            return it->second;
+        }
+        return IRMutator::visit(op);
+    }
+
+public:
+    ResolveHoistedOccupancyPlaceholders(const map<string, Expr> &choices)
+        : choices(choices) {
+    }
+};
+
 class InjectGpuOffload : public IRMutator {
     /** Child code generator for device kernels. */
     map<DeviceAPI, unique_ptr<CodeGen_GPU_Dev>> cgdev;
 
     map<string, bool> state_needed;
 
+    // Maps the stage prefixes named by occupancy-block-size
+    // placeholders to the resolved runtime query for the kernel each
+    // stage landed in.
+    map<string, Expr> occupancy_choices;
+
     const Target &target;
 
     Expr get_state_var(const string &name) {
@@ -136,6 +201,21 @@ class InjectGpuOffload : public IRMutator {
         internal_assert(loop->device_api != DeviceAPI::Default_GPU)
             << "A concrete device API should have been selected before codegen.";
 
+        // Resolve any occupancy-block-size placeholders in the kernel
+        // to variables, so that the launch configuration and the
+        // kernel body both see the value bound at the launch site
+        // below.
+        ResolveOccupancyPlaceholders occupancy;
+        Stmt resolved = occupancy.mutate(loop);
+        if (!occupancy.vars.empty()) {
+            user_assert(loop->device_api == DeviceAPI::CUDA)
+                << "gpu_tile_occupancy was used in a loop scheduled on device "
+                << loop->device_api << "; the occupancy API is only available "
+                << "on CUDA.\n";
+            loop = resolved.as<For>();
+            internal_assert(loop);
+        }
+
         ExtractBounds bounds;
         loop->accept(&bounds);
         debug(2) << "Kernel bounds: ("
@@ -246,7 +326,23 @@ class InjectGpuOffload : public IRMutator {
             Call::make(Handle(), Call::make_struct, args, Call::Intrinsic),
             Call::make(Handle(), Call::make_struct, arg_is_buffer, Call::Intrinsic),
         };
-        return call_extern_and_assert("halide_" + api_unique_name + "_run", run_args);
+        Stmt run = call_extern_and_assert("halide_" + api_unique_name + "_run", run_args);
+
+        // Bind the occupancy block size choices at the launch
+        // site. If several kernels come from the same stage (e.g. via
+        // specializations), the first one's query is reused for all
+        // of them, so every use of a stage's block size agrees.
+        for (const auto &p : occupancy.vars) {
+            auto it = occupancy_choices.find(p.first);
+            if (it == occupancy_choices.end()) {
+                Expr choice = Call::make(Int(32), "halide_cuda_occupancy_block_size",
+                                         {get_state_var(api_unique_name), kernel_name},
+                                         Call::Extern);
+                it = occupancy_choices.emplace(p.first, choice).first;
+            }
+            run = LetStmt::make(p.second, it->second, run);
+        }
+        return run;
     }
 
 public:
@@ -279,6 +375,10 @@ public:
 
         Stmt result = mutate(s);
 
+        // Placeholders that were hoisted above the kernels they came
+        // from (e.g. into bounds lets) still need resolving.
+        result = ResolveHoistedOccupancyPlaceholders(occupancy_choices).mutate(result);
+
         for (auto &i : cgdev) {
             string api_unique_name = i.second->api_unique_name();
 
@@ -11,6 +11,7 @@ namespace Internal {
 struct BufferConstraint {
     Expr min, extent, stride;
     Expr min_estimate, extent_estimate;
+    std::vector<int> hot_extents;
 };
 
 struct ParameterContents {
@@ -224,6 +225,17 @@ void Parameter::set_extent_constraint_estimate(int dim, Expr extent) {
     contents->buffer_constraints[dim].extent_estimate = std::move(extent);
 }
 
+void Parameter::set_hot_extents(int dim, const std::vector<int> &extents) {
+    check_is_buffer();
+    check_dim_ok(dim);
+    for (int e : extents) {
+        user_assert(e > 0)
+            << "Hot extent " << e << " for dimension " << dim
+            << " of Parameter " << name() << " must be positive\n";
+    }
+    contents->buffer_constraints[dim].hot_extents = extents;
+}
+
 void Parameter::set_host_alignment(int bytes) {
     check_is_buffer();
     contents->host_alignment = bytes;
@@ -259,6 +271,12 @@ Expr Parameter::extent_constraint_estimate(int dim) const {
     return contents->buffer_constraints[dim].extent_estimate;
 }
 
+const std::vector<int> &Parameter::hot_extents(int dim) const {
+    check_is_buffer();
+    check_dim_ok(dim);
+    return contents->buffer_constraints[dim].hot_extents;
+}
+
 int Parameter::host_alignment() const {
     check_is_buffer();
     return contents->host_alignment;
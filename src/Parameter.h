@@ -5,6 +5,7 @@
  * Defines the internal representation of parameters to halide piplines
  */
 #include <string>
+#include <vector>
 
 #include "IntrusivePtr.h"
 #include "Type.h"
@@ -130,12 +131,14 @@ public:
     void set_stride_constraint(int dim, Expr e);
     void set_min_constraint_estimate(int dim, Expr min);
     void set_extent_constraint_estimate(int dim, Expr extent);
+    void set_hot_extents(int dim, const std::vector<int> &extents);
     void set_host_alignment(int bytes);
     Expr min_constraint(int dim) const;
     Expr extent_constraint(int dim) const;
     Expr stride_constraint(int dim) const;
     Expr min_constraint_estimate(int dim) const;
     Expr extent_constraint_estimate(int dim) const;
+    const std::vector<int> &hot_extents(int dim) const;
     int host_alignment() const;
     //@}
 
@@ -1,10 +1,12 @@
 #include <algorithm>
+#include <map>
 #include <numeric>
 #include <utility>
 
 #include "CSE.h"
 #include "CodeGen_GPU_Dev.h"
 #include "ExprUsesVar.h"
+#include "Function.h"
 #include "IREquality.h"
 #include "IRMutator.h"
 #include "IROperator.h"
@@ -12,6 +14,7 @@
 #include "Simplify.h"
 #include "Solve.h"
 #include "Substitute.h"
+#include "Util.h"
 #include "Var.h"
 
 namespace Halide {
@@ -466,7 +469,8 @@ public:
 protected:
     using IRVisitor::visit;
     void visit(const Call *op) override {
-        if (op->is_intrinsic(Call::gpu_thread_barrier)) {
+        if (op->is_intrinsic(Call::gpu_thread_barrier) ||
+            op->is_intrinsic(Call::gpu_named_barrier)) {
             result = true;
         } else {
             IRVisitor::visit(op);
@@ -491,20 +495,77 @@ bool contains_warp_synchronous_logic(const Stmt &s) {
     return c.result;
 }
 
+// When enabled, loop partitioning also recurses into the prologue and
+// epilogue it creates, so that (e.g.) the top strip of a 2D boundary
+// condition gets its own inner-dimension partitioning: the result is a
+// set of corner/edge/interior tile kernels in which only the corners
+// retain clamps in every dimension, and each edge strip vectorizes
+// cleanly along its unclamped dimension. Off by default because the
+// number of code versions grows as 3^d in the dimensions partitioned.
+bool partition_edge_tiles() {
+    static bool enabled = !get_env_variable("HL_PARTITION_EDGE_TILES").empty();
+    return enabled;
+}
+
 class PartitionLoops : public IRMutator {
     using IRMutator::visit;
 
     bool in_gpu_loop = false;
 
+    // The number of enclosing loops that have already been partitioned
+    // into prologue/steady-state/epilogue. Used to bound the code-size
+    // blowup when recursing into the prologue and epilogue.
+    int partitioned_depth = 0;
+
+    // The number of enclosing prologue or epilogue sections of loops
+    // that have already been partitioned.
+    int edge_depth = 0;
+
+    // Explicit per-loop policies from the schedule, keyed by loop
+    // name. Loops not in the map use the heuristic.
+    const std::map<std::string, Partition> &policies;
+
+    Partition policy_for(const std::string &loop_name) const {
+        auto it = policies.find(loop_name);
+        return it == policies.end() ? Partition::Auto : it->second;
+    }
+
     Stmt visit(const For *op) override {
         Stmt body = op->body;
 
+        Partition policy = policy_for(op->name);
+
         ScopedValue<bool> old_in_gpu_loop(in_gpu_loop, in_gpu_loop ||
                                                            CodeGen_GPU_Dev::is_gpu_var(op->name));
 
         // If we're inside GPU kernel, and the body contains thread
         // barriers or warp shuffles, it's not safe to partition loops.
         if (in_gpu_loop && contains_warp_synchronous_logic(op)) {
+            user_assert(policy != Partition::Always)
+                << "Loop " << op->name << " was scheduled with Partition::Always, "
+                << "but it cannot be partitioned because it is inside a GPU kernel "
+                << "that contains warp-synchronous logic.\n";
+            return IRMutator::visit(op);
+        }
+
+        if (policy == Partition::Never) {
+            debug(2) << "Loop partitioning: " << op->name
+                     << " not partitioned (scheduled with Partition::Never)\n";
+            return IRMutator::visit(op);
+        }
+
+        // By default, don't try to partition loops inside the
+        // prologue or epilogue of an enclosing partitioned loop - the
+        // number of code versions grows as 3^d in the dimensions
+        // partitioned. Partition::Always overrides this on a per-loop
+        // basis, and HL_PARTITION_EDGE_TILES enables it globally (up
+        // to a depth cap).
+        if (edge_depth > 0 &&
+            policy != Partition::Always &&
+            !(partition_edge_tiles() && partitioned_depth <= 2)) {
+            debug(2) << "Loop partitioning: " << op->name
+                     << " not partitioned (inside the prologue or epilogue of an "
+                     << "enclosing partitioned loop; use Partition::Always to force)\n";
             return IRMutator::visit(op);
         }
 
@@ -513,6 +574,10 @@ class PartitionLoops : public IRMutator {
         body.accept(&finder);
 
         if (finder.simplifications.empty()) {
+            user_assert(policy != Partition::Always)
+                << "Loop " << op->name << " was scheduled with Partition::Always, "
+                << "but there are no likely-tagged boundary conditions in its body "
+                << "that partitioning could simplify.\n";
             return IRMutator::visit(op);
         }
 
@@ -641,8 +706,24 @@ class PartitionLoops : public IRMutator {
         bool make_epilogue = !equal(epilogue, simpler_body);
 
         // Recurse on the middle section.
+        ScopedValue<int> old_depth(partitioned_depth, partitioned_depth + 1);
         simpler_body = mutate(simpler_body);
 
+        // Recurse on the edge sections too. Whether a loop inside
+        // them actually gets partitioned is decided in the recursive
+        // call (see the edge_depth check above): only if it was
+        // scheduled with Partition::Always, or if edge tiles are
+        // enabled globally and we're within the depth cap.
+        {
+            ScopedValue<int> old_edge_depth(edge_depth, edge_depth + 1);
+            if (make_prologue) {
+                prologue = mutate(prologue);
+            }
+            if (make_epilogue) {
+                epilogue = mutate(epilogue);
+            }
+        }
+
         // Construct variables for the bounds of the simplified middle section
         Expr min_steady = op->min, max_steady = op->extent + op->min;
         Expr prologue_val, epilogue_val;
@@ -742,15 +823,35 @@ class PartitionLoops : public IRMutator {
         if (can_prove(epilogue_val <= prologue_val)) {
             // The steady state is empty. I've made a huge
             // mistake. Try to partition a loop further in.
+            user_assert(policy != Partition::Always)
+                << "Loop " << op->name << " was scheduled with Partition::Always, "
+                << "but the steady state after partitioning would be empty.\n";
+            debug(2) << "Loop partitioning: " << op->name
+                     << " not partitioned (the steady state would be empty)\n";
             return IRMutator::visit(op);
         }
 
+        debug(2) << "Loop partitioning: " << op->name
+                 << " partitioned into "
+                 << (make_prologue ? "prologue + " : "")
+                 << "steady state"
+                 << (make_epilogue ? " + epilogue" : "")
+                 << " using " << middle_simps.size()
+                 << " likely-based simplification(s)"
+                 << (policy == Partition::Always ? " (scheduled with Partition::Always)" : "")
+                 << "\n";
+
         debug(3) << "Partition loop.\n"
                  << "Old: " << Stmt(op) << "\n"
                  << "New: " << stmt << "\n";
 
         return stmt;
     }
+
+public:
+    PartitionLoops(const std::map<std::string, Partition> &policies)
+        : policies(policies) {
+    }
 };
 
 class ExprContainsLoad : public IRVisitor {
@@ -1059,9 +1160,41 @@ bool has_likely_tag(const Expr &e) {
     return h.result;
 }
 
-Stmt partition_loops(Stmt s) {
+namespace {
+
+// Collect the explicit partition policies of one definition's dims,
+// keyed by the name each loop has at this point in lowering.
+void gather_partition_policies(const std::string &prefix,
+                               const Definition &def,
+                               std::map<std::string, Partition> &policies) {
+    if (!def.defined()) {
+        return;
+    }
+    for (const Dim &d : def.schedule().dims()) {
+        if (d.partition_policy != Partition::Auto) {
+            policies[prefix + d.var] = d.partition_policy;
+        }
+    }
+    for (const Specialization &s : def.specializations()) {
+        gather_partition_policies(prefix, s.definition, policies);
+    }
+}
+
+}  // namespace
+
+Stmt partition_loops(Stmt s, const std::map<std::string, Function> &env) {
     s = LowerLikelyIfInnermost().mutate(s);
 
+    std::map<std::string, Partition> policies;
+    for (const auto &p : env) {
+        const Function &f = p.second;
+        gather_partition_policies(f.name() + ".s0.", f.definition(), policies);
+        for (size_t i = 0; i < f.updates().size(); i++) {
+            gather_partition_policies(f.name() + ".s" + std::to_string(i + 1) + ".",
+                                      f.updates()[i], policies);
+        }
+    }
+
     // Walk inwards to the first loop before doing any more work.
     class Mutator : public IRMutator {
         using IRMutator::visit;
@@ -1069,12 +1202,19 @@ Stmt partition_loops(Stmt s) {
             Stmt s = op;
             s = MarkClampedRampsAsLikely().mutate(s);
             s = ExpandSelects().mutate(s);
-            s = PartitionLoops().mutate(s);
+            s = PartitionLoops(policies).mutate(s);
             s = RenormalizeGPULoops().mutate(s);
             s = CollapseSelects().mutate(s);
             return s;
         }
-    } mutator;
+
+        const std::map<std::string, Partition> &policies;
+
+    public:
+        Mutator(const std::map<std::string, Partition> &policies)
+            : policies(policies) {
+        }
+    } mutator{policies};
     s = mutator.mutate(s);
 
     s = remove_likelies(s);
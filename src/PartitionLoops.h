@@ -7,11 +7,16 @@
  * steady-stage, and an epilogue.
  */
 
+#include <map>
+#include <string>
+
 #include "Expr.h"
 
 namespace Halide {
 namespace Internal {
 
+class Function;
+
 /** Return true if an expression uses a likely tag that isn't captured
  * by an enclosing Select, Min, or Max. */
 bool has_uncaptured_likely_tag(const Expr &e);
@@ -21,8 +26,10 @@ bool has_likely_tag(const Expr &e);
 
 /** Partitions loop bodies into a prologue, a steady state, and an
  * epilogue. Finds the steady state by hunting for use of clamped
- * ramps, or the 'likely' intrinsic. */
-Stmt partition_loops(Stmt s);
+ * ramps, or the 'likely' intrinsic. Loops scheduled with an explicit
+ * partition policy (see Func::partition) are handled as directed
+ * instead of heuristically. */
+Stmt partition_loops(Stmt s, const std::map<std::string, Function> &env);
 
 }  // namespace Internal
 }  // namespace Halide
@@ -0,0 +1,157 @@
+#include "PersistentState.h"
+#include "Function.h"
+#include "IRMutator.h"
+#include "IROperator.h"
+#include "Schedule.h"
+
+namespace Halide {
+namespace Internal {
+
+namespace {
+
+// Clamp the named produce loop to start at first_invalid, so slices
+// restored from the previous invocation are not recomputed. Only
+// fires on an exact name match: if the outermost storage dimension
+// has been split or renamed the loop is left alone, and the restored
+// slices are simply recomputed.
+class ClampProduceLoop : public IRMutator {
+    const std::string &loop_name;
+    const Expr &first_invalid;
+
+    using IRMutator::visit;
+
+    Stmt visit(const For *op) override {
+        if (op->name == loop_name) {
+            Expr new_min = max(op->min, first_invalid);
+            Expr new_extent = max(op->min + op->extent - new_min, 0);
+            return For::make(op->name, new_min, new_extent,
+                             op->for_type, op->device_api, op->body);
+        }
+        return IRMutator::visit(op);
+    }
+
+public:
+    ClampProduceLoop(const std::string &loop_name, const Expr &first_invalid)
+        : loop_name(loop_name), first_invalid(first_invalid) {
+    }
+};
+
+class InjectPersistentState : public IRMutator {
+public:
+    const std::map<std::string, Function> &env;
+    const std::string &top_level_name;
+    const std::vector<Function> &outputs;
+
+    InjectPersistentState(const std::map<std::string, Function> &e,
+                          const std::string &name,
+                          const std::vector<Function> &outputs)
+        : env(e), top_level_name(name), outputs(outputs) {
+    }
+
+private:
+    using IRMutator::visit;
+
+    Stmt visit(const Realize *op) override {
+        std::map<std::string, Function>::const_iterator iter = env.find(op->name);
+        if (iter == env.end() ||
+            !iter->second.schedule().store_persistent()) {
+            return IRMutator::visit(op);
+        }
+
+        const Function &f = iter->second;
+
+        for (const Function &o : outputs) {
+            if (f.same_as(o)) {
+                user_error << "Function " << f.name() << " cannot be store_persistent because "
+                           << "it is an output of pipeline " << top_level_name << ".\n";
+            }
+        }
+
+        // Restoring happens once per invocation, at the scope of the
+        // allocation, so the storage and compute must both be at
+        // root: anything computed inside a loop would see state from
+        // mid-way through the previous invocation.
+        if (!f.schedule().store_level().is_root() ||
+            !f.schedule().compute_level().is_root()) {
+            user_error << "Function " << f.name() << " cannot be store_persistent because "
+                       << "it is not scheduled compute_root.\n";
+        }
+
+        // Restored slices are not re-produced, so a Func with update
+        // definitions would have its updates applied again to state
+        // they already transformed.
+        if (f.has_update_definition()) {
+            user_error << "Function " << f.name() << " cannot be store_persistent because "
+                       << "it has update definitions.\n";
+        }
+
+        if (f.outputs() != 1) {
+            user_error << "Function " << f.name() << " cannot be store_persistent because "
+                       << "it has a Tuple value.\n";
+        }
+
+        Stmt mutated_body = mutate(op->body);
+
+        // Restore the previously-computed slices into the freshly
+        // allocated buffer and learn the first coordinate along the
+        // outermost storage dimension that still needs computing.
+        Expr acquire = Call::make(Int(32), "halide_persistent_state_acquire",
+                                  {persistent_state_key(op->name),
+                                   Variable::make(type_of<halide_buffer_t *>(), op->name + ".buffer")},
+                                  Call::Extern);
+        Stmt body = LetStmt::make(op->name + ".persistent_first_invalid", acquire, mutated_body);
+
+        return Realize::make(op->name, op->types, op->memory_type, op->bounds, op->condition, body);
+    }
+
+    Stmt visit(const ProducerConsumer *op) override {
+        std::map<std::string, Function>::const_iterator iter = env.find(op->name);
+        if (iter == env.end() ||
+            !iter->second.schedule().store_persistent()) {
+            return IRMutator::visit(op);
+        }
+
+        // The error checking was done at the Realize node for this
+        // producer, so no need to repeat it here.
+
+        Stmt body = mutate(op->body);
+
+        if (op->is_producer) {
+            const Function &f = iter->second;
+            std::string dim = f.schedule().storage_dims().back().var;
+            Expr first_invalid = Variable::make(Int(32), op->name + ".persistent_first_invalid");
+            body = ClampProduceLoop(op->name + ".s0." + dim, first_invalid).mutate(body);
+        } else {
+            // Record the computed contents and bounds for the next
+            // invocation before the consumers run, in case a
+            // consumer faults.
+            Stmt store_back =
+                Evaluate::make(Call::make(Int(32), "halide_persistent_state_store",
+                                          {persistent_state_key(op->name),
+                                           Variable::make(type_of<halide_buffer_t *>(), op->name + ".buffer")},
+                                          Call::Extern));
+            body = Block::make(store_back, body);
+        }
+        return ProducerConsumer::make(op->name, op->is_producer, body);
+    }
+
+    // The runtime keys retained state on the contents of this
+    // string. Func names are already uniquified per pipeline, so
+    // recompiling the same pipeline (e.g. under the JIT) finds its
+    // state again, and distinct pipelines do not collide.
+    Expr persistent_state_key(const std::string &func_name) const {
+        return StringImm::make(top_level_name + ":" + func_name);
+    }
+};
+
+}  // namespace
+
+Stmt inject_persistent_state(const Stmt &s, const std::map<std::string, Function> &env,
+                             const std::string &name,
+                             const std::vector<Function> &outputs) {
+    InjectPersistentState injector(env, name, outputs);
+    return injector.mutate(s);
+}
+
+}  // namespace Internal
+}  // namespace Halide
@@ -0,0 +1,35 @@
+#ifndef HALIDE_PERSISTENT_STATE_H
+#define HALIDE_PERSISTENT_STATE_H
+
+/** \file
+ *
+ * Defines the lowering pass that keeps the storage of Funcs
+ * scheduled with Func::store_persistent alive across pipeline
+ * invocations.
+ */
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Expr.h"
+
+namespace Halide {
+namespace Internal {
+
+class Function;
+
+/** Wrap the realizations of Funcs scheduled with
+ * Func::store_persistent with runtime calls that restore the slices
+ * computed by the previous invocation and record the slices computed
+ * by this one. The produce loop over the outermost storage dimension
+ * is clamped to start after the restored slices, so only the delta
+ * region is recomputed. */
+Stmt inject_persistent_state(const Stmt &s, const std::map<std::string, Function> &env,
+                             const std::string &name,
+                             const std::vector<Function> &outputs);
+
+}  // namespace Internal
+}  // namespace Halide
+
+#endif
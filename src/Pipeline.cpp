@@ -1,12 +1,20 @@
 #include <algorithm>
 #include <atomic>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <set>
 #include <utility>
 
+#include "AffineAccessDescriptors.h"
 #include "Argument.h"
 #include "CodeGen_Internal.h"
 #include "FindCalls.h"
 #include "Func.h"
+#include "IREquality.h"
+#include "IRMutator.h"
 #include "IRVisitor.h"
+#include "ImageParam.h"
 #include "InferArguments.h"
 #include "LLVM_Output.h"
 #include "Lower.h"
@@ -15,6 +23,9 @@
 #include "Pipeline.h"
 #include "PrintLoopNest.h"
 #include "RealizationOrder.h"
+#include "RegionCosts.h"
+#include "Simplify.h"
+#include "ThreadPool.h"
 #include "WasmExecutor.h"
 
 using namespace Halide::Internal;
@@ -59,6 +70,108 @@ std::map<Output, std::string> object_file_outputs(const string &filename_prefix,
     return outputs;
 }
 
+// State for Pipeline::set_jit_workspace. There is one process-wide
+// arena; each Pipeline opts in to allocating from it. Intermediates
+// are bump-allocated from the arena and the whole arena recycles once
+// every outstanding allocation has been freed, which in steady state
+// means one trivial reset per realization and no allocator traffic.
+struct WorkspaceArena {
+    uint8_t *base = nullptr;
+    uint64_t size = 0;
+    uint64_t cursor = 0;
+    // Outstanding allocations served from the arena.
+    uint64_t live = 0;
+    // Bytes currently live in fallback (non-arena) allocations.
+    uint64_t fallback_bytes = 0;
+    // High-water mark of arena cursor plus fallback bytes.
+    uint64_t peak = 0;
+};
+WorkspaceArena workspace_arena;
+std::mutex workspace_arena_mutex;
+
+// halide_malloc requires 32-byte alignment and permits reads slightly
+// out of bounds; match the default allocator's more generous margin.
+constexpr uint64_t workspace_alignment = 128;
+
+void *workspace_malloc(void *user_context, size_t bytes) {
+    std::lock_guard<std::mutex> lock(workspace_arena_mutex);
+    WorkspaceArena &a = workspace_arena;
+    uint64_t start = (a.cursor + workspace_alignment - 1) & ~(workspace_alignment - 1);
+    if (a.base && start + bytes + workspace_alignment <= a.size) {
+        a.cursor = start + bytes + workspace_alignment;
+        a.live++;
+        a.peak = std::max(a.peak, a.cursor + a.fallback_bytes);
+        return a.base + start;
+    }
+    // Arena exhausted (or none set): fall back to the system
+    // allocator, aligning manually and stashing the original pointer
+    // and size just below the aligned address.
+    void *orig = malloc(bytes + 2 * workspace_alignment);
+    if (!orig) {
+        return nullptr;
+    }
+    uintptr_t aligned = ((uintptr_t)orig + workspace_alignment) & ~(uintptr_t)(workspace_alignment - 1);
+    ((void **)aligned)[-1] = orig;
+    ((uint64_t *)aligned)[-2] = bytes;
+    a.fallback_bytes += bytes;
+    a.peak = std::max(a.peak, a.cursor + a.fallback_bytes);
+    return (void *)aligned;
+}
+
+void workspace_free(void *user_context, void *ptr) {
+    if (!ptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(workspace_arena_mutex);
+    WorkspaceArena &a = workspace_arena;
+    uint8_t *p = (uint8_t *)ptr;
+    if (a.base && p >= a.base && p < a.base + a.size) {
+        internal_assert(a.live > 0);
+        if (--a.live == 0) {
+            // Everything handed out has come back; recycle the whole
+            // arena for the next realization.
+            a.cursor = 0;
+        }
+        return;
+    }
+    a.fallback_bytes -= ((uint64_t *)ptr)[-2];
+    free(((void **)ptr)[-1]);
+}
+
+// Sums the sizes of the statically-sized heap allocations in lowered
+// code. Sets unknown if any internal allocation's size can't be known
+// until runtime.
+class SumAllocationFootprint : public IRVisitor {
+    using IRVisitor::visit;
+
+    void visit(const Allocate *op) override {
+        IRVisitor::visit(op);
+        if (op->new_expr.defined() ||
+            (op->memory_type != MemoryType::Auto &&
+             op->memory_type != MemoryType::Heap)) {
+            return;
+        }
+        int64_t size = op->constant_allocation_size();
+        if (size == 0) {
+            unknown = true;
+            return;
+        }
+        int64_t bytes = size * op->type.bytes();
+        if (op->memory_type == MemoryType::Auto &&
+            can_allocation_fit_on_stack(bytes)) {
+            // Will be lowered to an alloca, not a heap allocation.
+            return;
+        }
+        // Per-allocation alignment padding, as the workspace arena
+        // would apply.
+        total += ((uint64_t)bytes + 2 * workspace_alignment - 1) & ~(workspace_alignment - 1);
+    }
+
+public:
+    uint64_t total = 0;
+    bool unknown = false;
+};
+
 }  // namespace
 
 struct PipelineContents {
@@ -77,15 +190,48 @@ struct PipelineContents {
     // Cached compiled JavaScript and/or wasm if defined */
     WasmModule wasm_module;
 
-    /** Clear all cached state */
+    /** Clear all cached state. Note that the lowered module cache
+     * survives: its entries are keyed on the full schedule state, so a
+     * schedule change simply misses in it, and the algorithm cannot
+     * change once the Pipeline's outputs are frozen. */
     void invalidate_cache() {
         module = Module("", Target());
         jit_module = JITModule();
         jit_target = Target();
         inferred_args.clear();
         wasm_module = WasmModule();
+        trusted_shapes.clear();
+        unchecked_variant = Pipeline();
+        // Baked parameter/value registrations survive, but their
+        // compiled variants must be rebuilt.
+        for (auto &b : baked_variants) {
+            b.variant = Pipeline();
+        }
     }
 
+    /** For Pipeline::trusted_realize: signatures of argument sets
+     * that have already passed the full checks, and a variant of the
+     * pipeline compiled without them to dispatch those calls to. */
+    std::set<uint64_t> trusted_shapes;
+    Pipeline unchecked_variant;
+
+    /** For Pipeline::bake: parameter/value pairs to specialize on,
+     * each with a variant of the pipeline compiled with that value
+     * substituted as a constant. Variants are compiled lazily on the
+     * first realize() call that matches them. */
+    struct BakedVariant {
+        Parameter param;
+        Expr value;
+        Pipeline variant;
+    };
+    std::vector<BakedVariant> baked_variants;
+
+    /** When incremental lowering is enabled, previously lowered
+     * modules, keyed on a fingerprint of the schedule state they were
+     * lowered with. */
+    bool incremental_lowering = false;
+    std::map<string, Module> lowered_module_cache;
+
     // The outputs
     vector<Function> outputs;
 
@@ -316,6 +462,18 @@ void Pipeline::print_loop_nest() {
     debug(0) << Halide::Internal::print_loop_nest(contents->outputs);
 }
 
+void Pipeline::print_performance_report(const MachineParams &arch_params) {
+    user_assert(defined()) << "Can't print performance report of undefined Pipeline.\n";
+    std::map<string, Function> env;
+    for (const Function &f : contents->outputs) {
+        std::map<string, Function> more_funcs = find_transitive_calls(f);
+        env.insert(more_funcs.begin(), more_funcs.end());
+    }
+    vector<string> order = realization_order(contents->outputs, env).first;
+    debug(0) << Halide::Internal::print_performance_report(contents->outputs, env, order,
+                                                           arch_params.last_level_cache_size);
+}
+
 void Pipeline::compile_to_lowered_stmt(const string &filename,
                                        const vector<Argument> &args,
                                        StmtOutputFormat fmt,
@@ -324,6 +482,18 @@ void Pipeline::compile_to_lowered_stmt(const string &filename,
     m.compile(single_output(filename, m, fmt == HTML ? Output::stmt_html : Output::stmt));
 }
 
+void Pipeline::compile_to_access_descriptors(const string &filename,
+                                             const vector<Argument> &args,
+                                             const std::string &fn_name,
+                                             const Target &target) {
+    Module m = compile_to_module(args, fn_name, target);
+    std::ofstream out(filename);
+    user_assert(!out.fail()) << "Unable to open file for writing: " << filename << "\n";
+    for (const auto &f : m.functions()) {
+        write_affine_access_descriptors(out, f.name, extract_affine_access_descriptors(f.body));
+    }
+}
+
 void Pipeline::compile_to_static_library(const string &filename_prefix,
                                          const vector<Argument> &args,
                                          const std::string &fn_name,
@@ -451,6 +621,135 @@ vector<Argument> Pipeline::infer_arguments() {
     return infer_arguments(Stmt());
 }
 
+namespace {
+
+// Serialize the complete schedule state of a pipeline into a string,
+// for use as a key in the lowered module cache. Two pipelines over the
+// same (frozen) algorithm that produce the same fingerprint must lower
+// to the same module.
+
+void fingerprint_loop_level(std::ostream &o, const LoopLevel &l) {
+    o << l.to_string_unlocked() << "|";
+}
+
+void fingerprint_stage_schedule(std::ostream &o, const StageSchedule &s) {
+    for (const ReductionVariable &r : s.rvars()) {
+        o << "rvar:" << r.var << "," << r.min << "," << r.extent << "|";
+    }
+    for (const Split &sp : s.splits()) {
+        o << "split:" << sp.old_var << "," << sp.outer << "," << sp.inner << ","
+          << sp.factor << "," << sp.exact << "," << (int)sp.tail << ","
+          << (int)sp.split_type << "|";
+    }
+    for (const Dim &d : s.dims()) {
+        o << "dim:" << d.var << "," << (int)d.for_type << ","
+          << (int)d.device_api << "," << (int)d.dim_type << "|";
+    }
+    for (const PrefetchDirective &p : s.prefetches()) {
+        o << "prefetch:" << p.name << "," << p.var << "," << p.offset << ","
+          << (int)p.strategy << "," << p.adaptive << "|";
+    }
+    for (const PipelineLoopDirective &p : s.pipeline_loops()) {
+        o << "pipeline_loop:" << p.var << "," << p.stages << "|";
+    }
+    for (const Expr &c : s.skip_conditions()) {
+        o << "skip_when:" << c << "|";
+    }
+    o << "fuse:";
+    fingerprint_loop_level(o, s.fuse_level().level);
+    for (const auto &a : s.fuse_level().align) {
+        o << a.first << "," << (int)a.second << ";";
+    }
+    for (const FusedPair &p : s.fused_pairs()) {
+        o << "fused:" << p.func_1 << "," << p.stage_1 << "," << p.func_2 << ","
+          << p.stage_2 << "," << p.var_name << "|";
+    }
+    o << "flags:" << s.allow_race_conditions() << s.atomic()
+      << s.override_atomic_associativity_test() << "|";
+}
+
+void fingerprint_definition(std::ostream &o, const Definition &d) {
+    fingerprint_stage_schedule(o, d.schedule());
+    for (const Specialization &sp : d.specializations()) {
+        o << "spec:" << sp.condition << "{";
+        fingerprint_definition(o, sp.definition);
+        o << "}";
+    }
+}
+
+void fingerprint_func_schedule(std::ostream &o, const FuncSchedule &s) {
+    o << "memoized:" << s.memoized() << "," << s.memoize_eviction_key()
+      << "|async:" << s.async()
+      << "|ring_buffer:" << s.ring_buffer()
+      << "|memory_type:" << (int)s.memory_type()
+      << "|store:";
+    fingerprint_loop_level(o, s.store_level());
+    o << "compute:";
+    fingerprint_loop_level(o, s.compute_level());
+    for (const StorageDim &d : s.storage_dims()) {
+        o << "storage:" << d.var << "," << d.alignment << "," << d.fold_factor
+          << "," << d.fold_forward << "," << d.interleave_lanes << "|";
+    }
+    for (const Bound &b : s.bounds()) {
+        o << "bound:" << b.var << "," << b.min << "," << b.extent << ","
+          << b.modulus << "," << b.remainder << "|";
+    }
+    for (const Bound &b : s.estimates()) {
+        o << "estimate:" << b.var << "," << b.min << "," << b.extent << "|";
+    }
+    for (const auto &w : s.wrappers()) {
+        o << "wrapper:" << w.first << "|";
+    }
+}
+
+string compute_schedule_fingerprint(const vector<Function> &outputs,
+                                    const string &fn_name,
+                                    const Target &target,
+                                    const vector<Argument> &args,
+                                    LinkageType linkage_type,
+                                    const vector<Stmt> &requirements,
+                                    bool trace_pipeline,
+                                    size_t num_custom_passes) {
+    std::ostringstream o;
+    o << fn_name << "|" << target.to_string() << "|" << (int)linkage_type
+      << "|trace:" << trace_pipeline
+      << "|custom_passes:" << num_custom_passes << "|";
+    for (const Argument &a : args) {
+        o << "arg:" << a.name << "," << (int)a.kind << "," << a.type << ","
+          << a.dimensions << "|";
+    }
+    for (const Stmt &r : requirements) {
+        o << "require:" << r;
+    }
+    std::map<string, Function> env;
+    for (const Function &f : outputs) {
+        populate_environment(f, env);
+    }
+    for (const auto &it : env) {
+        const Function &f = it.second;
+        o << "func:" << f.name() << "{";
+        fingerprint_func_schedule(o, f.schedule());
+        if (f.has_pure_definition()) {
+            fingerprint_definition(o, f.definition());
+        }
+        for (const Definition &u : f.updates()) {
+            fingerprint_definition(o, u);
+        }
+        o << "}";
+    }
+    return o.str();
+}
+
+}  // namespace
+
+void Pipeline::set_incremental_lowering(bool enable) {
+    user_assert(defined()) << "Pipeline is undefined\n";
+    contents->incremental_lowering = enable;
+    if (!enable) {
+        contents->lowered_module_cache.clear();
+    }
+}
+
 Module Pipeline::compile_to_module(const vector<Argument> &args,
                                    const string &fn_name,
                                    const Target &target,
@@ -510,6 +809,20 @@ Module Pipeline::compile_to_module(const vector<Argument> &args,
         // We can avoid relowering and just reuse the existing module.
         debug(2) << "Reusing old module\n";
     } else {
+        string fingerprint;
+        if (contents->incremental_lowering) {
+            fingerprint = compute_schedule_fingerprint(
+                contents->outputs, new_fn_name, target, lowering_args,
+                linkage_type, contents->requirements, contents->trace_pipeline,
+                contents->custom_lowering_passes.size());
+            auto cached = contents->lowered_module_cache.find(fingerprint);
+            if (cached != contents->lowered_module_cache.end()) {
+                debug(2) << "Reusing lowered module for previously-seen schedule state\n";
+                contents->module = cached->second;
+                return contents->module;
+            }
+        }
+
         vector<IRMutator *> custom_passes;
         for (const CustomLoweringPass &p : contents->custom_lowering_passes) {
             custom_passes.push_back(p.pass);
@@ -518,6 +831,10 @@ Module Pipeline::compile_to_module(const vector<Argument> &args,
         contents->module = lower(contents->outputs, new_fn_name, target, lowering_args,
                                  linkage_type, contents->requirements, contents->trace_pipeline,
                                  custom_passes);
+
+        if (!fingerprint.empty()) {
+            contents->lowered_module_cache.emplace(fingerprint, contents->module);
+        }
     }
 
     return contents->module;
@@ -551,6 +868,30 @@ Target Pipeline::get_compiled_jit_target() const {
     return contents->jit_target;
 }
 
+namespace {
+
+// Whether to JIT in two tiers: an unoptimized version that is ready
+// almost immediately serves the first calls while the fully optimized
+// version is built on a background thread. Enabled by setting
+// HL_JIT_TIERED to a non-zero value. Disabled under the sanitizers,
+// which rely on instrumentation passes that the fast tier skips.
+bool use_tiered_jit(const Target &target) {
+    string tiered_str = get_env_variable("HL_JIT_TIERED");
+    return !tiered_str.empty() && tiered_str != "0" &&
+           !target.has_feature(Target::ASAN) &&
+           !target.has_feature(Target::MSAN) &&
+           !target.has_feature(Target::TSAN);
+}
+
+// The threads used by compile_jit_async. Deliberately leaked: joining
+// them from a static destructor deadlocks on some platforms.
+ThreadPool<void> &jit_compile_pool() {
+    static ThreadPool<void> *pool = new ThreadPool<void>();
+    return *pool;
+}
+
+}  // namespace
+
 void Pipeline::compile_jit(const Target &target_arg) {
     user_assert(defined()) << "Pipeline is undefined\n";
     user_assert(!target_arg.has_unknowns()) << "Cannot compile_jit() for target '" << target_arg << "'\n";
@@ -623,7 +964,7 @@ void Pipeline::compile_jit(const Target &target_arg) {
     auto f = module.get_function_by_name(name);
 
     // Compile to jit module
-    JITModule jit_module(module, f, make_externs_jit_module(target_arg, lowered_externs));
+    JITModule jit_module(module, f, make_externs_jit_module(target_arg, lowered_externs), use_tiered_jit(target));
 
     // Dump bitcode to a file if the environment variable
     // HL_GENBITCODE is defined to a nonzero value.
@@ -640,6 +981,54 @@ void Pipeline::compile_jit(const Target &target_arg) {
     contents->jit_module = jit_module;
 }
 
+std::future<void> Pipeline::compile_jit_async(const Target &target_arg) {
+    user_assert(defined()) << "Pipeline is undefined\n";
+    user_assert(!target_arg.has_unknowns()) << "Cannot compile_jit_async() for target '" << target_arg << "'\n";
+    user_assert(target_arg.arch != Target::WebAssembly)
+        << "compile_jit_async() does not support WebAssembly targets; use compile_jit().\n";
+
+    Target target(target_arg);
+    target.set_feature(Target::JIT);
+    target.set_feature(Target::UserContext);
+
+    // If we're already compiled for this target, the future is ready now.
+    if (get_compiled_jit_target() == target) {
+        std::promise<void> done;
+        done.set_value();
+        return done.get_future();
+    }
+
+    debug(2) << "async jit-compiling for: " << target_arg << "\n";
+
+    contents->invalidate_cache();
+
+    // The front end runs here, on the calling thread: lowering shares
+    // state between pipelines (including any extern pipelines it pulls
+    // in), so only the LLVM work below is farmed out.
+    infer_arguments();
+    vector<Argument> args;
+    for (const InferredArgument &arg : contents->inferred_args) {
+        args.push_back(arg.arg);
+    }
+    string name = generate_function_name();
+    Module module = compile_to_module(args, name, target).resolve_submodules();
+    std::map<std::string, JITExtern> lowered_externs = contents->jit_externs;
+    std::vector<JITModule> externs_jit_module = make_externs_jit_module(target_arg, lowered_externs);
+
+    // The copied Pipeline handle keeps contents alive until the
+    // compiled code has been installed.
+    Pipeline self = *this;
+    const bool tiered = use_tiered_jit(target);
+    return jit_compile_pool().async([self, module, name, externs_jit_module, target, tiered]() mutable {
+        auto f = module.get_function_by_name(name);
+        JITModule jit_module(module, f, externs_jit_module, tiered);
+        self.contents->jit_module = jit_module;
+        // Set last: the pipeline is treated as compiled once the
+        // target is recorded.
+        self.contents->jit_target = target;
+    });
+}
+
 void Pipeline::set_error_handler(void (*handler)(void *, const char *)) {
     user_assert(defined()) << "Pipeline is undefined\n";
     contents->jit_handlers.custom_error = handler;
@@ -652,6 +1041,39 @@ void Pipeline::set_custom_allocator(void *(*cust_malloc)(void *, size_t),
     contents->jit_handlers.custom_free = cust_free;
 }
 
+void Pipeline::set_jit_workspace(void *base, uint64_t size_in_bytes) {
+    user_assert(defined()) << "Pipeline is undefined\n";
+    user_assert(base != nullptr || size_in_bytes == 0)
+        << "A null workspace must have zero size\n";
+    {
+        std::lock_guard<std::mutex> lock(workspace_arena_mutex);
+        user_assert(workspace_arena.live == 0)
+            << "Cannot replace the jit workspace while allocations from it are live\n";
+        workspace_arena.base = (uint8_t *)base;
+        workspace_arena.size = size_in_bytes;
+        workspace_arena.cursor = 0;
+    }
+    set_custom_allocator(workspace_malloc, workspace_free);
+}
+
+uint64_t Pipeline::jit_workspace_peak() {
+    std::lock_guard<std::mutex> lock(workspace_arena_mutex);
+    return workspace_arena.peak;
+}
+
+uint64_t Pipeline::infer_intermediate_footprint(const Target &target) {
+    user_assert(defined()) << "Pipeline is undefined\n";
+    Module m = compile_to_module(infer_arguments(), generate_function_name(), target);
+    SumAllocationFootprint footprint;
+    for (const auto &f : m.functions()) {
+        f.body.accept(&footprint);
+    }
+    if (footprint.unknown) {
+        return 0;
+    }
+    return footprint.total;
+}
+
 void Pipeline::set_custom_do_par_for(int (*cust_do_par_for)(void *, int (*)(void *, int, uint8_t *), int, int, uint8_t *)) {
     user_assert(defined()) << "Pipeline is undefined\n";
     contents->jit_handlers.custom_do_par_for = cust_do_par_for;
@@ -707,8 +1129,35 @@ const JITHandlers &Pipeline::jit_handlers() {
     return contents->jit_handlers;
 }
 
+void CancellationToken::cancel() {
+    cancel_requested = true;
+    // Set the flag in the runtime and wake any sleeping thread pool
+    // threads. This is a no-op if no JIT runtime exists yet; realize
+    // replays the request when it registers the token.
+    JITSharedRuntime::cancel(&contents);
+}
+
+bool CancellationToken::cancelled() const {
+    return cancel_requested.load();
+}
+
+void CancellationToken::set_deadline(int64_t budget_ns) {
+    deadline_budget_ns = budget_ns > 0 ? budget_ns : 0;
+}
+
+bool CancellationToken::deadline_progress(int *first_skipped) const {
+    return JITSharedRuntime::deadline_progress(
+        const_cast<halide_cancellation_token_t *>(&contents), first_skipped);
+}
+
+void CancellationToken::reset() {
+    cancel_requested = false;
+    JITSharedRuntime::cancellation_token_init(&contents);
+}
+
 Realization Pipeline::realize(vector<int32_t> sizes, const Target &target,
-                              const ParamMap &param_map) {
+                              const ParamMap &param_map,
+                              CancellationToken *cancellation_token) {
     user_assert(defined()) << "Pipeline is undefined\n";
     vector<Buffer<>> bufs;
     for (auto &out : contents->outputs) {
@@ -727,7 +1176,7 @@ Realization Pipeline::realize(vector<int32_t> sizes, const Target &target,
         r[i].allocate();
     }
     // Do the actual computation
-    realize(r, target, param_map);
+    realize(r, target, param_map, cancellation_token);
 
     // Crop back to the requested size if necessary
     bool needs_crop = false;
@@ -1057,11 +1506,79 @@ int Pipeline::call_jit_code(const Target &target, const JITCallArgs &args) {
     return contents->jit_module.argv_function()(args.store);
 }
 
+namespace {
+
+// For Pipeline::bake: a custom lowering pass that rewrites every use
+// of one scalar parameter to a literal constant, then re-simplifies
+// the whole stmt so the constant propagates into loop bounds, LUT
+// contents, and anything else derived from the parameter. Because
+// this runs before the lowered stmt's arguments are inferred, the
+// parameter also vanishes from the variant's argument list.
+class BakeParamValue : public IRMutator {
+    using IRMutator::visit;
+
+    Expr visit(const Variable *op) override {
+        if (op->param.defined() && op->param.name() == param.name()) {
+            return value;
+        }
+        return op;
+    }
+
+    Stmt mutate(const Stmt &s) override {
+        if (nested) {
+            return IRMutator::mutate(s);
+        }
+        nested = true;
+        Stmt result = simplify(IRMutator::mutate(s));
+        nested = false;
+        return result;
+    }
+
+    using IRMutator::mutate;
+
+    Parameter param;
+    Expr value;
+    bool nested = false;
+
+public:
+    BakeParamValue(Parameter param, Expr value)
+        : param(std::move(param)), value(std::move(value)) {
+    }
+};
+
+}  // namespace
+
 void Pipeline::realize(RealizationArg outputs, const Target &t,
-                       const ParamMap &param_map) {
+                       const ParamMap &param_map,
+                       CancellationToken *cancellation_token) {
     Target target = t;
     user_assert(defined()) << "Can't realize an undefined Pipeline\n";
 
+    // If a parameter is currently bound to a value it has been baked
+    // for, dispatch to the variant specialized on that value. Calls
+    // that remap parameters always use the generic pipeline, since
+    // the ParamMap may rebind the baked parameter.
+    if (!contents->baked_variants.empty() && param_map.size() == 0) {
+        for (auto &b : contents->baked_variants) {
+            if (!equal(b.param.scalar_expr(), b.value)) {
+                continue;
+            }
+            if (!b.variant.defined()) {
+                vector<Func> outs;
+                outs.reserve(contents->outputs.size());
+                for (const Function &f : contents->outputs) {
+                    outs.emplace_back(f);
+                }
+                b.variant = Pipeline(outs);
+                b.variant.contents->jit_handlers = contents->jit_handlers;
+                b.variant.contents->jit_externs = contents->jit_externs;
+                b.variant.add_custom_lowering_pass(new BakeParamValue(b.param, b.value));
+            }
+            b.variant.realize(std::move(outputs), t, param_map, cancellation_token);
+            return;
+        }
+    }
+
     debug(2) << "Realizing Pipeline for " << target << "\n";
 
     if (target.has_unknowns()) {
@@ -1143,10 +1660,32 @@ void Pipeline::realize(RealizationArg outputs, const Target &t,
     // halide_runtime_error, which either calls abort() or throws an
     // exception.
 
+    // Associate the cancellation token with this call's user context
+    // in the shared runtime's thread pool, so the parallel tasks of
+    // this invocation (and no other) poll it. A cancel() that raced
+    // ahead of runtime creation is replayed now that the runtime
+    // exists.
+    if (cancellation_token) {
+        JITSharedRuntime::set_cancellation_token(&jit_context.jit_context, &cancellation_token->contents);
+        // The deadline is armed per invocation, on the runtime's
+        // clock, so the token's budget covers this call alone.
+        int64_t budget_ns = cancellation_token->deadline_budget_ns.load();
+        if (budget_ns > 0) {
+            JITSharedRuntime::set_deadline(&cancellation_token->contents, budget_ns);
+        }
+        if (cancellation_token->cancel_requested.load()) {
+            JITSharedRuntime::cancel(&cancellation_token->contents);
+        }
+    }
+
     debug(2) << "Calling jitted function\n";
     int exit_status = call_jit_code(target, args);
     debug(2) << "Back from jitted function. Exit status was " << exit_status << "\n";
 
+    if (cancellation_token) {
+        JITSharedRuntime::set_cancellation_token(&jit_context.jit_context, nullptr);
+    }
+
     // If we're profiling, report runtimes and reset profiler stats.
     if (target.has_feature(Target::Profile)) {
         JITModule::Symbol report_sym =
@@ -1166,6 +1705,555 @@ void Pipeline::realize(RealizationArg outputs, const Target &t,
     jit_context.finalize(exit_status);
 }
 
+uint64_t Pipeline::trusted_call_signature(const RealizationArg &outputs) const {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    auto mix = [&](uint64_t v) {
+        h ^= v;
+        h *= 0x100000001b3ULL;
+    };
+    auto mix_buffer = [&](const halide_buffer_t *buf) -> bool {
+        if (!buf || !buf->host) {
+            // Unbound, or a bounds query; not something to trust.
+            return false;
+        }
+        mix(buf->type.code);
+        mix(buf->type.bits);
+        mix(buf->type.lanes);
+        mix((uint64_t)buf->dimensions);
+        for (int i = 0; i < buf->dimensions; i++) {
+            mix((uint64_t)(uint32_t)buf->dim[i].min);
+            mix((uint64_t)(uint32_t)buf->dim[i].extent);
+            mix((uint64_t)(uint32_t)buf->dim[i].stride);
+        }
+        // The checks can constrain host alignment too.
+        mix((uint64_t)(uintptr_t)buf->host & 4095);
+        return true;
+    };
+    for (const InferredArgument &arg : contents->inferred_args) {
+        if (arg.param.defined()) {
+            if (arg.param.same_as(contents->user_context_arg.param)) {
+                continue;
+            }
+            if (arg.param.is_buffer()) {
+                Buffer<> buf = arg.param.buffer();
+                if (!buf.defined() || !mix_buffer(buf.raw_buffer())) {
+                    return 0;
+                }
+            } else {
+                // Scalar parameter values participate in the
+                // signature, so changing one re-validates.
+                uint64_t bits = 0;
+                memcpy(&bits, arg.param.scalar_address(), arg.param.type().bytes());
+                mix(bits);
+            }
+        } else if (arg.buffer.defined()) {
+            if (!mix_buffer(arg.buffer.raw_buffer())) {
+                return 0;
+            }
+        }
+    }
+    if (outputs.r) {
+        for (size_t i = 0; i < outputs.r->size(); i++) {
+            if (!mix_buffer((*outputs.r)[i].raw_buffer())) {
+                return 0;
+            }
+        }
+    } else if (outputs.buf) {
+        if (!mix_buffer(outputs.buf)) {
+            return 0;
+        }
+    } else {
+        for (const Buffer<> &buffer : *outputs.buffer_list) {
+            if (!mix_buffer(buffer.raw_buffer())) {
+                return 0;
+            }
+        }
+    }
+    // Zero means "no signature".
+    return h ? h : 1;
+}
+
+void Pipeline::trusted_realize(RealizationArg outputs, const Target &t) {
+    Target target = t;
+    user_assert(defined()) << "Can't realize an undefined Pipeline\n";
+
+    if (target.has_unknowns()) {
+        // If we've already jit-compiled for a specific target, use that.
+        target = get_compiled_jit_target();
+        if (target.has_unknowns()) {
+            // Otherwise get the target from the environment
+            target = get_jit_target_from_environment();
+        }
+    }
+
+    if (target.arch == Target::WebAssembly) {
+        // No unchecked fast path for wasm.
+        realize(std::move(outputs), target);
+        return;
+    }
+
+    // Make sure inferred_args is populated before taking a signature.
+    compile_jit(target);
+
+    uint64_t signature = trusted_call_signature(outputs);
+    if (signature == 0 || !contents->trusted_shapes.count(signature)) {
+        // First time we've seen this combination of shapes and
+        // parameter values (or one we can't sign): run the fully
+        // checked pipeline. It only becomes trusted if that succeeds.
+        realize(std::move(outputs), target);
+        if (signature != 0) {
+            contents->trusted_shapes.insert(signature);
+        }
+        return;
+    }
+
+    // The checks have already passed for exactly these shapes and
+    // values, so dispatch to a variant compiled without them.
+    if (!contents->unchecked_variant.defined()) {
+        vector<Func> outs;
+        outs.reserve(contents->outputs.size());
+        for (const Function &f : contents->outputs) {
+            outs.emplace_back(f);
+        }
+        contents->unchecked_variant = Pipeline(outs);
+        contents->unchecked_variant.contents->jit_handlers = contents->jit_handlers;
+        contents->unchecked_variant.contents->jit_externs = contents->jit_externs;
+    }
+    contents->unchecked_variant.realize(std::move(outputs), target.with_feature(Target::NoAsserts));
+}
+
+
+void Pipeline::bake(const Internal::Parameter &param, Expr value) {
+    user_assert(defined()) << "Can't bake a parameter of an undefined Pipeline\n";
+    user_assert(param.defined() && !param.is_buffer())
+        << "Pipeline::bake() requires a scalar parameter\n";
+    user_assert(value.defined()) << "Pipeline::bake() requires a defined value\n";
+    value = simplify(cast(param.type(), value));
+    user_assert(is_const(value))
+        << "Pipeline::bake() requires a constant value; got " << value << "\n";
+    for (const auto &b : contents->baked_variants) {
+        if (b.param.name() == param.name() && equal(b.value, value)) {
+            // Already baked.
+            return;
+        }
+    }
+    contents->baked_variants.push_back({param, value, Pipeline()});
+}
+
+void Pipeline::realize_batch(std::vector<Realization> &outputs, const Target &t,
+                             const std::vector<ParamMap> &param_maps) {
+    Target target = t;
+    user_assert(defined()) << "Can't realize an undefined Pipeline\n";
+    user_assert(!outputs.empty()) << "Can't realize an empty batch\n";
+    user_assert(param_maps.empty() || param_maps.size() == outputs.size())
+        << "realize_batch() requires one ParamMap per Realization, or none at all. "
+        << "Got " << param_maps.size() << " ParamMaps for " << outputs.size() << " Realizations.\n";
+
+    debug(2) << "Realizing batch of " << outputs.size() << " for " << target << "\n";
+
+    if (target.has_unknowns()) {
+        // If we've already jit-compiled for a specific target, use that.
+        target = get_compiled_jit_target();
+        if (target.has_unknowns()) {
+            // Otherwise get the target from the environment
+            target = get_jit_target_from_environment();
+        }
+    }
+
+    // See the comments in realize() above for how the context and
+    // handlers work. Here we compile once and reuse one context and
+    // one argument block for the entire batch.
+    compile_jit(target);
+
+    JITFuncCallContext jit_context(jit_handlers());
+    void *user_context_storage = &jit_context.jit_context;
+
+    const size_t num_inputs = contents->inferred_args.size();
+    JITCallArgs args(num_inputs + outputs[0].size());
+
+    for (size_t i = 0; i < outputs.size(); i++) {
+        user_assert(outputs[i].size() == outputs[0].size())
+            << "All Realizations in a batch must contain the same number of buffers. "
+            << "Realization " << i << " has " << outputs[i].size()
+            << " buffers; the first has " << outputs[0].size() << ".\n";
+        RealizationArg out(outputs[i]);
+        if (i == 0 || !param_maps.empty()) {
+            const ParamMap &pm = param_maps.empty() ? ParamMap::empty_map() : param_maps[i];
+            prepare_jit_call_arguments(out, target, pm,
+                                       &user_context_storage, false, args);
+        } else {
+            // The input arguments are the same across the batch; only
+            // the output buffers change.
+            size_t arg_index = num_inputs;
+            for (size_t j = 0; j < outputs[i].size(); j++) {
+                args.store[arg_index++] = outputs[i][j].raw_buffer();
+            }
+        }
+
+        debug(2) << "Calling jitted function for batch element " << i << "\n";
+        int exit_status = call_jit_code(target, args);
+        debug(2) << "Back from jitted function. Exit status was " << exit_status << "\n";
+
+        // Throws (or aborts) on the first failing element.
+        jit_context.finalize(exit_status);
+    }
+
+    // If we're profiling, report runtimes over the whole batch and
+    // reset profiler stats.
+    if (target.has_feature(Target::Profile)) {
+        JITModule::Symbol report_sym =
+            contents->jit_module.find_symbol_by_name("halide_profiler_report");
+        JITModule::Symbol reset_sym =
+            contents->jit_module.find_symbol_by_name("halide_profiler_reset");
+        if (report_sym.address && reset_sym.address) {
+            void *uc = &jit_context.jit_context;
+            void (*report_fn_ptr)(void *) = (void (*)(void *))(report_sym.address);
+            report_fn_ptr(uc);
+
+            void (*reset_fn_ptr)() = (void (*)())(reset_sym.address);
+            reset_fn_ptr();
+        }
+    }
+}
+
+void Pipeline::realize_tiled(const std::vector<int32_t> &sizes,
+                             const std::vector<int32_t> &tile_sizes,
+                             const std::function<void(const Realization &)> &sink,
+                             const Target &t,
+                             const ParamMap &param_map) {
+    Target target = t;
+    user_assert(defined()) << "Can't realize an undefined Pipeline\n";
+    user_assert(!sizes.empty()) << "realize_tiled() requires at least one output dimension\n";
+    user_assert(tile_sizes.size() == sizes.size())
+        << "realize_tiled() requires one tile size per output dimension. "
+        << "Got " << tile_sizes.size() << " tile sizes for " << sizes.size() << " dimensions.\n";
+    user_assert(sink) << "realize_tiled() requires a sink callback\n";
+    const int dims = (int)sizes.size();
+    for (int i = 0; i < dims; i++) {
+        user_assert(sizes[i] > 0 && tile_sizes[i] > 0)
+            << "realize_tiled() requires positive sizes and tile sizes. "
+            << "Dimension " << i << " has size " << sizes[i]
+            << " and tile size " << tile_sizes[i] << ".\n";
+    }
+    for (const Internal::Function &f : contents->outputs) {
+        user_assert(f.dimensions() == dims)
+            << "Can't realize Func \"" << f.name() << "\" over " << dims
+            << " tiled dimensions because it has " << f.dimensions() << " dimensions.\n";
+    }
+
+    debug(2) << "Realizing Pipeline tiled for " << target << "\n";
+
+    if (target.has_unknowns()) {
+        // If we've already jit-compiled for a specific target, use that.
+        target = get_compiled_jit_target();
+        if (target.has_unknowns()) {
+            // Otherwise get the target from the environment
+            target = get_jit_target_from_environment();
+        }
+    }
+
+    // See the comments in realize() above for how the context and
+    // handlers work. As in realize_batch, we compile once and reuse
+    // one context and one argument block for the entire traversal.
+    compile_jit(target);
+
+    JITFuncCallContext jit_context(jit_handlers());
+    void *user_context_storage = &jit_context.jit_context;
+
+    const size_t num_inputs = contents->inferred_args.size();
+    size_t num_output_buffers = 0;
+    for (const Internal::Function &f : contents->outputs) {
+        num_output_buffers += f.outputs();
+    }
+    JITCallArgs args(num_inputs + num_output_buffers);
+
+    // The sink runs on a single pool thread, so computing the next
+    // tile overlaps writing out the previous one, while sinks for
+    // consecutive tiles stay serialized and in tile order.
+    Internal::ThreadPool<void> sink_pool(1);
+    std::future<void> previous_sink;
+
+    std::vector<int32_t> tile_min(dims, 0);
+    bool first_tile = true;
+    while (true) {
+        // Allocate this tile's outputs, shrunk to fit at the edges,
+        // with the tile's coordinates in the mins.
+        std::vector<halide_dimension_t> shape(dims);
+        int32_t stride = 1;
+        for (int i = 0; i < dims; i++) {
+            int32_t extent = std::min(tile_sizes[i], sizes[i] - tile_min[i]);
+            shape[i] = {tile_min[i], extent, stride, 0};
+            stride *= extent;
+        }
+        std::vector<Buffer<>> bufs;
+        for (const Internal::Function &f : contents->outputs) {
+            for (Type type : f.output_types()) {
+                Buffer<> im(type, (void *)nullptr, dims, shape.data());
+                im.allocate();
+                bufs.push_back(im);
+            }
+        }
+        Realization r(bufs);
+
+        RealizationArg out(r);
+        if (first_tile) {
+            prepare_jit_call_arguments(out, target, param_map,
+                                       &user_context_storage, false, args);
+            first_tile = false;
+        } else {
+            // The input arguments are the same for every tile; only
+            // the output buffers change.
+            size_t arg_index = num_inputs;
+            for (size_t j = 0; j < r.size(); j++) {
+                args.store[arg_index++] = r[j].raw_buffer();
+            }
+        }
+
+        debug(2) << "Calling jitted function for tile at " << tile_min[0] << "...\n";
+        int exit_status = call_jit_code(target, args);
+        debug(2) << "Back from jitted function. Exit status was " << exit_status << "\n";
+
+        // Throws (or aborts) on the first failing tile.
+        jit_context.finalize(exit_status);
+
+        // Wait until the sink is done with the tile before this one,
+        // so that at most two tiles are allocated at once. Rethrows
+        // anything the sink threw.
+        if (previous_sink.valid()) {
+            previous_sink.get();
+        }
+        previous_sink = sink_pool.async([&sink, r]() { sink(r); });
+
+        // Advance to the next tile, first dimension innermost.
+        int d = 0;
+        for (; d < dims; d++) {
+            tile_min[d] += tile_sizes[d];
+            if (tile_min[d] < sizes[d]) {
+                break;
+            }
+            tile_min[d] = 0;
+        }
+        if (d == dims) {
+            break;
+        }
+    }
+
+    if (previous_sink.valid()) {
+        previous_sink.get();
+    }
+
+    // If we're profiling, report runtimes over the whole traversal
+    // and reset profiler stats.
+    if (target.has_feature(Target::Profile)) {
+        JITModule::Symbol report_sym =
+            contents->jit_module.find_symbol_by_name("halide_profiler_report");
+        JITModule::Symbol reset_sym =
+            contents->jit_module.find_symbol_by_name("halide_profiler_reset");
+        if (report_sym.address && reset_sym.address) {
+            void *uc = &jit_context.jit_context;
+            void (*report_fn_ptr)(void *) = (void (*)(void *))(report_sym.address);
+            report_fn_ptr(uc);
+
+            void (*reset_fn_ptr)() = (void (*)())(reset_sym.address);
+            reset_fn_ptr();
+        }
+    }
+}
+
+Realization Pipeline::realize_distributed(const std::vector<int32_t> &sizes,
+                                          int rank, int num_ranks,
+                                          const DistributedTransport &transport,
+                                          const Target &target,
+                                          const ParamMap &param_map) {
+    user_assert(defined()) << "Can't realize an undefined Pipeline\n";
+    user_assert(!sizes.empty()) << "realize_distributed() requires at least one output dimension\n";
+    user_assert(num_ranks > 0) << "realize_distributed() requires a positive number of ranks\n";
+    user_assert(rank >= 0 && rank < num_ranks)
+        << "realize_distributed() rank " << rank << " is outside [0, " << num_ranks << ")\n";
+    user_assert(transport) << "realize_distributed() requires a transport callback\n";
+    user_assert(!target.has_feature(Target::NoBoundsQuery))
+        << "You may not call realize_distributed() with Target::NoBoundsQuery set.";
+    const int dims = (int)sizes.size();
+    for (const Internal::Function &f : contents->outputs) {
+        user_assert(f.dimensions() == dims)
+            << "Can't realize Func \"" << f.name() << "\" over " << dims
+            << " distributed dimensions because it has " << f.dimensions() << " dimensions.\n";
+    }
+
+    // Split the outermost dimension into num_ranks contiguous slices.
+    const int d = dims - 1;
+    const int32_t extent = sizes[d];
+    const int32_t slice = (extent + num_ranks - 1) / num_ranks;
+    const int32_t shard_min = rank * slice;
+    const int32_t shard_extent = std::min(extent - shard_min, slice);
+    user_assert(shard_extent > 0)
+        << "realize_distributed() can't split an outermost extent of " << extent
+        << " across " << num_ranks << " ranks; rank " << rank
+        << " would get an empty shard. Use fewer ranks.\n";
+
+    // Allocate this rank's outputs, with the shard's coordinates in
+    // the mins.
+    std::vector<halide_dimension_t> shape(dims);
+    int32_t stride = 1;
+    for (int i = 0; i < dims; i++) {
+        int32_t e = (i == d) ? shard_extent : sizes[i];
+        int32_t m = (i == d) ? shard_min : 0;
+        shape[i] = {m, e, stride, 0};
+        stride *= e;
+    }
+    std::vector<Buffer<>> bufs;
+    for (const Internal::Function &f : contents->outputs) {
+        for (Type type : f.output_types()) {
+            Buffer<> im(type, (void *)nullptr, dims, shape.data());
+            im.allocate();
+            bufs.push_back(im);
+        }
+    }
+    Realization r(bufs);
+
+    // Remember which buffer inputs are unbound; those are the ones
+    // whose required regions the bounds query will infer, and which
+    // the transport must fill.
+    std::vector<Internal::Parameter> unbound_inputs;
+    for (const InferredArgument &ia : contents->inferred_args) {
+        if (ia.param.defined() && ia.param.is_buffer() && !ia.param.buffer().defined()) {
+            unbound_inputs.push_back(ia.param);
+        }
+    }
+
+    // Infer the region required of each unbound input for this shard,
+    // including any halo reaching into neighbouring ranks' slices,
+    // and allocate buffers covering it.
+    infer_input_bounds(r, target, param_map);
+
+    // Fill each inferred input, one transport call per maximal run of
+    // rows in the outermost dimension with a single owner. Inputs are
+    // assumed to be distributed by the same outermost-dimension
+    // decomposition as the output.
+    for (const Internal::Parameter &p : unbound_inputs) {
+        Buffer<> buf = p.buffer();
+        internal_assert(buf.defined());
+        const int bd = buf.dimensions() - 1;
+        const int32_t row_min = buf.dim(bd).min();
+        const int32_t row_end = row_min + buf.dim(bd).extent();
+        int32_t row = row_min;
+        while (row < row_end) {
+            int owner = 0;
+            if (row >= 0) {
+                owner = std::min(row / slice, num_ranks - 1);
+            }
+            int32_t run_end = row_end;
+            if (owner < num_ranks - 1) {
+                run_end = std::min(run_end, (owner + 1) * slice);
+            }
+            Runtime::Buffer<> crop = buf.get()->cropped(bd, row, run_end - row);
+            transport(p.name(), owner, crop.raw_buffer());
+            row = run_end;
+        }
+        buf.set_host_dirty();
+    }
+
+    // Compute the shard.
+    realize(r, target, param_map);
+    return r;
+}
+
+struct Pipeline::BoundCallContents {
+    // Keeps the compiled module alive.
+    Pipeline pipeline;
+    Target target;
+    JITFuncCallContext jit_context;
+    // The argv block points at this member, so it must have a stable
+    // address for the lifetime of the BoundCall.
+    void *user_context_storage;
+    JITCallArgs args;
+    size_t num_inputs;
+    // The argv slot of each buffer input, by parameter name.
+    std::map<std::string, size_t> input_slots;
+    // Buffers rebound after bind() are kept alive here.
+    std::map<size_t, Buffer<>> bound_buffers;
+
+    BoundCallContents(const Pipeline &pipeline, const Target &target,
+                      const JITHandlers &handlers, size_t num_args)
+        : pipeline(pipeline), target(target), jit_context(handlers),
+          user_context_storage(&jit_context.jit_context), args(num_args) {
+    }
+};
+
+Pipeline::BoundCall Pipeline::bind(RealizationArg outputs, const Target &t,
+                                   const ParamMap &param_map) {
+    Target target = t;
+    user_assert(defined()) << "Can't bind an undefined Pipeline\n";
+
+    if (target.has_unknowns()) {
+        // If we've already jit-compiled for a specific target, use that.
+        target = get_compiled_jit_target();
+        if (target.has_unknowns()) {
+            // Otherwise get the target from the environment
+            target = get_jit_target_from_environment();
+        }
+    }
+
+    // Ensure the module is compiled.
+    compile_jit(target);
+
+    BoundCall result;
+    result.contents = std::make_shared<BoundCallContents>(
+        *this, target, jit_handlers(),
+        contents->inferred_args.size() + outputs.size());
+    BoundCallContents &b = *result.contents;
+    b.num_inputs = contents->inferred_args.size();
+
+    prepare_jit_call_arguments(outputs, target, param_map,
+                               &b.user_context_storage, false, b.args);
+
+    // Remember where each buffer input landed so that set_input can
+    // repoint it later.
+    for (size_t i = 0; i < contents->inferred_args.size(); i++) {
+        const InferredArgument &ia = contents->inferred_args[i];
+        if (ia.param.defined() && ia.param.is_buffer()) {
+            b.input_slots[ia.param.name()] = i;
+        }
+    }
+
+    return result;
+}
+
+bool Pipeline::BoundCall::defined() const {
+    return contents != nullptr;
+}
+
+void Pipeline::BoundCall::run() {
+    user_assert(defined()) << "Can't run an undefined BoundCall\n";
+    BoundCallContents &b = *contents;
+
+    debug(2) << "Calling jitted function\n";
+    int exit_status = b.pipeline.call_jit_code(b.target, b.args);
+    debug(2) << "Back from jitted function. Exit status was " << exit_status << "\n";
+
+    b.jit_context.finalize(exit_status);
+}
+
+void Pipeline::BoundCall::set_input(const ImageParam &p, const Buffer<> &buf) {
+    user_assert(defined()) << "Can't set an input on an undefined BoundCall\n";
+    BoundCallContents &b = *contents;
+    auto it = b.input_slots.find(p.name());
+    user_assert(it != b.input_slots.end())
+        << "The pipeline of this BoundCall has no input named " << p.name() << "\n";
+    b.args.store[it->second] = buf.raw_buffer();
+    b.bound_buffers[it->second] = buf;
+}
+
+void Pipeline::BoundCall::set_output(size_t index, const Buffer<> &buf) {
+    user_assert(defined()) << "Can't set an output on an undefined BoundCall\n";
+    BoundCallContents &b = *contents;
+    user_assert(index < b.args.size - b.num_inputs)
+        << "Output index " << index << " is out of range for a pipeline with "
+        << (b.args.size - b.num_inputs) << " output buffers\n";
+    b.args.store[b.num_inputs + index] = buf.raw_buffer();
+    b.bound_buffers[b.num_inputs + index] = buf;
+}
+
 void Pipeline::infer_input_bounds(RealizationArg outputs, const Target &target, const ParamMap &param_map) {
     user_assert(!target.has_feature(Target::NoBoundsQuery)) << "You may not call infer_input_bounds() with Target::NoBoundsQuery set.";
     compile_jit(target);
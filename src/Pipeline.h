@@ -7,7 +7,10 @@
  * pipeline.
  */
 
+#include <atomic>
+#include <future>
 #include <map>
+#include <memory>
 #include <vector>
 
 #include "ExternalCode.h"
@@ -92,6 +95,67 @@ class Pipeline;
 
 using AutoSchedulerFn = std::function<void(const Pipeline &, const Target &, const MachineParams &, AutoSchedulerResults *outputs)>;
 
+/** A handle used to cancel in-flight realizations from another
+ * thread. Pass a pointer to one to Pipeline::realize; calling
+ * cancel() from any thread then makes the realization stop launching
+ * parallel tasks and return promptly with
+ * halide_error_code_pipeline_cancelled (reported via the error
+ * handler, so by default realize throws). Tasks that are already
+ * running finish normally, and the output buffers may contain partial
+ * results. The token must outlive any realization using it, and can
+ * be reused for a fresh realization after calling reset(). In AOT
+ * code, use halide_set_cancellation_token and halide_cancel from
+ * HalideRuntime.h instead. */
+class CancellationToken {
+    halide_cancellation_token_t contents = {{0, 0, 0}};
+
+    // Cancellation requested before the JIT runtime existed still
+    // takes effect when the next realization registers the token.
+    std::atomic<bool> cancel_requested{false};
+
+    // A per-realization time budget in nanoseconds, or zero. The
+    // deadline itself is armed in the runtime when a realization
+    // registers the token, so the budget covers each realization
+    // rather than starting when set_deadline is called.
+    std::atomic<int64_t> deadline_budget_ns{0};
+
+    friend class Pipeline;
+
+public:
+    /** Request cancellation of any realization currently using this
+     * token. Idempotent, and safe to call from any thread. */
+    void cancel();
+
+    /** True if cancel() has been called since the last reset(). */
+    bool cancelled() const;
+
+    /** Give each realization using this token a time budget, in
+     * nanoseconds, measured from when it starts. A realization that
+     * exceeds its budget cancels itself at the next task boundary, as
+     * if cancel() had been called; use deadline_progress() to see how
+     * much output it completed, and reset() before reusing the token.
+     * Schedule the output's outer loop parallel to give the runtime
+     * task boundaries at which to check. A budget of zero or less
+     * removes the deadline. */
+    void set_deadline(int64_t budget_ns);
+
+    /** If a realization using this token was cancelled, report the
+     * first parallel loop iteration it skipped via first_skipped and
+     * return true. All earlier iterations of that loop completed, so
+     * when the outermost loop of the output is the parallel one this
+     * identifies the valid region of the partial result. Returns
+     * false if nothing was skipped. */
+    bool deadline_progress(int *first_skipped) const;
+
+    /** Re-arm the token for reuse. Do not call this while a
+     * realization using the token is in flight. */
+    void reset();
+
+    CancellationToken() = default;
+    CancellationToken(const CancellationToken &) = delete;
+    CancellationToken &operator=(const CancellationToken &) = delete;
+};
+
 /** A class representing a Halide pipeline. Constructed from the Func
  * or Funcs that it outputs. */
 class Pipeline {
@@ -156,6 +220,13 @@ private:
 
     int call_jit_code(const Target &target, const JITCallArgs &args);
 
+    // A hash of everything the injected checks can depend on for one
+    // call: buffer shapes, host pointer alignments, and scalar
+    // parameter values. Returns zero if a signature can't be taken
+    // (e.g. an unbound or bounds-query buffer), meaning the call must
+    // take the checked path.
+    uint64_t trusted_call_signature(const RealizationArg &outputs) const;
+
     // Get the value of contents->jit_target, but reality-check that the contents
     // sensibly match the value. Return Target() if not jitted.
     Target get_compiled_jit_target() const;
@@ -283,11 +354,34 @@ public:
                                  StmtOutputFormat fmt = Text,
                                  const Target &target = get_target_from_environment());
 
+    /** Write out the affine access descriptors of the lowered
+     * pipeline as a C table of halide_affine_access_descriptor_t
+     * (see HalideRuntime.h): for each stage, the base, strides, and
+     * extents of every buffer access, as far as they are statically
+     * known. Useful for programming DMA and prefetch engines from
+     * the schedule itself rather than from hand-maintained
+     * descriptor tables that drift when the schedule changes. */
+    void compile_to_access_descriptors(const std::string &filename,
+                                       const std::vector<Argument> &args,
+                                       const std::string &fn_name,
+                                       const Target &target = get_target_from_environment());
+
     /** Write out the loop nests specified by the schedule for this
      * Pipeline's Funcs. Helpful for understanding what a schedule is
      * doing. */
     void print_loop_nest();
 
+    /** Write out a report of the predicted cost of computing each Func
+     * in this Pipeline: arithmetic operations, bytes moved, arithmetic
+     * intensity, and the working set of each stage compared against the
+     * last-level cache size in 'arch_params'. The regions of the Funcs
+     * are derived from the estimates provided on the outputs and on any
+     * ImageParams (see Func::set_estimate), assuming every Func is
+     * computed in full, so the report is independent of the schedule.
+     * Helpful for spotting stages whose footprint cannot be cache
+     * resident before running anything. */
+    void print_performance_report(const MachineParams &arch_params = MachineParams::generic());
+
     /** Compile to object file and header pair, with the given
      * arguments. */
     void compile_to_file(const std::string &filename_prefix,
@@ -347,6 +441,17 @@ public:
      */
     void compile_jit(const Target &target = get_jit_target_from_environment());
 
+    /** As compile_jit, but farms the LLVM compilation out to an
+     * internal pool of compiler threads and returns a future, so that
+     * many pipeline variants can be compiled concurrently at
+     * startup. Lowering still runs on the calling thread before this
+     * returns, as the front end shares state between pipelines; only
+     * the LLVM work is deferred. Wait on the returned future before
+     * calling realize() or any other compile method on this Pipeline;
+     * exceptions thrown during compilation are rethrown by
+     * std::future::get. Not supported for WebAssembly targets. */
+    std::future<void> compile_jit_async(const Target &target = get_jit_target_from_environment());
+
     /** Set the error handler function that be called in the case of
      * runtime errors during halide pipelines. If you are compiling
      * statically, you can also just define your own function with
@@ -373,6 +478,37 @@ public:
     void set_custom_allocator(void *(*malloc)(void *, size_t),
                               void (*free)(void *, void *));
 
+    /** Provide a persistent workspace for this pipeline's internal
+     * heap allocations when running under the jit. Intermediates are
+     * bump-allocated from the given memory and the workspace recycles
+     * once every allocation from a realization has been freed, so
+     * repeated calls to realize() perform no allocator traffic in
+     * steady state. The caller retains ownership of the memory and
+     * may back it however it likes (e.g. huge pages); it must outlive
+     * all realizations. The workspace is shared process-wide by every
+     * pipeline that opts in. Allocations that don't fit fall back to
+     * the system allocator, so an undersized workspace is a
+     * performance problem rather than a correctness one. Calling
+     * set_custom_allocator afterwards reverts this pipeline to the
+     * given allocator. */
+    void set_jit_workspace(void *base, uint64_t size_in_bytes);
+
+    /** The high-water mark, in bytes, of memory simultaneously live
+     * through the jit workspace allocator (including fallback
+     * allocations that did not fit). Realize once with a workspace of
+     * size zero and use this to size the real workspace. */
+    static uint64_t jit_workspace_peak();
+
+    /** An estimate of the total heap memory the pipeline's internal
+     * allocations need per realization, computed from the statically
+     * bounded allocations in the lowered code, including the
+     * alignment padding the workspace allocator applies. Returns zero
+     * if any internal allocation's size isn't known until runtime (in
+     * which case use jit_workspace_peak() from a trial run instead).
+     * Allocations inside parallel loops are counted once, so
+     * schedules that allocate per-thread may need more. */
+    uint64_t infer_intermediate_footprint(const Target &target = get_jit_target_from_environment());
+
     /** Set a custom task handler to be called by the parallel for
      * loop. It is useful to set this if you want to do some
      * additional bookkeeping at the granularity of parallel
@@ -483,10 +619,12 @@ public:
     /** Get the custom lowering passes. */
     const std::vector<CustomLoweringPass> &custom_lowering_passes();
 
-    /** See Func::realize */
+    /** See Func::realize. Pass a CancellationToken to allow another
+     * thread to cancel the realization while it runs. */
     // @{
     Realization realize(std::vector<int32_t> sizes = {}, const Target &target = Target(),
-                        const ParamMap &param_map = ParamMap::empty_map());
+                        const ParamMap &param_map = ParamMap::empty_map(),
+                        CancellationToken *cancellation_token = nullptr);
     HALIDE_ATTRIBUTE_DEPRECATED("Call realize() with a vector<int> instead")
     Realization realize(int x_size, int y_size, int z_size, int w_size, const Target &target = Target(),
                         const ParamMap &param_map = ParamMap::empty_map());
@@ -515,9 +653,177 @@ public:
      * each individual output Func, all Buffers must have the same
      * shape, but the shape can vary across the different output
      * Funcs. This form of realize does *not* automatically copy data
-     * back from the GPU. */
+     * back from the GPU. Pass a CancellationToken to allow another
+     * thread to cancel the realization while it runs. */
     void realize(RealizationArg output, const Target &target = Target(),
-                 const ParamMap &param_map = ParamMap::empty_map());
+                 const ParamMap &param_map = ParamMap::empty_map(),
+                 CancellationToken *cancellation_token = nullptr);
+
+    /** Like the buffer form of realize, but once a given combination
+     * of argument shapes and scalar parameter values has passed the
+     * parameter and image checks, later calls with the same
+     * combination dispatch to a variant of the pipeline compiled
+     * without those checks. This is for inner loops of services that
+     * realize the same shapes millions of times: the stride, extent
+     * and parameter facts get proven once per unique shape instead of
+     * per call. Any change to a buffer shape, a host pointer's
+     * alignment, or a scalar parameter value re-validates through the
+     * full checks, so this is safe as long as buffer contents are the
+     * only thing that varies between calls. The unchecked variant is
+     * compiled lazily on the first trusted call, and custom handlers
+     * and jit externs are captured at that point. Not supported when
+     * jitting to WebAssembly; such calls just use the checked path. */
+    void trusted_realize(RealizationArg output, const Target &target = Target());
+
+    /** Register a baked variant of this Pipeline in which the given
+     * scalar parameter is replaced by a literal constant. Whenever
+     * realize() is called with the parameter bound to a baked value,
+     * the call dispatches to a variant jit-compiled with that value
+     * substituted into the IR and re-simplified, so expressions that
+     * depend only on the parameter (kernel weights, loop bounds,
+     * select conditions) constant-fold away and the parameter
+     * disappears from the variant's argument list. Any other value
+     * falls back to the generic pipeline, so baking is always safe;
+     * it just makes the baked values faster. Each variant is compiled
+     * lazily on the first realize() that matches it and cached for
+     * subsequent calls. Calls that remap parameters through a
+     * ParamMap always use the generic pipeline. Baking the same
+     * parameter/value pair twice is a no-op. */
+    // @{
+    void bake(const Internal::Parameter &param, Expr value);
+
+    template<typename T>
+    void bake(const Param<T> &param, const T &value) {
+        bake(param.parameter(), Expr(value));
+    }
+    // @}
+
+    /** Evaluate this Pipeline into a batch of existing allocated
+     * buffers in one call. Equivalent to calling the buffer form of
+     * realize on each element of the batch in turn, but the pipeline
+     * is validated, the handler context set up, and the input
+     * arguments marshalled once for the whole batch rather than per
+     * call, which matters when realizing many small outputs. Each
+     * Realization in the batch must contain the same number of
+     * buffers (one per tuple component per output Func). Pass one
+     * ParamMap per Realization to vary parameter bindings across the
+     * batch, or none to use the bound parameter values for every
+     * element. Stops at the first element that fails. Like the buffer
+     * form of realize, this does *not* automatically copy data back
+     * from the GPU. */
+    void realize_batch(std::vector<Realization> &outputs, const Target &target = Target(),
+                       const std::vector<ParamMap> &param_maps = {});
+
+    /** Evaluate this Pipeline one output tile at a time, handing each
+     * finished tile to a sink callback, so that outputs too large to
+     * allocate in one piece (e.g. enormous scans) can be streamed to
+     * disk or the network without ever materializing the whole
+     * result. 'sizes' gives the total extent of the output region and
+     * 'tile_sizes' the extent of each tile, per dimension; tiles at
+     * the upper edges are shrunk to fit. Each output Func must have
+     * the same dimensionality as 'sizes'. Tiles are visited in order
+     * with the first dimension innermost, and the Buffers handed to
+     * the sink carry their tile's coordinates in their mins.
+     *
+     * The pipeline is compiled once for the whole traversal, and the
+     * sink runs on its own thread, so computing the next tile
+     * overlaps writing out the previous one. At most two tiles are
+     * allocated at any moment, and sinks for consecutive tiles never
+     * run concurrently. Exceptions thrown by the sink (or a failing
+     * tile) stop the traversal. Producers shared between adjacent
+     * tiles are recomputed per tile, as with any realize call over a
+     * crop, so prefer tiles that span the full extent of all but the
+     * outermost dimensions (strips) when redundant boundary work
+     * matters. Like the buffer form of realize, this does *not*
+     * automatically copy data back from the GPU. */
+    void realize_tiled(const std::vector<int32_t> &sizes,
+                       const std::vector<int32_t> &tile_sizes,
+                       const std::function<void(const Realization &)> &sink,
+                       const Target &target = Target(),
+                       const ParamMap &param_map = ParamMap::empty_map());
+
+    /** A callback used by realize_distributed to fill a crop of an
+     * input buffer with data owned by a given rank. The crop
+     * describes the required region, including its coordinates in the
+     * mins; the callback must write the data into it, typically by
+     * copying from local storage when owner_rank is the calling
+     * rank's own, and by receiving it from the owner over whatever
+     * transport connects the ranks (MPI, sockets, shared memory)
+     * otherwise. */
+    using DistributedTransport =
+        std::function<void(const std::string &input_name, int owner_rank, halide_buffer_t *crop)>;
+
+    /** Realize one rank's shard of this Pipeline's output domain.
+     * The outermost dimension of the given output size is split into
+     * num_ranks contiguous slices, and this call computes the slice
+     * belonging to the given rank, returning a Realization whose
+     * buffers carry the shard's coordinates in their mins.
+     *
+     * A bounds query over the shard determines the region required of
+     * each unbound input, including any halo extending into
+     * neighbouring ranks' slices. Each input's rows are assumed to be
+     * distributed across ranks by the same outermost-dimension
+     * decomposition as the output (the usual arrangement for stencil
+     * pipelines). The transport callback is invoked once per
+     * maximal run of required rows with a single owner -- including
+     * the calling rank itself -- so only the halos cross ranks, and
+     * the redundant recompute of a hand-cropped run is avoided.
+     * Inputs that are already bound to a buffer are used as-is and
+     * the transport is not consulted for them. */
+    Realization realize_distributed(const std::vector<int32_t> &sizes,
+                                    int rank, int num_ranks,
+                                    const DistributedTransport &transport,
+                                    const Target &target = Target(),
+                                    const ParamMap &param_map = ParamMap::empty_map());
+
+    struct BoundCallContents;
+
+    /** A jit-compiled pipeline invocation with its arguments already
+     * marshalled into the raw argv block the jitted code consumes.
+     * Produced by Pipeline::bind. Calling run() skips all per-call
+     * setup: no parameter map lookups, no argument marshalling, no
+     * handler context construction. Between runs, only the values
+     * that changed need to be poked: scalar params read their bound
+     * storage directly, so Param::set (or ParamMap::set on the map
+     * passed to bind) takes effect on the next run with no further
+     * work, while buffers are repointed with set_input and
+     * set_output. The caller must keep any buffers that were bound at
+     * bind() time alive for as long as they remain bound. Holds the
+     * compiled module alive. */
+    class BoundCall {
+        std::shared_ptr<BoundCallContents> contents;
+        friend class Pipeline;
+
+    public:
+        /** Construct an undefined BoundCall; use Pipeline::bind to
+         * make a defined one. */
+        BoundCall() = default;
+
+        /** Is this BoundCall bound to a pipeline? */
+        bool defined() const;
+
+        /** Run the pipeline on the currently-bound arguments. Raises
+         * errors the same way realize does. Does *not* automatically
+         * copy data back from the GPU. */
+        void run();
+
+        /** Repoint an input ImageParam at a new buffer. The BoundCall
+         * keeps the buffer alive until it is replaced. */
+        void set_input(const ImageParam &p, const Buffer<> &buf);
+
+        /** Repoint one of the output buffers, in the same order the
+         * outputs were given to Pipeline::bind. The BoundCall keeps
+         * the buffer alive until it is replaced. */
+        void set_output(size_t index, const Buffer<> &buf);
+    };
+
+    /** Compile this Pipeline if necessary and marshal the given
+     * outputs and parameter bindings into a BoundCall that can be run
+     * repeatedly with near-zero per-call setup. Use this instead of
+     * realize on latency-sensitive paths where the same pipeline runs
+     * many times on the same (or mostly the same) arguments. */
+    BoundCall bind(RealizationArg outputs, const Target &target = Target(),
+                   const ParamMap &param_map = ParamMap::empty_map());
 
     /** For a given size of output, or a given set of output buffers,
      * determine the bounds required of all unbound ImageParams
@@ -551,6 +857,20 @@ public:
      * been rescheduled. */
     void invalidate_cache();
 
+    /** Enable or disable incremental lowering for this Pipeline. When
+     * enabled, every module this Pipeline lowers is remembered, keyed
+     * on a fingerprint of the complete schedule state, and compiling
+     * after a schedule change that restores a previously-seen state
+     * reuses the remembered module instead of re-lowering from
+     * scratch. This is intended for autotuning loops that mutate
+     * schedules in-process and frequently revisit candidates. The
+     * remembered modules are kept for the lifetime of the Pipeline
+     * (or until incremental lowering is disabled again), so do not
+     * leave this enabled while exploring an unbounded number of
+     * schedules. Any custom lowering passes must be pure functions of
+     * the IR for the reuse to be sound. Off by default. */
+    void set_incremental_lowering(bool enable);
+
     /** Add a top-level precondition to the generated pipeline,
      * expressed as a boolean Expr. The Expr may depend on parameters
      * only, and may not call any Func or use a Var. If the condition
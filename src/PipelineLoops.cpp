@@ -0,0 +1,173 @@
+#include "PipelineLoops.h"
+#include "Function.h"
+#include "IRMutator.h"
+#include "IROperator.h"
+#include "IRPrinter.h"
+#include "Substitute.h"
+
+namespace Halide {
+namespace Internal {
+
+using std::map;
+using std::pair;
+using std::string;
+using std::vector;
+
+namespace {
+
+void block_to_vector(const Stmt &s, vector<Stmt> &v) {
+    const Block *b = s.as<Block>();
+    if (!b) {
+        v.push_back(s);
+    } else {
+        block_to_vector(b->first, v);
+        block_to_vector(b->rest, v);
+    }
+}
+
+/** A pipeline_loop request resolved to the loops it names. */
+struct Rotation {
+    string prefix;  // <func>.s<stage>.
+    string var;
+    int stages;
+};
+
+class PipelineLoops : public IRMutator {
+    using IRMutator::visit;
+
+    const vector<Rotation> &rotations;
+
+    Stmt visit(const For *op) override {
+        Stmt body = mutate(op->body);
+
+        const Rotation *request = nullptr;
+        for (const Rotation &r : rotations) {
+            if (starts_with(op->name, r.prefix) &&
+                ends_with(op->name, "." + r.var)) {
+                request = &r;
+                break;
+            }
+        }
+        if (request == nullptr) {
+            if (body.same_as(op->body)) {
+                return op;
+            } else {
+                return For::make(op->name, op->min, op->extent,
+                                 op->for_type, op->device_api, body);
+            }
+        }
+
+        user_assert(op->for_type == ForType::Serial)
+            << "Loop " << op->name << " is scheduled with pipeline_loop(), "
+            << "which requires a serial loop, but it is of type "
+            << op->for_type << "\n";
+
+        // Peel off any leading lets. They are replicated into each
+        // stage; replicas a stage doesn't use will simplify away.
+        vector<pair<string, Expr>> lets;
+        while (const LetStmt *l = body.as<LetStmt>()) {
+            lets.emplace_back(l->name, l->value);
+            body = l->body;
+        }
+
+        // The top-level statements of the body become the pipeline
+        // stages.
+        vector<Stmt> stmts;
+        block_to_vector(body, stmts);
+
+        int stages = std::min(request->stages, (int)stmts.size());
+        if (stages < 2) {
+            user_warning << "Not software-pipelining loop " << op->name
+                         << " because its body has a single top-level statement.\n";
+            return op;
+        }
+
+        // Group the statements into the stages, in order, distributed
+        // as evenly as possible.
+        vector<Stmt> groups(stages);
+        for (int g = 0; g < stages; g++) {
+            size_t begin = (stmts.size() * g) / stages;
+            size_t end = (stmts.size() * (g + 1)) / stages;
+            Stmt group = stmts[begin];
+            for (size_t i = begin + 1; i < end; i++) {
+                group = Block::make(group, stmts[i]);
+            }
+            groups[g] = group;
+        }
+
+        // Rotate the stages: in the new loop body, stage g works on
+        // iteration loop_var - g, so the loop runs for stages - 1
+        // extra iterations and each stage is guarded against the
+        // iterations at which it has no work. The guards are marked
+        // likely, so that loop partitioning peels them off into a
+        // prologue and epilogue and leaves the steady state
+        // unguarded. The stages are emitted in reverse order, so that
+        // within one iteration of the rotated loop the work on the
+        // oldest input iteration runs first; this keeps a stage no
+        // more than one iteration ahead of the stage after it.
+        Expr loop_var = Variable::make(Int(32), op->name);
+        Stmt new_body;
+        for (int g = 0; g < stages; g++) {
+            Stmt stage = groups[g];
+            for (auto it = lets.rbegin(); it != lets.rend(); ++it) {
+                stage = LetStmt::make(it->first, it->second, stage);
+            }
+            stage = substitute(op->name, loop_var - g, stage);
+            Expr active;
+            if (g > 0) {
+                active = likely(loop_var >= op->min + g);
+            }
+            if (g < stages - 1) {
+                Expr not_done = likely(loop_var < op->min + op->extent + g);
+                active = active.defined() ? active && not_done : not_done;
+            }
+            if (active.defined()) {
+                stage = IfThenElse::make(active, stage);
+            }
+            if (new_body.defined()) {
+                new_body = Block::make(stage, new_body);
+            } else {
+                new_body = stage;
+            }
+        }
+
+        return For::make(op->name, op->min, op->extent + (stages - 1),
+                         op->for_type, op->device_api, new_body);
+    }
+
+public:
+    PipelineLoops(const vector<Rotation> &r)
+        : rotations(r) {
+    }
+};
+
+}  // namespace
+
+Stmt pipeline_loops(const Stmt &s, const map<string, Function> &env) {
+    vector<Rotation> rotations;
+    for (const auto &p : env) {
+        const Function &f = p.second;
+        if (!f.has_pure_definition()) {
+            continue;
+        }
+        int stage_index = 0;
+        auto collect = [&](const Definition &def) {
+            string prefix = f.name() + ".s" + std::to_string(stage_index) + ".";
+            for (const PipelineLoopDirective &d : def.schedule().pipeline_loops()) {
+                rotations.push_back({prefix, d.var, d.stages});
+            }
+        };
+        collect(f.definition());
+        for (const Definition &def : f.updates()) {
+            stage_index++;
+            collect(def);
+        }
+    }
+    if (rotations.empty()) {
+        return s;
+    }
+    return PipelineLoops(rotations).mutate(s);
+}
+
+}  // namespace Internal
+}  // namespace Halide
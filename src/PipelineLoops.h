@@ -0,0 +1,27 @@
+#ifndef HALIDE_PIPELINE_LOOPS_H
+#define HALIDE_PIPELINE_LOOPS_H
+
+/** \file
+ * Defines the lowering pass that software-pipelines loops marked as such.
+ */
+#include <map>
+#include <string>
+
+#include "Expr.h"
+
+namespace Halide {
+namespace Internal {
+
+class Function;
+
+/** Rotate the bodies of loops scheduled with Func::pipeline_loop into
+ * several stages that work on staggered loop iterations, so that the
+ * statements of the body overlap across iterations. The stage guards
+ * are marked likely, so that a later loop partitioning pass peels them
+ * off into a prologue and epilogue. */
+Stmt pipeline_loops(const Stmt &s, const std::map<std::string, Function> &env);
+
+}  // namespace Internal
+}  // namespace Halide
+
+#endif
@@ -0,0 +1,162 @@
+#include "PredicateClampedLoads.h"
+#include "IRMutator.h"
+#include "IROperator.h"
+#include "Simplify.h"
+#include "Target.h"
+#include "Util.h"
+#include "VectorizeLoops.h"
+
+namespace Halide {
+namespace Internal {
+
+namespace {
+
+// A load index of the form max(min(ramp, hi), lo) or min(max(ramp, lo), hi),
+// decomposed. lo_index and hi_index are the scalar addresses the
+// out-of-range lanes resolve to; they differ between the two nestings
+// when the clamp is degenerate (lo > hi).
+struct ClampedRamp {
+    const Ramp *ramp = nullptr;
+    Expr lo, hi;
+    Expr lo_index, hi_index;
+};
+
+const Ramp *as_dense_ramp(const Expr &e) {
+    const Ramp *r = e.as<Ramp>();
+    return (r && is_const_one(r->stride)) ? r : nullptr;
+}
+
+// Split a Min or Max into a dense ramp operand and a broadcast-of-scalar
+// operand, in either order.
+template<typename MinOrMax>
+bool split_clamp_level(const MinOrMax *op, const Ramp **ramp, Expr *bound) {
+    const Broadcast *b;
+    if ((*ramp = as_dense_ramp(op->a)) && (b = op->b.template as<Broadcast>())) {
+    } else if ((*ramp = as_dense_ramp(op->b)) && (b = op->a.template as<Broadcast>())) {
+    } else {
+        return false;
+    }
+    if (b->value.type().is_vector() || b->lanes != (*ramp)->lanes) {
+        return false;
+    }
+    *bound = b->value;
+    return true;
+}
+
+bool match_clamped_ramp(const Expr &index, ClampedRamp *result) {
+    // The simplifier canonicalizes clamp(x, lo, hi) to
+    // max(min(x, hi), lo), but accept the other nesting too.
+    if (const Max *mx = index.as<Max>()) {
+        const Min *mn;
+        const Broadcast *b;
+        if ((mn = mx->a.as<Min>()) && (b = mx->b.as<Broadcast>())) {
+        } else if ((mn = mx->b.as<Min>()) && (b = mx->a.as<Broadcast>())) {
+        } else {
+            return false;
+        }
+        if (b->value.type().is_vector() || !split_clamp_level(mn, &result->ramp, &result->hi)) {
+            return false;
+        }
+        result->lo = b->value;
+        // Lanes below lo always produce lo; lanes above hi produce
+        // max(hi, lo), which matters if the clamp is degenerate.
+        result->lo_index = result->lo;
+        result->hi_index = max(result->hi, result->lo);
+        return b->lanes == result->ramp->lanes;
+    } else if (const Min *mn = index.as<Min>()) {
+        const Max *mx;
+        const Broadcast *b;
+        if ((mx = mn->a.as<Max>()) && (b = mn->b.as<Broadcast>())) {
+        } else if ((mx = mn->b.as<Max>()) && (b = mn->a.as<Broadcast>())) {
+        } else {
+            return false;
+        }
+        if (b->value.type().is_vector() || !split_clamp_level(mx, &result->ramp, &result->lo)) {
+            return false;
+        }
+        result->hi = b->value;
+        result->lo_index = min(result->lo, result->hi);
+        result->hi_index = result->hi;
+        return b->lanes == result->ramp->lanes;
+    }
+    return false;
+}
+
+class PredicateClampedLoads : public IRMutator {
+    using IRMutator::visit;
+
+    const Target &target;
+    DeviceAPI device_api = DeviceAPI::None;
+
+    Stmt visit(const For *op) override {
+        ScopedValue<DeviceAPI> old(device_api,
+                                   op->device_api == DeviceAPI::None ? device_api : op->device_api);
+        return IRMutator::visit(op);
+    }
+
+    Expr visit(const Load *op) override {
+        Expr expr = IRMutator::visit(op);
+        op = expr.as<Load>();
+        if (!op ||
+            op->type.is_scalar() ||
+            !is_const_one(op->predicate)) {
+            return expr;
+        }
+
+        // The profitability of masked loads is only understood for
+        // host code and Hexagon; leave other device code alone.
+        bool in_hexagon = device_api == DeviceAPI::Hexagon;
+        if (device_api != DeviceAPI::None && !in_hexagon) {
+            return expr;
+        }
+
+        ClampedRamp c;
+        if (!match_clamped_ramp(op->index, &c) ||
+            !can_predicate_store_load(target, in_hexagon, op->type.bits(), op->type.lanes())) {
+            return expr;
+        }
+
+        // In-range lanes come from a dense load predicated on being
+        // in range; lanes clamped low or high all read the same edge
+        // address, so blend in a broadcast of each edge value. The
+        // edge loads must be predicated on their clamp actually
+        // engaging: bounds inference only covers the addresses the
+        // original clamped index produces, so when the realized
+        // region stays in the interior the clamp bounds themselves
+        // may lie outside the allocation.
+        int lanes = op->type.lanes();
+        Expr ramp = c.ramp;
+        Expr below = ramp < Broadcast::make(c.lo, lanes);
+        Expr above = ramp > Broadcast::make(c.hi, lanes);
+        // The ramp is dense, so the first lane is the smallest index
+        // and the last lane the largest. The high edge is only
+        // selected for lanes that aren't also below lo (the low clamp
+        // wins in the select below), hence the extra conjunct.
+        Expr first = c.ramp->base;
+        Expr last = c.ramp->base + (lanes - 1);
+        Expr any_below = simplify(first < c.lo);
+        Expr any_above = simplify(last > c.hi && last >= c.lo);
+        Expr dense = Load::make(op->type, op->name, ramp, op->image, op->param,
+                                simplify(!below && !above), ModulusRemainder());
+        Expr edge_lo = Load::make(op->type.element_of(), op->name, c.lo_index,
+                                  op->image, op->param, any_below, ModulusRemainder());
+        Expr edge_hi = Load::make(op->type.element_of(), op->name, c.hi_index,
+                                  op->image, op->param, any_above, ModulusRemainder());
+        return Select::make(below, Broadcast::make(edge_lo, lanes),
+                            Select::make(above, Broadcast::make(edge_hi, lanes), dense));
+    }
+
+public:
+    PredicateClampedLoads(const Target &t)
+        : target(t) {
+    }
+};
+
+}  // namespace
+
+Stmt predicate_clamped_loads(const Stmt &s, const Target &t) {
+    return PredicateClampedLoads(t).mutate(s);
+}
+
+}  // namespace Internal
+}  // namespace Halide
@@ -0,0 +1,31 @@
+#ifndef HALIDE_PREDICATE_CLAMPED_LOADS_H
+#define HALIDE_PREDICATE_CLAMPED_LOADS_H
+
+/** \file
+ * Defines the lowering pass that turns loads through clamped dense
+ * ramps into predicated dense loads.
+ */
+
+#include "Expr.h"
+
+namespace Halide {
+
+struct Target;
+
+namespace Internal {
+
+/** Find vector loads whose index is a clamped dense ramp, as produced
+ * by hand-written boundary conditions like in(clamp(x + i, 0, W - 1)),
+ * and rewrite them into a dense load predicated on the in-range lanes,
+ * blended with broadcasts of the two edge values. Loop partitioning
+ * removes these clamps from the steady state, so this applies to the
+ * prologue and epilogue loops (and to loops that couldn't be
+ * partitioned), where the clamped index would otherwise lower to a
+ * scalar gather per lane. Only fires on targets where a masked vector
+ * load beats the scalarized equivalent. */
+Stmt predicate_clamped_loads(const Stmt &s, const Target &t);
+
+}  // namespace Internal
+}  // namespace Halide
+
+#endif
@@ -193,6 +193,7 @@ private:
     Stmt visit(const For *op) override {
         Stmt body = mutate(op->body);
 
+        vector<std::pair<string, Expr>> distance_lets;
         if (!prefetch_list.empty() && starts_with(op->name, prefix)) {
             // If there are multiple prefetches of the same Func or ImageParam,
             // use the most recent one
@@ -204,7 +205,22 @@ private:
                 }
                 seen.insert(p.name);
 
-                body = add_placeholder_prefetch(op->name, p, body);
+                if (p.adaptive) {
+                    // The prefetch distance is loop invariant but not
+                    // constant: it is fetched from the runtime once per
+                    // entry to this loop nest, so successive entries can
+                    // recalibrate it.
+                    string dist_name = op->name + "." + p.name + ".prefetch_distance";
+                    Expr dist_call = Call::make(Int(32), "halide_prefetch_distance",
+                                                {StringImm::make(p.name), p.offset},
+                                                Call::Extern);
+                    distance_lets.emplace_back(dist_name, dist_call);
+                    PrefetchDirective adjusted = p;
+                    adjusted.offset = Variable::make(Int(32), dist_name);
+                    body = add_placeholder_prefetch(op->name, adjusted, body);
+                } else {
+                    body = add_placeholder_prefetch(op->name, p, body);
+                }
             }
         }
 
@@ -214,6 +230,9 @@ private:
         } else {
             stmt = op;
         }
+        for (const auto &l : distance_lets) {
+            stmt = LetStmt::make(l.first, l.second, stmt);
+        }
         return stmt;
     }
 };
@@ -236,7 +255,7 @@ class ReducePrefetchDimension : public IRMutator {
         // the dimensions with larger strides and keep the smaller ones in
         // the prefetch call.
 
-        size_t max_arg_size = 2 + 2 * max_dim;  // Prefetch: {base, offset, extent0, stride0, extent1, stride1, ...}
+        size_t max_arg_size = 4 + 2 * max_dim;  // Prefetch: {base, offset, rw, locality, extent0, stride0, extent1, stride1, ...}
         if (prefetch && (prefetch->args.size() > max_arg_size)) {
             const Variable *base = prefetch->args[0].as<Variable>();
             internal_assert(base && base->type.is_handle());
@@ -245,7 +264,7 @@ class ReducePrefetchDimension : public IRMutator {
             Expr new_offset = prefetch->args[1];
             for (size_t i = max_arg_size; i < prefetch->args.size(); i += 2) {
                 Expr stride = prefetch->args[i + 1];
-                string index_name = "prefetch_reduce_" + base->name + "." + std::to_string((i - 1) / 2);
+                string index_name = "prefetch_reduce_" + base->name + "." + std::to_string((i - 3) / 2);
                 index_names.push_back(index_name);
                 new_offset += Variable::make(Int(32), index_name) * stride;
             }
@@ -257,8 +276,14 @@ class ReducePrefetchDimension : public IRMutator {
 
             stmt = Evaluate::make(Call::make(prefetch->type, Call::prefetch, args, Call::Intrinsic));
             for (size_t i = 0; i < index_names.size(); ++i) {
-                stmt = For::make(index_names[i], 0, prefetch->args[(i + max_dim) * 2 + 2],
-                                 ForType::Serial, DeviceAPI::None, stmt);
+                Expr extent = prefetch->args[max_arg_size + 2 * i];
+                // For short, constant extents (e.g. the vertical taps of a
+                // stencil), emit the prefetches as straight-line code rather
+                // than a loop. unroll_loops runs after this pass.
+                const int64_t *const_extent = as_const_int(extent);
+                ForType for_type = (const_extent && *const_extent <= 8) ? ForType::Unrolled : ForType::Serial;
+                stmt = For::make(index_names[i], 0, extent,
+                                 for_type, DeviceAPI::None, stmt);
             }
             debug(5) << "\nReduce prefetch to " << max_dim << " dim:\n"
                      << "Before:\n"
@@ -295,32 +320,36 @@ class SplitPrefetch : public IRMutator {
             vector<string> index_names;
             vector<Expr> extents;
             Expr new_offset = prefetch->args[1];
-            for (size_t i = 2; i < prefetch->args.size(); i += 2) {
+            for (size_t i = 4; i < prefetch->args.size(); i += 2) {
                 Expr extent = prefetch->args[i];
                 Expr stride = prefetch->args[i + 1];
                 Expr stride_bytes = stride * elem_size;
 
-                string index_name = "prefetch_split_" + base->name + "." + std::to_string((i - 1) / 2);
+                string index_name = "prefetch_split_" + base->name + "." + std::to_string((i - 3) / 2);
                 index_names.push_back(index_name);
 
                 Expr is_negative_stride = (stride < 0);
                 Expr outer_var = Variable::make(Int(32), index_name);
                 Expr outer_extent;
+                // Note that the offset is in elements of the prefetched
+                // type, not bytes, so the step per iteration must be too.
                 if (can_prove(max_byte_size < stride_bytes) || can_prove(max_byte_size < -stride_bytes)) {
                     // If 'max_byte_size' is smaller than the absolute value of the
                     // stride bytes, we can only prefetch one element per iteration.
                     outer_extent = extent;
-                    new_offset += outer_var * stride_bytes;
+                    new_offset += outer_var * stride;
                 } else {
                     // Otherwise, we just prefetch 'max_byte_size' per iteration.
                     Expr abs_stride_bytes = Call::make(stride_bytes.type(), Call::abs, {stride_bytes}, Call::PureIntrinsic);
                     outer_extent = simplify((extent * abs_stride_bytes + max_byte_size - 1) / max_byte_size);
-                    new_offset += outer_var * simplify(select(is_negative_stride, -max_byte_size, max_byte_size));
+                    Expr elems_per_iter = simplify(max_byte_size / elem_size);
+                    new_offset += outer_var * select(is_negative_stride, -elems_per_iter, elems_per_iter);
                 }
                 extents.push_back(outer_extent);
             }
 
-            vector<Expr> args = {base, new_offset, Expr(1), simplify(max_byte_size / elem_size)};
+            vector<Expr> args = {base, new_offset, prefetch->args[2], prefetch->args[3],
+                                 Expr(1), simplify(max_byte_size / elem_size)};
             stmt = Evaluate::make(Call::make(prefetch->type, Call::prefetch, args, Call::Intrinsic));
             for (size_t i = 0; i < index_names.size(); ++i) {
                 stmt = For::make(index_names[i], 0, extents[i],
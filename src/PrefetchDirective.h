@@ -32,6 +32,22 @@ enum class PrefetchBoundStrategy {
     NonFaulting
 };
 
+/** Which levels of the cache hierarchy a prefetch should populate.
+ * On x86 these map to the prefetcht0/t1/nta instructions, and on
+ * other architectures to the closest equivalent hint. */
+enum class PrefetchLocality {
+    /** Non-temporal: fetch with minimal cache pollution, for data
+     * that will be read once and discarded. */
+    NTA,
+
+    /** Fetch into the L2 cache but not L1, for data that will be
+     * needed soon but not immediately. */
+    L2,
+
+    /** Fetch into all levels of the cache hierarchy. The default. */
+    L1
+};
+
 namespace Internal {
 
 struct PrefetchDirective {
@@ -39,6 +55,16 @@ struct PrefetchDirective {
     std::string var;
     Expr offset;
     PrefetchBoundStrategy strategy;
+    PrefetchLocality locality;
+    // If true, prefetch with intent to write (prefetchw on x86),
+    // acquiring the cache line in an exclusive state. Useful when
+    // prefetching the output tile of the next loop iteration.
+    bool for_write;
+    // If true, 'offset' is only the initial prefetch distance. The actual
+    // distance is fetched from the runtime on entry to the prefetch loop
+    // nest, so it can be recalibrated as the pipeline runs. See
+    // \ref Func::prefetch_adaptive.
+    bool adaptive;
     // If it's a prefetch load from an image parameter, this points to that.
     Parameter param;
 };
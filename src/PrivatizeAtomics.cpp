@@ -0,0 +1,387 @@
+#include "PrivatizeAtomics.h"
+
+#include "IREquality.h"
+#include "IRMutator.h"
+#include "IROperator.h"
+#include "IRVisitor.h"
+#include "Scope.h"
+#include "Util.h"
+
+#include <map>
+#include <set>
+#include <vector>
+
+namespace Halide {
+namespace Internal {
+
+using std::map;
+using std::set;
+using std::string;
+using std::vector;
+
+namespace {
+
+// Privatization trades memory for contention, so only allocations of at
+// most this many elements get private copies (a 4096-bin histogram of
+// 32-bit counters costs 16KB per task).
+const int64_t max_privatized_elements = 4096;
+
+// Cap on the number of private copies, in case the host reports a
+// pathological core count.
+const int max_private_copies = 64;
+
+enum class ReduceOp { Add,
+                      Mul,
+                      Min,
+                      Max };
+
+Expr combine(ReduceOp reduce_op, Expr a, Expr b) {
+    switch (reduce_op) {
+    case ReduceOp::Add:
+        return Add::make(std::move(a), std::move(b));
+    case ReduceOp::Mul:
+        return Mul::make(std::move(a), std::move(b));
+    case ReduceOp::Min:
+        return Min::make(std::move(a), std::move(b));
+    case ReduceOp::Max:
+        return Max::make(std::move(a), std::move(b));
+    }
+    return Expr();
+}
+
+Expr identity(ReduceOp reduce_op, Type t) {
+    switch (reduce_op) {
+    case ReduceOp::Add:
+        return make_zero(t);
+    case ReduceOp::Mul:
+        return make_one(t);
+    case ReduceOp::Min:
+        return t.max();
+    case ReduceOp::Max:
+        return t.min();
+    }
+    return Expr();
+}
+
+struct AllocInfo {
+    Type type;
+    int64_t flat_extent;
+};
+
+// Match an Atomic node of the shape left behind for an associative
+// read-modify-write update that needs no mutex, e.g.
+//   atomic { hist[idx] = hist[idx] + v }
+// On a match, returns the Store and reports the operator and the
+// partial value being folded in.
+const Store *match_rmw_update(const Atomic *node, const Scope<AllocInfo> &allocations,
+                              ReduceOp *reduce_op, Expr *partial) {
+    if (!node->mutex_name.empty()) {
+        return nullptr;
+    }
+    Stmt s = node->body;
+    while (const LetStmt *let = s.as<LetStmt>()) {
+        s = let->body;
+    }
+    const Store *store = s.as<Store>();
+    if (!store ||
+        !allocations.contains(store->name) ||
+        !is_const_one(store->predicate) ||
+        !store->value.type().is_scalar()) {
+        return nullptr;
+    }
+
+    Expr a, b;
+    if (const Add *op = store->value.as<Add>()) {
+        *reduce_op = ReduceOp::Add;
+        a = op->a;
+        b = op->b;
+    } else if (const Mul *op = store->value.as<Mul>()) {
+        *reduce_op = ReduceOp::Mul;
+        a = op->a;
+        b = op->b;
+    } else if (const Min *op = store->value.as<Min>()) {
+        *reduce_op = ReduceOp::Min;
+        a = op->a;
+        b = op->b;
+    } else if (const Max *op = store->value.as<Max>()) {
+        *reduce_op = ReduceOp::Max;
+        a = op->a;
+        b = op->b;
+    } else {
+        return nullptr;
+    }
+
+    auto is_self_load = [&](const Expr &e) {
+        const Load *load = e.as<Load>();
+        return load &&
+               load->name == store->name &&
+               is_const_one(load->predicate) &&
+               equal(load->index, store->index);
+    };
+    if (is_self_load(a)) {
+        *partial = b;
+    } else if (is_self_load(b)) {
+        *partial = a;
+    } else {
+        return nullptr;
+    }
+    return store;
+}
+
+// Scan the body of a parallel loop for privatizable atomic updates.
+// Any access to a tracked allocation outside of such an update
+// disqualifies it: a privatized buffer only holds partial results
+// while the loop runs, so nothing else may observe it.
+class FindPrivatizableUpdates : public IRVisitor {
+public:
+    FindPrivatizableUpdates(const Scope<AllocInfo> &allocations)
+        : allocations(allocations) {
+    }
+
+    // The matched Atomic nodes, grouped by the buffer they update
+    map<string, vector<const Atomic *>> matches;
+    map<string, ReduceOp> ops;
+    set<string> disqualified;
+
+protected:
+    const Scope<AllocInfo> &allocations;
+
+    using IRVisitor::visit;
+
+    void visit(const Atomic *op) override {
+        ReduceOp reduce_op;
+        Expr partial;
+        const Store *store = match_rmw_update(op, allocations, &reduce_op, &partial);
+        if (store) {
+            // The partial value, the store index, and any lets wrapping
+            // the store may still reference other candidates (or this
+            // one); those accesses are loads of possibly-stale partial
+            // results, so they disqualify.
+            partial.accept(this);
+            store->index.accept(this);
+            Stmt s = op->body;
+            while (const LetStmt *let = s.as<LetStmt>()) {
+                let->value.accept(this);
+                s = let->body;
+            }
+            auto it = ops.find(store->name);
+            if (it != ops.end() && it->second != reduce_op) {
+                // mixing operators is not a single associative reduction
+                disqualified.insert(store->name);
+            } else {
+                ops[store->name] = reduce_op;
+                matches[store->name].push_back(op);
+            }
+            return;
+        }
+        IRVisitor::visit(op);
+    }
+
+    void visit(const Store *op) override {
+        if (allocations.contains(op->name)) {
+            disqualified.insert(op->name);
+        }
+        IRVisitor::visit(op);
+    }
+
+    void visit(const Load *op) override {
+        if (allocations.contains(op->name)) {
+            disqualified.insert(op->name);
+        }
+        IRVisitor::visit(op);
+    }
+
+    void visit(const Variable *op) override {
+        // e.g. the .buffer object handed to an extern stage
+        if (ends_with(op->name, ".buffer") &&
+            allocations.contains(op->name.substr(0, op->name.size() - 7))) {
+            disqualified.insert(op->name.substr(0, op->name.size() - 7));
+        }
+        IRVisitor::visit(op);
+    }
+};
+
+// Retarget the matched atomic updates at this task's slice of the
+// private copies, dropping the Atomic wrappers along the way.
+class RewriteMatchedStores : public IRMutator {
+public:
+    RewriteMatchedStores(const set<const Atomic *> &matched,
+                         const map<string, Expr> &slice_offset)
+        : matched(matched), slice_offset(slice_offset) {
+    }
+
+protected:
+    const set<const Atomic *> &matched;
+    // buffer name -> offset of this task's slice in the private copies
+    const map<string, Expr> &slice_offset;
+    bool in_matched_update = false;
+
+    using IRMutator::visit;
+
+    Stmt visit(const Atomic *op) override {
+        if (matched.count(op)) {
+            ScopedValue<bool> old(in_matched_update, true);
+            return mutate(op->body);
+        }
+        return IRMutator::visit(op);
+    }
+
+    Stmt visit(const Store *op) override {
+        auto it = slice_offset.find(op->name);
+        if (in_matched_update && it != slice_offset.end()) {
+            return Store::make(op->name + ".private", mutate(op->value),
+                               mutate(op->index) + it->second,
+                               Parameter(), op->predicate, ModulusRemainder());
+        }
+        return IRMutator::visit(op);
+    }
+
+    Expr visit(const Load *op) override {
+        auto it = slice_offset.find(op->name);
+        if (in_matched_update && it != slice_offset.end()) {
+            return Load::make(op->type, op->name + ".private",
+                              mutate(op->index) + it->second,
+                              Buffer<>(), Parameter(), op->predicate, ModulusRemainder());
+        }
+        return IRMutator::visit(op);
+    }
+};
+
+class PrivatizeAtomics : public IRMutator {
+    using IRMutator::visit;
+
+    Scope<AllocInfo> allocations;
+
+    Stmt visit(const Allocate *op) override {
+        int64_t flat_extent = 1;
+        bool trackable = op->type.is_scalar() &&
+                         !op->new_expr.defined() &&
+                         is_const_one(op->condition);
+        for (const Expr &e : op->extents) {
+            const int64_t *extent = as_const_int(e);
+            if (!extent) {
+                trackable = false;
+                break;
+            }
+            flat_extent *= *extent;
+        }
+        if (!trackable || flat_extent <= 0 || flat_extent > max_privatized_elements) {
+            return IRMutator::visit(op);
+        }
+        ScopedBinding<AllocInfo> bind(allocations, op->name,
+                                      AllocInfo{op->type, flat_extent});
+        return IRMutator::visit(op);
+    }
+
+    Stmt visit(const For *op) override {
+        if (op->for_type != ForType::Parallel) {
+            return IRMutator::visit(op);
+        }
+        Stmt body = mutate(op->body);
+
+        FindPrivatizableUpdates finder(allocations);
+        body.accept(&finder);
+
+        struct Candidate {
+            string name;
+            Type type;
+            int64_t flat_extent;
+            ReduceOp reduce_op;
+        };
+        vector<Candidate> candidates;
+        set<const Atomic *> matched;
+        for (const auto &p : finder.matches) {
+            if (finder.disqualified.count(p.first)) {
+                continue;
+            }
+            const AllocInfo &info = allocations.get(p.first);
+            candidates.push_back({p.first, info.type, info.flat_extent,
+                                  finder.ops[p.first]});
+            matched.insert(p.second.begin(), p.second.end());
+        }
+
+        if (candidates.empty()) {
+            return For::make(op->name, op->min, op->extent,
+                             op->for_type, op->device_api, body);
+        }
+
+        // One private copy of each updated buffer per worker thread. The
+        // parallel loop is re-chunked into exactly that many coarse
+        // tasks, so the task index can double as the private copy index.
+        Expr num_copies = Call::make(Int(32), "halide_host_cpu_count", {}, Call::Extern);
+        num_copies = max(min(num_copies, max_private_copies), 1);
+        string copies_name = unique_name(op->name + ".num_private_copies");
+        Expr copies_var = Variable::make(Int(32), copies_name);
+
+        string task_name = unique_name(op->name + ".task");
+        Expr task_var = Variable::make(Int(32), task_name);
+
+        map<string, Expr> slice_offset;
+        for (const Candidate &c : candidates) {
+            slice_offset[c.name] = task_var * (int)c.flat_extent;
+        }
+        body = RewriteMatchedStores(matched, slice_offset).mutate(body);
+
+        // Task t runs iterations [min + t*task_size, min + (t+1)*task_size)
+        // of the original loop, clipped to the original bounds.
+        string task_size_name = unique_name(op->name + ".task_size");
+        Expr task_size_var = Variable::make(Int(32), task_size_name);
+        string within_name = unique_name(op->name + ".within_task");
+        Expr within_var = Variable::make(Int(32), within_name);
+
+        body = LetStmt::make(op->name, op->min + task_var * task_size_var + within_var, body);
+        body = IfThenElse::make(task_var * task_size_var + within_var < op->extent, body);
+        body = For::make(within_name, 0, task_size_var, ForType::Serial, op->device_api, body);
+        Stmt loop = For::make(task_name, 0, copies_var, ForType::Parallel, op->device_api, body);
+        loop = LetStmt::make(task_size_name,
+                             (op->extent + copies_var - 1) / copies_var, loop);
+
+        // Initialize the private copies to the reduction identity before
+        // the loop, and fold them back into the original buffer after it.
+        vector<Stmt> stmts;
+        for (const Candidate &c : candidates) {
+            string t_name = unique_name(c.name + ".init_copy");
+            string i_name = unique_name(c.name + ".init_elem");
+            Expr idx = Variable::make(Int(32), t_name) * (int)c.flat_extent +
+                       Variable::make(Int(32), i_name);
+            Stmt init = Store::make(c.name + ".private", identity(c.reduce_op, c.type),
+                                    idx, Parameter(), const_true(), ModulusRemainder());
+            init = For::make(i_name, 0, (int)c.flat_extent, ForType::Serial, DeviceAPI::None, init);
+            init = For::make(t_name, 0, copies_var, ForType::Serial, DeviceAPI::None, init);
+            stmts.push_back(init);
+        }
+        stmts.push_back(loop);
+        for (const Candidate &c : candidates) {
+            string t_name = unique_name(c.name + ".merge_copy");
+            string i_name = unique_name(c.name + ".merge_elem");
+            Expr i_var = Variable::make(Int(32), i_name);
+            Expr partial = Load::make(c.type, c.name + ".private",
+                                      Variable::make(Int(32), t_name) * (int)c.flat_extent + i_var,
+                                      Buffer<>(), Parameter(), const_true(), ModulusRemainder());
+            Expr prev = Load::make(c.type, c.name, i_var,
+                                   Buffer<>(), Parameter(), const_true(), ModulusRemainder());
+            Stmt merge = Store::make(c.name, combine(c.reduce_op, prev, partial),
+                                     i_var, Parameter(), const_true(), ModulusRemainder());
+            merge = For::make(t_name, 0, copies_var, ForType::Serial, DeviceAPI::None, merge);
+            merge = For::make(i_name, 0, (int)c.flat_extent, ForType::Serial, DeviceAPI::None, merge);
+            stmts.push_back(merge);
+        }
+
+        Stmt result = Block::make(stmts);
+        for (const Candidate &c : candidates) {
+            result = Allocate::make(c.name + ".private", c.type, MemoryType::Auto,
+                                    {(int)c.flat_extent, copies_var}, const_true(), result);
+        }
+        result = LetStmt::make(copies_name, num_copies, result);
+        return result;
+    }
+};
+
+}  // namespace
+
+Stmt privatize_atomics(Stmt s) {
+    return PrivatizeAtomics().mutate(s);
+}
+
+}  // namespace Internal
+}  // namespace Halide
@@ -0,0 +1,20 @@
+#ifndef HALIDE_PRIVATIZE_ATOMICS_H
+#define HALIDE_PRIVATIZE_ATOMICS_H
+
+#include "Expr.h"
+
+/** \file
+ * Defines the lowering pass that rewrites contended atomic updates to
+ * small allocations (e.g. histograms) into accumulation onto per-task
+ * private copies followed by a merge, so the hot loop runs without any
+ * atomic instructions. */
+
+namespace Halide {
+namespace Internal {
+
+Stmt privatize_atomics(Stmt s);
+
+}  // namespace Internal
+}  // namespace Halide
+
+#endif
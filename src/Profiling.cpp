@@ -21,6 +21,44 @@ using std::vector;
 
 namespace {
 
+struct AllocSize {
+    bool on_stack;
+    Expr size;
+};
+
+Expr compute_allocation_size(const vector<Expr> &extents,
+                             const Expr &condition,
+                             const Type &type,
+                             const std::string &name,
+                             bool &on_stack) {
+    on_stack = true;
+
+    Expr cond = simplify(condition);
+    if (is_const_zero(cond)) {  // Condition always false
+        return make_zero(UInt(64));
+    }
+
+    int64_t constant_size = Allocate::constant_allocation_size(extents, name);
+    if (constant_size > 0) {
+        int64_t stack_bytes = constant_size * type.bytes();
+        if (can_allocation_fit_on_stack(stack_bytes)) {  // Allocation on stack
+            return make_const(UInt(64), stack_bytes);
+        }
+    }
+
+    // Check that the allocation is not scalar (if it were scalar
+    // it would have constant size).
+    internal_assert(!extents.empty());
+
+    on_stack = false;
+    Expr size = cast<uint64_t>(extents[0]);
+    for (size_t i = 1; i < extents.size(); i++) {
+        size *= extents[i];
+    }
+    size = simplify(Select::make(condition, size * type.bytes(), make_zero(UInt(64))));
+    return size;
+}
+
 class InjectProfiling : public IRMutator {
 
 public:
@@ -54,11 +92,6 @@ private:
     Expr profiler_state;
     Expr profiler_token;
 
-    struct AllocSize {
-        bool on_stack;
-        Expr size;
-    };
-
     Scope<AllocSize> func_alloc_sizes;
 
     bool profiling_memory = true;
@@ -89,39 +122,6 @@ private:
                                          {profiler_state, profiler_token, id}, Call::Extern));
     }
 
-    Expr compute_allocation_size(const vector<Expr> &extents,
-                                 const Expr &condition,
-                                 const Type &type,
-                                 const std::string &name,
-                                 bool &on_stack) {
-        on_stack = true;
-
-        Expr cond = simplify(condition);
-        if (is_const_zero(cond)) {  // Condition always false
-            return make_zero(UInt(64));
-        }
-
-        int64_t constant_size = Allocate::constant_allocation_size(extents, name);
-        if (constant_size > 0) {
-            int64_t stack_bytes = constant_size * type.bytes();
-            if (can_allocation_fit_on_stack(stack_bytes)) {  // Allocation on stack
-                return make_const(UInt(64), stack_bytes);
-            }
-        }
-
-        // Check that the allocation is not scalar (if it were scalar
-        // it would have constant size).
-        internal_assert(!extents.empty());
-
-        on_stack = false;
-        Expr size = cast<uint64_t>(extents[0]);
-        for (size_t i = 1; i < extents.size(); i++) {
-            size *= extents[i];
-        }
-        size = simplify(Select::make(condition, size * type.bytes(), make_zero(UInt(64))));
-        return size;
-    }
-
     Stmt visit(const Allocate *op) override {
         int idx = get_func_id(op->name);
 
@@ -318,6 +318,50 @@ private:
     }
 };
 
+// The telemetry version of the above: no per-func accounting, just a
+// running total and high-water mark of the heap allocations.
+class InjectTelemetry : public IRMutator {
+    using IRMutator::visit;
+
+    Scope<AllocSize> func_alloc_sizes;
+
+    Stmt visit(const Allocate *op) override {
+        bool on_stack;
+        Expr size = compute_allocation_size(op->extents, op->condition, op->type, op->name, on_stack);
+        func_alloc_sizes.push(op->name, {on_stack, size});
+        Stmt stmt = IRMutator::visit(op);
+        if (!is_const_zero(size) && !on_stack) {
+            Stmt track = Evaluate::make(Call::make(Int(32), "halide_telemetry_track_allocation",
+                                                   {size}, Call::Extern));
+            stmt = Block::make(track, stmt);
+        }
+        return stmt;
+    }
+
+    Stmt visit(const Free *op) override {
+        AllocSize alloc = func_alloc_sizes.get(op->name);
+        func_alloc_sizes.pop(op->name);
+        Stmt stmt = IRMutator::visit(op);
+        if (!is_const_zero(alloc.size) && !alloc.on_stack) {
+            Stmt track = Evaluate::make(Call::make(Int(32), "halide_telemetry_track_free",
+                                                   {alloc.size}, Call::Extern));
+            stmt = Block::make(stmt, track);
+        }
+        return stmt;
+    }
+
+    Stmt visit(const For *op) override {
+        // The counters live in host memory; don't instrument
+        // allocations inside device loops.
+        if (op->device_api == DeviceAPI::None ||
+            op->device_api == DeviceAPI::Host) {
+            return IRMutator::visit(op);
+        } else {
+            return op;
+        }
+    }
+};
+
 }  // namespace
 
 Stmt inject_profiling(Stmt s, const string &pipeline_name) {
@@ -391,5 +435,18 @@ Stmt inject_profiling(Stmt s, const string &pipeline_name) {
     return s;
 }
 
+Stmt inject_telemetry(Stmt s, const string &pipeline_name) {
+    InjectTelemetry telemetry;
+    s = telemetry.mutate(s);
+
+    Expr start_time = Variable::make(Int(64), "telemetry_start_time");
+    Expr start = Call::make(Int(64), "halide_telemetry_pipeline_start", {}, Call::Extern);
+    Stmt report = Evaluate::make(Call::make(Int(32), "halide_telemetry_pipeline_end",
+                                            {pipeline_name, start_time}, Call::Extern));
+    s = Block::make(s, report);
+    s = LetStmt::make("telemetry_start_time", start, s);
+    return s;
+}
+
 }  // namespace Internal
 }  // namespace Halide
@@ -39,6 +39,15 @@ namespace Internal {
  */
 Stmt inject_profiling(Stmt, const std::string &);
 
+/** Take a statement representing a halide pipeline and insert the
+ * lightweight telemetry hooks: a timestamp pair bracketing the
+ * invocation, a counter update per heap allocation, and a call to the
+ * handler registered with halide_set_telemetry_report at the end.
+ * Unlike full profiling there is no sampling thread and no per-func
+ * accounting, so the overhead is small enough to leave enabled in
+ * production. */
+Stmt inject_telemetry(Stmt, const std::string &);
+
 }  // namespace Internal
 }  // namespace Halide
 
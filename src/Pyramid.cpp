@@ -0,0 +1,101 @@
+#include "Pyramid.h"
+
+#include "IROperator.h"
+
+namespace Halide {
+
+Pyramid::Pyramid(const Func &input, int levels, const std::string &name) {
+    user_assert(input.defined()) << "Pyramid requires a defined input Func.\n";
+    user_assert(input.dimensions() >= 2)
+        << "Pyramid input " << input.name() << " must have at least two dimensions.\n";
+    user_assert(levels >= 1) << "Pyramid must have at least one level.\n";
+    level_funcs.push_back(input);
+    for (int j = 1; j < levels; j++) {
+        level_funcs.push_back(downsample(level_funcs.back(), name + "_" + std::to_string(j)));
+    }
+}
+
+Func Pyramid::operator[](int level) const {
+    user_assert(level >= 0 && level < levels())
+        << "Pyramid level " << level << " is out of range; the pyramid has "
+        << levels() << " levels.\n";
+    return level_funcs[level];
+}
+
+Func Pyramid::downsample(const Func &f, const std::string &name) {
+    user_assert(f.defined()) << "downsample requires a defined Func.\n";
+    user_assert(f.dimensions() >= 2)
+        << "downsample of " << f.name() << " requires at least two dimensions.\n";
+    user_assert(f.output_types().size() == 1)
+        << "downsample of the Tuple-valued Func " << f.name() << " is not supported.\n";
+
+    Type t = f.output_types()[0];
+    // Widen integer types so the filter taps can't overflow.
+    Type wide = t.is_float() ? t : (t.bits() <= 16 ? Int(32) : Int(64));
+    auto w = [&](const Expr &e) { return cast(wide, e); };
+
+    Var x("x"), y("y");
+    Func downx(name + "_x"), downy(name);
+    downx(x, y, _) = (w(f(2 * x - 1, y, _)) +
+                      3 * (w(f(2 * x, y, _)) + w(f(2 * x + 1, y, _))) +
+                      w(f(2 * x + 2, y, _))) /
+                     8;
+    downy(x, y, _) = cast(t, (downx(x, 2 * y - 1, _) +
+                              3 * (downx(x, 2 * y, _) + downx(x, 2 * y + 1, _)) +
+                              downx(x, 2 * y + 2, _)) /
+                                 8);
+    return downy;
+}
+
+Func Pyramid::upsample(const Func &f, const std::string &name) {
+    user_assert(f.defined()) << "upsample requires a defined Func.\n";
+    user_assert(f.dimensions() >= 2)
+        << "upsample of " << f.name() << " requires at least two dimensions.\n";
+
+    Var x("x"), y("y");
+    Func upx(name + "_x"), upy(name);
+    upx(x, y, _) = lerp(f(x / 2, y, _), f((x + 1) / 2, y, _), ((x % 2) * 2 + 1) / 4.0f);
+    upy(x, y, _) = lerp(upx(x, y / 2, _), upx(x, (y + 1) / 2, _), ((y % 2) * 2 + 1) / 4.0f);
+    return upy;
+}
+
+Pyramid &Pyramid::schedule_cpu(int vector_size, int strip_size) {
+    user_assert(vector_size >= 1 && strip_size >= 1)
+        << "Pyramid::schedule_cpu requires positive vector and strip sizes.\n";
+
+    const int n = levels();
+    std::vector<Var> strip_vars(n);
+    // Walk from the coarsest level down so each level can be computed
+    // at the strip loop of the level that consumes it.
+    for (int j = n - 1; j >= 1; j--) {
+        Func level = level_funcs[j];
+        Var x = level.args()[0];
+        Var y = level.args()[1];
+        Var yo(level.name() + "_yo");
+        strip_vars[j] = yo;
+        level.split(y, yo, y, strip_size).vectorize(x, vector_size);
+        if (j == n - 1) {
+            level.compute_root().parallel(yo);
+        } else {
+            level.compute_at(level_funcs[j + 1], strip_vars[j + 1]);
+        }
+    }
+    return *this;
+}
+
+Pyramid &Pyramid::schedule_gpu() {
+    const int n = levels();
+    for (int j = 1; j < n; j++) {
+        Func level = level_funcs[j];
+        Var x = level.args()[0];
+        Var y = level.args()[1];
+        Var xi(level.name() + "_xi"), yi(level.name() + "_yi");
+        // Coarse levels have little parallelism left; use small blocks.
+        const int block_w = j > 3 ? 2 : 16;
+        const int block_h = j > 3 ? 2 : 8;
+        level.compute_root().gpu_tile(x, y, xi, yi, block_w, block_h);
+    }
+    return *this;
+}
+
+}  // namespace Halide
@@ -0,0 +1,78 @@
+#ifndef HALIDE_PYRAMID_H
+#define HALIDE_PYRAMID_H
+
+/** \file
+ * Support for building image pyramids from Halide::Funcs.
+ */
+
+#include <string>
+#include <vector>
+
+#include "Func.h"
+
+namespace Halide {
+
+/** A Gaussian image pyramid built from a Func. Level 0 is the input
+ * Func itself; each subsequent level is the previous one downsampled
+ * by a factor of two in the first two dimensions using the binomial
+ * [1 3 3 1]/8 filter in x and then y. Any further dimensions pass
+ * through unmodified. The input must be defined at the coordinates the
+ * downsampling stencil reaches outside each level's region of
+ * interest, e.g. by imposing a boundary condition first (see
+ * \ref BoundaryConditions).
+ *
+ * The levels form a single schedulable group. By default nothing is
+ * scheduled, so levels can be scheduled individually via operator[],
+ * but the schedule_cpu and schedule_gpu presets apply tuned schedules
+ * for generating the whole pyramid in one go. */
+class Pyramid {
+public:
+    Pyramid() = default;
+
+    /** Build a pyramid with the given number of levels (including the
+     * input as level 0) over the first two dimensions of 'input'. */
+    Pyramid(const Func &input, int levels, const std::string &name = "pyramid");
+
+    /** The number of levels, including the input. */
+    int levels() const {
+        return (int)level_funcs.size();
+    }
+
+    /** Get a level of the pyramid. Level 0 is the input Func. */
+    Func operator[](int level) const;
+
+    /** Downsample a Func by a factor of two in its first two
+     * dimensions with the binomial [1 3 3 1]/8 filter, and upsample by
+     * a factor of two using bilinear interpolation. These are the
+     * stencils the pyramid levels use, exposed so that matching
+     * Laplacian-style pyramids can be built from the same kernels.
+     * Integer types are widened to 32 bits internally and cast back. */
+    // @{
+    static Func downsample(const Func &f, const std::string &name = "downsample");
+    static Func upsample(const Func &f, const std::string &name = "upsample");
+    // @}
+
+    /** Tuned CPU schedule: the coarsest level is computed in parallel
+     * strips of rows, and each finer level is computed in strips at
+     * the strip loop of the level that consumes it, so adjacent levels
+     * fuse and each level's tile is consumed while still in cache.
+     * Every level is vectorized over x. The input (level 0) is left
+     * unscheduled. Note that with this schedule the intermediate
+     * levels are computed inside the coarsest level's loop nest, so
+     * anything else that consumes them must do so from within it. */
+    Pyramid &schedule_cpu(int vector_size = 8, int strip_size = 32);
+
+    /** Tuned GPU schedule: each level is computed at root as a grid of
+     * thread blocks, with smaller blocks for the coarse levels where
+     * there is little parallelism left. Cross-level fusion rarely pays
+     * on GPU, so levels are not fused. The input (level 0) is left
+     * unscheduled. */
+    Pyramid &schedule_gpu();
+
+private:
+    std::vector<Func> level_funcs;
+};
+
+}  // namespace Halide
+
+#endif  // HALIDE_PYRAMID_H
@@ -25,6 +25,7 @@ private:
     std::vector<std::string> buffer_refs;
 
     void compile(const LoweredFunc &f);
+    void compile_fast_entry(const LoweredFunc &f);
     void convert_buffer(const std::string &name, const LoweredArgument *arg);
     void release_buffers(const std::string &prefix);
 };
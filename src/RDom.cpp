@@ -243,6 +243,24 @@ void RDom::where(Expr predicate) {
     dom.where(std::move(predicate));
 }
 
+void RDom::tile(const RVar &v, const RVar &outer, const RVar &inner, const Expr &factor) {
+    user_assert(dom.defined()) << "Error: Can't tile an undefined RDom.\n";
+    user_assert(!dom.frozen())
+        << (*this) << " cannot be tiled, because it has already"
+        << " been used in the update definition of some function.\n";
+    user_assert(factor.defined() && factor.type().is_int())
+        << "Tile factor for " << v.name() << " must be an integer expression.\n";
+    bool found = false;
+    for (const ReductionVariable &rv : dom.domain()) {
+        found |= (rv.var == v.name());
+    }
+    user_assert(found)
+        << "In call to RDom::tile, " << v.name()
+        << " is not one of the variables of:\n"
+        << (*this) << "\n";
+    dom.schedule_tile(v.name(), outer.name(), inner.name(), factor);
+}
+
 /** Emit an RVar in a human-readable form */
 std::ostream &operator<<(std::ostream &stream, const RVar &v) {
     stream << v.name() << "(" << v.min() << ", " << v.extent() << ")";
@@ -330,6 +330,30 @@ public:
      */
     void where(Expr predicate);
 
+    /** Split the reduction variable v into an outer and inner pair,
+     * so that every update definition that later uses this RDom
+     * iterates over the reduction in blocks of 'factor': the inner
+     * variable is placed innermost, and the outer variable is hoisted
+     * outside the pure variables of the update. Each block of the
+     * reduction is thus applied to every output point before the next
+     * block begins, which keeps the slice of input the block touches
+     * resident in cache across the outputs — the access pattern the
+     * apps/linear_algebra schedules construct by hand for GEMM, but
+     * without needing an intermediate Func and rfactor. The split is
+     * exact (a partial tail block is guarded with an if rather than
+     * over-iterated), and outer and inner can be scheduled further
+     * through the usual Stage interface:
+     \code
+     RDom r(0, 4096);
+     RVar rxo, rxi;
+     r.tile(r.x, rxo, rxi, 64);
+     f(x) += in(x + r.x) * k(r.x);
+     f.update().reorder(x, rxo).vectorize(x, 8);
+     \endcode
+     * Must be called before the RDom is used in an update
+     * definition. */
+    void tile(const RVar &v, const RVar &outer, const RVar &inner, const Expr &factor);
+
     /** Direct access to the first four dimensions of the reduction
      * domain. Some of these variables may be undefined if the
      * reduction domain has fewer than four dimensions. */
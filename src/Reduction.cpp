@@ -94,6 +94,7 @@ void split_predicate_test() {
 struct ReductionDomainContents {
     mutable RefCount ref_count;
     std::vector<ReductionVariable> domain;
+    std::vector<ReductionTile> tiles;
     Expr predicate;
     bool frozen = false;
 
@@ -152,6 +153,7 @@ ReductionDomain ReductionDomain::deep_copy() const {
         return ReductionDomain();
     }
     ReductionDomain copy(contents->domain);
+    copy.contents->tiles = contents->tiles;
     copy.contents->predicate = contents->predicate;
     copy.contents->frozen = contents->frozen;
     return copy;
@@ -206,6 +208,19 @@ std::vector<Expr> ReductionDomain::split_predicate() const {
     return predicates;
 }
 
+void ReductionDomain::schedule_tile(const std::string &old_var, const std::string &outer,
+                                    const std::string &inner, const Expr &factor) {
+    for (const ReductionTile &t : contents->tiles) {
+        user_assert(t.old_var != old_var)
+            << "Reduction variable " << old_var << " has already been tiled\n";
+    }
+    contents->tiles.push_back({old_var, outer, inner, factor});
+}
+
+const std::vector<ReductionTile> &ReductionDomain::tiles() const {
+    return contents->tiles;
+}
+
 void ReductionDomain::freeze() {
     contents->frozen = true;
 }
@@ -26,6 +26,14 @@ struct ReductionVariable {
     };
 };
 
+/** A deferred split of one reduction variable into an outer/inner
+ * pair, recorded by RDom::tile and applied to the schedule of each
+ * update definition that uses the domain. */
+struct ReductionTile {
+    std::string old_var, outer, inner;
+    Expr factor;
+};
+
 struct ReductionDomainContents;
 
 /** A reference-counted handle on a reduction domain, which is just a
@@ -87,6 +95,14 @@ public:
      * empty vector. */
     std::vector<Expr> split_predicate() const;
 
+    /** Record a deferred tiling of one of the reduction
+     * variables. See \ref RDom::tile. */
+    void schedule_tile(const std::string &old_var, const std::string &outer,
+                       const std::string &inner, const Expr &factor);
+
+    /** The deferred tilings recorded on this domain by RDom::tile. */
+    const std::vector<ReductionTile> &tiles() const;
+
     /** Mark RDom as frozen, which means it cannot accept new predicates. An
      * RDom is frozen once it is used in a Func's update definition. */
     void freeze();
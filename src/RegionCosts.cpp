@@ -1,4 +1,8 @@
+#include <cstdio>
+#include <sstream>
+
 #include "RegionCosts.h"
+#include "Bounds.h"
 #include "FindCalls.h"
 #include "Function.h"
 #include "IRMutator.h"
@@ -795,6 +799,215 @@ void RegionCosts::disp_func_costs() {
     debug(0) << "===========================\n";
 }
 
+std::string print_performance_report(const vector<Function> &outputs,
+                                     const map<string, Function> &env,
+                                     const vector<string> &order,
+                                     uint64_t last_level_cache_size) {
+    RegionCosts costs(env, order);
+
+    FuncValueBounds func_val_bounds = compute_function_value_bounds(order, env);
+
+    // Concrete region of each Func and input in the pipeline, propagated
+    // from the estimates on the outputs down to the producers. This is a
+    // simplified version of the dependence analysis performed by the
+    // mullapudi2016 autoscheduler: since there is no schedule to consult,
+    // every Func is assumed to be computed in full.
+    map<string, Box> pipeline_bounds;
+
+    // The regions of the producers (and image inputs) loaded by each
+    // stage of each Func.
+    map<string, vector<map<string, Box>>> stage_loads;
+
+    // Seed the regions of the outputs from their estimates. If there are
+    // duplicate estimates, use the most recent one.
+    for (const Function &out : outputs) {
+        Box out_box;
+        const auto &estimates = out.schedule().estimates();
+        for (const auto &arg : out.args()) {
+            int i;
+            for (i = (int)estimates.size() - 1; i >= 0; --i) {
+                const auto &est = estimates[i];
+                if ((est.var == arg) && est.min.defined() && est.extent.defined()) {
+                    out_box.push_back(Interval(est.min, simplify(est.min + est.extent - 1)));
+                    break;
+                }
+            }
+            user_assert(i >= 0)
+                << "Performance report: no estimate found for dimension \"" << arg
+                << "\" of output \"" << out.name()
+                << "\". Use Func::set_estimate to provide one.\n";
+        }
+        auto iter = pipeline_bounds.find(out.name());
+        if (iter == pipeline_bounds.end()) {
+            pipeline_bounds.emplace(out.name(), out_box);
+        } else {
+            merge_boxes(iter->second, out_box);
+        }
+    }
+
+    // Walk from the outputs towards the inputs. The realization order
+    // guarantees that all consumers of a Func are visited before the Func
+    // itself, so its region is final by the time it is processed.
+    for (int i = (int)order.size() - 1; i >= 0; --i) {
+        const Function &f = get_element(env, order[i]);
+        auto bounds_iter = pipeline_bounds.find(f.name());
+        if (bounds_iter == pipeline_bounds.end()) {
+            // Not reachable from any of the outputs.
+            continue;
+        }
+        if (f.has_extern_definition()) {
+            // There is no visibility into the regions required by an
+            // extern stage.
+            continue;
+        }
+
+        DimBounds pure_bounds;
+        const vector<string> &args = f.args();
+        internal_assert(args.size() == bounds_iter->second.size());
+        for (size_t d = 0; d < args.size(); d++) {
+            pure_bounds.emplace(args[d], bounds_iter->second[d]);
+        }
+        vector<DimBounds> stage_bounds = get_stage_bounds(f, pure_bounds);
+
+        int num_stages = (int)f.updates().size() + 1;
+        vector<map<string, Box>> &loads = stage_loads[f.name()];
+        loads.resize(num_stages);
+        for (int s = 0; s < num_stages; s++) {
+            Definition def = get_stage_definition(f, s);
+
+            Scope<Interval> scope;
+            scope.set_containing_scope(&costs.input_estimates);
+            const vector<Dim> &dims = def.schedule().dims();
+            for (int d = 0; d < (int)dims.size() - 1; d++) {
+                Interval bound = get_element(stage_bounds[s], dims[d].var);
+                bound.min = substitute_var_estimates(bound.min);
+                bound.max = substitute_var_estimates(bound.max);
+                scope.push(dims[d].var, bound);
+            }
+
+            vector<Expr> exprs = def.values();
+            for (const Expr &arg : def.args()) {
+                exprs.push_back(arg);
+            }
+            for (const Expr &e : exprs) {
+                map<string, Box> regions =
+                    boxes_required(substitute_var_estimates(e), scope, func_val_bounds);
+                for (auto &reg : regions) {
+                    if ((env.find(reg.first) == env.end()) &&
+                        (costs.inputs.find(reg.first) == costs.inputs.end())) {
+                        continue;
+                    }
+                    if (reg.first == f.name()) {
+                        // Loads from earlier stages of the same Func fall
+                        // within its own region, which is accounted for
+                        // separately.
+                        continue;
+                    }
+                    for (size_t d = 0; d < reg.second.size(); d++) {
+                        Interval &in = reg.second[d];
+                        if (in.min.defined()) {
+                            in.min = simplify(substitute_var_estimates(in.min));
+                        }
+                        if (in.max.defined()) {
+                            in.max = simplify(substitute_var_estimates(in.max));
+                        }
+                    }
+                    merge_boxes(loads[s][reg.first], reg.second);
+                    auto iter = pipeline_bounds.find(reg.first);
+                    if (iter == pipeline_bounds.end()) {
+                        pipeline_bounds.emplace(reg.first, reg.second);
+                    } else {
+                        merge_boxes(iter->second, reg.second);
+                    }
+                }
+            }
+        }
+    }
+
+    std::ostringstream report;
+    report << "Performance report (schedule-independent estimates, assuming "
+           << "every Func is computed in full):\n"
+           << "Last-level cache size: " << last_level_cache_size << " bytes\n";
+
+    for (const auto &f_name : order) {
+        auto iter = pipeline_bounds.find(f_name);
+        if (iter == pipeline_bounds.end()) {
+            continue;
+        }
+        const Function &f = get_element(env, f_name);
+        const Box &region = iter->second;
+
+        report << f_name << " (region";
+        for (size_t d = 0; d < region.size(); d++) {
+            report << " [" << region[d].min << ", " << region[d].max << "]";
+        }
+        report << "):\n";
+
+        if (f.has_extern_definition()) {
+            report << "  extern definition; no cost estimate available\n";
+            continue;
+        }
+
+        Expr alloc_size = costs.region_size(f_name, region);
+
+        int num_stages = (int)f.updates().size() + 1;
+        const auto &loads = get_element(stage_loads, f_name);
+        for (int s = 0; s < num_stages; s++) {
+            if (s == 0) {
+                report << "  pure stage:\n";
+            } else {
+                report << "  update " << s - 1 << ":\n";
+            }
+
+            Cost cost = costs.stage_region_cost(f_name, s, region);
+            if (!cost.defined()) {
+                report << "    cost could not be determined\n";
+                continue;
+            }
+            report << "    arithmetic cost: " << cost.arith << " ops\n";
+            report << "    bytes moved: " << cost.memory << "\n";
+
+            const int64_t *arith_int = as_const_int(cost.arith);
+            const int64_t *mem_int = as_const_int(cost.memory);
+            if (arith_int && mem_int && *mem_int != 0) {
+                char buf[32];
+                snprintf(buf, sizeof(buf), "%.2f", (double)*arith_int / (double)*mem_int);
+                report << "    arithmetic intensity: " << buf << " ops/byte\n";
+            }
+
+            // The working set of a stage is its own region plus the
+            // regions of the producers it loads from.
+            Expr working_set = alloc_size;
+            for (const auto &load : loads[s]) {
+                if (!working_set.defined()) {
+                    break;
+                }
+                Expr load_size = (env.find(load.first) != env.end()) ?
+                                     costs.region_size(load.first, load.second) :
+                                     costs.input_region_size(load.first, load.second);
+                if (!load_size.defined()) {
+                    working_set = Expr();
+                } else {
+                    working_set += load_size;
+                }
+            }
+            if (!working_set.defined()) {
+                report << "    working set: unknown\n";
+            } else {
+                working_set = simplify(working_set);
+                report << "    working set: " << working_set << " bytes";
+                const int64_t *ws_int = as_const_int(working_set);
+                if (ws_int && (uint64_t)*ws_int > last_level_cache_size) {
+                    report << " (exceeds last-level cache)";
+                }
+                report << "\n";
+            }
+        }
+    }
+
+    return report.str();
+}
+
 bool is_func_trivial_to_inline(const Function &func) {
     if (!func.can_be_inlined()) {
         return false;
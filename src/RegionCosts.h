@@ -146,6 +146,19 @@ struct RegionCosts {
                 const std::vector<std::string> &order);
 };
 
+/** Return a human-readable report of the estimated cost of computing each
+ * Func in the pipeline: the predicted arithmetic and bytes moved for each
+ * stage, its arithmetic intensity, and its working set compared against the
+ * last-level cache size. The regions of the Funcs are derived from the
+ * estimates provided on the outputs (and on any ImageParams), assuming
+ * every Func is computed in full; the report is therefore independent of
+ * the schedule. 'env' is a map of all functions in the pipeline and
+ * 'order' is their realization order. */
+std::string print_performance_report(const std::vector<Function> &outputs,
+                                     const std::map<std::string, Function> &env,
+                                     const std::vector<std::string> &order,
+                                     uint64_t last_level_cache_size);
+
 /** Return true if the cost of inlining a function is equivalent to the
  * cost of calling the function directly. */
 bool is_func_trivial_to_inline(const Function &func);
@@ -0,0 +1,124 @@
+#include "ReplaceCopyLoops.h"
+#include "ExprUsesVar.h"
+#include "IRMutator.h"
+#include "IROperator.h"
+#include "Simplify.h"
+#include "Substitute.h"
+#include "Util.h"
+
+namespace Halide {
+namespace Internal {
+
+namespace {
+
+class ReplaceCopyLoops : public IRMutator {
+    using IRMutator::visit;
+
+    bool in_device_loop = false;
+
+    // Does e advance by exactly 'stride' each time the loop variable
+    // 'var' increases by one, for all values of the loop variable?
+    static bool advances_by(const Expr &e, const std::string &var, const Expr &stride) {
+        Expr next = substitute(var, Variable::make(Int(32), var) + 1, e);
+        return can_prove(next - e == stride);
+    }
+
+    static Expr make_copy(Type t, const std::string &dst, const Expr &dst_offset,
+                          const std::string &src, const Expr &src_offset,
+                          const Expr &count) {
+        // The last arg is a sentinel that carries the element type
+        // being copied, so the backends know how to scale the
+        // offsets; the call node itself is an int.
+        return Call::make(Int(32), Call::copy_memory,
+                          {Variable::make(Handle(), dst), dst_offset,
+                           Variable::make(Handle(), src), src_offset,
+                           count, make_zero(t)},
+                          Call::Intrinsic);
+    }
+
+    // If the loop is a dense scalar copy of one buffer to another,
+    // return the equivalent copy_memory call. Returns an undefined
+    // Stmt if it isn't.
+    Stmt as_leaf_copy(const For *op, const Store *store) {
+        const Load *load = store->value.as<Load>();
+        if (!load ||
+            store->value.type().lanes() != 1 ||
+            load->name == store->name ||
+            !is_const_one(store->predicate) ||
+            !is_const_one(load->predicate)) {
+            return Stmt();
+        }
+        if (!advances_by(store->index, op->name, 1) ||
+            !advances_by(load->index, op->name, 1)) {
+            return Stmt();
+        }
+        Expr dst_offset = simplify(substitute(op->name, op->min, store->index));
+        Expr src_offset = simplify(substitute(op->name, op->min, load->index));
+        return Evaluate::make(make_copy(store->value.type(), store->name, dst_offset,
+                                        load->name, src_offset, op->extent));
+    }
+
+    // If the loop iterates a copy_memory whose source and destination
+    // both advance by exactly the size of the copy (i.e. the rows are
+    // contiguous in both buffers), collapse it into one bigger
+    // copy. Rows with gaps between them stay as a loop of per-row
+    // copies.
+    Stmt as_collapsed_copy(const For *op, const Call *call) {
+        const Expr &dst_offset = call->args[1];
+        const Expr &src_offset = call->args[3];
+        const Expr &count = call->args[4];
+        if (expr_uses_var(count, op->name) ||
+            !advances_by(dst_offset, op->name, count) ||
+            !advances_by(src_offset, op->name, count)) {
+            return Stmt();
+        }
+        std::vector<Expr> args = call->args;
+        args[1] = simplify(substitute(op->name, op->min, dst_offset));
+        args[3] = simplify(substitute(op->name, op->min, src_offset));
+        args[4] = simplify(count * op->extent);
+        return Evaluate::make(Call::make(call->type, call->name, args, call->call_type));
+    }
+
+    Stmt visit(const For *op) override {
+        if (op->device_api != DeviceAPI::None) {
+            ScopedValue<bool> old(in_device_loop, true);
+            return IRMutator::visit(op);
+        }
+        Stmt body = mutate(op->body);
+        if (op->for_type == ForType::Serial && !in_device_loop) {
+            // Look through any lets wrapping the leaf.
+            Stmt leaf = body;
+            const Stmt *inner = &leaf;
+            while (const LetStmt *let = inner->as<LetStmt>()) {
+                inner = &let->body;
+            }
+            if (inner->as<Store>() || inner->as<Evaluate>()) {
+                leaf = substitute_in_all_lets(body);
+            }
+            Stmt copy;
+            if (const Store *store = leaf.as<Store>()) {
+                copy = as_leaf_copy(op, store);
+            } else if (const Evaluate *eval = leaf.as<Evaluate>()) {
+                if (const Call *call = Call::as_intrinsic(eval->value, {Call::copy_memory})) {
+                    copy = as_collapsed_copy(op, call);
+                }
+            }
+            if (copy.defined()) {
+                return copy;
+            }
+        }
+        if (body.same_as(op->body)) {
+            return op;
+        }
+        return For::make(op->name, op->min, op->extent, op->for_type, op->device_api, body);
+    }
+};
+
+}  // namespace
+
+Stmt replace_copy_loops(const Stmt &s) {
+    return ReplaceCopyLoops().mutate(s);
+}
+
+}  // namespace Internal
+}  // namespace Halide
@@ -0,0 +1,28 @@
+#ifndef HALIDE_REPLACE_COPY_LOOPS_H
+#define HALIDE_REPLACE_COPY_LOOPS_H
+
+/** \file
+ * Defines the lowering pass that rewrites dense copy loops as calls
+ * to memcpy.
+ */
+
+#include "Expr.h"
+
+namespace Halide {
+namespace Internal {
+
+/** Rewrite serial loops that just copy one buffer to another (a
+ * scalar store of a load, with both flattened indices advancing by
+ * one element per iteration) as single copy_memory intrinsics, which
+ * the backends emit as memcpy. Nests of such loops whose rows are
+ * contiguous in both buffers collapse into one copy of the whole
+ * region; rows with equal strides but gaps between them become one
+ * memcpy per row. Runs after storage flattening (which is what
+ * exposes the flat indices) and before vectorization, so the loops
+ * are still scalar. Loops on a device API are left alone. */
+Stmt replace_copy_loops(const Stmt &s);
+
+}  // namespace Internal
+}  // namespace Halide
+
+#endif
@@ -174,6 +174,34 @@ std::string LoopLevel::to_string() const {
     }
 }
 
+std::string LoopLevel::to_string_unlocked() const {
+    if (!contents.defined()) {
+        return "<null>";
+    }
+    return contents->func_name + ".s" + std::to_string(contents->stage_index) +
+           "." + contents->var_name + (contents->is_rvar ? ".r" : "");
+}
+
+std::string LoopLevel::func_name() const {
+    return contents->func_name;
+}
+
+std::string LoopLevel::var_name() const {
+    return contents->var_name;
+}
+
+bool LoopLevel::is_rvar() const {
+    return contents->is_rvar;
+}
+
+int LoopLevel::get_stage_index() const {
+    return contents->stage_index;
+}
+
+bool LoopLevel::locked() const {
+    return contents->locked;
+}
+
 bool LoopLevel::match(const std::string &loop) const {
     check_defined_and_locked();
     if (contents->stage_index == -1) {
@@ -219,8 +247,14 @@ struct FuncScheduleContents {
     std::vector<Bound> estimates;
     std::map<std::string, Internal::FunctionPtr> wrappers;
     MemoryType memory_type = MemoryType::Auto;
+    int stack_budget_bytes = 0;
     bool memoized = false;
     bool async = false;
+    bool store_streaming = false;
+    bool fuse_gpu_stages = false;
+    bool fuse_tuple_stores = false;
+    bool store_persistent = false;
+    Expr ring_buffer;
     Expr memoize_eviction_key;
 
     FuncScheduleContents()
@@ -278,6 +312,8 @@ struct StageScheduleContents {
     std::vector<Split> splits;
     std::vector<Dim> dims;
     std::vector<PrefetchDirective> prefetches;
+    std::vector<PipelineLoopDirective> pipeline_loops;
+    std::vector<Expr> skip_conditions;
     FuseLoopLevel fuse_level;
     std::vector<FusedPair> fused_pairs;
     bool touched = false;
@@ -309,6 +345,11 @@ struct StageScheduleContents {
                 p.offset = mutator->mutate(p.offset);
             }
         }
+        for (Expr &c : skip_conditions) {
+            if (c.defined()) {
+                c = mutator->mutate(c);
+            }
+        }
     }
 };
 
@@ -337,9 +378,15 @@ FuncSchedule FuncSchedule::deep_copy(
     copy.contents->bounds = contents->bounds;
     copy.contents->estimates = contents->estimates;
     copy.contents->memory_type = contents->memory_type;
+    copy.contents->stack_budget_bytes = contents->stack_budget_bytes;
     copy.contents->memoized = contents->memoized;
     copy.contents->memoize_eviction_key = contents->memoize_eviction_key;
     copy.contents->async = contents->async;
+    copy.contents->store_streaming = contents->store_streaming;
+    copy.contents->fuse_gpu_stages = contents->fuse_gpu_stages;
+    copy.contents->fuse_tuple_stores = contents->fuse_tuple_stores;
+    copy.contents->store_persistent = contents->store_persistent;
+    copy.contents->ring_buffer = contents->ring_buffer;
 
     // Deep-copy wrapper functions.
     for (const auto &iter : contents->wrappers) {
@@ -359,6 +406,14 @@ MemoryType &FuncSchedule::memory_type() {
     return contents->memory_type;
 }
 
+int FuncSchedule::stack_budget_bytes() const {
+    return contents->stack_budget_bytes;
+}
+
+int &FuncSchedule::stack_budget_bytes() {
+    return contents->stack_budget_bytes;
+}
+
 bool &FuncSchedule::memoized() {
     return contents->memoized;
 }
@@ -379,10 +434,50 @@ bool &FuncSchedule::async() {
     return contents->async;
 }
 
+bool &FuncSchedule::store_streaming() {
+    return contents->store_streaming;
+}
+
+bool FuncSchedule::store_streaming() const {
+    return contents->store_streaming;
+}
+
+bool &FuncSchedule::fuse_gpu_stages() {
+    return contents->fuse_gpu_stages;
+}
+
+bool FuncSchedule::fuse_gpu_stages() const {
+    return contents->fuse_gpu_stages;
+}
+
+bool &FuncSchedule::fuse_tuple_stores() {
+    return contents->fuse_tuple_stores;
+}
+
+bool FuncSchedule::fuse_tuple_stores() const {
+    return contents->fuse_tuple_stores;
+}
+
+bool &FuncSchedule::store_persistent() {
+    return contents->store_persistent;
+}
+
+bool FuncSchedule::store_persistent() const {
+    return contents->store_persistent;
+}
+
 bool FuncSchedule::async() const {
     return contents->async;
 }
 
+Expr &FuncSchedule::ring_buffer() {
+    return contents->ring_buffer;
+}
+
+Expr FuncSchedule::ring_buffer() const {
+    return contents->ring_buffer;
+}
+
 std::vector<StorageDim> &FuncSchedule::storage_dims() {
     return contents->storage_dims;
 }
@@ -476,6 +571,9 @@ void FuncSchedule::accept(IRVisitor *visitor) const {
     if (memoize_eviction_key().defined()) {
         memoize_eviction_key().accept(visitor);
     }
+    if (ring_buffer().defined()) {
+        ring_buffer().accept(visitor);
+    }
 }
 
 void FuncSchedule::mutate(IRMutator *mutator) {
@@ -495,6 +593,8 @@ StageSchedule StageSchedule::get_copy() const {
     copy.contents->splits = contents->splits;
     copy.contents->dims = contents->dims;
     copy.contents->prefetches = contents->prefetches;
+    copy.contents->pipeline_loops = contents->pipeline_loops;
+    copy.contents->skip_conditions = contents->skip_conditions;
     copy.contents->fuse_level = contents->fuse_level;
     copy.contents->fused_pairs = contents->fused_pairs;
     copy.contents->touched = contents->touched;
@@ -544,6 +644,22 @@ const std::vector<PrefetchDirective> &StageSchedule::prefetches() const {
     return contents->prefetches;
 }
 
+std::vector<PipelineLoopDirective> &StageSchedule::pipeline_loops() {
+    return contents->pipeline_loops;
+}
+
+const std::vector<PipelineLoopDirective> &StageSchedule::pipeline_loops() const {
+    return contents->pipeline_loops;
+}
+
+std::vector<Expr> &StageSchedule::skip_conditions() {
+    return contents->skip_conditions;
+}
+
+const std::vector<Expr> &StageSchedule::skip_conditions() const {
+    return contents->skip_conditions;
+}
+
 FuseLoopLevel &StageSchedule::fuse_level() {
     return contents->fuse_level;
 }
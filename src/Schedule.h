@@ -48,6 +48,21 @@ enum class TailStrategy {
      * case to handle the if statement. */
     GuardWithIf,
 
+    /** Guard the loads and stores in the loop with the same condition
+     * as GuardWithIf, but do not treat it as a boundary condition to
+     * be factored out into a loop epilogue. Always legal. On
+     * architectures with masked vector loads and stores (e.g. AVX-512,
+     * HVX) a vectorized loop runs at full vector width for every
+     * iteration, with the out-of-range lanes masked off, so there is
+     * no scalar cleanup loop at all. Pros: no redundant
+     * re-evaluation; no code growth from separate tail-case handling;
+     * does not constrain input or output sizes. Cons: every iteration
+     * pays for the predicate, so prefer GuardWithIf when the
+     * steady-state portion of the loop dominates; on architectures
+     * without masked vector operations the guarded loads and stores
+     * scalarize. */
+    Predicate,
+
     /** Prevent evaluation beyond the original extent by shifting
      * the tail case inwards, re-evaluating some points near the
      * end. Only legal for pure variables in pure definitions. If
@@ -89,6 +104,28 @@ enum class LoopAlignStrategy {
     Auto
 };
 
+/** Different ways to handle loops with a potentially optimizable
+ * boundary conditions. */
+enum class Partition {
+    /** Leave the decision to Halide. Loops over a boundary condition
+     * or similar structure that can be proven to be unnecessary in
+     * the steady state are partitioned into a prologue, steady state,
+     * and epilogue. */
+    Auto,
+
+    /** Never partition this loop. Use this if you know the loop
+     * bounds are small enough that the prologue and epilogue cover
+     * most of the iterations, or to reduce code size. */
+    Never,
+
+    /** Always partition this loop, even in places where the default
+     * heuristic would decline to (e.g. inside the prologue or
+     * epilogue of an enclosing partitioned loop). It is an error to
+     * request this on a loop in which no simplifications can be made
+     * by partitioning. */
+    Always
+};
+
 /** A reference to a site in a Halide statement at the top of the
  * body of a particular for loop. Evaluating a region of a halide
  * function is done by generating a loop nest that spans its
@@ -146,8 +183,6 @@ class LoopLevel {
     explicit LoopLevel(Internal::IntrusivePtr<Internal::LoopLevelContents> c)
         : contents(std::move(c)) {
     }
-    LoopLevel(const std::string &func_name, const std::string &var_name,
-              bool is_rvar, int stage_index, bool locked = false);
 
 public:
     /** Return the index of the function stage associated with this loop level.
@@ -204,6 +239,31 @@ public:
     // to call for root or inline LoopLevels, but asserts if !defined().
     std::string to_string() const;
 
+    // As to_string(), but a raw dump of the contents that is legal to
+    // call on an unlocked (or undefined) LoopLevel. Used internally to
+    // fingerprint schedule state before lowering locks the levels;
+    // user code should use to_string() instead.
+    std::string to_string_unlocked() const;
+
+    // Raw accessors for the underlying contents. Unlike the accessors
+    // above, these are legal to call on an unlocked (or undefined)
+    // LoopLevel: the serializer must inspect schedule state before
+    // lowering locks the levels. User code should use func(), var(),
+    // etc. instead.
+    // @{
+    std::string func_name() const;
+    std::string var_name() const;
+    bool is_rvar() const;
+    int get_stage_index() const;
+    bool locked() const;
+    // @}
+
+    // Construct a LoopLevel from raw contents values. Meant only for
+    // use by the deserializer; user code should use the public
+    // constructors or inlined()/root() instead.
+    LoopLevel(const std::string &func_name, const std::string &var_name,
+              bool is_rvar, int stage_index, bool locked = false);
+
     // Compare this loop level against the variable name of a for
     // loop, to see if this loop level refers to the site
     // immediately inside this loop. Asserts if !defined().
@@ -256,7 +316,8 @@ struct Split {
     enum SplitType { SplitVar = 0,
                      RenameVar,
                      FuseVars,
-                     PurifyRVar };
+                     PurifyRVar,
+                     FuseVarsMorton };
 
     // If split_type is Rename, then this is just a renaming of the
     // old_var to the outer and not a split. The inner var should
@@ -270,6 +331,13 @@ struct Split {
 
     // If split_type is Fuse, then this does the opposite of a
     // split, it joins the outer and inner into the old_var.
+
+    // If split_type is FuseVarsMorton, it joins the outer and inner
+    // into the old_var like a fuse, but the fused loop traverses the
+    // inner/outer space in Morton (Z-curve) order instead of
+    // row-major order. The extents of the inner and outer are rounded
+    // up to powers of two, and iterations of the curve that fall
+    // outside the original bounds are skipped.
     SplitType split_type;
 
     bool is_rename() const {
@@ -279,7 +347,10 @@ struct Split {
         return split_type == SplitVar;
     }
     bool is_fuse() const {
-        return split_type == FuseVars;
+        return split_type == FuseVars || split_type == FuseVarsMorton;
+    }
+    bool is_morton_fuse() const {
+        return split_type == FuseVarsMorton;
     }
     bool is_purify() const {
         return split_type == PurifyRVar;
@@ -391,6 +462,11 @@ struct Dim {
      * loop (see the DimType enum above). */
     DimType dim_type;
 
+    /** Whether the loop partitioning heuristic should be skipped or
+     * overridden for this loop. Set by Func::partition and
+     * Stage::partition. */
+    Partition partition_policy = Partition::Auto;
+
     /** Can this loop be evaluated in any order (including in
      * parallel)? Equivalently, are there no data hazards between
      * evaluations of the Func at distinct values of this var? */
@@ -453,6 +529,24 @@ struct StorageDim {
      * false). */
     Expr fold_factor;
     bool fold_forward;
+
+    /** If set (by Func::store_interleaved), this dimension is
+     * interleaved into the innermost storage dimension in tiles of
+     * this many elements, giving an AoSoA layout. Only meaningful on
+     * the second-innermost storage dimension. */
+    Expr interleave_lanes;
+};
+
+/** A request from Stage::pipeline_loop to software-pipeline a loop:
+ * rotate the top-level statements of the loop body into the given
+ * number of stages that work on staggered loop iterations, with a
+ * prologue and epilogue peeled off by loop partitioning. */
+struct PipelineLoopDirective {
+    /** The loop var to rotate */
+    std::string var;
+
+    /** The number of pipeline stages to rotate the body into */
+    int stages;
 };
 
 /** This represents two stages with fused loop nests from outermost to
@@ -541,6 +635,36 @@ public:
     bool &async();
     bool async() const;
 
+    /** Is this function's storage written with streaming
+     * (non-temporal) stores where possible? */
+    bool &store_streaming();
+    bool store_streaming() const;
+
+    /** Should this function's GPU kernel be fused into the kernel of
+     * its consumer when the block structures are compatible? */
+    bool &fuse_gpu_stages();
+    bool fuse_gpu_stages() const;
+
+    /** Should all elements of this Function's Tuple value be computed
+     * before any of them are stored, so the inputs are traversed
+     * once? */
+    bool &fuse_tuple_stores();
+    bool fuse_tuple_stores() const;
+
+    /** This flag is set to true if the buffer and valid bounds of
+     * this function should survive across pipeline invocations, if
+     * Func::store_persistent was called. */
+    bool &store_persistent();
+    bool store_persistent() const;
+
+    /** The number of copies of storage this Function's realization
+     * rotates through, if Func::ring_buffer was called. An undefined
+     * Expr if it was not. */
+    // @{
+    Expr &ring_buffer();
+    Expr ring_buffer() const;
+    // @}
+
     /** The list and order of dimensions used to store this
      * function. The first dimension in the vector corresponds to the
      * innermost dimension for storage (i.e. which dimension is
@@ -556,6 +680,15 @@ public:
     MemoryType &memory_type();
     // @}
 
+    /** An upper bound, in bytes, on the size of this Func's
+     * allocations, used to promote dynamically-sized stack
+     * allocations to a fixed size. Zero if no budget was given. See
+     * \ref Func::store_in. */
+    // @{
+    int stack_budget_bytes() const;
+    int &stack_budget_bytes();
+    // @}
+
     /** You may explicitly bound some of the dimensions of a function,
      * or constrain them to lie on multiples of a given factor. See
      * \ref Func::bound and \ref Func::align_bounds and \ref Func::align_extent. */
@@ -662,6 +795,20 @@ public:
     std::vector<PrefetchDirective> &prefetches();
     // @}
 
+    /** You may software-pipeline some of the loops of a function. See
+     * \ref Func::pipeline_loop */
+    // @{
+    const std::vector<PipelineLoopDirective> &pipeline_loops() const;
+    std::vector<PipelineLoopDirective> &pipeline_loops();
+    // @}
+
+    /** You may skip iterations of this function stage for which a
+     * boolean condition holds. See \ref Func::skip_when */
+    // @{
+    const std::vector<Expr> &skip_conditions() const;
+    std::vector<Expr> &skip_conditions();
+    // @}
+
     /** Innermost loop level of fused loop nest for this function stage.
      * Fusion runs from outermost to this loop level. The stages being fused
      * should not have producer/consumer relationship. See \ref Func::compute_with
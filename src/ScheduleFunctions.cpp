@@ -196,6 +196,14 @@ Stmt build_loop_nest(
         }
         pred_container.emplace_back(Container::If, 0, "", pred);
     }
+
+    // Add any skip_when() conditions, negated. The sort below places
+    // each one just inside the innermost loop over a variable it
+    // references, so a condition that only mentions tile indices is
+    // checked once per tile and skips the whole tile's worth of work.
+    for (const Expr &cond : stage_s.skip_conditions()) {
+        pred_container.emplace_back(Container::If, 0, "", qualify(prefix, !cond));
+    }
     int n_predicates = (int)(pred_container.size());
 
     nest.insert(nest.end(), pred_container.begin(), pred_container.end());
@@ -444,6 +452,31 @@ Stmt build_extern_produce(const map<string, Function> &env, Function f, const Ta
 
     vector<pair<string, Expr>> lets;
 
+    // With the raw-pointer ABI (see Func::raw_pointer_extern), each
+    // buffer is passed as a host pointer pre-resolved to the min of
+    // the required region, followed by an extent and stride per
+    // dimension, instead of as a halide_buffer_t. No crops or bounds
+    // structs need to be built per call.
+    const bool raw_pointers = f.extern_definition_uses_raw_pointers();
+    auto push_raw_buffer_args = [&](const Expr &buffer, int dimensions, int bytes_per_elem,
+                                    const vector<Expr> &mins, const vector<Expr> &extents) {
+        Expr host = Call::make(Handle(), Call::buffer_get_host, {buffer}, Call::Extern);
+        Expr offset = make_zero(Int(64));
+        vector<Expr> strides;
+        for (int d = 0; d < dimensions; d++) {
+            Expr buf_min = Call::make(Int(32), Call::buffer_get_min, {buffer, d}, Call::Extern);
+            Expr stride = Call::make(Int(32), Call::buffer_get_stride, {buffer, d}, Call::Extern);
+            offset += cast<int64_t>(mins[d] - buf_min) * cast<int64_t>(stride);
+            strides.push_back(stride);
+        }
+        Expr addr = reinterpret(UInt(64), host) + cast<uint64_t>(offset * bytes_per_elem);
+        extern_call_args.push_back(reinterpret(Handle(), addr));
+        for (int d = 0; d < dimensions; d++) {
+            extern_call_args.push_back(extents[d]);
+            extern_call_args.push_back(strides[d]);
+        }
+    };
+
     // Iterate through all of the input args to the extern
     // function building a suitable argument list for the
     // extern function call.
@@ -456,7 +489,31 @@ Stmt build_extern_produce(const map<string, Function> &env, Function f, const Ta
             extern_call_args.push_back(arg.expr);
         } else if (arg.is_func()) {
             Function input(arg.func);
-            if (!needs_crops && input.schedule().store_level() == input.schedule().compute_level()) {
+            if (raw_pointers) {
+                // Pass the required region of the input directly as a
+                // pointer plus extents and strides.
+                string stage_name = input.name() + ".s" + std::to_string(input.updates().size()) + ".";
+                const vector<string> &input_args = input.args();
+                vector<Expr> mins, extents;
+                internal_assert(input.dimensions() == (int)input_args.size());
+                for (const string &arg : input_args) {
+                    string var = stage_name + arg;
+                    Expr min = Variable::make(Int(32), var + ".min");
+                    Expr max = Variable::make(Int(32), var + ".max");
+                    mins.push_back(min);
+                    extents.push_back(max - min + 1);
+                }
+                for (int k = 0; k < input.outputs(); k++) {
+                    string buf_name = input.name();
+                    if (input.outputs() > 1) {
+                        buf_name += "." + std::to_string(k);
+                    }
+                    buf_name += ".buffer";
+                    Expr buffer = Variable::make(type_of<struct halide_buffer_t *>(), buf_name);
+                    push_raw_buffer_args(buffer, input.dimensions(),
+                                         input.output_types()[k].bytes(), mins, extents);
+                }
+            } else if (!needs_crops && input.schedule().store_level() == input.schedule().compute_level()) {
                 for (int k = 0; k < input.outputs(); k++) {
                     string buf_name = input.name();
                     if (input.outputs() > 1) {
@@ -523,12 +580,32 @@ Stmt build_extern_produce(const map<string, Function> &env, Function f, const Ta
             Parameter p(b.type(), true, b.dimensions(), b.name());
             p.set_buffer(b);
             Expr buf = Variable::make(type_of<struct halide_buffer_t *>(), b.name() + ".buffer", p);
+            if (raw_pointers) {
+                // Pass the whole buffer: pointer to the min, plus
+                // extents and strides.
+                vector<Expr> mins, extents;
+                for (int d = 0; d < b.dimensions(); d++) {
+                    mins.push_back(Call::make(Int(32), Call::buffer_get_min, {buf, d}, Call::Extern));
+                    extents.push_back(Call::make(Int(32), Call::buffer_get_extent, {buf, d}, Call::Extern));
+                }
+                push_raw_buffer_args(buf, b.dimensions(), b.type().bytes(), mins, extents);
+                continue;
+            }
             extern_call_args.push_back(buf);
             buffers_to_annotate.emplace_back(buf, b.dimensions());
             buffers_contents_to_annotate.push_back(buf);
         } else if (arg.is_image_param()) {
             Parameter p = arg.image_param;
             Expr buf = Variable::make(type_of<struct halide_buffer_t *>(), p.name() + ".buffer", p);
+            if (raw_pointers) {
+                vector<Expr> mins, extents;
+                for (int d = 0; d < p.dimensions(); d++) {
+                    mins.push_back(Call::make(Int(32), Call::buffer_get_min, {buf, d}, Call::Extern));
+                    extents.push_back(Call::make(Int(32), Call::buffer_get_extent, {buf, d}, Call::Extern));
+                }
+                push_raw_buffer_args(buf, p.dimensions(), p.type().bytes(), mins, extents);
+                continue;
+            }
             extern_call_args.push_back(buf);
             // Do not annotate ImageParams: both the halide_buffer_t itself,
             // and the contents it points to, should be filled by the caller;
@@ -545,7 +622,31 @@ Stmt build_extern_produce(const map<string, Function> &env, Function f, const Ta
     // ones already injected by allocation bounds inference. If
     // it's the output to the pipeline then it will similarly be
     // in the symbol table.
-    if (!needs_crops && f.schedule().store_level() == f.schedule().compute_level()) {
+    if (raw_pointers) {
+        // Pass the region being computed directly as a pointer plus
+        // extents and strides for each output.
+        string stage_name = f.name() + ".s0.";
+        const vector<string> &f_args = f.args();
+        vector<Expr> mins, extents;
+        internal_assert(f.dimensions() == (int)f_args.size());
+        for (const string &arg : f_args) {
+            string var = stage_name + arg;
+            Expr min = Variable::make(Int(32), var + ".min");
+            Expr max = Variable::make(Int(32), var + ".max");
+            mins.push_back(min);
+            extents.push_back(max - min + 1);
+        }
+        for (int j = 0; j < f.outputs(); j++) {
+            string buf_name = f.name();
+            if (f.outputs() > 1) {
+                buf_name += "." + std::to_string(j);
+            }
+            buf_name += ".buffer";
+            Expr buffer = Variable::make(type_of<struct halide_buffer_t *>(), buf_name);
+            push_raw_buffer_args(buffer, f.dimensions(),
+                                 f.output_types()[j].bytes(), mins, extents);
+        }
+    } else if (!needs_crops && f.schedule().store_level() == f.schedule().compute_level()) {
         for (int j = 0; j < f.outputs(); j++) {
             string buf_name = f.name();
             if (f.outputs() > 1) {
@@ -661,6 +762,16 @@ Stmt build_extern_produce(const map<string, Function> &env, Function f, const Ta
         }
     }
 
+    if (f.extern_definition_is_async()) {
+        // Asynchronous extern stages take a trailing completion
+        // semaphore. No semaphore exists this early in lowering, so
+        // pass null; if the stage is scheduled async,
+        // fork_async_producers points this argument at the semaphore
+        // its consumers wait on. A null semaphore tells the extern
+        // stage to complete synchronously.
+        extern_call_args.push_back(make_zero(type_of<struct halide_semaphore_t *>()));
+    }
+
     // Make the extern call
     Expr e = f.make_call_to_extern_definition(extern_call_args, target);
 
@@ -1238,6 +1349,41 @@ private:
         return s;
     }
 
+    // Find the index in 'dims' of the outermost loop of a child stage
+    // fused into the parent loop nest described by 'fuse_level'. Dims
+    // that share the parent's pure loop variables are matched by
+    // name. The fused dims of an update definition may instead be
+    // RVars, whose names can never match the parent's, so fall back
+    // to aligning positionally with the parent's fused dims (the rest
+    // of the fusion machinery maps child to parent dims by position
+    // anyway).
+    int find_fuse_start(const vector<Dim> &dims, const LoopLevel &fuse_level) const {
+        const auto &iter = std::find_if(dims.begin(), dims.end(),
+                                        [&fuse_level](const Dim &d) {
+                                            return var_name_match(d.var, fuse_level.var().name());
+                                        });
+        if (iter != dims.end()) {
+            return (int)(iter - dims.begin());
+        }
+
+        const auto &env_iter = env.find(fuse_level.func());
+        internal_assert(env_iter != env.end());
+        const auto &parent_func = env_iter->second;
+        const auto &parent_def = (fuse_level.stage_index() == 0) ? parent_func.definition() : parent_func.update(fuse_level.stage_index() - 1);
+        const vector<Dim> &parent_dims = parent_def.schedule().dims();
+        const auto &parent_iter = std::find_if(parent_dims.begin(), parent_dims.end(),
+                                               [&fuse_level](const Dim &d) {
+                                                   return var_name_match(d.var, fuse_level.var().name());
+                                               });
+        internal_assert(parent_iter != parent_dims.end());
+        // Ignore the __outermost dummy dimension on both sides.
+        int n_fused = (int)(parent_dims.size() - 1 - (parent_iter - parent_dims.begin()));
+        int start_fuse = (int)dims.size() - 1 - n_fused;
+        // Validated in validate_fused_group_schedule_helper.
+        internal_assert(start_fuse >= 0);
+        return start_fuse;
+    }
+
     // Compute the shift factor required to align iteration of
     // a function stage with its fused parent loop nest.
     void compute_shift_factor(const Function &f, const string &prefix, const Definition &def,
@@ -1254,15 +1400,7 @@ private:
             return;
         }
 
-        int start_fuse;
-        {
-            const auto &iter = std::find_if(dims.begin(), dims.end(),
-                                            [&fuse_level](const Dim &d) {
-                                                return var_name_match(d.var, fuse_level.var().name());
-                                            });
-            internal_assert(iter != dims.end());
-            start_fuse = (int)(iter - dims.begin());
-        }
+        int start_fuse = find_fuse_start(dims, fuse_level);
 
         int fused_vars_num = dims.size() - start_fuse - 1;
 
@@ -1322,12 +1460,7 @@ private:
 
         size_t start_fuse = dims.size();
         if (!fuse_level.is_inlined() && !fuse_level.is_root()) {
-            const auto &iter = std::find_if(dims.begin(), dims.end(),
-                                            [&fuse_level](const Dim &d) {
-                                                return var_name_match(d.var, fuse_level.var().name());
-                                            });
-            internal_assert(iter != dims.end());
-            start_fuse = (size_t)(iter - dims.begin());
+            start_fuse = (size_t)find_fuse_start(dims, fuse_level);
         }
 
         // The bounds of the child fused loops should be replaced to refer to the
@@ -2190,31 +2323,50 @@ void validate_fused_group_schedule_helper(const string &fn,
             << "Invalid compute_with: cannot find " << p.var_name << " in "
             << p.func_1 << ".s" << p.stage_1 << "\n";
 
+        // The fused dims of an update definition may be RVars, whose
+        // names can never match the parent's pure loop variable. In
+        // that case fall back to aligning the fused dims positionally
+        // with the parent's, which is how the fusion machinery maps
+        // child to parent dims anyway.
+        size_t start_fuse_1 = (size_t)(iter_1 - dims_1.begin());
+        int n_fused = (int)(dims_1.size() - start_fuse_1 - 1);  // Ignore __outermost
+
         const auto &iter_2 =
             std::find_if(dims_2.begin(), dims_2.end(),
                          [&p](const Dim &d) {
                              return var_name_match(d.var, p.var_name);
                          });
-        user_assert(iter_2 != dims_2.end())
-            << "Invalid compute_with: cannot find " << p.var_name << " in "
-            << p.func_2 << ".s" << p.stage_2 << "\n";
 
-        // Verify that their dimensions up to "var_name" are the same.
-        size_t start_fuse_1 = (size_t)(iter_1 - dims_1.begin());
-        size_t start_fuse_2 = (size_t)(iter_2 - dims_2.begin());
+        size_t start_fuse_2;
+        if (iter_2 != dims_2.end()) {
+            start_fuse_2 = (size_t)(iter_2 - dims_2.begin());
 
-        int n_fused = (int)(dims_1.size() - start_fuse_1 - 1);  // Ignore __outermost
-        user_assert(n_fused == (int)(dims_2.size() - start_fuse_2 - 1))
-            << "Invalid compute_with: # of fused dims of " << p.func_1 << ".s"
-            << p.stage_1 << " and " << p.func_2 << ".s" << p.stage_2 << " do not match.\n";
+            // Verify that their dimensions up to "var_name" are the same.
+            user_assert(n_fused == (int)(dims_2.size() - start_fuse_2 - 1))
+                << "Invalid compute_with: # of fused dims of " << p.func_1 << ".s"
+                << p.stage_1 << " and " << p.func_2 << ".s" << p.stage_2 << " do not match.\n";
+        } else {
+            user_assert((int)dims_2.size() - 1 >= n_fused)
+                << "Invalid compute_with: cannot find " << p.var_name << " in "
+                << p.func_2 << ".s" << p.stage_2 << ", and it does not have enough dims "
+                << "to fuse " << n_fused << " loops positionally.\n";
+            start_fuse_2 = (size_t)((int)dims_2.size() - 1 - n_fused);
+        }
 
         for (int i = 0; i < n_fused; ++i) {
             const Dim &d1 = dims_1[start_fuse_1 + i];
             const Dim &d2 = dims_2[start_fuse_2 + i];
-            user_assert(var_name_match(d1.var, d2.var)) << "Invalid compute_with: names of dim "
-                                                        << i << " of " << p.func_1 << ".s"
-                                                        << p.stage_1 << "(" << d1.var << ") and " << p.func_2
-                                                        << ".s" << p.stage_2 << "(" << d2.var << ") do not match.\n";
+            // Pure dims must match by name. A pure dim may also be
+            // fused with a pure (i.e. race-free and reorderable) RVar
+            // of an update definition; impure RVars have ordering
+            // constraints we can't generally preserve through fusion,
+            // so they may only be fused with each other.
+            if (d1.dim_type == DimType::PureVar && d2.dim_type == DimType::PureVar) {
+                user_assert(var_name_match(d1.var, d2.var)) << "Invalid compute_with: names of dim "
+                                                            << i << " of " << p.func_1 << ".s"
+                                                            << p.stage_1 << "(" << d1.var << ") and " << p.func_2
+                                                            << ".s" << p.stage_2 << "(" << d2.var << ") do not match.\n";
+            }
             user_assert(d1.for_type == d2.for_type) << "Invalid compute_with: for types of dim "
                                                     << i << " of " << p.func_1 << ".s" << p.stage_1 << "("
                                                     << d1.var << " is " << d1.for_type << ") and " << p.func_2
@@ -2225,11 +2377,14 @@ void validate_fused_group_schedule_helper(const string &fn,
                                                         << d1.var << " is " << d1.device_api << ") and " << p.func_2
                                                         << ".s" << p.stage_2 << "(" << d2.var << " is " << d2.device_api
                                                         << ") do not match.\n";
-            user_assert(d1.dim_type == d2.dim_type) << "Invalid compute_with: types of dim "
-                                                    << i << " of " << p.func_1 << ".s" << p.stage_1 << "("
-                                                    << d1.var << " is " << d1.dim_type << ") and " << p.func_2
-                                                    << ".s" << p.stage_2 << "(" << d2.var << " is " << d2.dim_type
-                                                    << ") do not match.\n";
+            bool types_compatible =
+                (d1.dim_type == d2.dim_type) ||
+                ((d1.dim_type != DimType::ImpureRVar) && (d2.dim_type != DimType::ImpureRVar));
+            user_assert(types_compatible) << "Invalid compute_with: types of dim "
+                                          << i << " of " << p.func_1 << ".s" << p.stage_1 << "("
+                                          << d1.var << " is " << d1.dim_type << ") and " << p.func_2
+                                          << ".s" << p.stage_2 << "(" << d2.var << " is " << d2.dim_type
+                                          << ") are not compatible.\n";
         }
     }
 }
@@ -2284,6 +2439,55 @@ bool group_should_be_inlined(const vector<Function> &funcs) {
             funcs[0].schedule().compute_level().is_inlined());
 }
 
+// Can this Function be safely marked async when the target asks for
+// independent compute_root stages to run as a task DAG (Target::AsyncRoot)?
+bool can_run_async_at_root(const Function &f, const vector<Function> &outputs) {
+    for (const Function &o : outputs) {
+        // Output buffers are realized by the caller; there's no
+        // producer/consumer fork to make for them.
+        if (o.same_as(f)) {
+            return false;
+        }
+    }
+
+    const FuncSchedule &sched = f.schedule();
+    if (!sched.compute_level().is_root() || !sched.store_level().is_root()) {
+        return false;
+    }
+    if (f.has_extern_definition() || sched.memoized() || sched.async()) {
+        return false;
+    }
+
+    vector<Definition> defs;
+    defs.push_back(f.definition());
+    for (const Definition &def : f.updates()) {
+        defs.push_back(def);
+    }
+    for (const Definition &def : defs) {
+        // Funcs involved in a compute_with relationship must stay in
+        // their fused loop nest, so leave them synchronous.
+        const LoopLevel &fuse_level = def.schedule().fuse_level().level;
+        if (!fuse_level.is_inlined() && !fuse_level.is_root()) {
+            return false;
+        }
+        if (!def.schedule().fused_pairs().empty()) {
+            return false;
+        }
+        // Device stages synchronize via the device runtime, not
+        // semaphores, so only host stages are forked.
+        for (const Dim &d : def.schedule().dims()) {
+            if (d.for_type == ForType::GPUBlock ||
+                d.for_type == ForType::GPUThread ||
+                d.for_type == ForType::GPULane ||
+                d.device_api != DeviceAPI::None) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
 }  // namespace
 
 std::ostream &operator<<(std::ostream &out, const std::vector<Function> &v) {
@@ -2308,6 +2512,23 @@ Stmt schedule_functions(const vector<Function> &outputs,
 
     any_memoized = false;
 
+    // With the async_root feature, independent compute_root stages
+    // become producer/consumer forks instead of running strictly
+    // sequentially in realization order. Marking a stage async here
+    // makes fork_async_producers turn its Realize node into a Fork
+    // with semaphore edges, which halide_do_parallel_tasks then
+    // executes as a task DAG, so parallel branches of the pipeline
+    // overlap even when individual stages don't scale.
+    if (target.has_feature(Target::AsyncRoot)) {
+        for (const auto &p : env) {
+            Function f = p.second;
+            if (can_run_async_at_root(f, outputs)) {
+                debug(1) << "Marking " << f.name() << " async for async_root\n";
+                f.schedule().async() = true;
+            }
+        }
+    }
+
     validate_fused_groups_schedule(fused_groups, env);
 
     for (size_t i = fused_groups.size(); i > 0; --i) {
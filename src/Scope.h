@@ -10,6 +10,7 @@
 
 #include "Debug.h"
 #include "Error.h"
+#include "InternedString.h"
 
 /** \file
  * Defines the Scope class, which is used for keeping track of names in a scope while traversing IR
@@ -89,11 +90,17 @@ public:
 /** A common pattern when traversing Halide IR is that you need to
  * keep track of stuff when you find a Let or a LetStmt, and that it
  * should hide previous values with the same name until you leave the
- * Let or LetStmt nodes This class helps with that. */
+ * Let or LetStmt nodes This class helps with that.
+ *
+ * The table is keyed by interned symbols rather than strings, so
+ * lookups hash a name once instead of comparing it against every name
+ * on the path through the map; names arriving as strings are interned
+ * at the call boundary. Iteration order is the order in which names
+ * were first interned (see InternedString). */
 template<typename T = void>
 class Scope {
 private:
-    std::map<std::string, SmallStack<T>> table;
+    std::map<InternedString, SmallStack<T>> table;
 
     const Scope<T> *containing_scope = nullptr;
 
@@ -125,13 +132,13 @@ public:
     /** Retrieve the value referred to by a name */
     template<typename T2 = T,
              typename = typename std::enable_if<!std::is_same<T2, void>::value>::type>
-    T2 get(const std::string &name) const {
-        typename std::map<std::string, SmallStack<T>>::const_iterator iter = table.find(name);
+    T2 get(const InternedString &name) const {
+        typename std::map<InternedString, SmallStack<T>>::const_iterator iter = table.find(name);
         if (iter == table.end() || iter->second.empty()) {
             if (containing_scope) {
                 return containing_scope->get(name);
             } else {
-                internal_error << "Name not in Scope: " << name << "\n"
+                internal_error << "Name not in Scope: " << name.str() << "\n"
                                << *this << "\n";
             }
         }
@@ -141,18 +148,18 @@ public:
     /** Return a reference to an entry. Does not consider the containing scope. */
     template<typename T2 = T,
              typename = typename std::enable_if<!std::is_same<T2, void>::value>::type>
-    T2 &ref(const std::string &name) {
-        typename std::map<std::string, SmallStack<T>>::iterator iter = table.find(name);
+    T2 &ref(const InternedString &name) {
+        typename std::map<InternedString, SmallStack<T>>::iterator iter = table.find(name);
         if (iter == table.end() || iter->second.empty()) {
-            internal_error << "Name not in Scope: " << name << "\n"
+            internal_error << "Name not in Scope: " << name.str() << "\n"
                            << *this << "\n";
         }
         return iter->second.top_ref();
     }
 
     /** Tests if a name is in scope */
-    bool contains(const std::string &name) const {
-        typename std::map<std::string, SmallStack<T>>::const_iterator iter = table.find(name);
+    bool contains(const InternedString &name) const {
+        typename std::map<InternedString, SmallStack<T>>::const_iterator iter = table.find(name);
         if (iter == table.end() || iter->second.empty()) {
             if (containing_scope) {
                 return containing_scope->contains(name);
@@ -164,7 +171,7 @@ public:
     }
 
     /** How many nested definitions of a single name exist? */
-    size_t count(const std::string &name) const {
+    size_t count(const InternedString &name) const {
         auto it = table.find(name);
         if (it == table.end()) {
             return 0;
@@ -178,22 +185,22 @@ public:
      */
     template<typename T2 = T,
              typename = typename std::enable_if<!std::is_same<T2, void>::value>::type>
-    void push(const std::string &name, T2 &&value) {
+    void push(const InternedString &name, T2 &&value) {
         table[name].push(std::forward<T2>(value));
     }
 
     template<typename T2 = T,
              typename = typename std::enable_if<std::is_same<T2, void>::value>::type>
-    void push(const std::string &name) {
+    void push(const InternedString &name) {
         table[name].push();
     }
 
     /** A name goes out of scope. Restore whatever its old value
      * was (or remove it entirely if there was nothing else of the
      * same name in an outer scope) */
-    void pop(const std::string &name) {
-        typename std::map<std::string, SmallStack<T>>::iterator iter = table.find(name);
-        internal_assert(iter != table.end()) << "Name not in Scope: " << name << "\n"
+    void pop(const InternedString &name) {
+        typename std::map<InternedString, SmallStack<T>>::iterator iter = table.find(name);
+        internal_assert(iter != table.end()) << "Name not in Scope: " << name.str() << "\n"
                                              << *this << "\n";
         iter->second.pop();
         if (iter->second.empty()) {
@@ -203,10 +210,10 @@ public:
 
     /** Iterate through the scope. Does not capture any containing scope. */
     class const_iterator {
-        typename std::map<std::string, SmallStack<T>>::const_iterator iter;
+        typename std::map<InternedString, SmallStack<T>>::const_iterator iter;
 
     public:
-        explicit const_iterator(const typename std::map<std::string, SmallStack<T>>::const_iterator &i)
+        explicit const_iterator(const typename std::map<InternedString, SmallStack<T>>::const_iterator &i)
             : iter(i) {
         }
 
@@ -216,12 +223,16 @@ public:
             return iter != other.iter;
         }
 
+        bool operator==(const const_iterator &other) {
+            return iter == other.iter;
+        }
+
         void operator++() {
             ++iter;
         }
 
         const std::string &name() {
-            return iter->first;
+            return iter->first.str();
         }
 
         const SmallStack<T> &stack() {
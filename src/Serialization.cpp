@@ -0,0 +1,1739 @@
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Serialization.h"
+
+#include "ExternFuncArgument.h"
+#include "FindCalls.h"
+#include "Func.h"
+#include "Function.h"
+#include "FunctionPtr.h"
+#include "IR.h"
+#include "IRMutator.h"
+#include "IRPrinter.h"
+#include "Parameter.h"
+#include "Reduction.h"
+#include "Schedule.h"
+#include "Var.h"
+
+namespace Halide {
+namespace Internal {
+
+namespace {
+
+using std::map;
+using std::string;
+using std::vector;
+
+const char kMagic[4] = {'H', 'L', 'P', 'B'};
+// Bumped to 2 when TailStrategy gained Predicate, which shifted the
+// ordinals of the later enum values.
+// Bumped to 3 when extern definitions gained an is-async flag.
+// Bumped to 5 when func schedules gained a store-streaming flag.
+// Bumped to 6 when func schedules gained a fuse-gpu-stages flag.
+// Bumped to 7 when func schedules gained a store-persistent flag.
+// Bumped to 8 when func schedules gained a stack budget.
+// Bumped to 9 when func schedules gained a fuse-tuple-stores flag.
+constexpr uint32_t kVersion = 9;
+
+/** Stable tags for the Expr nodes we can serialize. These must never
+ * be renumbered; add new nodes at the end. Stmt nodes and Load nodes
+ * never appear in unlowered pipelines, so they have no tags. */
+enum class ExprTag : uint8_t {
+    Undefined = 0,
+    IntImm,
+    UIntImm,
+    FloatImm,
+    StringImm,
+    Cast,
+    Variable,
+    Add,
+    Sub,
+    Mul,
+    Div,
+    Mod,
+    Min,
+    Max,
+    EQ,
+    NE,
+    LT,
+    LE,
+    GT,
+    GE,
+    And,
+    Or,
+    Not,
+    Select,
+    Ramp,
+    Broadcast,
+    Call,
+    Let,
+    Shuffle,
+    VectorReduce,
+};
+
+enum class FunctionKind : uint8_t {
+    Pure = 0,
+    Extern,
+};
+
+/** Mutator that weakens any Call's FunctionPtr that points into the
+ * given function group. Within-group references (self-calls in
+ * specializations, schedule exprs, wrapper cycles) must be weak, or
+ * the group's reference count never reaches zero. */
+class WeakenWithinGroupReferences : public IRMutator {
+public:
+    explicit WeakenWithinGroupReferences(FunctionGroup *group)
+        : group(group) {
+    }
+
+protected:
+    using IRMutator::visit;
+
+    Expr visit(const Call *op) override {
+        Expr expr = IRMutator::visit(op);
+        op = expr.as<Call>();
+        internal_assert(op);
+        if (op->func.defined() && op->func.group() == group && op->func.strong.defined()) {
+            FunctionPtr weak = op->func;
+            weak.weaken();
+            expr = Call::make(op->type, op->name, op->args, op->call_type,
+                              weak, op->value_index, op->image, op->param);
+        }
+        return expr;
+    }
+
+private:
+    FunctionGroup *group;
+};
+
+class Serializer {
+public:
+    explicit Serializer(std::ostream &out)
+        : out(out) {
+    }
+
+    void serialize(const Pipeline &pipeline);
+
+private:
+    std::ostream &out;
+
+    // The table of all functions reachable from the outputs, and the
+    // cross-reference tables for handles encountered while writing
+    // exprs and schedules. Handles are written out in full the first
+    // time they are referenced, and by index thereafter.
+    map<string, int> function_index;
+    map<Parameter, int> parameter_index;
+    map<ReductionDomain, int, ReductionDomain::Compare> rdom_index;
+    map<const void *, int> buffer_index;
+
+    void write_bytes(const void *data, size_t size) {
+        out.write((const char *)data, (std::streamsize)size);
+    }
+    void write_u8(uint8_t v) {
+        write_bytes(&v, sizeof(v));
+    }
+    void write_bool(bool v) {
+        write_u8(v ? 1 : 0);
+    }
+    void write_u32(uint32_t v) {
+        write_bytes(&v, sizeof(v));
+    }
+    void write_i32(int32_t v) {
+        write_bytes(&v, sizeof(v));
+    }
+    void write_i64(int64_t v) {
+        write_bytes(&v, sizeof(v));
+    }
+    void write_u64(uint64_t v) {
+        write_bytes(&v, sizeof(v));
+    }
+    void write_f64(double v) {
+        write_bytes(&v, sizeof(v));
+    }
+    void write_string(const string &s) {
+        write_u32((uint32_t)s.size());
+        write_bytes(s.data(), s.size());
+    }
+    void write_strings(const vector<string> &v) {
+        write_u32((uint32_t)v.size());
+        for (const string &s : v) {
+            write_string(s);
+        }
+    }
+    void write_tag(ExprTag tag) {
+        write_u8((uint8_t)tag);
+    }
+
+    void write_type(const Type &t) {
+        write_u8((uint8_t)t.code());
+        write_u8((uint8_t)t.bits());
+        write_i32(t.lanes());
+    }
+    void write_types(const vector<Type> &v) {
+        write_u32((uint32_t)v.size());
+        for (const Type &t : v) {
+            write_type(t);
+        }
+    }
+
+    void write_expr(const Expr &e);
+    void write_exprs(const vector<Expr> &v) {
+        write_u32((uint32_t)v.size());
+        for (const Expr &e : v) {
+            write_expr(e);
+        }
+    }
+
+    void write_function_ref(const FunctionPtr &ptr);
+    void write_parameter_ref(const Parameter &p);
+    void write_rdom_ref(const ReductionDomain &r);
+    void write_buffer_ref(const Buffer<> &b);
+
+    void write_loop_level(const LoopLevel &l);
+    void write_func_schedule(const FuncSchedule &s);
+    void write_stage_schedule(const StageSchedule &s);
+    void write_definition_rest(const Definition &def);
+    void write_function(const Function &f);
+};
+
+void Serializer::write_expr(const Expr &e) {
+    if (!e.defined()) {
+        write_tag(ExprTag::Undefined);
+        return;
+    }
+    switch (e.node_type()) {
+    case IRNodeType::IntImm: {
+        const IntImm *n = e.as<IntImm>();
+        write_tag(ExprTag::IntImm);
+        write_type(n->type);
+        write_i64(n->value);
+        break;
+    }
+    case IRNodeType::UIntImm: {
+        const UIntImm *n = e.as<UIntImm>();
+        write_tag(ExprTag::UIntImm);
+        write_type(n->type);
+        write_u64(n->value);
+        break;
+    }
+    case IRNodeType::FloatImm: {
+        const FloatImm *n = e.as<FloatImm>();
+        write_tag(ExprTag::FloatImm);
+        write_type(n->type);
+        write_f64(n->value);
+        break;
+    }
+    case IRNodeType::StringImm: {
+        const StringImm *n = e.as<StringImm>();
+        write_tag(ExprTag::StringImm);
+        write_string(n->value);
+        break;
+    }
+    case IRNodeType::Cast: {
+        const Cast *n = e.as<Cast>();
+        write_tag(ExprTag::Cast);
+        write_type(n->type);
+        write_expr(n->value);
+        break;
+    }
+    case IRNodeType::Variable: {
+        const Variable *n = e.as<Variable>();
+        write_tag(ExprTag::Variable);
+        write_type(n->type);
+        write_string(n->name);
+        write_parameter_ref(n->param);
+        write_buffer_ref(n->image);
+        write_rdom_ref(n->reduction_domain);
+        break;
+    }
+    case IRNodeType::Add: {
+        const Add *n = e.as<Add>();
+        write_tag(ExprTag::Add);
+        write_expr(n->a);
+        write_expr(n->b);
+        break;
+    }
+    case IRNodeType::Sub: {
+        const Sub *n = e.as<Sub>();
+        write_tag(ExprTag::Sub);
+        write_expr(n->a);
+        write_expr(n->b);
+        break;
+    }
+    case IRNodeType::Mul: {
+        const Mul *n = e.as<Mul>();
+        write_tag(ExprTag::Mul);
+        write_expr(n->a);
+        write_expr(n->b);
+        break;
+    }
+    case IRNodeType::Div: {
+        const Div *n = e.as<Div>();
+        write_tag(ExprTag::Div);
+        write_expr(n->a);
+        write_expr(n->b);
+        break;
+    }
+    case IRNodeType::Mod: {
+        const Mod *n = e.as<Mod>();
+        write_tag(ExprTag::Mod);
+        write_expr(n->a);
+        write_expr(n->b);
+        break;
+    }
+    case IRNodeType::Min: {
+        const Min *n = e.as<Min>();
+        write_tag(ExprTag::Min);
+        write_expr(n->a);
+        write_expr(n->b);
+        break;
+    }
+    case IRNodeType::Max: {
+        const Max *n = e.as<Max>();
+        write_tag(ExprTag::Max);
+        write_expr(n->a);
+        write_expr(n->b);
+        break;
+    }
+    case IRNodeType::EQ: {
+        const EQ *n = e.as<EQ>();
+        write_tag(ExprTag::EQ);
+        write_expr(n->a);
+        write_expr(n->b);
+        break;
+    }
+    case IRNodeType::NE: {
+        const NE *n = e.as<NE>();
+        write_tag(ExprTag::NE);
+        write_expr(n->a);
+        write_expr(n->b);
+        break;
+    }
+    case IRNodeType::LT: {
+        const LT *n = e.as<LT>();
+        write_tag(ExprTag::LT);
+        write_expr(n->a);
+        write_expr(n->b);
+        break;
+    }
+    case IRNodeType::LE: {
+        const LE *n = e.as<LE>();
+        write_tag(ExprTag::LE);
+        write_expr(n->a);
+        write_expr(n->b);
+        break;
+    }
+    case IRNodeType::GT: {
+        const GT *n = e.as<GT>();
+        write_tag(ExprTag::GT);
+        write_expr(n->a);
+        write_expr(n->b);
+        break;
+    }
+    case IRNodeType::GE: {
+        const GE *n = e.as<GE>();
+        write_tag(ExprTag::GE);
+        write_expr(n->a);
+        write_expr(n->b);
+        break;
+    }
+    case IRNodeType::And: {
+        const And *n = e.as<And>();
+        write_tag(ExprTag::And);
+        write_expr(n->a);
+        write_expr(n->b);
+        break;
+    }
+    case IRNodeType::Or: {
+        const Or *n = e.as<Or>();
+        write_tag(ExprTag::Or);
+        write_expr(n->a);
+        write_expr(n->b);
+        break;
+    }
+    case IRNodeType::Not: {
+        const Not *n = e.as<Not>();
+        write_tag(ExprTag::Not);
+        write_expr(n->a);
+        break;
+    }
+    case IRNodeType::Select: {
+        const Select *n = e.as<Select>();
+        write_tag(ExprTag::Select);
+        write_expr(n->condition);
+        write_expr(n->true_value);
+        write_expr(n->false_value);
+        break;
+    }
+    case IRNodeType::Ramp: {
+        const Ramp *n = e.as<Ramp>();
+        write_tag(ExprTag::Ramp);
+        write_expr(n->base);
+        write_expr(n->stride);
+        write_i32(n->lanes);
+        break;
+    }
+    case IRNodeType::Broadcast: {
+        const Broadcast *n = e.as<Broadcast>();
+        write_tag(ExprTag::Broadcast);
+        write_expr(n->value);
+        write_i32(n->lanes);
+        break;
+    }
+    case IRNodeType::Call: {
+        const Call *n = e.as<Call>();
+        write_tag(ExprTag::Call);
+        write_type(n->type);
+        write_string(n->name);
+        write_u8((uint8_t)n->call_type);
+        write_i32(n->value_index);
+        write_function_ref(n->func);
+        write_buffer_ref(n->image);
+        write_parameter_ref(n->param);
+        write_exprs(n->args);
+        break;
+    }
+    case IRNodeType::Let: {
+        const Let *n = e.as<Let>();
+        write_tag(ExprTag::Let);
+        write_string(n->name);
+        write_expr(n->value);
+        write_expr(n->body);
+        break;
+    }
+    case IRNodeType::Shuffle: {
+        const Shuffle *n = e.as<Shuffle>();
+        write_tag(ExprTag::Shuffle);
+        write_exprs(n->vectors);
+        write_u32((uint32_t)n->indices.size());
+        for (int i : n->indices) {
+            write_i32(i);
+        }
+        break;
+    }
+    case IRNodeType::VectorReduce: {
+        const VectorReduce *n = e.as<VectorReduce>();
+        write_tag(ExprTag::VectorReduce);
+        write_u8((uint8_t)n->op);
+        write_i32(n->type.lanes());
+        write_expr(n->value);
+        break;
+    }
+    default:
+        user_error << "Cannot serialize Expr: " << e << "\n"
+                   << "Only unlowered pipeline state can be serialized.\n";
+    }
+}
+
+void Serializer::write_function_ref(const FunctionPtr &ptr) {
+    if (!ptr.defined()) {
+        write_i32(-1);
+        return;
+    }
+    Function f(ptr);
+    auto it = function_index.find(f.name());
+    user_assert(it != function_index.end())
+        << "Cannot serialize pipeline: it references Function \"" << f.name()
+        << "\", which is not reachable from the pipeline's outputs.\n";
+    write_i32(it->second);
+}
+
+void Serializer::write_parameter_ref(const Parameter &p) {
+    if (!p.defined()) {
+        write_i32(-1);
+        return;
+    }
+    auto it = parameter_index.find(p);
+    if (it != parameter_index.end()) {
+        write_i32(it->second);
+        return;
+    }
+    // First use. Register the index before writing the constraint
+    // exprs, which may refer back to this parameter.
+    int idx = (int)parameter_index.size();
+    parameter_index.emplace(p, idx);
+    write_i32(idx);
+    write_string(p.name());
+    write_type(p.type());
+    write_bool(p.is_buffer());
+    write_i32(p.dimensions());
+    if (p.is_buffer()) {
+        for (int d = 0; d < p.dimensions(); d++) {
+            write_expr(p.min_constraint(d));
+            write_expr(p.extent_constraint(d));
+            write_expr(p.stride_constraint(d));
+            write_expr(p.min_constraint_estimate(d));
+            write_expr(p.extent_constraint_estimate(d));
+        }
+        write_i32(p.host_alignment());
+        write_u8((uint8_t)p.memory_type());
+    } else {
+        write_expr(p.min_value());
+        write_expr(p.max_value());
+        write_expr(p.estimate());
+        write_expr(p.default_value());
+        // The currently-bound scalar value, so that pipelines shipped
+        // to jitting workers keep their parameter bindings.
+        write_bytes(p.scalar_address(), p.type().bytes());
+    }
+}
+
+void Serializer::write_rdom_ref(const ReductionDomain &r) {
+    if (!r.defined()) {
+        write_i32(-1);
+        return;
+    }
+    auto it = rdom_index.find(r);
+    if (it != rdom_index.end()) {
+        write_i32(it->second);
+        return;
+    }
+    int idx = (int)rdom_index.size();
+    rdom_index.emplace(r, idx);
+    write_i32(idx);
+    // The domain's min/extent exprs cannot refer back to the domain,
+    // but the predicate can (and usually does, via its RVars).
+    const vector<ReductionVariable> &dom = r.domain();
+    write_u32((uint32_t)dom.size());
+    for (const ReductionVariable &rv : dom) {
+        write_string(rv.var);
+        write_expr(rv.min);
+        write_expr(rv.extent);
+    }
+    write_expr(r.predicate());
+}
+
+void Serializer::write_buffer_ref(const Buffer<> &b) {
+    if (!b.defined()) {
+        write_i32(-1);
+        return;
+    }
+    auto it = buffer_index.find((const void *)b.get());
+    if (it != buffer_index.end()) {
+        write_i32(it->second);
+        return;
+    }
+    int idx = (int)buffer_index.size();
+    buffer_index.emplace((const void *)b.get(), idx);
+    write_i32(idx);
+    write_string(b.name());
+    write_type(b.type());
+    int dims = b.dimensions();
+    write_i32(dims);
+    for (int d = 0; d < dims; d++) {
+        write_i32(b.dim(d).min());
+        write_i32(b.dim(d).extent());
+    }
+    bool has_data = b.data() != nullptr;
+    write_bool(has_data);
+    if (has_data) {
+        // Write the host data in dense planar order, whatever the
+        // source buffer's layout is.
+        vector<halide_dimension_t> shape(dims);
+        int32_t stride = 1;
+        for (int d = 0; d < dims; d++) {
+            shape[d] = {b.dim(d).min(), b.dim(d).extent(), stride, 0};
+            stride *= b.dim(d).extent();
+        }
+        Runtime::Buffer<> dense(b.type(), nullptr, dims, shape.data());
+        dense.allocate();
+        dense.copy_from(*b.get());
+        uint64_t size = (uint64_t)dense.size_in_bytes();
+        write_u64(size);
+        write_bytes(dense.data(), (size_t)size);
+    }
+}
+
+void Serializer::write_loop_level(const LoopLevel &l) {
+    // The raw contents fields round-trip verbatim; the magic var
+    // names for inlined/root/undefined levels need no special casing.
+    write_string(l.func_name());
+    write_string(l.var_name());
+    write_bool(l.is_rvar());
+    write_i32(l.get_stage_index());
+    write_bool(l.locked());
+}
+
+void Serializer::write_func_schedule(const FuncSchedule &s) {
+    write_loop_level(s.store_level());
+    write_loop_level(s.compute_level());
+    write_u32((uint32_t)s.storage_dims().size());
+    for (const StorageDim &d : s.storage_dims()) {
+        write_string(d.var);
+        write_expr(d.alignment);
+        write_expr(d.fold_factor);
+        write_bool(d.fold_forward);
+        write_expr(d.interleave_lanes);
+    }
+    write_u32((uint32_t)s.bounds().size());
+    for (const Bound &b : s.bounds()) {
+        write_string(b.var);
+        write_expr(b.min);
+        write_expr(b.extent);
+        write_expr(b.modulus);
+        write_expr(b.remainder);
+    }
+    write_u32((uint32_t)s.estimates().size());
+    for (const Bound &b : s.estimates()) {
+        write_string(b.var);
+        write_expr(b.min);
+        write_expr(b.extent);
+        write_expr(b.modulus);
+        write_expr(b.remainder);
+    }
+    write_u32((uint32_t)s.wrappers().size());
+    for (const auto &w : s.wrappers()) {
+        write_string(w.first);
+        write_function_ref(w.second);
+    }
+    write_u8((uint8_t)s.memory_type());
+    write_bool(s.memoized());
+    write_expr(s.memoize_eviction_key());
+    write_bool(s.async());
+    write_expr(s.ring_buffer());
+    write_bool(s.store_streaming());
+    write_bool(s.fuse_gpu_stages());
+    write_bool(s.store_persistent());
+    write_i32(s.stack_budget_bytes());
+    write_bool(s.fuse_tuple_stores());
+}
+
+void Serializer::write_stage_schedule(const StageSchedule &s) {
+    write_u32((uint32_t)s.rvars().size());
+    for (const ReductionVariable &rv : s.rvars()) {
+        write_string(rv.var);
+        write_expr(rv.min);
+        write_expr(rv.extent);
+    }
+    write_u32((uint32_t)s.splits().size());
+    for (const Split &sp : s.splits()) {
+        write_string(sp.old_var);
+        write_string(sp.outer);
+        write_string(sp.inner);
+        write_expr(sp.factor);
+        write_bool(sp.exact);
+        write_u8((uint8_t)sp.tail);
+        write_u8((uint8_t)sp.split_type);
+    }
+    write_u32((uint32_t)s.dims().size());
+    for (const Dim &d : s.dims()) {
+        write_string(d.var);
+        write_u8((uint8_t)d.for_type);
+        write_u8((uint8_t)d.device_api);
+        write_u8((uint8_t)d.dim_type);
+        write_u8((uint8_t)d.partition_policy);
+    }
+    write_u32((uint32_t)s.prefetches().size());
+    for (const PrefetchDirective &p : s.prefetches()) {
+        write_string(p.name);
+        write_string(p.var);
+        write_expr(p.offset);
+        write_u8((uint8_t)p.strategy);
+        write_u8((uint8_t)p.locality);
+        write_bool(p.for_write);
+        write_bool(p.adaptive);
+        write_parameter_ref(p.param);
+    }
+    write_u32((uint32_t)s.pipeline_loops().size());
+    for (const PipelineLoopDirective &p : s.pipeline_loops()) {
+        write_string(p.var);
+        write_i32(p.stages);
+    }
+    write_exprs(s.skip_conditions());
+    write_loop_level(s.fuse_level().level);
+    write_u32((uint32_t)s.fuse_level().align.size());
+    for (const auto &a : s.fuse_level().align) {
+        write_string(a.first);
+        write_u8((uint8_t)a.second);
+    }
+    write_u32((uint32_t)s.fused_pairs().size());
+    for (const FusedPair &p : s.fused_pairs()) {
+        write_string(p.func_1);
+        write_u64((uint64_t)p.stage_1);
+        write_string(p.func_2);
+        write_u64((uint64_t)p.stage_2);
+        write_string(p.var_name);
+    }
+    write_bool(s.touched());
+    write_bool(s.allow_race_conditions());
+    write_bool(s.atomic());
+    write_bool(s.override_atomic_associativity_test());
+}
+
+void Serializer::write_definition_rest(const Definition &def) {
+    write_expr(def.predicate());
+    write_stage_schedule(def.schedule());
+    write_u32((uint32_t)def.specializations().size());
+    for (const Specialization &sp : def.specializations()) {
+        write_expr(sp.condition);
+        write_string(sp.failure_message);
+        write_exprs(sp.definition.args());
+        write_exprs(sp.definition.values());
+        write_definition_rest(sp.definition);
+    }
+}
+
+void Serializer::write_function(const Function &f) {
+    write_u8((uint8_t)(f.has_extern_definition() ? FunctionKind::Extern : FunctionKind::Pure));
+    write_bool(f.is_tracing_loads());
+    write_bool(f.is_tracing_stores());
+    write_bool(f.is_tracing_realizations());
+    write_strings(f.get_trace_tags());
+    write_bool(f.frozen());
+    if (f.has_extern_definition()) {
+        write_string(f.extern_function_name());
+        write_u8((uint8_t)f.extern_definition_name_mangling());
+        write_u8((uint8_t)f.extern_function_device_api());
+        write_bool(f.extern_definition_is_async());
+        write_bool(f.extern_definition_uses_raw_pointers());
+        write_types(f.output_types());
+        write_strings(f.args());
+        const vector<ExternFuncArgument> &args = f.extern_arguments();
+        write_u32((uint32_t)args.size());
+        for (const ExternFuncArgument &arg : args) {
+            write_u8((uint8_t)arg.arg_type);
+            switch (arg.arg_type) {
+            case ExternFuncArgument::FuncArg:
+                write_function_ref(arg.func);
+                break;
+            case ExternFuncArgument::BufferArg:
+                write_buffer_ref(arg.buffer);
+                break;
+            case ExternFuncArgument::ExprArg:
+                write_expr(arg.expr);
+                break;
+            case ExternFuncArgument::ImageParamArg:
+                write_parameter_ref(arg.image_param);
+                break;
+            case ExternFuncArgument::UndefinedArg:
+                break;
+            }
+        }
+        write_expr(f.extern_definition_proxy_expr());
+        write_func_schedule(f.schedule());
+        write_stage_schedule(f.definition().schedule());
+    } else {
+        write_strings(f.args());
+        write_exprs(f.values());
+        write_definition_rest(f.definition());
+        write_u32((uint32_t)f.updates().size());
+        for (const Definition &def : f.updates()) {
+            write_exprs(def.args());
+            write_exprs(def.values());
+            write_definition_rest(def);
+        }
+        write_func_schedule(f.schedule());
+    }
+}
+
+void Serializer::serialize(const Pipeline &pipeline) {
+    user_assert(pipeline.defined())
+        << "Cannot serialize an undefined Pipeline.\n";
+
+    vector<Function> outputs;
+    map<string, Function> env;
+    for (const Func &f : pipeline.outputs()) {
+        outputs.push_back(f.function());
+        // populate_environment also pulls in wrapper Funcs, which
+        // aren't transitively called until lowering substitutes them.
+        populate_environment(f.function(), env);
+    }
+
+    write_bytes(kMagic, sizeof(kMagic));
+    write_u32(kVersion);
+
+    // The function table. Functions are allocated in groups (all
+    // within-group references must be weak), so record each
+    // function's group to reconstruct the same ownership structure.
+    write_u32((uint32_t)env.size());
+    vector<Function> funcs;
+    map<const FunctionGroup *, int> group_index;
+    for (const auto &it : env) {
+        function_index[it.first] = (int)funcs.size();
+        funcs.push_back(it.second);
+        const FunctionGroup *group = it.second.get_contents().group();
+        auto g = group_index.find(group);
+        if (g == group_index.end()) {
+            g = group_index.emplace(group, (int)group_index.size()).first;
+        }
+        write_string(it.first);
+        write_i32(g->second);
+    }
+    for (const Function &f : funcs) {
+        write_function(f);
+    }
+
+    write_u32((uint32_t)outputs.size());
+    for (const Function &f : outputs) {
+        write_i32(function_index[f.name()]);
+    }
+}
+
+class Deserializer {
+public:
+    explicit Deserializer(std::istream &in)
+        : in(in) {
+    }
+
+    Pipeline deserialize(map<string, Parameter> &external_params);
+
+private:
+    std::istream &in;
+
+    vector<Function> functions;
+    vector<Parameter> parameters;
+    vector<ReductionDomain> rdoms;
+    vector<Buffer<>> buffers;
+
+    // Wrapper wiring and freezing are deferred until every function
+    // has its definitions, since both prevent further definition.
+    struct WrapperRecord {
+        int func;
+        string wrapped;
+        int wrapper;
+    };
+    vector<WrapperRecord> wrappers;
+    vector<bool> frozen;
+
+    void read_bytes(void *data, size_t size) {
+        in.read((char *)data, (std::streamsize)size);
+        user_assert(in.good()) << "Deserializing pipeline: unexpected end of file.\n";
+    }
+    uint8_t read_u8() {
+        uint8_t v;
+        read_bytes(&v, sizeof(v));
+        return v;
+    }
+    bool read_bool() {
+        return read_u8() != 0;
+    }
+    uint32_t read_u32() {
+        uint32_t v;
+        read_bytes(&v, sizeof(v));
+        return v;
+    }
+    int32_t read_i32() {
+        int32_t v;
+        read_bytes(&v, sizeof(v));
+        return v;
+    }
+    int64_t read_i64() {
+        int64_t v;
+        read_bytes(&v, sizeof(v));
+        return v;
+    }
+    uint64_t read_u64() {
+        uint64_t v;
+        read_bytes(&v, sizeof(v));
+        return v;
+    }
+    double read_f64() {
+        double v;
+        read_bytes(&v, sizeof(v));
+        return v;
+    }
+    string read_string() {
+        uint32_t size = read_u32();
+        string s(size, '\0');
+        if (size > 0) {
+            read_bytes(&s[0], size);
+        }
+        return s;
+    }
+    vector<string> read_strings() {
+        uint32_t count = read_u32();
+        vector<string> v(count);
+        for (uint32_t i = 0; i < count; i++) {
+            v[i] = read_string();
+        }
+        return v;
+    }
+
+    Type read_type() {
+        halide_type_code_t code = (halide_type_code_t)read_u8();
+        int bits = read_u8();
+        int lanes = read_i32();
+        return Type(code, bits, lanes);
+    }
+    vector<Type> read_types() {
+        uint32_t count = read_u32();
+        vector<Type> v;
+        v.reserve(count);
+        for (uint32_t i = 0; i < count; i++) {
+            v.push_back(read_type());
+        }
+        return v;
+    }
+
+    Expr read_expr();
+    vector<Expr> read_exprs() {
+        uint32_t count = read_u32();
+        vector<Expr> v(count);
+        for (uint32_t i = 0; i < count; i++) {
+            v[i] = read_expr();
+        }
+        return v;
+    }
+
+    FunctionPtr read_function_ref();
+    Parameter read_parameter_ref();
+    ReductionDomain read_rdom_ref();
+    Buffer<> read_buffer_ref();
+
+    LoopLevel read_loop_level();
+    void read_func_schedule(FuncSchedule &s, int func_index);
+    void read_stage_schedule(StageSchedule &s);
+    void read_definition_rest(Definition &def);
+    void read_function(int index);
+};
+
+Expr Deserializer::read_expr() {
+    ExprTag tag = (ExprTag)read_u8();
+    switch (tag) {
+    case ExprTag::Undefined:
+        return Expr();
+    case ExprTag::IntImm: {
+        Type t = read_type();
+        int64_t v = read_i64();
+        return IntImm::make(t, v);
+    }
+    case ExprTag::UIntImm: {
+        Type t = read_type();
+        uint64_t v = read_u64();
+        return UIntImm::make(t, v);
+    }
+    case ExprTag::FloatImm: {
+        Type t = read_type();
+        double v = read_f64();
+        return FloatImm::make(t, v);
+    }
+    case ExprTag::StringImm:
+        return StringImm::make(read_string());
+    case ExprTag::Cast: {
+        Type t = read_type();
+        Expr v = read_expr();
+        return Cast::make(t, v);
+    }
+    case ExprTag::Variable: {
+        Type t = read_type();
+        string name = read_string();
+        Parameter param = read_parameter_ref();
+        Buffer<> image = read_buffer_ref();
+        ReductionDomain rdom = read_rdom_ref();
+        return Variable::make(t, name, image, param, rdom);
+    }
+    case ExprTag::Add: {
+        Expr a = read_expr();
+        Expr b = read_expr();
+        return Add::make(a, b);
+    }
+    case ExprTag::Sub: {
+        Expr a = read_expr();
+        Expr b = read_expr();
+        return Sub::make(a, b);
+    }
+    case ExprTag::Mul: {
+        Expr a = read_expr();
+        Expr b = read_expr();
+        return Mul::make(a, b);
+    }
+    case ExprTag::Div: {
+        Expr a = read_expr();
+        Expr b = read_expr();
+        return Div::make(a, b);
+    }
+    case ExprTag::Mod: {
+        Expr a = read_expr();
+        Expr b = read_expr();
+        return Mod::make(a, b);
+    }
+    case ExprTag::Min: {
+        Expr a = read_expr();
+        Expr b = read_expr();
+        return Min::make(a, b);
+    }
+    case ExprTag::Max: {
+        Expr a = read_expr();
+        Expr b = read_expr();
+        return Max::make(a, b);
+    }
+    case ExprTag::EQ: {
+        Expr a = read_expr();
+        Expr b = read_expr();
+        return EQ::make(a, b);
+    }
+    case ExprTag::NE: {
+        Expr a = read_expr();
+        Expr b = read_expr();
+        return NE::make(a, b);
+    }
+    case ExprTag::LT: {
+        Expr a = read_expr();
+        Expr b = read_expr();
+        return LT::make(a, b);
+    }
+    case ExprTag::LE: {
+        Expr a = read_expr();
+        Expr b = read_expr();
+        return LE::make(a, b);
+    }
+    case ExprTag::GT: {
+        Expr a = read_expr();
+        Expr b = read_expr();
+        return GT::make(a, b);
+    }
+    case ExprTag::GE: {
+        Expr a = read_expr();
+        Expr b = read_expr();
+        return GE::make(a, b);
+    }
+    case ExprTag::And: {
+        Expr a = read_expr();
+        Expr b = read_expr();
+        return And::make(a, b);
+    }
+    case ExprTag::Or: {
+        Expr a = read_expr();
+        Expr b = read_expr();
+        return Or::make(a, b);
+    }
+    case ExprTag::Not:
+        return Not::make(read_expr());
+    case ExprTag::Select: {
+        Expr c = read_expr();
+        Expr t = read_expr();
+        Expr f = read_expr();
+        return Select::make(c, t, f);
+    }
+    case ExprTag::Ramp: {
+        Expr base = read_expr();
+        Expr stride = read_expr();
+        int lanes = read_i32();
+        return Ramp::make(base, stride, lanes);
+    }
+    case ExprTag::Broadcast: {
+        Expr value = read_expr();
+        int lanes = read_i32();
+        return Broadcast::make(value, lanes);
+    }
+    case ExprTag::Call: {
+        Type t = read_type();
+        string name = read_string();
+        Call::CallType call_type = (Call::CallType)read_u8();
+        int value_index = read_i32();
+        FunctionPtr func = read_function_ref();
+        Buffer<> image = read_buffer_ref();
+        Parameter param = read_parameter_ref();
+        vector<Expr> args = read_exprs();
+        return Call::make(t, name, args, call_type, func, value_index, image, param);
+    }
+    case ExprTag::Let: {
+        string name = read_string();
+        Expr value = read_expr();
+        Expr body = read_expr();
+        return Let::make(name, value, body);
+    }
+    case ExprTag::Shuffle: {
+        vector<Expr> vectors = read_exprs();
+        uint32_t count = read_u32();
+        vector<int> indices(count);
+        for (uint32_t i = 0; i < count; i++) {
+            indices[i] = read_i32();
+        }
+        return Shuffle::make(vectors, indices);
+    }
+    case ExprTag::VectorReduce: {
+        VectorReduce::Operator op = (VectorReduce::Operator)read_u8();
+        int lanes = read_i32();
+        Expr value = read_expr();
+        return VectorReduce::make(op, value, lanes);
+    }
+    default:
+        user_error << "Deserializing pipeline: malformed Expr tag " << (int)tag << "\n";
+        return Expr();
+    }
+}
+
+FunctionPtr Deserializer::read_function_ref() {
+    int idx = read_i32();
+    if (idx < 0) {
+        return FunctionPtr();
+    }
+    internal_assert(idx < (int)functions.size());
+    return functions[idx].get_contents();
+}
+
+Parameter Deserializer::read_parameter_ref() {
+    int idx = read_i32();
+    if (idx < 0) {
+        return Parameter();
+    }
+    if (idx < (int)parameters.size()) {
+        return parameters[idx];
+    }
+    internal_assert(idx == (int)parameters.size());
+    string name = read_string();
+    Type type = read_type();
+    bool is_buffer = read_bool();
+    int dims = read_i32();
+    Parameter p(type, is_buffer, dims, name);
+    // Register the handle before reading the constraint exprs, which
+    // may refer back to this parameter.
+    parameters.push_back(p);
+    if (is_buffer) {
+        for (int d = 0; d < dims; d++) {
+            Expr min = read_expr();
+            Expr extent = read_expr();
+            Expr stride = read_expr();
+            Expr min_estimate = read_expr();
+            Expr extent_estimate = read_expr();
+            if (min.defined()) {
+                p.set_min_constraint(d, min);
+            }
+            if (extent.defined()) {
+                p.set_extent_constraint(d, extent);
+            }
+            if (stride.defined()) {
+                p.set_stride_constraint(d, stride);
+            }
+            if (min_estimate.defined()) {
+                p.set_min_constraint_estimate(d, min_estimate);
+            }
+            if (extent_estimate.defined()) {
+                p.set_extent_constraint_estimate(d, extent_estimate);
+            }
+        }
+        p.set_host_alignment(read_i32());
+        p.store_in((MemoryType)read_u8());
+    } else {
+        Expr min = read_expr();
+        Expr max = read_expr();
+        Expr estimate = read_expr();
+        Expr default_value = read_expr();
+        if (min.defined()) {
+            p.set_min_value(min);
+        }
+        if (max.defined()) {
+            p.set_max_value(max);
+        }
+        if (estimate.defined()) {
+            p.set_estimate(estimate);
+        }
+        if (default_value.defined()) {
+            p.set_default_value(default_value);
+        }
+        read_bytes(p.scalar_address(), p.type().bytes());
+    }
+    return p;
+}
+
+ReductionDomain Deserializer::read_rdom_ref() {
+    int idx = read_i32();
+    if (idx < 0) {
+        return ReductionDomain();
+    }
+    if (idx < (int)rdoms.size()) {
+        return rdoms[idx];
+    }
+    internal_assert(idx == (int)rdoms.size());
+    uint32_t count = read_u32();
+    vector<ReductionVariable> vars(count);
+    for (uint32_t i = 0; i < count; i++) {
+        vars[i].var = read_string();
+        vars[i].min = read_expr();
+        vars[i].extent = read_expr();
+    }
+    ReductionDomain r(vars);
+    // Register the handle before reading the predicate, whose RVars
+    // refer back to this domain. The domain is not frozen here;
+    // define_update freezes it, as it did for the original.
+    rdoms.push_back(r);
+    Expr predicate = read_expr();
+    if (predicate.defined()) {
+        r.set_predicate(predicate);
+    }
+    return r;
+}
+
+Buffer<> Deserializer::read_buffer_ref() {
+    int idx = read_i32();
+    if (idx < 0) {
+        return Buffer<>();
+    }
+    if (idx < (int)buffers.size()) {
+        return buffers[idx];
+    }
+    internal_assert(idx == (int)buffers.size());
+    string name = read_string();
+    Type type = read_type();
+    int dims = read_i32();
+    vector<halide_dimension_t> shape(dims);
+    int32_t stride = 1;
+    for (int d = 0; d < dims; d++) {
+        int32_t min = read_i32();
+        int32_t extent = read_i32();
+        shape[d] = {min, extent, stride, 0};
+        stride *= extent;
+    }
+    Buffer<> b(type, (void *)nullptr, dims, shape.data(), name);
+    if (read_bool()) {
+        b.allocate();
+        uint64_t size = read_u64();
+        internal_assert(size == (uint64_t)b.size_in_bytes());
+        read_bytes(b.data(), (size_t)size);
+    }
+    buffers.push_back(b);
+    return b;
+}
+
+LoopLevel Deserializer::read_loop_level() {
+    string func_name = read_string();
+    string var_name = read_string();
+    bool is_rvar = read_bool();
+    int stage_index = read_i32();
+    bool locked = read_bool();
+    return LoopLevel(func_name, var_name, is_rvar, stage_index, locked);
+}
+
+void Deserializer::read_func_schedule(FuncSchedule &s, int func_index) {
+    s.store_level() = read_loop_level();
+    s.compute_level() = read_loop_level();
+    uint32_t count = read_u32();
+    s.storage_dims().clear();
+    for (uint32_t i = 0; i < count; i++) {
+        StorageDim d;
+        d.var = read_string();
+        d.alignment = read_expr();
+        d.fold_factor = read_expr();
+        d.fold_forward = read_bool();
+        d.interleave_lanes = read_expr();
+        s.storage_dims().push_back(d);
+    }
+    count = read_u32();
+    s.bounds().clear();
+    for (uint32_t i = 0; i < count; i++) {
+        Bound b;
+        b.var = read_string();
+        b.min = read_expr();
+        b.extent = read_expr();
+        b.modulus = read_expr();
+        b.remainder = read_expr();
+        s.bounds().push_back(b);
+    }
+    count = read_u32();
+    s.estimates().clear();
+    for (uint32_t i = 0; i < count; i++) {
+        Bound b;
+        b.var = read_string();
+        b.min = read_expr();
+        b.extent = read_expr();
+        b.modulus = read_expr();
+        b.remainder = read_expr();
+        s.estimates().push_back(b);
+    }
+    count = read_u32();
+    for (uint32_t i = 0; i < count; i++) {
+        WrapperRecord w;
+        w.func = func_index;
+        w.wrapped = read_string();
+        w.wrapper = read_i32();
+        internal_assert(w.wrapper >= 0);
+        wrappers.push_back(w);
+    }
+    s.memory_type() = (MemoryType)read_u8();
+    s.memoized() = read_bool();
+    s.memoize_eviction_key() = read_expr();
+    s.async() = read_bool();
+    s.ring_buffer() = read_expr();
+    s.store_streaming() = read_bool();
+    s.fuse_gpu_stages() = read_bool();
+    s.store_persistent() = read_bool();
+    s.stack_budget_bytes() = read_i32();
+    s.fuse_tuple_stores() = read_bool();
+}
+
+void Deserializer::read_stage_schedule(StageSchedule &s) {
+    uint32_t count = read_u32();
+    s.rvars().clear();
+    for (uint32_t i = 0; i < count; i++) {
+        ReductionVariable rv;
+        rv.var = read_string();
+        rv.min = read_expr();
+        rv.extent = read_expr();
+        s.rvars().push_back(rv);
+    }
+    count = read_u32();
+    s.splits().clear();
+    for (uint32_t i = 0; i < count; i++) {
+        Split sp;
+        sp.old_var = read_string();
+        sp.outer = read_string();
+        sp.inner = read_string();
+        sp.factor = read_expr();
+        sp.exact = read_bool();
+        sp.tail = (TailStrategy)read_u8();
+        sp.split_type = (Split::SplitType)read_u8();
+        s.splits().push_back(sp);
+    }
+    count = read_u32();
+    s.dims().clear();
+    for (uint32_t i = 0; i < count; i++) {
+        Dim d;
+        d.var = read_string();
+        d.for_type = (ForType)read_u8();
+        d.device_api = (DeviceAPI)read_u8();
+        d.dim_type = (DimType)read_u8();
+        d.partition_policy = (Partition)read_u8();
+        s.dims().push_back(d);
+    }
+    count = read_u32();
+    s.prefetches().clear();
+    for (uint32_t i = 0; i < count; i++) {
+        PrefetchDirective p;
+        p.name = read_string();
+        p.var = read_string();
+        p.offset = read_expr();
+        p.strategy = (PrefetchBoundStrategy)read_u8();
+        p.locality = (PrefetchLocality)read_u8();
+        p.for_write = read_bool();
+        p.adaptive = read_bool();
+        p.param = read_parameter_ref();
+        s.prefetches().push_back(p);
+    }
+    count = read_u32();
+    s.pipeline_loops().clear();
+    for (uint32_t i = 0; i < count; i++) {
+        PipelineLoopDirective p;
+        p.var = read_string();
+        p.stages = read_i32();
+        s.pipeline_loops().push_back(p);
+    }
+    s.skip_conditions() = read_exprs();
+    LoopLevel fuse_level = read_loop_level();
+    count = read_u32();
+    map<string, LoopAlignStrategy> align;
+    for (uint32_t i = 0; i < count; i++) {
+        string var = read_string();
+        align[var] = (LoopAlignStrategy)read_u8();
+    }
+    s.fuse_level() = FuseLoopLevel(fuse_level, align);
+    count = read_u32();
+    s.fused_pairs().clear();
+    for (uint32_t i = 0; i < count; i++) {
+        FusedPair p;
+        p.func_1 = read_string();
+        p.stage_1 = (size_t)read_u64();
+        p.func_2 = read_string();
+        p.stage_2 = (size_t)read_u64();
+        p.var_name = read_string();
+        s.fused_pairs().push_back(p);
+    }
+    s.touched() = read_bool();
+    s.allow_race_conditions() = read_bool();
+    s.atomic() = read_bool();
+    s.override_atomic_associativity_test() = read_bool();
+}
+
+void Deserializer::read_definition_rest(Definition &def) {
+    def.predicate() = read_expr();
+    read_stage_schedule(def.schedule());
+    uint32_t count = read_u32();
+    for (uint32_t i = 0; i < count; i++) {
+        Expr condition = read_expr();
+        string failure_message = read_string();
+        vector<Expr> args = read_exprs();
+        vector<Expr> values = read_exprs();
+        def.add_specialization(condition);
+        Specialization &sp = def.specializations().back();
+        sp.failure_message = failure_message;
+        sp.definition.args() = args;
+        sp.definition.values() = values;
+        read_definition_rest(sp.definition);
+    }
+}
+
+void Deserializer::read_function(int index) {
+    Function &f = functions[index];
+    FunctionKind kind = (FunctionKind)read_u8();
+    if (read_bool()) {
+        f.trace_loads();
+    }
+    if (read_bool()) {
+        f.trace_stores();
+    }
+    if (read_bool()) {
+        f.trace_realizations();
+    }
+    for (const string &tag : read_strings()) {
+        f.add_trace_tag(tag);
+    }
+    frozen[index] = read_bool();
+    if (kind == FunctionKind::Extern) {
+        string function_name = read_string();
+        NameMangling mangling = (NameMangling)read_u8();
+        DeviceAPI device_api = (DeviceAPI)read_u8();
+        bool is_async = read_bool();
+        bool raw_pointers = read_bool();
+        vector<Type> types = read_types();
+        vector<Var> dims;
+        for (const string &name : read_strings()) {
+            dims.emplace_back(name);
+        }
+        uint32_t count = read_u32();
+        vector<ExternFuncArgument> args(count);
+        for (uint32_t i = 0; i < count; i++) {
+            args[i].arg_type = (ExternFuncArgument::ArgType)read_u8();
+            switch (args[i].arg_type) {
+            case ExternFuncArgument::FuncArg:
+                args[i].func = read_function_ref();
+                break;
+            case ExternFuncArgument::BufferArg:
+                args[i].buffer = read_buffer_ref();
+                break;
+            case ExternFuncArgument::ExprArg:
+                args[i].expr = read_expr();
+                break;
+            case ExternFuncArgument::ImageParamArg:
+                args[i].image_param = read_parameter_ref();
+                break;
+            case ExternFuncArgument::UndefinedArg:
+                break;
+            }
+        }
+        f.define_extern(function_name, args, types, dims, mangling, device_api);
+        f.extern_definition_is_async() = is_async;
+        f.extern_definition_uses_raw_pointers() = raw_pointers;
+        f.extern_definition_proxy_expr() = read_expr();
+        read_func_schedule(f.schedule(), index);
+        read_stage_schedule(f.definition().schedule());
+    } else {
+        vector<string> args = read_strings();
+        vector<Expr> values = read_exprs();
+        f.define(args, values);
+        read_definition_rest(f.definition());
+        uint32_t n_updates = read_u32();
+        for (uint32_t i = 0; i < n_updates; i++) {
+            // define_update re-discovers the reduction domain from
+            // the RVars in the args/values and freezes it, exactly as
+            // the original definition did.
+            vector<Expr> update_args = read_exprs();
+            vector<Expr> update_values = read_exprs();
+            f.define_update(update_args, update_values);
+            read_definition_rest(f.update((int)i));
+        }
+        read_func_schedule(f.schedule(), index);
+    }
+}
+
+Pipeline Deserializer::deserialize(map<string, Parameter> &external_params) {
+    char magic[sizeof(kMagic)];
+    read_bytes(magic, sizeof(magic));
+    user_assert(memcmp(magic, kMagic, sizeof(kMagic)) == 0)
+        << "Deserializing pipeline: not a serialized Halide pipeline.\n";
+    uint32_t version = read_u32();
+    user_assert(version == kVersion)
+        << "Deserializing pipeline: file has format version " << version
+        << ", but this Halide supports version " << kVersion << ".\n";
+
+    // Create all the functions up front, so that Call nodes anywhere
+    // in the stream can resolve regardless of definition order.
+    // Functions that shared an allocation group (e.g. a Func and the
+    // wrappers made by Func::in) are re-created in a shared group.
+    uint32_t n_funcs = read_u32();
+    functions.resize(n_funcs);
+    frozen.resize(n_funcs, false);
+    vector<Function> group_leader;
+    for (uint32_t i = 0; i < n_funcs; i++) {
+        string name = read_string();
+        int group = read_i32();
+        internal_assert(group >= 0 && group <= (int)group_leader.size());
+        if (group == (int)group_leader.size()) {
+            functions[i] = Function(name);
+            group_leader.push_back(functions[i]);
+        } else {
+            functions[i] = group_leader[group].new_function_in_same_group(name);
+        }
+    }
+    for (uint32_t i = 0; i < n_funcs; i++) {
+        read_function((int)i);
+    }
+
+    uint32_t n_outputs = read_u32();
+    vector<Func> outputs;
+    for (uint32_t i = 0; i < n_outputs; i++) {
+        int idx = read_i32();
+        internal_assert(idx >= 0 && idx < (int)functions.size());
+        outputs.emplace_back(functions[idx]);
+    }
+
+    // Wrapper wiring was deferred because add_wrapper freezes the
+    // wrapper, which would have prevented defining it above.
+    for (const WrapperRecord &w : wrappers) {
+        functions[w.func].add_wrapper(w.wrapped, functions[w.wrapper]);
+    }
+    for (uint32_t i = 0; i < n_funcs; i++) {
+        if (frozen[i]) {
+            functions[i].freeze();
+        }
+    }
+
+    // The Call nodes built above all hold strong references. Weaken
+    // any that point within their owner's group (define_update has
+    // already done this for self-calls in the base update defs, but
+    // not for specializations or schedule exprs).
+    for (Function &f : functions) {
+        WeakenWithinGroupReferences weakener(f.get_contents().group());
+        f.mutate(&weakener);
+    }
+
+    for (const Parameter &p : parameters) {
+        external_params.emplace(p.name(), p);
+    }
+
+    return Pipeline(outputs);
+}
+
+}  // namespace
+
+}  // namespace Internal
+
+void serialize_pipeline(const Pipeline &pipeline, const std::string &filename) {
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    user_assert(!out.fail())
+        << "Cannot open file for writing: " << filename << "\n";
+    Internal::Serializer serializer(out);
+    serializer.serialize(pipeline);
+    out.close();
+    user_assert(!out.fail())
+        << "Failed to write serialized pipeline to: " << filename << "\n";
+}
+
+Pipeline deserialize_pipeline(const std::string &filename,
+                              std::map<std::string, Internal::Parameter> &external_params) {
+    std::ifstream in(filename, std::ios::binary);
+    user_assert(!in.fail())
+        << "Cannot open file for reading: " << filename << "\n";
+    Internal::Deserializer deserializer(in);
+    return deserializer.deserialize(external_params);
+}
+
+Pipeline deserialize_pipeline(const std::string &filename) {
+    std::map<std::string, Internal::Parameter> external_params;
+    return deserialize_pipeline(filename, external_params);
+}
+
+namespace Internal {
+namespace {
+
+// The schedule package format is a deliberately simple line-oriented
+// text file, so that schedule artifacts are diffable and greppable.
+// Tokens are whitespace-separated; Halide names never contain
+// whitespace. The only structure is that store_level/compute_level
+// lines apply to the most recent func line, and split/dim lines to
+// the most recent stage line.
+const char *const kScheduleMagic = "HalideSchedule";
+constexpr int kScheduleVersion = 1;
+
+void write_schedule_loop_level(std::ostream &out, const char *key, const LoopLevel &l) {
+    out << key << " ";
+    if (!l.defined()) {
+        out << "undefined\n";
+    } else if (l.var_name() == "__root") {
+        out << "root\n";
+    } else if (l.var_name().empty()) {
+        out << "inlined\n";
+    } else {
+        out << "at " << l.func_name() << " " << l.get_stage_index() << " "
+            << (int)l.is_rvar() << " " << l.var_name() << "\n";
+    }
+}
+
+LoopLevel read_schedule_loop_level(std::istream &in, const string &filename) {
+    string kind;
+    in >> kind;
+    if (kind == "undefined") {
+        return LoopLevel();
+    } else if (kind == "root") {
+        return LoopLevel::root();
+    } else if (kind == "inlined") {
+        return LoopLevel::inlined();
+    }
+    user_assert(kind == "at") << filename << " is not a valid schedule file\n";
+    string func, var;
+    int stage = -1, is_rvar = 0;
+    in >> func >> stage >> is_rvar >> var;
+    return LoopLevel(func, var, is_rvar != 0, stage);
+}
+
+void write_schedule_stage(std::ostream &out, int index, const StageSchedule &s,
+                          const string &func_name) {
+    out << "stage " << index << "\n";
+    for (const Split &sp : s.splits()) {
+        int64_t factor = 0;
+        const bool has_factor = sp.factor.defined();
+        if (has_factor) {
+            const int64_t *f = as_const_int(sp.factor);
+            user_assert(f) << "Cannot save_schedule for " << func_name
+                           << ": the factor of the split producing " << sp.inner
+                           << " is " << sp.factor << ", which is not a constant\n";
+            factor = *f;
+        }
+        out << "split " << (int)sp.split_type << " " << (int)sp.tail << " "
+            << (int)sp.exact << " " << (int)has_factor << " " << factor << " "
+            << sp.old_var << " " << sp.outer << " " << sp.inner << "\n";
+    }
+    for (const Dim &d : s.dims()) {
+        out << "dim " << (int)d.for_type << " " << (int)d.device_api << " "
+            << (int)d.dim_type << " " << d.var << "\n";
+    }
+}
+
+}  // namespace
+}  // namespace Internal
+
+void save_schedule(const Pipeline &pipeline,
+                   const std::string &filename,
+                   const Target &target,
+                   const std::map<std::string, double> &metrics) {
+    user_assert(pipeline.defined()) << "Cannot save_schedule for an undefined Pipeline\n";
+
+    std::map<std::string, Internal::Function> env;
+    for (const Func &f : pipeline.outputs()) {
+        Internal::populate_environment(f.function(), env);
+    }
+
+    std::ofstream out(filename, std::ios::trunc);
+    user_assert(!out.fail()) << "Cannot open file for writing: " << filename << "\n";
+    out.precision(17);
+    out << Internal::kScheduleMagic << " " << Internal::kScheduleVersion << "\n";
+    out << "target " << target.to_string() << "\n";
+    for (const auto &m : metrics) {
+        out << "metric " << m.first << " " << m.second << "\n";
+    }
+    for (const auto &it : env) {
+        const Internal::Function &f = it.second;
+        const int num_stages = f.has_pure_definition() ? 1 + (int)f.updates().size() : 0;
+        out << "func " << f.name() << " " << num_stages << "\n";
+        Internal::write_schedule_loop_level(out, "store_level", f.schedule().store_level());
+        Internal::write_schedule_loop_level(out, "compute_level", f.schedule().compute_level());
+        if (f.has_pure_definition()) {
+            Internal::write_schedule_stage(out, 0, f.definition().schedule(), f.name());
+            for (size_t i = 0; i < f.updates().size(); i++) {
+                Internal::write_schedule_stage(out, (int)i + 1, f.updates()[i].schedule(), f.name());
+            }
+        }
+    }
+    out.close();
+    user_assert(!out.fail()) << "Failed to write schedule to: " << filename << "\n";
+}
+
+std::map<std::string, double> apply_schedule(Pipeline &pipeline,
+                                             const std::string &filename,
+                                             Target *target) {
+    user_assert(pipeline.defined()) << "Cannot apply_schedule to an undefined Pipeline\n";
+
+    std::ifstream in(filename);
+    user_assert(!in.fail()) << "Cannot open file for reading: " << filename << "\n";
+    std::string magic;
+    int version = 0;
+    in >> magic >> version;
+    user_assert(magic == Internal::kScheduleMagic)
+        << filename << " is not a Halide schedule file\n";
+    user_assert(version == Internal::kScheduleVersion)
+        << "Schedule file " << filename << " has version " << version
+        << "; this Halide expects version " << Internal::kScheduleVersion << "\n";
+
+    std::map<std::string, Internal::Function> env;
+    for (const Func &f : pipeline.outputs()) {
+        Internal::populate_environment(f.function(), env);
+    }
+
+    std::map<std::string, double> metrics;
+    Internal::Function current_func;
+    Internal::Definition current_def;
+    bool have_func = false, have_stage = false;
+    std::string key;
+    while (in >> key) {
+        if (key == "target") {
+            std::string t;
+            in >> t;
+            if (target) {
+                *target = Target(t);
+            }
+        } else if (key == "metric") {
+            std::string name;
+            double value = 0;
+            in >> name >> value;
+            metrics[name] = value;
+        } else if (key == "func") {
+            std::string name;
+            int num_stages = -1;
+            in >> name >> num_stages;
+            auto it = env.find(name);
+            user_assert(it != env.end())
+                << "Schedule file " << filename << " refers to Func \"" << name
+                << "\", which is not present in this pipeline\n";
+            current_func = it->second;
+            const int stages_here =
+                current_func.has_pure_definition() ? 1 + (int)current_func.updates().size() : 0;
+            user_assert(num_stages == stages_here)
+                << "Schedule file " << filename << " records " << num_stages
+                << " stages for Func \"" << name << "\", but it has " << stages_here
+                << "; was the pipeline built from the same algorithm?\n";
+            have_func = true;
+            have_stage = false;
+        } else if (key == "store_level" || key == "compute_level") {
+            user_assert(have_func) << filename << " is not a valid schedule file\n";
+            LoopLevel l = Internal::read_schedule_loop_level(in, filename);
+            if (key == "store_level") {
+                current_func.schedule().store_level() = l;
+            } else {
+                current_func.schedule().compute_level() = l;
+            }
+        } else if (key == "stage") {
+            user_assert(have_func) << filename << " is not a valid schedule file\n";
+            int i = -1;
+            in >> i;
+            current_def = (i == 0) ? current_func.definition() : current_func.update(i - 1);
+            // The file records the stage's splits and loop nest
+            // wholesale, so start from a clean slate.
+            current_def.schedule().splits().clear();
+            current_def.schedule().dims().clear();
+            have_stage = true;
+        } else if (key == "split") {
+            user_assert(have_stage) << filename << " is not a valid schedule file\n";
+            int split_type = 0, tail = 0, exact = 0, has_factor = 0;
+            int64_t factor = 0;
+            Internal::Split sp;
+            in >> split_type >> tail >> exact >> has_factor >> factor >> sp.old_var >> sp.outer >> sp.inner;
+            sp.split_type = (Internal::Split::SplitType)split_type;
+            sp.tail = (TailStrategy)tail;
+            sp.exact = exact != 0;
+            if (has_factor) {
+                sp.factor = Internal::IntImm::make(Int(32), factor);
+            }
+            current_def.schedule().splits().push_back(sp);
+        } else if (key == "dim") {
+            user_assert(have_stage) << filename << " is not a valid schedule file\n";
+            int for_type = 0, device_api = 0, dim_type = 0;
+            Internal::Dim d;
+            in >> for_type >> device_api >> dim_type >> d.var;
+            d.for_type = (Internal::ForType)for_type;
+            d.device_api = (DeviceAPI)device_api;
+            d.dim_type = (Internal::DimType)dim_type;
+            current_def.schedule().dims().push_back(d);
+        } else {
+            user_error << "Unexpected key \"" << key << "\" in schedule file " << filename << "\n";
+        }
+    }
+
+    pipeline.invalidate_cache();
+    return metrics;
+}
+
+}  // namespace Halide
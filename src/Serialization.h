@@ -0,0 +1,75 @@
+#ifndef HALIDE_SERIALIZATION_H
+#define HALIDE_SERIALIZATION_H
+
+/** \file
+ *
+ * Defines methods for serializing a Halide pipeline to a compact
+ * binary format and reconstructing it again. The serialized form
+ * captures the algorithm (pure and update definitions, reduction
+ * domains, extern definitions) and the schedule (splits, dims,
+ * storage directives, compute/store levels, specializations, etc.)
+ * of every Func reachable from the pipeline's outputs, along with
+ * any input Parameters and embedded Buffers they reference, so a
+ * pipeline can be built once and then shipped to other processes
+ * (e.g. autotuning measurement workers) to be scheduled further,
+ * compiled, or run.
+ *
+ * The format is a private implementation detail: it is not stable
+ * across Halide versions, and makes no attempt to be portable
+ * across machines with different endianness. Some state that does
+ * not affect compilation round-trips lossily: handle types lose
+ * their C++ type annotations, constraints set on output buffers are
+ * not preserved, and concrete buffers bound to input Parameters for
+ * jitting are not preserved (scalar parameter values are).
+ */
+
+#include <map>
+#include <string>
+
+#include "Pipeline.h"
+
+namespace Halide {
+
+/** Serialize a pipeline to the given file. The file is overwritten
+ * if it already exists. */
+void serialize_pipeline(const Pipeline &pipeline, const std::string &filename);
+
+/** Deserialize a pipeline from the given file. The input Parameters
+ * (ImageParams and scalar Params) reconstructed while deserializing
+ * are added to 'external_params', keyed by name, so the caller can
+ * bind buffers and values to them before jitting the result. */
+Pipeline deserialize_pipeline(const std::string &filename,
+                              std::map<std::string, Internal::Parameter> &external_params);
+
+/** Deserialize a pipeline from the given file, discarding the
+ * reconstructed input Parameters. */
+Pipeline deserialize_pipeline(const std::string &filename);
+
+/** Write the scheduling directives applied to every Func reachable
+ * from the pipeline's outputs -- splits, loop orderings and loop
+ * types, and compute/store levels -- to a versioned, human-readable
+ * text file, along with the target the schedule was tuned for and
+ * any measured performance numbers the caller wants to record with
+ * it (e.g. autotuner benchmark results). Unlike serialize_pipeline,
+ * the algorithm is not captured: the result is a portable schedule
+ * artifact that can be re-applied via apply_schedule to a pipeline
+ * built from the same algorithm. Split factors must be compile-time
+ * constants. */
+void save_schedule(const Pipeline &pipeline,
+                   const std::string &filename,
+                   const Target &target,
+                   const std::map<std::string, double> &metrics = {});
+
+/** Apply a schedule file written by save_schedule to a pipeline built
+ * from the same algorithm, replacing the splits, loop orderings, and
+ * compute/store levels of every Func the file mentions. Funcs the
+ * file does not mention keep their current schedule. Returns the
+ * performance metrics recorded in the file, and the target the
+ * schedule was tuned for in 'target' if non-null. */
+std::map<std::string, double> apply_schedule(Pipeline &pipeline,
+                                             const std::string &filename,
+                                             Target *target = nullptr);
+
+}  // namespace Halide
+
+#endif
@@ -52,6 +52,27 @@ Simplify::Simplify(bool r, const Scope<Interval> *bi, const Scope<ModulusRemaind
         bounds.alignment = iter.value();
         bounds_and_alignment_info.push(iter.name(), bounds);
     }
+
+    // Lowering calls simplify() on the whole program many times with
+    // the default configuration and no enclosing context, and most of
+    // the tree is unchanged between calls, so that's the case worth
+    // memoizing. Stamps written under one configuration would be
+    // wrong to trust under another (e.g. dead lets would survive a
+    // remove_dead_lets pass), so other configurations opt out
+    // entirely.
+    memoize_clean_stmts = remove_dead_lets &&
+                          bi->cbegin() == bi->cend() &&
+                          ai->cbegin() == ai->cend();
+}
+
+void Simplify::skipped_clean_stmt() {
+    // This can only keep lets alive, never drop them: simplify_let
+    // also requires an exact occurrence count over the final body
+    // (count_var_uses) before emitting a let, and that traversal does
+    // see skipped subtrees.
+    for (auto iter = var_info.cbegin(); iter != var_info.cend(); ++iter) {
+        var_info.ref(iter.name()).old_uses++;
+    }
 }
 
 void Simplify::found_buffer_reference(const string &name, size_t dimensions) {
@@ -327,7 +348,15 @@ Stmt Simplify::ScopedFact::substitute_facts(const Stmt &s) {
 
 Simplify::ScopedFact::~ScopedFact() {
     for (const auto *v : pop_list) {
+        // A fact entry shadows any let binding of the same name. Old
+        // uses observed while the fact was active (possible when a
+        // stamped subtree was skipped) belong to the binding below,
+        // so hand them down rather than dropping them.
+        int old_uses = simplify->var_info.get(v->name).old_uses;
         simplify->var_info.pop(v->name);
+        if (old_uses > 0 && simplify->var_info.contains(v->name)) {
+            simplify->var_info.ref(v->name).old_uses += old_uses;
+        }
     }
     for (const auto *v : bounds_pop_list) {
         simplify->bounds_and_alignment_info.pop(v->name);
@@ -6,6 +6,8 @@
 #include "IROperator.h"
 #include "Simplify.h"
 #include "Substitute.h"
+#include "ThreadPool.h"
+#include "Util.h"
 
 #include <set>
 #include <utility>
@@ -157,6 +159,26 @@ vector<Definition> propagate_specialization_in_definition(Definition &def, const
 }  // namespace
 
 void simplify_specializations(map<string, Function> &env) {
+    // Each Function's definition is simplified in isolation, so with
+    // HL_PARALLEL_LOWERING set the Functions can be handled on a
+    // thread pool.
+    if (!get_env_variable("HL_PARALLEL_LOWERING").empty() && env.size() > 1) {
+        ThreadPool<void> pool;
+        vector<std::future<void>> futures;
+        for (auto &iter : env) {
+            Function &func = iter.second;
+            if (func.definition().defined()) {
+                futures.push_back(pool.async([&func]() {
+                    propagate_specialization_in_definition(func.definition(), func.name());
+                }));
+            }
+        }
+        for (auto &f : futures) {
+            f.get();
+        }
+        return;
+    }
+
     for (auto &iter : env) {
         Function &func = iter.second;
         if (func.definition().defined()) {
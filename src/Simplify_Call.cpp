@@ -469,7 +469,7 @@ Expr Simplify::visit(const Call *op, ExprInfo *bounds) {
         // Collapse the prefetched region into lower dimension whenever is possible.
         // TODO(psuriana): Deal with negative strides and overlaps.
 
-        internal_assert(op->args.size() % 2 == 0);  // Format: {base, offset, extent0, min0, ...}
+        internal_assert(op->args.size() >= 4 && op->args.size() % 2 == 0);  // Format: {base, offset, rw, locality, extent0, stride0, ...}
 
         vector<Expr> args(op->args);
         bool changed = false;
@@ -484,7 +484,7 @@ Expr Simplify::visit(const Call *op, ExprInfo *bounds) {
         // based on the storage dimension in ascending order (i.e. innermost
         // first and outermost last), so, it is enough to check for the upper
         // triangular pairs to see if any contiguous addresses exist.
-        for (size_t i = 2; i < args.size(); i += 2) {
+        for (size_t i = 4; i < args.size(); i += 2) {
             Expr extent_0 = args[i];
             Expr stride_0 = args[i + 1];
             for (size_t j = i + 2; j < args.size(); j += 2) {
@@ -147,6 +147,17 @@ public:
     }
 #else
     Stmt mutate(const Stmt &s) {
+        if (memoize_clean_stmts) {
+            if (s.get()->simplify_stamp.load(std::memory_order_relaxed)) {
+                // A previous pass already put this subtree into
+                // canonical form, and nothing has rebuilt it since.
+                skipped_clean_stmt();
+                return s;
+            }
+            Stmt new_s = Super::dispatch(s);
+            new_s.get()->simplify_stamp.store(1, std::memory_order_relaxed);
+            return new_s;
+        }
         return Super::dispatch(s);
     }
 #endif
@@ -154,6 +165,21 @@ public:
     bool remove_dead_lets;
     bool no_float_simplify;
 
+    // Whether to stamp statements we canonicalize and trust stamps
+    // left by previous passes. Only enabled for the default
+    // simplifier configuration (see the constructor); other
+    // configurations would want different canonical forms, so they
+    // neither write nor read stamps. Skipping a stamped subtree can
+    // only forgo further simplification, never change meaning, with
+    // one trap: uses of let variables inside it go unobserved, which
+    // is what skipped_clean_stmt() accounts for.
+    bool memoize_clean_stmts = false;
+
+    // Called when a stamped subtree is skipped. Conservatively marks
+    // every let variable in scope as used, since the subtree may
+    // reference any of them without us seeing the use.
+    void skipped_clean_stmt();
+
     HALIDE_ALWAYS_INLINE
     bool may_simplify(const Type &t) const {
         return !no_float_simplify || !t.is_float();
@@ -56,6 +56,12 @@ Expr Simplify::visit(const Mul *op, ExprInfo *bounds) {
             std::swap(a_bounds, b_bounds);
         }
 
+        // As in Simplify_Add.cpp, the rules are grouped into banks
+        // guarded by necessary conditions on the operand node types,
+        // in their original order.
+        const IRNodeType a_node = a.node_type();
+        const IRNodeType b_node = b.node_type();
+
         auto rewrite = IRMatcher::rewriter(IRMatcher::mul(a, b), op->type);
         if (rewrite(c0 * c1, fold(c0 * c1)) ||
             rewrite(IRMatcher::Overflow() * x, a) ||
@@ -67,20 +73,24 @@ Expr Simplify::visit(const Mul *op, ExprInfo *bounds) {
             return rewrite.result;
         }
 
-        if (rewrite((x + c0) * c1, x * c1 + fold(c0 * c1), !overflows(c0 * c1)) ||
-            rewrite((c0 - x) * c1, x * fold(-c1) + fold(c0 * c1), !overflows(c0 * c1)) ||
-            rewrite((x - y) * c0, (y - x) * fold(-c0), c0 < 0 && -c0 > 0) ||
-            rewrite((x * c0) * c1, x * fold(c0 * c1), !overflows(c0 * c1)) ||
-            rewrite((x * c0) * y, (x * y) * c0, !is_const(y)) ||
-            rewrite(x * (y * c0), (x * y) * c0) ||
-            rewrite(max(x, y) * min(x, y), x * y) ||
-            rewrite(max(x, y) * min(y, x), y * x) ||
-            rewrite(broadcast(x, c0) * broadcast(y, c0), broadcast(x * y, c0)) ||
-            rewrite(broadcast(x, c0) * broadcast(y, c1), broadcast(x * broadcast(y, fold(c1 / c0)), c0), c1 % c0 == 0) ||
-            rewrite(broadcast(y, c1) * broadcast(x, c0), broadcast(broadcast(y, fold(c1 / c0)) * x, c0), c1 % c0 == 0) ||
-            rewrite(ramp(x, y, c0) * broadcast(z, c0), ramp(x * z, y * z, c0)) ||
-            rewrite(ramp(broadcast(x, c0), broadcast(y, c0), c1) * broadcast(z, c2),
-                    ramp(broadcast(x * z, c0), broadcast(y * z, c0), c1), c2 == c0 * c1) ||
+        if (((a_node == IRNodeType::Add || a_node == IRNodeType::Sub || a_node == IRNodeType::Mul) &&
+             (rewrite((x + c0) * c1, x * c1 + fold(c0 * c1), !overflows(c0 * c1)) ||
+              rewrite((c0 - x) * c1, x * fold(-c1) + fold(c0 * c1), !overflows(c0 * c1)) ||
+              rewrite((x - y) * c0, (y - x) * fold(-c0), c0 < 0 && -c0 > 0) ||
+              rewrite((x * c0) * c1, x * fold(c0 * c1), !overflows(c0 * c1)) ||
+              rewrite((x * c0) * y, (x * y) * c0, !is_const(y)))) ||
+            (b_node == IRNodeType::Mul &&
+             rewrite(x * (y * c0), (x * y) * c0)) ||
+            (a_node == IRNodeType::Max &&
+             (rewrite(max(x, y) * min(x, y), x * y) ||
+              rewrite(max(x, y) * min(y, x), y * x))) ||
+            (op->type.is_vector() &&
+             (rewrite(broadcast(x, c0) * broadcast(y, c0), broadcast(x * y, c0)) ||
+              rewrite(broadcast(x, c0) * broadcast(y, c1), broadcast(x * broadcast(y, fold(c1 / c0)), c0), c1 % c0 == 0) ||
+              rewrite(broadcast(y, c1) * broadcast(x, c0), broadcast(broadcast(y, fold(c1 / c0)) * x, c0), c1 % c0 == 0) ||
+              rewrite(ramp(x, y, c0) * broadcast(z, c0), ramp(x * z, y * z, c0)) ||
+              rewrite(ramp(broadcast(x, c0), broadcast(y, c0), c1) * broadcast(z, c2),
+                      ramp(broadcast(x * z, c0), broadcast(y * z, c0), c1), c2 == c0 * c1))) ||
             false) {
             return mutate(rewrite.result, bounds);
         }
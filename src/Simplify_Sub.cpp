@@ -32,6 +32,12 @@ Expr Simplify::visit(const Sub *op, ExprInfo *bounds) {
 
     if (may_simplify(op->type)) {
 
+        // As in Simplify_Add.cpp, the rules are grouped into banks
+        // guarded by necessary conditions on the operand node types,
+        // in their original order.
+        const IRNodeType a_node = a.node_type();
+        const IRNodeType b_node = b.node_type();
+
         auto rewrite = IRMatcher::rewriter(IRMatcher::sub(a, b), op->type);
 
         if (rewrite(c0 - c1, fold(c0 - c1)) ||
@@ -45,104 +51,112 @@ Expr Simplify::visit(const Sub *op, ExprInfo *bounds) {
         if (EVAL_IN_LAMBDA
             ((!op->type.is_uint() && rewrite(x - c0, x + fold(-c0), !overflows(-c0))) ||
              rewrite(x - x, 0) || // We want to remutate this just to get better bounds
-             rewrite(ramp(x, y, c0) - ramp(z, w, c0), ramp(x - z, y - w, c0)) ||
-             rewrite(ramp(x, y, c0) - broadcast(z, c0), ramp(x - z, y, c0)) ||
-             rewrite(broadcast(x, c0) - ramp(z, w, c0), ramp(x - z, -w, c0)) ||
-             rewrite(broadcast(x, c0) - broadcast(y, c0), broadcast(x - y, c0)) ||
-             rewrite(broadcast(x, c0) - broadcast(y, c1), broadcast(x - broadcast(y, fold(c1/c0)), c0), c1 % c0 == 0) ||
-             rewrite(broadcast(y, c1) - broadcast(x, c0), broadcast(broadcast(y, fold(c1/c0)) - x, c0), c1 % c0 == 0) ||
-             rewrite((x - broadcast(y, c0)) - broadcast(z, c0), x - broadcast(y + z, c0)) ||
-             rewrite((x + broadcast(y, c0)) - broadcast(z, c0), x + broadcast(y - z, c0)) ||
-
-             rewrite(ramp(broadcast(x, c0), y, c1) - broadcast(z, c2), ramp(broadcast(x - z, c0), y, c1), c2 == c0 * c1) ||
-             rewrite(ramp(ramp(x, y, c0), z, c1) - broadcast(w, c2), ramp(ramp(x - w, y, c0), z, c1), c2 == c0 * c1) ||
-             rewrite(select(x, y, z) - select(x, w, u), select(x, y - w, z - u)) ||
-             rewrite(select(x, y, z) - y, select(x, 0, z - y)) ||
-             rewrite(select(x, y, z) - z, select(x, y - z, 0)) ||
-             rewrite(y - select(x, y, z), select(x, 0, y - z)) ||
-             rewrite(z - select(x, y, z), select(x, z - y, 0)) ||
-
-             rewrite(select(x, y + w, z) - y, select(x, w, z - y)) ||
-             rewrite(select(x, w + y, z) - y, select(x, w, z - y)) ||
-             rewrite(select(x, y, z + w) - z, select(x, y - z, w)) ||
-             rewrite(select(x, y, w + z) - z, select(x, y - z, w)) ||
-             rewrite(y - select(x, y + w, z), 0 - select(x, w, z - y)) ||
-             rewrite(y - select(x, w + y, z), 0 - select(x, w, z - y)) ||
-             rewrite(z - select(x, y, z + w), 0 - select(x, y - z, w)) ||
-             rewrite(z - select(x, y, w + z), 0 - select(x, y - z, w)) ||
-
-             rewrite((x + y) - x, y) ||
-             rewrite((x + y) - y, x) ||
-             rewrite(x - (x + y), -y) ||
-             rewrite(y - (x + y), -x) ||
-             rewrite((x - y) - x, -y) ||
-             rewrite((select(x, y, z) + w) - select(x, u, v), select(x, y - u, z - v) + w) ||
-             rewrite((w + select(x, y, z)) - select(x, u, v), select(x, y - u, z - v) + w) ||
-             rewrite(select(x, y, z) - (select(x, u, v) + w), select(x, y - u, z - v) - w) ||
-             rewrite(select(x, y, z) - (w + select(x, u, v)), select(x, y - u, z - v) - w) ||
-             rewrite((select(x, y, z) - w) - select(x, u, v), select(x, y - u, z - v) - w) ||
-             rewrite(c0 - select(x, c1, c2), select(x, fold(c0 - c1), fold(c0 - c2))) ||
-             rewrite((x + c0) - c1, x + fold(c0 - c1)) ||
-             rewrite((x + c0) - (c1 - y), (x + y) + fold(c0 - c1)) ||
-             rewrite((x + c0) - (y + c1), (x - y) + fold(c0 - c1)) ||
-             rewrite((x + c0) - y, (x - y) + c0) ||
-             rewrite((c0 - x) - (c1 - y), (y - x) + fold(c0 - c1)) ||
-             rewrite((c0 - x) - (y + c1), fold(c0 - c1) - (x + y)) ||
-             rewrite(x - (y - z), x + (z - y)) ||
-             rewrite(x - y*c0, x + y*fold(-c0), c0 < 0 && -c0 > 0) ||
-             rewrite(x - (y + c0), (x - y) - c0) ||
-             rewrite((c0 - x) - c1, fold(c0 - c1) - x) ||
-             rewrite(x*y - z*y, (x - z)*y) ||
-             rewrite(x*y - y*z, (x - z)*y) ||
-             rewrite(y*x - z*y, y*(x - z)) ||
-             rewrite(y*x - y*z, y*(x - z)) ||
-             rewrite((x + y) - (x + z), y - z) ||
-             rewrite((x + y) - (z + x), y - z) ||
-             rewrite((y + x) - (x + z), y - z) ||
-             rewrite((y + x) - (z + x), y - z) ||
-             rewrite(((x + y) + z) - x, y + z) ||
-             rewrite(((y + x) + z) - x, y + z) ||
-             rewrite((z + (x + y)) - x, z + y) ||
-             rewrite((z + (y + x)) - x, z + y) ||
-
-             rewrite(x - (y + (x - z)), z - y) ||
-             rewrite(x - ((x - y) + z), y - z) ||
-             rewrite((x + (y - z)) - y, x - z) ||
-             rewrite(((x - y) + z) - x, z - y) ||
-
-             rewrite(x - (y + (x + z)), 0 - (y + z)) ||
-             rewrite(x - (y + (z + x)), 0 - (y + z)) ||
-             rewrite(x - ((x + y) + z), 0 - (y + z)) ||
-             rewrite(x - ((y + x) + z), 0 - (y + z)) ||
-             rewrite((x + y) - (z + (w + x)), y - (z + w)) ||
-             rewrite((x + y) - (z + (w + y)), x - (z + w)) ||
-             rewrite((x + y) - (z + (x + w)), y - (z + w)) ||
-             rewrite((x + y) - (z + (y + w)), x - (z + w)) ||
-             rewrite((x + y) - ((x + z) + w), y - (z + w)) ||
-             rewrite((x + y) - ((y + z) + w), x - (z + w)) ||
-             rewrite((x + y) - ((z + x) + w), y - (z + w)) ||
-             rewrite((x + y) - ((z + y) + w), x - (z + w)) ||
-
-             rewrite((x - y) - (x + z), 0 - y - z) ||
-             rewrite((x - y) - (z + x), 0 - y - z) ||
-
-             rewrite(((x + y) - z) - x, y - z) ||
-             rewrite(((x + y) - z) - y, x - z) ||
-
-             rewrite(x - min(x - y, 0), max(x, y)) ||
-             rewrite(x - max(x - y, 0), min(x, y)) ||
-             rewrite((x + y) - min(x, y), max(y, x)) ||
-             rewrite((x + y) - min(y, x), max(y, x)) ||
-             rewrite((x + y) - max(x, y), min(y, x)) ||
-             rewrite((x + y) - max(y, x), min(x, y)) ||
-
-             rewrite(0 - (x + (y - z)), z - (x + y)) ||
-             rewrite(0 - ((x - y) + z), y - (x + z)) ||
-             rewrite(((x - y) - z) - x, 0 - (y + z)) ||
-
-             rewrite(x - x%c0, (x/c0)*c0) ||
+             (op->type.is_vector() &&
+              (rewrite(ramp(x, y, c0) - ramp(z, w, c0), ramp(x - z, y - w, c0)) ||
+               rewrite(ramp(x, y, c0) - broadcast(z, c0), ramp(x - z, y, c0)) ||
+               rewrite(broadcast(x, c0) - ramp(z, w, c0), ramp(x - z, -w, c0)) ||
+               rewrite(broadcast(x, c0) - broadcast(y, c0), broadcast(x - y, c0)) ||
+               rewrite(broadcast(x, c0) - broadcast(y, c1), broadcast(x - broadcast(y, fold(c1/c0)), c0), c1 % c0 == 0) ||
+               rewrite(broadcast(y, c1) - broadcast(x, c0), broadcast(broadcast(y, fold(c1/c0)) - x, c0), c1 % c0 == 0) ||
+               rewrite((x - broadcast(y, c0)) - broadcast(z, c0), x - broadcast(y + z, c0)) ||
+               rewrite((x + broadcast(y, c0)) - broadcast(z, c0), x + broadcast(y - z, c0)) ||
+
+               rewrite(ramp(broadcast(x, c0), y, c1) - broadcast(z, c2), ramp(broadcast(x - z, c0), y, c1), c2 == c0 * c1) ||
+               rewrite(ramp(ramp(x, y, c0), z, c1) - broadcast(w, c2), ramp(ramp(x - w, y, c0), z, c1), c2 == c0 * c1))) ||
+             ((a_node == IRNodeType::Select || b_node == IRNodeType::Select) &&
+              (rewrite(select(x, y, z) - select(x, w, u), select(x, y - w, z - u)) ||
+               rewrite(select(x, y, z) - y, select(x, 0, z - y)) ||
+               rewrite(select(x, y, z) - z, select(x, y - z, 0)) ||
+               rewrite(y - select(x, y, z), select(x, 0, y - z)) ||
+               rewrite(z - select(x, y, z), select(x, z - y, 0)) ||
+
+               rewrite(select(x, y + w, z) - y, select(x, w, z - y)) ||
+               rewrite(select(x, w + y, z) - y, select(x, w, z - y)) ||
+               rewrite(select(x, y, z + w) - z, select(x, y - z, w)) ||
+               rewrite(select(x, y, w + z) - z, select(x, y - z, w)) ||
+               rewrite(y - select(x, y + w, z), 0 - select(x, w, z - y)) ||
+               rewrite(y - select(x, w + y, z), 0 - select(x, w, z - y)) ||
+               rewrite(z - select(x, y, z + w), 0 - select(x, y - z, w)) ||
+               rewrite(z - select(x, y, w + z), 0 - select(x, y - z, w)))) ||
+
+             ((a_node == IRNodeType::Add || a_node == IRNodeType::Sub || a_node == IRNodeType::Mul ||
+               b_node == IRNodeType::Add || b_node == IRNodeType::Sub || b_node == IRNodeType::Mul ||
+               b_node == IRNodeType::Min || b_node == IRNodeType::Max || b_node == IRNodeType::Mod ||
+               b_node == IRNodeType::Select) &&
+              (rewrite((x + y) - x, y) ||
+               rewrite((x + y) - y, x) ||
+               rewrite(x - (x + y), -y) ||
+               rewrite(y - (x + y), -x) ||
+               rewrite((x - y) - x, -y) ||
+               rewrite((select(x, y, z) + w) - select(x, u, v), select(x, y - u, z - v) + w) ||
+               rewrite((w + select(x, y, z)) - select(x, u, v), select(x, y - u, z - v) + w) ||
+               rewrite(select(x, y, z) - (select(x, u, v) + w), select(x, y - u, z - v) - w) ||
+               rewrite(select(x, y, z) - (w + select(x, u, v)), select(x, y - u, z - v) - w) ||
+               rewrite((select(x, y, z) - w) - select(x, u, v), select(x, y - u, z - v) - w) ||
+               rewrite(c0 - select(x, c1, c2), select(x, fold(c0 - c1), fold(c0 - c2))) ||
+               rewrite((x + c0) - c1, x + fold(c0 - c1)) ||
+               rewrite((x + c0) - (c1 - y), (x + y) + fold(c0 - c1)) ||
+               rewrite((x + c0) - (y + c1), (x - y) + fold(c0 - c1)) ||
+               rewrite((x + c0) - y, (x - y) + c0) ||
+               rewrite((c0 - x) - (c1 - y), (y - x) + fold(c0 - c1)) ||
+               rewrite((c0 - x) - (y + c1), fold(c0 - c1) - (x + y)) ||
+               rewrite(x - (y - z), x + (z - y)) ||
+               rewrite(x - y*c0, x + y*fold(-c0), c0 < 0 && -c0 > 0) ||
+               rewrite(x - (y + c0), (x - y) - c0) ||
+               rewrite((c0 - x) - c1, fold(c0 - c1) - x) ||
+               rewrite(x*y - z*y, (x - z)*y) ||
+               rewrite(x*y - y*z, (x - z)*y) ||
+               rewrite(y*x - z*y, y*(x - z)) ||
+               rewrite(y*x - y*z, y*(x - z)) ||
+               rewrite((x + y) - (x + z), y - z) ||
+               rewrite((x + y) - (z + x), y - z) ||
+               rewrite((y + x) - (x + z), y - z) ||
+               rewrite((y + x) - (z + x), y - z) ||
+               rewrite(((x + y) + z) - x, y + z) ||
+               rewrite(((y + x) + z) - x, y + z) ||
+               rewrite((z + (x + y)) - x, z + y) ||
+               rewrite((z + (y + x)) - x, z + y) ||
+
+               rewrite(x - (y + (x - z)), z - y) ||
+               rewrite(x - ((x - y) + z), y - z) ||
+               rewrite((x + (y - z)) - y, x - z) ||
+               rewrite(((x - y) + z) - x, z - y) ||
+
+               rewrite(x - (y + (x + z)), 0 - (y + z)) ||
+               rewrite(x - (y + (z + x)), 0 - (y + z)) ||
+               rewrite(x - ((x + y) + z), 0 - (y + z)) ||
+               rewrite(x - ((y + x) + z), 0 - (y + z)) ||
+               rewrite((x + y) - (z + (w + x)), y - (z + w)) ||
+               rewrite((x + y) - (z + (w + y)), x - (z + w)) ||
+               rewrite((x + y) - (z + (x + w)), y - (z + w)) ||
+               rewrite((x + y) - (z + (y + w)), x - (z + w)) ||
+               rewrite((x + y) - ((x + z) + w), y - (z + w)) ||
+               rewrite((x + y) - ((y + z) + w), x - (z + w)) ||
+               rewrite((x + y) - ((z + x) + w), y - (z + w)) ||
+               rewrite((x + y) - ((z + y) + w), x - (z + w)) ||
+
+               rewrite((x - y) - (x + z), 0 - y - z) ||
+               rewrite((x - y) - (z + x), 0 - y - z) ||
+
+               rewrite(((x + y) - z) - x, y - z) ||
+               rewrite(((x + y) - z) - y, x - z) ||
+
+               rewrite(x - min(x - y, 0), max(x, y)) ||
+               rewrite(x - max(x - y, 0), min(x, y)) ||
+               rewrite((x + y) - min(x, y), max(y, x)) ||
+               rewrite((x + y) - min(y, x), max(y, x)) ||
+               rewrite((x + y) - max(x, y), min(y, x)) ||
+               rewrite((x + y) - max(y, x), min(x, y)) ||
+
+               rewrite(0 - (x + (y - z)), z - (x + y)) ||
+               rewrite(0 - ((x - y) + z), y - (x + z)) ||
+               rewrite(((x - y) - z) - x, 0 - (y + z)) ||
+
+               rewrite(x - x%c0, (x/c0)*c0))) ||
 
              (no_overflow(op->type) &&
+              (a_node == IRNodeType::Min || a_node == IRNodeType::Max || a_node == IRNodeType::Mul ||
+               b_node == IRNodeType::Min || b_node == IRNodeType::Max || b_node == IRNodeType::Mul) &&
               (rewrite(max(x, y) - x, max(y - x, 0)) ||
                rewrite(min(x, y) - x, min(y - x, 0)) ||
                rewrite(max(x, y) - y, max(x - y, 0)) ||
@@ -345,6 +359,9 @@ Expr Simplify::visit(const Sub *op, ExprInfo *bounds) {
                rewrite(max(y, x + c0) - max(x + c1, w), min(max(x + c0, y) - w, fold(c0 - c1)), can_prove(y + c1 <= w + c0, this)))) ||
 
              (no_overflow_int(op->type) &&
+              (a_node == IRNodeType::Div || a_node == IRNodeType::Mul ||
+               a_node == IRNodeType::Min || a_node == IRNodeType::Add ||
+               b_node == IRNodeType::Div || b_node == IRNodeType::Mul) &&
               (rewrite(c0 - (c1 - x)/c2, (fold(c0*c2 - c1 + c2 - 1) + x)/c2, c2 > 0) ||
                rewrite(c0 - (x + c1)/c2, (fold(c0*c2 - c1 + c2 - 1) - x)/c2, c2 > 0) ||
                rewrite(x - (x + y)/c0, (x*fold(c0 - 1) - y + fold(c0 - 1))/c0, c0 > 0) ||
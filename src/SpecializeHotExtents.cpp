@@ -0,0 +1,121 @@
+#include "SpecializeHotExtents.h"
+#include "Function.h"
+#include "IROperator.h"
+#include "IRVisitor.h"
+#include "Parameter.h"
+#include "Simplify.h"
+#include "Substitute.h"
+
+#include <map>
+#include <set>
+
+namespace Halide {
+namespace Internal {
+
+using std::map;
+using std::string;
+using std::vector;
+
+namespace {
+
+// Find every buffer parameter referenced by the pipeline body, so we
+// can ask each one which of its dimensions have hot extents declared.
+class FindBufferParameters : public IRVisitor {
+    using IRVisitor::visit;
+
+    void visit(const Variable *op) override {
+        if (op->param.defined() && op->param.is_buffer()) {
+            params[op->param.name()] = op->param;
+        }
+    }
+
+    void visit(const Call *op) override {
+        if (op->param.defined() && op->param.is_buffer()) {
+            params[op->param.name()] = op->param;
+        }
+        IRVisitor::visit(op);
+    }
+
+public:
+    map<string, Parameter> params;
+};
+
+}  // namespace
+
+Stmt specialize_hot_extents(const Stmt &s) {
+    FindBufferParameters finder;
+    s.accept(&finder);
+
+    Stmt result = s;
+    for (const auto &p : finder.params) {
+        const Parameter &param = p.second;
+        for (int d = 0; d < param.dimensions(); d++) {
+            const vector<int> &hot = param.hot_extents(d);
+            if (hot.empty()) {
+                continue;
+            }
+
+            string var_name = param.name() + ".extent." + std::to_string(d);
+            Expr extent = Variable::make(Int(32), var_name, param);
+
+            // Build the dispatch chain from the last hot extent
+            // inwards, so the first one listed is tested first. The
+            // accumulated result (including any specializations
+            // already applied for other dimensions) serves as both
+            // the generic fallback and the body to specialize, so
+            // multiple annotated dimensions compose into nested
+            // dispatches.
+            Stmt chain = result;
+            for (auto it = hot.rbegin(); it != hot.rend(); ++it) {
+                Expr c = make_const(Int(32), *it);
+                // Don't remove dead lets; storage folding still
+                // needs the .loop_max symbols at this point.
+                Stmt body = simplify(substitute(var_name, c, result), false);
+                chain = IfThenElse::make(extent == c, body, chain);
+            }
+            result = chain;
+        }
+    }
+    return result;
+}
+
+Stmt specialize_dense_strides(const Stmt &s, const std::vector<Function> &outputs) {
+    FindBufferParameters finder;
+    s.accept(&finder);
+
+    std::set<string> output_names;
+    for (const Function &f : outputs) {
+        for (const Parameter &p : f.output_buffers()) {
+            output_names.insert(p.name());
+        }
+    }
+
+    // One specialized copy guarded by the conjunction of all the
+    // stride tests, rather than one per input: the case worth a fast
+    // path is every input being dense, and a single copy keeps code
+    // size linear in the number of inputs.
+    Expr condition;
+    map<string, Expr> replacements;
+    for (const auto &p : finder.params) {
+        const Parameter &param = p.second;
+        if (param.dimensions() < 1 ||
+            output_names.count(param.name()) ||
+            param.stride_constraint(0).defined()) {
+            continue;
+        }
+        string var_name = param.name() + ".stride.0";
+        Expr stride = Variable::make(Int(32), var_name, param);
+        Expr test = (stride == 1);
+        condition = condition.defined() ? (condition && test) : test;
+        replacements[var_name] = make_one(Int(32));
+    }
+    if (!condition.defined()) {
+        return s;
+    }
+
+    Stmt dense = simplify(substitute(replacements, s), false);
+    return IfThenElse::make(condition, dense, s);
+}
+
+}  // namespace Internal
+}  // namespace Halide
@@ -0,0 +1,43 @@
+#ifndef HALIDE_SPECIALIZE_HOT_EXTENTS_H
+#define HALIDE_SPECIALIZE_HOT_EXTENTS_H
+
+/** \file
+ * Defines lowering passes that multiversion the pipeline body on
+ * properties of its buffer parameters: the hot extents declared on
+ * buffer dimensions, and dense input strides.
+ */
+
+#include <vector>
+
+#include "Expr.h"
+
+namespace Halide {
+namespace Internal {
+
+class Function;
+
+/** For each buffer parameter dimension with declared hot extents
+ * (see Dimension::set_hot_extents), emit a copy of the pipeline body
+ * specialized for each hot extent, in which the extent is a
+ * compile-time constant, plus the original body as a generic
+ * fallback, dispatched on the actual extent at entry. Dimensions
+ * with no hot extents declared are left alone. */
+Stmt specialize_hot_extents(const Stmt &s);
+
+/** Emit a copy of the pipeline body specialized for every input
+ * buffer having a dense (stride one) innermost dimension, plus the
+ * original body as a generic fallback, dispatched on the actual
+ * strides at entry. In the specialized copy the innermost strides are
+ * the constant one, so loads of the inputs vectorize as dense loads
+ * rather than gathers, without constraining the parameters the way
+ * dim(0).set_stride(1) does: interleaved or cropped inputs still work
+ * via the fallback. Inputs whose innermost stride is already
+ * constrained are left alone. Runs after storage flattening, which is
+ * what introduces the stride variables, and is enabled by the
+ * specialize_strides target feature. */
+Stmt specialize_dense_strides(const Stmt &s, const std::vector<Function> &outputs);
+
+}  // namespace Internal
+}  // namespace Halide
+
+#endif
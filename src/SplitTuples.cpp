@@ -137,27 +137,10 @@ class SplitTuples : public IRMutator {
         }
     }
 
-    Stmt visit_provide(const Provide *op, const Atomic *atomic) {
-
-        if (op->values.size() == 1) {
-            if (atomic) {
-                return IRMutator::visit(atomic);
-            } else {
-                return IRMutator::visit(op);
-            }
-        }
-
-        // Mutate the args
-        vector<Expr> args;
-        for (const Expr &e : op->args) {
-            args.push_back(mutate(e));
-        }
-
-        // Get the Function
-        auto it = env.find(op->name);
-        internal_assert(it != env.end());
-        Function f = it->second;
-
+    // For each tuple component of a Provide, decide which other
+    // components its loads or stores may alias, and group components
+    // that may alias into clusters.
+    vector<vector<int>> compute_aliasing_clusters(const Provide *op, const vector<Expr> &args) {
         // For the new value of each tuple component, what existing
         // tuple components does it already depend on?
         vector<set<int>> dependencies(op->values.size());
@@ -210,9 +193,6 @@ class SplitTuples : public IRMutator {
             op->values[i].accept(&checker);
         }
 
-        // Build clusters of tuple components where two components
-        // belong to the same cluster if any of their loads or stores
-        // may alias
         vector<vector<int>> clusters;
         // Reserve space so that we can use pointers to clusters.
         clusters.reserve(op->values.size());
@@ -245,6 +225,50 @@ class SplitTuples : public IRMutator {
                 clusters.back().push_back(i);
             }
         }
+        return clusters;
+    }
+
+    Stmt visit_provide(const Provide *op, const Atomic *atomic) {
+
+        if (op->values.size() == 1) {
+            if (atomic) {
+                return IRMutator::visit(atomic);
+            } else {
+                return IRMutator::visit(op);
+            }
+        }
+
+        // Mutate the args
+        vector<Expr> args;
+        for (const Expr &e : op->args) {
+            args.push_back(mutate(e));
+        }
+
+        // Get the Function
+        auto it = env.find(op->name);
+        internal_assert(it != env.end());
+        Function f = it->second;
+
+        // Build clusters of tuple components where two components
+        // belong to the same cluster if any of their loads or stores
+        // may alias. Components in a cluster have their values
+        // computed into scalars before any of them are stored.
+        vector<vector<int>> clusters;
+        // Reserve space so that we can use pointers to clusters.
+        clusters.reserve(op->values.size());
+
+        if (f.schedule().fuse_tuple_stores()) {
+            // The schedule asks for every component to be computed
+            // before any is stored, so that shared work is done once
+            // per iteration. Put everything in one cluster and skip
+            // the aliasing analysis.
+            clusters.emplace_back();
+            for (int i = 0; i < (int)op->values.size(); i++) {
+                clusters.back().push_back(i);
+            }
+        } else {
+            clusters = compute_aliasing_clusters(op, args);
+        }
 
         // If each cluster has only a single store in it, we can use
         // CAS loops or atomic adds and avoid ever needing to wrap
@@ -4,10 +4,12 @@
 #include "Module.h"
 #include "Scope.h"
 
+#include <cmath>
 #include <cstdio>
 #include <fstream>
 #include <iostream>
 #include <iterator>
+#include <map>
 #include <sstream>
 
 namespace Halide {
@@ -23,6 +25,129 @@ std::string to_string(T value) {
     return os.str();
 }
 
+// A rough static cost model used to annotate the loop structure. Each
+// leaf operation (load, store, call, arithmetic) costs one unit, and
+// a loop multiplies the cost of its body by its trip count, or by a
+// nominal guess when the extent isn't a compile-time constant. The
+// absolute numbers mean nothing; the relative magnitudes are what
+// make the hot loop nests stand out when triaging a large Stmt.
+class CostEstimator : public IRVisitor {
+public:
+    // Estimated cost of each loop, including everything it contains.
+    std::map<const For *, double> loop_costs;
+
+    // Constant trip counts. Loops with non-constant extents are absent.
+    std::map<const For *, int64_t> trip_counts;
+
+    double estimate(const Stmt &s) {
+        ops = 0;
+        s.accept(this);
+        return std::max(ops, 1.0);
+    }
+
+private:
+    double ops = 0;
+
+    // Trip count to assume for loops whose extent is unknown at
+    // compile time.
+    static constexpr double assumed_trip_count = 64;
+
+    using IRVisitor::visit;
+
+    void visit(const For *op) override {
+        double before = ops;
+        IRVisitor::visit(op);
+        double body = ops - before;
+        double trip = assumed_trip_count;
+        if (const int64_t *extent = as_const_int(op->extent)) {
+            trip_counts[op] = *extent;
+            trip = (double)std::max<int64_t>(*extent, 1);
+        }
+        double cost = body * trip + 1;
+        loop_costs[op] = cost;
+        ops = before + cost;
+    }
+
+    template<typename T>
+    void count(const T *op) {
+        ops += 1;
+        IRVisitor::visit(op);
+    }
+
+    void visit(const Cast *op) override {
+        count(op);
+    }
+    void visit(const Add *op) override {
+        count(op);
+    }
+    void visit(const Sub *op) override {
+        count(op);
+    }
+    void visit(const Mul *op) override {
+        count(op);
+    }
+    void visit(const Div *op) override {
+        count(op);
+    }
+    void visit(const Mod *op) override {
+        count(op);
+    }
+    void visit(const Min *op) override {
+        count(op);
+    }
+    void visit(const Max *op) override {
+        count(op);
+    }
+    void visit(const EQ *op) override {
+        count(op);
+    }
+    void visit(const NE *op) override {
+        count(op);
+    }
+    void visit(const LT *op) override {
+        count(op);
+    }
+    void visit(const LE *op) override {
+        count(op);
+    }
+    void visit(const GT *op) override {
+        count(op);
+    }
+    void visit(const GE *op) override {
+        count(op);
+    }
+    void visit(const And *op) override {
+        count(op);
+    }
+    void visit(const Or *op) override {
+        count(op);
+    }
+    void visit(const Not *op) override {
+        count(op);
+    }
+    void visit(const Select *op) override {
+        count(op);
+    }
+    void visit(const Load *op) override {
+        count(op);
+    }
+    void visit(const Store *op) override {
+        count(op);
+    }
+    void visit(const Call *op) override {
+        count(op);
+    }
+    void visit(const Provide *op) override {
+        count(op);
+    }
+    void visit(const Shuffle *op) override {
+        count(op);
+    }
+    void visit(const VectorReduce *op) override {
+        count(op);
+    }
+};
+
 class StmtToHtml : public IRVisitor {
 
     static const std::string css, js;
@@ -105,6 +230,21 @@ private:
         return span("Symbol", x);
     }
 
+    CostEstimator costs;
+    double total_cost = 1;
+
+    // Bucket a loop's estimated cost into one of six heat levels,
+    // log-scaled from roughly 0.1% to 100% of the cost of the
+    // enclosing function.
+    int heat_bucket(double cost) const {
+        double fraction = cost / total_cost;
+        if (fraction <= 0.001) {
+            return 0;
+        }
+        int b = (int)(6 + std::log10(fraction) * 2);
+        return std::min(std::max(b, 0), 5);
+    }
+
     Scope<int> scope;
     string var(const string &x) {
         int id;
@@ -384,9 +524,46 @@ private:
         scope.pop(op->name);
     }
 
+    // The badge and cost annotation rendered after a loop header:
+    // vectorization/unroll width where it is known, the trip count,
+    // and this loop nest's share of the enclosing function's
+    // estimated cost.
+    string loop_annotation(const For *op) {
+        std::stringstream s;
+        auto trip = costs.trip_counts.find(op);
+        if (trip != costs.trip_counts.end()) {
+            if (op->for_type == ForType::Vectorized) {
+                s << span("Badge", to_string(trip->second) + " lanes");
+            } else if (op->for_type == ForType::Unrolled) {
+                s << span("Badge", "unroll &times;" + to_string(trip->second));
+            }
+        }
+        std::stringstream note;
+        note << "// trip count ";
+        if (trip != costs.trip_counts.end()) {
+            note << trip->second;
+        } else {
+            note << "?";
+        }
+        auto cost = costs.loop_costs.find(op);
+        if (cost != costs.loop_costs.end()) {
+            char pct[32];
+            snprintf(pct, sizeof(pct), "%.1f", 100 * cost->second / total_cost);
+            note << ", ~" << pct << "% of function";
+        }
+        s << span("LoopCost", note.str());
+        return s.str();
+    }
+
     void visit(const For *op) override {
         scope.push(op->name, unique_id());
-        stream << open_div("For");
+        auto cost = costs.loop_costs.find(op);
+        int heat = cost != costs.loop_costs.end() ? heat_bucket(cost->second) : 0;
+        if (heat > 0) {
+            stream << open_div("For Heat" + to_string(heat));
+        } else {
+            stream << open_div("For");
+        }
 
         int id = unique_id();
         stream << open_expand_button(id);
@@ -414,6 +591,7 @@ private:
         stream << matched(")");
         stream << close_expand_button();
         stream << " " << matched("{");
+        stream << loop_annotation(op);
         stream << open_div("ForBody Indent", id);
         print(op->body);
         stream << close_div();
@@ -734,8 +912,13 @@ public:
         ir.accept(this);
     }
 
+    void analyze(const Stmt &s) {
+        total_cost = costs.estimate(s);
+    }
+
     void print(const LoweredFunc &op) {
         scope.push(op.name, unique_id());
+        analyze(op.body);
         stream << open_div("Function");
 
         int id = unique_id();
@@ -838,6 +1021,13 @@ span.Type { color: #445588; font-weight: bold; }\n \
 span.StringImm { color: #d14; }\n \
 span.IntImm { color: #099; }\n \
 span.FloatImm { color: #099; }\n \
+span.Badge { background: #445588; color: #fff; border-radius: 3px; padding: 0px 4px; font-size: 10px; margin-left: 4px; }\n \
+span.LoopCost { color: #998; font-style: italic; margin-left: 4px; }\n \
+div.Heat1 { background: rgba(255,64,0,0.04); }\n \
+div.Heat2 { background: rgba(255,64,0,0.08); }\n \
+div.Heat3 { background: rgba(255,64,0,0.14); }\n \
+div.Heat4 { background: rgba(255,64,0,0.22); }\n \
+div.Heat5 { background: rgba(255,64,0,0.32); }\n \
 b.Highlight { font-weight: bold; background-color: #DDD; }\n \
 span.Highlight { font-weight: bold; background-color: #FF0; }\n \
 ";
@@ -862,6 +1052,7 @@ function toggle(id) { \n \
 
 void print_to_html(const string &filename, const Stmt &s) {
     StmtToHtml sth(filename);
+    sth.analyze(s);
     sth.print(s);
 }
 
@@ -0,0 +1,303 @@
+#include "StorageAliasing.h"
+#include "ExprUsesVar.h"
+#include "IRMutator.h"
+#include "IROperator.h"
+#include "IRVisitor.h"
+#include "Scope.h"
+#include "Simplify.h"
+
+#include <map>
+#include <set>
+
+namespace Halide {
+namespace Internal {
+
+using std::map;
+using std::set;
+using std::string;
+using std::vector;
+
+namespace {
+
+struct AllocInfo {
+    const Allocate *node = nullptr;
+    // Positions in a lexical ordering of the IR.
+    int alloc_pos = -1, body_end = -1;
+    int first_use = -1, last_use = -1;
+    // Ids of the loops/forks enclosing the Allocate node, and those
+    // enclosing any use of the buffer.
+    vector<int> alloc_loops;
+    set<int> use_loops;
+    // Names of lets and loop variables in scope at the Allocate node.
+    vector<string> bound_vars;
+    bool mergeable = true;
+};
+
+class CollectAllocations : public IRVisitor {
+    using IRVisitor::visit;
+
+    int clock = 0;
+    vector<int> loop_stack;
+    vector<string> var_stack;
+
+    void record_use(const string &name) {
+        auto it = index.find(name);
+        if (it == index.end()) {
+            return;
+        }
+        AllocInfo &info = allocs[it->second];
+        int pos = clock++;
+        if (info.first_use < 0) {
+            info.first_use = pos;
+        }
+        info.last_use = pos;
+        info.use_loops.insert(loop_stack.begin(), loop_stack.end());
+    }
+
+    void visit(const Allocate *op) override {
+        AllocInfo info;
+        info.node = op;
+        info.alloc_pos = clock++;
+        info.alloc_loops = loop_stack;
+        info.bound_vars = var_stack;
+        info.mergeable = (is_const_one(op->condition) &&
+                          !op->new_expr.defined() &&
+                          op->free_function.empty() &&
+                          (op->memory_type == MemoryType::Auto ||
+                           op->memory_type == MemoryType::Heap ||
+                           op->memory_type == MemoryType::Stack));
+        int idx = (int)allocs.size();
+        index[op->name] = idx;
+        allocs.push_back(info);
+        IRVisitor::visit(op);
+        allocs[idx].body_end = clock++;
+    }
+
+    void visit(const For *op) override {
+        op->min.accept(this);
+        op->extent.accept(this);
+        loop_stack.push_back(clock++);
+        var_stack.push_back(op->name);
+        op->body.accept(this);
+        var_stack.pop_back();
+        loop_stack.pop_back();
+    }
+
+    void visit(const Fork *op) override {
+        // Anything under a fork may run concurrently, so treat it
+        // like a loop for the overlap check.
+        loop_stack.push_back(clock++);
+        IRVisitor::visit(op);
+        loop_stack.pop_back();
+    }
+
+    void visit(const LetStmt *op) override {
+        op->value.accept(this);
+        var_stack.push_back(op->name);
+        op->body.accept(this);
+        var_stack.pop_back();
+    }
+
+    void visit(const Load *op) override {
+        record_use(op->name);
+        IRVisitor::visit(op);
+    }
+
+    void visit(const Store *op) override {
+        record_use(op->name);
+        IRVisitor::visit(op);
+    }
+
+    void visit(const Free *op) override {
+        record_use(op->name);
+    }
+
+    void visit(const Variable *op) override {
+        // The buffer escapes (e.g. it's passed to an extern stage);
+        // don't touch it.
+        auto it = index.find(op->name);
+        if (it != index.end()) {
+            allocs[it->second].mergeable = false;
+        }
+    }
+
+public:
+    map<string, int> index;
+    vector<AllocInfo> allocs;
+};
+
+Expr flat_size(const Allocate *op) {
+    Expr size = make_const(Int(32), 1);
+    for (const Expr &e : op->extents) {
+        size *= e;
+    }
+    return size;
+}
+
+class MergeAllocations : public IRMutator {
+    using IRMutator::visit;
+
+    const map<string, Expr> &resize;    // group root -> shared flat extent
+    const map<string, string> &rename;  // member -> group root
+    const set<string> &drop_free;
+
+    Stmt visit(const Allocate *op) override {
+        if (rename.count(op->name)) {
+            return mutate(op->body);
+        }
+        auto it = resize.find(op->name);
+        if (it != resize.end()) {
+            return Allocate::make(op->name, op->type, op->memory_type,
+                                  {it->second}, op->condition, mutate(op->body));
+        }
+        return IRMutator::visit(op);
+    }
+
+    Stmt visit(const Free *op) override {
+        if (drop_free.count(op->name)) {
+            return Evaluate::make(0);
+        }
+        auto it = rename.find(op->name);
+        if (it != rename.end()) {
+            return Free::make(it->second);
+        }
+        return op;
+    }
+
+    Expr visit(const Load *op) override {
+        auto it = rename.find(op->name);
+        if (it != rename.end()) {
+            return Load::make(op->type, it->second, mutate(op->index),
+                              op->image, op->param, mutate(op->predicate), op->alignment);
+        }
+        return IRMutator::visit(op);
+    }
+
+    Stmt visit(const Store *op) override {
+        auto it = rename.find(op->name);
+        if (it != rename.end()) {
+            return Store::make(it->second, mutate(op->value), mutate(op->index),
+                               op->param, mutate(op->predicate), op->alignment);
+        }
+        return IRMutator::visit(op);
+    }
+
+public:
+    MergeAllocations(const map<string, Expr> &resize,
+                     const map<string, string> &rename,
+                     const set<string> &drop_free)
+        : resize(resize), rename(rename), drop_free(drop_free) {
+    }
+};
+
+}  // namespace
+
+Stmt storage_aliasing(const Stmt &s) {
+    CollectAllocations collector;
+    s.accept(&collector);
+
+    map<string, Expr> resize;
+    map<string, string> rename;
+    set<string> drop_free;
+
+    vector<bool> grouped(collector.allocs.size(), false);
+    for (size_t i = 0; i < collector.allocs.size(); i++) {
+        const AllocInfo &root = collector.allocs[i];
+        if (grouped[i] || !root.mergeable) {
+            continue;
+        }
+        set<int> root_loops(root.alloc_loops.begin(), root.alloc_loops.end());
+
+        vector<size_t> members = {i};
+        int group_last_use = root.last_use;
+        set<int> group_use_loops = root.use_loops;
+
+        for (size_t j = i + 1; j < collector.allocs.size(); j++) {
+            const AllocInfo &b = collector.allocs[j];
+            if (grouped[j] ||
+                !b.mergeable ||
+                b.node->type != root.node->type ||
+                b.node->memory_type != root.node->memory_type ||
+                // Must be nested inside the root's scope, so the
+                // shared allocation covers its uses.
+                !(b.alloc_pos > root.alloc_pos && b.body_end < root.body_end) ||
+                // At the same loop level, so the lifetimes recur in
+                // lockstep.
+                b.alloc_loops != root.alloc_loops ||
+                // Live range must start after every existing member's
+                // has ended.
+                (b.first_use >= 0 && b.first_use <= group_last_use)) {
+                continue;
+            }
+
+            // A loop that encloses uses of both would interleave the
+            // lifetimes across iterations, unless it also encloses
+            // both Allocate nodes.
+            bool overlapping = false;
+            for (int l : b.use_loops) {
+                if (group_use_loops.count(l) && !root_loops.count(l)) {
+                    overlapping = true;
+                    break;
+                }
+            }
+            if (overlapping) {
+                continue;
+            }
+
+            // The member's size must be computable at the root's
+            // position.
+            Scope<> inner_vars;
+            for (size_t k = root.bound_vars.size(); k < b.bound_vars.size(); k++) {
+                inner_vars.push(b.bound_vars[k]);
+            }
+            if (expr_uses_vars(flat_size(b.node), inner_vars)) {
+                continue;
+            }
+
+            grouped[j] = true;
+            members.push_back(j);
+            group_last_use = std::max(group_last_use, b.last_use);
+            group_use_loops.insert(b.use_loops.begin(), b.use_loops.end());
+        }
+
+        if (members.size() == 1) {
+            continue;
+        }
+        grouped[i] = true;
+
+        // Size the shared allocation for the largest member.
+        Expr size = flat_size(root.node);
+        for (size_t k = 1; k < members.size(); k++) {
+            size = max(size, flat_size(collector.allocs[members[k]].node));
+        }
+        resize[root.node->name] = simplify(size);
+
+        // The last member to die keeps its early free (retargeted at
+        // the shared allocation); the others' frees must go, since
+        // later members still need the storage.
+        size_t last = members[0];
+        for (size_t m : members) {
+            if (collector.allocs[m].last_use > collector.allocs[last].last_use) {
+                last = m;
+            }
+        }
+        for (size_t m : members) {
+            const string &name = collector.allocs[m].node->name;
+            if (m != members[0]) {
+                rename[name] = root.node->name;
+            }
+            if (m != last) {
+                drop_free.insert(name);
+            }
+        }
+    }
+
+    if (resize.empty()) {
+        return s;
+    }
+
+    return MergeAllocations(resize, rename, drop_free).mutate(s);
+}
+
+}  // namespace Internal
+}  // namespace Halide
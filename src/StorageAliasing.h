@@ -0,0 +1,27 @@
+#ifndef HALIDE_STORAGE_ALIASING_H
+#define HALIDE_STORAGE_ALIASING_H
+
+/** \file
+ * Defines the lowering pass that makes allocations with disjoint live
+ * ranges share storage.
+ */
+
+#include "Expr.h"
+
+namespace Halide {
+namespace Internal {
+
+/** Find groups of allocations of the same type whose live ranges
+ * don't overlap -- e.g. the levels of a pyramid, where each level is
+ * dead once the next one has been computed -- and rewrite them to
+ * share a single allocation sized for the largest member. This runs
+ * after the early frees have been injected, which is what ends a live
+ * range before the enclosing Allocate node closes. Lifetimes are
+ * compared lexically, so uses under a common loop or fork that does
+ * not also contain both Allocate nodes are treated as overlapping. */
+Stmt storage_aliasing(const Stmt &s);
+
+}  // namespace Internal
+}  // namespace Halide
+
+#endif
@@ -49,6 +49,47 @@ private:
         return Variable::make(Int(32), name, buf, param, rdom);
     }
 
+    /** Describes a Func stored in AoSoA form (Func::store_interleaved):
+     * the innermost storage dimension is tiled by `lanes`, and within
+     * each tile the interleaved dimension varies. */
+    struct InterleaveInfo {
+        int tile_dim = -1;   // arg index of the innermost (tiled) storage dim
+        int outer_dim = -1;  // arg index of the interleaved storage dim
+        Expr lanes;
+    };
+
+    InterleaveInfo interleave_info(const string &name) const {
+        InterleaveInfo info;
+        auto iter = env.find(name);
+        if (iter == env.end()) {
+            return info;
+        }
+        const Function &f = iter->second.first;
+        const vector<StorageDim> &storage_dims = f.schedule().storage_dims();
+        const vector<string> &args = f.args();
+        for (size_t i = 0; i < storage_dims.size(); i++) {
+            if (!storage_dims[i].interleave_lanes.defined()) {
+                continue;
+            }
+            user_assert(i == 1)
+                << "In schedule for " << f.name()
+                << ", the interleaved storage dimension " << storage_dims[i].var
+                << " is no longer the second-innermost storage dimension. "
+                << "Apply store_interleaved after any reorder_storage calls.\n";
+            info.lanes = storage_dims[i].interleave_lanes;
+            for (size_t j = 0; j < args.size(); j++) {
+                if (args[j] == storage_dims[0].var) {
+                    info.tile_dim = (int)j;
+                }
+                if (args[j] == storage_dims[i].var) {
+                    info.outer_dim = (int)j;
+                }
+            }
+            internal_assert(info.tile_dim >= 0 && info.outer_dim >= 0);
+        }
+        return info;
+    }
+
     Expr flatten_args(const string &name, vector<Expr> args,
                       const Buffer<> &buf, const Parameter &param) {
         bool internal = realizations.contains(name);
@@ -65,10 +106,22 @@ private:
 
         Expr zero = target.has_large_buffers() ? make_zero(Int(64)) : 0;
 
+        InterleaveInfo ileave = interleave_info(name);
+        user_assert(internal || !ileave.lanes.defined())
+            << "Cannot apply store_interleaved to the pipeline output " << name
+            << ", since the layout is not expressible with the strides in a "
+            << "halide_buffer_t.\n";
+
         // We peel off constant offsets so that multiple stencil
-        // taps can share the same base address.
+        // taps can share the same base address. The interleaved
+        // dimensions of an AoSoA layout don't have a single stride,
+        // so leave those alone.
         Expr constant_term = zero;
         for (size_t i = 0; i < args.size(); i++) {
+            if (ileave.lanes.defined() &&
+                ((int)i == ileave.tile_dim || (int)i == ileave.outer_dim)) {
+                continue;
+            }
             const Add *add = args[i].as<Add>();
             if (add && is_const(add->b)) {
                 constant_term += strides[i] * add->b;
@@ -76,7 +129,28 @@ private:
             }
         }
 
-        if (internal) {
+        if (internal && ileave.lanes.defined()) {
+            // An AoSoA layout. The innermost storage dimension is
+            // tiled by the interleave width; within a tile the
+            // interleaved dimension has stride equal to the width,
+            // and tiles are interleave_stride elements apart (bound
+            // by the Realize below).
+            Expr lanes = ileave.lanes;
+            Expr tile_stride = Variable::make(Int(32), name + ".interleave_stride");
+            if (target.has_large_buffers()) {
+                tile_stride = cast<int64_t>(tile_stride);
+            }
+            for (size_t i = 0; i < args.size(); i++) {
+                Expr coord = args[i] - mins[i];
+                if ((int)i == ileave.tile_dim) {
+                    idx += (coord % lanes) * strides[i] + (coord / lanes) * tile_stride;
+                } else if ((int)i == ileave.outer_dim) {
+                    idx += coord * lanes * strides[ileave.tile_dim];
+                } else {
+                    idx += coord * strides[i];
+                }
+            }
+        } else if (internal) {
             // f(x, y) -> f[(x-xmin)*xstride + (y-ymin)*ystride] This
             // strategy makes sense when we expect x to cancel with
             // something in xmin.  We use this for internal allocations.
@@ -156,6 +230,34 @@ private:
 
         internal_assert(storage_permutation.size() == op->bounds.size());
 
+        InterleaveInfo ileave = interleave_info(op->name);
+        if (ileave.lanes.defined()) {
+            // Pad the tiled dimension up to a whole number of tiles.
+            Expr lanes = ileave.lanes;
+            allocation_extents[ileave.tile_dim] =
+                ((allocation_extents[ileave.tile_dim] + lanes - 1) / lanes) * lanes;
+        }
+
+        // GPU shared memory is striped across banks (32 banks of four
+        // bytes each on current hardware). If the innermost storage
+        // dimension of a shared allocation spans a multiple of the
+        // bank stride, walking the allocation along any outer
+        // dimension (e.g. reading the staged tile transposed) hits
+        // the same bank on every step and the accesses serialize. Pad
+        // the innermost dimension by one element in that case so that
+        // successive rows start in different banks. The padding only
+        // changes the strides of the allocation, never the region
+        // computed, so it is invisible to the rest of lowering.
+        if (op->memory_type == MemoryType::GPUShared && op->bounds.size() > 1 &&
+            !ileave.lanes.defined()) {
+            int innermost = storage_permutation[0];
+            int bank_stride_elems = (32 * 4) / op->types[0].bytes();
+            const int64_t *e = as_const_int(allocation_extents[innermost]);
+            if (bank_stride_elems > 0 && e && *e > 0 && (*e % bank_stride_elems) == 0) {
+                allocation_extents[innermost] += 1;
+            }
+        }
+
         Stmt stmt = body;
         internal_assert(op->types.size() == 1);
 
@@ -190,6 +292,14 @@ private:
         // Make the allocation node
         stmt = Allocate::make(op->name, op->types[0], op->memory_type, allocation_extents, condition, stmt);
 
+        // The distance between consecutive tiles of an AoSoA layout:
+        // one tile's worth of every entry of the interleaved
+        // dimension. Flattened indices computed above refer to this.
+        if (ileave.lanes.defined()) {
+            stmt = LetStmt::make(op->name + ".interleave_stride",
+                                 ileave.lanes * allocation_extents[ileave.outer_dim], stmt);
+        }
+
         // Compute the strides
         for (int i = (int)op->bounds.size() - 1; i > 0; i--) {
             int prev_j = storage_permutation[i - 1];
@@ -331,7 +441,23 @@ private:
 
         Expr base_offset = mutate(flatten_args(op->name, prefetch_min, Buffer<>(), op->prefetch.param));
         Expr base_address = Variable::make(Handle(), op->name);
-        vector<Expr> args = {base_address, base_offset};
+        // rw and locality match the encoding of the llvm prefetch
+        // intrinsic: rw 0 = read, 1 = write; locality 0 = NTA,
+        // 2 = L2, 3 = all levels.
+        Expr rw = op->prefetch.for_write ? 1 : 0;
+        Expr locality;
+        switch (op->prefetch.locality) {
+        case PrefetchLocality::NTA:
+            locality = 0;
+            break;
+        case PrefetchLocality::L2:
+            locality = 2;
+            break;
+        case PrefetchLocality::L1:
+            locality = 3;
+            break;
+        }
+        vector<Expr> args = {base_address, base_offset, rw, locality};
 
         auto iter = env.find(op->name);
         if (iter != env.end()) {
@@ -60,6 +60,26 @@ class FoldStorageOfFunction : public IRMutator {
     Expr factor;
     string dynamic_footprint;
 
+    // When rotating, the folded index is computed line-buffer style as
+    // (idx - base) + pos, wrapped with a single conditional subtract,
+    // where base is the min of the region accessed in the current loop
+    // iteration and pos = base % factor is maintained once per
+    // iteration. This is exactly idx % factor (so the memory layout is
+    // unchanged), but without a div/mod on every access, which makes
+    // non-power-of-two fold factors as cheap as power-of-two ones.
+    bool rotate = false;
+    string rotation_base_name, rotation_pos_name;
+
+    Expr fold_index(const Expr &idx) {
+        if (!rotate) {
+            return idx % factor;
+        }
+        Expr base = Variable::make(Int(32), rotation_base_name);
+        Expr pos = Variable::make(Int(32), rotation_pos_name);
+        Expr wrapped = idx - base + pos;
+        return select(wrapped < factor, wrapped, wrapped - factor);
+    }
+
     using IRMutator::visit;
 
     Expr visit(const Call *op) override {
@@ -69,7 +89,7 @@ class FoldStorageOfFunction : public IRMutator {
         if (op->name == func && op->call_type == Call::Halide) {
             vector<Expr> args = op->args;
             internal_assert(dim < (int)args.size());
-            args[dim] = is_const_one(factor) ? 0 : (args[dim] % factor);
+            args[dim] = is_const_one(factor) ? 0 : fold_index(args[dim]);
             expr = Call::make(op->type, op->name, args, op->call_type,
                               op->func, op->value_index, op->image, op->param);
         } else if (op->name == Call::buffer_crop) {
@@ -98,7 +118,10 @@ class FoldStorageOfFunction : public IRMutator {
                 Expr old_min = mins[dim];
                 Expr old_extent = extents[dim];
 
-                // Rewrite the crop args
+                // Rewrite the crop args. A crop happens once per
+                // extern call, so a modulo is fine here even when the
+                // per-pixel accesses use rotation; the layout is the
+                // same either way.
                 mins[dim] = old_min % factor;
                 Expr new_mins = Call::make(type_of<int *>(), Call::make_struct, mins, Call::Intrinsic);
                 vector<Expr> new_args = op->args;
@@ -143,7 +166,7 @@ class FoldStorageOfFunction : public IRMutator {
         internal_assert(op);
         if (op->name == func) {
             vector<Expr> args = op->args;
-            args[dim] = is_const_one(factor) ? 0 : (args[dim] % factor);
+            args[dim] = is_const_one(factor) ? 0 : fold_index(args[dim]);
             stmt = Provide::make(op->name, op->values, args);
         }
         return stmt;
@@ -153,6 +176,21 @@ public:
     FoldStorageOfFunction(string f, int d, Expr e, string p)
         : func(std::move(f)), dim(d), factor(std::move(e)), dynamic_footprint(std::move(p)) {
     }
+
+    // Mutate with rotating (line-buffer) addressing instead of modulo,
+    // given the min of the region of the folded dimension accessed per
+    // iteration of the enclosing loop. Wraps the result in the lets
+    // that maintain the rotation.
+    Stmt mutate_with_rotation(const Stmt &s, const Expr &fold_min) {
+        rotate = true;
+        rotation_base_name = func + ".fold_base" + unique_name('_');
+        rotation_pos_name = func + ".fold_pos" + unique_name('_');
+        Stmt stmt = mutate(s);
+        Expr base = Variable::make(Int(32), rotation_base_name);
+        stmt = LetStmt::make(rotation_pos_name, base % factor, stmt);
+        stmt = LetStmt::make(rotation_base_name, fold_min, stmt);
+        return stmt;
+    }
 };
 
 // Inject dynamic folding checks against a tracked live range.
@@ -723,7 +761,17 @@ class AttemptStorageFoldingOfFunction : public IRMutator {
                 const int max_fold = 1024;
                 const int64_t *const_max_extent = as_const_int(max_extent);
                 if (const_max_extent && *const_max_extent <= max_fold) {
-                    factor = static_cast<int>(next_power_of_two(*const_max_extent));
+                    // Rounding up to a power of two only mattered when
+                    // the folded index was computed by modulo. When the
+                    // rotating addressing below applies, use the exact
+                    // extent instead of wasting storage on padding
+                    // (e.g. a 5-line vertical stencil gets 5 lines, not
+                    // 8).
+                    if (is_pure(min)) {
+                        factor = static_cast<int>(*const_max_extent);
+                    } else {
+                        factor = static_cast<int>(next_power_of_two(*const_max_extent));
+                    }
                 } else {
                     // Try a little harder to find a bounding power of two
                     int e = max_fold * 2;
@@ -742,6 +790,18 @@ class AttemptStorageFoldingOfFunction : public IRMutator {
                         continue;
                     }
                 }
+
+                if (func.schedule().async()) {
+                    // A fold factor that exactly covers the consumer's
+                    // footprint would serialize an async producer against
+                    // its consumer: the producer couldn't start on the
+                    // next fold until the consumer had released the
+                    // current one. Double it so the producer (e.g. a DMA
+                    // copy stage fetching the next tile) fills one half of
+                    // the circular buffer while the consumer reads the
+                    // other.
+                    factor = simplify(factor * 2);
+                }
             }
 
             internal_assert(factor.defined());
@@ -774,7 +834,22 @@ class AttemptStorageFoldingOfFunction : public IRMutator {
                 } else {
                     head = dynamic_footprint;
                 }
-                body = FoldStorageOfFunction(func.name(), (int)i - 1, factor, head).mutate(body);
+                FoldStorageOfFunction folder(func.name(), (int)i - 1, factor, head);
+                // Use rotating line-buffer addressing where it pays
+                // for itself: a constant non-power-of-two factor would
+                // otherwise cost a div/mod on every access. This needs
+                // the per-iteration min of the footprint, so it only
+                // applies when the fold position is statically tracked
+                // and the min can be re-evaluated in a let.
+                int bits;
+                if (dynamic_footprint.empty() &&
+                    is_pure(min) &&
+                    is_const(factor) &&
+                    !is_const_power_of_two_integer(factor, &bits)) {
+                    body = folder.mutate_with_rotation(body, min);
+                } else {
+                    body = folder.mutate(body);
+                }
             }
 
             // If the producer is async, it can run ahead by
@@ -943,8 +1018,13 @@ class StorageFolding : public IRMutator {
         Function func = func_it != env.end() ? func_it->second : Function();
 
         // Don't attempt automatic storage folding if there is
-        // more than one produce node for this func.
-        bool explicit_only = count_producers(body, op->name) != 1;
+        // more than one produce node for this func, or if it is
+        // ring-buffered. Automatic folding of an async producer
+        // limits how far it can run ahead to the fold factor, which
+        // would defeat the deeper run-ahead the ring buffer was
+        // scheduled to provide.
+        bool explicit_only = count_producers(body, op->name) != 1 ||
+                             (func_it != env.end() && func.schedule().ring_buffer().defined());
         AttemptStorageFoldingOfFunction folder(func, explicit_only);
         if (explicit_only) {
             debug(3) << "Attempting to fold " << op->name << " explicitly\n";
@@ -0,0 +1,221 @@
+#include "StrengthReduceDivMod.h"
+#include "ExprUsesVar.h"
+#include "IREquality.h"
+#include "IRMutator.h"
+#include "IROperator.h"
+#include "Scope.h"
+#include "Substitute.h"
+#include "Util.h"
+
+namespace Halide {
+namespace Internal {
+
+using std::string;
+using std::vector;
+
+namespace {
+
+// True if e doesn't depend on the loop variable or on anything bound
+// between the loop and the expression.
+bool is_invariant(const Expr &e, const string &var, const Scope<> &bound) {
+    return !expr_uses_var(e, var) && !expr_uses_vars(e, bound);
+}
+
+// True if e is the loop variable plus or minus loop-invariant terms,
+// i.e. it advances by exactly one each iteration.
+bool is_unit_linear(const Expr &e, const string &var, const Scope<> &bound) {
+    if (const Variable *v = e.as<Variable>()) {
+        return v->name == var;
+    } else if (const Add *add = e.as<Add>()) {
+        return (is_unit_linear(add->a, var, bound) && is_invariant(add->b, var, bound)) ||
+               (is_invariant(add->a, var, bound) && is_unit_linear(add->b, var, bound));
+    } else if (const Sub *sub = e.as<Sub>()) {
+        return is_unit_linear(sub->a, var, bound) && is_invariant(sub->b, var, bound);
+    } else {
+        return false;
+    }
+}
+
+class StrengthReduceDivMod : public IRMutator {
+    using IRMutator::visit;
+
+    bool in_gpu_loop = false;
+
+    // A numerator/denominator pair for which we're carrying the
+    // quotient and remainder in a two-element scratch allocation
+    // (remainder at index 0, quotient at index 1).
+    struct Recurrence {
+        Expr num, den;
+        string scratch;
+        bool uses_div = false;
+    };
+
+    static Expr scratch_load(const Recurrence &r, int idx) {
+        return Load::make(Int(32), r.scratch, idx,
+                          Buffer<>(), Parameter(), const_true(), ModulusRemainder());
+    }
+
+    static Stmt scratch_store(const Recurrence &r, int idx, const Expr &value) {
+        return Store::make(r.scratch, value, idx,
+                           Parameter(), const_true(), ModulusRemainder());
+    }
+
+    Stmt visit(const For *op) override {
+        bool gpu = op->device_api != DeviceAPI::None ||
+                   op->for_type == ForType::GPUBlock ||
+                   op->for_type == ForType::GPUThread ||
+                   op->for_type == ForType::GPULane;
+        ScopedValue<bool> old_in_gpu(in_gpu_loop, in_gpu_loop || gpu);
+
+        Stmt body = mutate(op->body);
+        if (op->for_type != ForType::Serial || in_gpu_loop) {
+            if (body.same_as(op->body)) {
+                return op;
+            } else {
+                return For::make(op->name, op->min, op->extent, op->for_type, op->device_api, body);
+            }
+        }
+
+        // Walk the chain of lets at the top of the loop body looking
+        // for values of the form (x / c + k) or (x % c + k), where x
+        // advances by one each iteration and c and k are
+        // loop-invariant. This is the index reconstruction that
+        // Func::fuse produces.
+        vector<const LetStmt *> lets;
+        vector<int> recurrence_idx;  // per let: index into recurrences, or -1
+        vector<bool> is_div;         // per let: quotient or remainder
+        vector<Expr> addend;         // per let: the invariant additive term, possibly undefined
+        vector<Recurrence> recurrences;
+        Scope<> bound;
+        Stmt inner = body;
+        while (const LetStmt *let = inner.as<LetStmt>()) {
+            Expr num, den, add;
+            bool div = false;
+            Expr v = let->value;
+            if (const Add *a = v.as<Add>()) {
+                if (a->a.as<Div>() || a->a.as<Mod>()) {
+                    v = a->a;
+                    add = a->b;
+                } else if (a->b.as<Div>() || a->b.as<Mod>()) {
+                    v = a->b;
+                    add = a->a;
+                }
+            }
+            if (const Div *d = v.as<Div>()) {
+                num = d->a;
+                den = d->b;
+                div = true;
+            } else if (const Mod *m = v.as<Mod>()) {
+                num = m->a;
+                den = m->b;
+            }
+
+            // Division by a constant power of two is already just a
+            // shift and a mask; leave those alone. Other denominators
+            // (including non-power-of-two constants, which lower to a
+            // multiply and shifts) are worth carrying.
+            bool den_ok = num.defined();
+            int bits;
+            if (den_ok && is_const_power_of_two_integer(den, &bits)) {
+                den_ok = false;
+            } else if (den_ok) {
+                if (const int64_t *c = as_const_int(den)) {
+                    den_ok = (*c > 1);
+                }
+            }
+
+            bool candidate =
+                (den_ok &&
+                 num.type() == Int(32) &&
+                 is_unit_linear(num, op->name, bound) &&
+                 is_invariant(den, op->name, bound) &&
+                 (!add.defined() || is_invariant(add, op->name, bound)));
+
+            int idx = -1;
+            if (candidate) {
+                for (int i = 0; i < (int)recurrences.size(); i++) {
+                    if (equal(recurrences[i].num, num) && equal(recurrences[i].den, den)) {
+                        idx = i;
+                        break;
+                    }
+                }
+                if (idx < 0) {
+                    idx = (int)recurrences.size();
+                    recurrences.push_back({num, den, unique_name('d'), false});
+                }
+                recurrences[idx].uses_div |= div;
+            }
+
+            lets.push_back(let);
+            recurrence_idx.push_back(idx);
+            is_div.push_back(div);
+            addend.push_back(add);
+            bound.push(let->name);
+            inner = let->body;
+        }
+
+        if (recurrences.empty()) {
+            if (body.same_as(op->body)) {
+                return op;
+            } else {
+                return For::make(op->name, op->min, op->extent, op->for_type, op->device_api, body);
+            }
+        }
+
+        // Rebuild the let chain with the carried counters standing in
+        // for the div/mod.
+        Stmt core = inner;
+        for (size_t i = lets.size(); i > 0; i--) {
+            const LetStmt *let = lets[i - 1];
+            int idx = recurrence_idx[i - 1];
+            if (idx < 0) {
+                core = LetStmt::make(let->name, let->value, core);
+            } else {
+                Expr value = scratch_load(recurrences[idx], is_div[i - 1] ? 1 : 0);
+                if (addend[i - 1].defined()) {
+                    value += addend[i - 1];
+                }
+                core = LetStmt::make(let->name, value, core);
+            }
+        }
+
+        // Step the counters at the end of each iteration: bump the
+        // remainder, and on wrap-around reset it and carry into the
+        // quotient.
+        vector<Stmt> stmts = {core};
+        for (const Recurrence &r : recurrences) {
+            string next_name = unique_name('t');
+            Expr next = Variable::make(Int(32), next_name);
+            Stmt step = scratch_store(r, 0, select(next >= r.den, 0, next));
+            if (r.uses_div) {
+                Stmt carry = scratch_store(r, 1, scratch_load(r, 1) + select(next == r.den, 1, 0));
+                step = Block::make(step, carry);
+            }
+            stmts.push_back(LetStmt::make(next_name, scratch_load(r, 0) + 1, step));
+        }
+
+        Stmt stmt = For::make(op->name, op->min, op->extent, op->for_type, op->device_api,
+                              Block::make(stmts));
+
+        // Initialize the counters for the first iteration.
+        for (const Recurrence &r : recurrences) {
+            Expr num0 = substitute(op->name, op->min, r.num);
+            if (r.uses_div) {
+                stmt = Block::make(scratch_store(r, 1, num0 / r.den), stmt);
+            }
+            stmt = Block::make(scratch_store(r, 0, num0 % r.den), stmt);
+            stmt = Allocate::make(r.scratch, Int(32), MemoryType::Stack, {2}, const_true(), stmt);
+        }
+
+        return stmt;
+    }
+};
+
+}  // namespace
+
+Stmt strength_reduce_div_mod(const Stmt &s) {
+    return StrengthReduceDivMod().mutate(s);
+}
+
+}  // namespace Internal
+}  // namespace Halide
@@ -0,0 +1,26 @@
+#ifndef HALIDE_STRENGTH_REDUCE_DIV_MOD_H
+#define HALIDE_STRENGTH_REDUCE_DIV_MOD_H
+
+/** \file
+ * Defines the lowering pass that rewrites div/mod recurrences on loop
+ * variables as counters carried across loop iterations.
+ */
+
+#include "Expr.h"
+
+namespace Halide {
+namespace Internal {
+
+/** Find serial loops that recover indices from the loop variable by
+ * dividing and taking the remainder by a loop-invariant value -- the
+ * pattern Func::fuse produces -- and replace the per-iteration div/mod
+ * with a pair of counters that are incremented (with wrap-around) as
+ * the loop advances, in the manner of an OpenMP collapsed loop. Loops
+ * that are parallel, vectorized, or on a device are left alone, as are
+ * divisions by constant powers of two, which are already cheap. */
+Stmt strength_reduce_div_mod(const Stmt &s);
+
+}  // namespace Internal
+}  // namespace Halide
+
+#endif
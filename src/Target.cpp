@@ -162,6 +162,7 @@ Target calculate_host_target() {
         if ((info2[1] & avx2) == avx2) {
             initial_features.push_back(Target::AVX2);
         }
+        const uint32_t avx512vnni = 1U << 11;  // vnni result in ecx
         if ((info2[1] & avx512) == avx512) {
             initial_features.push_back(Target::AVX512);
             if ((info2[1] & avx512_knl) == avx512_knl) {
@@ -169,14 +170,17 @@ Target calculate_host_target() {
             }
             if ((info2[1] & avx512_skylake) == avx512_skylake) {
                 initial_features.push_back(Target::AVX512_Skylake);
+                if ((info2[2] & avx512vnni) == avx512vnni) {
+                    // Cascade Lake and onwards
+                    initial_features.push_back(Target::AVX512_VNNI);
+                }
             }
             if ((info2[1] & avx512_cannonlake) == avx512_cannonlake) {
                 initial_features.push_back(Target::AVX512_Cannonlake);
 
 #if LLVM_VERSION >= 120
                 // Sapphire Rapids support was added in LLVM 12, so earlier versions cannot support this CPU's features.
-                const uint32_t avx512vnni = 1U << 11;  // vnni result in ecx
-                const uint32_t avx512bf16 = 1U << 5;   // bf16 result in eax, with cpuid(eax=7, ecx=1)
+                const uint32_t avx512bf16 = 1U << 5;  // bf16 result in eax, with cpuid(eax=7, ecx=1)
                 int info3[4];
                 cpuid(info3, 7, 1);
                 if ((info2[2] & avx512vnni) == avx512vnni &&
@@ -184,6 +188,14 @@ Target calculate_host_target() {
                     initial_features.push_back(Target::AVX512_SapphireRapids);
                 }
 #endif
+
+#if LLVM_VERSION >= 140
+                // AVX512-FP16 codegen support was added in LLVM 14.
+                const uint32_t avx512fp16 = 1U << 23;  // fp16 result in edx
+                if ((info2[3] & avx512fp16) == avx512fp16) {
+                    initial_features.push_back(Target::AVX512_FP16);
+                }
+#endif
             }
         }
     }
@@ -365,6 +377,8 @@ const std::map<std::string, Target::Feature> feature_name_map = {
     {"avx512_skylake", Target::AVX512_Skylake},
     {"avx512_cannonlake", Target::AVX512_Cannonlake},
     {"avx512_sapphirerapids", Target::AVX512_SapphireRapids},
+    {"avx512_vnni", Target::AVX512_VNNI},
+    {"avx512_fp16", Target::AVX512_FP16},
     {"trace_loads", Target::TraceLoads},
     {"trace_stores", Target::TraceStores},
     {"trace_realizations", Target::TraceRealizations},
@@ -386,8 +400,14 @@ const std::map<std::string, Target::Feature> feature_name_map = {
     {"sve", Target::SVE},
     {"sve2", Target::SVE2},
     {"arm_dot_prod", Target::ARMDotProd},
+    {"arm_bf16", Target::ARMBf16},
     {"llvm_large_code_model", Target::LLVMLargeCodeModel},
     {"rvv", Target::RVV},
+    {"async_root", Target::AsyncRoot},
+    {"arm_sme", Target::ARMSME},
+    {"strip_runtime", Target::StripRuntime},
+    {"telemetry", Target::Telemetry},
+    {"specialize_strides", Target::SpecializeStrides},
     // NOTE: When adding features to this map, be sure to update PyEnums.cpp as well.
 };
 
@@ -439,6 +459,44 @@ Target get_jit_target_from_environment() {
     }
 }
 
+std::vector<Target> get_x86_multitarget_tiers(const Target &base) {
+    user_assert(base.arch == Target::X86 && base.bits == 64)
+        << "get_x86_multitarget_tiers() requires an x86-64 base target; got "
+        << base.to_string() << "\n";
+    // Cumulative feature sets for each tier, from most to least
+    // capable. The wrapper emitted by compile_multitarget tries the
+    // targets in order and uses the first whose features the host
+    // supports, so ordering matters.
+    static const std::vector<std::vector<Target::Feature>> tiers = {
+        // Sapphire Rapids class: AVX-512 with the bf16/AMX codegen paths.
+        {Target::SSE41, Target::AVX, Target::F16C, Target::FMA, Target::AVX2,
+         Target::AVX512, Target::AVX512_Skylake, Target::AVX512_Cannonlake,
+         Target::AVX512_SapphireRapids},
+        // Skylake-X/Ice Lake class AVX-512.
+        {Target::SSE41, Target::AVX, Target::F16C, Target::FMA, Target::AVX2,
+         Target::AVX512, Target::AVX512_Skylake},
+        // Haswell and later.
+        {Target::SSE41, Target::AVX, Target::F16C, Target::FMA, Target::AVX2},
+        // Anything from the last decade or so.
+        {Target::SSE41},
+    };
+    std::vector<Target> result;
+    for (const auto &tier : tiers) {
+        Target t = base;
+        for (Target::Feature f : tier) {
+            t.set_feature(f);
+        }
+        // Skip tiers that the base target's own features make redundant.
+        if (t != base && (result.empty() || t != result.back())) {
+            result.push_back(t);
+        }
+    }
+    // The base target comes last: it doubles as the fallback variant and
+    // as the target the shared runtime is built with.
+    result.push_back(base);
+    return result;
+}
+
 namespace {
 bool merge_string(Target &t, const std::string &target) {
     string rest = target;
@@ -931,6 +989,17 @@ int Target::natural_vector_size(const Halide::Type &t) const {
             // SSE was all 128-bit. We ignore MMX.
             return 16 / data_size;
         }
+    } else if (arch == Target::ARM) {
+        if (bits == 64 && (has_feature(Halide::Target::SVE) ||
+                           has_feature(Halide::Target::SVE2))) {
+            // SVE vector lengths are implementation-defined; we
+            // generate fixed-length code for the 256-bit
+            // implementations (see CodeGen_ARM::native_vector_bits).
+            return 32 / data_size;
+        } else {
+            // 128-bit NEON vectors.
+            return 16 / data_size;
+        }
     } else if (arch == Target::WebAssembly) {
         if (has_feature(Halide::Target::WasmSimd128)) {
             if (t.bits() == 64) {
@@ -982,15 +1051,17 @@ bool Target::get_runtime_compatible_target(const Target &other, Target &result)
     // clang-format on
 
     // clang-format off
-    const std::array<Feature, 13> intersection_features = {{
+    const std::array<Feature, 15> intersection_features = {{
         ARMv7s,
         AVX,
         AVX2,
         AVX512,
         AVX512_Cannonlake,
+        AVX512_FP16,
         AVX512_KNL,
         AVX512_SapphireRapids,
         AVX512_Skylake,
+        AVX512_VNNI,
         F16C,
         FMA,
         FMA4,
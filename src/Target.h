@@ -8,6 +8,7 @@
 #include <bitset>
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include "DeviceAPI.h"
 #include "Type.h"
@@ -106,6 +107,9 @@ struct Target {
         AVX512_Skylake = halide_target_feature_avx512_skylake,
         AVX512_Cannonlake = halide_target_feature_avx512_cannonlake,
         AVX512_SapphireRapids = halide_target_feature_avx512_sapphirerapids,
+        AVX512_VNNI = halide_target_feature_avx512_vnni,
+        AVX512_FP16 = halide_target_feature_avx512_fp16,
+        ARMBf16 = halide_target_feature_arm_bf16,
         TraceLoads = halide_target_feature_trace_loads,
         TraceStores = halide_target_feature_trace_stores,
         TraceRealizations = halide_target_feature_trace_realizations,
@@ -128,6 +132,11 @@ struct Target {
         ARMDotProd = halide_target_feature_arm_dot_prod,
         LLVMLargeCodeModel = halide_llvm_large_code_model,
         RVV = halide_target_feature_rvv,
+        AsyncRoot = halide_target_feature_async_root,
+        ARMSME = halide_target_feature_arm_sme,
+        StripRuntime = halide_target_feature_strip_runtime,
+        Telemetry = halide_target_feature_telemetry,
+        SpecializeStrides = halide_target_feature_specialize_strides,
         FeatureEnd = halide_target_feature_end
     };
     Target() = default;
@@ -322,6 +331,18 @@ Target get_target_from_environment();
  * useful for controlling the feature set. */
 Target get_jit_target_from_environment();
 
+/** Given an x86-64 base target, return an ordered list of targets
+ * suitable for passing to compile_to_multitarget_static_library (or
+ * compile_multitarget), covering the instruction-set tiers found
+ * across a typical x86-64 fleet: Sapphire Rapids class AVX-512
+ * (including the bf16/AMX codegen paths), Skylake class AVX-512,
+ * AVX2, SSE 4.1, and finally the base target itself as the fallback.
+ * Tiers already implied by the base target's features are omitted.
+ * The wrapper generated for these targets resolves the best variant
+ * the first time the pipeline is called and caches the function
+ * pointer, so subsequent calls cost one predictable branch. */
+std::vector<Target> get_x86_multitarget_tiers(const Target &base);
+
 /** Get the Target feature corresponding to a DeviceAPI. For device
  * apis that do not correspond to any single target feature, returns
  * Target::FeatureEnd */
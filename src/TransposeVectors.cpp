@@ -0,0 +1,254 @@
+#include "TransposeVectors.h"
+#include "CSE.h"
+#include "IREquality.h"
+#include "IRMutator.h"
+#include "IROperator.h"
+#include "IRVisitor.h"
+#include "Simplify.h"
+#include "Substitute.h"
+
+#include <map>
+#include <set>
+
+namespace Halide {
+namespace Internal {
+
+using std::map;
+using std::pair;
+using std::string;
+using std::vector;
+
+namespace {
+
+/** A helper to unpack a block into its component Stmts. */
+void block_to_vector(const Stmt &s, vector<Stmt> &v) {
+    const Block *b = s.as<Block>();
+    if (!b) {
+        v.push_back(s);
+    } else {
+        block_to_vector(b->first, v);
+        block_to_vector(b->rest, v);
+    }
+}
+
+class FindStridedLoads : public IRGraphVisitor {
+    using IRGraphVisitor::visit;
+
+    std::set<const Load *> found;
+
+    void visit(const Load *op) override {
+        if (found.count(op) == 0) {
+            found.insert(op);
+            result.push_back(op);
+        }
+        IRGraphVisitor::visit(op);
+    }
+
+public:
+    vector<const Load *> result;
+};
+
+class FindStoredBuffers : public IRVisitor {
+    using IRVisitor::visit;
+
+    void visit(const Store *op) override {
+        buffers.insert(op->name);
+        IRVisitor::visit(op);
+    }
+
+public:
+    std::set<string> buffers;
+};
+
+bool is_store_like(const Stmt &s) {
+    if (s.as<Store>()) {
+        return true;
+    }
+    if (const LetStmt *let = s.as<LetStmt>()) {
+        return is_store_like(let->body);
+    }
+    return false;
+}
+
+class TransposeVectors : public IRMutator {
+    using IRMutator::visit;
+
+    // Rewrite the strided loads in a run of consecutive stores, if
+    // they form complete transpose blocks. Returns an undefined Stmt
+    // if there's nothing to do.
+    Stmt transpose_loads_in_run(const vector<Stmt> &run) {
+        Stmt orig = Block::make(run);
+
+        // Work on the stmt as a graph, as LoopCarry does, so that
+        // equal loads are easy to group.
+        Stmt graph_stmt = substitute_in_all_lets(orig);
+
+        FindStridedLoads find_loads;
+        graph_stmt.accept(&find_loads);
+
+        FindStoredBuffers stored;
+        graph_stmt.accept(&stored);
+
+        // Group graph-equal loads, keeping only strided vector loads
+        // from buffers the run doesn't write to.
+        vector<vector<const Load *>> loads;
+        for (const Load *load : find_loads.result) {
+            const Ramp *ramp = load->index.as<Ramp>();
+            if (!ramp ||
+                ramp->base.type().is_vector() ||
+                !is_const_one(load->predicate) ||
+                stored.buffers.count(load->name)) {
+                continue;
+            }
+            // Small constant strides are handled well by the
+            // interleaved load support in codegen; leave those alone
+            // (along with dense and broadcast-ish loads).
+            if (const int64_t *s = as_const_int(ramp->stride)) {
+                if (std::abs(*s) <= 4) {
+                    continue;
+                }
+            }
+            bool represented = false;
+            for (vector<const Load *> &v : loads) {
+                if (graph_equal(Expr(load), Expr(v[0]))) {
+                    v.push_back(load);
+                    represented = true;
+                }
+            }
+            if (!represented) {
+                loads.push_back({load});
+            }
+        }
+
+        // Bucket the loads by buffer, type, and stride, recording
+        // each one's constant offset from the first load in its
+        // bucket.
+        struct Bucket {
+            Expr base, stride;
+            // Offset -> the graph-equal instances of that load.
+            map<int64_t, vector<const Load *>> members;
+        };
+        vector<Bucket> buckets;
+        for (const vector<const Load *> &v : loads) {
+            const Load *load = v[0];
+            const Ramp *ramp = load->index.as<Ramp>();
+            bool placed = false;
+            for (Bucket &b : buckets) {
+                const Load *ref = b.members.begin()->second[0];
+                if (ref->name != load->name ||
+                    ref->type != load->type ||
+                    !graph_equal(b.stride, ramp->stride)) {
+                    continue;
+                }
+                Expr diff = simplify(ramp->base - b.base);
+                if (const int64_t *d = as_const_int(diff)) {
+                    b.members[*d] = v;
+                    placed = true;
+                    break;
+                }
+            }
+            if (!placed) {
+                buckets.push_back({ramp->base, ramp->stride, {{0, v}}});
+            }
+        }
+
+        // Within each bucket, look for complete blocks: lanes loads
+        // at consecutive offsets. Those collectively read a dense
+        // lanes x lanes block, so replace them with dense loads of
+        // its rows and shuffles that transpose in registers.
+        Stmt result;
+        for (const Bucket &b : buckets) {
+            const Load *ref = b.members.begin()->second[0];
+            const int lanes = ref->type.lanes();
+            auto it = b.members.begin();
+            while (it != b.members.end()) {
+                auto block_end = it;
+                int64_t start = it->first;
+                int count = 0;
+                while (block_end != b.members.end() &&
+                       block_end->first == start + count) {
+                    block_end++;
+                    count++;
+                    if (count == lanes) {
+                        break;
+                    }
+                }
+                if (count == lanes) {
+                    Expr anchor = simplify(b.base + (int)start);
+                    vector<Expr> rows;
+                    for (int k = 0; k < lanes; k++) {
+                        Expr idx = Ramp::make(anchor + k * b.stride, 1, lanes);
+                        rows.push_back(Load::make(ref->type, ref->name, idx,
+                                                  ref->image, ref->param,
+                                                  const_true(lanes), ModulusRemainder()));
+                    }
+                    int j = 0;
+                    for (auto m = it; m != block_end; m++, j++) {
+                        vector<int> indices;
+                        for (int k = 0; k < lanes; k++) {
+                            indices.push_back(k * lanes + j);
+                        }
+                        Expr replacement = Shuffle::make(rows, indices);
+                        if (!result.defined()) {
+                            result = graph_stmt;
+                        }
+                        for (const Load *l : m->second) {
+                            result = graph_substitute(l, replacement, result);
+                        }
+                    }
+                }
+                it = block_end;
+            }
+        }
+
+        if (result.defined()) {
+            // Re-common the dense loads, which are shared between the
+            // shuffles.
+            result = common_subexpression_elimination(result);
+        }
+        return result;
+    }
+
+    Stmt visit(const Block *op) override {
+        vector<Stmt> stmts;
+        block_to_vector(op, stmts);
+
+        vector<Stmt> result;
+        vector<Stmt> run;
+        auto flush = [&]() {
+            if (run.empty()) {
+                return;
+            }
+            Stmt transposed;
+            if (run.size() > 1) {
+                transposed = transpose_loads_in_run(run);
+            }
+            if (transposed.defined()) {
+                result.push_back(transposed);
+            } else {
+                result.insert(result.end(), run.begin(), run.end());
+            }
+            run.clear();
+        };
+        for (const Stmt &s : stmts) {
+            if (is_store_like(s)) {
+                run.push_back(s);
+            } else {
+                flush();
+                result.push_back(mutate(s));
+            }
+        }
+        flush();
+
+        return Block::make(result);
+    }
+};
+
+}  // namespace
+
+Stmt transpose_vectors(const Stmt &s) {
+    return TransposeVectors().mutate(s);
+}
+
+}  // namespace Internal
+}  // namespace Halide
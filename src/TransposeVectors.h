@@ -0,0 +1,27 @@
+#ifndef HALIDE_TRANSPOSE_VECTORS_H
+#define HALIDE_TRANSPOSE_VECTORS_H
+
+/** \file
+ * Defines the lowering pass that rewrites blocks of strided vector
+ * loads as dense loads plus an in-register transpose.
+ */
+
+#include "Expr.h"
+
+namespace Halide {
+namespace Internal {
+
+/** Find groups of strided vector loads that collectively read a dense
+ * two-dimensional block -- the access pattern of a vectorized and
+ * unrolled transpose tile -- and rewrite them as dense loads of the
+ * rows of the block followed by a network of shuffles. The shuffles
+ * lower to in-register transpose sequences (unpck/shuf on x86, zip on
+ * ARM) instead of the gathers or scalar loads the strided form would
+ * produce. Loads with a small constant stride are left to the
+ * interleaved-load handling in codegen. */
+Stmt transpose_vectors(const Stmt &s);
+
+}  // namespace Internal
+}  // namespace Halide
+
+#endif
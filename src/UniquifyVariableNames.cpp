@@ -116,6 +116,11 @@ class UniquifyVariableNames : public IRMutator {
 public:
     UniquifyVariableNames(const Scope<string> *free_vars) {
         renaming.set_containing_scope(free_vars);
+        // This pass holds subtrees only through Expr/Stmt handles, and
+        // its caller doesn't care whether the result is the same
+        // object, so the spine of large pipelines can be rewritten in
+        // place instead of reallocated.
+        mutate_in_place_when_unique = true;
     }
 };
 
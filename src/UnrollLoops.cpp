@@ -1,12 +1,20 @@
 #include "UnrollLoops.h"
 #include "Bounds.h"
 #include "CSE.h"
+#include "ExprUsesVar.h"
+#include "IREquality.h"
 #include "IRMutator.h"
 #include "IROperator.h"
 #include "Simplify.h"
 #include "Substitute.h"
 
+#include <map>
+#include <set>
+
+using std::map;
 using std::pair;
+using std::set;
+using std::string;
 using std::vector;
 
 namespace Halide {
@@ -14,6 +22,153 @@ namespace Internal {
 
 namespace {
 
+// Decides whether it's safe to hoist loads out of the bodies of a
+// jammed loop, and gathers the buffers written to within it.
+class GatherJamHazards : public IRVisitor {
+    using IRVisitor::visit;
+
+    void visit(const Store *op) override {
+        stores.insert(op->name);
+        IRVisitor::visit(op);
+    }
+
+    void visit(const Call *op) override {
+        if (!op->is_pure()) {
+            // An impure call could write to any buffer.
+            unsafe = true;
+        }
+        IRVisitor::visit(op);
+    }
+
+    void visit(const Acquire *op) override {
+        unsafe = true;
+    }
+
+    void visit(const Fork *op) override {
+        unsafe = true;
+    }
+
+public:
+    set<string> stores;
+    bool unsafe = false;
+};
+
+// Finds loads that occur more than once across the bodies of a jammed
+// loop and can be hoisted: unpredicated, from a buffer the bodies
+// don't write to, at an index invariant to anything defined within
+// the bodies.
+class FindSharedLoads : public IRVisitor {
+    using IRVisitor::visit;
+
+    void visit(const Load *op) override {
+        // Visit the index first, so that nested loads are recorded
+        // (and hence let-bound) before the loads containing them.
+        IRVisitor::visit(op);
+        if (!is_const_one(op->predicate) ||
+            stores.count(op->name) ||
+            expr_uses_vars(op, inner_vars)) {
+            return;
+        }
+        Expr e = op;
+        int &count = counts[e];
+        if (count == 0) {
+            order.push_back(e);
+        }
+        count++;
+    }
+
+    void visit(const Let *op) override {
+        visit_let(op);
+    }
+
+    void visit(const LetStmt *op) override {
+        visit_let(op);
+    }
+
+    template<typename LetOp>
+    void visit_let(const LetOp *op) {
+        op->value.accept(this);
+        inner_vars.push(op->name);
+        op->body.accept(this);
+        inner_vars.pop(op->name);
+    }
+
+    void visit(const For *op) override {
+        op->min.accept(this);
+        op->extent.accept(this);
+        inner_vars.push(op->name);
+        op->body.accept(this);
+        inner_vars.pop(op->name);
+    }
+
+    const set<string> &stores;
+    Scope<> inner_vars;
+
+public:
+    map<Expr, int, IRDeepCompare> counts;
+    vector<Expr> order;
+
+    FindSharedLoads(const set<string> &stores)
+        : stores(stores) {
+    }
+};
+
+class ReplaceSharedLoads : public IRMutator {
+public:
+    using IRMutator::mutate;
+
+    Expr mutate(const Expr &e) override {
+        auto it = replacements.find(e);
+        if (it != replacements.end()) {
+            return it->second;
+        }
+        return IRMutator::mutate(e);
+    }
+
+    map<Expr, Expr, IRDeepCompare> replacements;
+};
+
+// Hoist loads that are repeated across the jammed bodies of an
+// unrolled loop into lets wrapping the block, so that each shared
+// load is done once regardless of how well downstream compilation
+// does at eliminating redundant memory accesses.
+Stmt hoist_shared_loads(const Stmt &s) {
+    GatherJamHazards hazards;
+    s.accept(&hazards);
+    if (hazards.unsafe) {
+        return s;
+    }
+
+    FindSharedLoads finder(hazards.stores);
+    s.accept(&finder);
+
+    ReplaceSharedLoads replacer;
+    vector<pair<string, Expr>> lets;
+    for (const Expr &load : finder.order) {
+        if (finder.counts[load] > 1) {
+            string name = unique_name("t_jam");
+            lets.emplace_back(name, load);
+            replacer.replacements[load] = Variable::make(load.type(), name);
+        }
+    }
+    if (lets.empty()) {
+        return s;
+    }
+
+    Stmt stmt = replacer.mutate(s);
+    // Nested loads were recorded before the loads containing them, so
+    // wrapping in reverse order places each let inside the lets it
+    // depends on.
+    for (size_t i = lets.size(); i > 0; i--) {
+        Expr value = lets[i - 1].second;
+        // Stop this let from referring to itself.
+        replacer.replacements.erase(value);
+        value = replacer.mutate(value);
+        stmt = LetStmt::make(lets[i - 1].first, value, stmt);
+    }
+    return stmt;
+}
+
 class UnrollLoops : public IRMutator {
     using IRMutator::visit;
 
@@ -92,6 +247,14 @@ class UnrollLoops : public IRMutator {
                 }
             }
 
+            // Loops scheduled with unroll_and_jam promise that loads
+            // shared between the jammed bodies are hoisted and done
+            // once. Guarded bodies are skipped: lifting a load out of
+            // its guard could read out of bounds.
+            if (!use_guard && ends_with(for_loop->name, "__jam")) {
+                iters = hoist_shared_loads(iters);
+            }
+
             return simplify(iters);
 
         } else {
@@ -132,6 +132,27 @@ string running_program_name() {
 #endif
 }
 
+string running_program_path() {
+#ifndef CAN_GET_RUNNING_PROGRAM_NAME
+    return "";
+#else
+    char path[PATH_MAX] = {0};
+    uint32_t size = sizeof(path);
+#if defined(__linux__)
+    ssize_t len = ::readlink("/proc/self/exe", path, size - 1);
+#elif defined(__APPLE__)
+    ssize_t len = ::_NSGetExecutablePath(path, &size);
+#endif
+    if (len == -1) {
+        return "";
+    }
+#if defined(__linux__)
+    path[len] = '\0';
+#endif
+    return std::string(path);
+#endif
+}
+
 namespace {
 // We use 64K of memory to store unique counters for the purpose of
 // making names unique. Using less memory increases the likelihood of
@@ -130,6 +130,11 @@ std::string get_env_variable(char const *env_var_name);
  * If program name cannot be retrieved, function returns an empty string. */
 std::string running_program_name();
 
+/** Get the full path to the currently running executable.
+ * Platform-specific. If the path cannot be retrieved, function
+ * returns an empty string. */
+std::string running_program_path();
+
 /** Generate a unique name starting with the given prefix. It's unique
  * relative to all other strings returned by unique_name in this
  * process.
@@ -381,20 +381,7 @@ class PredicateLoadStore : public IRMutator {
     using IRMutator::visit;
 
     bool should_predicate_store_load(int bit_size) {
-        if (in_hexagon) {
-            internal_assert(target.has_feature(Target::HVX))
-                << "We are inside a hexagon loop, but the target doesn't have hexagon's features\n";
-            return true;
-        } else if (target.arch == Target::X86) {
-            // Should only attempt to predicate store/load if the lane size is
-            // no less than 4
-            // TODO: disabling for now due to trunk LLVM breakage.
-            // See: https://github.com/halide/Halide/issues/3534
-            // return (bit_size == 32) && (lanes >= 4);
-            return false;
-        }
-        // For other architecture, do not predicate vector load/store
-        return false;
+        return can_predicate_store_load(target, in_hexagon, bit_size, lanes);
     }
 
     Expr merge_predicate(Expr pred, const Expr &new_pred) {
@@ -1622,6 +1609,34 @@ class RemoveUnnecessaryAtomics : public IRMutator {
 
 }  // namespace
 
+bool can_predicate_store_load(const Target &t, bool in_hexagon, int bit_size, int lanes) {
+    if (in_hexagon) {
+        internal_assert(t.has_feature(Target::HVX))
+            << "We are inside a hexagon loop, but the target doesn't have hexagon's features\n";
+        return true;
+    } else if (t.arch == Target::X86) {
+        // AVX-512 has native masked vector loads and stores. The
+        // base feature set only masks 32- and 64-bit elements;
+        // 8- and 16-bit masking needs the BW extension, present
+        // from the Skylake feature set onwards.
+        if (t.has_feature(Target::AVX512_Skylake) ||
+            t.has_feature(Target::AVX512_Cannonlake) ||
+            t.has_feature(Target::AVX512_SapphireRapids)) {
+            return lanes >= 4;
+        }
+        if (t.has_feature(Target::AVX512) ||
+            t.has_feature(Target::AVX512_KNL)) {
+            return (bit_size == 32 || bit_size == 64) && (lanes >= 4);
+        }
+        // Without AVX-512, predicating x86 vector ops produces
+        // poor code (and has broken LLVM in the past).
+        // See: https://github.com/halide/Halide/issues/3534
+        return false;
+    }
+    // For other architecture, do not predicate vector load/store
+    return false;
+}
+
 Stmt vectorize_loops(const Stmt &stmt, const map<string, Function> &env, const Target &t) {
     // Limit the scope of atomic nodes to just the necessary stuff.
     // TODO: Should this be an earlier pass? It's probably a good idea
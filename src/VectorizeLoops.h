@@ -22,6 +22,11 @@ namespace Internal {
  */
 Stmt vectorize_loops(const Stmt &s, const std::map<std::string, Function> &env, const Target &t);
 
+/** Is a predicated (masked) vector load or store of the given element
+ * width and lane count expected to beat the equivalent scalarized
+ * sequence on this target? */
+bool can_predicate_store_load(const Target &t, bool in_hexagon, int bit_size, int lanes);
+
 }  // namespace Internal
 }  // namespace Halide
 
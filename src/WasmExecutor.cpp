@@ -313,7 +313,7 @@ std::vector<char> compile_to_wasm(const Module &module, const std::string &fn_na
 
     TemporaryFile wasm_output("", ".wasm");
 
-    std::string lld_arg_strs[] = {
+    std::vector<std::string> lld_arg_strs = {
         "HalideJITLinker",
         // For debugging purposes:
         // "--verbose",
@@ -327,9 +327,16 @@ std::vector<char> compile_to_wasm(const Module &module, const std::string &fn_na
         "-o",
         wasm_output.pathname()};
 
-    constexpr int c = sizeof(lld_arg_strs) / sizeof(lld_arg_strs[0]);
-    const char *lld_args[c];
-    for (int i = 0; i < c; ++i) {
+    if (module.target().has_feature(Target::WasmThreads)) {
+        // Objects built with +atomics can only be linked into a shared
+        // memory, and shared memories must declare a maximum size.
+        constexpr uint64_t max_shared_memory_size = 1ULL << 30;
+        lld_arg_strs.push_back("--shared-memory");
+        lld_arg_strs.push_back("--max-memory=" + std::to_string(max_shared_memory_size));
+    }
+
+    std::vector<const char *> lld_args(lld_arg_strs.size());
+    for (size_t i = 0; i < lld_arg_strs.size(); ++i) {
         lld_args[i] = lld_arg_strs[i].c_str();
     }
 
@@ -1312,6 +1319,13 @@ wabt::Features calc_features(const Target &target) {
     if (target.has_feature(Target::WasmSatFloatToInt)) {
         f.enable_sat_float_to_int();
     }
+    if (target.has_feature(Target::WasmBulkMemory) ||
+        target.has_feature(Target::WasmThreads)) {
+        f.enable_bulk_memory();
+    }
+    if (target.has_feature(Target::WasmThreads)) {
+        f.enable_threads();
+    }
     return f;
 }
 
@@ -1335,6 +1349,14 @@ struct WasmModuleContents {
     wabt::interp::Instance::Ptr instance;
     wabt::interp::Thread::Options thread_options;
     wabt::interp::Memory::Ptr memory;
+    // The exported function, resolved once at construction.
+    wabt::interp::FuncType *func_type = nullptr;
+    wabt::interp::RefPtr<wabt::interp::Func> func;
+    std::string func_name;
+    // The interpreter thread is created lazily on the first call and
+    // reused for subsequent ones; its stacks are empty between calls,
+    // and creating one is not cheap.
+    wabt::interp::Thread::Ptr thread;
 #endif
 
     WasmModuleContents(
@@ -1364,7 +1386,12 @@ WasmModuleContents::WasmModuleContents(
 #if WITH_WABT
     user_assert(LLVM_VERSION >= 110) << "Using the WebAssembly JIT is only supported under LLVM 11+.";
 
-    user_assert(!target.has_feature(Target::WasmThreads)) << "The Halide WebAssembly JIT doesn't support wasm threads yet.";
+    // Modules built with wasm_threads are accepted here, but note that wabt's
+    // interpreter is strictly single-threaded: the atomics they contain
+    // execute sequentially (which is a legal interleaving), and parallel
+    // loops run serially on the fake thread pool, just as they do without
+    // the feature. Use an AOT build under a real wasm engine to get actual
+    // concurrency.
 
     wdebug(1) << "Compiling wasm function " << fn_name << "\n";
 
@@ -1436,6 +1463,14 @@ WasmModuleContents::WasmModuleContents(
     int32_t heap_base = -1;
 
     for (const auto &e : module_desc.exports) {
+        if (e.type.type->kind == wabt::ExternalKind::Func) {
+            wdebug(1) << "Selecting export '" << e.type.name << "'\n";
+            internal_assert(!func_type && !func) << "Multiple exported funcs found";
+            func_type = wabt::cast<wabt::interp::FuncType>(e.type.type.get());
+            func = store.UnsafeGet<wabt::interp::Func>(instance->funcs()[e.index]);
+            func_name = e.type.name;
+            continue;
+        }
         if (e.type.name == "__heap_base") {
             internal_assert(e.type.type->kind == wabt::ExternalKind::Global);
             heap_base = store.UnsafeGet<wabt::interp::Global>(instance->globals()[e.index])->Get().Get<int32_t>();
@@ -1460,23 +1495,6 @@ WasmModuleContents::WasmModuleContents(
 
 int WasmModuleContents::run(const void **args) {
 #if WITH_WABT
-    const auto &module_desc = module->desc();
-
-    wabt::interp::FuncType *func_type = nullptr;
-    wabt::interp::RefPtr<wabt::interp::Func> func;
-    std::string func_name;
-
-    for (const auto &e : module_desc.exports) {
-        if (e.type.type->kind == wabt::ExternalKind::Func) {
-            wdebug(1) << "Selecting export '" << e.type.name << "'\n";
-            internal_assert(!func_type && !func) << "Multiple exported funcs found";
-            func_type = wabt::cast<wabt::interp::FuncType>(e.type.type.get());
-            func = store.UnsafeGet<wabt::interp::Func>(instance->funcs()[e.index]);
-            func_name = e.type.name;
-            continue;
-        }
-    }
-
     JITUserContext *jit_user_context = nullptr;
     for (size_t i = 0; i < arguments.size(); i++) {
         const Argument &arg = arguments[i];
@@ -1512,8 +1530,9 @@ int WasmModuleContents::run(const void **args) {
         }
     }
 
-    wabt::interp::Thread::Options options;
-    wabt::interp::Thread::Ptr thread = wabt::interp::Thread::New(store, options);
+    if (!thread) {
+        thread = wabt::interp::Thread::New(store, thread_options);
+    }
     thread->set_host_info(&wabt_context);
 
     auto r = func->Call(*thread, wabt_args, wabt_results, &trap);
@@ -0,0 +1,119 @@
+#include "WorkingSetReport.h"
+
+#include "Debug.h"
+#include "IRVisitor.h"
+#include "Target.h"
+
+namespace Halide {
+namespace Internal {
+
+using std::string;
+using std::vector;
+
+namespace {
+
+class ComputeWorkingSets : public IRVisitor {
+    using IRVisitor::visit;
+
+    int depth = 0;
+    bool on_device = false;
+
+    void visit(const For *op) override {
+        size_t idx = loops.size();
+        loops.push_back({op->name, depth, 0, true, on_device});
+        int64_t bytes_before = total_bytes;
+        bool exact_before = exact;
+        bool device_before = on_device;
+        exact = true;
+        on_device = on_device || (op->device_api != DeviceAPI::None);
+        depth++;
+        IRVisitor::visit(op);
+        depth--;
+        loops[idx].bytes = total_bytes - bytes_before;
+        loops[idx].exact = exact;
+        exact = exact && exact_before;
+        on_device = device_before;
+    }
+
+    void visit(const Allocate *op) override {
+        int32_t elements = op->constant_allocation_size();
+        if (elements > 0) {
+            total_bytes += (int64_t)elements * op->type.bytes();
+        } else {
+            exact = false;
+        }
+        IRVisitor::visit(op);
+    }
+
+public:
+    struct Loop {
+        string name;
+        int depth;
+        int64_t bytes;
+        // False if the loop contains an allocation of non-constant
+        // size, in which case bytes is a lower bound.
+        bool exact;
+        bool on_device;
+    };
+    vector<Loop> loops;
+    int64_t total_bytes = 0;
+    bool exact = true;
+};
+
+}  // namespace
+
+void report_working_set(const Stmt &s,
+                        const Target &t,
+                        const string &pipeline_name) {
+    ComputeWorkingSets ws;
+    s.accept(&ws);
+
+    // The Target doesn't describe the cache hierarchy, so compare
+    // against generic desktop-class sizes (the same assumptions the
+    // adams2019 cost model bakes in). Treat these as a starting point
+    // for tile-size tuning, not ground truth.
+    int64_t l1_size = 32 * 1024;
+    int64_t l2_size = 256 * 1024;
+    int64_t llc_size = 8 * 1024 * 1024;
+    if (t.arch == Target::Hexagon) {
+        // Hexagon's unified L2 is also its last-level cache.
+        l2_size = llc_size = 1024 * 1024;
+    }
+
+    auto classify = [&](int64_t bytes, bool exact) -> const char * {
+        if (!exact && bytes <= llc_size) {
+            return "non-constant allocation sizes";
+        } else if (bytes <= l1_size) {
+            return "fits in L1";
+        } else if (bytes <= l2_size) {
+            return "fits in L2";
+        } else if (bytes <= llc_size) {
+            return "fits in LLC";
+        } else {
+            return "exceeds LLC";
+        }
+    };
+
+    debug(1) << "Working set per loop level for pipeline " << pipeline_name
+             << " (assuming " << (l1_size >> 10) << " KiB L1, "
+             << (l2_size >> 10) << " KiB L2, "
+             << (llc_size >> 10) << " KiB LLC):\n";
+    debug(1) << "  total allocated: " << ws.total_bytes
+             << (ws.exact ? "" : "+") << " bytes ("
+             << classify(ws.total_bytes, ws.exact) << ")\n";
+    for (const auto &l : ws.loops) {
+        if (l.bytes == 0 && l.exact) {
+            // Innermost loops rarely contain allocations; don't
+            // drown the interesting levels in zero rows.
+            continue;
+        }
+        debug(1) << "  " << string((size_t)l.depth * 2, ' ')
+                 << "for " << l.name << ": " << l.bytes
+                 << (l.exact ? "" : "+") << " bytes ("
+                 << (l.on_device ? "on device" : classify(l.bytes, l.exact))
+                 << ")\n";
+    }
+}
+
+}  // namespace Internal
+}  // namespace Halide
@@ -0,0 +1,34 @@
+#ifndef HALIDE_INTERNAL_WORKING_SET_REPORT_H
+#define HALIDE_INTERNAL_WORKING_SET_REPORT_H
+
+/** \file
+ *
+ * Defines a compile-time report of the bytes allocated at each loop
+ * level of a lowered pipeline, compared to the sizes of a typical
+ * cache hierarchy.
+ */
+#include <string>
+
+#include "Expr.h"
+
+namespace Halide {
+
+struct Target;
+
+namespace Internal {
+
+/** Print (at debug level 1) the bytes of storage allocated within
+ * each loop of a fully-lowered statement, and whether that working
+ * set fits in the L1, L2, or last-level cache. The Target doesn't
+ * model the cache hierarchy, so the comparison uses generic
+ * desktop-class sizes; it is meant as a starting point for tile-size
+ * tuning, not an exact model. Allocations whose sizes are not
+ * compile-time constants are reported as lower bounds. */
+void report_working_set(const Stmt &s,
+                        const Target &t,
+                        const std::string &pipeline_name);
+
+}  // namespace Internal
+}  // namespace Halide
+
+#endif
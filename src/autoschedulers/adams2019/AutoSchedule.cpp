@@ -47,6 +47,12 @@
   HL_SEED
   Random seed used by the random dropout.
 
+  HL_SEARCH_THREADS
+  Number of threads used to expand the states in the beam in parallel. Defaults to the number of hardware threads. Set to 1 to expand states serially. The result of the search does not depend on this value.
+
+  HL_FEATURE_CACHE_SIZE
+  Number of bytes used to cache the featurizations of states visited during the search, so that the coarse-to-fine passes of beam search don't refeaturize structurally identical states. Defaults to 1GB. Set to 0 to disable the cache.
+
   HL_WEIGHTS_DIR
   When training or schedule, read weights from this directory or file
   (if path ends in `.weights` it is written as a single file, otherwise a directory of files)
@@ -61,12 +67,21 @@
   HL_AUTOSCHEDULE_MEMORY_LIMIT
   If set, only consider schedules that allocate at most this much memory (measured in bytes).
 
+  HL_CALIBRATION_PROFILE
+  Path to a profile exported by halide_profiler_export from a production run of this
+  pipeline. The measured per-func times are used to rescale the cost model's per-stage
+  predictions, so candidate schedules are re-ranked using the measured rather than
+  predicted distribution of time across stages. Useful when the cost model badly
+  mispredicts the relative cost of particular stages. Funcs absent from the profile
+  (e.g. ones the production schedule inlined away) keep their predicted costs.
+
   TODO: expose these settings by adding some means to pass args to
   generator plugins instead of environment vars.
 */
 #include "HalidePlugin.h"
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <fstream>
 #include <iostream>
@@ -74,6 +89,7 @@
 #include <random>
 #include <set>
 #include <sstream>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -177,6 +193,15 @@ bool random_dropout(std::mt19937 &rng, size_t num_decisions) {
     return drop_it;
 }
 
+// Get the HL_SEARCH_THREADS environment variable. Purpose of this is described above.
+int get_num_search_threads() {
+    string search_threads_str = get_env_variable("HL_SEARCH_THREADS");
+    if (!search_threads_str.empty()) {
+        return std::max(1, atoi(search_threads_str.c_str()));
+    }
+    return std::max(1, (int)std::thread::hardware_concurrency());
+}
+
 // A priority queue of states, sorted according to increasing
 // cost. Never shrinks, to avoid reallocations.
 // Can't use std::priority_queue because it doesn't support unique_ptr.
@@ -261,7 +286,8 @@ IntrusivePtr<State> optimal_schedule_pass(FunctionDAG &dag,
                                           int pass_idx,
                                           int num_passes,
                                           ProgressBar &tick,
-                                          std::unordered_set<uint64_t> &permitted_hashes) {
+                                          std::unordered_set<uint64_t> &permitted_hashes,
+                                          FeaturizationCache *feature_cache) {
 
     if (cost_model) {
         configure_pipeline_features(dag, params, cost_model);
@@ -320,7 +346,8 @@ IntrusivePtr<State> optimal_schedule_pass(FunctionDAG &dag,
                                              pass_idx,
                                              num_passes,
                                              tick,
-                                             permitted_hashes);
+                                             permitted_hashes,
+                                             feature_cache);
             } else {
                 internal_error << "Ran out of legal states with beam size " << beam_size << "\n";
             }
@@ -331,6 +358,7 @@ IntrusivePtr<State> optimal_schedule_pass(FunctionDAG &dag,
         }
 
         expanded = 0;
+        vector<IntrusivePtr<State>> to_expand;
         while (expanded < beam_size && !pending.empty()) {
 
             IntrusivePtr<State> state{pending.pop()};
@@ -408,10 +436,47 @@ IntrusivePtr<State> optimal_schedule_pass(FunctionDAG &dag,
                 return best;
             }
 
-            state->generate_children(dag, params, cost_model, memory_limit, enqueue_new_children);
+            to_expand.emplace_back(std::move(state));
             expanded++;
         }
 
+        // Expand the selected states. Computing the featurization of
+        // each candidate child is independent of the others and
+        // dominates the cost of a pass, so the states can be expanded
+        // in parallel. Each state's children are buffered separately
+        // and enqueued in beam order below, so the result of the
+        // search does not depend on the number of threads.
+        vector<vector<IntrusivePtr<State>>> new_children(to_expand.size());
+        std::atomic<size_t> next_to_expand{0};
+        auto expand_states = [&]() {
+            size_t idx;
+            while ((idx = next_to_expand++) < to_expand.size()) {
+                std::function<void(IntrusivePtr<State> &&)> buffer_child =
+                    [&](IntrusivePtr<State> &&s) {
+                        new_children[idx].emplace_back(std::move(s));
+                    };
+                to_expand[idx]->generate_children(dag, params, cost_model, memory_limit, feature_cache, buffer_child);
+            }
+        };
+        size_t num_threads = std::min((size_t)get_num_search_threads(), to_expand.size());
+        if (num_threads <= 1) {
+            expand_states();
+        } else {
+            vector<std::thread> threads;
+            threads.reserve(num_threads);
+            for (size_t t = 0; t < num_threads; t++) {
+                threads.emplace_back(expand_states);
+            }
+            for (auto &t : threads) {
+                t.join();
+            }
+        }
+        for (auto &children : new_children) {
+            for (auto &c : children) {
+                enqueue_new_children(std::move(c));
+            }
+        }
+
         // Drop the other states unconsidered.
         pending.clear();
 
@@ -431,7 +496,7 @@ IntrusivePtr<State> optimal_schedule_pass(FunctionDAG &dag,
                 auto state = q[choice_label];
                 aslog(0) << "\n[" << choice_label << "]:\n";
                 state->dump();
-                state->calculate_cost(dag, params, cost_model, memory_limit, true);
+                state->calculate_cost(dag, params, cost_model, memory_limit, feature_cache, true);
             }
             cost_model->evaluate_costs();
 
@@ -463,6 +528,12 @@ IntrusivePtr<State> optimal_schedule(FunctionDAG &dag,
 
     std::unordered_set<uint64_t> permitted_hashes;
 
+    // The coarse-to-fine passes below re-explore much of the same
+    // space, so featurizations are cached across them. The cache is
+    // scoped to this search: the hashes it is keyed by are not unique
+    // across pipelines.
+    FeaturizationCache feature_cache;
+
     // If the beam size is one, it's pointless doing multiple passes.
     int num_passes = (beam_size == 1) ? 1 : 5;
 
@@ -486,7 +557,8 @@ IntrusivePtr<State> optimal_schedule(FunctionDAG &dag,
 
         auto pass = optimal_schedule_pass(dag, outputs, params, cost_model,
                                           rng, beam_size, memory_limit,
-                                          i, num_passes, tick, permitted_hashes);
+                                          i, num_passes, tick, permitted_hashes,
+                                          &feature_cache);
 
         std::chrono::duration<double> total_time = timer.elapsed();
         auto milli = std::chrono::duration_cast<std::chrono::milliseconds>(total_time).count();
@@ -509,11 +581,16 @@ IntrusivePtr<State> optimal_schedule(FunctionDAG &dag,
 
     aslog(0) << "Best cost: " << best->cost << "\n";
 
+    if (feature_cache.enabled()) {
+        aslog(1) << "Featurization cache: " << feature_cache.hits()
+                 << " hits, " << feature_cache.misses() << " misses\n";
+    }
+
     return best;
 }
 
 // Keep track of how many times we evaluated a state.
-int State::cost_calculations = 0;
+std::atomic<int> State::cost_calculations{0};
 
 // The main entrypoint to generate a schedule for a pipeline.
 void generate_schedule(const std::vector<Function> &outputs,
@@ -563,9 +640,20 @@ void generate_schedule(const std::vector<Function> &outputs,
     // Construct a cost model to use to evaluate states. Currently we
     // just have the one, but it's an abstract interface, so others
     // can be slotted in for experimentation.
-    std::unique_ptr<CostModel> cost_model = make_default_cost_model(weights_in_path, weights_out_path, randomize_weights);
+    std::unique_ptr<DefaultCostModel> cost_model = make_default_cost_model(weights_in_path, weights_out_path, randomize_weights);
     internal_assert(cost_model != nullptr);
 
+    // Optionally calibrate the cost model against measured stage
+    // runtimes from a production run of this pipeline.
+    string calibration_profile = get_env_variable("HL_CALIBRATION_PROFILE");
+    if (!calibration_profile.empty()) {
+        if (cost_model->load_calibration_profile(calibration_profile)) {
+            aslog(1) << "Loaded calibration profile from " << calibration_profile << "\n";
+        } else {
+            user_warning << "Could not parse calibration profile " << calibration_profile << "; ignoring it\n";
+        }
+    }
+
     IntrusivePtr<State> optimal;
 
     // Run beam search
@@ -573,16 +661,16 @@ void generate_schedule(const std::vector<Function> &outputs,
 
     HALIDE_TOC;
 
-    aslog(1) << "Cost evaluated this many times: " << State::cost_calculations << "\n";
+    aslog(1) << "Cost evaluated this many times: " << State::cost_calculations.load() << "\n";
 
     // Dump the schedule found
     aslog(1) << "** Optimal schedule:\n";
 
     // Just to get the debugging prints to fire
-    optimal->calculate_cost(dag, params, cost_model.get(), memory_limit, aslog::aslog_level() > 0);
+    optimal->calculate_cost(dag, params, cost_model.get(), memory_limit, nullptr, aslog::aslog_level() > 0);
 
     // Apply the schedules to the pipeline
-    optimal->apply_schedule(dag, params);
+    optimal->apply_schedule(dag, params, target);
 
     // Print out the schedule
     if (aslog::aslog_level() > 0) {
@@ -640,6 +728,7 @@ REGISTER_AUTOSCHEDULER(Adams2019)
 void find_and_apply_schedule(FunctionDAG &dag,
                              const std::vector<Function> &outputs,
                              const MachineParams &params,
+                             const Target &target,
                              CostModel *cost_model,
                              int beam_size,
                              int64_t memory_limit,
@@ -649,7 +738,7 @@ void find_and_apply_schedule(FunctionDAG &dag,
     IntrusivePtr<State> optimal = optimal_schedule(dag, outputs, params, cost_model, rng, beam_size, memory_limit);
 
     // Apply the schedules
-    optimal->apply_schedule(dag, params);
+    optimal->apply_schedule(dag, params, target);
 
     if (schedule_features) {
         optimal->compute_featurization(dag, params, schedule_features);
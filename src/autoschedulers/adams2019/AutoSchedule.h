@@ -12,7 +12,7 @@ namespace Autoscheduler {
 typedef PerfectHashMap<FunctionDAG::Node::Stage, ScheduleFeatures> StageMapOfScheduleFeatures;
 
 void find_and_apply_schedule(FunctionDAG &dag, const std::vector<Function> &outputs, const MachineParams &params,
-                             CostModel *cost_model, int beam_size, StageMapOfScheduleFeatures *schedule_features);
+                             const Target &target, CostModel *cost_model, int beam_size, StageMapOfScheduleFeatures *schedule_features);
 
 }  // namespace Autoscheduler
 }  // namespace Internal
@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <cmath>
 #include <ctime>
+#include <fstream>
 #include <map>
 #include <random>
 #include <sstream>
@@ -17,6 +18,10 @@
 #include "cost_model.h"
 #include "train_cost_model.h"
 
+#ifdef HALIDE_ADAMS2019_CUDA_COST_MODEL
+#include "cost_model_cuda.h"
+#endif
+
 // This is an embedded version of `baseline.weights`.
 // The embedding is done using binary2cpp.
 
@@ -60,11 +65,16 @@ void DefaultCostModel::set_pipeline_features(const Internal::Autoscheduler::Func
         if (!n.is_input) num_stages += (int)n.stages.size();
     }
     Runtime::Buffer<float> pipeline_features(head1_w, head1_h, num_stages);
+    stage_names.clear();
     int stage = 0;
     for (const auto &n : dag.nodes) {
         if (n.is_input) continue;
         for (auto it = n.stages.rbegin(); it != n.stages.rend(); it++) {
             const auto &s = *it;
+            // Remember which func owns this stage index, so measured
+            // profiles (which are per-func) can be matched up with
+            // the per-stage feature buffers.
+            stage_names.push_back(n.func.name());
             const int *pipeline_feats = (const int *)(&(s.features)) + 7;
             // skip the first 7 features
             for (int i = 0; i < pipeline_feat_size; i++) {
@@ -90,6 +100,11 @@ void DefaultCostModel::set_pipeline_features(const Runtime::Buffer<float> &pipel
 void DefaultCostModel::enqueue(const Internal::Autoscheduler::FunctionDAG &dag,
                                const Halide::Internal::Autoscheduler::StageMapOfScheduleFeatures &schedule_feats,
                                double *cost_ptr) {
+    // Hold the lock for the whole call, so that a concurrent enqueue
+    // can't trigger a batch evaluation while we're still copying
+    // features into our slot in the batch.
+    std::lock_guard<std::mutex> lock(enqueue_mutex);
+
     num_stages = (int)schedule_feats.size();
 
     Runtime::Buffer<float> schedule_features;
@@ -142,7 +157,15 @@ void DefaultCostModel::enqueue(int ns, Runtime::Buffer<float> *schedule_feats, d
         << "schedule features has more stages (" << num_stages
         << ") than pipeline features (" << max_num_stages << ")\n";
 
+#ifdef HALIDE_ADAMS2019_CUDA_COST_MODEL
+    // When inference can run on the GPU, much larger batches are
+    // needed to amortize the kernel launch and the feature upload,
+    // so gather featurizations across many more beam search states
+    // before evaluating.
+    const int batch_size = 8192;
+#else
     const int batch_size = 1024;
+#endif
     if (!schedule_feat_queue.data() ||
         schedule_feat_queue.dim(2).extent() < max_num_stages) {
         internal_assert(cursor == 0);
@@ -279,7 +302,33 @@ void DefaultCostModel::evaluate_costs() {
 
     auto loss = Runtime::Buffer<float>::make_scalar();
 
-    int result = cost_model(num_stages,
+    int result = -1;
+#ifdef HALIDE_ADAMS2019_CUDA_COST_MODEL
+    // Prefer the CUDA build of the cost model. If it fails (most
+    // likely because there is no usable CUDA device), fall back to
+    // the CPU build for the rest of the process.
+    if (!cuda_cost_model_failed) {
+        result = cost_model_cuda(num_stages,
+                                 cursor,
+                                 num_cores,
+                                 pipeline_feat_queue,
+                                 schedule_feat_queue,
+                                 weights.head1_filter, weights.head1_bias,
+                                 weights.head2_filter, weights.head2_bias,
+                                 weights.conv1_filter, weights.conv1_bias,
+                                 0.0f, 0, 0, nullptr,
+                                 dst, loss);
+        if (result == 0) {
+            dst.copy_to_host();
+        } else {
+            aslog(1) << "CUDA cost model returned " << result
+                     << "; falling back to CPU inference\n";
+            cuda_cost_model_failed = true;
+        }
+    }
+#endif
+    if (result != 0) {
+        result = cost_model(num_stages,
                             cursor,
                             num_cores,
                             pipeline_feat_queue,
@@ -289,9 +338,14 @@ void DefaultCostModel::evaluate_costs() {
                             weights.conv1_filter, weights.conv1_bias,
                             0.0f, 0, 0, nullptr,
                             dst, loss);
+    }
     (void)result;
     internal_assert(result == 0);
 
+    if (!calibration_times.empty() && !stage_names.empty()) {
+        apply_calibration(dst);
+    }
+
     for (int i = 0; i < cursor; i++) {
         internal_assert(cost_ptrs(i));
         *(cost_ptrs(i)) = dst(i);
@@ -300,6 +354,147 @@ void DefaultCostModel::evaluate_costs() {
     cursor = 0;
 }
 
+void DefaultCostModel::apply_calibration(Runtime::Buffer<float> &dst) {
+    const int num_features = schedule_feat_queue.dim(1).extent();
+
+    // Peel the model's prediction apart into per-stage costs. The
+    // predicted runtime is a sum over stages, each stage's
+    // contribution depends only on its own features, and every term
+    // in a stage's cost is proportional to at least one of its
+    // schedule features. So re-running the model with one stage's
+    // schedule features zeroed out subtracts exactly that stage's
+    // contribution from the total.
+    Runtime::Buffer<float> masked(cursor, num_features, num_stages);
+    for (int w = 0; w < num_stages; w++) {
+        for (int c = 0; c < num_features; c++) {
+            for (int i = 0; i < cursor; i++) {
+                masked(i, c, w) = schedule_feat_queue(i, c, w);
+            }
+        }
+    }
+
+    Runtime::Buffer<float> stage_costs(cursor, num_stages);
+    Runtime::Buffer<float> partial(cursor);
+    auto loss = Runtime::Buffer<float>::make_scalar();
+    for (int w = 0; w < num_stages; w++) {
+        for (int c = 0; c < num_features; c++) {
+            for (int i = 0; i < cursor; i++) {
+                masked(i, c, w) = 0.0f;
+            }
+        }
+        int result = cost_model(num_stages,
+                                cursor,
+                                num_cores,
+                                pipeline_feat_queue,
+                                masked,
+                                weights.head1_filter, weights.head1_bias,
+                                weights.head2_filter, weights.head2_bias,
+                                weights.conv1_filter, weights.conv1_bias,
+                                0.0f, 0, 0, nullptr,
+                                partial, loss);
+        (void)result;
+        internal_assert(result == 0);
+        for (int i = 0; i < cursor; i++) {
+            stage_costs(i, w) = std::max(0.0f, dst(i) - partial(i));
+        }
+        for (int c = 0; c < num_features; c++) {
+            for (int i = 0; i < cursor; i++) {
+                masked(i, c, w) = schedule_feat_queue(i, c, w);
+            }
+        }
+    }
+
+    // Derive a per-stage correction factor by comparing how the
+    // measured profile distributes time across stages with how the
+    // model thinks this batch does. Both distributions are
+    // renormalized over the stages that were actually measured;
+    // unmeasured stages (e.g. funcs the production schedule inlined
+    // away) are left uncorrected.
+    std::vector<double> predicted(num_stages, 0.0), measured(num_stages, -1.0);
+    double total_predicted = 0, total_measured = 0;
+    for (int w = 0; w < num_stages; w++) {
+        for (int i = 0; i < cursor; i++) {
+            predicted[w] += stage_costs(i, w);
+        }
+        auto it = calibration_times.find(stage_names[w]);
+        if (it != calibration_times.end() && predicted[w] > 0) {
+            measured[w] = it->second;
+            total_predicted += predicted[w];
+            total_measured += measured[w];
+        }
+    }
+    if (total_predicted <= 0 || total_measured <= 0) {
+        return;
+    }
+
+    std::vector<float> factor(num_stages, 1.0f);
+    for (int w = 0; w < num_stages; w++) {
+        if (measured[w] >= 0) {
+            double f = ((measured[w] / total_measured) /
+                        (predicted[w] / total_predicted));
+            // A mispredicted stage share shouldn't be able to
+            // completely erase or drown out the schedule-dependent
+            // signal for the other stages.
+            factor[w] = (float)std::min(100.0, std::max(0.01, f));
+        }
+    }
+
+    if (!calibration_logged) {
+        calibration_logged = true;
+        for (int w = 0; w < num_stages; w++) {
+            aslog(1) << "Calibration factor for stage " << w
+                     << " (" << stage_names[w] << "): " << factor[w] << "\n";
+        }
+    }
+
+    for (int i = 0; i < cursor; i++) {
+        float cost = 0.0f;
+        for (int w = 0; w < num_stages; w++) {
+            cost += factor[w] * stage_costs(i, w);
+        }
+        dst(i) = cost;
+    }
+}
+
+bool DefaultCostModel::load_calibration_profile(const std::string &path) {
+    std::ifstream file(path);
+    std::string line;
+    if (!std::getline(file, line)) {
+        return false;
+    }
+    {
+        std::istringstream header(line);
+        std::string magic;
+        int version = 0;
+        header >> magic >> version;
+        if (magic != "halide_profile" || version != 1) {
+            return false;
+        }
+    }
+    calibration_times.clear();
+    double runs = 1;
+    while (std::getline(file, line)) {
+        std::istringstream is(line);
+        std::string tag;
+        is >> tag;
+        if (tag == "pipeline") {
+            is >> runs;
+            runs = std::max(runs, 1.0);
+        } else if (tag == "func") {
+            uint64_t time_ns = 0;
+            std::string name;
+            is >> time_ns >> std::ws;
+            std::getline(is, name);
+            if (!name.empty()) {
+                // Store per-run seconds. If the same func name shows
+                // up under several pipelines, the last one wins.
+                calibration_times[name] = time_ns / (runs * 1e9);
+            }
+        }
+    }
+    return !calibration_times.empty();
+}
+
 void DefaultCostModel::load_weights() {
     bool need_randomize = randomize_weights;
 
@@ -3,7 +3,10 @@
 
 #include "CostModel.h"
 #include "Weights.h"
+#include <map>
+#include <mutex>
 #include <string>
+#include <vector>
 
 namespace Halide {
 
@@ -14,9 +17,35 @@ private:
     Runtime::Buffer<double *> cost_ptrs;
     int cursor, num_stages, num_cores;
 
+    // Guards the queue of enqueued schedules, which is filled from
+    // multiple threads when the beam search is parallelized.
+    std::mutex enqueue_mutex;
+
     const std::string weights_in_path, weights_out_path;
     const bool randomize_weights;
 
+    // Measured per-run time in seconds for each func, loaded from a
+    // profile exported by halide_profiler_export. Empty if no
+    // calibration profile has been loaded.
+    std::map<std::string, double> calibration_times;
+
+    // The func name that owns each stage index, in the same order the
+    // stages appear in the feature buffers. Only filled in by the
+    // FunctionDAG flavor of set_pipeline_features.
+    std::vector<std::string> stage_names;
+
+    bool calibration_logged = false;
+
+    // Set once the CUDA build of the cost model has failed to run
+    // (most likely because there is no CUDA device); inference then
+    // sticks to the CPU build. Only used when a CUDA cost model was
+    // compiled in.
+    bool cuda_cost_model_failed = false;
+
+    // Rescale the predicted costs of the current batch using the
+    // loaded calibration profile.
+    void apply_calibration(Runtime::Buffer<float> &dst);
+
     Runtime::Buffer<float>
         head1_filter_update, head1_bias_update,
         head2_filter_update, head2_bias_update,
@@ -40,8 +69,11 @@ public:
                                const MachineParams &params) override;
     void set_pipeline_features(const Runtime::Buffer<float> &, int n);
 
-    // Enqueue a schedule to be evaluated. The second version of this method returns a buffer of
-    // schedule_features that should be filled in by the caller.
+    // Enqueue a schedule to be evaluated. The first version is
+    // thread-safe; it may be called concurrently with itself, but not
+    // with evaluate_costs. The second version of this method returns
+    // a buffer of schedule_features that should be filled in by the
+    // caller, and is not thread-safe.
     void enqueue(const Internal::Autoscheduler::FunctionDAG &dag,
                  const Halide::Internal::Autoscheduler::StageMapOfScheduleFeatures &schedule_feats,
                  double *cost_ptr) override;
@@ -56,6 +88,14 @@ public:
     // Update model weights using true measured runtimes.
     float backprop(const Runtime::Buffer<const float> &true_runtimes, float learning_rate);
 
+    // Load measured per-func runtimes from a profile exported by
+    // halide_profiler_export during a production run of this
+    // pipeline. While loaded, evaluate_costs reweights the model's
+    // per-stage cost predictions so that the predicted distribution
+    // of time across stages matches the measured one. Returns false
+    // if the file could not be read or contained no measurements.
+    bool load_calibration_profile(const std::string &path);
+
     // Save/Load the model weights to/from disk.
     void save_weights();
     void load_weights();
@@ -375,6 +375,7 @@ void BoundContents::Layout::allocate_some_more() const {
 }
 
 BoundContents *BoundContents::Layout::make() const {
+    std::lock_guard<std::mutex> lock(mutex);
     if (pool.empty()) {
         allocate_some_more();
     }
@@ -387,6 +388,7 @@ BoundContents *BoundContents::Layout::make() const {
 void BoundContents::Layout::release(const BoundContents *b) const {
     internal_assert(b->layout == this) << "Releasing BoundContents onto the wrong pool!";
     b->~BoundContents();
+    std::lock_guard<std::mutex> lock(mutex);
     pool.push_back(const_cast<BoundContents *>(b));
     num_live--;
 }
@@ -755,6 +757,14 @@ FunctionDAG::FunctionDAG(const vector<Function> &outputs, const MachineParams &p
             if (def.predicate().defined()) {
                 exprs_vector.push_back(def.predicate());
             }
+            if (consumer.has_extern_definition() &&
+                consumer.extern_definition_proxy_expr().defined()) {
+                // An extern definition's values are undef. Stand in
+                // the proxy expression so that the edges to the
+                // stage's inputs carry real footprints instead of
+                // walling the stage off from the search.
+                exprs_vector.push_back(consumer.extern_definition_proxy_expr());
+            }
             Expr exprs = Call::make(Int(32), "dummy", exprs_vector, Call::Extern);
 
             // Walk over the expressions involved sniffing types
@@ -935,6 +945,8 @@ FunctionDAG::FunctionDAG(const vector<Function> &outputs, const MachineParams &p
 
             node.is_wrapper = node.func.is_wrapper();
             node.is_input = !node.func.has_update_definition() && node.is_wrapper && !any_incoming_edges;
+            node.is_extern = node.func.has_extern_definition();
+            node.is_memoized = node.func.schedule().memoized();
             node.dimensions = node.func.dimensions();
         }
     }
@@ -1044,7 +1056,9 @@ void FunctionDAG::dump_internal(OS &os) const {
            << " boundary condition: " << n.is_boundary_condition
            << " wrapper: " << n.is_wrapper
            << " input: " << n.is_input
-           << " output: " << n.is_output << "\n";
+           << " output: " << n.is_output
+           << " extern: " << n.is_extern
+           << " memoized: " << n.is_memoized << "\n";
     }
     for (const Edge &e : edges) {
         os << "Edge: " << e.producer->func.name() << " -> " << e.consumer->name << "\n"
@@ -8,6 +8,7 @@
 #include <algorithm>
 #include <cstdint>
 #include <map>
+#include <mutex>
 #include <string>
 #include <utility>
 
@@ -317,8 +318,7 @@ struct BoundContents {
     // We're frequently going to need to make these concrete bounds
     // arrays.  It makes things more efficient if we figure out the
     // memory layout of those data structures once ahead of time, and
-    // make each individual instance just use that. Note that this is
-    // not thread-safe.
+    // make each individual instance just use that.
     class Layout {
         // A memory pool of free BoundContent objects with this layout
         mutable std::vector<BoundContents *> pool;
@@ -328,6 +328,10 @@ struct BoundContents {
 
         mutable size_t num_live = 0;
 
+        // Guards the pool, as Bounds are created and destroyed on
+        // multiple threads when the beam search is parallelized.
+        mutable std::mutex mutex;
+
         void allocate_some_more() const;
 
     public:
@@ -513,6 +517,18 @@ struct FunctionDAG {
         // Only uses pointwise calls + clamping on all indices
         bool is_boundary_condition;
 
+        // Has an extern definition. The loops of an extern stage
+        // belong to its implementation, so we may not inline, subtile,
+        // vectorize, or parallelize it, but with a proxy expression
+        // (see Func::extern_definition_proxy) its cost and footprint
+        // are still modeled so producers and consumers can be
+        // scheduled around it.
+        bool is_extern;
+
+        // Is scheduled with memoize(). Inlining it would silently
+        // discard the cache, so we don't.
+        bool is_memoized;
+
         std::unique_ptr<BoundContents::Layout> bounds_memory_layout;
 
         BoundContents *make_bound() const {
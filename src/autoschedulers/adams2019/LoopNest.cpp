@@ -128,7 +128,11 @@ void LoopNest::copy_from(const LoopNest &n) {
     children = n.children;
     inlined = n.inlined;
     store_at = n.store_at;
-    bounds = n.bounds;
+    {
+        // Another thread may be memoizing bounds into the source map.
+        std::lock_guard<std::mutex> lock(n.bounds_mutex);
+        bounds = n.bounds;
+    }
     node = n.node;
     stage = n.stage;
     innermost = n.innermost;
@@ -959,6 +963,11 @@ void LoopNest::compute_features(const FunctionDAG &dag,
 // know what region would be computed if it were scheduled here,
 // and what its loop nest would be.
 const Bound &LoopNest::get_bounds(const FunctionDAG::Node *f) const {
+    std::lock_guard<std::mutex> lock(bounds_mutex);
+    return get_bounds_inner(f);
+}
+
+const Bound &LoopNest::get_bounds_inner(const FunctionDAG::Node *f) const {
     if (bounds.contains(f)) {
         const Bound &b = bounds.get(f);
         // Expensive validation for debugging
@@ -990,7 +999,7 @@ const Bound &LoopNest::get_bounds(const FunctionDAG::Node *f) const {
                 !stage->downstream_of(*(e->consumer->node))) {
                 continue;
             }
-            const auto &c_bounds = get_bounds(e->consumer->node);
+            const auto &c_bounds = get_bounds_inner(e->consumer->node);
 
             // Get the concrete sizes of the consuming loop
             const auto *consumer_loop = &(c_bounds->loops(e->consumer->index, 0));
@@ -1216,7 +1225,7 @@ void LoopNest::compute_here(const FunctionDAG::Node *f, bool tileable, int v) {
         node->stage = &f->stages[s];
         node->innermost = true;
         node->vectorized_loop_index = -1;
-        node->tileable = tileable && (is_root() || may_subtile());
+        node->tileable = tileable && (is_root() || may_subtile()) && !f->is_extern;
         // Set up a bound for the inside of the
         // loop. computed/required is still the full region, but
         // the loop nest will be a single representative point.
@@ -1240,6 +1249,7 @@ void LoopNest::compute_here(const FunctionDAG::Node *f, bool tileable, int v) {
             internal_assert(l.max() >= l.min()) << i << " " << l.max() << " " << l.min() << "\n";
 
             if (f->dimensions &&
+                !f->is_extern &&
                 node->size[i] >= 1 &&
                 f->stages[s].loop[i].var == f->func.args()[v]) {
                 node->vectorized_loop_index = (int)i;
@@ -1309,7 +1319,11 @@ IntrusivePtr<const LoopNest> LoopNest::parallelize_in_tiles(const MachineParams
     inner->innermost = innermost;
     inner->children = children;
     inner->inlined = inlined;
-    inner->bounds = bounds;
+    {
+        // Another thread may be memoizing bounds into the source map.
+        std::lock_guard<std::mutex> lock(bounds_mutex);
+        inner->bounds = bounds;
+    }
     inner->store_at = store_at;
 
     auto *b = inner->get_bounds(node)->make_copy();
@@ -1479,7 +1493,11 @@ vector<IntrusivePtr<const LoopNest>> LoopNest::compute_in_tiles(const FunctionDA
             inner->innermost = innermost;
             inner->children = children;
             inner->inlined = inlined;
-            inner->bounds = bounds;
+            {
+                // Another thread may be memoizing bounds into the source map.
+                std::lock_guard<std::mutex> lock(bounds_mutex);
+                inner->bounds = bounds;
+            }
             inner->store_at = store_at;
 
             {
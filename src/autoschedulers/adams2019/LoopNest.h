@@ -9,6 +9,7 @@
 #include "FunctionDAG.h"
 #include "PerfectHashMap.h"
 #include <map>
+#include <mutex>
 #include <set>
 #include <utility>
 #include <vector>
@@ -55,6 +56,11 @@ struct LoopNest {
     // little boxes to the left of the loop nest tree figures.
     mutable NodeMap<Bound> bounds;
 
+    // Guards lazy computation of the map above. Sub-trees are shared
+    // between the states being explored, which may be expanded on
+    // different threads during beam search.
+    mutable std::mutex bounds_mutex;
+
     // The Func this loop nest belongs to
     const FunctionDAG::Node *node = nullptr;
 
@@ -144,6 +150,10 @@ struct LoopNest {
 
     // Set the region required of a Func at this site.
     const Bound &set_bounds(const FunctionDAG::Node *f, BoundContents *b) const {
+        // Jump straight to the reference-stable large state of the
+        // map, so that references returned by get_bounds stay valid
+        // while other threads memoize additional entries.
+        bounds.make_large((int)f->max_id);
         return bounds.emplace(f, b);
     }
 
@@ -152,6 +162,9 @@ struct LoopNest {
     // and what its loop nest would be.
     const Bound &get_bounds(const FunctionDAG::Node *f) const;
 
+    // The above, assuming bounds_mutex is already held.
+    const Bound &get_bounds_inner(const FunctionDAG::Node *f) const;
+
     // Recursively print a loop nest representation to stderr
     void dump(string prefix, const LoopNest *parent) const;
 
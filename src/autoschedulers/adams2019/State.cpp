@@ -1,5 +1,7 @@
 #include "State.h"
 
+#include <limits>
+
 namespace Halide {
 namespace Internal {
 namespace Autoscheduler {
@@ -7,6 +9,60 @@ namespace Autoscheduler {
 using std::map;
 using std::pair;
 
+namespace {
+
+// Get the HL_FEATURE_CACHE_SIZE environment variable. Purpose of this
+// is described on the FeaturizationCache class.
+uint64_t get_feature_cache_size() {
+    string cache_size_str = get_env_variable("HL_FEATURE_CACHE_SIZE");
+    if (!cache_size_str.empty()) {
+        return (uint64_t)std::atoll(cache_size_str.c_str());
+    }
+    return (uint64_t)1 << 30;
+}
+
+}  // namespace
+
+FeaturizationCache::FeaturizationCache()
+    : max_bytes(get_feature_cache_size()) {
+}
+
+bool FeaturizationCache::lookup(uint64_t hash, StageMap<ScheduleFeatures> *features) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = cache.find(hash);
+    if (it == cache.end()) {
+        num_misses++;
+        return false;
+    }
+    num_hits++;
+    *features = it->second;
+    return true;
+}
+
+void FeaturizationCache::store(uint64_t hash, const StageMap<ScheduleFeatures> &features) {
+    std::lock_guard<std::mutex> lock(mutex);
+    const uint64_t entry_size = (uint64_t)features.size() * sizeof(ScheduleFeatures);
+    if (bytes_used + entry_size > max_bytes) {
+        // Full. Keep what we already have: the states cached earliest
+        // are the ones nearest the root of the search tree, which are
+        // also the ones most likely to be revisited by a later pass.
+        return;
+    }
+    if (cache.emplace(hash, features).second) {
+        bytes_used += entry_size;
+    }
+}
+
+uint64_t FeaturizationCache::hits() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return num_hits;
+}
+
+uint64_t FeaturizationCache::misses() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return num_misses;
+}
+
 uint64_t State::structural_hash(int depth) const {
     uint64_t h = num_decisions_made;
     internal_assert(root.defined());
@@ -115,9 +171,32 @@ void State::save_featurization(const FunctionDAG &dag, const MachineParams &para
 }
 
 bool State::calculate_cost(const FunctionDAG &dag, const MachineParams &params,
-                           CostModel *cost_model, int64_t memory_limit, bool verbose) {
+                           CostModel *cost_model, int64_t memory_limit,
+                           FeaturizationCache *feature_cache, bool verbose) {
+    if (feature_cache && !feature_cache->enabled()) {
+        feature_cache = nullptr;
+    }
+
     StageMap<ScheduleFeatures> features;
-    compute_featurization(dag, params, &features);
+
+    uint64_t hash = 0;
+    bool cached = false;
+    if (feature_cache) {
+        // Hash the entire loop nest structure. Structurally identical
+        // states, which recur across the coarse-to-fine passes of the
+        // search, have identical featurizations. A 64-bit hash
+        // collision would serve the wrong featurization here, but
+        // it's vanishingly unlikely, and the stakes are low: a
+        // mis-costed candidate schedule.
+        hash = structural_hash(std::numeric_limits<int>::max());
+        cached = feature_cache->lookup(hash, &features);
+    }
+    if (!cached) {
+        compute_featurization(dag, params, &features);
+        if (feature_cache) {
+            feature_cache->store(hash, features);
+        }
+    }
 
     cost = 0.0f;
 
@@ -193,6 +272,7 @@ void State::generate_children(const FunctionDAG &dag,
                               const MachineParams &params,
                               CostModel *cost_model,
                               int64_t memory_limit,
+                              FeaturizationCache *feature_cache,
                               std::function<void(IntrusivePtr<State> &&)> &accept_child) const {
 
     internal_assert(root.defined() && root->is_root()) << "generate_children needs defined root\n";
@@ -250,15 +330,18 @@ void State::generate_children(const FunctionDAG &dag,
     if (phase == 0) {
         // Injecting realizations
         {
-            // 1) Inline it
-            if (node->stages.size() == 1 && !node->is_output) {
+            // 1) Inline it. Extern stages can't be inlined, and
+            // inlining a memoized Func would silently discard its
+            // cache.
+            if (node->stages.size() == 1 && !node->is_output &&
+                !node->is_extern && !node->is_memoized) {
                 auto child = make_child();
                 LoopNest *new_root = new LoopNest;
                 new_root->copy_from(*root);
                 new_root->inline_func(node);
                 child->root = new_root;
                 child->num_decisions_made++;
-                if (child->calculate_cost(dag, params, cost_model, memory_limit)) {
+                if (child->calculate_cost(dag, params, cost_model, memory_limit, feature_cache)) {
                     num_children++;
                     accept_child(std::move(child));
                 }
@@ -316,6 +399,13 @@ void State::generate_children(const FunctionDAG &dag,
             }
         }
 
+        if (node->is_extern) {
+            // The extern stage's own loops can't be vectorized, so
+            // there's only one meaningful choice of vector dim.
+            vector_dims.clear();
+            vector_dims.push_back(0);
+        }
+
         if (vector_dims.empty()) {
             // This can happen if the output strides aren't known, or if all
             // the dimensions are smaller than the vector size.
@@ -340,7 +430,7 @@ void State::generate_children(const FunctionDAG &dag,
                 auto child = make_child();
                 child->root = std::move(n);
                 child->num_decisions_made++;
-                if (child->calculate_cost(dag, params, cost_model, memory_limit)) {
+                if (child->calculate_cost(dag, params, cost_model, memory_limit, feature_cache)) {
                     num_children++;
                     accept_child(std::move(child));
                 }
@@ -351,7 +441,9 @@ void State::generate_children(const FunctionDAG &dag,
 
         bool should_parallelize = false;
         const vector<int64_t> *pure_size = nullptr;
-        if (params.parallelism > 1) {
+        // Don't parallelize the loops of an extern stage; any
+        // parallelism is internal to its implementation.
+        if (params.parallelism > 1 && !node->is_extern) {
             for (const auto &c : root->children) {
                 if (c->node == node && node->dimensions > 0) {
                     if (c->stage->index == 0) {
@@ -494,7 +586,7 @@ void State::generate_children(const FunctionDAG &dag,
                 }
                 child->root = new_root;
                 child->num_decisions_made++;
-                if (child->calculate_cost(dag, params, cost_model, memory_limit)) {
+                if (child->calculate_cost(dag, params, cost_model, memory_limit, feature_cache)) {
                     num_children++;
                     accept_child(std::move(child));
                 }
@@ -520,7 +612,7 @@ void State::dump() const {
 // Apply the schedule represented by this state to a Halide
 // Pipeline. Also generate source code for the schedule for the
 // user to copy-paste to freeze this schedule as permanent artifact.
-void State::apply_schedule(const FunctionDAG &dag, const MachineParams &params) {
+void State::apply_schedule(const FunctionDAG &dag, const MachineParams &params, const Target &target) {
     StageMap<std::unique_ptr<LoopNest::StageScheduleState>> state_map;
     root->apply(LoopLevel::root(), state_map, params.parallelism, 0, nullptr, nullptr);
 
@@ -535,37 +627,23 @@ void State::apply_schedule(const FunctionDAG &dag, const MachineParams &params)
         i--;
     }
 
-    // Gather all Vars and RVars so that we can declare them in the emitted source
-    map<string, string> vars, rvars;
+    // Gather all Vars and RVars so that we can declare them in the
+    // emitted source. Mapping loops onto the GPU below may mint
+    // additional ones.
+    map<string, string> var_decls, rvar_decls;
     for (auto &p : state_map) {
         for (auto &v : p.second->vars) {
             if (v.exists) {
                 if (v.var.is_rvar) {
-                    rvars.emplace(v.var.name(), v.accessor);
+                    rvar_decls.emplace(v.var.name(), v.accessor);
                 } else {
-                    vars.emplace(v.var.name(), v.accessor);
+                    var_decls.emplace(v.var.name(), v.accessor);
                 }
             }
         }
     }
-    if (!vars.empty()) {
-        for (const auto &p : vars) {
-            if (p.second.empty()) {
-                src << "Var " << p.first << "(\"" << p.first << "\");\n";
-            } else {
-                src << "Var " << p.first << "(" << p.second << ");\n";
-            }
-        }
-    }
-    if (!rvars.empty()) {
-        for (const auto &p : rvars) {
-            if (p.second.empty()) {
-                src << "RVar " << p.first << "(\"" << p.first << "\");\n";
-            } else {
-                src << "RVar " << p.first << "(" << p.second << ");\n";
-            }
-        }
-    }
+
+    std::ostringstream stage_src;
 
     for (auto &p : state_map) {
         if (p.first->node->is_input) {
@@ -574,6 +652,16 @@ void State::apply_schedule(const FunctionDAG &dag, const MachineParams &params)
 
         Stage stage(p.first->stage);
 
+        if (p.first->node->is_extern) {
+            // Extern stages only get a compute/store level; their
+            // loops are not ours to reorder, vectorize, or
+            // parallelize.
+            stage_src << p.first->name
+                      << p.second->schedule_source.str()
+                      << ";\n";
+            continue;
+        }
+
         // Do all the reorders and pick which vars to
         // parallelize.
         vector<VarOrRVar> vars;
@@ -625,13 +713,50 @@ void State::apply_schedule(const FunctionDAG &dag, const MachineParams &params)
                 stage.fuse(parallel_vars[i], parallel_vars[i - 1], parallel_vars[i]);
             }
             if (!parallel_vars.empty()) {
-                p.second->schedule_source << "\n    .parallel(" << parallel_vars.back().name() << ")";
-                stage.parallel(parallel_vars.back());
+                if (target.has_gpu_feature()) {
+                    // Map the fused parallel loop onto GPU blocks and
+                    // threads instead. Aim for a reasonable block
+                    // size, while keeping plenty of blocks around to
+                    // fill the machine.
+                    VarOrRVar v = parallel_vars.back();
+                    int threads = 1;
+                    while (threads < 128 && threads * 32 <= parallel_tasks) {
+                        threads *= 2;
+                    }
+                    if (threads == 1) {
+                        p.second->schedule_source << "\n    .gpu_blocks(" << v.name() << ")";
+                        stage.gpu_blocks(v);
+                    } else {
+                        VarOrRVar thread_var(v.name() + "_thread", v.is_rvar);
+                        if (v.is_rvar) {
+                            rvar_decls.emplace(thread_var.name(), "");
+                        } else {
+                            var_decls.emplace(thread_var.name(), "");
+                        }
+                        p.second->schedule_source << "\n    .gpu_tile(" << v.name() << ", " << v.name()
+                                                  << ", " << thread_var.name() << ", " << threads
+                                                  << ", TailStrategy::GuardWithIf)";
+                        stage.gpu_tile(v, v, thread_var, threads, TailStrategy::GuardWithIf);
+                    }
+                } else {
+                    p.second->schedule_source << "\n    .parallel(" << parallel_vars.back().name() << ")";
+                    stage.parallel(parallel_vars.back());
+                }
             }
         } else {
-            for (const auto &v : parallel_vars) {
-                p.second->schedule_source << "\n    .parallel(" << v.name() << ")";
-                stage.parallel(v);
+            if (target.has_gpu_feature()) {
+                // We can't fuse the parallel RVars and Vars into a
+                // single loop to tile, so just map them (up to the
+                // limit of three grid dimensions) onto GPU blocks.
+                for (size_t i = 0; i < parallel_vars.size() && i < 3; i++) {
+                    p.second->schedule_source << "\n    .gpu_blocks(" << parallel_vars[i].name() << ")";
+                    stage.gpu_blocks(parallel_vars[i]);
+                }
+            } else {
+                for (const auto &v : parallel_vars) {
+                    p.second->schedule_source << "\n    .parallel(" << v.name() << ")";
+                    stage.parallel(v);
+                }
             }
         }
 
@@ -655,10 +780,31 @@ void State::apply_schedule(const FunctionDAG &dag, const MachineParams &params)
         }
 
         // Dump the schedule source string
-        src << p.first->name
-            << p.second->schedule_source.str()
-            << ";\n";
+        stage_src << p.first->name
+                  << p.second->schedule_source.str()
+                  << ";\n";
+    }
+
+    if (!var_decls.empty()) {
+        for (const auto &p : var_decls) {
+            if (p.second.empty()) {
+                src << "Var " << p.first << "(\"" << p.first << "\");\n";
+            } else {
+                src << "Var " << p.first << "(" << p.second << ");\n";
+            }
+        }
     }
+    if (!rvar_decls.empty()) {
+        for (const auto &p : rvar_decls) {
+            if (p.second.empty()) {
+                src << "RVar " << p.first << "(\"" << p.first << "\");\n";
+            } else {
+                src << "RVar " << p.first << "(" << p.second << ");\n";
+            }
+        }
+    }
+    src << stage_src.str();
+
     // Sanitize the names of things to make them legal source code.
     schedule_source = src.str();
     bool in_quotes = false;
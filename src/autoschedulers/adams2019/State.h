@@ -8,13 +8,51 @@
 #include "Halide.h"
 #include "LoopNest.h"
 #include "PerfectHashMap.h"
+#include <atomic>
 #include <map>
+#include <mutex>
 #include <utility>
 
 namespace Halide {
 namespace Internal {
 namespace Autoscheduler {
 
+// A cache of the featurizations of states already visited during the
+// search, keyed by the structural hash of their loop nest. The
+// coarse-to-fine passes of beam search re-explore much of the same
+// space, and featurization dominates the cost of a pass, so repeated
+// featurizations can be served from the cache instead. Thread-safe.
+// Bounded by HL_FEATURE_CACHE_SIZE bytes (1GB by default); set it to
+// zero to disable caching.
+class FeaturizationCache {
+    std::map<uint64_t, StageMap<ScheduleFeatures>> cache;
+    mutable std::mutex mutex;
+    uint64_t bytes_used = 0, num_hits = 0, num_misses = 0;
+    const uint64_t max_bytes;
+
+public:
+    FeaturizationCache();
+
+    // Caching can be disabled entirely with HL_FEATURE_CACHE_SIZE=0,
+    // in which case there's no point hashing states either.
+    bool enabled() const {
+        return max_bytes > 0;
+    }
+
+    // If a featurization with the given hash is in the cache, copy it
+    // into 'features' and return true.
+    bool lookup(uint64_t hash, StageMap<ScheduleFeatures> *features);
+
+    // Add a featurization to the cache, if there is budget remaining
+    // for it.
+    void store(uint64_t hash, const StageMap<ScheduleFeatures> &features);
+
+    // The number of lookups served from / missing from the cache, for
+    // logging.
+    uint64_t hits() const;
+    uint64_t misses() const;
+};
+
 // A struct representing an intermediate state in the tree search.
 // It represents a partial schedule for some pipeline.
 struct State {
@@ -35,8 +73,9 @@ struct State {
     string schedule_source;
 
     // The number of times a cost is enqueued into the cost model,
-    // for all states.
-    static int cost_calculations;
+    // for all states. Incremented from multiple threads when the
+    // beam is expanded in parallel.
+    static std::atomic<int> cost_calculations;
 
     State() = default;
     State(const State &) = delete;
@@ -62,8 +101,12 @@ struct State {
     // Performs some pruning to decide if this state is worth queuing in
     // the cost_model. If it is, calls `cost_model->enqueue` and returns true,
     // otherwise sets `cost` equal to a large value and returns false.
+    // If `feature_cache` is non-null, the featurization is served
+    // from it when a structurally identical state has been visited
+    // before.
     bool calculate_cost(const FunctionDAG &dag, const MachineParams &params,
                         CostModel *cost_model, int64_t memory_limit,
+                        FeaturizationCache *feature_cache = nullptr,
                         bool verbose = false);
 
     // Make a child copy of this state. The loop nest is const (we
@@ -79,6 +122,7 @@ struct State {
                            const MachineParams &params,
                            CostModel *cost_model,
                            int64_t memory_limit,
+                           FeaturizationCache *feature_cache,
                            std::function<void(IntrusivePtr<State> &&)> &accept_child) const;
 
     // Dumps cost, the `root` LoopNest, and then `schedule_source` to `aslog(0)`.
@@ -87,8 +131,10 @@ struct State {
     // Apply the schedule represented by this state to a Halide
     // Pipeline. Also generate source code for the schedule for the
     // user to copy-paste to freeze this schedule as permanent artifact.
-    // Also fills `schedule_source`.
-    void apply_schedule(const FunctionDAG &dag, const MachineParams &params);
+    // Also fills `schedule_source`. On GPU targets, the parallel
+    // loops of each compute_root stage are mapped onto GPU blocks and
+    // threads rather than CPU threads.
+    void apply_schedule(const FunctionDAG &dag, const MachineParams &params, const Target &target);
 };
 
 }  // namespace Autoscheduler
@@ -0,0 +1,403 @@
+// A self-contained autotuning loop for the adams2019 autoscheduler,
+// replacing the old autotune_loop.sh script. Each batch it:
+//
+//   1. Samples schedules for a generator from the search space. The
+//      first sample in a batch is best-effort beam search with no
+//      randomness; the rest are random probes biased by the current
+//      cost model (beam size 1 with random dropout).
+//   2. Builds each sample into a benchmarking binary using the RunGen
+//      infrastructure, and benchmarks it on the device.
+//   3. Retrains the cost model on all samples measured so far using
+//      the retrain_cost_model tool, which also tracks the best
+//      schedule seen, leaving it in best.<pipeline>.schedule.h (and
+//      its runtime in best.<pipeline>.benchmark.txt) in the samples
+//      directory.
+//
+// Samples persist across runs: re-running with the same samples
+// directory continues from where the previous run left off, with the
+// updated weights.
+//
+// This tool shells out for subprocess control, like the script it
+// replaces, and so expects a POSIX system. On macOS, GNU coreutils
+// provides the 'timeout' command as 'gtimeout' (pass
+// --timeout_cmd=gtimeout), or pass --compile_timeout=0
+// --benchmark_timeout=0 to not use timeouts at all.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Halide.h"
+#include "cmdline.h"
+
+namespace {
+
+namespace fs = std::filesystem;
+
+using std::string;
+using std::vector;
+
+#ifdef __APPLE__
+constexpr const char *kSharedExt = "dylib";
+#else
+constexpr const char *kSharedExt = "so";
+#endif
+
+struct Flags {
+    string generator;        // Path to the generator binary to autotune
+    string pipeline;         // Name of the generator to autotune
+    string target;           // Halide target string to compile for
+    string initial_weights;  // Weights to start training from
+    string bin_dir;          // Directory containing the autoscheduler binaries
+    string halide_dir;       // Path to the Halide distribution
+    string samples_dir = "samples";
+    string generator_args;  // Extra args to pass to the generator
+    string cxx = "c++";
+    string timeout_cmd = "timeout";
+    int batches = 1;
+    int batch_size = 32;
+    int parallelism = 32;
+    int compile_timeout = 600;   // seconds; 0 disables the timeout
+    int benchmark_timeout = 60;  // seconds; 0 disables the timeout
+
+    Flags(int argc, char **argv) {
+        cmdline::parser a;
+
+        constexpr bool kOptional = false;
+
+        a.add<string>("generator", '\0', "Path to the generator binary to autotune");
+        a.add<string>("pipeline", '\0', "Name of the generator to autotune");
+        a.add<string>("target", '\0', "Halide target string. Defaults to the host target, without AVX-512", kOptional, "");
+        a.add<string>("initial_weights", '\0', "Weights to start training from (e.g. baseline.weights). Only needed when the samples directory doesn't already contain updated weights", kOptional, "");
+        a.add<string>("bin", '\0', "Directory containing libautoschedule_adams2019, featurization_to_sample and retrain_cost_model");
+        a.add<string>("halide_dir", '\0', "Path to the Halide distribution (for RunGenMain.cpp and the headers)");
+        a.add<string>("samples", '\0', "Directory to store samples in", kOptional, "samples");
+        a.add<string>("generator_args", '\0', "Extra args to pass to the generator", kOptional, "");
+        a.add<string>("cxx", '\0', "C++ compiler used to build the benchmarking binaries", kOptional, "c++");
+        a.add<string>("timeout_cmd", '\0', "Command used to impose the timeouts below", kOptional, "timeout");
+        a.add<int>("batches", '\0', "Number of batches to sample, benchmark, and retrain on", kOptional, 1);
+        a.add<int>("batch_size", '\0', "Number of samples per batch", kOptional, 32);
+        a.add<int>("parallelism", '\0', "Number of cores to schedule and benchmark for", kOptional, 32);
+        a.add<int>("compile_timeout", '\0', "Seconds to allow each sample to compile for. 0 means no timeout", kOptional, 600);
+        a.add<int>("benchmark_timeout", '\0', "Seconds to allow each sample to benchmark for. 0 means no timeout", kOptional, 60);
+
+        a.parse_check(argc, argv);  // exits if parsing fails
+
+        generator = a.get<string>("generator");
+        pipeline = a.get<string>("pipeline");
+        target = a.get<string>("target");
+        initial_weights = a.get<string>("initial_weights");
+        bin_dir = a.get<string>("bin");
+        halide_dir = a.get<string>("halide_dir");
+        samples_dir = a.get<string>("samples");
+        generator_args = a.get<string>("generator_args");
+        cxx = a.get<string>("cxx");
+        timeout_cmd = a.get<string>("timeout_cmd");
+        batches = a.get<int>("batches");
+        batch_size = a.get<int>("batch_size");
+        parallelism = a.get<int>("parallelism");
+        compile_timeout = a.get<int>("compile_timeout");
+        benchmark_timeout = a.get<int>("benchmark_timeout");
+
+        if (target.empty()) {
+            // Use the host target, but remove features that we don't
+            // want to train for by default (most notably, AVX-512).
+            Halide::Target t = Halide::get_host_target();
+            for (auto f : {Halide::Target::AVX512,
+                           Halide::Target::AVX512_KNL,
+                           Halide::Target::AVX512_Skylake,
+                           Halide::Target::AVX512_Cannonlake}) {
+                t = t.without_feature(f);
+            }
+            target = t.to_string();
+        }
+        // Turning off LLVM's loop optimization makes the runtimes
+        // more strongly determined by the schedule, which is what we
+        // want to train on.
+        if (target.find("disable_llvm_loop_opt") == string::npos) {
+            target += "-disable_llvm_loop_opt";
+        }
+
+        if (batch_size <= 0 || batches <= 0 || parallelism <= 0) {
+            std::cerr << "--batches, --batch_size, and --parallelism must be > 0.\n";
+            exit(1);
+        }
+    }
+};
+
+// Quote a path for use in a shell command.
+string quoted(const string &s) {
+    return "\"" + s + "\"";
+}
+
+// Run a shell command, returning true on success. Failures are
+// expected here (e.g. a sample that doesn't terminate gets killed by
+// the timeout command), so they are reported by the caller, not here.
+bool run(const string &cmd) {
+    return std::system(cmd.c_str()) == 0;
+}
+
+string timeout_prefix(const Flags &flags, int seconds) {
+    if (seconds <= 0 || flags.timeout_cmd.empty()) {
+        return "";
+    }
+    std::ostringstream s;
+    s << flags.timeout_cmd << " -k " << seconds << "s " << seconds << "s ";
+    return s.str();
+}
+
+// Compile one sample of the pipeline with a random schedule, emitting
+// a static library, a RunGen registration file, and a featurization.
+bool make_featurization(const Flags &flags, const string &weights,
+                        const string &dir, const string &seed,
+                        const string &fname, bool best_effort) {
+    fs::create_directories(dir);
+    fs::remove(dir + "/" + fname + ".featurization");
+    fs::remove(dir + "/" + fname + ".sample");
+
+    // The best-effort sample uses beam search with no randomness; the
+    // rest are random probes biased by the cost model.
+    const int dropout = best_effort ? 100 : 1;
+    const int beam = best_effort ? 32 : 1;
+
+    std::ostringstream cmd;
+    cmd << "HL_SEED=" << seed
+        << " HL_WEIGHTS_DIR=" << quoted(weights)
+        << " HL_RANDOM_DROPOUT=" << dropout
+        << " HL_BEAM_SIZE=" << beam
+        << " HL_MACHINE_PARAMS=" << flags.parallelism << ",24000000,40 "
+        << timeout_prefix(flags, flags.compile_timeout)
+        << quoted(flags.generator)
+        << " -g " << flags.pipeline
+        << " -f " << fname
+        << " -o " << quoted(dir)
+        << " -e stmt,assembly,static_library,c_header,registration,schedule,featurization"
+        << " target=" << flags.target
+        << " auto_schedule=true";
+    if (!flags.generator_args.empty()) {
+        cmd << " " << flags.generator_args;
+    }
+    cmd << " -p " << quoted(flags.bin_dir + "/libautoschedule_adams2019." + kSharedExt)
+        << " -s Adams2019"
+        << " 2> " << quoted(dir + "/compile_log.txt");
+    if (!run(cmd.str())) {
+        std::cout << "Compilation failed or timed out for " << dir << "\n";
+        return false;
+    }
+
+    // Build a benchmarking binary for the sample using RunGen. We
+    // don't need image I/O for this purpose, so leave out libpng and
+    // libjpeg.
+    std::ostringstream link;
+    link << flags.cxx << " -std=c++17"
+         << " -I " << quoted(flags.halide_dir + "/include") << " "
+         << quoted(flags.halide_dir + "/tools/RunGenMain.cpp") << " "
+         << quoted(dir + "/" + fname + ".registration.cpp") << " "
+         << quoted(dir + "/" + fname + ".a")
+         << " -o " << quoted(dir + "/bench")
+         << " -DHALIDE_NO_PNG -DHALIDE_NO_JPEG -ldl -lpthread"
+         << " 2>> " << quoted(dir + "/compile_log.txt");
+    if (!run(link.str())) {
+        std::cout << "Building the benchmarking binary failed for " << dir << "\n";
+        return false;
+    }
+    return true;
+}
+
+// Benchmark one sample and append the measured runtime to its
+// featurization, producing a .sample file for retraining.
+void benchmark_sample(const Flags &flags, const string &dir,
+                      const string &fname, const string &schedule_id) {
+    // Give CPU clocks a chance to spin back up if we're thermally throttling.
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+
+    std::ostringstream cmd;
+    cmd << "HL_NUM_THREADS=" << flags.parallelism << " "
+        << timeout_prefix(flags, flags.benchmark_timeout)
+        << quoted(dir + "/bench")
+        << " --estimate_all --benchmarks=all"
+        << " > " << quoted(dir + "/bench.txt") << " 2>&1";
+    const bool ran = run(cmd.str());
+
+    // Pull the best-case runtime out of the RunGen output.
+    double runtime = 0;
+    {
+        std::ifstream f(dir + "/bench.txt");
+        string line;
+        const string marker = "best case of ";
+        while (std::getline(f, line)) {
+            size_t pos = line.find(marker);
+            if (pos != string::npos) {
+                runtime = std::atof(line.c_str() + pos + marker.size());
+                break;
+            }
+        }
+    }
+    if (!ran || runtime <= 0) {
+        std::cout << "Benchmarking failed or timed out for " << dir << "\n";
+        return;
+    }
+    std::cout << dir << ": " << runtime << " sec\n";
+
+    std::ostringstream sample;
+    sample << quoted(flags.bin_dir + "/featurization_to_sample") << " "
+           << quoted(dir + "/" + fname + ".featurization") << " "
+           << runtime << " 0 " << schedule_id << " "
+           << quoted(dir + "/" + fname + ".sample");
+    if (!run(sample.str())) {
+        std::cout << "featurization_to_sample failed for " << dir << "\n";
+    }
+}
+
+// Retrain the model weights on all samples seen so far. This also
+// updates the best-schedule-so-far files in the samples directory.
+void retrain(const Flags &flags, const string &weights) {
+    std::cout << "Retraining model...\n";
+
+    std::ostringstream cmd;
+    cmd << quoted(flags.bin_dir + "/retrain_cost_model")
+        << " --epochs=" << flags.batch_size
+        << " --rates=0.0001"
+        << " --num_cores=" << flags.parallelism
+        << " --initial_weights=" << quoted(weights)
+        << " --weights_out=" << quoted(weights)
+        << " --best_benchmark=" << quoted(flags.samples_dir + "/best." + flags.pipeline + ".benchmark.txt")
+        << " --best_schedule=" << quoted(flags.samples_dir + "/best." + flags.pipeline + ".schedule.h");
+
+    // retrain_cost_model reads the sample paths from stdin.
+    FILE *p = popen(cmd.str().c_str(), "w");
+    if (!p) {
+        std::cerr << "Could not launch retrain_cost_model\n";
+        exit(1);
+    }
+    for (const auto &entry : fs::recursive_directory_iterator(flags.samples_dir)) {
+        if (entry.path().extension() == ".sample") {
+            fprintf(p, "%s\n", entry.path().string().c_str());
+        }
+    }
+    if (pclose(p) != 0) {
+        std::cerr << "retrain_cost_model failed\n";
+        exit(1);
+    }
+}
+
+// Samples persist across runs of this tool, so find the index of the
+// last batch already present in the samples directory.
+int last_batch_id(const string &samples_dir) {
+    int last = 0;
+    for (const auto &entry : fs::directory_iterator(samples_dir)) {
+        const string name = entry.path().filename().string();
+        if (name.rfind("batch_", 0) == 0) {
+            last = std::max(last, std::atoi(name.c_str() + 6));
+        }
+    }
+    return last;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    Flags flags(argc, argv);
+
+    std::cout << "Training target is: " << flags.target << "\n";
+
+    fs::create_directories(flags.samples_dir);
+
+    // Only copy over the initial weights if we don't have any
+    // already, so that restarted jobs continue where they left off.
+    const string weights = flags.samples_dir + "/updated.weights";
+    if (fs::exists(weights)) {
+        std::cout << "Using existing weights " << weights << "\n";
+    } else {
+        if (flags.initial_weights.empty() || !fs::exists(flags.initial_weights)) {
+            std::cerr << "No weights at " << weights
+                      << "; pass starting weights (e.g. baseline.weights) with --initial_weights\n";
+            return 1;
+        }
+        std::cout << "Copying starting weights from " << flags.initial_weights
+                  << " to " << weights << "\n";
+        fs::copy_file(flags.initial_weights, weights);
+    }
+
+    const int first = last_batch_id(flags.samples_dir);
+    const int local_cores = std::max(1u, std::thread::hardware_concurrency());
+
+    for (int batch_id = first + 1; batch_id <= first + flags.batches; batch_id++) {
+        const auto batch_start = std::chrono::steady_clock::now();
+
+        const string dir = flags.samples_dir + "/batch_" + std::to_string(batch_id) + "_0";
+        fs::create_directories(dir);
+
+        // Copy the weights being used into the batch folder so that
+        // we can repro failures.
+        fs::copy_file(weights, dir + "/used.weights", fs::copy_options::overwrite_existing);
+
+        auto sample_name = [&](int sample_id) {
+            char buf[1024];
+            snprintf(buf, sizeof(buf), "%s_batch_%04d_sample_%04d",
+                     flags.pipeline.c_str(), batch_id, sample_id);
+            return string(buf);
+        };
+        auto schedule_id = [&](int sample_id) {
+            char buf[32];
+            snprintf(buf, sizeof(buf), "%04d%04d", batch_id, sample_id);
+            return string(buf);
+        };
+
+        // Compile the samples in parallel, with at most one job per
+        // local core so that machines with fewer cores than the batch
+        // size don't get swamped and time out unnecessarily.
+        std::cout << "Compiling " << flags.batch_size << " samples\n";
+        vector<char> ok(flags.batch_size, 0);
+        std::atomic<int> next_sample{0};
+        auto compile_some = [&]() {
+            int sample_id;
+            while ((sample_id = next_sample++) < flags.batch_size) {
+                const string sample_dir = dir + "/" + std::to_string(sample_id);
+                ok[sample_id] = make_featurization(flags, weights, sample_dir,
+                                                   schedule_id(sample_id),
+                                                   sample_name(sample_id),
+                                                   /*best_effort=*/sample_id == 0);
+            }
+        };
+        {
+            vector<std::thread> threads;
+            for (int t = 0; t < std::min(local_cores, flags.batch_size); t++) {
+                threads.emplace_back(compile_some);
+            }
+            for (auto &t : threads) {
+                t.join();
+            }
+        }
+
+        // Benchmark them serially.
+        for (int sample_id = 0; sample_id < flags.batch_size; sample_id++) {
+            if (!ok[sample_id]) {
+                continue;
+            }
+            benchmark_sample(flags, dir + "/" + std::to_string(sample_id),
+                             sample_name(sample_id), schedule_id(sample_id));
+        }
+
+        // Retrain the model weights on all samples seen so far.
+        retrain(flags, weights);
+
+        const auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::steady_clock::now() - batch_start);
+        std::cout << "Batch " << batch_id << " took " << elapsed.count()
+                  << " seconds to compile, benchmark, and retrain\n";
+    }
+
+    std::cout << "Best schedule is at " << flags.samples_dir << "/best."
+              << flags.pipeline << ".schedule.h\n";
+    return 0;
+}
@@ -125,6 +125,7 @@ public:
     using Output = GeneratorOutput<T>;
     using Generator<CostModel<training>>::auto_schedule;
     using Generator<CostModel<training>>::get_pipeline;
+    using Generator<CostModel<training>>::get_target;
 
     // Number of pipeline stages
     Input<int> num_stages{"num_stages", 1};
@@ -486,6 +487,34 @@ public:
             do_cost_model_schedule(get_pipeline());
         } else if (auto_schedule) {
             // Do nothing.
+        } else if (get_target().has_gpu_feature()) {
+            // An inference schedule for GPUs. The network is small
+            // enough that the entire forwards path for one batch
+            // element fits comfortably in a single GPU thread, so we
+            // just launch one thread per batch element. This only
+            // pays off for large batches; callers should batch
+            // featurization rows across beam search states as
+            // aggressively as they can.
+            Var no, ni;
+            prediction_output
+                .compute_root()
+                .gpu_tile(n, no, ni, 64, TailStrategy::GuardWithIf);
+            prediction_output.bound(n, 0, batch_size);
+
+            // The embedding of the algorithm-specific features is
+            // shared by the whole batch and is a trivial amount of
+            // work, so it stays on the host and gets copied to the
+            // device once per batch.
+            conv1_stage1.compute_root().vectorize(c);
+            squashed_head1_filter.compute_root().vectorize(c);
+
+            // The batch-dependent funcs are computed within each
+            // thread. head2_conv, conv1_stage2 and prediction are
+            // inline reductions, computed at the innermost loop of
+            // their consumers.
+            normalized_schedule_features.compute_at(prediction_output, ni);
+            head2_relu.compute_at(prediction_output, ni);
+            relu1.compute_at(prediction_output, ni);
         } else {
             // We just write down a good schedule for
             // inference. Scheduling a couple of convs is easy.
@@ -48,7 +48,7 @@ void test_coeff_wise(const MachineParams &params, const Target &target) {
             input_type,
             vars,
             Halide::NameMangling::C);
-        g.function().extern_definition_proxy_expr() = f(x, y) * 2.0f;
+        g.extern_definition_proxy(f(x, y) * 2.0f);
 
         h(x, y) = g(x, y) * 2 + 1;
 
@@ -133,7 +133,7 @@ void test_matmul(const MachineParams &params, const Target &target) {
             {input_type, input_type},
             vars,
             Halide::NameMangling::C);
-        mm.function().extern_definition_proxy_expr() = Halide::sum(input1(x, r) * input2(r, y));
+        mm.extern_definition_proxy(Halide::sum(input1(x, r) * input2(r, y)));
 
         h(x, y) = mm(x, y);
 
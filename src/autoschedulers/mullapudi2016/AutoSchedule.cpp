@@ -1062,6 +1062,12 @@ struct Partitioner {
     // Output functions of the pipeline.
     const vector<Function> &outputs;
 
+    // Approximate hierarchical grouping, enabled by setting
+    // HL_MULLAPUDI_FAST_GROUPING. Setting it to an integer greater than one
+    // overrides the maximum number of functions per region.
+    bool hierarchical_grouping = false;
+    int max_region_size = 16;
+
     Partitioner(const map<string, Box> &_pipeline_bounds,
                 const MachineParams &_arch_params,
                 const vector<Function> &_outputs,
@@ -1093,9 +1099,23 @@ struct Partitioner {
     map<FStage, map<FStage, DimBounds>> group_loop_bounds();
 
     // Partition the pipeline by iteratively merging groups until a fixpoint is
-    // reached.
+    // reached. With HL_MULLAPUDI_FAST_GROUPING set, first runs the merging
+    // restricted to clusters of connected functions of bounded size, then
+    // finishes with an unrestricted pass over the coarsened graph; on large
+    // graphs this is much faster than running the quadratic-ish fixpoint
+    // globally, at some cost in schedule quality.
     void group(Partitioner::Level level);
 
+    // The fixpoint merging loop underlying 'group'. If 'regions' is non-null,
+    // only grouping candidates whose functions lie in the same region are
+    // considered.
+    void group_impl(Partitioner::Level level, const map<string, int> *regions);
+
+    // Cluster the pipeline's functions into connected regions of at most
+    // 'max_region_size' functions, for hierarchical grouping on very large
+    // graphs. Returns a map from function name to region id.
+    map<string, int> cluster_into_regions();
+
     // Given a grouping choice, return a configuration for the group that gives
     // the highest estimated benefits.
     GroupConfig evaluate_choice(const GroupingChoice &group, Partitioner::Level level);
@@ -1358,6 +1378,15 @@ Partitioner::Partitioner(const map<string, Box> &_pipeline_bounds,
             }
         }
     }
+
+    string fast_grouping = get_env_variable("HL_MULLAPUDI_FAST_GROUPING");
+    if (!fast_grouping.empty()) {
+        hierarchical_grouping = true;
+        int cap = atoi(fast_grouping.c_str());
+        if (cap > 1) {
+            max_region_size = cap;
+        }
+    }
 }
 
 void Partitioner::initialize_groups() {
@@ -1626,7 +1655,78 @@ Partitioner::find_best_tile_config(const Group &g) {
     return make_pair(best_config, best_analysis);
 }
 
+map<string, int> Partitioner::cluster_into_regions() {
+    // Union-find over the functions in the pipeline graph, with a cap on
+    // region size so that the restricted grouping fixpoint stays cheap.
+    map<string, string> parent;
+    map<string, int> region_size;
+    for (const pair<const FStage, Group> &g : groups) {
+        parent.emplace(g.first.func.name(), g.first.func.name());
+        region_size.emplace(g.first.func.name(), 1);
+    }
+
+    auto find_root = [&parent](string f) {
+        while (get_element(parent, f) != f) {
+            // Path halving.
+            string &p = get_element(parent, f);
+            p = get_element(parent, p);
+            f = p;
+        }
+        return f;
+    };
+
+    for (const auto &c : children) {
+        const string &prod = c.first.func.name();
+        if (!parent.count(prod)) {
+            continue;
+        }
+        for (const FStage &s : c.second) {
+            const string &cons = s.func.name();
+            if (!parent.count(cons)) {
+                continue;
+            }
+            string prod_root = find_root(prod);
+            string cons_root = find_root(cons);
+            if (prod_root == cons_root) {
+                continue;
+            }
+            int merged_size = get_element(region_size, prod_root) +
+                              get_element(region_size, cons_root);
+            if (merged_size > max_region_size) {
+                continue;
+            }
+            get_element(parent, prod_root) = cons_root;
+            get_element(region_size, cons_root) = merged_size;
+        }
+    }
+
+    map<string, int> regions;
+    map<string, int> root_ids;
+    for (const auto &p : parent) {
+        string root = find_root(p.first);
+        auto iter = root_ids.emplace(root, (int)root_ids.size());
+        regions.emplace(p.first, iter.first->second);
+    }
+
+    debug(3) << "Clustered " << regions.size() << " functions into "
+             << root_ids.size() << " regions\n";
+
+    return regions;
+}
+
 void Partitioner::group(Partitioner::Level level) {
+    if (hierarchical_grouping) {
+        // Coarsen the graph by merging within connected regions of bounded
+        // size first. The unrestricted pass below then starts from far
+        // fewer groups, which is what makes this fast; merges that cross
+        // region boundaries are only considered in that second pass.
+        map<string, int> regions = cluster_into_regions();
+        group_impl(level, &regions);
+    }
+    group_impl(level, nullptr);
+}
+
+void Partitioner::group_impl(Partitioner::Level level, const map<string, int> *regions) {
     bool fixpoint = false;
     while (!fixpoint) {
         Cost pre_merge = get_pipeline_cost();
@@ -1667,13 +1767,35 @@ void Partitioner::group(Partitioner::Level level) {
                 // when grouping for computing in tiles.
                 // TODO: The current scheduling model does not allow functions
                 // to be computed at different points.
+                // When grouping hierarchically, only consider candidates
+                // whose functions all lie in the same region.
+                bool same_region = true;
+                if (regions) {
+                    const auto &prod_iter = regions->find(prod_f.name());
+                    same_region = (prod_iter != regions->end());
+                    for (const string &c : child_groups) {
+                        if (!same_region) {
+                            break;
+                        }
+                        const auto &cons_iter = regions->find(c);
+                        if (cons_iter == regions->end() ||
+                            cons_iter->second != prod_iter->second) {
+                            same_region = false;
+                        }
+                    }
+                }
+
                 if ((num_children == 1) && (level == Partitioner::Level::FastMem)) {
                     const string &prod_name = prod_f.name();
                     const string &cons_name = (*child_groups.begin());
-                    cand.emplace_back(prod_name, cons_name);
+                    if (same_region) {
+                        cand.emplace_back(prod_name, cons_name);
+                    }
                 } else if ((level == Partitioner::Level::Inline) && prod_f.is_pure()) {
                     const string &prod_name = prod_f.name();
-                    cand.emplace_back(prod_name, "");
+                    if (same_region) {
+                        cand.emplace_back(prod_name, "");
+                    }
                 }
             }
         }
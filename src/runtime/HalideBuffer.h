@@ -13,6 +13,7 @@
 #include <cstring>
 #include <limits>
 #include <memory>
+#include <thread>
 #include <vector>
 
 #if defined(__has_feature)
@@ -23,6 +24,13 @@
 
 #include "HalideRuntime.h"
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #ifdef _MSC_VER
 #include <malloc.h>
 #define HALIDE_ALLOCA _alloca
@@ -30,6 +38,19 @@
 #define HALIDE_ALLOCA __builtin_alloca
 #endif
 
+// Buffer::allocate conservatively aligns allocations to this many
+// bytes, which is enough for all the platforms we might use. Define
+// it to a larger power of two to match a stricter allocation policy.
+#ifndef HALIDE_RUNTIME_BUFFER_ALLOCATION_ALIGNMENT
+#define HALIDE_RUNTIME_BUFFER_ALLOCATION_ALIGNMENT 128
+#endif
+
+// On Linux, define HALIDE_RUNTIME_BUFFER_HUGE_PAGE_THRESHOLD to a
+// byte count to make Buffer::allocate serve requests of at least that
+// size from an anonymous mmap backed by 2MB huge pages (pre-reserved
+// ones when available, transparent ones otherwise), instead of the
+// default allocator. Cuts TLB pressure for very large images.
+
 // gcc 5.1 has a false positive warning on this code
 #if __GNUC__ == 5 && __GNUC_MINOR__ == 1
 #pragma GCC diagnostic ignored "-Warray-bounds"
@@ -89,6 +110,37 @@ struct AllocationHeader {
     }
 };
 
+#ifndef _WIN32
+namespace Internal {
+/** The allocation header used for file-backed Buffers. It records the
+ * mapped region, which may start before the host pointer because mmap
+ * requires a page-aligned file offset. The AllocationHeader must come
+ * first: decref hands its address to the deallocate_fn. */
+struct FileMappingHeader {
+    AllocationHeader header;
+    void *mapping;
+    size_t length;
+};
+
+inline void unmap_file_allocation(void *ptr) {
+    FileMappingHeader *header = (FileMappingHeader *)ptr;
+    ::munmap(header->mapping, header->length);
+    free(header);
+}
+}  // namespace Internal
+
+/** A hint describing how a pipeline will walk a file-backed Buffer,
+ * forwarded to the OS via madvise. The access pattern the compiler
+ * knows statically isn't visible at runtime, so callers that know how
+ * the consuming loop nest is scheduled should say so here. */
+enum struct FileMappingHint : int {
+    None,        ///> No advice; the OS readahead heuristics apply.
+    Sequential,  ///> The buffer is scanned in storage order (MADV_SEQUENTIAL).
+    Random,      ///> Accesses are scattered, so readahead is wasted (MADV_RANDOM).
+    WillNeed,    ///> The whole region is needed soon; fault it in eagerly (MADV_WILLNEED).
+};
+#endif
+
 /** This indicates how to deallocate the device for a Halide::Runtime::Buffer. */
 enum struct BufferDeviceOwnership : int {
     Allocated,               ///> halide_device_free will be called when device ref count goes to zero
@@ -770,9 +822,50 @@ public:
     }
 
     /** Allocate memory for this Buffer. Drops the reference to any
-     * owned memory. */
+     * owned memory. If pre_fault is true, every page of the new
+     * allocation is touched once before returning, so that first
+     * access doesn't pay soft page faults inside a timed region (the
+     * portable equivalent of mapping with MAP_POPULATE). */
     void allocate(void *(*allocate_fn)(size_t) = nullptr,
-                  void (*deallocate_fn)(void *) = nullptr) {
+                  void (*deallocate_fn)(void *) = nullptr,
+                  bool pre_fault = false) {
+        size_t size = size_in_bytes();
+        constexpr size_t alignment = HALIDE_RUNTIME_BUFFER_ALLOCATION_ALIGNMENT;
+        static_assert((alignment & (alignment - 1)) == 0,
+                      "HALIDE_RUNTIME_BUFFER_ALLOCATION_ALIGNMENT must be a power of two");
+#if defined(HALIDE_RUNTIME_BUFFER_HUGE_PAGE_THRESHOLD) && defined(__linux__)
+        if (!allocate_fn && size >= (size_t)HALIDE_RUNTIME_BUFFER_HUGE_PAGE_THRESHOLD) {
+            allocate_fn = [](size_t bytes) -> void * {
+                // Round up to whole huge pages and stash the mapped
+                // length at the base; the pointer handed back (and
+                // later passed to the deallocate_fn) is one alignment
+                // past it.
+                constexpr size_t huge_page_size = 2 * 1024 * 1024;
+                size_t length = (bytes + alignment + huge_page_size - 1) & ~(huge_page_size - 1);
+                void *base = MAP_FAILED;
+#ifdef MAP_HUGETLB
+                base = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+                if (base == MAP_FAILED) {
+                    base = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                    if (base == MAP_FAILED) {
+                        return nullptr;
+                    }
+#ifdef MADV_HUGEPAGE
+                    madvise(base, length, MADV_HUGEPAGE);
+#endif
+                }
+                ((size_t *)base)[0] = length;
+                return (void *)((uint8_t *)base + alignment);
+            };
+            deallocate_fn = [](void *ptr) {
+                uint8_t *base = (uint8_t *)ptr - alignment;
+                munmap(base, ((size_t *)base)[0]);
+            };
+        }
+#endif
         if (!allocate_fn) {
             allocate_fn = malloc;
         }
@@ -783,15 +876,21 @@ public:
         // Drop any existing allocation
         deallocate();
 
-        // Conservatively align images to 128 bytes. This is enough
-        // alignment for all the platforms we might use.
-        size_t size = size_in_bytes();
-        const size_t alignment = 128;
         size = (size + alignment - 1) & ~(alignment - 1);
         void *alloc_storage = allocate_fn(size + sizeof(AllocationHeader) + alignment - 1);
         alloc = new (alloc_storage) AllocationHeader(deallocate_fn);
         uint8_t *unaligned_ptr = ((uint8_t *)alloc) + sizeof(AllocationHeader);
         buf.host = (uint8_t *)((uintptr_t)(unaligned_ptr + alignment - 1) & ~(alignment - 1));
+        if (pre_fault) {
+            // Write each page's first byte back to itself; the
+            // volatile access can't be elided, and the write forces
+            // the OS to commit a private writable page.
+            constexpr size_t page_size = 4096;
+            volatile uint8_t *p = buf.host;
+            for (size_t i = 0; i < size; i += page_size) {
+                p[i] = p[i];
+            }
+        }
     }
 
     /** Drop reference to any owned host or device memory, possibly
@@ -1261,6 +1360,57 @@ public:
         set_host_dirty();
     }
 
+private:
+    // Invoke f on disjoint crops of this buffer that cover the whole
+    // thing, one per thread. Used by the parallel variants of fill
+    // and copy_from. Splits the dimension with the largest extent, so
+    // the pieces stay large and contiguous.
+    template<typename Fn>
+    void for_each_slice_parallel(int num_threads, Fn &&f) {
+        int split_dim = 0;
+        for (int i = 1; i < dimensions(); i++) {
+            if (dim(i).extent() > dim(split_dim).extent()) {
+                split_dim = i;
+            }
+        }
+        int min = dim(split_dim).min();
+        int extent = dim(split_dim).extent();
+        num_threads = std::min(num_threads, extent);
+        std::vector<std::thread> threads;
+        threads.reserve(num_threads);
+        for (int t = 0; t < num_threads; t++) {
+            int begin = min + (int)(((int64_t)extent * t) / num_threads);
+            int end = min + (int)(((int64_t)extent * (t + 1)) / num_threads);
+            Buffer<T, D> slice = cropped(split_dim, begin, end - begin);
+            threads.emplace_back([f, slice]() mutable { f(slice); });
+        }
+        for (auto &t : threads) {
+            t.join();
+        }
+    }
+
+public:
+    /** A parallel variant of copy_from(). The destination is divided
+     * into contiguous slices, each copied on its own thread; slices
+     * that do not overlap the source copy nothing. The serial inner
+     * loop already collapses to a dense autovectorizable copy per
+     * slice, so this adds the memory-bandwidth scaling that a single
+     * core cannot provide when staging very large buffers in or out
+     * of a pipeline. Uses plain threads rather than
+     * halide_do_par_for so that this header remains usable without a
+     * Halide runtime to link against. */
+    template<typename T2, int D2>
+    void copy_from(const Buffer<T2, D2> &other, int num_threads) {
+        if (num_threads <= 1 || dimensions() == 0) {
+            copy_from(other);
+            return;
+        }
+        for_each_slice_parallel(num_threads, [&other](Buffer<T, D> &slice) {
+            slice.copy_from(other);
+        });
+        set_host_dirty();
+    }
+
     /** Make an image that refers to a sub-range of this image along
      * the given dimension. Asserts that the crop region is within
      * the existing bounds: you cannot "crop outwards", even if you know there
@@ -1774,6 +1924,75 @@ public:
         return buf;
     }
 
+#ifndef _WIN32
+    /** Make a Buffer of runtime type whose host memory is a
+     * memory-mapping of a file, instead of an allocation. The file
+     * must contain, starting at byte_offset, densely-packed data of
+     * the given type and sizes in the same row-major layout the
+     * allocating constructors use. Pages are faulted in lazily, so a
+     * pipeline whose bounds only touch part of the buffer only reads
+     * the corresponding pages from disk. The mapping is private
+     * (copy-on-write): stores to the buffer are legal but do not write
+     * back to the file. The mapping is released when the last Buffer
+     * referencing it is destroyed. */
+    static Buffer<add_const_if_T_is_const<void>, D>
+    make_memory_mapped(halide_type_t t, const char *filename,
+                       const std::vector<int> &sizes,
+                       FileMappingHint hint = FileMappingHint::None,
+                       uint64_t byte_offset = 0) {
+        Buffer<add_const_if_T_is_const<void>, D> im(t, nullptr, sizes);
+        size_t size = im.size_in_bytes();
+        int fd = ::open(filename, O_RDONLY);
+        assert(fd >= 0 && "make_memory_mapped: could not open file");
+        struct stat file_stat;
+        int stat_result = ::fstat(fd, &file_stat);
+        assert(stat_result == 0 &&
+               (uint64_t)file_stat.st_size >= byte_offset + size &&
+               "make_memory_mapped: file is smaller than the requested shape");
+        (void)stat_result;
+        // mmap requires a page-aligned file offset, so map from the
+        // enclosing page boundary and point host at the requested byte.
+        const uint64_t page_size = (uint64_t)::sysconf(_SC_PAGESIZE);
+        const uint64_t aligned_offset = byte_offset & ~(page_size - 1);
+        const size_t length = (size_t)(byte_offset - aligned_offset) + size;
+        const int prot = std::is_const<T>::value ? PROT_READ : (PROT_READ | PROT_WRITE);
+        void *mapping = ::mmap(nullptr, length, prot, MAP_PRIVATE, fd, (off_t)aligned_offset);
+        ::close(fd);
+        assert(mapping != MAP_FAILED && "make_memory_mapped: mmap failed");
+        switch (hint) {
+        case FileMappingHint::Sequential:
+            ::madvise(mapping, length, MADV_SEQUENTIAL);
+            break;
+        case FileMappingHint::Random:
+            ::madvise(mapping, length, MADV_RANDOM);
+            break;
+        case FileMappingHint::WillNeed:
+            ::madvise(mapping, length, MADV_WILLNEED);
+            break;
+        case FileMappingHint::None:
+            break;
+        }
+        auto *header = (Internal::FileMappingHeader *)malloc(sizeof(Internal::FileMappingHeader));
+        new (&header->header) AllocationHeader(Internal::unmap_file_allocation);
+        header->mapping = mapping;
+        header->length = length;
+        im.alloc = &header->header;
+        im.buf.host = (uint8_t *)mapping + (size_t)(byte_offset - aligned_offset);
+        return im;
+    }
+
+    /** Make a Buffer of static type whose host memory is a
+     * memory-mapping of a file. See the runtime-typed overload above. */
+    static Buffer<T, D> make_memory_mapped(const char *filename,
+                                           const std::vector<int> &sizes,
+                                           FileMappingHint hint = FileMappingHint::None,
+                                           uint64_t byte_offset = 0) {
+        static_assert(!T_is_void,
+                      "To construct a Buffer<void>, pass a halide_type_t as the first argument to make_memory_mapped");
+        return make_memory_mapped(static_halide_type(), filename, sizes, hint, byte_offset);
+    }
+#endif
+
     /** Make a buffer with the same shape and memory nesting order as
      * another buffer. It may have a different type. */
     template<typename T2, int D2>
@@ -1952,6 +2171,19 @@ public:
         return *this;
     }
 
+    /** A parallel variant of fill(): the buffer is divided into
+     * contiguous slices, each filled on its own thread. */
+    Buffer<T, D> &fill(not_void_T val, int num_threads) {
+        if (num_threads <= 1 || dimensions() == 0) {
+            return fill(val);
+        }
+        set_host_dirty();
+        for_each_slice_parallel(num_threads, [=](Buffer<T, D> &slice) {
+            slice.for_each_value([=](T &v) { v = val; });
+        });
+        return *this;
+    }
+
 private:
     /** Helper functions for for_each_value. */
     // @{
@@ -84,6 +84,18 @@ AT_FORALL_SCALAR_TYPES_WITH_COMPLEX(HL_PT_DEFINE_TYPECHECK);
 
 #endif  // HL_PYTORCH_API_VERSION check
 
+inline std::vector<halide_dimension_t> get_shape(const at::Tensor tensor) {
+    int ndims = tensor.ndimension();
+    std::vector<halide_dimension_t> shape(ndims);
+    // PyTorch dim order is reverse of Halide
+    for (int dim = 0; dim < ndims; ++dim) {
+        shape[dim].min = 0;
+        shape[dim].extent = tensor.size(ndims - 1 - dim);
+        shape[dim].stride = tensor.stride(ndims - 1 - dim);
+    }
+    return shape;
+}
+
 template<class scalar_t>
 inline Buffer<scalar_t> wrap(at::Tensor &tensor) {
     check_type<scalar_t>(tensor);
@@ -113,6 +125,41 @@ inline Buffer<scalar_t> wrap(at::Tensor &tensor) {
     return buffer;
 }
 
+/** Wrap a tensor without requiring it to be contiguous: the tensor's
+ * own strides (e.g. a channels-last layout, or a view) are carried
+ * into the Halide buffer instead of copying into a dense layout.
+ * Only safe for pipelines that accept arbitrary strides, e.g. ones
+ * compiled with the specialize_strides target feature, which
+ * dispatches to a dense fast path internally when the strides allow
+ * it. */
+template<class scalar_t>
+inline Buffer<scalar_t> wrap_strided(at::Tensor &tensor) {
+    check_type<scalar_t>(tensor);
+    std::vector<halide_dimension_t> shape = get_shape(tensor);
+#if HL_PYTORCH_API_VERSION >= 13
+    scalar_t *pData = tensor.data_ptr<scalar_t>();
+#else
+    scalar_t *pData = tensor.data<scalar_t>();
+#endif
+    Buffer<scalar_t> buffer;
+
+    if (tensor.is_cuda()) {
+#ifdef HL_PT_CUDA
+        buffer = Buffer<scalar_t>((scalar_t *)nullptr, (int)shape.size(), shape.data());
+        const halide_device_interface_t *cuda_interface = halide_cuda_device_interface();
+        int err = buffer.device_wrap_native(cuda_interface, (uint64_t)pData);
+        AT_ASSERTM(err == 0, "halide_device_wrap failed");
+        buffer.set_device_dirty();
+#else
+        AT_ERROR("Trying to wrap a CUDA tensor, but HL_PT_CUDA was not defined: cuda is not available");
+#endif
+    } else {
+        buffer = Buffer<scalar_t>(pData, (int)shape.size(), shape.data());
+    }
+
+    return buffer;
+}
+
 }  // namespace PyTorch
 }  // namespace Halide
 
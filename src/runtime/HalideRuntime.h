@@ -333,6 +333,174 @@ extern void halide_join_thread(struct halide_thread *);
  */
 extern int halide_set_num_threads(int n);
 
+/** Set the maximum number of iterations a parallel loop may have and
+ * still run entirely on the calling thread instead of going through
+ * the thread pool's work queue; waking a sleeping worker can cost
+ * more than a tiny loop's work. Returns the previous threshold. The
+ * default is 1. Set 0 to always enqueue. Only loops without
+ * inter-task dependencies take the fast path; nested parallelism
+ * inside such a loop still uses the pool. Like
+ * halide_set_num_threads, this only affects the default
+ * halide_do_par_for implementation. */
+extern int halide_set_parallel_inline_threshold(int n);
+
+/** Return the number of hardware threads on the host. This is the
+ * default size of the thread pool when halide_set_num_threads has not
+ * been called. Generated code also calls this to size per-thread
+ * private copies of privatized reduction buffers. */
+extern int halide_host_cpu_count();
+
+/** Enable or disable work stealing in Halide's thread pool. When
+ * enabled, workers claim chunks of parallel loop iterations and
+ * balance them between themselves with lock-free operations, only
+ * taking the shared work queue lock when idle. This helps fine-grained
+ * parallel loops on machines with many cores, at the cost of slightly
+ * coarser-grained error reporting within a chunk. Off by default.
+ * Takes one of the halide_work_stealing_mode_t values and returns the
+ * previous setting.
+ *
+ * (As with halide_set_num_threads, this only has an effect when using
+ * the default implementation of halide_do_par_for().) */
+extern int halide_set_work_stealing(int enable);
+
+/** Modes for halide_set_work_stealing. */
+typedef enum halide_work_stealing_mode_t {
+    /** Workers claim one iteration per acquisition of the work queue
+     * lock. The default. */
+    halide_work_stealing_off = 0,
+    /** Idle workers steal single iterations from published chunks.
+     * Best when iteration costs vary wildly, since no iteration ever
+     * waits behind another on the same thread. */
+    halide_work_stealing_single = 1,
+    /** Guided self-scheduling: idle workers steal half of a chunk's
+     * remaining iterations at a time, so chunks recursively split
+     * into exponentially smaller pieces as long as anyone is idle.
+     * Much less contention than stealing single iterations when
+     * iterations are cheap, while still bounding the serial tail of
+     * an imbalanced loop by a single iteration. */
+    halide_work_stealing_guided = 2,
+} halide_work_stealing_mode_t;
+
+/** Enable or disable adaptive parallelism in Halide's thread pool.
+ * When enabled, the pool measures the throughput of each top-level
+ * parallel loop across invocations and converges on the number of
+ * workers that maximizes it, re-probing occasionally to track changes
+ * in machine load. Memory-bound pipelines often peak well below the
+ * machine's core count, and oversubscribing them actively hurts; this
+ * finds the knee automatically instead of requiring a hand-tuned
+ * halide_set_num_threads call per pipeline. Works best when a
+ * pipeline is invoked repeatedly on same-sized inputs, so successive
+ * invocations are comparable. Off by default. Returns the previous
+ * setting.
+ *
+ * (As with halide_set_num_threads, this only has an effect when using
+ * the default implementation of halide_do_par_for().) */
+extern int halide_set_adaptive_parallelism(int enable);
+
+/** Policies for pinning thread pool workers to cpus. */
+typedef enum halide_thread_affinity_policy_t {
+    /** Workers are not pinned. The default. */
+    halide_thread_affinity_policy_none = 0,
+    /** Worker k is pinned to cpu k, filling cpu ids in order. On
+     * machines that enumerate one NUMA node's cpus before the next,
+     * this packs workers onto as few nodes as possible. */
+    halide_thread_affinity_policy_compact,
+    /** Consecutive workers alternate between the lower and upper
+     * halves of the cpu id space, which on the common two-socket
+     * topology places them on alternating NUMA nodes. */
+    halide_thread_affinity_policy_spread
+} halide_thread_affinity_policy_t;
+
+/** Set the policy used to pin Halide's thread pool workers to cpus.
+ * Returns the previous policy. Only affects workers spawned after the
+ * call, so set it before the first parallel pipeline runs (or after
+ * halide_shutdown_thread_pool). Pinning workers also improves NUMA
+ * locality of memory from halide_malloc: pages are placed on the node
+ * of the worker that first touches them, so with pinned workers a
+ * parallel task's working set stays on the node executing it. Only
+ * implemented on Linux; elsewhere the policy is recorded but has no
+ * effect. */
+extern int halide_set_thread_affinity_policy(int policy);
+
+/** Set the scheduling priority given to tasks subsequently enqueued
+ * on Halide's thread pool, returning the previous value. Idle workers
+ * pick the highest-priority runnable task, so when a latency-sensitive
+ * pipeline and bulk background work share one process, bracketing the
+ * latency-sensitive invocations with a higher priority keeps their
+ * tasks from queueing behind the bulk work. The priority is sampled
+ * when a pipeline's top-level tasks are enqueued and inherited by any
+ * nested tasks, so changing it does not affect work already queued.
+ * Priorities are arbitrary ints; the default is 0. Tasks already
+ * running are not preempted.
+ *
+ * (As with halide_set_num_threads, this only has an effect when using
+ * the default implementation of halide_do_par_for().) */
+extern int halide_set_default_task_priority(int priority);
+
+/** An opaque token used to cooperatively cancel running pipelines.
+ * Zero-initialize it (or call halide_cancellation_token_init),
+ * associate it with a user context pointer via
+ * halide_set_cancellation_token, and invoke the pipeline with that
+ * user context. Workers in Halide's thread pool then poll the token
+ * each time they pick up a parallel task, so after halide_cancel the
+ * invocation stops issuing new tasks and returns
+ * halide_error_code_pipeline_cancelled promptly. Tasks that are
+ * already running are not interrupted, and partial results may have
+ * been written to the output buffers. The token must outlive any
+ * pipeline invocation that polls it. */
+struct halide_cancellation_token_t {
+    uint64_t _private[3];
+};
+
+/** Return a cancellation token to the not-cancelled state, e.g. to
+ * reuse it for a fresh pipeline invocation. Do not call this while a
+ * pipeline polling the token is running. */
+extern int halide_cancellation_token_init(struct halide_cancellation_token_t *token);
+
+/** Cancel all in-flight and subsequent pipeline invocations whose
+ * user context is associated with the given token. Idempotent, and
+ * safe to call from any thread. */
+extern void halide_cancel(struct halide_cancellation_token_t *token);
+
+/** Check whether a token has been cancelled. */
+extern bool halide_cancellation_token_cancelled(struct halide_cancellation_token_t *token);
+
+/** Associate a cancellation token with a user context pointer, so
+ * that pipelines invoked with that user context poll the token. Pass
+ * a null token to remove the association again; do this before the
+ * token goes out of scope. A fixed number of associations may be live
+ * at once; returns halide_error_code_generic_error if the table is
+ * full and zero otherwise.
+ *
+ * (As with halide_set_num_threads, this only has an effect when using
+ * the default implementation of halide_do_par_for().) */
+extern int halide_set_cancellation_token(void *user_context, struct halide_cancellation_token_t *token);
+
+/** Arm a deadline on a cancellation token: once approximately
+ * budget_ns nanoseconds have elapsed, the token cancels itself the
+ * next time a worker polls it, so an in-flight pipeline invocation
+ * stops issuing new parallel tasks and returns
+ * halide_error_code_pipeline_cancelled instead of running to
+ * completion. Tasks already running still finish, so everything the
+ * pipeline reports as complete really is. The deadline is checked at
+ * task granularity; schedule the outer tile loops of the output
+ * parallel to control how often that is and how much work a missed
+ * deadline wastes. A budget of zero or less disarms the deadline.
+ * Re-arm after each halide_cancellation_token_init, which clears it. */
+extern int halide_set_deadline(struct halide_cancellation_token_t *token, int64_t budget_ns);
+
+/** After an invocation polling this token was cancelled, report how
+ * far it got: *first_skipped receives the lowest parallel-loop
+ * iteration that was skipped. All lower iterations of that loop ran
+ * to completion, so when the outermost loop of the output is the
+ * parallel one this identifies the completed output region, and a
+ * caller missing a frame deadline can consume the partial result.
+ * If the cancelled invocation had several parallel loops in flight
+ * the value may mix their iteration spaces and is only a hint.
+ * Returns false if no work was skipped (e.g. the invocation
+ * finished before the deadline). */
+extern bool halide_deadline_progress(struct halide_cancellation_token_t *token, int *first_skipped);
+
 /** Halide calls these functions to allocate and free memory. To
  * replace in AOT code, use the halide_set_custom_malloc and
  * halide_set_custom_free, or (on platforms that support weak
@@ -395,6 +563,19 @@ extern int32_t halide_debug_to_file(void *user_context, const char *filename,
                                     int32_t type_code,
                                     struct halide_buffer_t *buf);
 
+/** Called on entry to a loop nest that contains a prefetch scheduled
+ * with Func::prefetch_adaptive. 'name' is the name of the prefetched
+ * buffer, and 'initial_distance' is the distance given in the
+ * schedule. Returns the prefetch distance (in iterations of the
+ * marked loop) to use for this entry to the loop nest. The default
+ * implementation hill-climbs the distance per buffer, using the wall
+ * time between successive entries as feedback. It can be replaced in
+ * AOT code on platforms that support weak linking by defining your
+ * own halide_prefetch_distance, e.g. to pin the distance to a value
+ * computed by other means. */
+extern int32_t halide_prefetch_distance(void *user_context, const char *name,
+                                        int32_t initial_distance);
+
 /** Types in the halide type system. They can be ints, unsigned ints,
  * or floats (of various bit-widths), or a handle (which is always 64-bits).
  * Note that the int/uint/float values do not imply a specific bit width
@@ -682,7 +863,15 @@ struct halide_trace_packet_t {
  * Halide checks the for existence of an environment variable called
  * HL_TRACE_FILE and opens that file. If HL_TRACE_FILE is not defined,
  * it outputs trace information to stdout in a human-readable
- * format. */
+ * format.
+ *
+ * When writing to a file opened via HL_TRACE_FILE, additionally
+ * setting HL_TRACE_BUFFERED in the environment makes each thread
+ * write packets to a per-thread buffer that a background thread
+ * drains to the file in bulk, instead of serializing every packet
+ * through a single lock and write call. This perturbs the timing of
+ * the traced pipeline far less. The file contents are identical
+ * either way. */
 extern void halide_set_trace_file(int fd);
 
 /** Halide calls this to retrieve the file descriptor to write binary
@@ -783,6 +972,15 @@ extern int halide_buffer_copy(void *user_context, struct halide_buffer_t *src,
                               const struct halide_device_interface_t *dst_device_interface,
                               struct halide_buffer_t *dst);
 
+/** Touch every page of a buffer's host allocation. A freshly
+ * allocated output buffer otherwise faults its pages in one at a time
+ * during the first realization, a cost that profilers misattribute to
+ * whichever pipeline stage writes the output first. Call this outside
+ * the timed region instead. If parallel is true, the pages are
+ * touched using the thread pool. Does nothing for buffers with no
+ * host allocation. */
+extern int halide_buffer_prefault(void *user_context, struct halide_buffer_t *buf, bool parallel);
+
 /** Give the destination buffer a device allocation which is an alias
  * for the same coordinate range in the source buffer. Modifies the
  * device, device_interface, and the device_dirty flag only. Only
@@ -871,6 +1069,39 @@ extern int halide_get_gpu_device(void *user_context);
  */
 extern void halide_memoization_cache_set_size(int64_t size);
 
+/** Set the number of independently locked shards the memoization
+ *  cache is split into. Each shard has its own hash table, LRU list,
+ *  and an even slice of the size budget, so lookups and stores of
+ *  distinct keys from concurrent threads mostly proceed without
+ *  contending on a single lock. Values are clamped to a small
+ *  implementation-defined maximum; with the default of one shard the
+ *  cache behaves exactly as it always has (a single global LRU).
+ *  Changing the shard count flushes the cache, so call this once at
+ *  startup before running any memoized pipelines.
+ */
+extern void halide_memoization_cache_set_shards(int shards);
+
+/** Set a directory backing a second, persistent tier of the
+ *  memoization cache. While set, stored entries are also serialized
+ *  to one file per cache key in that directory, and in-memory misses
+ *  fall back to reading them, so warm results survive process
+ *  restarts and are shared between processes on one host. Entries are
+ *  written via a temp file renamed into place, so concurrent
+ *  processes never observe partial files. Only host-resident results
+ *  are written; results with live device allocations skip the disk
+ *  tier. Can also be set with the HL_MEMOIZATION_CACHE_DIR
+ *  environment variable. Pass null or an empty string to disable.
+ */
+extern void halide_memoization_cache_set_dir(const char *path);
+
+/** Limit the number of bytes this process will write to the disk
+ *  tier of the memoization cache. The runtime cannot cheaply audit
+ *  what other processes wrote, so this bounds local writes only;
+ *  trimming old entries is left to the owner of the directory. Pass
+ *  zero for no limit. Defaults to 1GB.
+ */
+extern void halide_memoization_cache_set_disk_size(int64_t size);
+
 /** Given a cache key for a memoized result, currently constructed
  *  from the Func name and top-level Func name plus the arguments of
  *  the computation, determine if the result is in the cache and
@@ -942,6 +1173,26 @@ extern void halide_memoization_cache_release(void *user_context, void *host);
  */
 extern void halide_memoization_cache_cleanup();
 
+/** Restore the contents of a buffer retained by a Func scheduled
+ * with Func::store_persistent. Called by compiled pipelines; not
+ * intended to be replaced or called directly. Returns the first
+ * coordinate along the outermost dimension that was not restored. */
+extern int32_t halide_persistent_state_acquire(void *user_context, const char *key,
+                                               struct halide_buffer_t *buf);
+
+/** Record the contents and bounds of a buffer produced by a Func
+ * scheduled with Func::store_persistent, so the next invocation can
+ * restore them. Called by compiled pipelines; not intended to be
+ * replaced or called directly. */
+extern int halide_persistent_state_store(void *user_context, const char *key,
+                                         struct halide_buffer_t *buf);
+
+/** Free the state retained for Funcs scheduled with
+ * Func::store_persistent. A null key clears all retained state;
+ * after clearing, the next invocation of an affected pipeline
+ * computes everything from scratch. */
+extern int halide_persistent_state_clear(void *user_context, const char *key);
+
 /** Verify that a given range of memory has been initialized; only used when Target::MSAN is enabled.
  *
  * The default implementation simply calls the LLVM-provided __msan_check_mem_is_initialized() function.
@@ -1173,6 +1424,11 @@ enum halide_error_code_t {
      * pipeline, or enable the appropriate device backend. */
     halide_error_code_device_dirty_with_no_device_support = -44,
 
+    /** The pipeline run was cancelled via a halide_cancellation_token_t
+     * before it finished. Partial results may have been written to the
+     * output buffers. */
+    halide_error_code_pipeline_cancelled = -45,
+
 };
 
 /** Halide calls the functions below on various error conditions. The
@@ -1244,6 +1500,7 @@ extern int halide_error_device_interface_no_device(void *user_context);
 extern int halide_error_host_and_device_dirty(void *user_context);
 extern int halide_error_buffer_is_null(void *user_context, const char *routine);
 extern int halide_error_device_dirty_with_no_device_support(void *user_context, const char *buffer_name);
+extern int halide_error_pipeline_cancelled(void *user_context);
 // @}
 
 /** Optional features a compilation Target can have.
@@ -1328,7 +1585,7 @@ typedef enum halide_target_feature_t {
     halide_target_feature_wasm_simd128,           ///< Enable +simd128 instructions for WebAssembly codegen.
     halide_target_feature_wasm_signext,           ///< Enable +sign-ext instructions for WebAssembly codegen.
     halide_target_feature_wasm_sat_float_to_int,  ///< Enable saturating (nontrapping) float-to-int instructions for WebAssembly codegen.
-    halide_target_feature_wasm_threads,           ///< Enable the thread pool for WebAssembly codegen. (Also enables +atomics)
+    halide_target_feature_wasm_threads,           ///< Enable the thread pool for WebAssembly codegen. (Also enables +atomics and +bulk-memory, which shared wasm memories require.)
     halide_target_feature_wasm_bulk_memory,       ///< Enable +bulk-memory instructions for WebAssembly codegen.
     halide_target_feature_sve,                    ///< Enable ARM Scalable Vector Extensions
     halide_target_feature_sve2,                   ///< Enable ARM Scalable Vector Extensions v2
@@ -1336,6 +1593,14 @@ typedef enum halide_target_feature_t {
     halide_target_feature_arm_dot_prod,           ///< Enable ARMv8.2-a dotprod extension (i.e. udot and sdot instructions)
     halide_llvm_large_code_model,                 ///< Use the LLVM large code model to compile
     halide_target_feature_rvv,                    ///< Enable RISCV "V" Vector Extension
+    halide_target_feature_avx512_vnni,            ///< Enable AVX512-VNNI instructions without requiring the full Sapphire Rapids feature set. Present on Cascade Lake and Ice Lake processors.
+    halide_target_feature_arm_bf16,               ///< Enable the ARMv8.6-a bfloat extension (i.e. bfdot and bfcvt instructions)
+    halide_target_feature_avx512_fp16,            ///< Enable the AVX512-FP16 extension (native float16 vector arithmetic), present on Sapphire Rapids processors.
+    halide_target_feature_async_root,             ///< Automatically mark independent compute_root stages async, so they execute as a task DAG rather than strictly sequentially.
+    halide_target_feature_arm_sme,                ///< Enable the ARMv9 Scalable Matrix Extension: function bodies run in streaming mode so vector code executes on the SME/streaming engine.
+    halide_target_feature_strip_runtime,          ///< Discard runtime functions the generated code does not reference from AOT output. Runtime API entrypoints that survive are still overridable, but stripped ones cannot be called from user code.
+    halide_target_feature_telemetry,              ///< Report per-invocation wall time and peak heap usage via halide_set_telemetry_report. Far cheaper than halide_target_feature_profile; suitable for production use.
+    halide_target_feature_specialize_strides,     ///< Multiversion pipeline bodies on input strides: a specialized copy where every input has a dense innermost dimension, plus a generic fallback.
     halide_target_feature_end                     ///< A sentinel. Every target is considered to have this feature, and setting this feature does nothing.
 } halide_target_feature_t;
 
@@ -1670,6 +1935,46 @@ struct halide_filter_metadata_t {
     const char *name;
 };
 
+/** The maximum number of loop terms in a
+ * halide_affine_access_descriptor_t. */
+#define HALIDE_MAX_AFFINE_ACCESS_DIMS 16
+
+/** The affine access pattern of one load or store in a compiled
+ * pipeline, as emitted by Pipeline::compile_to_access_descriptors.
+ * Describes the addresses a stage touches in a buffer as a base plus
+ * a sum of loop terms, so DMA engines, prefetchers and similar
+ * descriptor-driven hardware can be programmed from the schedule
+ * instead of from hand-maintained tables. Strides and bases are in
+ * bytes; terms are ordered innermost first; any value that is not a
+ * compile-time constant is -1. */
+struct halide_affine_access_descriptor_t {
+    /** The producing or consuming stage. */
+    const char *stage;
+
+    /** The buffer accessed. */
+    const char *buffer;
+
+    /** 1 for a store, 0 for a load. */
+    int32_t is_write;
+
+    /** The size of one accessed element. */
+    int32_t element_bytes;
+
+    /** The number of loop terms below. */
+    int32_t dimensions;
+
+    /** Byte offset of the first element touched, relative to the
+     * start of the buffer, or -1 if not statically known. */
+    int64_t base;
+
+    /** Bytes between the addresses touched by consecutive iterations
+     * of each loop. */
+    int64_t stride[HALIDE_MAX_AFFINE_ACCESS_DIMS];
+
+    /** Iteration count of each loop. */
+    int64_t extent[HALIDE_MAX_AFFINE_ACCESS_DIMS];
+};
+
 /** halide_register_argv_and_metadata() is a **user-defined** function that
  * must be provided in order to use the registration.cc files produced
  * by Generators when the 'registration' output is requested. Each registration.cc
@@ -1709,6 +2014,19 @@ struct halide_profiler_func_stats {
     /** The average number of thread pool worker threads active while computing this Func. */
     uint64_t active_threads_numerator, active_threads_denominator;
 
+    /** Hardware performance counters sampled while computing this
+     * Func: instructions retired, cache misses, and stalled backend
+     * cycles. Only populated on Linux when HL_PROFILER_PERF_EVENTS is
+     * set; see halide_profiler_state. */
+    uint64_t instructions;
+    uint64_t cache_misses;
+    uint64_t stalled_cycles;
+
+    /** The memory this Func was holding at the moment the pipeline
+     * hit its peak heap usage. The non-zero entries across a pipeline
+     * are the allocations that coexisted to produce memory_peak. */
+    uint64_t memory_at_peak;
+
     /** The name of this Func. A global constant string. */
     const char *name;
 
@@ -1832,6 +2150,68 @@ void halide_profiler_shutdown();
  * reset. Also happens at process exit. */
 extern void halide_profiler_report(void *user_context);
 
+/** Set the file the profiler writes a Chrome trace_event JSON timeline
+ * to. While a trace file is set, the sampling thread records each
+ * observed run of a func (func id, active thread count, begin/end
+ * timestamps) into a lock-free ring buffer, and the events are dumped
+ * as a Chrome trace at process exit (or explicitly via
+ * halide_profiler_chrome_trace_dump), suitable for loading into
+ * chrome://tracing or Perfetto alongside other traces. The timeline
+ * has the resolution of the profiler's sampling interval (see the
+ * sleep_time field of halide_profiler_state). Can also be enabled by
+ * setting the HL_PROFILER_TRACE_FILE environment variable. Only the
+ * most recent events are kept if the ring buffer wraps. */
+extern void halide_profiler_set_chrome_trace_file(const char *path);
+
+/** Write all trace events recorded so far to the Chrome trace file
+ * configured above. Does nothing if no trace file is set. */
+extern void halide_profiler_chrome_trace_dump(void *user_context);
+
+/** Export the accumulated profiler statistics to the given file in a
+ * simple machine-readable text format: a "halide_profile 1" header,
+ * then for each pipeline a line "pipeline <runs> <name>" followed by
+ * one line "func <total_time_ns> <name>" per func the sampler
+ * observed running. The exported profile from a production run can be
+ * fed back to the adams2019 autoscheduler (via the
+ * HL_CALIBRATION_PROFILE environment variable) to calibrate its cost
+ * model with measured rather than predicted stage runtimes. */
+extern void halide_profiler_export(void *user_context, const char *path);
+
+/** The record passed to the telemetry handler once per pipeline
+ * invocation when a pipeline is compiled with the telemetry target
+ * feature. Telemetry is a far cheaper alternative to the full
+ * profiler: one timestamp pair per invocation plus a counter update
+ * per heap allocation, with no sampling thread. */
+struct halide_telemetry_record {
+    /** The name of the pipeline that ran. */
+    const char *pipeline_name;
+    /** Wall-clock time from pipeline entry to exit, in nanoseconds. */
+    uint64_t wall_time_ns;
+    /** High-water mark of heap memory allocated by Halide pipelines
+     * during this invocation, in bytes. The counter is shared, so
+     * pipelines running concurrently observe each other's
+     * allocations. */
+    uint64_t peak_heap_bytes;
+};
+
+/** Set the function called with a completed telemetry record at the
+ * end of each invocation of a pipeline compiled with the telemetry
+ * target feature. Returns the previously-installed handler. There is
+ * no default handler; until one is installed, records are
+ * discarded. The handler may be called concurrently from multiple
+ * threads. */
+typedef void (*halide_telemetry_report_t)(void *user_context, const struct halide_telemetry_record *);
+extern halide_telemetry_report_t halide_set_telemetry_report(halide_telemetry_report_t report);
+
+/** Called by compiled pipelines to gather the data above. Not for use
+ * by user code. */
+// @{
+extern int64_t halide_telemetry_pipeline_start();
+extern int halide_telemetry_pipeline_end(const char *pipeline_name, int64_t start_time_ns);
+extern int halide_telemetry_track_allocation(uint64_t bytes);
+extern int halide_telemetry_track_free(uint64_t bytes);
+// @}
+
 /// \name "Float16" functions
 /// These functions operate of bits (``uint16_t``) representing a half
 /// precision floating point number (IEEE-754 2008 binary16).
@@ -1895,6 +2275,34 @@ struct halide_device_allocation_pool {
  * global lifetime, and its next field will be clobbered. */
 extern void halide_register_device_allocation_pool(struct halide_device_allocation_pool *);
 
+/** Give the default host allocator a byte budget for caching freed
+ * allocations for reuse, instead of returning every one to the system
+ * allocator. Useful for workloads that allocate and free the same
+ * buffer sizes every frame. Allocations are rounded up to
+ * power-of-two size classes (64 bytes to 64 MB; larger requests
+ * bypass the cache), and each class is sharded into several
+ * lock-striped magazines so concurrent threads rarely contend.
+ * Setting the size to zero (the default) disables the cache and
+ * releases everything in it; shrinking the budget below the cached
+ * bytes also flushes. Can also be configured with the
+ * HL_HOST_ALLOCATION_CACHE_SIZE environment variable. Only affects
+ * halide_default_malloc/free, not a custom allocator installed with
+ * halide_set_custom_malloc. */
+extern void halide_set_host_allocation_cache_size(void *user_context, uint64_t size);
+
+/** Configure the default host allocator's policy for large
+ * allocations. Requests of huge_page_threshold bytes or more are
+ * served with anonymous mmap instead of malloc, requesting 2MB huge
+ * pages up front and advising transparent huge pages as a fallback
+ * (Linux only; elsewhere the threshold is ignored). A threshold of
+ * zero disables the mmap path. If alignment is non-zero it must be a
+ * power of two no greater than 4096, and raises the alignment of
+ * every allocation above the default halide_malloc_alignment. The
+ * threshold can also be set with the HL_HUGE_PAGE_THRESHOLD
+ * environment variable. Only affects halide_default_malloc/free, not
+ * a custom allocator installed with halide_set_custom_malloc. */
+extern void halide_set_allocation_policy(void *user_context, uint64_t huge_page_threshold, int alignment);
+
 #ifdef __cplusplus
 }  // End extern "C"
 #endif
@@ -35,6 +35,8 @@ extern int halide_cuda_run(void *user_context,
                            void *args[],
                            int8_t arg_is_buffer[]);
 extern void halide_cuda_finalize_kernels(void *user_context, void *state_ptr);
+extern int halide_cuda_occupancy_block_size(void *user_context, void *state_ptr,
+                                            const char *entry_name);
 // @}
 
 /** Set the underlying cuda device poiner for a buffer. The device
@@ -65,6 +67,93 @@ extern uintptr_t halide_cuda_get_device_ptr(void *user_context, struct halide_bu
  * driver. See halide_reuse_device_allocations. */
 extern int halide_cuda_release_unused_device_allocations(void *user_context);
 
+/** Enable or disable the cuda stream pool. When enabled, each
+ * distinct user_context gets its own non-blocking cuda stream instead
+ * of everything sharing the default stream, so pipelines invoked
+ * concurrently from multiple threads can actually overlap on the
+ * GPU. To benefit, pass a distinct user_context per thread. Can also
+ * be enabled by setting the HL_CUDA_STREAM_POOL environment
+ * variable. Off by default. Pooled streams live until
+ * halide_device_release is called on the corresponding context. */
+extern void halide_cuda_enable_stream_pool(void *user_context, bool enable);
+
+/** Map a user_context to a specific CUDA device ordinal, for sharding
+ * work across the devices of a multi-GPU machine. Pipeline
+ * invocations passing a mapped user_context run on a dedicated
+ * context for that device instead of the process-wide default
+ * context; each ordinal gets one context, shared by every
+ * user_context mapped to it. To split one realization across N
+ * devices, crop the output along an outer dimension into N pieces and
+ * realize each piece from its own thread with a user_context mapped
+ * to a distinct device; the crops alias the host allocation, so
+ * copying each piece back to host stitches the result. Establish the
+ * mapping before launching work with that user_context. Passing a
+ * negative device removes the mapping. Call halide_device_release
+ * with a mapped user_context to destroy that device's context.
+ * Returns 0 on success. */
+extern int halide_cuda_set_device_for_user_context(void *user_context, int device);
+
+/** Enable or disable pinned (page-locked) host memory for buffers
+ * allocated through halide_device_and_host_malloc. Pinned memory lets
+ * host<->device copies run as true DMA transfers, roughly doubling
+ * transfer bandwidth for transfer-bound pipelines, at the cost of
+ * reducing the memory available to the rest of the system. Freed
+ * pinned allocations are cached for reuse (see
+ * halide_reuse_device_allocations); the cache is dropped by
+ * halide_cuda_release_unused_device_allocations. Can also be enabled
+ * by setting the HL_CUDA_PINNED_HOST environment variable. Off by
+ * default. */
+extern void halide_cuda_enable_pinned_host_allocations(void *user_context, bool enable);
+
+/** Enable or disable blocking synchronization. By default the CUDA
+ * driver spins a CPU core at 100% inside halide_device_sync while the
+ * GPU works. When enabled, contexts are created with
+ * CU_CTX_SCHED_BLOCKING_SYNC and halide_device_sync waits on a
+ * blocking event, so the waiting thread sleeps in the driver and the
+ * core is free to run other work (e.g. other pipelines, or tasks from
+ * the Halide thread pool). Adds a small wake-up latency per sync, so
+ * leave it off for latency-critical single-pipeline use. Takes effect
+ * for context creation only if set before the first pipeline runs;
+ * the event-based wait in halide_device_sync applies regardless, and
+ * also covers contexts supplied by an overridden
+ * halide_cuda_acquire_context. Can also be enabled by setting the
+ * HL_CUDA_BLOCKING_SYNC environment variable. Off by default. */
+extern void halide_cuda_enable_blocking_sync(void *user_context, bool enable);
+
+/** Enable or disable stream-ordered device allocations. By default
+ * device memory comes from cuMemAlloc, which synchronizes against all
+ * in-flight work on the device, so pipelines that allocate per-frame
+ * temporaries stall multi-stream runs. When enabled, allocations come
+ * from the driver's stream-ordered memory pool (cuMemAllocAsync) on
+ * the invocation's stream and are returned to it with cuMemFreeAsync,
+ * ordered after the work that used them, so no device-wide sync
+ * occurs. The driver pool recycles freed memory itself, so these
+ * allocations don't use the halide_reuse_device_allocations cache.
+ * Can also be enabled by setting the HL_CUDA_ASYNC_ALLOC environment
+ * variable. Off by default. Requires a CUDA 11.2 or later driver;
+ * older drivers fall back to cuMemAlloc. */
+extern void halide_cuda_enable_async_allocations(void *user_context, bool enable);
+
+/** Capture a sequence of kernel launches and buffer copies into a
+ * CUDA Graph, amortizing per-launch driver overhead when the same
+ * sequence is submitted repeatedly (e.g. a pipeline run once per
+ * frame). Call halide_cuda_graph_capture_begin, run the pipeline once
+ * from the same thread with the same user_context, then call
+ * halide_cuda_graph_capture_end to get an executable graph. The
+ * captured work is recorded, not executed. Replaying the graph with
+ * halide_cuda_graph_launch re-issues the recorded launches against
+ * the same device and host addresses, so it is only valid while every
+ * buffer involved still has the same allocation; re-capture after
+ * reallocating. Only one capture may be in progress at a time. Do not
+ * call halide_device_sync between begin and end. Returns an error if
+ * the driver does not support graphs. */
+// @{
+extern int halide_cuda_graph_capture_begin(void *user_context);
+extern int halide_cuda_graph_capture_end(void *user_context, void **graph);
+extern int halide_cuda_graph_launch(void *user_context, void *graph);
+extern int halide_cuda_graph_destroy(void *user_context, void *graph);
+// @}
+
 #ifdef __cplusplus
 }  // End extern "C"
 #endif
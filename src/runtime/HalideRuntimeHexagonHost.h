@@ -129,6 +129,21 @@ extern int halide_hexagon_set_performance(void *user_context, halide_hexagon_pow
 extern int halide_hexagon_set_thread_priority(void *user_context, int priority);
 // @}
 
+/** Allow up to the given number of offloaded pipeline launches to be
+ * queued and issued to the DSP from a dedicated submission thread,
+ * instead of blocking in halide_hexagon_run for each FastRPC round
+ * trip. Back-to-back offloaded stages then overlap argument
+ * marshalling and RPC latency with remote execution; launches are
+ * issued in submission order, and any host-side access to device
+ * memory (copies, frees, halide_device_sync) waits for the queue to
+ * drain first, so dataflow is preserved. Only launches whose buffer
+ * arguments all live in shared ION allocations are queued; others
+ * run synchronously. Errors from a queued launch are reported at the
+ * next drain point. A depth of 0 (the default) restores fully
+ * synchronous behavior. Returns the previous depth, or a negative
+ * error code. */
+extern int halide_hexagon_set_rpc_queue_depth(void *user_context, int depth);
+
 /** These are forward declared here to allow clients to override the
  *  Halide Hexagon runtime. Do not call them. */
 // @{
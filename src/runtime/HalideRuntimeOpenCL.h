@@ -79,6 +79,19 @@ extern void halide_opencl_set_build_options(const char *n);
  * halide_opencl_set_build_options. */
 extern const char *halide_opencl_get_build_options(void *user_context);
 
+/** Enable or disable zero-copy host-shared buffers for allocations
+ * made through halide_device_and_host_malloc. When enabled, the host
+ * and device sides of a buffer are the same CL_MEM_ALLOC_HOST_PTR
+ * allocation: halide_copy_to_device unmaps the buffer to publish host
+ * writes and halide_copy_to_host maps it back, so no data is ever
+ * copied. This is a win on devices that share DRAM with the host
+ * (integrated GPUs); on discrete GPUs the allocation may land in
+ * system memory and every kernel access crosses the bus, so leave it
+ * off there. It is the caller's responsibility to enable this only on
+ * suitable devices. Can also be enabled by setting the
+ * HL_OPENCL_HOST_SHARED environment variable. Off by default. */
+extern void halide_opencl_enable_host_shared_allocations(void *user_context, bool enable);
+
 /** Set the underlying cl_mem for a halide_buffer_t. This memory should be
  * allocated using clCreateBuffer or similar and must have an extent
  * large enough to cover that specified by the halide_buffer_t extent
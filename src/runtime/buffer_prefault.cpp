@@ -0,0 +1,68 @@
+#include "HalideRuntime.h"
+
+// Pre-fault the host allocation of a buffer, so that a
+// latency-critical first realization doesn't pay a storm of soft page
+// faults that the profiler then attributes to the first pipeline
+// stage.
+
+namespace Halide {
+namespace Runtime {
+namespace Internal {
+
+// Each parallel task touches this many bytes, so the task count stays
+// proportional to the buffer size without making tasks too small to
+// be worth distributing.
+constexpr uint64_t prefault_chunk_bytes = 2 * 1024 * 1024;
+
+// A lower bound on the page size of any supported OS. Touching at
+// this granularity on systems with larger pages just means a few
+// redundant loads per page.
+constexpr uint64_t prefault_page_bytes = 4096;
+
+struct prefault_closure {
+    uint8_t *base;
+    uint64_t size;
+};
+
+WEAK int prefault_chunk(void *user_context, int chunk, uint8_t *closure) {
+    prefault_closure *c = (prefault_closure *)closure;
+    uint64_t begin = (uint64_t)chunk * prefault_chunk_bytes;
+    uint64_t end = begin + prefault_chunk_bytes;
+    if (end > c->size) {
+        end = c->size;
+    }
+    // Write each page's first byte back to itself. The volatile
+    // access can't be elided, and the write forces the OS to commit a
+    // private writable page rather than aliasing the shared zero
+    // page.
+    volatile uint8_t *p = c->base;
+    for (uint64_t i = begin; i < end; i += prefault_page_bytes) {
+        p[i] = p[i];
+    }
+    return 0;
+}
+
+}  // namespace Internal
+}  // namespace Runtime
+}  // namespace Halide
+
+extern "C" {
+
+WEAK int halide_buffer_prefault(void *user_context, struct halide_buffer_t *buf, bool parallel) {
+    if (buf == nullptr || buf->host == nullptr) {
+        // Nothing to pre-fault. Device allocations are the device
+        // API's problem.
+        return halide_error_code_success;
+    }
+    prefault_closure closure = {buf->host, buf->size_in_bytes()};
+    int chunks = (int)((closure.size + prefault_chunk_bytes - 1) / prefault_chunk_bytes);
+    if (parallel && chunks > 1) {
+        return halide_do_par_for(user_context, prefault_chunk, 0, chunks, (uint8_t *)&closure);
+    }
+    for (int i = 0; i < chunks; i++) {
+        prefault_chunk(user_context, i, (uint8_t *)&closure);
+    }
+    return halide_error_code_success;
+}
+
+}  // extern "C"
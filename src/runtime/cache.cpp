@@ -193,34 +193,291 @@ WEAK uint32_t djb_hash(const uint8_t *key, size_t key_size) {
     return h;
 }
 
-WEAK halide_mutex memoization_lock = {{0}};
-
 const size_t kHashTableSize = 256;
+const uint64_t kDefaultCacheSize = 1 << 20;
+const int kMaxCacheShards = 16;
+
+// The cache is split into independently locked shards, each with its
+// own hash table, LRU list, and slice of the size budget, so
+// concurrent lookups of distinct keys from many threads don't
+// serialize on one lock. Keys land in a shard based on their hash, so
+// with the default of one shard behavior (including global LRU order)
+// is identical to the unsharded cache.
+struct CacheShard {
+    halide_mutex lock;
+    CacheEntry *cache_entries[kHashTableSize];
+    CacheEntry *most_recently_used;
+    CacheEntry *least_recently_used;
+    int64_t max_cache_size;
+    int64_t current_cache_size;
+
+    void prune();
+};
 
-WEAK CacheEntry *cache_entries[kHashTableSize];
+WEAK CacheShard cache_shards[kMaxCacheShards];
+WEAK int num_cache_shards = 1;
+WEAK int64_t total_max_cache_size = kDefaultCacheSize;
+WEAK bool cache_shards_inited = false;
 
-WEAK CacheEntry *most_recently_used = nullptr;
-WEAK CacheEntry *least_recently_used = nullptr;
+// Give each active shard an even slice of the total budget. Also
+// serves as first-use initialization, since the shards are
+// zero-initialized statics.
+WEAK void set_cache_shard_budgets() {
+    cache_shards_inited = true;
+    for (int i = 0; i < kMaxCacheShards; i++) {
+        cache_shards[i].max_cache_size = total_max_cache_size / num_cache_shards;
+    }
+}
 
-const uint64_t kDefaultCacheSize = 1 << 20;
-WEAK int64_t max_cache_size = kDefaultCacheSize;
-WEAK int64_t current_cache_size = 0;
+WEAK void init_cache_shards() {
+    if (!cache_shards_inited) {
+        set_cache_shard_budgets();
+    }
+}
+
+// The low bits of the hash pick the bucket within a shard, so use
+// higher bits to pick the shard.
+WEAK __attribute((always_inline)) CacheShard *get_cache_shard(uint32_t h) {
+    init_cache_shards();
+    return &cache_shards[(h / kHashTableSize) % num_cache_shards];
+}
+
+// An optional second, disk-backed cache tier, enabled by configuring a
+// backing directory (halide_memoization_cache_set_dir or the
+// HL_MEMOIZATION_CACHE_DIR environment variable). Stored entries are
+// also serialized to one file per cache key in that directory, and
+// in-memory misses fall back to reading them, so warm results survive
+// process restarts and are shared between processes on a host. Writes
+// go to a temp file that is renamed into place, so a reader never sees
+// a partial entry.
+
+extern "C" size_t fread(void *, size_t, size_t, void *);
+extern "C" int rename(const char *oldname, const char *newname);
+
+const uint32_t kDiskCacheMagic = 0x484c4d43;  // "HLMC"
+const uint32_t kDiskCacheVersion = 1;
+const int kMaxDiskCacheDims = 16;
+
+struct DiskCacheEntryHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t key_size;
+    uint32_t tuple_count;
+    uint32_t dimensions;
+    uint32_t pad;
+};
+
+WEAK halide_mutex disk_cache_lock = {{0}};
+WEAK char disk_cache_dir[512] = {0};
+WEAK bool disk_cache_checked_env = false;
+// The disk tier can't cheaply enumerate what other processes wrote, so
+// the size limit bounds the bytes written by this process; trimming
+// stale entries is left to the owner of the directory.
+WEAK int64_t disk_cache_max_size = 1 << 30;
+WEAK int64_t disk_cache_bytes_written = 0;
+
+WEAK bool disk_cache_enabled() {
+    if (!disk_cache_checked_env) {
+        disk_cache_checked_env = true;
+        const char *dir = getenv("HL_MEMOIZATION_CACHE_DIR");
+        if (dir && dir[0] && !disk_cache_dir[0]) {
+            halide_memoization_cache_set_dir(dir);
+        }
+    }
+    return disk_cache_dir[0] != 0;
+}
+
+WEAK char disk_cache_hex_digit(int val) {
+    return val < 10 ? '0' + val : 'a' + (val - 10);
+}
+
+// The file name is derived from two independent hashes of the key;
+// the full key is stored in the file and verified on read, so a
+// name collision is a miss, never a wrong result.
+WEAK bool disk_cache_path(char *buf, size_t buf_size,
+                          uint32_t h, const uint8_t *cache_key, int32_t key_size) {
+    uint32_t h2 = 0;
+    for (int32_t i = 0; i < key_size; i++) {
+        h2 = h2 * 131 + cache_key[i] + 7;
+    }
+    size_t dir_len = strlen(disk_cache_dir);
+    if (dir_len + 32 > buf_size) {
+        return false;
+    }
+    memcpy(buf, disk_cache_dir, dir_len);
+    char *p = buf + dir_len;
+    *p++ = '/';
+    for (int i = 28; i >= 0; i -= 4) {
+        *p++ = disk_cache_hex_digit((h >> i) & 0xf);
+    }
+    for (int i = 28; i >= 0; i -= 4) {
+        *p++ = disk_cache_hex_digit((h2 >> i) & 0xf);
+    }
+    *p++ = '.';
+    *p++ = 'h';
+    *p++ = 'm';
+    *p++ = 'c';
+    *p++ = 0;
+    return true;
+}
+
+WEAK uint32_t disk_cache_type_bits(const halide_buffer_t *buf) {
+    return (((uint32_t)buf->type.code) << 24) |
+           (((uint32_t)buf->type.bits) << 16) |
+           (uint32_t)buf->type.lanes;
+}
+
+WEAK void disk_cache_store(void *user_context, uint32_t h,
+                           const uint8_t *cache_key, int32_t key_size,
+                           halide_buffer_t *computed_bounds,
+                           int32_t tuple_count, halide_buffer_t **tuple_buffers) {
+    if (computed_bounds->dimensions > kMaxDiskCacheDims) {
+        return;
+    }
+    int64_t data_bytes = 0;
+    for (int32_t i = 0; i < tuple_count; i++) {
+        // Only host-resident results can be serialized.
+        if (tuple_buffers[i]->device != 0 || tuple_buffers[i]->host == nullptr) {
+            return;
+        }
+        data_bytes += tuple_buffers[i]->size_in_bytes();
+    }
+
+    char path[512], tmp_path[512 + 20];
+    if (!disk_cache_path(path, sizeof(path), h, cache_key, key_size)) {
+        return;
+    }
+
+    ScopedMutexLock lock(&disk_cache_lock);
+
+    if (disk_cache_max_size != 0 &&
+        disk_cache_bytes_written + data_bytes > disk_cache_max_size) {
+        return;
+    }
+
+    // Write to a unique temp file and rename it into place so another
+    // process never reads a half-written entry. The address of a
+    // local distinguishes concurrent processes sharing the directory;
+    // within this process writes are serialized by the lock above.
+    uintptr_t tag = (uintptr_t)&data_bytes;
+    size_t path_len = strlen(path);
+    memcpy(tmp_path, path, path_len);
+    char *p = tmp_path + path_len;
+    *p++ = '.';
+    for (int i = 0; i < 8; i++) {
+        *p++ = disk_cache_hex_digit((tag >> (i * 4)) & 0xf);
+    }
+    *p++ = 0;
+
+    void *file = fopen(tmp_path, "wb");
+    if (!file) {
+        return;
+    }
+
+    DiskCacheEntryHeader header;
+    header.magic = kDiskCacheMagic;
+    header.version = kDiskCacheVersion;
+    header.key_size = key_size;
+    header.tuple_count = tuple_count;
+    header.dimensions = computed_bounds->dimensions;
+    header.pad = 0;
+
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(cache_key, key_size, 1, file) == 1 &&
+              (header.dimensions == 0 ||
+               fwrite(computed_bounds->dim, sizeof(halide_dimension_t) * header.dimensions, 1, file) == 1);
+    for (int32_t i = 0; ok && i < tuple_count; i++) {
+        halide_buffer_t *buf = tuple_buffers[i];
+        uint32_t type_bits = disk_cache_type_bits(buf);
+        uint64_t size_in_bytes = buf->size_in_bytes();
+        ok = fwrite(&type_bits, sizeof(type_bits), 1, file) == 1 &&
+             fwrite(&size_in_bytes, sizeof(size_in_bytes), 1, file) == 1 &&
+             (header.dimensions == 0 ||
+              fwrite(buf->dim, sizeof(halide_dimension_t) * header.dimensions, 1, file) == 1) &&
+             fwrite(buf->host, size_in_bytes, 1, file) == 1;
+    }
+    fclose(file);
+
+    if (ok && rename(tmp_path, path) == 0) {
+        disk_cache_bytes_written += data_bytes;
+    } else {
+        remove(tmp_path);
+    }
+}
+
+WEAK bool disk_cache_load(void *user_context, uint32_t h,
+                          const uint8_t *cache_key, int32_t key_size,
+                          halide_buffer_t *computed_bounds,
+                          int32_t tuple_count, halide_buffer_t **tuple_buffers) {
+    if (computed_bounds->dimensions > kMaxDiskCacheDims) {
+        return false;
+    }
+    char path[512];
+    if (!disk_cache_path(path, sizeof(path), h, cache_key, key_size)) {
+        return false;
+    }
+    void *file = fopen(path, "rb");
+    if (!file) {
+        return false;
+    }
+
+    // Anything unexpected in the file (a name collision, a different
+    // shape, a truncated write from a dead process) is just a miss.
+    uint8_t stored_key[1024];
+    halide_dimension_t stored_dims[kMaxDiskCacheDims];
+    DiskCacheEntryHeader header;
+    bool ok = fread(&header, sizeof(header), 1, file) == 1 &&
+              header.magic == kDiskCacheMagic &&
+              header.version == kDiskCacheVersion &&
+              header.key_size == (uint32_t)key_size &&
+              header.key_size <= sizeof(stored_key) &&
+              header.tuple_count == (uint32_t)tuple_count &&
+              header.dimensions == (uint32_t)computed_bounds->dimensions &&
+              fread(stored_key, key_size, 1, file) == 1 &&
+              keys_equal(stored_key, cache_key, key_size);
+    if (ok && header.dimensions > 0) {
+        ok = fread(stored_dims, sizeof(halide_dimension_t) * header.dimensions, 1, file) == 1;
+        for (uint32_t i = 0; ok && i < header.dimensions; i++) {
+            ok = !(stored_dims[i] != computed_bounds->dim[i]);
+        }
+    }
+    for (int32_t i = 0; ok && i < tuple_count; i++) {
+        halide_buffer_t *buf = tuple_buffers[i];
+        uint32_t type_bits = 0;
+        uint64_t size_in_bytes = 0;
+        ok = fread(&type_bits, sizeof(type_bits), 1, file) == 1 &&
+             type_bits == disk_cache_type_bits(buf) &&
+             fread(&size_in_bytes, sizeof(size_in_bytes), 1, file) == 1 &&
+             size_in_bytes == (uint64_t)buf->size_in_bytes();
+        if (ok && header.dimensions > 0) {
+            ok = fread(stored_dims, sizeof(halide_dimension_t) * header.dimensions, 1, file) == 1;
+            for (uint32_t j = 0; ok && j < header.dimensions; j++) {
+                ok = !(stored_dims[j] != buf->dim[j]);
+            }
+        }
+        if (ok) {
+            ok = fread(buf->host, size_in_bytes, 1, file) == 1;
+        }
+    }
+    fclose(file);
+    return ok;
+}
 
 #if CACHE_DEBUGGING
-WEAK void validate_cache() {
-    print(nullptr) << "validating cache, "
-                   << "current size " << current_cache_size
-                   << " of maximum " << max_cache_size << "\n";
+WEAK void validate_cache_shard(CacheShard *shard) {
+    print(nullptr) << "validating cache shard, "
+                   << "current size " << shard->current_cache_size
+                   << " of maximum " << shard->max_cache_size << "\n";
     int entries_in_hash_table = 0;
     for (size_t i = 0; i < kHashTableSize; i++) {
-        CacheEntry *entry = cache_entries[i];
+        CacheEntry *entry = shard->cache_entries[i];
         while (entry != nullptr) {
             entries_in_hash_table++;
-            if (entry->more_recent == nullptr && entry != most_recently_used) {
+            if (entry->more_recent == nullptr && entry != shard->most_recently_used) {
                 halide_print(nullptr, "cache invalid case 1\n");
                 __builtin_trap();
             }
-            if (entry->less_recent == nullptr && entry != least_recently_used) {
+            if (entry->less_recent == nullptr && entry != shard->least_recently_used) {
                 halide_print(nullptr, "cache invalid case 2\n");
                 __builtin_trap();
             }
@@ -228,13 +485,13 @@ WEAK void validate_cache() {
         }
     }
     int entries_from_mru = 0;
-    CacheEntry *mru_chain = most_recently_used;
+    CacheEntry *mru_chain = shard->most_recently_used;
     while (mru_chain != nullptr) {
         entries_from_mru++;
         mru_chain = mru_chain->less_recent;
     }
     int entries_from_lru = 0;
-    CacheEntry *lru_chain = least_recently_used;
+    CacheEntry *lru_chain = shard->least_recently_used;
     while (lru_chain != nullptr) {
         entries_from_lru++;
         lru_chain = lru_chain->more_recent;
@@ -250,16 +507,16 @@ WEAK void validate_cache() {
         halide_print(nullptr, "cache invalid case 4\n");
         __builtin_trap();
     }
-    if (current_cache_size < 0) {
+    if (shard->current_cache_size < 0) {
         halide_print(nullptr, "cache size is negative\n");
         __builtin_trap();
     }
 }
 #endif
 
-WEAK void prune_cache() {
+WEAK void CacheShard::prune() {
 #if CACHE_DEBUGGING
-    validate_cache();
+    validate_cache_shard(this);
 #endif
     CacheEntry *prune_candidate = least_recently_used;
     while (current_cache_size > max_cache_size &&
@@ -311,7 +568,7 @@ WEAK void prune_cache() {
         prune_candidate = more_recent;
     }
 #if CACHE_DEBUGGING
-    validate_cache();
+    validate_cache_shard(this);
 #endif
 }
 
@@ -326,10 +583,56 @@ WEAK void halide_memoization_cache_set_size(int64_t size) {
         size = kDefaultCacheSize;
     }
 
-    ScopedMutexLock lock(&memoization_lock);
+    total_max_cache_size = size;
+    cache_shards_inited = true;
+    for (int i = 0; i < kMaxCacheShards; i++) {
+        ScopedMutexLock lock(&cache_shards[i].lock);
+        cache_shards[i].max_cache_size = size / num_cache_shards;
+        cache_shards[i].prune();
+    }
+}
+
+WEAK void halide_memoization_cache_set_dir(const char *path) {
+    ScopedMutexLock lock(&disk_cache_lock);
+    // An explicit call beats the environment variable.
+    disk_cache_checked_env = true;
+    size_t i = 0;
+    if (path) {
+        size_t len = strlen(path);
+        // Strip a trailing slash; paths are formed as dir + '/' + name.
+        while (len > 1 && path[len - 1] == '/') {
+            len--;
+        }
+        for (; i < len && i < sizeof(disk_cache_dir) - 1; i++) {
+            disk_cache_dir[i] = path[i];
+        }
+    }
+    disk_cache_dir[i] = 0;
+}
+
+WEAK void halide_memoization_cache_set_disk_size(int64_t size) {
+    ScopedMutexLock lock(&disk_cache_lock);
+    disk_cache_max_size = size;
+}
+
+WEAK void halide_memoization_cache_set_shards(int shards) {
+    if (shards < 1) {
+        shards = 1;
+    }
+    if (shards > kMaxCacheShards) {
+        shards = kMaxCacheShards;
+    }
+    if (shards == num_cache_shards) {
+        return;
+    }
 
-    max_cache_size = size;
-    prune_cache();
+    // Entries are placed by key hash modulo the shard count, so a
+    // different count invalidates their placement. Flush rather than
+    // rehash; this is meant to be called once at startup, before any
+    // memoized pipelines run.
+    halide_memoization_cache_cleanup();
+    num_cache_shards = shards;
+    set_cache_shard_budgets();
 }
 
 WEAK int halide_memoization_cache_lookup(void *user_context, const uint8_t *cache_key, int32_t size,
@@ -337,7 +640,8 @@ WEAK int halide_memoization_cache_lookup(void *user_context, const uint8_t *cach
     uint32_t h = djb_hash(cache_key, size);
     uint32_t index = h % kHashTableSize;
 
-    ScopedMutexLock lock(&memoization_lock);
+    CacheShard *shard = get_cache_shard(h);
+    ScopedMutexLock lock(&shard->lock);
 
 #if CACHE_DEBUGGING
     debug_print_key(user_context, "halide_memoization_cache_lookup", cache_key, size);
@@ -352,7 +656,7 @@ WEAK int halide_memoization_cache_lookup(void *user_context, const uint8_t *cach
     }
 #endif
 
-    CacheEntry *entry = cache_entries[index];
+    CacheEntry *entry = shard->cache_entries[index];
     while (entry != nullptr) {
         if (entry->hash == h && entry->key_size == (size_t)size &&
             keys_equal(entry->key, cache_key, size) &&
@@ -366,23 +670,23 @@ WEAK int halide_memoization_cache_lookup(void *user_context, const uint8_t *cach
             }
 
             if (all_bounds_equal) {
-                if (entry != most_recently_used) {
+                if (entry != shard->most_recently_used) {
                     halide_assert(user_context, entry->more_recent != nullptr);
                     if (entry->less_recent != nullptr) {
                         entry->less_recent->more_recent = entry->more_recent;
                     } else {
-                        halide_assert(user_context, least_recently_used == entry);
-                        least_recently_used = entry->more_recent;
+                        halide_assert(user_context, shard->least_recently_used == entry);
+                        shard->least_recently_used = entry->more_recent;
                     }
                     halide_assert(user_context, entry->more_recent != nullptr);
                     entry->more_recent->less_recent = entry->less_recent;
 
                     entry->more_recent = nullptr;
-                    entry->less_recent = most_recently_used;
-                    if (most_recently_used != nullptr) {
-                        most_recently_used->more_recent = entry;
+                    entry->less_recent = shard->most_recently_used;
+                    if (shard->most_recently_used != nullptr) {
+                        shard->most_recently_used->more_recent = entry;
                     }
-                    most_recently_used = entry;
+                    shard->most_recently_used = entry;
                 }
 
                 for (int32_t i = 0; i < tuple_count; i++) {
@@ -415,8 +719,18 @@ WEAK int halide_memoization_cache_lookup(void *user_context, const uint8_t *cach
         header->entry = nullptr;
     }
 
+    // Fall back to the disk tier, filling the buffers just allocated
+    // for the miss. The entry is left out of the in-memory tier (the
+    // caller owns these buffers and won't call store), so repeated
+    // hits re-read the file; that's still far cheaper than
+    // recomputing, which is the case the disk tier exists for.
+    if (disk_cache_enabled() &&
+        disk_cache_load(user_context, h, cache_key, size, computed_bounds, tuple_count, tuple_buffers)) {
+        return 0;
+    }
+
 #if CACHE_DEBUGGING
-    validate_cache();
+    validate_cache_shard(shard);
 #endif
 
     return 1;
@@ -432,7 +746,8 @@ WEAK int halide_memoization_cache_store(void *user_context, const uint8_t *cache
 
     uint32_t index = h % kHashTableSize;
 
-    ScopedMutexLock lock(&memoization_lock);
+    CacheShard *shard = get_cache_shard(h);
+    ScopedMutexLock lock(&shard->lock);
 
 #if CACHE_DEBUGGING
     debug_print_key(user_context, "halide_memoization_cache_store", cache_key, size);
@@ -447,7 +762,7 @@ WEAK int halide_memoization_cache_store(void *user_context, const uint8_t *cache
     }
 #endif
 
-    CacheEntry *entry = cache_entries[index];
+    CacheEntry *entry = shard->cache_entries[index];
     while (entry != nullptr) {
         if (entry->hash == h && entry->key_size == (size_t)size &&
             keys_equal(entry->key, cache_key, size) &&
@@ -485,8 +800,8 @@ WEAK int halide_memoization_cache_store(void *user_context, const uint8_t *cache
             added_size += buf->size_in_bytes();
         }
     }
-    current_cache_size += added_size;
-    prune_cache();
+    shard->current_cache_size += added_size;
+    shard->prune();
 
     CacheEntry *new_entry = (CacheEntry *)halide_malloc(nullptr, sizeof(CacheEntry));
     bool inited = false;
@@ -495,7 +810,7 @@ WEAK int halide_memoization_cache_store(void *user_context, const uint8_t *cache
                                  has_eviction_key, eviction_key);
     }
     if (!inited) {
-        current_cache_size -= added_size;
+        shard->current_cache_size -= added_size;
 
         // This entry is still in use by the caller. Mark it as having no cache entry
         // so halide_memoization_cache_release can free the buffer.
@@ -509,16 +824,16 @@ WEAK int halide_memoization_cache_store(void *user_context, const uint8_t *cache
         return 0;
     }
 
-    new_entry->next = cache_entries[index];
-    new_entry->less_recent = most_recently_used;
-    if (most_recently_used != nullptr) {
-        most_recently_used->more_recent = new_entry;
+    new_entry->next = shard->cache_entries[index];
+    new_entry->less_recent = shard->most_recently_used;
+    if (shard->most_recently_used != nullptr) {
+        shard->most_recently_used->more_recent = new_entry;
     }
-    most_recently_used = new_entry;
-    if (least_recently_used == nullptr) {
-        least_recently_used = new_entry;
+    shard->most_recently_used = new_entry;
+    if (shard->least_recently_used == nullptr) {
+        shard->least_recently_used = new_entry;
     }
-    cache_entries[index] = new_entry;
+    shard->cache_entries[index] = new_entry;
 
     new_entry->in_use_count = tuple_count;
 
@@ -526,8 +841,12 @@ WEAK int halide_memoization_cache_store(void *user_context, const uint8_t *cache
         get_pointer_to_header(tuple_buffers[i]->host)->entry = new_entry;
     }
 
+    if (disk_cache_enabled()) {
+        disk_cache_store(user_context, h, cache_key, size, computed_bounds, tuple_count, tuple_buffers);
+    }
+
 #if CACHE_DEBUGGING
-    validate_cache();
+    validate_cache_shard(shard);
 #endif
     debug(user_context) << "Exiting halide_memoization_cache_store\n";
 
@@ -542,12 +861,13 @@ WEAK void halide_memoization_cache_release(void *user_context, void *host) {
     if (entry == nullptr) {
         halide_free(user_context, header);
     } else {
-        ScopedMutexLock lock(&memoization_lock);
+        CacheShard *shard = get_cache_shard(header->hash);
+        ScopedMutexLock lock(&shard->lock);
 
         halide_assert(user_context, entry->in_use_count > 0);
         entry->in_use_count--;
 #if CACHE_DEBUGGING
-        validate_cache();
+        validate_cache_shard(shard);
 #endif
     }
 
@@ -556,54 +876,64 @@ WEAK void halide_memoization_cache_release(void *user_context, void *host) {
 
 WEAK void halide_memoization_cache_cleanup() {
     debug(nullptr) << "halide_memoization_cache_cleanup\n";
-    for (size_t i = 0; i < kHashTableSize; i++) {
-        CacheEntry *entry = cache_entries[i];
-        cache_entries[i] = nullptr;
-        while (entry != nullptr) {
-            CacheEntry *next = entry->next;
-            entry->destroy();
-            halide_free(nullptr, entry);
-            entry = next;
+    for (int s = 0; s < kMaxCacheShards; s++) {
+        CacheShard *shard = &cache_shards[s];
+        for (size_t i = 0; i < kHashTableSize; i++) {
+            CacheEntry *entry = shard->cache_entries[i];
+            shard->cache_entries[i] = nullptr;
+            while (entry != nullptr) {
+                CacheEntry *next = entry->next;
+                entry->destroy();
+                halide_free(nullptr, entry);
+                entry = next;
+            }
         }
+        shard->current_cache_size = 0;
+        shard->most_recently_used = nullptr;
+        shard->least_recently_used = nullptr;
     }
-    current_cache_size = 0;
-    most_recently_used = nullptr;
-    least_recently_used = nullptr;
 }
 
 WEAK void halide_memoization_cache_evict(void *user_context, uint64_t eviction_key) {
-    ScopedMutexLock lock(&memoization_lock);
-
-    for (size_t i = 0; i < kHashTableSize; i++) {
-        CacheEntry *entry = cache_entries[i];
-        if (entry != nullptr) {
-            CacheEntry **prev = &cache_entries[i];
-            while (entry != nullptr) {
-                CacheEntry *next = entry->next;
-                if (entry->has_eviction_key && entry->eviction_key == eviction_key) {
-                    *prev = next;
-                    if (entry->more_recent != nullptr) {
-                        entry->more_recent->less_recent = entry->less_recent;
-                    } else {
-                        most_recently_used = entry->less_recent;
-                    }
-                    if (entry->less_recent != nullptr) {
-                        entry->less_recent->more_recent = entry->more_recent;
+    for (int s = 0; s < kMaxCacheShards; s++) {
+        CacheShard *shard = &cache_shards[s];
+        ScopedMutexLock lock(&shard->lock);
+
+        for (size_t i = 0; i < kHashTableSize; i++) {
+            CacheEntry *entry = shard->cache_entries[i];
+            if (entry != nullptr) {
+                CacheEntry **prev = &shard->cache_entries[i];
+                while (entry != nullptr) {
+                    CacheEntry *next = entry->next;
+                    if (entry->has_eviction_key && entry->eviction_key == eviction_key) {
+                        *prev = next;
+                        if (entry->more_recent != nullptr) {
+                            entry->more_recent->less_recent = entry->less_recent;
+                        } else {
+                            shard->most_recently_used = entry->less_recent;
+                        }
+                        if (entry->less_recent != nullptr) {
+                            entry->less_recent->more_recent = entry->more_recent;
+                        } else {
+                            shard->least_recently_used = entry->more_recent;
+                        }
+                        // Decrease cache used amount.
+                        for (uint32_t j = 0; j < entry->tuple_count; j++) {
+                            shard->current_cache_size -= entry->buf[j].size_in_bytes();
+                        }
+                        entry->destroy();
+                        halide_free(user_context, entry);
                     } else {
-                        least_recently_used = entry->more_recent;
+                        prev = &entry->next;
                     }
-                    entry->destroy();
-                    halide_free(user_context, entry);
-                } else {
-                    prev = &entry->next;
+                    entry = next;
                 }
-                entry = next;
             }
         }
-    }
 #if CACHE_DEBUGGING
-    validate_cache();
+        validate_cache_shard(shard);
 #endif
+    }
 }
 
 namespace {
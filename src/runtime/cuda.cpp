@@ -100,13 +100,264 @@ WEAK void ensure_libcuda_init(void *user_context) {
 extern WEAK halide_device_interface_t cuda_device_interface;
 
 WEAK const char *get_error_name(CUresult error);
-WEAK CUresult create_cuda_context(void *user_context, CUcontext *ctx);
+WEAK CUresult create_cuda_context(void *user_context, CUcontext *ctx, int forced_device = -1);
 
 // A cuda context defined in this module with weak linkage
 CUcontext WEAK context = nullptr;
 // This lock protexts the above context variable.
 WEAK halide_mutex context_lock;
 
+// Support for sharding work across the devices of a multi-GPU
+// machine: user_contexts can be mapped to a device ordinal with
+// halide_cuda_set_device_for_user_context, and the default
+// halide_cuda_acquire_context resolves a mapped user_context to a
+// lazily-created context on that device instead of the global context
+// above. Each ordinal gets one context, shared by every user_context
+// mapped to it. The contexts array is protected by context_lock; the
+// mapping table by its own lock, with lock-free reads on the hot path
+// (callers establish mappings before launching work on them).
+const int kMaxDeviceOrdinals = 16;
+WEAK CUcontext device_contexts[kMaxDeviceOrdinals];
+const int kMaxDeviceMapEntries = 64;
+WEAK struct DeviceMapEntry {
+    void *user_context;
+    int device;
+    volatile int valid;
+} device_map[kMaxDeviceMapEntries];
+WEAK halide_mutex device_map_lock;
+
+WEAK int device_for_user_context(void *user_context) {
+    for (int i = 0; i < kMaxDeviceMapEntries; i++) {
+        DeviceMapEntry *e = &device_map[i];
+        if (e->valid && e->user_context == user_context) {
+            return e->device;
+        }
+    }
+    return -1;
+}
+
+// An optional pool of streams, so that independent pipeline
+// invocations (distinguished by their user_context) run on their own
+// non-blocking streams and overlap on the GPU instead of serializing
+// on the null stream. Entries are write-once: the fast path scans the
+// table with plain loads and takes no lock; the lock below is only
+// held while creating a stream the first time a user_context shows
+// up. Enabled by halide_cuda_enable_stream_pool or the
+// HL_CUDA_STREAM_POOL environment variable.
+const int kMaxPooledStreams = 64;
+WEAK struct StreamPoolEntry {
+    void *user_context;
+    CUcontext ctx;
+    CUstream stream;
+    volatile int valid;
+} stream_pool[kMaxPooledStreams];
+WEAK halide_mutex stream_pool_lock;
+
+// Cached results of occupancy queries, keyed by context and function
+// handle (which is stable for a loaded module within its context).
+const int kMaxOccupancyCacheEntries = 64;
+WEAK struct OccupancyCacheEntry {
+    CUcontext ctx;
+    CUfunction fn;
+    int block_size;
+} occupancy_cache[kMaxOccupancyCacheEntries];
+WEAK int occupancy_cache_count = 0;
+WEAK halide_mutex occupancy_cache_lock;
+// -1 = consult the environment on first use, 0 = off, 1 = on.
+WEAK int stream_pool_enabled = -1;
+
+WEAK bool stream_pool_in_use() {
+    if (stream_pool_enabled < 0) {
+        const char *e = getenv("HL_CUDA_STREAM_POOL");
+        stream_pool_enabled = (e && e[0]) ? 1 : 0;
+    }
+    return stream_pool_enabled == 1;
+}
+
+WEAK int stream_pool_get(void *user_context, CUcontext ctx, CUstream *stream) {
+    // Fast path: the stream for this user_context/context already
+    // exists. Entries are published with a barrier before valid is
+    // set and never change afterwards, so no lock is needed here.
+    for (int i = 0; i < kMaxPooledStreams; i++) {
+        StreamPoolEntry *e = &stream_pool[i];
+        if (e->valid && e->user_context == user_context && e->ctx == ctx) {
+            *stream = e->stream;
+            return 0;
+        }
+    }
+
+    ScopedMutexLock lock(&stream_pool_lock);
+
+    StreamPoolEntry *free_entry = nullptr;
+    for (int i = 0; i < kMaxPooledStreams; i++) {
+        StreamPoolEntry *e = &stream_pool[i];
+        if (e->valid) {
+            if (e->user_context == user_context && e->ctx == ctx) {
+                // Someone else created it while we waited for the lock.
+                *stream = e->stream;
+                return 0;
+            }
+        } else if (!free_entry) {
+            free_entry = e;
+        }
+    }
+
+    if (!free_entry) {
+        // Table is full; fall back to the default stream rather than
+        // churning streams.
+        *stream = nullptr;
+        return 0;
+    }
+
+    CUstream new_stream;
+    CUresult err = cuStreamCreate(&new_stream, 1 /* CU_STREAM_NON_BLOCKING */);
+    if (err != CUDA_SUCCESS) {
+        error(user_context) << "CUDA: cuStreamCreate failed: "
+                            << get_error_name(err);
+        return err;
+    }
+
+    free_entry->user_context = user_context;
+    free_entry->ctx = ctx;
+    free_entry->stream = new_stream;
+    __sync_synchronize();
+    free_entry->valid = 1;
+
+    *stream = new_stream;
+    return 0;
+}
+
+// Destroy all pooled streams belonging to ctx. Called (with ctx
+// current) when the context is released.
+WEAK void stream_pool_release_context(void *user_context, CUcontext ctx) {
+    ScopedMutexLock lock(&stream_pool_lock);
+    for (int i = 0; i < kMaxPooledStreams; i++) {
+        StreamPoolEntry *e = &stream_pool[i];
+        if (e->valid && e->ctx == ctx) {
+            if (cuStreamDestroy_v2) {
+                cuStreamDestroy_v2(e->stream);
+            }
+            e->valid = 0;
+            e->user_context = nullptr;
+            e->ctx = nullptr;
+            e->stream = nullptr;
+        }
+    }
+}
+
+// Cached per-(module, entry point) launch state: the resolved
+// CUfunction and the argument block marshalled for the previous
+// launch. Without it, every launch pays a cuModuleGetFunction round
+// trip, two heap allocations, and a full re-marshalling, which adds
+// up in pipelines that launch many kernels per frame with
+// mostly-unchanged parameters. Each argument occupies its own 8-byte
+// slot whether it is a scalar value or a translated device handle;
+// slots are only rewritten when the incoming value differs. The
+// per-entry mutex is held across the launch, so concurrent launches
+// of the same kernel serialize their setup.
+const int kMaxLaunchCacheEntries = 64;
+const int kMaxLaunchCacheArgs = 32;
+WEAK struct LaunchCacheEntry {
+    CUmodule mod;
+    const char *entry_name;
+    CUfunction fn;
+    size_t num_args;
+    uint64_t arg_values[kMaxLaunchCacheArgs];
+    void *translated_args[kMaxLaunchCacheArgs + 1];
+    halide_mutex mutex;
+    volatile int valid;
+} launch_cache[kMaxLaunchCacheEntries];
+WEAK halide_mutex launch_cache_lock;
+
+// Find or create the launch cache entry for a kernel. The entry name
+// is compared by pointer; it is a string constant in the generated
+// code, so it is stable for the lifetime of the pipeline. Returns
+// nullptr (and the caller falls back to uncached launching) if the
+// function cannot be resolved or the table is full.
+WEAK LaunchCacheEntry *launch_cache_get(void *user_context, CUmodule mod, const char *entry_name) {
+    // Fast path: entries are published with a barrier before valid is
+    // set and their key fields never change afterwards. The acquire
+    // load pairs with that barrier so the key fields are visible on
+    // weakly-ordered architectures.
+    for (int i = 0; i < kMaxLaunchCacheEntries; i++) {
+        LaunchCacheEntry *e = &launch_cache[i];
+        if (__atomic_load_n(&e->valid, __ATOMIC_ACQUIRE) && e->mod == mod && e->entry_name == entry_name) {
+            return e;
+        }
+    }
+
+    ScopedMutexLock lock(&launch_cache_lock);
+
+    LaunchCacheEntry *free_entry = nullptr;
+    for (int i = 0; i < kMaxLaunchCacheEntries; i++) {
+        LaunchCacheEntry *e = &launch_cache[i];
+        if (e->valid) {
+            if (e->mod == mod && e->entry_name == entry_name) {
+                // Someone else created it while we waited for the lock.
+                return e;
+            }
+        } else if (!free_entry) {
+            free_entry = e;
+        }
+    }
+
+    if (!free_entry) {
+        return nullptr;
+    }
+
+    CUfunction fn;
+    CUresult err = cuModuleGetFunction(&fn, mod, entry_name);
+    if (err != CUDA_SUCCESS) {
+        return nullptr;
+    }
+
+    free_entry->mod = mod;
+    free_entry->entry_name = entry_name;
+    free_entry->fn = fn;
+    // Forces a full rewrite of the argument slots on first use.
+    free_entry->num_args = (size_t)-1;
+    __sync_synchronize();
+    free_entry->valid = 1;
+
+    return free_entry;
+}
+
+// Drop all cached launch state. Called when modules are unloaded, at
+// which point the cached CUfunction handles are dangling.
+WEAK void launch_cache_release() {
+    ScopedMutexLock lock(&launch_cache_lock);
+    for (int i = 0; i < kMaxLaunchCacheEntries; i++) {
+        LaunchCacheEntry *e = &launch_cache[i];
+        e->valid = 0;
+        e->mod = nullptr;
+        e->entry_name = nullptr;
+        e->fn = nullptr;
+    }
+}
+
+// State for CUDA Graph capture. At most one capture can be in flight
+// at a time; the stream being captured is private to the capturing
+// thread, so the launches and copies made between
+// halide_cuda_graph_capture_begin/end are recorded into the graph
+// instead of executing. Begin/end and the work between them happen on
+// one thread, so the unlocked reads in graph_capture_stream see the
+// values that thread wrote.
+WEAK halide_mutex graph_capture_lock;
+WEAK struct GraphCaptureState {
+    void *user_context;
+    CUstream stream;
+    volatile int active;
+} graph_capture;
+
+// Returns the stream being captured if a capture begun by this
+// user_context is in flight, otherwise nullptr.
+WEAK CUstream graph_capture_stream(void *user_context) {
+    if (graph_capture.active && graph_capture.user_context == user_context) {
+        return graph_capture.stream;
+    }
+    return nullptr;
+}
+
 // A free list, used when allocations are being cached.
 WEAK struct FreeListItem {
     CUdeviceptr ptr;
@@ -117,6 +368,106 @@ WEAK struct FreeListItem {
 } *free_list = nullptr;
 WEAK halide_mutex free_list_lock;
 
+// Pinned (page-locked) host allocations handed out by
+// halide_cuda_device_and_host_malloc when the pinned-host mode is on,
+// so that copies to and from the device are true DMA transfers
+// instead of staged copies through a driver-internal bounce
+// buffer. Live allocations are tracked so that
+// halide_cuda_device_and_host_free knows the host pointer came from
+// cuMemHostAlloc rather than halide_malloc; freed ones are cached for
+// reuse with the same best-fit policy as the device free list
+// above. Enabled by halide_cuda_enable_pinned_host_allocations or the
+// HL_CUDA_PINNED_HOST environment variable.
+WEAK struct PinnedHostAlloc {
+    void *ptr;
+    CUcontext ctx;
+    size_t size;
+    PinnedHostAlloc *next;
+} *pinned_live_list = nullptr, *pinned_free_list = nullptr;
+WEAK halide_mutex pinned_host_lock;
+// -1 = consult the environment on first use, 0 = off, 1 = on.
+WEAK int pinned_host_enabled = -1;
+
+WEAK bool pinned_host_in_use() {
+    if (pinned_host_enabled < 0) {
+        const char *e = getenv("HL_CUDA_PINNED_HOST");
+        pinned_host_enabled = (e && e[0]) ? 1 : 0;
+    }
+    return pinned_host_enabled == 1;
+}
+
+// Stream-ordered device allocations. cuMemAlloc synchronizes against
+// all in-flight work on the device before returning, so per-frame
+// temporaries stall multi-stream runs even when memory is plentiful.
+// When this mode is on, device allocations come from the driver's
+// stream-ordered memory pool with cuMemAllocAsync on the invocation's
+// stream instead, and are returned to the pool with cuMemFreeAsync,
+// ordered after the work that used them. The pool recycles freed
+// memory without fragmentation-induced misses, so async allocations
+// bypass the halide_reuse_device_allocations free list above.
+// Allocations made this way must be freed with cuMemFreeAsync, and
+// the mode can be toggled while sync allocations are live, so live
+// async allocations are tracked here. Enabled by
+// halide_cuda_enable_async_allocations or the HL_CUDA_ASYNC_ALLOC
+// environment variable; drivers without memory pool support (older
+// than CUDA 11.2) fall back to cuMemAlloc.
+WEAK struct AsyncAlloc {
+    CUdeviceptr ptr;
+    AsyncAlloc *next;
+} *async_live_list = nullptr;
+WEAK halide_mutex async_alloc_lock;
+// -1 = consult the environment on first use, 0 = off, 1 = on.
+WEAK int async_alloc_enabled = -1;
+
+WEAK bool async_alloc_in_use() {
+    if (async_alloc_enabled < 0) {
+        const char *e = getenv("HL_CUDA_ASYNC_ALLOC");
+        async_alloc_enabled = (e && e[0]) ? 1 : 0;
+    }
+    return async_alloc_enabled == 1;
+}
+
+WEAK void record_async_allocation(CUdeviceptr ptr) {
+    AsyncAlloc *node = (AsyncAlloc *)malloc(sizeof(AsyncAlloc));
+    node->ptr = ptr;
+    ScopedMutexLock lock(&async_alloc_lock);
+    node->next = async_live_list;
+    async_live_list = node;
+}
+
+// Returns true and forgets the entry if ptr was allocated with
+// cuMemAllocAsync.
+WEAK bool forget_async_allocation(CUdeviceptr ptr) {
+    ScopedMutexLock lock(&async_alloc_lock);
+    for (AsyncAlloc **prev = &async_live_list; *prev; prev = &(*prev)->next) {
+        if ((*prev)->ptr == ptr) {
+            AsyncAlloc *node = *prev;
+            *prev = node->next;
+            free(node);
+            return true;
+        }
+    }
+    return false;
+}
+
+// By default the driver spins a CPU core inside cuCtxSynchronize and
+// friends while the GPU works. The blocking-sync mode creates
+// contexts with CU_CTX_SCHED_BLOCKING_SYNC and waits on blocking
+// events in halide_cuda_device_sync, so waiting threads sleep in the
+// driver and the cores are free to run other tasks. Enabled by
+// halide_cuda_enable_blocking_sync or the HL_CUDA_BLOCKING_SYNC
+// environment variable.
+// -1 = consult the environment on first use, 0 = off, 1 = on.
+WEAK int blocking_sync_enabled = -1;
+
+WEAK bool blocking_sync_in_use() {
+    if (blocking_sync_enabled < 0) {
+        const char *e = getenv("HL_CUDA_BLOCKING_SYNC");
+        blocking_sync_enabled = (e && e[0]) ? 1 : 0;
+    }
+    return blocking_sync_enabled == 1;
+}
+
 }  // namespace Cuda
 }  // namespace Internal
 }  // namespace Runtime
@@ -144,6 +495,34 @@ WEAK int halide_cuda_acquire_context(void *user_context, CUcontext *ctx, bool cr
     // If the context has not been initialized, initialize it now.
     halide_assert(user_context, &context != nullptr);
 
+    // If this user_context has been mapped to a specific device,
+    // resolve to the per-device context instead of the global one.
+    int mapped_device = device_for_user_context(user_context);
+    if (mapped_device >= 0) {
+        if (mapped_device >= kMaxDeviceOrdinals) {
+            error(user_context) << "CUDA: device ordinal " << mapped_device << " out of range";
+            return CUDA_ERROR_INVALID_DEVICE;
+        }
+        CUcontext local_val = device_contexts[mapped_device];
+        if (local_val == nullptr) {
+            if (!create) {
+                *ctx = nullptr;
+                return 0;
+            }
+            ScopedMutexLock spinlock(&context_lock);
+            local_val = device_contexts[mapped_device];
+            if (local_val == nullptr) {
+                CUresult error = create_cuda_context(user_context, &local_val, mapped_device);
+                if (error != CUDA_SUCCESS) {
+                    return error;
+                }
+                device_contexts[mapped_device] = local_val;
+            }
+        }
+        *ctx = local_val;
+        return 0;
+    }
+
     // Note that this null-check of the context is *not* locked with
     // respect to device_release, so we may get a non-null context
     // that's in the process of being destroyed. Things will go badly
@@ -189,6 +568,19 @@ WEAK int halide_cuda_release_context(void *user_context) {
 // any sort of scoping must be handled by that of the
 // halide_cuda_acquire_context/halide_cuda_release_context pair, not this call.
 WEAK int halide_cuda_get_stream(void *user_context, CUcontext ctx, CUstream *stream) {
+    // If this user_context is capturing a graph, all work must go to
+    // the capture stream so it is recorded rather than executed.
+    CUstream capture_stream = graph_capture_stream(user_context);
+    if (capture_stream) {
+        *stream = capture_stream;
+        return 0;
+    }
+    if (stream_pool_in_use() && cuStreamCreate) {
+        // Give each user_context its own non-blocking stream, so that
+        // pipelines invoked concurrently from different threads (with
+        // distinct user_contexts) can overlap on the GPU.
+        return stream_pool_get(user_context, ctx, stream);
+    }
     // There are two default streams we could use. stream 0 is fully
     // synchronous. stream 2 gives a separate non-blocking stream per
     // thread.
@@ -196,6 +588,56 @@ WEAK int halide_cuda_get_stream(void *user_context, CUcontext ctx, CUstream *str
     return 0;
 }
 
+WEAK void halide_cuda_enable_stream_pool(void *user_context, bool enable) {
+    stream_pool_enabled = enable ? 1 : 0;
+}
+
+WEAK void halide_cuda_enable_pinned_host_allocations(void *user_context, bool enable) {
+    pinned_host_enabled = enable ? 1 : 0;
+}
+
+WEAK void halide_cuda_enable_blocking_sync(void *user_context, bool enable) {
+    blocking_sync_enabled = enable ? 1 : 0;
+}
+
+WEAK void halide_cuda_enable_async_allocations(void *user_context, bool enable) {
+    async_alloc_enabled = enable ? 1 : 0;
+}
+
+WEAK int halide_cuda_set_device_for_user_context(void *user_context, int device) {
+    ScopedMutexLock lock(&device_map_lock);
+    DeviceMapEntry *free_entry = nullptr;
+    for (int i = 0; i < kMaxDeviceMapEntries; i++) {
+        DeviceMapEntry *e = &device_map[i];
+        if (e->valid) {
+            if (e->user_context == user_context) {
+                if (device < 0) {
+                    e->valid = 0;
+                    e->user_context = nullptr;
+                } else {
+                    e->device = device;
+                }
+                return 0;
+            }
+        } else if (!free_entry) {
+            free_entry = e;
+        }
+    }
+    if (device < 0) {
+        // Removing a mapping that doesn't exist is a no-op.
+        return 0;
+    }
+    if (!free_entry) {
+        error(user_context) << "CUDA: too many user_context to device mappings\n";
+        return -1;
+    }
+    free_entry->user_context = user_context;
+    free_entry->device = device;
+    __sync_synchronize();
+    free_entry->valid = 1;
+    return 0;
+}
+
 }  // extern "C"
 
 namespace Halide {
@@ -247,7 +689,7 @@ public:
 
 WEAK Halide::Internal::GPUCompilationCache<CUcontext, CUmodule> compilation_cache;
 
-WEAK CUresult create_cuda_context(void *user_context, CUcontext *ctx) {
+WEAK CUresult create_cuda_context(void *user_context, CUcontext *ctx, int forced_device) {
     // Initialize CUDA
     ensure_libcuda_init(user_context);
     if (!cuInit) {
@@ -276,7 +718,15 @@ WEAK CUresult create_cuda_context(void *user_context, CUcontext *ctx) {
         return CUDA_ERROR_NO_DEVICE;
     }
 
-    int device = halide_get_gpu_device(user_context);
+    int device = forced_device;
+    if (device >= deviceCount) {
+        error(user_context) << "CUDA: device ordinal " << device
+                            << " out of range; " << deviceCount << " devices available";
+        return CUDA_ERROR_INVALID_DEVICE;
+    }
+    if (device == -1) {
+        device = halide_get_gpu_device(user_context);
+    }
     if (device == -1 && deviceCount == 1) {
         device = 0;
     } else if (device == -1) {
@@ -416,8 +866,9 @@ WEAK CUresult create_cuda_context(void *user_context, CUcontext *ctx) {
 #endif
 
     // Create context
+    unsigned int ctx_flags = blocking_sync_in_use() ? CU_CTX_SCHED_BLOCKING_SYNC : 0;
     debug(user_context) << "    cuCtxCreate " << dev << " -> ";
-    err = cuCtxCreate(ctx, 0, dev);
+    err = cuCtxCreate(ctx, ctx_flags, dev);
     if (err != CUDA_SUCCESS) {
         debug(user_context) << get_error_name(err) << "\n";
         error(user_context) << "CUDA: cuCtxCreate failed: "
@@ -559,6 +1010,22 @@ WEAK int halide_cuda_release_unused_device_allocations(void *user_context) {
         free(to_free);
         to_free = next;
     }
+
+    PinnedHostAlloc *pinned_to_free;
+    {
+        ScopedMutexLock lock(&pinned_host_lock);
+        pinned_to_free = pinned_free_list;
+        pinned_free_list = nullptr;
+    }
+    while (pinned_to_free) {
+        debug(user_context) << "    cuMemFreeHost " << pinned_to_free->ptr << "\n";
+        if (cuMemFreeHost) {
+            cuMemFreeHost(pinned_to_free->ptr);
+        }
+        PinnedHostAlloc *next = pinned_to_free->next;
+        free(pinned_to_free);
+        pinned_to_free = next;
+    }
     return 0;
 }
 
@@ -614,7 +1081,22 @@ WEAK int halide_cuda_device_free(void *user_context, halide_buffer_t *buf) {
     halide_assert(user_context, validate_device_pointer(user_context, buf));
 
     CUresult err = CUDA_SUCCESS;
-    if (halide_can_reuse_device_allocations(user_context)) {
+    if (forget_async_allocation(dev_ptr)) {
+        // Stream-ordered allocations must go back to the driver's
+        // pool with cuMemFreeAsync. The free is ordered after the
+        // work already queued on the invocation's stream, so there is
+        // no need to synchronize first, and the pool does its own
+        // recycling, so the free list below is not used.
+        CUstream stream = nullptr;
+        int result = halide_cuda_get_stream(user_context, ctx.context, &stream);
+        if (result != 0) {
+            error(user_context) << "CUDA: In halide_cuda_device_free, halide_cuda_get_stream returned " << result << "\n";
+        }
+        debug(user_context) << "    cuMemFreeAsync " << (void *)(dev_ptr) << "\n";
+        err = cuMemFreeAsync(dev_ptr, stream);
+        // As with cuMemFree below, if this fails it isn't likely to
+        // succeed later, so just drop the reference.
+    } else if (halide_can_reuse_device_allocations(user_context)) {
         debug(user_context) << "    caching allocation for later use: " << (void *)(dev_ptr) << "\n";
 
         FreeListItem *item = (FreeListItem *)malloc(sizeof(FreeListItem));
@@ -692,6 +1174,12 @@ WEAK int halide_cuda_device_release(void *user_context) {
 
         compilation_cache.delete_context(user_context, ctx, cuModuleUnload);
 
+        // The modules just unloaded may back cached launch state.
+        launch_cache_release();
+
+        // Destroy any pooled streams created against this context.
+        stream_pool_release_context(user_context, ctx);
+
         CUcontext old_ctx;
         cuCtxPopCurrent(&old_ctx);
 
@@ -706,6 +1194,17 @@ WEAK int halide_cuda_device_release(void *user_context) {
                 err = cuCtxDestroy(context);
                 halide_assert(user_context, err == CUDA_SUCCESS || err == CUDA_ERROR_DEINITIALIZED);
                 context = nullptr;
+            } else {
+                // A per-device context created for a mapped user_context.
+                for (int i = 0; i < kMaxDeviceOrdinals; i++) {
+                    if (ctx == device_contexts[i]) {
+                        debug(user_context) << "    cuCtxDestroy " << ctx << "\n";
+                        err = cuCtxDestroy(ctx);
+                        halide_assert(user_context, err == CUDA_SUCCESS || err == CUDA_ERROR_DEINITIALIZED);
+                        device_contexts[i] = nullptr;
+                        break;
+                    }
+                }
             }
         }  // spinlock
     }
@@ -807,7 +1306,35 @@ WEAK int halide_cuda_device_malloc(void *user_context, halide_buffer_t *buf) {
         to_free = next;
     }
 
-    if (!p) {
+    if (!p && async_alloc_in_use() && cuMemAllocAsync && cuMemFreeAsync) {
+        // Allocate from the driver's stream-ordered memory pool. This
+        // doesn't synchronize against in-flight kernels, and the pool
+        // recycles freed memory, so the free list above is not
+        // consulted for these.
+        CUstream stream = nullptr;
+        int result = halide_cuda_get_stream(user_context, ctx.context, &stream);
+        if (result != 0) {
+            error(user_context) << "CUDA: In halide_cuda_device_malloc, halide_cuda_get_stream returned " << result << "\n";
+        }
+
+        debug(user_context) << "    cuMemAllocAsync " << (uint64_t)size << " -> ";
+        CUresult err = cuMemAllocAsync(&p, size, stream);
+        if (err == CUDA_ERROR_OUT_OF_MEMORY) {
+            // Our own free list may be holding the memory the pool
+            // needs.
+            halide_cuda_release_unused_device_allocations(user_context);
+            err = cuMemAllocAsync(&p, size, stream);
+        }
+        if (err != CUDA_SUCCESS) {
+            debug(user_context) << get_error_name(err) << "\n";
+            error(user_context) << "CUDA: cuMemAllocAsync failed: "
+                                << get_error_name(err);
+            return err;
+        } else {
+            debug(user_context) << (void *)p << "\n";
+        }
+        record_async_allocation(p);
+    } else if (!p) {
         debug(user_context) << "    cuMemAlloc " << (uint64_t)size << " -> ";
 
         // Quantize all allocation sizes to the top 4 bits, to make
@@ -841,8 +1368,125 @@ WEAK int halide_cuda_device_malloc(void *user_context, halide_buffer_t *buf) {
 }
 
 namespace {
+
+// State for a device-to-device copy whose source and destination live
+// in different contexts (i.e. usually on different GPUs). When the
+// devices can access each other the driver's peer copy is used;
+// otherwise each chunk bounces through a pinned host staging buffer,
+// which is still one PCIe round trip cheaper than the generic
+// host-memory fallback in halide_buffer_copy.
+struct cuda_cross_context_copy_info {
+    CUcontext src_ctx;
+    CUcontext dst_ctx;
+    bool use_peer;
+    bool staging_pinned;
+    void *staging;
+    size_t staging_size;
+};
+
+// The device owning a context, or -1.
+WEAK CUdevice device_of_context(CUcontext ctx) {
+    CUcontext ignore;
+    if (cuCtxPushCurrent(ctx) != CUDA_SUCCESS) {
+        return (CUdevice)-1;
+    }
+    CUdevice dev;
+    CUresult err = cuCtxGetDevice(&dev);
+    cuCtxPopCurrent(&ignore);
+    return (err == CUDA_SUCCESS) ? dev : (CUdevice)-1;
+}
+
+WEAK bool cuda_peer_access_allowed(CUcontext src_ctx, CUcontext dst_ctx) {
+    if (!cuDeviceCanAccessPeer || !cuMemcpyPeer) {
+        return false;
+    }
+    CUdevice src_dev = device_of_context(src_ctx);
+    CUdevice dst_dev = device_of_context(dst_ctx);
+    if (src_dev == (CUdevice)-1 || dst_dev == (CUdevice)-1) {
+        return false;
+    }
+    if (src_dev == dst_dev) {
+        // Two contexts on the same device; the peer copy handles this
+        // without any staging.
+        return true;
+    }
+    int can_access = 0;
+    if (cuDeviceCanAccessPeer(&can_access, dst_dev, src_dev) != CUDA_SUCCESS) {
+        return false;
+    }
+    return can_access != 0;
+}
+
+WEAK int cuda_cross_context_chunk_copy(void *user_context, cuda_cross_context_copy_info *info,
+                                       CUdeviceptr dst, CUdeviceptr src, size_t size) {
+    if (info->use_peer) {
+        debug(user_context) << "cuMemcpyPeer(" << (void *)dst << ", " << (void *)src << ", " << (int64_t)size << ")\n";
+        CUstream capture_stream = graph_capture_stream(user_context);
+        CUresult err;
+        if (capture_stream && cuMemcpyPeerAsync) {
+            err = cuMemcpyPeerAsync(dst, info->dst_ctx, src, info->src_ctx, size, capture_stream);
+        } else {
+            err = cuMemcpyPeer(dst, info->dst_ctx, src, info->src_ctx, size);
+        }
+        if (err != CUDA_SUCCESS) {
+            error(user_context) << "CUDA: cuMemcpyPeer failed: " << get_error_name(err);
+            return (int)err;
+        }
+        return 0;
+    }
+
+    // Bounce through host memory, pinned when the driver provides it
+    // so both legs run at full transfer speed.
+    if (info->staging_size < size) {
+        if (info->staging) {
+            if (info->staging_pinned) {
+                cuMemFreeHost(info->staging);
+            } else {
+                halide_free(user_context, info->staging);
+            }
+            info->staging = nullptr;
+            info->staging_size = 0;
+        }
+        info->staging_pinned = cuMemHostAlloc != nullptr &&
+                               cuMemHostAlloc(&info->staging, size, 0) == CUDA_SUCCESS;
+        if (!info->staging_pinned) {
+            info->staging = halide_malloc(user_context, size);
+        }
+        if (info->staging == nullptr) {
+            error(user_context) << "CUDA: could not allocate staging buffer for cross-device copy";
+            return halide_error_code_out_of_memory;
+        }
+        info->staging_size = size;
+    }
+
+    // Each leg runs with the context that owns its device pointer
+    // current; the pointers are not valid in each other's contexts
+    // when peer access is unavailable.
+    CUcontext ignore;
+    CUresult err = cuCtxPushCurrent(info->src_ctx);
+    if (err == CUDA_SUCCESS) {
+        debug(user_context) << "cuMemcpyDtoH(" << info->staging << ", " << (void *)src << ", " << (int64_t)size << ")\n";
+        err = cuMemcpyDtoH(info->staging, src, size);
+        cuCtxPopCurrent(&ignore);
+    }
+    if (err == CUDA_SUCCESS) {
+        err = cuCtxPushCurrent(info->dst_ctx);
+        if (err == CUDA_SUCCESS) {
+            debug(user_context) << "cuMemcpyHtoD(" << (void *)dst << ", " << info->staging << ", " << (int64_t)size << ")\n";
+            err = cuMemcpyHtoD(dst, info->staging, size);
+            cuCtxPopCurrent(&ignore);
+        }
+    }
+    if (err != CUDA_SUCCESS) {
+        error(user_context) << "CUDA: staged cross-device copy failed: " << get_error_name(err);
+        return (int)err;
+    }
+    return 0;
+}
+
 WEAK int cuda_do_multidimensional_copy(void *user_context, const device_copy &c,
-                                       uint64_t src, uint64_t dst, int d, bool from_host, bool to_host) {
+                                       uint64_t src, uint64_t dst, int d, bool from_host, bool to_host,
+                                       cuda_cross_context_copy_info *cross) {
     if (d > MAX_COPY_DIMS) {
         error(user_context) << "Buffer has too many dimensions to copy to/from GPU\n";
         return -1;
@@ -852,18 +1496,38 @@ WEAK int cuda_do_multidimensional_copy(void *user_context, const device_copy &c,
         debug(user_context) << "    from " << (from_host ? "host" : "device")
                             << " to " << (to_host ? "host" : "device") << ", "
                             << (void *)src << " -> " << (void *)dst << ", " << c.chunk_size << " bytes\n";
+        // While this user_context is capturing a graph, synchronous
+        // copies are illegal; record the copy on the capture stream
+        // instead.
+        CUstream capture_stream = graph_capture_stream(user_context);
         if (!from_host && to_host) {
             debug(user_context) << "cuMemcpyDtoH(" << (void *)dst << ", " << (void *)src << ", " << c.chunk_size << ")\n";
             copy_name = "cuMemcpyDtoH";
-            err = cuMemcpyDtoH((void *)dst, (CUdeviceptr)src, c.chunk_size);
+            if (capture_stream && cuMemcpyDtoHAsync_v2) {
+                err = cuMemcpyDtoHAsync_v2((void *)dst, (CUdeviceptr)src, c.chunk_size, capture_stream);
+            } else {
+                err = cuMemcpyDtoH((void *)dst, (CUdeviceptr)src, c.chunk_size);
+            }
         } else if (from_host && !to_host) {
             debug(user_context) << "cuMemcpyHtoD(" << (void *)dst << ", " << (void *)src << ", " << c.chunk_size << ")\n";
             copy_name = "cuMemcpyHtoD";
-            err = cuMemcpyHtoD((CUdeviceptr)dst, (void *)src, c.chunk_size);
+            if (capture_stream && cuMemcpyHtoDAsync_v2) {
+                err = cuMemcpyHtoDAsync_v2((CUdeviceptr)dst, (void *)src, c.chunk_size, capture_stream);
+            } else {
+                err = cuMemcpyHtoD((CUdeviceptr)dst, (void *)src, c.chunk_size);
+            }
         } else if (!from_host && !to_host) {
+            if (cross) {
+                return cuda_cross_context_chunk_copy(user_context, cross,
+                                                     (CUdeviceptr)dst, (CUdeviceptr)src, c.chunk_size);
+            }
             debug(user_context) << "cuMemcpyDtoD(" << (void *)dst << ", " << (void *)src << ", " << c.chunk_size << ")\n";
             copy_name = "cuMemcpyDtoD";
-            err = cuMemcpyDtoD((CUdeviceptr)dst, (CUdeviceptr)src, c.chunk_size);
+            if (capture_stream && cuMemcpyDtoDAsync_v2) {
+                err = cuMemcpyDtoDAsync_v2((CUdeviceptr)dst, (CUdeviceptr)src, c.chunk_size, capture_stream);
+            } else {
+                err = cuMemcpyDtoD((CUdeviceptr)dst, (CUdeviceptr)src, c.chunk_size);
+            }
         } else if (dst != src) {
             debug(user_context) << "memcpy(" << (void *)dst << ", " << (void *)src << ", " << c.chunk_size << ")\n";
             // Could reach here if a user called directly into the
@@ -878,7 +1542,7 @@ WEAK int cuda_do_multidimensional_copy(void *user_context, const device_copy &c,
     } else {
         ssize_t src_off = 0, dst_off = 0;
         for (int i = 0; i < (int)c.extent[d - 1]; i++) {
-            int err = cuda_do_multidimensional_copy(user_context, c, src + src_off, dst + dst_off, d - 1, from_host, to_host);
+            int err = cuda_do_multidimensional_copy(user_context, c, src + src_off, dst + dst_off, d - 1, from_host, to_host, cross);
             dst_off += c.dst_stride_bytes[d - 1];
             src_off += c.src_stride_bytes[d - 1];
             if (err) {
@@ -935,7 +1599,35 @@ WEAK int halide_cuda_buffer_copy(void *user_context, struct halide_buffer_t *src
         }
 #endif
 
-        err = cuda_do_multidimensional_copy(user_context, c, c.src + c.src_begin, c.dst, dst->dimensions, from_host, to_host);
+        // A device-to-device copy may span two contexts (two GPUs, or
+        // two contexts on one GPU). Resolve each pointer's owning
+        // context once; same-context copies keep the plain DtoD path.
+        cuda_cross_context_copy_info cross_info;
+        cuda_cross_context_copy_info *cross = nullptr;
+        if (!from_host && !to_host && cuPointerGetAttribute) {
+            CUcontext src_ctx = nullptr, dst_ctx = nullptr;
+            if (cuPointerGetAttribute(&src_ctx, CU_POINTER_ATTRIBUTE_CONTEXT, (CUdeviceptr)(c.src + c.src_begin)) == CUDA_SUCCESS &&
+                cuPointerGetAttribute(&dst_ctx, CU_POINTER_ATTRIBUTE_CONTEXT, (CUdeviceptr)c.dst) == CUDA_SUCCESS &&
+                src_ctx != nullptr && dst_ctx != nullptr && src_ctx != dst_ctx) {
+                cross_info.src_ctx = src_ctx;
+                cross_info.dst_ctx = dst_ctx;
+                cross_info.use_peer = cuda_peer_access_allowed(src_ctx, dst_ctx);
+                cross_info.staging_pinned = false;
+                cross_info.staging = nullptr;
+                cross_info.staging_size = 0;
+                cross = &cross_info;
+            }
+        }
+
+        err = cuda_do_multidimensional_copy(user_context, c, c.src + c.src_begin, c.dst, dst->dimensions, from_host, to_host, cross);
+
+        if (cross && cross->staging) {
+            if (cross->staging_pinned) {
+                cuMemFreeHost(cross->staging);
+            } else {
+                halide_free(user_context, cross->staging);
+            }
+        }
 
 #ifdef DEBUG_RUNTIME
         uint64_t t_after = halide_current_time_ns(user_context);
@@ -1013,7 +1705,31 @@ WEAK int halide_cuda_device_sync(void *user_context, struct halide_buffer_t *) {
 #endif
 
     CUresult err;
-    if (cuStreamSynchronize != nullptr) {
+    if (blocking_sync_in_use() &&
+        cuEventCreate != nullptr &&
+        cuEventRecord != nullptr &&
+        cuEventSynchronize != nullptr &&
+        cuEventDestroy_v2 != nullptr) {
+        // Wait on a blocking event recorded after the outstanding
+        // work. cuEventSynchronize on a CU_EVENT_BLOCKING_SYNC event
+        // sleeps in the driver instead of spinning, even if the
+        // context was created elsewhere without
+        // CU_CTX_SCHED_BLOCKING_SYNC.
+        CUstream stream = nullptr;
+        int result = halide_cuda_get_stream(user_context, ctx.context, &stream);
+        if (result != 0) {
+            error(user_context) << "CUDA: In halide_cuda_device_sync, halide_cuda_get_stream returned " << result << "\n";
+        }
+        CUevent event;
+        err = cuEventCreate(&event, CU_EVENT_BLOCKING_SYNC | CU_EVENT_DISABLE_TIMING);
+        if (err == CUDA_SUCCESS) {
+            err = cuEventRecord(event, stream);
+            if (err == CUDA_SUCCESS) {
+                err = cuEventSynchronize(event);
+            }
+            cuEventDestroy_v2(event);
+        }
+    } else if (cuStreamSynchronize != nullptr) {
         CUstream stream;
         int result = halide_cuda_get_stream(user_context, ctx.context, &stream);
         if (result != 0) {
@@ -1071,39 +1787,37 @@ WEAK int halide_cuda_run(void *user_context,
     halide_assert(user_context, found && mod != nullptr);
 
     debug(user_context) << "Got module " << mod << "\n";
-    CUfunction f;
-    err = cuModuleGetFunction(&f, mod, entry_name);
-    debug(user_context) << "Got function " << f << "\n";
-    if (err != CUDA_SUCCESS) {
-        error(user_context) << "CUDA: cuModuleGetFunction failed: "
-                            << get_error_name(err);
-        return err;
-    }
 
     size_t num_args = 0;
+    bool cacheable_args = true;
     while (arg_sizes[num_args] != 0) {
         debug(user_context) << "    halide_cuda_run " << (int)num_args
                             << " " << (int)arg_sizes[num_args]
                             << " [" << (*((void **)args[num_args])) << " ...] "
                             << arg_is_buffer[num_args] << "\n";
+        if (arg_sizes[num_args] > sizeof(uint64_t)) {
+            cacheable_args = false;
+        }
         num_args++;
     }
 
-    // We need storage for both the arg and the pointer to it if if
-    // has to be translated.
-    void **translated_args = (void **)malloc((num_args + 1) * sizeof(void *));
-    uint64_t *dev_handles = (uint64_t *)malloc(num_args * sizeof(uint64_t));
-    for (size_t i = 0; i <= num_args; i++) {  // Get nullptr at end.
-        if (arg_is_buffer[i]) {
-            halide_assert(user_context, arg_sizes[i] == sizeof(uint64_t));
-            dev_handles[i] = ((halide_buffer_t *)args[i])->device;
-            translated_args[i] = &(dev_handles[i]);
-            debug(user_context) << "    halide_cuda_run translated arg" << (int)i
-                                << " [" << (*((void **)translated_args[i])) << " ...]\n";
-        } else {
-            translated_args[i] = args[i];
+    LaunchCacheEntry *cache = nullptr;
+    if (cacheable_args && num_args <= (size_t)kMaxLaunchCacheArgs) {
+        cache = launch_cache_get(user_context, mod, entry_name);
+    }
+
+    CUfunction f = nullptr;
+    if (cache) {
+        f = cache->fn;
+    } else {
+        err = cuModuleGetFunction(&f, mod, entry_name);
+        if (err != CUDA_SUCCESS) {
+            error(user_context) << "CUDA: cuModuleGetFunction failed: "
+                                << get_error_name(err);
+            return err;
         }
     }
+    debug(user_context) << "Got function " << f << "\n";
 
     CUstream stream = nullptr;
     // We use whether this routine was defined in the cuda driver library
@@ -1112,21 +1826,65 @@ WEAK int halide_cuda_run(void *user_context,
         int result = halide_cuda_get_stream(user_context, ctx.context, &stream);
         if (result != 0) {
             error(user_context) << "CUDA: In halide_cuda_run, halide_cuda_get_stream returned " << result << "\n";
-            free(dev_handles);
-            free(translated_args);
             return result;
         }
     }
 
-    err = cuLaunchKernel(f,
-                         blocksX, blocksY, blocksZ,
-                         threadsX, threadsY, threadsZ,
-                         shared_mem_bytes,
-                         stream,
-                         translated_args,
-                         nullptr);
-    free(dev_handles);
-    free(translated_args);
+    if (cache) {
+        // Marshal into the cached argument block, touching only the
+        // slots whose values actually changed since the last launch.
+        ScopedMutexLock lock(&cache->mutex);
+        bool rewrite_all = cache->num_args != num_args;
+        for (size_t i = 0; i < num_args; i++) {
+            uint64_t value = 0;
+            if (arg_is_buffer[i]) {
+                halide_assert(user_context, arg_sizes[i] == sizeof(uint64_t));
+                value = ((halide_buffer_t *)args[i])->device;
+            } else {
+                memcpy(&value, args[i], arg_sizes[i]);
+            }
+            if (rewrite_all || cache->arg_values[i] != value) {
+                cache->arg_values[i] = value;
+            }
+            cache->translated_args[i] = &cache->arg_values[i];
+        }
+        cache->translated_args[num_args] = nullptr;
+        cache->num_args = num_args;
+
+        err = cuLaunchKernel(f,
+                             blocksX, blocksY, blocksZ,
+                             threadsX, threadsY, threadsZ,
+                             shared_mem_bytes,
+                             stream,
+                             cache->translated_args,
+                             nullptr);
+    } else {
+        // We need storage for both the arg and the pointer to it if if
+        // has to be translated.
+        void **translated_args = (void **)malloc((num_args + 1) * sizeof(void *));
+        uint64_t *dev_handles = (uint64_t *)malloc(num_args * sizeof(uint64_t));
+        for (size_t i = 0; i <= num_args; i++) {  // Get nullptr at end.
+            if (arg_is_buffer[i]) {
+                halide_assert(user_context, arg_sizes[i] == sizeof(uint64_t));
+                dev_handles[i] = ((halide_buffer_t *)args[i])->device;
+                translated_args[i] = &(dev_handles[i]);
+                debug(user_context) << "    halide_cuda_run translated arg" << (int)i
+                                    << " [" << (*((void **)translated_args[i])) << " ...]\n";
+            } else {
+                translated_args[i] = args[i];
+            }
+        }
+
+        err = cuLaunchKernel(f,
+                             blocksX, blocksY, blocksZ,
+                             threadsX, threadsY, threadsZ,
+                             shared_mem_bytes,
+                             stream,
+                             translated_args,
+                             nullptr);
+        free(dev_handles);
+        free(translated_args);
+    }
     if (err != CUDA_SUCCESS) {
         error(user_context) << "CUDA: cuLaunchKernel failed: "
                             << get_error_name(err);
@@ -1146,12 +1904,185 @@ WEAK int halide_cuda_run(void *user_context,
     return 0;
 }
 
+WEAK int halide_cuda_occupancy_block_size(void *user_context,
+                                          void *state_ptr,
+                                          const char *entry_name) {
+    // A reasonable static choice for devices and drivers we cannot
+    // query. Callers treat the result as opaque, so degrading to this
+    // keeps pipelines working.
+    const int default_block_size = 256;
+
+    debug(user_context) << "CUDA: halide_cuda_occupancy_block_size ("
+                        << "user_context: " << user_context << ", "
+                        << "entry: " << entry_name << ")\n";
+
+    Context ctx(user_context);
+    if (ctx.error != CUDA_SUCCESS) {
+        return default_block_size;
+    }
+
+    if (cuOccupancyMaxPotentialBlockSize == nullptr) {
+        // The driver predates the occupancy API.
+        return default_block_size;
+    }
+
+    CUmodule mod{};
+    bool found = compilation_cache.lookup(ctx.context, state_ptr, mod);
+    if (!found || mod == nullptr) {
+        return default_block_size;
+    }
+
+    CUfunction f;
+    CUresult err = cuModuleGetFunction(&f, mod, entry_name);
+    if (err != CUDA_SUCCESS) {
+        error(user_context) << "CUDA: cuModuleGetFunction failed: "
+                            << get_error_name(err);
+        return default_block_size;
+    }
+
+    ScopedMutexLock lock(&occupancy_cache_lock);
+    for (int i = 0; i < occupancy_cache_count; i++) {
+        if (occupancy_cache[i].ctx == ctx.context &&
+            occupancy_cache[i].fn == f) {
+            return occupancy_cache[i].block_size;
+        }
+    }
+
+    // The dynamic shared memory size is reported as zero; Halide
+    // sizes dynamic shared allocations from the launch configuration,
+    // so it is not known until after the block size is chosen.
+    int min_grid_size = 0, block_size = 0;
+    err = cuOccupancyMaxPotentialBlockSize(&min_grid_size, &block_size,
+                                           f, nullptr, 0, 0);
+    if (err != CUDA_SUCCESS || block_size <= 0) {
+        debug(user_context) << "CUDA: cuOccupancyMaxPotentialBlockSize failed: "
+                            << get_error_name(err) << "\n";
+        block_size = default_block_size;
+    }
+
+    if (occupancy_cache_count < kMaxOccupancyCacheEntries) {
+        OccupancyCacheEntry &e = occupancy_cache[occupancy_cache_count++];
+        e.ctx = ctx.context;
+        e.fn = f;
+        e.block_size = block_size;
+    }
+
+    debug(user_context) << "    Occupancy block size for " << entry_name
+                        << ": " << block_size << "\n";
+    return block_size;
+}
+
 WEAK int halide_cuda_device_and_host_malloc(void *user_context, struct halide_buffer_t *buf) {
+    if (pinned_host_in_use() && cuMemHostAlloc) {
+        Context ctx(user_context);
+        if (ctx.error == CUDA_SUCCESS) {
+            size_t size = quantize_allocation_size(buf->size_in_bytes());
+
+            PinnedHostAlloc *node = nullptr;
+            {
+                ScopedMutexLock lock(&pinned_host_lock);
+                // Best-fit reuse, with the same slop rule as the
+                // device free list above.
+                PinnedHostAlloc *best = nullptr, *item = pinned_free_list;
+                PinnedHostAlloc **best_prev = nullptr, **prev_ptr = &pinned_free_list;
+                while (item) {
+                    if ((size <= item->size) &&
+                        (size >= (item->size / 8) * 7) &&
+                        (ctx.context == item->ctx) &&
+                        ((best == nullptr) || (best->size > item->size))) {
+                        best = item;
+                        best_prev = prev_ptr;
+                    }
+                    prev_ptr = &item->next;
+                    item = item->next;
+                }
+                if (best) {
+                    *best_prev = best->next;
+                    node = best;
+                }
+            }
+
+            if (node == nullptr) {
+                void *p = nullptr;
+                debug(user_context) << "    cuMemHostAlloc " << (uint64_t)size << " -> ";
+                CUresult err = cuMemHostAlloc(&p, size, 0);
+                if (err == CUDA_SUCCESS) {
+                    debug(user_context) << p << "\n";
+                    node = (PinnedHostAlloc *)malloc(sizeof(PinnedHostAlloc));
+                    node->ptr = p;
+                    node->ctx = ctx.context;
+                    node->size = size;
+                } else {
+                    // Pinned memory is a finite resource; fall back
+                    // to a pageable allocation rather than failing.
+                    debug(user_context) << get_error_name(err)
+                                        << " (falling back to pageable host memory)\n";
+                }
+            }
+
+            if (node) {
+                {
+                    ScopedMutexLock lock(&pinned_host_lock);
+                    node->next = pinned_live_list;
+                    pinned_live_list = node;
+                }
+                buf->host = (uint8_t *)node->ptr;
+                int result = halide_device_malloc(user_context, buf, &cuda_device_interface);
+                if (result != 0) {
+                    // Return the pinned allocation to the pool.
+                    ScopedMutexLock lock(&pinned_host_lock);
+                    for (PinnedHostAlloc **prev_ptr = &pinned_live_list; *prev_ptr; prev_ptr = &(*prev_ptr)->next) {
+                        if (*prev_ptr == node) {
+                            *prev_ptr = node->next;
+                            break;
+                        }
+                    }
+                    node->next = pinned_free_list;
+                    pinned_free_list = node;
+                    buf->host = nullptr;
+                }
+                return result;
+            }
+        }
+    }
     return halide_default_device_and_host_malloc(user_context, buf, &cuda_device_interface);
 }
 
 WEAK int halide_cuda_device_and_host_free(void *user_context, struct halide_buffer_t *buf) {
-    return halide_default_device_and_host_free(user_context, buf, &cuda_device_interface);
+    // If the host side is one of our pinned allocations, it must go
+    // back to the pinned pool rather than through halide_free.
+    PinnedHostAlloc *node = nullptr;
+    if (buf->host) {
+        ScopedMutexLock lock(&pinned_host_lock);
+        for (PinnedHostAlloc **prev_ptr = &pinned_live_list; *prev_ptr; prev_ptr = &(*prev_ptr)->next) {
+            if ((*prev_ptr)->ptr == buf->host) {
+                node = *prev_ptr;
+                *prev_ptr = node->next;
+                break;
+            }
+        }
+    }
+    if (node == nullptr) {
+        return halide_default_device_and_host_free(user_context, buf, &cuda_device_interface);
+    }
+
+    int result = halide_device_free(user_context, buf);
+    if (halide_can_reuse_device_allocations(user_context)) {
+        ScopedMutexLock lock(&pinned_host_lock);
+        node->next = pinned_free_list;
+        pinned_free_list = node;
+    } else {
+        Context ctx(user_context);
+        debug(user_context) << "    cuMemFreeHost " << node->ptr << "\n";
+        if (cuMemFreeHost) {
+            cuMemFreeHost(node->ptr);
+        }
+        free(node);
+    }
+    buf->host = nullptr;
+    buf->set_host_dirty(false);
+    buf->set_device_dirty(false);
+    return result;
 }
 
 WEAK int halide_cuda_wrap_device_ptr(void *user_context, struct halide_buffer_t *buf, uint64_t device_ptr) {
@@ -1244,6 +2175,139 @@ WEAK int halide_cuda_compute_capability(void *user_context, int *major, int *min
     return 0;
 }
 
+WEAK int halide_cuda_graph_capture_begin(void *user_context) {
+    debug(user_context)
+        << "CUDA: halide_cuda_graph_capture_begin (user_context: " << user_context << ")\n";
+
+    Context ctx(user_context);
+    if (ctx.error != CUDA_SUCCESS) {
+        return ctx.error;
+    }
+
+    if (!cuStreamCreate || !cuStreamBeginCapture_v2 || !cuStreamEndCapture ||
+        !cuGraphInstantiate_v2 || !cuGraphLaunch) {
+        error(user_context) << "CUDA: driver does not support graph capture\n";
+        return -1;
+    }
+
+    ScopedMutexLock lock(&graph_capture_lock);
+    if (graph_capture.active) {
+        error(user_context) << "CUDA: a graph capture is already in progress\n";
+        return -1;
+    }
+
+    CUstream stream;
+    CUresult err = cuStreamCreate(&stream, 1 /* CU_STREAM_NON_BLOCKING */);
+    if (err != CUDA_SUCCESS) {
+        error(user_context) << "CUDA: cuStreamCreate failed: "
+                            << get_error_name(err);
+        return err;
+    }
+
+    err = cuStreamBeginCapture_v2(stream, CU_STREAM_CAPTURE_MODE_THREAD_LOCAL);
+    if (err != CUDA_SUCCESS) {
+        error(user_context) << "CUDA: cuStreamBeginCapture failed: "
+                            << get_error_name(err);
+        if (cuStreamDestroy_v2) {
+            cuStreamDestroy_v2(stream);
+        }
+        return err;
+    }
+
+    graph_capture.user_context = user_context;
+    graph_capture.stream = stream;
+    graph_capture.active = 1;
+    return 0;
+}
+
+WEAK int halide_cuda_graph_capture_end(void *user_context, void **graph) {
+    debug(user_context)
+        << "CUDA: halide_cuda_graph_capture_end (user_context: " << user_context << ")\n";
+
+    Context ctx(user_context);
+    if (ctx.error != CUDA_SUCCESS) {
+        return ctx.error;
+    }
+
+    ScopedMutexLock lock(&graph_capture_lock);
+    if (!graph_capture.active || graph_capture.user_context != user_context) {
+        error(user_context) << "CUDA: no graph capture in progress for this user_context\n";
+        return -1;
+    }
+
+    CUstream stream = graph_capture.stream;
+    graph_capture.active = 0;
+    graph_capture.user_context = nullptr;
+    graph_capture.stream = nullptr;
+
+    CUgraph captured;
+    CUresult err = cuStreamEndCapture(stream, &captured);
+    if (err == CUDA_SUCCESS) {
+        CUgraphExec exec;
+        err = cuGraphInstantiate_v2(&exec, captured, nullptr, nullptr, 0);
+        cuGraphDestroy(captured);
+        if (err == CUDA_SUCCESS) {
+            *graph = (void *)exec;
+        }
+    }
+    if (cuStreamDestroy_v2) {
+        cuStreamDestroy_v2(stream);
+    }
+    if (err != CUDA_SUCCESS) {
+        error(user_context) << "CUDA: graph capture failed: "
+                            << get_error_name(err);
+        return err;
+    }
+    return 0;
+}
+
+WEAK int halide_cuda_graph_launch(void *user_context, void *graph) {
+    debug(user_context)
+        << "CUDA: halide_cuda_graph_launch (user_context: " << user_context
+        << ", graph: " << graph << ")\n";
+
+    Context ctx(user_context);
+    if (ctx.error != CUDA_SUCCESS) {
+        return ctx.error;
+    }
+
+    CUstream stream = nullptr;
+    int result = halide_cuda_get_stream(user_context, ctx.context, &stream);
+    if (result != 0) {
+        error(user_context) << "CUDA: In halide_cuda_graph_launch, halide_cuda_get_stream returned " << result << "\n";
+        return result;
+    }
+
+    CUresult err = cuGraphLaunch((CUgraphExec)graph, stream);
+    if (err != CUDA_SUCCESS) {
+        error(user_context) << "CUDA: cuGraphLaunch failed: "
+                            << get_error_name(err);
+        return err;
+    }
+    return 0;
+}
+
+WEAK int halide_cuda_graph_destroy(void *user_context, void *graph) {
+    debug(user_context)
+        << "CUDA: halide_cuda_graph_destroy (user_context: " << user_context
+        << ", graph: " << graph << ")\n";
+
+    Context ctx(user_context);
+    if (ctx.error != CUDA_SUCCESS) {
+        return ctx.error;
+    }
+
+    if (graph && cuGraphExecDestroy) {
+        CUresult err = cuGraphExecDestroy((CUgraphExec)graph);
+        if (err != CUDA_SUCCESS) {
+            error(user_context) << "CUDA: cuGraphExecDestroy failed: "
+                                << get_error_name(err);
+            return err;
+        }
+    }
+    return 0;
+}
+
 namespace {
 WEAK __attribute__((destructor)) void halide_cuda_cleanup() {
     compilation_cache.release_all(nullptr, cuModuleUnload);
@@ -579,6 +579,8 @@ struct d3d12_buffer {
     // if the buffer is an upload/readback staging heap:
     void *mapped;
     volatile uint64_t ref_count /*__attribute__((aligned(8)))*/;
+    // next free byte offset when the staging heap is suballocated as a ring
+    size_t cursor;
 
     uint64_t signal;
 
@@ -639,6 +641,10 @@ struct d3d12_binder {
     D3D12_CPU_DESCRIPTOR_HANDLE CPU[NumSlots];
     D3D12_GPU_DESCRIPTOR_HANDLE GPU[NumSlots];
     UINT descriptorSize;
+    // fingerprint of the resource set currently described in the heap, so
+    // that identical dispatches can reuse the descriptor table as-is
+    // (zero means "unknown/invalid": always rebuild)
+    uint64_t bound_set_key;
 };
 
 struct d3d12_profiler {
@@ -710,6 +716,7 @@ WEAK d3d12_frame frame_pool[MaxFrames] = {};
 static uint64_t frame_selector = 0;
 
 static void wait_until_completed(d3d12_compute_command_list *cmdList);
+static void wait_until_signaled(uint64_t signal);
 static d3d12_command_list *new_compute_command_list(d3d12_device *device, d3d12_command_allocator *allocator);
 static d3d12_binder *new_descriptor_binder(d3d12_device *device);
 static void commit_command_list(d3d12_compute_command_list *cmdList);
@@ -833,6 +840,15 @@ void release_d3d12_object<d3d12_binder>(d3d12_binder *binder) {
 template<>
 void release_d3d12_object<d3d12_buffer>(d3d12_buffer *buffer) {
     TRACELOG;
+    // a future allocation may recycle the address of the resource being
+    // released and spuriously match a descriptor table cached in the frame
+    // pool, so drop all cached fingerprints
+    for (int i = 0; i < MaxFrames; ++i) {
+        d3d12_binder *binder = frame_pool[i].desc_binder;
+        if (binder != nullptr) {
+            binder->bound_set_key = 0;
+        }
+    }
     Release_ID3D12Object(buffer->resource);
     if (buffer->host_mirror != nullptr) {
         d3d12_free(buffer->host_mirror);
@@ -1494,14 +1510,22 @@ WEAK d3d12_buffer *new_buffer(d3d12_device *device, size_t length) {
 WEAK size_t suballocate(d3d12_device *device, d3d12_buffer *staging, size_t num_bytes) {
     TRACELOG;
 
+    // the staging heap is suballocated as a ring buffer: each transfer claims
+    // the next region past the cursor, and the heap only has to stall when
+    // the cursor wraps around onto regions that in-flight transfers might
+    // still be reading from
+    static const size_t ring_alignment = 256;
+    size_t aligned_bytes = (num_bytes + ring_alignment - 1) & ~(ring_alignment - 1);
+
     // buffer not large enough for suballocation: must grow
-    if (staging->sizeInBytes < num_bytes) {
-        // ensure there are no pending transfers on this buffer
+    if (staging->sizeInBytes < aligned_bytes) {
+        // in-flight transfers may still be using the old storage: drain them
+        wait_until_signaled(staging->signal);
         uint64_t use_count = __atomic_add_fetch(&staging->ref_count, 1, __ATOMIC_SEQ_CST);
         halide_assert(user_context, (use_count == 1));
         // find a new "ideal" size: e.g., using a cumulative 2x heuristic
         size_t old_capacity = staging->sizeInBytes;
-        size_t new_capacity = 2 * (old_capacity + num_bytes);
+        size_t new_capacity = 2 * (old_capacity + aligned_bytes);
         TRACEPRINT("not enough storage: growing from " << (uintptr_t)old_capacity << " bytes to " << (uintptr_t)new_capacity << " bytes.\n");
         // release the old storage
         use_count = __atomic_sub_fetch(&staging->ref_count, 1, __ATOMIC_SEQ_CST);
@@ -1524,12 +1548,22 @@ WEAK size_t suballocate(d3d12_device *device, d3d12_buffer *staging, size_t num_
         }
     }
 
-    halide_assert(user_context, (staging->sizeInBytes >= num_bytes));
+    halide_assert(user_context, (staging->sizeInBytes >= aligned_bytes));
+
+    if (staging->cursor + aligned_bytes > staging->sizeInBytes) {
+        // wrapping around: the beginning of the heap can only be reclaimed
+        // once every transfer issued on this trip through the ring has
+        // completed
+        wait_until_signaled(staging->signal);
+        staging->cursor = 0;
+    }
+
     // this reference counter will be decremented later by 'd3d12compute_device_sync_internal()'
     uint64_t use_count = __atomic_add_fetch(&staging->ref_count, 1, __ATOMIC_SEQ_CST);
-    // but for now we must ensure that there are no pending transfers on this buffer already
+    // only one transfer may be in the process of being recorded at a time
     halide_assert(user_context, (use_count == 1));
-    size_t byte_offset = 0;  // always zero, for now
+    size_t byte_offset = staging->cursor;
+    staging->cursor += aligned_bytes;
     return byte_offset;
 }
 
@@ -1772,6 +1806,7 @@ static d3d12_binder *new_descriptor_binder(d3d12_device *device) {
     d3d12_binder *binder = malloct<d3d12_binder>();
     binder->descriptorHeap = descriptorHeap;
     binder->descriptorSize = descriptorSize;
+    binder->bound_set_key = 0;
 
     D3D12_CPU_DESCRIPTOR_HANDLE baseCPU = binder->baseCPU = descriptorHeap->GetCPUDescriptorHandleForHeapStart();
     TRACEPRINT("descriptor heap base for CPU: " << baseCPU.ptr << " (" << (void *)baseCPU.ptr << ")\n");
@@ -2299,7 +2334,21 @@ static void d3d12compute_device_sync_internal(d3d12_device *device, d3d12_buffer
         d3d12_compute_command_list *blitCmdList = frame->cmd_list;
         synchronize_host_and_device_buffer_contents(blitCmdList, dev_buffer);
         enqueue_frame(frame);
-        wait_until_completed(frame);
+        d3d12_buffer *staging_buffer = dev_buffer->xfer->staging;
+        staging_buffer->signal = frame->fence_signal;
+        dev_buffer->signal = frame->fence_signal;
+        if (staging_buffer->type != d3d12_buffer::Upload) {
+            // readbacks must complete before the host can see the results;
+            // uploads, however, need not block the host: the ring region
+            // claimed by 'suballocate()' already holds a stable snapshot of
+            // the host data and won't be reclaimed until this fence signal
+            // completes
+            wait_until_completed(frame);
+        }
+    } else {
+        // plain sync request on the buffer: drain any transfer or dispatch
+        // still in flight on it
+        wait_until_signaled(dev_buffer->signal);
     }
 
     if (dev_buffer->xfer != nullptr) {
@@ -2980,6 +3029,14 @@ WEAK int halide_d3d12compute_copy_to_host(void *user_context, halide_buffer_t *b
     return 0;
 }
 
+static uint64_t fnv1a_mix(uint64_t hash, const void *data, size_t size) {
+    const uint8_t *bytes = (const uint8_t *)data;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
 WEAK int halide_d3d12compute_run(void *user_context,
                                  void *state_ptr,
                                  const char *entry_name,
@@ -3140,18 +3197,41 @@ WEAK int halide_d3d12compute_run(void *user_context,
         {
             TRACE_SCOPE("descriptor binding");
 
-            // setup/bind the argument buffer:
+            // the descriptors this frame wrote on its previous trip through
+            // the pool are still present in its heap; when the same set of
+            // resources is being bound again (the common case when the same
+            // pipeline is dispatched repeatedly), rewriting them is just
+            // redundant driver work, so the bound set is fingerprinted and
+            // the cached descriptor table reused on a match
+            uint64_t bound_set_key = 14695981039346656037ULL;  // FNV-1a offset basis
             if (has_uniform_arguments) {
-                // always bind argument buffer at constant buffer binding 0
-                int32_t cb_index = 0;  // a.k.a. register(c0)
-                set_input_buffer(binder, &uniform_buffer, cb_index);
+                bound_set_key = fnv1a_mix(bound_set_key, &uniform_buffer.resource, sizeof(uniform_buffer.resource));
+                bound_set_key = fnv1a_mix(bound_set_key, &uniform_buffer.sizeInBytes, sizeof(uniform_buffer.sizeInBytes));
             }
-
-            // setup/bind actual buffers:
             for (size_t i = 0; i < num_buffer_args; i++) {
                 d3d12_buffer *buffer = buffer_args[i];
-                int32_t uav_index = (int32_t)i;
-                set_input_buffer(binder, buffer, uav_index);  // register(u#)
+                bound_set_key = fnv1a_mix(bound_set_key, &buffer->resource, sizeof(buffer->resource));
+                bound_set_key = fnv1a_mix(bound_set_key, &buffer->offset, sizeof(buffer->offset));
+                bound_set_key = fnv1a_mix(bound_set_key, &buffer->elements, sizeof(buffer->elements));
+                bound_set_key = fnv1a_mix(bound_set_key, &buffer->format, sizeof(buffer->format));
+            }
+
+            if (binder->bound_set_key != bound_set_key) {
+                // setup/bind the argument buffer:
+                if (has_uniform_arguments) {
+                    // always bind argument buffer at constant buffer binding 0
+                    int32_t cb_index = 0;  // a.k.a. register(c0)
+                    set_input_buffer(binder, &uniform_buffer, cb_index);
+                }
+
+                // setup/bind actual buffers:
+                for (size_t i = 0; i < num_buffer_args; i++) {
+                    d3d12_buffer *buffer = buffer_args[i];
+                    int32_t uav_index = (int32_t)i;
+                    set_input_buffer(binder, buffer, uav_index);  // register(u#)
+                }
+
+                binder->bound_set_key = bound_set_key;
             }
         }
     }
@@ -276,4 +276,9 @@ WEAK int halide_error_buffer_is_null(void *user_context, const char *routine) {
     return halide_error_code_buffer_is_null;
 }
 
+WEAK int halide_error_pipeline_cancelled(void *user_context) {
+    error(user_context) << "Pipeline execution was cancelled.\n";
+    return halide_error_code_pipeline_cancelled;
+}
+
 }  // extern "C"
@@ -114,6 +114,11 @@ WEAK int halide_mutex_array_unlock(halide_mutex_array *array, int entry) {
 WEAK void halide_shutdown_thread_pool() {
 }
 
+WEAK int halide_set_parallel_inline_threshold(int n) {
+    // Everything already runs on the calling thread on this platform.
+    return 1;
+}
+
 WEAK int halide_set_num_threads(int n) {
     if (n != 1) {
         halide_error(nullptr, "halide_set_num_threads: only supports a value of 1 on this platform.");
@@ -121,6 +126,56 @@ WEAK int halide_set_num_threads(int n) {
     return 1;
 }
 
+WEAK int halide_set_work_stealing(int enable) {
+    // There is no thread pool to steal from on this platform.
+    return 0;
+}
+
+WEAK int halide_set_adaptive_parallelism(int enable) {
+    // Execution is serial on this platform, so there is no
+    // parallelism level to adapt.
+    return 0;
+}
+
+WEAK int halide_set_default_task_priority(int priority) {
+    // Tasks run synchronously on this platform, so priority is moot.
+    return 0;
+}
+
+// Cancellation tokens are single-threaded on this platform, so plain
+// loads and stores suffice. There is no thread pool polling them, so
+// associating a token with a user context has no effect.
+WEAK int halide_cancellation_token_init(halide_cancellation_token_t *token) {
+    token->_private[0] = 0;
+    return 0;
+}
+
+WEAK void halide_cancel(halide_cancellation_token_t *token) {
+    token->_private[0] = 1;
+}
+
+WEAK bool halide_cancellation_token_cancelled(halide_cancellation_token_t *token) {
+    return token->_private[0] != 0;
+}
+
+WEAK int halide_set_cancellation_token(void *user_context, halide_cancellation_token_t *token) {
+    return 0;
+}
+
+WEAK int halide_set_deadline(halide_cancellation_token_t *token, int64_t budget_ns) {
+    // Nothing polls tokens on this platform, so a deadline never fires.
+    return 0;
+}
+
+WEAK bool halide_deadline_progress(halide_cancellation_token_t *token, int *first_skipped) {
+    return false;
+}
+
+WEAK int halide_set_thread_affinity_policy(int policy) {
+    // There are no worker threads to pin on this platform.
+    return halide_thread_affinity_policy_none;
+}
+
 WEAK halide_do_task_t halide_set_custom_do_task(halide_do_task_t f) {
     halide_do_task_t result = custom_do_task;
     custom_do_task = f;
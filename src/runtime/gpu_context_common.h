@@ -1,9 +1,148 @@
 #include "printer.h"
 #include "scoped_mutex_lock.h"
 
+extern "C" {
+size_t fread(void *, size_t, size_t, void *);
+int rename(const char *, const char *);
+}
+
 namespace Halide {
 namespace Internal {
 
+// Optional on-disk persistence for compiled GPU kernels, shared by
+// the API-specific runtimes. The in-memory GPUCompilationCache below
+// only lives as long as the process, so APIs that compile kernels
+// from source at initialization (OpenCL, Metal) pay the full driver
+// compile on every process start. When the HL_GPU_KERNEL_CACHE_DIR
+// environment variable names a directory, a runtime can store the
+// driver's compiled binary keyed by a hash of the kernel source and
+// the device identity, and load it back on the next start. Files are
+// written to a temporary name and atomically renamed into place, so
+// concurrent processes sharing a cache directory see either a whole
+// entry or none. A corrupt or truncated entry is treated as a miss.
+
+namespace {
+constexpr uint32_t kGPUKernelCacheMagic = 0x484c4b43;  // "HLKC"
+constexpr uint32_t kGPUKernelCacheVersion = 1;
+}  // namespace
+
+WEAK const char *gpu_kernel_cache_dir() {
+    return getenv("HL_GPU_KERNEL_CACHE_DIR");
+}
+
+// FNV-1a, for keying cache entries. Seed with the previous hash to
+// chain source, build options, and device identity together.
+WEAK uint64_t gpu_kernel_cache_hash(const void *data, size_t size, uint64_t hash) {
+    const uint8_t *bytes = (const uint8_t *)data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+WEAK void gpu_kernel_cache_path(char *buf, size_t buf_size, const char *dir,
+                                const char *api, uint64_t hash, const char *suffix) {
+    const char hex[] = "0123456789abcdef";
+    char *dst = buf;
+    char *end = buf + buf_size - 1;
+    for (const char *s = dir; *s && dst < end; s++) {
+        *dst++ = *s;
+    }
+    if (dst < end) {
+        *dst++ = '/';
+    }
+    for (const char *s = api; *s && dst < end; s++) {
+        *dst++ = *s;
+    }
+    if (dst < end) {
+        *dst++ = '_';
+    }
+    for (int i = 15; i >= 0 && dst < end; i--) {
+        *dst++ = hex[(hash >> (i * 4)) & 0xf];
+    }
+    for (const char *s = suffix; *s && dst < end; s++) {
+        *dst++ = *s;
+    }
+    *dst = 0;
+}
+
+// Loads the blob for the given key into a halide_malloc'd buffer,
+// returned in *data/*size. Returns false (leaving them untouched) on
+// a miss or a malformed entry.
+WEAK bool gpu_kernel_cache_load(void *user_context, const char *api, uint64_t hash,
+                                void **data, size_t *size) {
+    const char *dir = gpu_kernel_cache_dir();
+    if (!dir) {
+        return false;
+    }
+    char path[512];
+    gpu_kernel_cache_path(path, sizeof(path), dir, api, hash, ".bin");
+
+    void *f = fopen(path, "rb");
+    if (!f) {
+        return false;
+    }
+    uint64_t header[2] = {0, 0};
+    bool ok = fread(header, sizeof(header), 1, f) == 1 &&
+              (uint32_t)header[0] == kGPUKernelCacheMagic &&
+              (uint32_t)(header[0] >> 32) == kGPUKernelCacheVersion &&
+              header[1] > 0;
+    void *blob = nullptr;
+    if (ok) {
+        blob = halide_malloc(user_context, header[1]);
+        ok = blob != nullptr &&
+             fread(blob, header[1], 1, f) == 1;
+    }
+    fclose(f);
+    if (!ok) {
+        if (blob) {
+            halide_free(user_context, blob);
+        }
+        return false;
+    }
+    *data = blob;
+    *size = header[1];
+    debug(user_context) << "    loaded cached GPU kernel binary from " << path << "\n";
+    return true;
+}
+
+WEAK bool gpu_kernel_cache_store(void *user_context, const char *api, uint64_t hash,
+                                 const void *data, size_t size) {
+    const char *dir = gpu_kernel_cache_dir();
+    if (!dir || size == 0) {
+        return false;
+    }
+    char path[512], tmp_path[512];
+    gpu_kernel_cache_path(path, sizeof(path), dir, api, hash, ".bin");
+    // Tag the temporary name with a stack address, which is unique
+    // enough across the processes racing on one directory.
+    uint64_t tag = (uint64_t)(uintptr_t)&path;
+    gpu_kernel_cache_path(tmp_path, sizeof(tmp_path), dir, api, hash ^ tag, ".tmp");
+
+    void *f = fopen(tmp_path, "wb");
+    if (!f) {
+        return false;
+    }
+    uint64_t header[2] = {
+        kGPUKernelCacheMagic | ((uint64_t)kGPUKernelCacheVersion << 32),
+        (uint64_t)size,
+    };
+    bool ok = fwrite(header, sizeof(header), 1, f) == 1 &&
+              fwrite(data, size, 1, f) == 1;
+    fclose(f);
+    if (!ok) {
+        remove(tmp_path);
+        return false;
+    }
+    if (rename(tmp_path, path) != 0) {
+        remove(tmp_path);
+        return false;
+    }
+    debug(user_context) << "    stored GPU kernel binary to " << path << "\n";
+    return true;
+}
+
 template<typename ContextT, typename ModuleStateT>
 class GPUCompilationCache {
     struct CachedCompilation {
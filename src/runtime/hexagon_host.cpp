@@ -380,8 +380,134 @@ WEAK int map_arguments(void *user_context, int arg_count,
     return mapped_count;
 }
 
+// A small queue of launches submitted to the DSP but not yet known
+// to have finished, so back-to-back offloaded stages overlap argument
+// marshalling and FastRPC latency with remote execution instead of
+// serializing on it. remote_run calls are issued in order from one
+// submission thread, which preserves the dataflow between stages that
+// only communicate through ION buffers. Disabled (depth 0) unless
+// enabled via halide_hexagon_set_rpc_queue_depth.
+constexpr int max_pending_rpcs = 8;
+
+struct pending_rpc {
+    halide_hexagon_handle_t module;
+    halide_hexagon_handle_t function;
+    remote_buffer *input_buffers;
+    remote_buffer *output_buffers;
+    remote_buffer *input_scalars;
+    int input_buffer_count;
+    int output_buffer_count;
+    int input_scalar_count;
+    // One allocation holding the remote_buffer arrays above and
+    // copies of the scalar argument payloads, which would otherwise
+    // dangle when the submitting pipeline's frame returns.
+    void *payload;
+};
+
+WEAK halide_mutex rpc_queue_lock = {{0}};
+WEAK halide_cond rpc_queue_not_empty = {{0}};
+WEAK halide_cond rpc_queue_changed = {{0}};
+WEAK pending_rpc rpc_queue[max_pending_rpcs];
+WEAK int rpc_queue_head = 0;
+WEAK int rpc_queue_size = 0;
+WEAK int rpc_queue_depth = 0;
+WEAK int rpc_queue_error = 0;
+WEAK bool rpc_thread_shutdown = false;
+WEAK halide_thread *rpc_thread = nullptr;
+
+WEAK void rpc_submission_thread(void *) {
+    halide_mutex_lock(&rpc_queue_lock);
+    while (true) {
+        if (rpc_queue_size == 0) {
+            if (rpc_thread_shutdown) {
+                break;
+            }
+            halide_cond_wait(&rpc_queue_not_empty, &rpc_queue_lock);
+            continue;
+        }
+        // The entry stays in its slot until the run finishes;
+        // enqueuers write at (head + size) % max_pending_rpcs, so the
+        // slot cannot be reused early.
+        pending_rpc r = rpc_queue[rpc_queue_head];
+        halide_mutex_unlock(&rpc_queue_lock);
+        int result = remote_run(r.module, r.function,
+                                r.input_buffers, r.input_buffer_count,
+                                r.output_buffers, r.output_buffer_count,
+                                r.input_scalars, r.input_scalar_count);
+        halide_free(nullptr, r.payload);
+        halide_mutex_lock(&rpc_queue_lock);
+        if (result != 0) {
+            rpc_queue_error = result;
+        }
+        rpc_queue_head = (rpc_queue_head + 1) % max_pending_rpcs;
+        rpc_queue_size--;
+        halide_cond_broadcast(&rpc_queue_changed);
+    }
+    halide_mutex_unlock(&rpc_queue_lock);
+}
+
+// Wait until every queued launch has finished, and report any error
+// one of them produced. Anything that reads, frees, or remaps device
+// memory must pass through here first.
+WEAK int sync_rpc_queue(void *user_context) {
+    halide_mutex_lock(&rpc_queue_lock);
+    while (rpc_queue_size > 0) {
+        halide_cond_wait(&rpc_queue_changed, &rpc_queue_lock);
+    }
+    int result = rpc_queue_error;
+    rpc_queue_error = 0;
+    halide_mutex_unlock(&rpc_queue_lock);
+    if (result != 0) {
+        error(user_context) << "Hexagon pipeline failed.\n";
+    }
+    return result;
+}
+
+// A launch can only be queued if nothing on the host aliases its
+// arguments once halide_hexagon_run returns: every buffer argument
+// must live in an ION allocation shared with the DSP. Host-side
+// buffer arguments are bounce buffers the caller may reuse.
+WEAK bool buffers_are_all_ion(int arg_count, uint64_t arg_sizes[], void *args[], int arg_flags[]) {
+    for (int i = 0; i < arg_count; i++) {
+        if (arg_flags[i] == 0) {
+            continue;
+        }
+        struct hexagon_device_pointer {
+            uint64_t dev;
+            uint8_t *host;
+        };
+        const hexagon_device_pointer *b = (hexagon_device_pointer *)args[i];
+        if (b->dev == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
 }  // namespace
 
+WEAK int halide_hexagon_set_rpc_queue_depth(void *user_context, int depth) {
+    debug(user_context)
+        << "Hexagon: halide_hexagon_set_rpc_queue_depth (user_context: " << user_context
+        << ", depth: " << depth << ")\n";
+    if (depth < 0) {
+        depth = 0;
+    }
+    if (depth > max_pending_rpcs) {
+        depth = max_pending_rpcs;
+    }
+    halide_mutex_lock(&rpc_queue_lock);
+    int old = rpc_queue_depth;
+    rpc_queue_depth = depth;
+    halide_mutex_unlock(&rpc_queue_lock);
+    if (depth == 0) {
+        // Drain so the caller can rely on synchronous behavior from
+        // here on.
+        return sync_rpc_queue(user_context) == 0 ? old : -1;
+    }
+    return old;
+}
+
 WEAK int halide_hexagon_run(void *user_context,
                             void *state_ptr,
                             const char *name,
@@ -450,6 +576,69 @@ WEAK int halide_hexagon_run(void *user_context,
         return input_scalar_count;
     }
 
+    // If pipelined submission is enabled and it is safe (everything
+    // the DSP will touch lives in shared ION buffers, and remote
+    // profiling isn't sampling the in-flight launch), queue the
+    // launch and return. The submission thread issues queued launches
+    // in order, so a stage consuming a queued stage's output stays
+    // behind it.
+    halide_mutex_lock(&rpc_queue_lock);
+    if (rpc_queue_depth > 0 &&
+        !remote_poll_profiler_state &&
+        buffers_are_all_ion(arg_count, arg_sizes, args, arg_flags)) {
+        while (rpc_queue_size >= rpc_queue_depth) {
+            halide_cond_wait(&rpc_queue_changed, &rpc_queue_lock);
+        }
+        size_t buffers_bytes = (size_t)arg_count * sizeof(remote_buffer);
+        size_t scalars_bytes = 0;
+        for (int i = 0; i < input_scalar_count; i++) {
+            scalars_bytes += input_scalars[i].dataLen;
+        }
+        void *payload = halide_malloc(user_context, buffers_bytes + scalars_bytes);
+        if (payload != nullptr) {
+            // The marshalled remote_buffer arrays live on this
+            // frame's stack and the scalars point into the caller's,
+            // so both are copied into the payload.
+            remote_buffer *copied = (remote_buffer *)payload;
+            memcpy(copied, mapped_buffers, buffers_bytes);
+            remote_buffer *copied_scalars = copied + input_buffer_count + output_buffer_count;
+            uint8_t *scalar_storage = (uint8_t *)payload + buffers_bytes;
+            for (int i = 0; i < input_scalar_count; i++) {
+                memcpy(scalar_storage, copied_scalars[i].data, copied_scalars[i].dataLen);
+                copied_scalars[i].data = scalar_storage;
+                scalar_storage += copied_scalars[i].dataLen;
+            }
+            pending_rpc &r = rpc_queue[(rpc_queue_head + rpc_queue_size) % max_pending_rpcs];
+            r.module = module;
+            r.function = *function;
+            r.input_buffers = copied;
+            r.input_buffer_count = input_buffer_count;
+            r.output_buffers = copied + input_buffer_count;
+            r.output_buffer_count = output_buffer_count;
+            r.input_scalars = copied_scalars;
+            r.input_scalar_count = input_scalar_count;
+            r.payload = payload;
+            rpc_queue_size++;
+            if (rpc_thread == nullptr) {
+                rpc_thread_shutdown = false;
+                rpc_thread = halide_spawn_thread(rpc_submission_thread, nullptr);
+            }
+            halide_cond_signal(&rpc_queue_not_empty);
+            halide_mutex_unlock(&rpc_queue_lock);
+            debug(user_context) << "    queued launch of " << name << "\n";
+            return 0;
+        }
+        // Allocation failure: fall through to the synchronous path.
+    }
+    halide_mutex_unlock(&rpc_queue_lock);
+
+    // Queued launches may produce this launch's inputs; drain them
+    // before running synchronously.
+    result = sync_rpc_queue(user_context);
+    if (result != 0) {
+        return result;
+    }
+
 #ifdef DEBUG_RUNTIME
     uint64_t t_before = halide_current_time_ns(user_context);
 #endif
@@ -492,6 +681,19 @@ WEAK int halide_hexagon_device_release(void *user_context) {
     debug(user_context)
         << "Hexagon: halide_hexagon_device_release (user_context: " << user_context << ")\n";
 
+    // Drain and stop the RPC submission thread before tearing down
+    // the modules its queued launches refer to.
+    sync_rpc_queue(user_context);
+    halide_mutex_lock(&rpc_queue_lock);
+    halide_thread *t = rpc_thread;
+    rpc_thread = nullptr;
+    rpc_thread_shutdown = true;
+    halide_cond_signal(&rpc_queue_not_empty);
+    halide_mutex_unlock(&rpc_queue_lock);
+    if (t != nullptr) {
+        halide_join_thread(t);
+    }
+
     ScopedMutexLock lock(&thread_lock);
 
     // Release all of the remote side modules.
@@ -612,6 +814,12 @@ WEAK int halide_hexagon_device_free(void *user_context, halide_buffer_t *buf) {
         << "Hexagon: halide_hexagon_device_free (user_context: " << user_context
         << ", buf: " << buf << ")\n";
 
+    // A queued launch may still be using this allocation.
+    int err = sync_rpc_queue(user_context);
+    if (err != 0) {
+        return err;
+    }
+
 #ifdef DEBUG_RUNTIME
     uint64_t t_before = halide_current_time_ns(user_context);
 #endif
@@ -657,6 +865,11 @@ WEAK int halide_hexagon_copy_to_device(void *user_context, halide_buffer_t *buf)
     uint64_t t_before = halide_current_time_ns(user_context);
 #endif
 
+    err = sync_rpc_queue(user_context);
+    if (err != 0) {
+        return err;
+    }
+
     halide_assert(user_context, buf->host && buf->device);
     device_copy c = make_host_to_device_copy(buf);
 
@@ -681,6 +894,11 @@ WEAK int halide_hexagon_copy_to_host(void *user_context, struct halide_buffer_t
     uint64_t t_before = halide_current_time_ns(user_context);
 #endif
 
+    int err = sync_rpc_queue(user_context);
+    if (err != 0) {
+        return err;
+    }
+
     halide_assert(user_context, buf->host && buf->device);
     device_copy c = make_device_to_host_copy(buf);
 
@@ -699,8 +917,9 @@ WEAK int halide_hexagon_copy_to_host(void *user_context, struct halide_buffer_t
 WEAK int halide_hexagon_device_sync(void *user_context, struct halide_buffer_t *) {
     debug(user_context)
         << "Hexagon: halide_hexagon_device_sync (user_context: " << user_context << ")\n";
-    // Nothing to do.
-    return 0;
+    // Launches are synchronous unless the RPC queue is enabled; wait
+    // for anything still queued.
+    return sync_rpc_queue(user_context);
 }
 
 WEAK int halide_hexagon_wrap_device_handle(void *user_context, struct halide_buffer_t *buf,
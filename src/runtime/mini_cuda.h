@@ -25,6 +25,29 @@ typedef struct CUfunc_st *CUfunction; /**< CUDA function */
 typedef struct CUstream_st *CUstream; /**< CUDA stream */
 typedef struct CUevent_st *CUevent;   /**< CUDA event */
 typedef struct CUarray_st *CUarray;
+typedef struct CUgraph_st *CUgraph;         /**< CUDA graph */
+typedef struct CUgraphExec_st *CUgraphExec; /**< CUDA executable graph */
+typedef struct CUgraphNode_st *CUgraphNode; /**< CUDA graph node */
+
+typedef enum CUstreamCaptureMode_enum {
+    CU_STREAM_CAPTURE_MODE_GLOBAL = 0,
+    CU_STREAM_CAPTURE_MODE_THREAD_LOCAL = 1,
+    CU_STREAM_CAPTURE_MODE_RELAXED = 2
+} CUstreamCaptureMode;
+
+typedef enum CUctx_flags_enum {
+    CU_CTX_SCHED_AUTO = 0,
+    CU_CTX_SCHED_SPIN = 1,
+    CU_CTX_SCHED_YIELD = 2,
+    CU_CTX_SCHED_BLOCKING_SYNC = 4,
+    CU_CTX_SCHED_MASK = 7
+} CUctx_flags;
+
+typedef enum CUevent_flags_enum {
+    CU_EVENT_DEFAULT = 0,
+    CU_EVENT_BLOCKING_SYNC = 1,
+    CU_EVENT_DISABLE_TIMING = 2
+} CUevent_flags;
 
 typedef enum CUjit_option_enum {
     CU_JIT_MAX_REGISTERS = 0,
@@ -297,6 +297,51 @@ struct device_handle {
 
 WEAK Halide::Internal::GPUCompilationCache<cl_context, cl_program> compilation_cache;
 
+using Halide::Internal::gpu_kernel_cache_dir;
+using Halide::Internal::gpu_kernel_cache_hash;
+using Halide::Internal::gpu_kernel_cache_load;
+using Halide::Internal::gpu_kernel_cache_store;
+
+// Zero-copy shared allocations, for devices (integrated GPUs) where
+// host and device share DRAM. When the mode is on,
+// halide_opencl_device_and_host_malloc allocates the buffer with
+// CL_MEM_ALLOC_HOST_PTR and maps it to get the host pointer, so host
+// and device views are backed by the same memory. copy_to_device on
+// such a buffer becomes an unmap (flushing host writes) and
+// copy_to_host a re-map (flushing device writes) -- on integrated
+// GPUs both are no-ops in the driver instead of a full copy. Enabled
+// by halide_opencl_enable_host_shared_allocations or the
+// HL_OPENCL_HOST_SHARED environment variable; whether the device
+// actually shares memory with the host is the caller's call to make.
+WEAK struct SharedAllocEntry {
+    cl_mem mem;
+    void *host;
+    size_t size;
+    bool mapped;
+    SharedAllocEntry *next;
+} *shared_alloc_list = nullptr;
+WEAK halide_mutex shared_alloc_lock;
+// -1 = consult the environment on first use, 0 = off, 1 = on.
+WEAK int host_shared_enabled = -1;
+
+WEAK bool host_shared_in_use() {
+    if (host_shared_enabled < 0) {
+        const char *e = getenv("HL_OPENCL_HOST_SHARED");
+        host_shared_enabled = (e && e[0]) ? 1 : 0;
+    }
+    return host_shared_enabled == 1;
+}
+
+// Caller must hold shared_alloc_lock.
+WEAK SharedAllocEntry *find_shared_alloc(cl_mem mem) {
+    for (SharedAllocEntry *e = shared_alloc_list; e; e = e->next) {
+        if (e->mem == mem) {
+            return e;
+        }
+    }
+    return nullptr;
+}
+
 WEAK bool validate_device_pointer(void *user_context, halide_buffer_t *buf, size_t size = 0) {
     if (buf->device == 0) {
         return true;
@@ -595,6 +640,46 @@ WEAK cl_program compile_kernel(void *user_context, cl_context ctx, const char *s
     const char *extra_options = halide_opencl_get_build_options(user_context);
     options << " " << extra_options;
 
+    // Key for the on-disk kernel cache: the source, the build
+    // options, and the device identity (name and driver version, so a
+    // driver update invalidates stale binaries).
+    uint64_t cache_key = 0;
+    if (gpu_kernel_cache_dir()) {
+        cache_key = gpu_kernel_cache_hash(src, size > 0 ? (size_t)size : strlen(src), 0xcbf29ce484222325ULL);
+        cache_key = gpu_kernel_cache_hash(options.str(), strlen(options.str()), cache_key);
+        char device_id_str[256];
+        if (clGetDeviceInfo(dev, CL_DEVICE_NAME, sizeof(device_id_str), device_id_str, nullptr) == CL_SUCCESS) {
+            cache_key = gpu_kernel_cache_hash(device_id_str, strlen(device_id_str), cache_key);
+        }
+        if (clGetDeviceInfo(dev, CL_DRIVER_VERSION, sizeof(device_id_str), device_id_str, nullptr) == CL_SUCCESS) {
+            cache_key = gpu_kernel_cache_hash(device_id_str, strlen(device_id_str), cache_key);
+        }
+
+        // On a hit, rebuild the program from the stored device binary,
+        // which skips the source compile. Any failure is just a miss.
+        void *binary = nullptr;
+        size_t binary_size = 0;
+        if (gpu_kernel_cache_load(user_context, "opencl", cache_key, &binary, &binary_size)) {
+            const unsigned char *binaries[] = {(const unsigned char *)binary};
+            cl_int binary_status = CL_SUCCESS;
+            debug(user_context) << "    clCreateProgramWithBinary (" << (uint64_t)binary_size << " bytes) -> ";
+            cl_program program = clCreateProgramWithBinary(ctx, 1, devices, &binary_size,
+                                                           binaries, &binary_status, &err);
+            halide_free(user_context, binary);
+            if (err == CL_SUCCESS && binary_status == CL_SUCCESS) {
+                debug(user_context) << (void *)program << "\n";
+                err = clBuildProgram(program, 1, devices, options.str(), nullptr, nullptr);
+                if (err == CL_SUCCESS) {
+                    return program;
+                }
+                clReleaseProgram(program);
+            } else {
+                debug(user_context) << get_opencl_error_name(err) << "\n";
+            }
+            debug(user_context) << "    cached binary rejected; recompiling from source\n";
+        }
+    }
+
     const char *sources[] = {src};
     debug(user_context) << "    clCreateProgramWithSource -> ";
     cl_program program = clCreateProgramWithSource(ctx, 1, &sources[0], nullptr, &err);
@@ -631,6 +716,25 @@ WEAK cl_program compile_kernel(void *user_context, cl_context ctx, const char *s
 
         return nullptr;
     }
+
+    // Persist the device binary for the next process start.
+    if (gpu_kernel_cache_dir()) {
+        size_t binary_size = 0;
+        if (clGetProgramInfo(program, CL_PROGRAM_BINARY_SIZES,
+                             sizeof(binary_size), &binary_size, nullptr) == CL_SUCCESS &&
+            binary_size > 0) {
+            void *binary = halide_malloc(user_context, binary_size);
+            if (binary) {
+                unsigned char *binaries[] = {(unsigned char *)binary};
+                if (clGetProgramInfo(program, CL_PROGRAM_BINARIES,
+                                     sizeof(binaries), binaries, nullptr) == CL_SUCCESS) {
+                    gpu_kernel_cache_store(user_context, "opencl", cache_key, binary, binary_size);
+                }
+                halide_free(user_context, binary);
+            }
+        }
+    }
+
     return program;
 }
 
@@ -988,6 +1092,51 @@ WEAK int halide_opencl_buffer_copy(void *user_context, struct halide_buffer_t *s
     halide_assert(user_context, from_host || src->device);
     halide_assert(user_context, to_host || dst->device);
 
+    // For a shared (zero-copy) allocation the host and device views
+    // are the same memory, so the "copy" reduces to an unmap (flush
+    // host writes before device use) or a re-map (flush device writes
+    // before host use).
+    if (src == dst && src->device != 0) {
+        ScopedMutexLock lock(&shared_alloc_lock);
+        SharedAllocEntry *entry = find_shared_alloc(((device_handle *)src->device)->mem);
+        if (entry) {
+            ClContext ctx(user_context);
+            if (ctx.error_code != CL_SUCCESS) {
+                return ctx.error_code;
+            }
+            cl_int err = CL_SUCCESS;
+            if (to_host && !entry->mapped) {
+                debug(user_context) << "CL: remapping shared allocation " << (void *)entry->mem << "\n";
+                void *mapped = clEnqueueMapBuffer(ctx.cmd_queue, entry->mem, CL_TRUE,
+                                                  CL_MAP_READ | CL_MAP_WRITE,
+                                                  0, entry->size, 0, nullptr, nullptr, &err);
+                if (err != CL_SUCCESS || mapped == nullptr) {
+                    error(user_context) << "CL: clEnqueueMapBuffer failed: "
+                                        << get_opencl_error_name(err);
+                    return err;
+                }
+                entry->mapped = true;
+                if (mapped != entry->host) {
+                    // The implementation moved the mapping.
+                    entry->host = mapped;
+                    dst->host = (uint8_t *)mapped;
+                }
+            } else if (!to_host && entry->mapped) {
+                debug(user_context) << "CL: unmapping shared allocation " << (void *)entry->mem << "\n";
+                err = clEnqueueUnmapMemObject(ctx.cmd_queue, entry->mem, entry->host,
+                                              0, nullptr, nullptr);
+                if (err != CL_SUCCESS) {
+                    error(user_context) << "CL: clEnqueueUnmapMemObject failed: "
+                                        << get_opencl_error_name(err);
+                    return err;
+                }
+                clFinish(ctx.cmd_queue);
+                entry->mapped = false;
+            }
+            return 0;
+        }
+    }
+
     device_copy c = make_buffer_copy(src, from_host, dst, to_host);
 
     int err = 0;
@@ -1086,31 +1235,15 @@ WEAK int halide_opencl_run(void *user_context,
     size_t global_dim[3] = {(size_t)blocksX * threadsX, (size_t)blocksY * threadsY, (size_t)blocksZ * threadsZ};
     size_t local_dim[3] = {(size_t)threadsX, (size_t)threadsY, (size_t)threadsZ};
 
-    // Set args
+    // Set args. Buffers take two kernel arguments: the cl_mem of the
+    // underlying allocation and the byte offset of any crop within
+    // it, which the kernel adds to the pointer. Passing the offset
+    // avoids clCreateSubBuffer, which many drivers reject for offsets
+    // not aligned to CL_DEVICE_MEM_BASE_ADDR_ALIGN.
     int i = 0;
-
-    // Count sub buffers needed for crops.
-    int sub_buffers_needed = 0;
+    int cl_arg = 0;
     while (arg_sizes[i] != 0) {
-        if (arg_is_buffer[i] &&
-            ((device_handle *)((halide_buffer_t *)args[i])->device)->offset != 0) {
-            sub_buffers_needed++;
-        }
-        i += 1;
-    }
-    cl_mem *sub_buffers = nullptr;
-    int sub_buffers_saved = 0;
-    if (sub_buffers_needed > 0) {
-        sub_buffers = (cl_mem *)malloc(sizeof(cl_mem) * sub_buffers_needed);
-        if (sub_buffers == nullptr) {
-            return halide_error_code_out_of_memory;
-        }
-        memset(sub_buffers, 0, sizeof(cl_mem) * sub_buffers_needed);
-    }
-
-    i = 0;
-    while (arg_sizes[i] != 0) {
-        debug(user_context) << "    clSetKernelArg " << i
+        debug(user_context) << "    clSetKernelArg " << cl_arg
                             << " " << (int)arg_sizes[i]
                             << " [" << (*((void **)args[i])) << " ...] "
                             << arg_is_buffer[i] << "\n";
@@ -1120,30 +1253,21 @@ WEAK int halide_opencl_run(void *user_context,
         if (arg_is_buffer[i]) {
             halide_assert(user_context, arg_sizes[i] == sizeof(uint64_t));
             cl_mem mem = ((device_handle *)((halide_buffer_t *)this_arg)->device)->mem;
-            uint64_t offset = ((device_handle *)((halide_buffer_t *)this_arg)->device)->offset;
-
-            if (offset != 0) {
-                cl_buffer_region region = {(size_t)offset, ((halide_buffer_t *)this_arg)->size_in_bytes()};
-                // The sub-buffer encompasses the linear range of addresses that
-                // span the crop.
-                mem = clCreateSubBuffer(mem, CL_MEM_READ_WRITE, CL_BUFFER_CREATE_TYPE_REGION, &region, &err);
-                sub_buffers[sub_buffers_saved++] = mem;
-            }
+            cl_ulong offset = ((device_handle *)((halide_buffer_t *)this_arg)->device)->offset;
+
+            debug(user_context) << "Mapped dev handle is: " << (void *)mem
+                                << " offset: " << (uint64_t)offset << "\n";
+            err = clSetKernelArg(f, cl_arg++, sizeof(mem), &mem);
             if (err == CL_SUCCESS) {
-                debug(user_context) << "Mapped dev handle is: " << (void *)mem << "\n";
-                err = clSetKernelArg(f, i, sizeof(mem), &mem);
+                err = clSetKernelArg(f, cl_arg++, sizeof(offset), &offset);
             }
         } else {
-            err = clSetKernelArg(f, i, arg_sizes[i], this_arg);
+            err = clSetKernelArg(f, cl_arg++, arg_sizes[i], this_arg);
         }
 
         if (err != CL_SUCCESS) {
             error(user_context) << "CL: clSetKernelArg failed: "
                                 << get_opencl_error_name(err);
-            for (int sub_buf_index = 0; sub_buf_index < sub_buffers_saved; sub_buf_index++) {
-                clReleaseMemObject(sub_buffers[sub_buf_index]);
-            }
-            free(sub_buffers);
             return err;
         }
         i++;
@@ -1151,8 +1275,8 @@ WEAK int halide_opencl_run(void *user_context,
     // Set the shared mem buffer last
     // Always set at least 1 byte of shmem, to keep the launch happy
     debug(user_context)
-        << "    clSetKernelArg " << i << " " << shared_mem_bytes << " [nullptr]\n";
-    err = clSetKernelArg(f, i, (shared_mem_bytes > 0) ? shared_mem_bytes : 1, nullptr);
+        << "    clSetKernelArg " << cl_arg << " " << shared_mem_bytes << " [nullptr]\n";
+    err = clSetKernelArg(f, cl_arg, (shared_mem_bytes > 0) ? shared_mem_bytes : 1, nullptr);
     if (err != CL_SUCCESS) {
         error(user_context) << "CL: clSetKernelArg failed "
                             << get_opencl_error_name(err);
@@ -1171,13 +1295,6 @@ WEAK int halide_opencl_run(void *user_context,
                                  0, nullptr, nullptr);
     debug(user_context) << get_opencl_error_name(err) << "\n";
 
-    // Now that the kernel is enqueued, OpenCL is holding its own
-    // references to sub buffers and the local ones can be released.
-    for (int sub_buf_index = 0; sub_buf_index < sub_buffers_saved; sub_buf_index++) {
-        clReleaseMemObject(sub_buffers[sub_buf_index]);
-    }
-    free(sub_buffers);
-
     if (err != CL_SUCCESS) {
         error(user_context) << "CL: clEnqueueNDRangeKernel failed: "
                             << get_opencl_error_name(err) << "\n";
@@ -1201,11 +1318,90 @@ WEAK int halide_opencl_run(void *user_context,
 }
 
 WEAK int halide_opencl_device_and_host_malloc(void *user_context, struct halide_buffer_t *buf) {
+    if (host_shared_in_use()) {
+        ClContext ctx(user_context);
+        if (ctx.error_code == CL_SUCCESS) {
+            size_t size = buf->size_in_bytes();
+            device_handle *dev_handle = (device_handle *)malloc(sizeof(device_handle));
+            SharedAllocEntry *entry = (SharedAllocEntry *)malloc(sizeof(SharedAllocEntry));
+            if (dev_handle && entry) {
+                cl_int err;
+                debug(user_context) << "    clCreateBuffer (shared) -> " << (int)size << " ";
+                cl_mem mem = clCreateBuffer(ctx.context,
+                                            CL_MEM_READ_WRITE | CL_MEM_ALLOC_HOST_PTR,
+                                            size, nullptr, &err);
+                if (err == CL_SUCCESS && mem != nullptr) {
+                    debug(user_context) << (void *)mem << "\n";
+                    void *host = clEnqueueMapBuffer(ctx.cmd_queue, mem, CL_TRUE,
+                                                    CL_MAP_READ | CL_MAP_WRITE,
+                                                    0, size, 0, nullptr, nullptr, &err);
+                    if (err == CL_SUCCESS && host != nullptr) {
+                        dev_handle->mem = mem;
+                        dev_handle->offset = 0;
+                        buf->device = (uint64_t)dev_handle;
+                        buf->device_interface = &opencl_device_interface;
+                        buf->device_interface->impl->use_module();
+                        buf->host = (uint8_t *)host;
+                        entry->mem = mem;
+                        entry->host = host;
+                        entry->size = size;
+                        entry->mapped = true;
+                        {
+                            ScopedMutexLock lock(&shared_alloc_lock);
+                            entry->next = shared_alloc_list;
+                            shared_alloc_list = entry;
+                        }
+                        return 0;
+                    }
+                    clReleaseMemObject(mem);
+                } else {
+                    debug(user_context) << get_opencl_error_name(err) << "\n";
+                }
+            }
+            free(dev_handle);
+            free(entry);
+            debug(user_context) << "    shared allocation failed; falling back to separate host and device memory\n";
+        }
+    }
     return halide_default_device_and_host_malloc(user_context, buf, &opencl_device_interface);
 }
 
 WEAK int halide_opencl_device_and_host_free(void *user_context, struct halide_buffer_t *buf) {
-    return halide_default_device_and_host_free(user_context, buf, &opencl_device_interface);
+    // If this is one of our shared allocations, the host side is the
+    // mapping, not a halide_malloc.
+    SharedAllocEntry *entry = nullptr;
+    if (buf->device != 0) {
+        cl_mem mem = ((device_handle *)buf->device)->mem;
+        ScopedMutexLock lock(&shared_alloc_lock);
+        for (SharedAllocEntry **prev_ptr = &shared_alloc_list; *prev_ptr; prev_ptr = &(*prev_ptr)->next) {
+            if ((*prev_ptr)->mem == mem) {
+                entry = *prev_ptr;
+                *prev_ptr = entry->next;
+                break;
+            }
+        }
+    }
+    if (entry == nullptr) {
+        return halide_default_device_and_host_free(user_context, buf, &opencl_device_interface);
+    }
+
+    if (entry->mapped) {
+        ClContext ctx(user_context);
+        if (ctx.error_code == CL_SUCCESS) {
+            clEnqueueUnmapMemObject(ctx.cmd_queue, entry->mem, entry->host, 0, nullptr, nullptr);
+            clFinish(ctx.cmd_queue);
+        }
+    }
+    free(entry);
+    int result = halide_opencl_device_free(user_context, buf);
+    buf->host = nullptr;
+    buf->set_host_dirty(false);
+    buf->set_device_dirty(false);
+    return result;
+}
+
+WEAK void halide_opencl_enable_host_shared_allocations(void *user_context, bool enable) {
+    host_shared_enabled = enable ? 1 : 0;
 }
 
 WEAK int halide_opencl_wrap_cl_mem(void *user_context, struct halide_buffer_t *buf, uint64_t mem) {
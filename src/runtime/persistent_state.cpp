@@ -0,0 +1,174 @@
+#include "HalideRuntime.h"
+#include "scoped_mutex_lock.h"
+
+namespace Halide {
+namespace Runtime {
+namespace Internal {
+
+// One retained realization, keyed by a string baked into the pipeline
+// by the store_persistent lowering. The contents and shape are copied
+// out of the pipeline's buffer at the end of each invocation and
+// copied back in at the start of the next, so nothing here aliases
+// pipeline-owned memory.
+struct PersistentState {
+    PersistentState *next;
+    char *key;
+    halide_type_t type;
+    int32_t dimensions;
+    halide_dimension_t *shape;
+    uint8_t *host;
+};
+
+WEAK halide_mutex persistent_state_lock;
+WEAK PersistentState *persistent_state_list = nullptr;
+
+WEAK PersistentState *find_persistent_state_already_locked(const char *key) {
+    for (PersistentState *p = persistent_state_list; p != nullptr; p = p->next) {
+        if (strcmp(p->key, key) == 0) {
+            return p;
+        }
+    }
+    return nullptr;
+}
+
+WEAK void free_persistent_state(void *user_context, PersistentState *p) {
+    halide_free(user_context, p->key);
+    halide_free(user_context, p->shape);
+    halide_free(user_context, p->host);
+    halide_free(user_context, p);
+}
+
+}  // namespace Internal
+}  // namespace Runtime
+}  // namespace Halide
+
+using namespace Halide::Runtime::Internal;
+
+extern "C" {
+
+// Returned by halide_persistent_state_acquire when nothing could be
+// restored; max() with any loop min leaves the loop unchanged.
+#define COMPUTE_EVERYTHING (-2147483647 - 1)
+
+WEAK int32_t halide_persistent_state_acquire(void *user_context, const char *key, halide_buffer_t *buf) {
+    if (buf == nullptr || buf->host == nullptr || buf->dimensions < 1) {
+        return COMPUTE_EVERYTHING;
+    }
+
+    ScopedMutexLock lock(&persistent_state_lock);
+
+    PersistentState *p = find_persistent_state_already_locked(key);
+    if (p == nullptr ||
+        !(p->type == buf->type) ||
+        p->dimensions != buf->dimensions) {
+        return COMPUTE_EVERYTHING;
+    }
+
+    // Slices are only restorable if the realization has the same
+    // shape as the previous invocation in every inner dimension, and
+    // the same layout along the outermost one.
+    const int d = buf->dimensions - 1;
+    for (int i = 0; i < d; i++) {
+        if (p->shape[i].min != buf->dim[i].min ||
+            p->shape[i].extent != buf->dim[i].extent ||
+            p->shape[i].stride != buf->dim[i].stride) {
+            return COMPUTE_EVERYTHING;
+        }
+    }
+    if (p->shape[d].stride != buf->dim[d].stride) {
+        return COMPUTE_EVERYTHING;
+    }
+
+    const int32_t stored_min = p->shape[d].min;
+    const int32_t stored_max = stored_min + p->shape[d].extent - 1;
+    const int32_t req_min = buf->dim[d].min;
+    const int32_t req_max = req_min + buf->dim[d].extent - 1;
+
+    // The produce loop can only be clamped from below, so a request
+    // starting before (or entirely after) the stored region cannot
+    // use it.
+    if (req_min < stored_min || req_min > stored_max) {
+        return COMPUTE_EVERYTHING;
+    }
+
+    const int32_t last_valid = req_max < stored_max ? req_max : stored_max;
+    const size_t slice_bytes = (size_t)buf->dim[d].stride * buf->type.bytes();
+    memcpy(buf->host,
+           p->host + (size_t)(req_min - stored_min) * slice_bytes,
+           (size_t)(last_valid - req_min + 1) * slice_bytes);
+    return last_valid + 1;
+}
+
+WEAK int halide_persistent_state_store(void *user_context, const char *key, halide_buffer_t *buf) {
+    if (buf == nullptr || buf->host == nullptr || buf->dimensions < 1) {
+        return 0;
+    }
+
+    ScopedMutexLock lock(&persistent_state_lock);
+
+    PersistentState *p = find_persistent_state_already_locked(key);
+    if (p == nullptr) {
+        p = (PersistentState *)halide_malloc(user_context, sizeof(PersistentState));
+        if (p == nullptr) {
+            return 0;
+        }
+        size_t key_bytes = strlen(key) + 1;
+        p->key = (char *)halide_malloc(user_context, key_bytes);
+        p->shape = (halide_dimension_t *)halide_malloc(user_context, buf->dimensions * sizeof(halide_dimension_t));
+        p->host = nullptr;
+        if (p->key == nullptr || p->shape == nullptr) {
+            free_persistent_state(user_context, p);
+            return 0;
+        }
+        memcpy(p->key, key, key_bytes);
+        p->next = persistent_state_list;
+        persistent_state_list = p;
+    } else if (p->dimensions != buf->dimensions) {
+        halide_free(user_context, p->shape);
+        p->shape = (halide_dimension_t *)halide_malloc(user_context, buf->dimensions * sizeof(halide_dimension_t));
+        halide_free(user_context, p->host);
+        p->host = nullptr;
+    }
+
+    // The copy is resized rather than reused: successive invocations
+    // of a video pipeline usually have identical extents, but a
+    // resize must not leave a stale shape paired with a smaller
+    // allocation.
+    halide_free(user_context, p->host);
+    size_t size = buf->size_in_bytes();
+    p->host = (uint8_t *)halide_malloc(user_context, size);
+    if (p->shape == nullptr || p->host == nullptr) {
+        // Dropping the entry is always safe; the next invocation
+        // recomputes from scratch.
+        PersistentState **prev = &persistent_state_list;
+        while (*prev != p) {
+            prev = &(*prev)->next;
+        }
+        *prev = p->next;
+        free_persistent_state(user_context, p);
+        return 0;
+    }
+    p->type = buf->type;
+    p->dimensions = buf->dimensions;
+    memcpy(p->shape, buf->dim, buf->dimensions * sizeof(halide_dimension_t));
+    memcpy(p->host, buf->host, size);
+    return 0;
+}
+
+WEAK int halide_persistent_state_clear(void *user_context, const char *key) {
+    ScopedMutexLock lock(&persistent_state_lock);
+
+    PersistentState **prev = &persistent_state_list;
+    while (*prev != nullptr) {
+        PersistentState *p = *prev;
+        if (key == nullptr || strcmp(p->key, key) == 0) {
+            *prev = p->next;
+            free_persistent_state(user_context, p);
+        } else {
+            prev = &p->next;
+        }
+    }
+    return 0;
+}
+
+}  // extern "C"
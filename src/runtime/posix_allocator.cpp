@@ -1,5 +1,6 @@
 #include "HalideRuntime.h"
 #include "runtime_internal.h"
+#include "scoped_spin_lock.h"
 
 #include "printer.h"
 
@@ -7,24 +8,284 @@ extern "C" {
 
 extern void *malloc(size_t);
 extern void free(void *);
+}
+
+namespace Halide {
+namespace Runtime {
+namespace Internal {
+
+// An optional size-classed cache of recently freed host allocations,
+// for workloads that allocate and free the same handful of buffer
+// sizes every frame. Allocations are rounded up to a power-of-two
+// size class, and each class is split into several "magazines" of
+// cached pointers, each behind its own spin lock. Threads pick a
+// magazine by hashing the address of a stack local -- each thread's
+// stack occupies a distinct region, so this spreads concurrent
+// threads across magazines well enough that they almost never contend
+// on a lock. Off by default; enabled by giving it a byte budget via
+// halide_set_host_allocation_cache_size or the
+// HL_HOST_ALLOCATION_CACHE_SIZE environment variable.
+const int kHostCacheMinClassBits = 6;  // Smallest class is 64 bytes
+const int kHostCacheNumClasses = 21;   // Largest class is 64 MB
+const int kHostCacheMagazinesPerClass = 8;
+const int kHostCacheMagazineSize = 16;
+
+WEAK struct HostAllocMagazine {
+    ScopedSpinLock::AtomicFlag lock;
+    int count;
+    void *entries[kHostCacheMagazineSize];
+} host_alloc_cache[kHostCacheNumClasses][kHostCacheMagazinesPerClass];
+
+// Bytes currently sitting in the cache, and the budget they must stay
+// under. A budget of -1 means the environment hasn't been consulted
+// yet; 0 means the cache is off.
+WEAK size_t host_alloc_cache_bytes = 0;
+WEAK int64_t host_alloc_cache_budget = -1;
+
+WEAK int64_t host_alloc_cache_budget_in_use() {
+    if (host_alloc_cache_budget < 0) {
+        int64_t budget = 0;
+        const char *e = getenv("HL_HOST_ALLOCATION_CACHE_SIZE");
+        if (e) {
+            while (*e >= '0' && *e <= '9') {
+                budget = budget * 10 + (*e++ - '0');
+            }
+        }
+        host_alloc_cache_budget = budget;
+    }
+    return host_alloc_cache_budget;
+}
+
+// Returns the size class for a request, or -1 if it is too large to cache.
+WEAK int host_alloc_size_class(size_t x) {
+    size_t class_size = (size_t)1 << kHostCacheMinClassBits;
+    for (int cls = 0; cls < kHostCacheNumClasses; cls++) {
+        if (x <= class_size) {
+            return cls;
+        }
+        class_size <<= 1;
+    }
+    return -1;
+}
+
+ALWAYS_INLINE int host_alloc_magazine_slot() {
+    int probe;
+    uintptr_t p = (uintptr_t)&probe;
+    return (int)((p >> 16) ^ (p >> 22)) & (kHostCacheMagazinesPerClass - 1);
+}
+
+WEAK void host_alloc_cache_flush() {
+    for (int cls = 0; cls < kHostCacheNumClasses; cls++) {
+        for (int m = 0; m < kHostCacheMagazinesPerClass; m++) {
+            HostAllocMagazine *mag = &host_alloc_cache[cls][m];
+            void *to_free[kHostCacheMagazineSize];
+            int n;
+            {
+                ScopedSpinLock lock(&mag->lock);
+                n = mag->count;
+                for (int i = 0; i < n; i++) {
+                    to_free[i] = mag->entries[i];
+                }
+                mag->count = 0;
+            }
+            for (int i = 0; i < n; i++) {
+                __sync_fetch_and_sub(&host_alloc_cache_bytes,
+                                     (size_t)1 << (kHostCacheMinClassBits + cls));
+                free(((void **)to_free[i])[-1]);
+            }
+        }
+    }
+}
+
+// An optional policy for large allocations: requests of at least a
+// byte threshold are served by anonymous mmap rather than malloc,
+// asking for 2MB huge pages up front and advising transparent huge
+// pages as a fallback, which cuts TLB pressure for buffers much
+// larger than a page. The alignment of every request can also be
+// raised above halide_malloc_alignment. Configured with
+// halide_set_allocation_policy or the HL_HUGE_PAGE_THRESHOLD
+// environment variable. The mmap path is Linux-only; elsewhere the
+// threshold is ignored.
+WEAK int64_t huge_page_threshold = -1;  // -1 means the environment hasn't been consulted
+WEAK size_t allocation_alignment_override = 0;
+
+WEAK int64_t huge_page_threshold_in_use() {
+    if (huge_page_threshold < 0) {
+        int64_t threshold = 0;
+        const char *e = getenv("HL_HUGE_PAGE_THRESHOLD");
+        if (e) {
+            while (*e >= '0' && *e <= '9') {
+                threshold = threshold * 10 + (*e++ - '0');
+            }
+        }
+        huge_page_threshold = threshold;
+    }
+    return huge_page_threshold;
+}
+
+#ifdef __linux__
+
+// We can't include sys/mman.h in freestanding mode, so declare the
+// little we use of the ABI directly.
+extern "C" void *mmap(void *, size_t, int, int, int, long);
+extern "C" int munmap(void *, size_t);
+extern "C" int madvise(void *, size_t, int);
+
+const int kProtReadWrite = 0x3;         // PROT_READ | PROT_WRITE
+const int kMapPrivateAnonymous = 0x22;  // MAP_PRIVATE | MAP_ANONYMOUS
+const int kMapHugeTLB = 0x40000;        // MAP_HUGETLB
+const int kMadvHugePage = 14;           // MADV_HUGEPAGE
+const size_t kHugePageSize = 2 * 1024 * 1024;
+
+// Maps at least bytes, rounded up to whole huge pages. Returns null
+// on failure; on success *length_out is the mapped length to pass to
+// huge_page_free.
+WEAK void *huge_page_alloc(size_t bytes, size_t *length_out) {
+    size_t length = (bytes + kHugePageSize - 1) & ~(kHugePageSize - 1);
+    void *p = mmap(nullptr, length, kProtReadWrite,
+                   kMapPrivateAnonymous | kMapHugeTLB, -1, 0);
+    if (p == (void *)-1) {
+        // No pre-reserved huge pages available; take a normal mapping
+        // and ask the kernel for transparent huge pages instead.
+        p = mmap(nullptr, length, kProtReadWrite, kMapPrivateAnonymous, -1, 0);
+        if (p == (void *)-1) {
+            return nullptr;
+        }
+        madvise(p, length, kMadvHugePage);
+    }
+    *length_out = length;
+    return p;
+}
+
+WEAK void huge_page_free(void *base, size_t length) {
+    munmap(base, length);
+}
+
+#else
+
+WEAK void *huge_page_alloc(size_t bytes, size_t *length_out) {
+    return nullptr;
+}
+
+WEAK void huge_page_free(void *base, size_t length) {
+}
+
+#endif
+
+}  // namespace Internal
+}  // namespace Runtime
+}  // namespace Halide
+
+extern "C" {
 
 WEAK void *halide_default_malloc(void *user_context, size_t x) {
+    size_t alignment = halide_malloc_alignment();
+    if (allocation_alignment_override > alignment) {
+        alignment = allocation_alignment_override;
+    }
+    const int64_t huge_threshold = huge_page_threshold_in_use();
+    if (huge_threshold > 0 && x >= (uint64_t)huge_threshold) {
+        // Same header layout as the malloc path below, plus the
+        // mapped length one slot further down. The returned pointer
+        // is a full alignment's width past the mapping base, so all
+        // supported alignments leave room for the three slots.
+        size_t length = 0;
+        void *base = huge_page_alloc(x + alignment, &length);
+        if (base) {
+            void *ptr = (void *)((uint8_t *)base + alignment);
+            ((void **)ptr)[-1] = base;
+            ((void **)ptr)[-2] = (void *)(intptr_t)-2;  // marks an mmap allocation
+            ((size_t *)ptr)[-3] = length;
+            return ptr;
+        }
+        // Mapping failed; fall through to the malloc path.
+    }
+    const int cls = host_alloc_size_class(x);
+    size_t size = x;
+    bool rounded_to_class = false;
+    if (host_alloc_cache_budget_in_use() > 0 && cls >= 0) {
+        size = (size_t)1 << (kHostCacheMinClassBits + cls);
+        rounded_to_class = true;
+        HostAllocMagazine *mag = &host_alloc_cache[cls][host_alloc_magazine_slot()];
+        void *cached = nullptr;
+        {
+            ScopedSpinLock lock(&mag->lock);
+            if (mag->count > 0) {
+                cached = mag->entries[--mag->count];
+            }
+        }
+        if (cached) {
+            __sync_fetch_and_sub(&host_alloc_cache_bytes, size);
+            return cached;
+        }
+    }
     // Allocate enough space for aligning the pointer we return.
-    const size_t alignment = halide_malloc_alignment();
-    void *orig = malloc(x + alignment);
+    void *orig = malloc(size + alignment);
     if (orig == nullptr) {
         // Will result in a failed assertion and a call to halide_error
         return nullptr;
     }
-    // We want to store the original pointer prior to the pointer we return.
-    void *ptr = (void *)(((size_t)orig + alignment + sizeof(void *) - 1) & ~(alignment - 1));
+    // We want to store the original pointer and the size class prior
+    // to the pointer we return. All supported alignments leave room
+    // for both. Only record the class if the block really holds the
+    // class size: if the cache was disabled above we allocated just x
+    // bytes, and caching such a block would hand it to a later,
+    // larger request in the same class if the cache gets enabled.
+    void *ptr = (void *)(((size_t)orig + alignment + 2 * sizeof(void *) - 1) & ~(alignment - 1));
     ((void **)ptr)[-1] = orig;
+    ((void **)ptr)[-2] = (void *)(intptr_t)(rounded_to_class ? cls : -1);
     return ptr;
 }
 
 WEAK void halide_default_free(void *user_context, void *ptr) {
+    const int cls = (int)(intptr_t)((void **)ptr)[-2];
+    if (cls == -2) {
+        // An mmap allocation from the huge-page path above.
+        huge_page_free(((void **)ptr)[-1], ((size_t *)ptr)[-3]);
+        return;
+    }
+    if (cls >= 0) {
+        const int64_t budget = host_alloc_cache_budget_in_use();
+        const size_t size = (size_t)1 << (kHostCacheMinClassBits + cls);
+        if (budget > 0 &&
+            (int64_t)(host_alloc_cache_bytes + size) <= budget) {
+            HostAllocMagazine *mag = &host_alloc_cache[cls][host_alloc_magazine_slot()];
+            bool cached = false;
+            {
+                ScopedSpinLock lock(&mag->lock);
+                if (mag->count < kHostCacheMagazineSize) {
+                    mag->entries[mag->count++] = ptr;
+                    cached = true;
+                }
+            }
+            if (cached) {
+                __sync_fetch_and_add(&host_alloc_cache_bytes, size);
+                return;
+            }
+        }
+    }
     free(((void **)ptr)[-1]);
 }
+
+WEAK void halide_set_host_allocation_cache_size(void *user_context, uint64_t size) {
+    host_alloc_cache_budget = (int64_t)size;
+    if (size == 0 || host_alloc_cache_bytes > size) {
+        host_alloc_cache_flush();
+    }
+}
+
+WEAK void halide_set_allocation_policy(void *user_context, uint64_t huge_page_threshold_bytes, int alignment) {
+    if (alignment != 0) {
+        // The mmap path returns pointers one alignment past a
+        // page-aligned base, so the alignment can't usefully exceed a
+        // page.
+        halide_assert(user_context, (alignment & (alignment - 1)) == 0 && alignment <= 4096);
+    }
+    huge_page_threshold = (int64_t)huge_page_threshold_bytes;
+    allocation_alignment_override = (size_t)alignment;
+    // Cached blocks were aligned under the old policy.
+    host_alloc_cache_flush();
+}
 }
 
 namespace Halide {
@@ -141,6 +141,46 @@ struct thread_parker {
 }  // namespace Runtime
 }  // namespace Halide
 
+#ifdef __linux__
+extern "C" {
+// Same ABI as the glibc wrapper; the mask is a cpu_set_t, which is a
+// 1024-bit bitmask.
+extern int sched_setaffinity(int pid, size_t cpusetsize, const uint64_t *mask);
+}  // extern "C"
+#endif
+
+namespace Halide {
+namespace Runtime {
+namespace Internal {
+
+// Pin the calling worker to a cpu chosen by the affinity policy. See
+// halide_set_thread_affinity_policy in HalideRuntime.h.
+WEAK void bind_worker_thread(int worker_id, int policy) {
+#ifdef __linux__
+    // A cpu_set_t is 1024 bits.
+    const int max_cpus = 1024;
+    int num_cpus = halide_host_cpu_count();
+    if (num_cpus <= 0 || num_cpus > max_cpus) {
+        return;
+    }
+    int cpu;
+    if (policy == halide_thread_affinity_policy_spread) {
+        int half = (num_cpus + 1) / 2;
+        cpu = (worker_id % 2) * half + (worker_id / 2) % half;
+    } else {
+        cpu = worker_id % num_cpus;
+    }
+    uint64_t mask[max_cpus / 64];
+    memset(mask, 0, sizeof(mask));
+    mask[cpu >> 6] = (uint64_t)1 << (cpu & 63);
+    sched_setaffinity(0, sizeof(mask), mask);
+#endif
+}
+
+}  // namespace Internal
+}  // namespace Runtime
+}  // namespace Halide
+
 #include "synchronization_common.h"
 
 #include "thread_pool_common.h"
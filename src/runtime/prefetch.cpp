@@ -1,4 +1,62 @@
 #include "HalideRuntime.h"
+#include "runtime_internal.h"
+#include "scoped_mutex_lock.h"
+
+namespace Halide {
+namespace Runtime {
+namespace Internal {
+
+// State for runtime calibration of adaptive prefetch distances (see
+// Func::prefetch_adaptive). One entry per prefetched buffer name.
+struct prefetch_distance_entry {
+    const char *name;
+    int32_t distance;       // the distance currently being tried
+    int32_t best_distance;  // the best distance found so far
+    int32_t direction;      // +1 to try longer distances next, -1 shorter
+    int32_t count;          // intervals measured at the current distance
+    uint64_t sum;           // total of those intervals
+    uint64_t last_time;     // time of the previous query
+    uint64_t best_cost;     // average interval observed at best_distance
+};
+
+static const int max_prefetch_distance_entries = 64;
+static const int32_t min_prefetch_distance = 1;
+static const int32_t max_prefetch_distance = 256;
+// The number of loop nest entries to average over before taking a step.
+static const int prefetch_calibration_interval = 16;
+
+WEAK halide_mutex prefetch_distance_lock = {{0}};
+WEAK prefetch_distance_entry prefetch_distances[max_prefetch_distance_entries];
+WEAK int num_prefetch_distance_entries = 0;
+
+WEAK bool prefetch_names_equal(const char *a, const char *b) {
+    // The names are string constants in the generated code, so they are
+    // usually the same pointer.
+    if (a == b) {
+        return true;
+    }
+    while (*a && *a == *b) {
+        a++;
+        b++;
+    }
+    return *a == *b;
+}
+
+WEAK int32_t clamp_prefetch_distance(int32_t d) {
+    if (d < min_prefetch_distance) {
+        return min_prefetch_distance;
+    }
+    if (d > max_prefetch_distance) {
+        return max_prefetch_distance;
+    }
+    return d;
+}
+
+}  // namespace Internal
+}  // namespace Runtime
+}  // namespace Halide
+
+using namespace Halide::Runtime::Internal;
 
 extern "C" {
 
@@ -9,4 +67,93 @@ WEAK_INLINE int _halide_prefetch(const void *ptr) {
     __builtin_prefetch(ptr, 1, 3);
     return 0;
 }
+
+// Variants for the other (rw, locality) hint combinations. CodeGen_LLVM
+// picks one by name; _halide_prefetch above is the read-to-L1 default.
+WEAK_INLINE int _halide_prefetch_l2(const void *ptr) {
+    __builtin_prefetch(ptr, 0, 2);
+    return 0;
+}
+
+WEAK_INLINE int _halide_prefetch_nta(const void *ptr) {
+    __builtin_prefetch(ptr, 0, 0);
+    return 0;
+}
+
+WEAK_INLINE int _halide_prefetch_write(const void *ptr) {
+    __builtin_prefetch(ptr, 1, 3);
+    return 0;
+}
+
+WEAK_INLINE int _halide_prefetch_write_l2(const void *ptr) {
+    __builtin_prefetch(ptr, 1, 2);
+    return 0;
+}
+
+WEAK_INLINE int _halide_prefetch_write_nta(const void *ptr) {
+    __builtin_prefetch(ptr, 1, 0);
+    return 0;
+}
+
+WEAK int32_t halide_prefetch_distance(void *user_context, const char *name,
+                                      int32_t initial_distance) {
+    ScopedMutexLock lock(&prefetch_distance_lock);
+
+    prefetch_distance_entry *e = nullptr;
+    for (int i = 0; i < num_prefetch_distance_entries; i++) {
+        if (prefetch_names_equal(prefetch_distances[i].name, name)) {
+            e = &prefetch_distances[i];
+            break;
+        }
+    }
+
+    uint64_t now = (uint64_t)halide_current_time_ns(user_context);
+
+    if (!e) {
+        if (num_prefetch_distance_entries == max_prefetch_distance_entries) {
+            // Too many distinct prefetched buffers to track; just use
+            // the distance from the schedule.
+            return clamp_prefetch_distance(initial_distance);
+        }
+        e = &prefetch_distances[num_prefetch_distance_entries++];
+        e->name = name;
+        e->distance = clamp_prefetch_distance(initial_distance);
+        e->best_distance = e->distance;
+        e->direction = 1;
+        e->count = 0;
+        e->sum = 0;
+        e->best_cost = 0;
+        e->last_time = now;
+        return e->distance;
+    }
+
+    // The time since the last entry to the loop nest is the cost of one
+    // pass over it at the current distance. We have no direct view of
+    // memory stalls from here, so this serves as the feedback signal.
+    e->sum += now - e->last_time;
+    e->last_time = now;
+    e->count++;
+    if (e->count < prefetch_calibration_interval) {
+        return e->distance;
+    }
+
+    // End of an epoch: take a hill-climbing step. Distances are searched
+    // on a log scale, since useful values span orders of magnitude.
+    uint64_t avg = e->sum / e->count;
+    e->sum = 0;
+    e->count = 0;
+    if (e->best_cost == 0 || avg < e->best_cost) {
+        e->best_cost = avg;
+        e->best_distance = e->distance;
+    } else {
+        e->direction = -e->direction;
+    }
+    // Inflate the recorded best slightly so that a stale optimum (say,
+    // after the input size changes) gets re-measured rather than pinning
+    // the distance forever.
+    e->best_cost += e->best_cost >> 4;
+    int32_t next = (e->direction > 0) ? e->best_distance * 2 : e->best_distance / 2;
+    e->distance = clamp_prefetch_distance(next);
+    return e->distance;
+}
 }
@@ -18,6 +18,145 @@ namespace Halide {
 namespace Runtime {
 namespace Internal {
 
+// A run of one func as observed by the sampling thread. begin/end are
+// in the timebase of halide_current_time_ns.
+struct profiler_trace_event {
+    uint64_t begin, end;
+    // Heap bytes live across all pipelines at the end of the span.
+    uint64_t memory;
+    int32_t func_id;
+    int32_t active_threads;
+};
+
+// Heap bytes currently live across all pipelines, so the sampling
+// thread can record a memory timeline without walking the pipeline
+// list. Updated by the memory_allocate/free hooks without a lock,
+// like the per-pipeline counters.
+WEAK uint64_t profiler_memory_current = 0;
+
+// Trace events go into a fixed-size power-of-two ring. The sampling
+// thread is the only writer; it claims a slot by atomically bumping
+// the write index, so recording never takes a lock and the newest
+// events overwrite the oldest if nobody dumps in time.
+static const int profiler_trace_capacity = 1 << 14;
+WEAK profiler_trace_event *profiler_trace_buffer = nullptr;
+WEAK int profiler_trace_write_index = 0;
+WEAK char profiler_trace_path[512] = {0};
+WEAK bool profiler_trace_checked_env = false;
+
+WEAK bool profiler_trace_enabled() {
+    if (!profiler_trace_checked_env) {
+        profiler_trace_checked_env = true;
+        const char *path = getenv("HL_PROFILER_TRACE_FILE");
+        if (path && path[0] && !profiler_trace_path[0]) {
+            halide_profiler_set_chrome_trace_file(path);
+        }
+    }
+    return profiler_trace_path[0] != 0;
+}
+
+// Optional hardware performance-counter sampling, attributed to funcs
+// the same way wall time is: the sampling thread reads the counters on
+// each wakeup and bills the delta to the func that was running. Linux
+// only (perf_event_open); elsewhere the counters just stay zero.
+static const int profiler_num_perf_counters = 3;
+WEAK int profiler_perf_fds[profiler_num_perf_counters] = {-1, -1, -1};
+WEAK bool profiler_perf_open_attempted = false;
+
+#ifdef __linux__
+
+// We can't include linux/perf_event.h in freestanding mode, so
+// declare the little we use of the ABI directly. The attr struct is
+// the 64-byte PERF_ATTR_SIZE_VER0 layout, zero past the flags word.
+struct profiler_perf_event_attr {
+    uint32_t type;  // PERF_TYPE_HARDWARE
+    uint32_t size;
+    uint64_t config;
+    uint64_t sample_period;
+    uint64_t sample_type;
+    uint64_t read_format;
+    uint64_t flags;  // bit 1 = inherit, bit 5 = exclude_kernel, bit 6 = exclude_hv
+    uint32_t wakeup_events;
+    uint32_t bp_type;
+    uint64_t config1;
+};
+
+extern "C" long syscall(long, ...);
+extern "C" int getpid();
+extern "C" ssize_t read(int fd, void *buf, size_t bytes);
+
+#if defined(__x86_64__)
+#define HL_NR_perf_event_open 298
+#elif defined(__i386__)
+#define HL_NR_perf_event_open 336
+#elif defined(__arm__)
+#define HL_NR_perf_event_open 364
+#else
+// aarch64, riscv, and other asm-generic architectures
+#define HL_NR_perf_event_open 241
+#endif
+
+WEAK void profiler_perf_open() {
+    // PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES,
+    // PERF_COUNT_HW_STALLED_CYCLES_BACKEND
+    const uint64_t configs[profiler_num_perf_counters] = {1, 3, 7};
+    for (int i = 0; i < profiler_num_perf_counters; i++) {
+        profiler_perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.type = 0;  // PERF_TYPE_HARDWARE
+        attr.size = sizeof(attr);
+        attr.config = configs[i];
+        attr.flags = (1 << 1) | (1 << 5) | (1 << 6);  // inherit, exclude_kernel, exclude_hv
+        profiler_perf_fds[i] =
+            (int)syscall(HL_NR_perf_event_open, &attr, getpid(), -1, -1, 0);
+    }
+}
+
+WEAK void profiler_perf_read(uint64_t *values) {
+    for (int i = 0; i < profiler_num_perf_counters; i++) {
+        if (profiler_perf_fds[i] < 0 ||
+            read(profiler_perf_fds[i], &values[i], sizeof(uint64_t)) != sizeof(uint64_t)) {
+            values[i] = 0;
+        }
+    }
+}
+
+#else
+
+WEAK void profiler_perf_open() {
+}
+
+WEAK void profiler_perf_read(uint64_t *values) {
+    for (int i = 0; i < profiler_num_perf_counters; i++) {
+        values[i] = 0;
+    }
+}
+
+#endif
+
+WEAK bool profiler_perf_enabled() {
+    return profiler_perf_fds[0] >= 0 ||
+           profiler_perf_fds[1] >= 0 ||
+           profiler_perf_fds[2] >= 0;
+}
+
+WEAK void profiler_trace_record(int func_id, int active_threads, uint64_t begin, uint64_t end) {
+    if (!profiler_trace_buffer) {
+        profiler_trace_buffer =
+            (profiler_trace_event *)malloc(profiler_trace_capacity * sizeof(profiler_trace_event));
+        if (!profiler_trace_buffer) {
+            return;
+        }
+    }
+    int idx = __sync_fetch_and_add(&profiler_trace_write_index, 1);
+    profiler_trace_event *e = profiler_trace_buffer + (idx & (profiler_trace_capacity - 1));
+    e->begin = begin;
+    e->end = end;
+    e->memory = profiler_memory_current;
+    e->func_id = func_id;
+    e->active_threads = active_threads;
+}
+
 WEAK halide_profiler_pipeline_stats *find_or_create_pipeline(const char *pipeline_name, int num_funcs, const uint64_t *func_names) {
     halide_profiler_state *s = halide_profiler_get_state();
 
@@ -64,13 +203,18 @@ WEAK halide_profiler_pipeline_stats *find_or_create_pipeline(const char *pipelin
         p->funcs[i].stack_peak = 0;
         p->funcs[i].active_threads_numerator = 0;
         p->funcs[i].active_threads_denominator = 0;
+        p->funcs[i].instructions = 0;
+        p->funcs[i].cache_misses = 0;
+        p->funcs[i].stalled_cycles = 0;
+        p->funcs[i].memory_at_peak = 0;
     }
     s->first_free_id += num_funcs;
     s->pipelines = p;
     return p;
 }
 
-WEAK void bill_func(halide_profiler_state *s, int func_id, uint64_t time, int active_threads) {
+WEAK void bill_func(halide_profiler_state *s, int func_id, uint64_t time,
+                    int active_threads, const uint64_t *counter_deltas) {
     halide_profiler_pipeline_stats *p_prev = nullptr;
     for (halide_profiler_pipeline_stats *p = s->pipelines; p;
          p = (halide_profiler_pipeline_stats *)(p->next)) {
@@ -83,6 +227,11 @@ WEAK void bill_func(halide_profiler_state *s, int func_id, uint64_t time, int ac
             }
             halide_profiler_func_stats *f = p->funcs + func_id - p->first_func_id;
             f->time += time;
+            if (counter_deltas) {
+                f->instructions += counter_deltas[0];
+                f->cache_misses += counter_deltas[1];
+                f->stalled_cycles += counter_deltas[2];
+            }
             f->active_threads_numerator += active_threads;
             f->active_threads_denominator += 1;
             p->time += time;
@@ -106,6 +255,14 @@ WEAK void sampling_profiler_thread(void *) {
 
         uint64_t t1 = halide_current_time_ns(nullptr);
         uint64_t t = t1;
+        int prev_func = halide_profiler_outside_of_halide;
+        uint64_t span_begin = t1;
+        uint64_t counters[profiler_num_perf_counters];
+        uint64_t counter_deltas[profiler_num_perf_counters];
+        const bool perf = profiler_perf_enabled();
+        if (perf) {
+            profiler_perf_read(counters);
+        }
         while (true) {
             int func, active_threads;
             if (s->get_remote_profiler_state) {
@@ -117,12 +274,31 @@ WEAK void sampling_profiler_thread(void *) {
                 active_threads = s->active_threads;
             }
             uint64_t t_now = halide_current_time_ns(nullptr);
+            if (perf) {
+                uint64_t now[profiler_num_perf_counters];
+                profiler_perf_read(now);
+                for (int i = 0; i < profiler_num_perf_counters; i++) {
+                    counter_deltas[i] = now[i] - counters[i];
+                    counters[i] = now[i];
+                }
+            }
+            if (func != prev_func && profiler_trace_enabled()) {
+                // The current func changed since the last sample, so
+                // the previous func's span (at sampling resolution)
+                // just ended.
+                if (prev_func >= 0) {
+                    profiler_trace_record(prev_func, active_threads, span_begin, t_now);
+                }
+                prev_func = func;
+                span_begin = t_now;
+            }
             if (func == halide_profiler_please_stop) {
                 break;
             } else if (func >= 0) {
                 // Assume all time since I was last awake is due to
                 // the currently running func.
-                bill_func(s, func, t_now - t, active_threads);
+                bill_func(s, func, t_now - t, active_threads,
+                          perf ? counter_deltas : nullptr);
             }
             t = t_now;
 
@@ -184,6 +360,19 @@ WEAK int halide_profiler_pipeline_start(void *user_context,
 
     ScopedMutexLock lock(&s->lock);
 
+    if (!profiler_perf_open_attempted) {
+        profiler_perf_open_attempted = true;
+        const char *perf = getenv("HL_PROFILER_PERF_EVENTS");
+        if (perf && perf[0]) {
+            // Opened on the thread launching the pipeline, with
+            // inherit set, so threads spawned from here on are
+            // counted too. Threads that already exist (e.g. an
+            // already-warm thread pool) are not; the counters are a
+            // sampled estimate, like the wall times.
+            profiler_perf_open();
+        }
+    }
+
     if (!s->sampling_thread) {
         halide_start_clock(user_context);
         s->sampling_thread = halide_spawn_thread(sampling_profiler_thread, nullptr);
@@ -243,12 +432,26 @@ WEAK void halide_profiler_memory_allocate(void *user_context,
     // current desctructor (called on profiler shutdown) does not free the structs
     // unless user specifically calls halide_profiler_reset().
 
+    __sync_add_and_fetch(&profiler_memory_current, incr);
+
     // Update per-pipeline memory stats
     __sync_add_and_fetch(&p_stats->num_allocs, 1);
     __sync_add_and_fetch(&p_stats->memory_total, incr);
     uint64_t p_mem_current = __sync_add_and_fetch(&p_stats->memory_current, incr);
     sync_compare_max_and_swap(&p_stats->memory_peak, p_mem_current);
 
+    if (p_mem_current == p_stats->memory_peak) {
+        // This allocation set a new pipeline-wide high-water mark.
+        // Snapshot what every func was holding, so the report can say
+        // which allocations coexisted to produce the peak. Racy in the
+        // same benign way as the counters above: a concurrent
+        // allocation may smear the snapshot slightly, but the totals
+        // remain within one allocation of the truth.
+        for (int i = 0; i < p_stats->num_funcs; i++) {
+            p_stats->funcs[i].memory_at_peak = p_stats->funcs[i].memory_current;
+        }
+    }
+
     // Update per-func memory stats
     __sync_add_and_fetch(&f_stats->num_allocs, 1);
     __sync_add_and_fetch(&f_stats->memory_total, incr);
@@ -279,6 +482,8 @@ WEAK void halide_profiler_memory_free(void *user_context,
     // current destructor (called on profiler shutdown) does not free the structs
     // unless user specifically calls halide_profiler_reset().
 
+    __sync_sub_and_fetch(&profiler_memory_current, decr);
+
     // Update per-pipeline memory stats
     __sync_sub_and_fetch(&p_stats->memory_current, decr);
 
@@ -316,6 +521,27 @@ WEAK void halide_profiler_report_unlocked(void *user_context, halide_profiler_st
              << "  peak heap usage: " << p->memory_peak << " bytes\n";
         halide_print(user_context, sstr.str());
 
+        // Which funcs' allocations coexisted at the moment of the
+        // peak. This is what explains the high-water mark: shrinking
+        // or rescheduling a func that isn't on this list won't move it.
+        bool any_at_peak = false;
+        for (int i = 0; i < p->num_funcs; i++) {
+            any_at_peak |= p->funcs[i].memory_at_peak != 0;
+        }
+        if (any_at_peak) {
+            sstr.clear();
+            sstr << " allocations live at the heap peak:\n";
+            halide_print(user_context, sstr.str());
+            for (int i = 0; i < p->num_funcs; i++) {
+                halide_profiler_func_stats *fs = p->funcs + i;
+                if (fs->memory_at_peak) {
+                    sstr.clear();
+                    sstr << "  " << fs->name << ": " << fs->memory_at_peak << " bytes\n";
+                    halide_print(user_context, sstr.str());
+                }
+            }
+        }
+
         bool print_f_states = p->time || p->memory_total;
         if (!print_f_states) {
             for (int i = 0; i < p->num_funcs; i++) {
@@ -396,6 +622,12 @@ WEAK void halide_profiler_report_unlocked(void *user_context, halide_profiler_st
                 if (fs->stack_peak > 0) {
                     sstr << " stack: " << fs->stack_peak;
                 }
+                if (fs->instructions || fs->cache_misses || fs->stalled_cycles) {
+                    // Per-run averages, like the times above.
+                    sstr << " inst: " << fs->instructions / p->runs
+                         << " cache-misses: " << fs->cache_misses / p->runs
+                         << " stalled-cycles: " << fs->stalled_cycles / p->runs;
+                }
                 sstr << "\n";
 
                 halide_print(user_context, sstr.str());
@@ -410,6 +642,129 @@ WEAK void halide_profiler_report(void *user_context) {
     halide_profiler_report_unlocked(user_context, s);
 }
 
+WEAK void halide_profiler_set_chrome_trace_file(const char *path) {
+    size_t i = 0;
+    if (path) {
+        for (; path[i] && i < sizeof(profiler_trace_path) - 1; i++) {
+            profiler_trace_path[i] = path[i];
+        }
+    }
+    profiler_trace_path[i] = 0;
+}
+
+WEAK void halide_profiler_chrome_trace_dump_unlocked(void *user_context, halide_profiler_state *s) {
+    if (!profiler_trace_enabled() || !profiler_trace_buffer) {
+        return;
+    }
+    void *file = fopen(profiler_trace_path, "w");
+    if (!file) {
+        error(user_context) << "Failed to open profiler trace file " << profiler_trace_path;
+        return;
+    }
+
+    char line_buf[1024];
+    Printer<StringStreamPrinter, sizeof(line_buf)> sstr(user_context, line_buf);
+
+    const char *header = "{\"traceEvents\":[\n";
+    fwrite(header, 1, strlen(header), file);
+
+    // If the ring wrapped, the oldest capacity's worth of events is
+    // all that's left.
+    int end_idx = profiler_trace_write_index;
+    int begin_idx = end_idx - profiler_trace_capacity;
+    if (begin_idx < 0) {
+        begin_idx = 0;
+    }
+    for (int i = begin_idx; i < end_idx; i++) {
+        const profiler_trace_event *e =
+            profiler_trace_buffer + (i & (profiler_trace_capacity - 1));
+
+        // Map the func id back to its func and pipeline. Pipelines
+        // are only freed by an explicit reset, so the stats structs
+        // are still alive here.
+        const char *name = "<overhead>";
+        int pid = 0;
+        for (halide_profiler_pipeline_stats *p = s->pipelines; p;
+             p = (halide_profiler_pipeline_stats *)(p->next)) {
+            if (e->func_id >= p->first_func_id &&
+                e->func_id < p->first_func_id + p->num_funcs) {
+                name = p->funcs[e->func_id - p->first_func_id].name;
+                pid = p->first_func_id;
+                break;
+            }
+        }
+
+        sstr.clear();
+        if (i > begin_idx) {
+            sstr << ",\n";
+        }
+        // Chrome wants timestamps and durations in microseconds.
+        uint64_t ts = e->begin / 1000;
+        uint64_t dur = (e->end - e->begin) / 1000;
+        sstr << "{\"name\":\"" << name << "\",\"ph\":\"X\""
+             << ",\"pid\":" << pid << ",\"tid\":0"
+             << ",\"ts\":" << ts << ",\"dur\":" << dur
+             << ",\"args\":{\"func_id\":" << e->func_id
+             << ",\"active_threads\":" << e->active_threads << "}},\n";
+        // A counter event alongside each span gives a heap-usage
+        // timeline correlated with the func that was running.
+        sstr << "{\"name\":\"heap bytes\",\"ph\":\"C\""
+             << ",\"pid\":" << pid << ",\"ts\":" << ts
+             << ",\"args\":{\"bytes\":" << e->memory << "}}";
+        fwrite(sstr.str(), 1, sstr.size(), file);
+    }
+
+    const char *footer = "\n]}\n";
+    fwrite(footer, 1, strlen(footer), file);
+    fclose(file);
+}
+
+WEAK void halide_profiler_chrome_trace_dump(void *user_context) {
+    halide_profiler_state *s = halide_profiler_get_state();
+    ScopedMutexLock lock(&s->lock);
+    halide_profiler_chrome_trace_dump_unlocked(user_context, s);
+}
+
+WEAK void halide_profiler_export(void *user_context, const char *path) {
+    halide_profiler_state *s = halide_profiler_get_state();
+    ScopedMutexLock lock(&s->lock);
+
+    void *file = fopen(path, "w");
+    if (!file) {
+        error(user_context) << "Failed to open profile export file " << path;
+        return;
+    }
+
+    char line_buf[1024];
+    Printer<StringStreamPrinter, sizeof(line_buf)> sstr(user_context, line_buf);
+
+    const char *header = "halide_profile 1\n";
+    fwrite(header, 1, strlen(header), file);
+
+    for (halide_profiler_pipeline_stats *p = s->pipelines; p;
+         p = (halide_profiler_pipeline_stats *)(p->next)) {
+        if (!p->runs) {
+            continue;
+        }
+        sstr.clear();
+        sstr << "pipeline " << p->runs << " " << p->name << "\n";
+        fwrite(sstr.str(), 1, sstr.size(), file);
+        for (int i = 0; i < p->num_funcs; i++) {
+            halide_profiler_func_stats *fs = p->funcs + i;
+            // Funcs the sampler never caught running have no
+            // measurement; consumers treat absent funcs as
+            // unmeasured rather than as taking zero time.
+            if (fs->time == 0) {
+                continue;
+            }
+            sstr.clear();
+            sstr << "func " << fs->time << " " << fs->name << "\n";
+            fwrite(sstr.str(), 1, sstr.size(), file);
+        }
+    }
+    fclose(file);
+}
+
 WEAK void halide_profiler_reset_unlocked(halide_profiler_state *s) {
     while (s->pipelines) {
         halide_profiler_pipeline_stats *p = s->pipelines;
@@ -448,6 +803,7 @@ halide_profiler_shutdown() {
     // Print results. No need to lock anything because we just shut
     // down the thread.
     halide_profiler_report_unlocked(nullptr, s);
+    halide_profiler_chrome_trace_dump_unlocked(nullptr, s);
 
     halide_profiler_reset_unlocked(s);
 }
@@ -470,6 +826,7 @@ WEAK void halide_windows_profiler_shutdown() {
     // Print results. Avoid locking as it will cause problems and
     // nothing should be running.
     halide_profiler_report_unlocked(nullptr, s);
+    halide_profiler_chrome_trace_dump_unlocked(nullptr, s);
 }
 #endif
 }  // namespace
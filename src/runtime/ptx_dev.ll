@@ -1,4 +1,6 @@
 declare void @llvm.nvvm.barrier0()
+declare void @llvm.nvvm.barrier.sync(i32)
+declare void @llvm.nvvm.barrier.sync.cnt(i32, i32)
 declare  i32 @llvm.nvvm.read.ptx.sreg.tid.x()
 declare  i32 @llvm.nvvm.read.ptx.sreg.ctaid.x()
 declare  i32 @llvm.nvvm.read.ptx.sreg.ntid.x()
@@ -21,6 +23,18 @@ declare  i32 @llvm.nvvm.read.ptx.sreg.warpsize()
 declare float @llvm.nvvm.atomic.load.add.f32.p0f32(float*, float)
 declare double @llvm.nvvm.atomic.load.add.f64.p0f64(double *, double)
 
+; Tensor core operations on 16x16x16 tiles of half-precision operands
+; with a float or half accumulator, in row-major layout. Emitted by
+; CodeGen_PTX_Dev for loop nests scheduled with gpu_tensor_core.
+declare {<2 x half>, <2 x half>, <2 x half>, <2 x half>, <2 x half>, <2 x half>, <2 x half>, <2 x half>} @llvm.nvvm.wmma.m16n16k16.load.a.row.stride.f16.p0i8(i8*, i32)
+declare {<2 x half>, <2 x half>, <2 x half>, <2 x half>, <2 x half>, <2 x half>, <2 x half>, <2 x half>} @llvm.nvvm.wmma.m16n16k16.load.b.row.stride.f16.p0i8(i8*, i32)
+declare {float, float, float, float, float, float, float, float} @llvm.nvvm.wmma.m16n16k16.load.c.row.stride.f32.p0i8(i8*, i32)
+declare {<2 x half>, <2 x half>, <2 x half>, <2 x half>} @llvm.nvvm.wmma.m16n16k16.load.c.row.stride.f16.p0i8(i8*, i32)
+declare {float, float, float, float, float, float, float, float} @llvm.nvvm.wmma.m16n16k16.mma.row.row.f32.f32(<2 x half>, <2 x half>, <2 x half>, <2 x half>, <2 x half>, <2 x half>, <2 x half>, <2 x half>, <2 x half>, <2 x half>, <2 x half>, <2 x half>, <2 x half>, <2 x half>, <2 x half>, <2 x half>, float, float, float, float, float, float, float, float)
+declare {<2 x half>, <2 x half>, <2 x half>, <2 x half>} @llvm.nvvm.wmma.m16n16k16.mma.row.row.f16.f16(<2 x half>, <2 x half>, <2 x half>, <2 x half>, <2 x half>, <2 x half>, <2 x half>, <2 x half>, <2 x half>, <2 x half>, <2 x half>, <2 x half>, <2 x half>, <2 x half>, <2 x half>, <2 x half>, <2 x half>, <2 x half>, <2 x half>, <2 x half>)
+declare void @llvm.nvvm.wmma.m16n16k16.store.d.row.stride.f32.p0i8(i8*, float, float, float, float, float, float, float, float, i32)
+declare void @llvm.nvvm.wmma.m16n16k16.store.d.row.stride.f16.p0i8(i8*, <2 x half>, <2 x half>, <2 x half>, <2 x half>, i32)
+
 ; Legacy - to replace
 ;declare void @llvm.ptx.red.global.add.s32(i32*, i32)
 ;declare void @llvm.ptx.red.global.add.f32(float*, float)
@@ -20,8 +20,13 @@
 
 extern "C" __attribute__((used)) void *halide_runtime_api_functions[] = {
     (void *)&halide_buffer_copy,
+    (void *)&halide_buffer_prefault,
     (void *)&halide_buffer_to_string,
     (void *)&halide_can_use_target_features,
+    (void *)&halide_cancel,
+    (void *)&halide_deadline_progress,
+    (void *)&halide_cancellation_token_cancelled,
+    (void *)&halide_cancellation_token_init,
     (void *)&halide_cond_broadcast,
     (void *)&halide_cond_signal,
     (void *)&halide_cond_wait,
@@ -29,10 +34,19 @@ extern "C" __attribute__((used)) void *halide_runtime_api_functions[] = {
     (void *)&halide_copy_to_host,
     (void *)&halide_cuda_detach_device_ptr,
     (void *)&halide_cuda_device_interface,
+    (void *)&halide_cuda_enable_async_allocations,
+    (void *)&halide_cuda_enable_pinned_host_allocations,
+    (void *)&halide_cuda_enable_stream_pool,
     (void *)&halide_cuda_get_device_ptr,
+    (void *)&halide_cuda_graph_capture_begin,
+    (void *)&halide_cuda_graph_capture_end,
+    (void *)&halide_cuda_graph_destroy,
+    (void *)&halide_cuda_graph_launch,
     (void *)&halide_cuda_initialize_kernels,
     (void *)&halide_cuda_finalize_kernels,
+    (void *)&halide_cuda_occupancy_block_size,
     (void *)&halide_cuda_run,
+    (void *)&halide_cuda_set_device_for_user_context,
     (void *)&halide_cuda_wrap_device_ptr,
     (void *)&halide_current_time_ns,
     (void *)&halide_debug_to_file,
@@ -71,6 +85,7 @@ extern "C" __attribute__((used)) void *halide_runtime_api_functions[] = {
     (void *)&halide_error_fold_factor_too_small,
     (void *)&halide_error_host_is_null,
     (void *)&halide_error_out_of_memory,
+    (void *)&halide_error_pipeline_cancelled,
     (void *)&halide_error_param_too_large_f64,
     (void *)&halide_error_param_too_large_i64,
     (void *)&halide_error_param_too_large_u64,
@@ -101,8 +116,10 @@ extern "C" __attribute__((used)) void *halide_runtime_api_functions[] = {
     (void *)&halide_hexagon_run,
     (void *)&halide_hexagon_set_performance,
     (void *)&halide_hexagon_set_performance_mode,
+    (void *)&halide_hexagon_set_rpc_queue_depth,
     (void *)&halide_hexagon_set_thread_priority,
     (void *)&halide_hexagon_wrap_device_handle,
+    (void *)&halide_host_cpu_count,
     (void *)&halide_int64_to_string,
     (void *)&halide_join_thread,
     (void *)&halide_load_library,
@@ -112,6 +129,9 @@ extern "C" __attribute__((used)) void *halide_runtime_api_functions[] = {
     (void *)&halide_memoization_cache_evict,
     (void *)&halide_memoization_cache_lookup,
     (void *)&halide_memoization_cache_release,
+    (void *)&halide_memoization_cache_set_dir,
+    (void *)&halide_memoization_cache_set_disk_size,
+    (void *)&halide_memoization_cache_set_shards,
     (void *)&halide_memoization_cache_set_size,
     (void *)&halide_memoization_cache_store,
     (void *)&halide_metal_acquire_context,
@@ -137,6 +157,7 @@ extern "C" __attribute__((used)) void *halide_runtime_api_functions[] = {
     (void *)&halide_mutex_array_unlock,
     (void *)&halide_opencl_detach_cl_mem,
     (void *)&halide_opencl_device_interface,
+    (void *)&halide_opencl_enable_host_shared_allocations,
     (void *)&halide_opencl_get_cl_mem,
     (void *)&halide_opencl_get_build_options,
     (void *)&halide_opencl_get_device_type,
@@ -157,14 +178,20 @@ extern "C" __attribute__((used)) void *halide_runtime_api_functions[] = {
     (void *)&halide_openglcompute_initialize_kernels,
     (void *)&halide_openglcompute_finalize_kernels,
     (void *)&halide_openglcompute_run,
+    (void *)&halide_persistent_state_acquire,
+    (void *)&halide_persistent_state_clear,
+    (void *)&halide_persistent_state_store,
     (void *)&halide_pointer_to_string,
     (void *)&halide_print,
+    (void *)&halide_profiler_chrome_trace_dump,
+    (void *)&halide_profiler_export,
     (void *)&halide_profiler_get_pipeline_state,
     (void *)&halide_profiler_get_state,
     (void *)&halide_profiler_memory_allocate,
     (void *)&halide_profiler_memory_free,
     (void *)&halide_profiler_pipeline_start,
     (void *)&halide_profiler_report,
+    (void *)&halide_profiler_set_chrome_trace_file,
     (void *)&halide_profiler_reset,
     (void *)&halide_profiler_stack_peak_update,
     (void *)&halide_qurt_hvx_lock,
@@ -180,21 +207,34 @@ extern "C" __attribute__((used)) void *halide_runtime_api_functions[] = {
     (void *)&halide_set_custom_do_task,
     (void *)&halide_set_custom_free,
     (void *)&halide_set_custom_get_library_symbol,
+    (void *)&halide_set_cancellation_token,
+    (void *)&halide_set_deadline,
     (void *)&halide_set_custom_get_symbol,
     (void *)&halide_set_custom_load_library,
     (void *)&halide_set_custom_malloc,
     (void *)&halide_set_custom_print,
     (void *)&halide_set_custom_trace,
+    (void *)&halide_set_telemetry_report,
+    (void *)&halide_set_default_task_priority,
     (void *)&halide_set_error_handler,
+    (void *)&halide_set_host_allocation_cache_size,
     (void *)&halide_set_gpu_device,
+    (void *)&halide_set_adaptive_parallelism,
     (void *)&halide_set_num_threads,
+    (void *)&halide_set_parallel_inline_threshold,
+    (void *)&halide_set_thread_affinity_policy,
     (void *)&halide_set_trace_file,
+    (void *)&halide_set_work_stealing,
     (void *)&halide_shutdown_thread_pool,
     (void *)&halide_shutdown_trace,
     (void *)&halide_sleep_ms,
     (void *)&halide_spawn_thread,
     (void *)&halide_start_clock,
     (void *)&halide_string_to_string,
+    (void *)&halide_telemetry_pipeline_end,
+    (void *)&halide_telemetry_pipeline_start,
+    (void *)&halide_telemetry_track_allocation,
+    (void *)&halide_telemetry_track_free,
     (void *)&halide_trace,
     (void *)&halide_trace_helper,
     (void *)&halide_uint64_to_string,
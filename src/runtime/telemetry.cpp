@@ -0,0 +1,67 @@
+#include "HalideRuntime.h"
+
+// Lightweight always-on alternative to the profiler: one timestamp
+// pair per pipeline invocation plus a heap high-water mark, delivered
+// to a registered callback. Designed to be cheap enough to leave
+// enabled in production; there is no sampling thread and the
+// per-invocation overhead is a couple of counter updates.
+
+namespace Halide {
+namespace Runtime {
+namespace Internal {
+
+WEAK halide_telemetry_report_t custom_telemetry_report = nullptr;
+
+// The heap counters are shared across pipelines, so concurrent
+// invocations observe each other's allocations. That keeps the track
+// calls to a single atomic op, and the high-water mark is still an
+// upper bound on any one pipeline's footprint.
+WEAK uint64_t telemetry_current_bytes = 0;
+WEAK uint64_t telemetry_peak_bytes = 0;
+
+}  // namespace Internal
+}  // namespace Runtime
+}  // namespace Halide
+
+extern "C" {
+
+WEAK halide_telemetry_report_t halide_set_telemetry_report(halide_telemetry_report_t report) {
+    halide_telemetry_report_t result = custom_telemetry_report;
+    custom_telemetry_report = report;
+    return result;
+}
+
+WEAK int halide_telemetry_track_allocation(uint64_t bytes) {
+    uint64_t current = __sync_add_and_fetch(&telemetry_current_bytes, bytes);
+    uint64_t peak = telemetry_peak_bytes;
+    while (current > peak &&
+           !__sync_bool_compare_and_swap(&telemetry_peak_bytes, peak, current)) {
+        peak = telemetry_peak_bytes;
+    }
+    return 0;
+}
+
+WEAK int halide_telemetry_track_free(uint64_t bytes) {
+    __sync_sub_and_fetch(&telemetry_current_bytes, bytes);
+    return 0;
+}
+
+WEAK int64_t halide_telemetry_pipeline_start() {
+    // Restart the high-water mark from whatever is currently live, so
+    // an earlier large invocation doesn't mask this one.
+    telemetry_peak_bytes = telemetry_current_bytes;
+    return halide_current_time_ns(nullptr);
+}
+
+WEAK int halide_telemetry_pipeline_end(const char *pipeline_name, int64_t start_time_ns) {
+    halide_telemetry_report_t report = custom_telemetry_report;
+    if (report) {
+        halide_telemetry_record record;
+        record.pipeline_name = pipeline_name;
+        record.wall_time_ns = (uint64_t)(halide_current_time_ns(nullptr) - start_time_ns);
+        record.peak_heap_bytes = telemetry_peak_bytes;
+        report(nullptr, &record);
+    }
+    return 0;
+}
+}
@@ -36,6 +36,23 @@ struct work {
     work *parent_job;
     int threads_reserved;
 
+    // Scheduling priority. Higher values are preferred by idle
+    // workers. Top-level jobs snapshot the work queue's default when
+    // enqueued; nested jobs inherit from their parent so an entire
+    // pipeline invocation runs at one priority.
+    int priority;
+
+    // The cancellation token registered for this job's user context
+    // when it was enqueued, or nullptr. Polled each time a task is
+    // claimed; nested jobs inherit their parent's token.
+    halide_cancellation_token_t *cancellation_token;
+
+    // Cap on how many workers may be active on this job at once, or
+    // zero for no cap. Set by the adaptive parallelism controller on
+    // top-level jobs and inherited by nested jobs that promise not to
+    // block. See halide_set_adaptive_parallelism.
+    int max_workers;
+
     void *user_context;
     int active_workers;
     int exit_status;
@@ -65,6 +82,74 @@ struct work {
 };
 
 #define MAX_THREADS 256
+#define MAX_CANCELLATION_TOKENS 16
+#define MAX_ADAPTIVE_PIPELINES 16
+
+// The layout behind the opaque halide_cancellation_token_t. Must fit
+// in its _private storage. All fields are accessed atomically so
+// tokens can be polled, cancelled, and expired without taking the
+// work queue mutex.
+struct cancellation_token_impl_t {
+    // Nonzero once the token has been cancelled.
+    int32_t cancelled;
+    // Guards reporting halide_error_pipeline_cancelled exactly once
+    // per cancellation.
+    int32_t error_reported;
+    // Absolute halide_current_time_ns after which polling the token
+    // cancels it, or zero if no deadline is armed.
+    int64_t deadline_ns;
+    // Nonzero once first_skipped below holds a value.
+    int32_t skip_recorded;
+    // The lowest parallel-loop iteration skipped because of a
+    // cancellation. Iterations are claimed in order, and running ones
+    // finish, so everything below this completed.
+    int32_t first_skipped;
+};
+
+// When work stealing is enabled, a worker claiming iterations of a
+// data-parallel job takes a contiguous chunk at a time and publishes it
+// in a per-thread slot. The chunk owner and idle workers then claim
+// individual iterations from the slot with atomic operations, so the
+// shared work queue lock is only taken when every slot is empty. This
+// is in the spirit of a Chase-Lev deque, but because the stealable work
+// is a dense iteration range we can get away with a single atomic
+// countdown instead of a ring buffer.
+struct work_stealing_slot {
+    // The job the published iterations belong to. Only passed through
+    // as the task_parent for loop tasks; thieves never dereference the
+    // job itself.
+    work *job;
+    // Copies of the fields of the job a thief needs to run one
+    // iteration. Stable from when remaining is published until the
+    // chunk completes.
+    halide_task_t task_fn;
+    halide_loop_task_t loop_task_fn;
+    void *user_context;
+    uint8_t *closure;
+    // First iteration of the published chunk.
+    int min;
+    // Number of iterations in the chunk.
+    int extent;
+    // Number of not-yet-claimed iterations. Claimed via
+    // compare-and-swap by owner and thieves alike, one at a time or,
+    // in guided mode, a batch at a time. A successful swap from r to
+    // r - k claims the k iterations starting at min + extent - r.
+    // Publishing a chunk only happens when this is zero, and the store
+    // that publishes it is the release that makes the fields above
+    // visible to thieves.
+    int remaining;
+    // Number of claimed iterations that have finished running. The
+    // chunk is complete when this reaches extent.
+    int completed;
+    // Sticky nonzero exit status of any iteration in the chunk.
+    int chunk_exit_status;
+    // The cancellation token of the job the chunk came from, polled
+    // before running each iteration.
+    halide_cancellation_token_t *cancellation_token;
+    // Whether some worker currently owns this slot. Protected by the
+    // work queue mutex.
+    bool owner_active;
+};
 
 WEAK int clamp_num_threads(int threads) {
     if (threads > MAX_THREADS) {
@@ -90,6 +175,31 @@ WEAK int default_desired_num_threads() {
     return desired_num_threads;
 }
 
+// Hill-climbing state for the adaptive parallelism controller, one
+// entry per distinct top-level parallel loop (identified by its task
+// function pointer, which is stable for the life of the process).
+// Memory-bound pipelines often peak well below the machine's core
+// count, so the controller measures per-invocation throughput at the
+// current worker cap, occasionally probes a neighboring cap, and
+// moves when the probe wins by a clear margin. Comparisons assume
+// successive invocations of the same loop do similar per-iteration
+// work, which holds when a pipeline is run repeatedly on same-sized
+// inputs; the occasional mis-attributed probe just costs one probe
+// cycle. All fields are protected by the work queue mutex.
+struct adaptive_parallelism_state {
+    // The task function of the loop this entry belongs to, or nullptr
+    // if the entry is free.
+    halide_task_t fn;
+    // The believed-best worker cap, and the direction (+1 or -1) the
+    // next probe should try.
+    int cap;
+    int direction;
+    // Invocations left before the next probe.
+    int countdown;
+    // Exponential moving average of iterations per second at cap.
+    int64_t best_rate;
+};
+
 // The work queue and thread pool is weak, so one big work queue is shared by all halide functions
 struct work_queue_t {
     // all fields are protected by this mutex.
@@ -98,6 +208,42 @@ struct work_queue_t {
     // The desired number threads doing work (HL_NUM_THREADS).
     int desired_threads_working;
 
+    // Whether workers should claim chunks of data-parallel iterations
+    // and balance them via the work stealing slots below, instead of
+    // claiming one iteration per acquisition of the mutex. One of the
+    // halide_work_stealing_mode_t values; in guided mode thieves take
+    // half of a chunk's remaining iterations at a time instead of one.
+    // See halide_set_work_stealing.
+    int use_work_stealing;
+
+    // Whether the pool should measure pipeline throughput and adapt
+    // the number of workers given to each top-level parallel loop.
+    // See halide_set_adaptive_parallelism.
+    int use_adaptive_parallelism;
+
+    // How workers should be pinned to cpus when they are spawned. One
+    // of the halide_thread_affinity_policy_t values. See
+    // halide_set_thread_affinity_policy.
+    int thread_affinity_policy;
+
+    // The priority assigned to top-level jobs as they are enqueued.
+    // See halide_set_default_task_priority.
+    int default_task_priority;
+
+    // Associations between user context pointers and cancellation
+    // tokens, established by halide_set_cancellation_token. Top-level
+    // jobs look up the token for their user context here when
+    // enqueued. An entry is live when its token is non-null.
+    struct {
+        void *user_context;
+        halide_cancellation_token_t *token;
+    } cancellation_tokens[MAX_CANCELLATION_TOKENS];
+
+    // Controller state for adaptive parallelism, live while fn is
+    // non-null. Kept across thread pool shutdowns, like the settings
+    // above.
+    adaptive_parallelism_state adaptive_states[MAX_ADAPTIVE_PIPELINES];
+
     // All fields after this must be zero in the initial state. See assert_zeroed
     // Field serves both to mark the offset in struct and as layout padding.
     int zero_marker;
@@ -108,6 +254,10 @@ struct work_queue_t {
     // The number threads created
     int threads_created;
 
+    // The number of worker threads that have started running, used to
+    // hand each one an id for affinity purposes.
+    int workers_started;
+
     // Workers sleep on one of two condition variables, to make it
     // easier to wake up the right number if a small number of tasks
     // are enqueued. There are A-team workers and B-team workers. The
@@ -128,6 +278,15 @@ struct work_queue_t {
     // Keep track of threads so they can be joined at shutdown
     halide_thread *threads[MAX_THREADS];
 
+    // Per-thread slots holding published chunks of data-parallel
+    // iterations, for work stealing. Only the fields documented as
+    // atomic are touched without the mutex held.
+    work_stealing_slot steal_slots[MAX_THREADS];
+
+    // One past the highest slot index ever handed out, so thieves
+    // don't have to scan all MAX_THREADS slots.
+    int steal_slots_high_water;
+
     // Global flags indicating the threadpool should shut down, and
     // whether the thread pool has been initialized.
     bool shutdown, initialized;
@@ -165,6 +324,10 @@ struct work_queue_t {
 
 WEAK work_queue_t work_queue = {};
 
+// Parallel loops with at most this many iterations run on the
+// calling thread rather than going through the work queue.
+WEAK int parallel_inline_threshold = 1;
+
 #if EXTENDED_DEBUG
 WEAK void print_job(work *job, const char *indent, const char *prefix = nullptr) {
     if (prefix == nullptr) {
@@ -172,7 +335,7 @@ WEAK void print_job(work *job, const char *indent, const char *prefix = nullptr)
     }
     const char *name = job->task.name ? job->task.name : "<no name>";
     const char *parent_name = job->parent_job ? (job->parent_job->task.name ? job->parent_job->task.name : "<no name>") : "<no parent job>";
-    log_message(prefix << name << "[" << job << "] serial: " << job->task.serial << " active_workers: " << job->active_workers << " min: " << job->task.min << " extent: " << job->task.extent << " siblings: " << job->siblings << " sibling count: " << job->sibling_count << " min_threads " << job->task.min_threads << " next_sempaphore: " << job->next_semaphore << " threads_reserved: " << job->threads_reserved << " parent_job: " << parent_name << "[" << job->parent_job << "]");
+    log_message(prefix << name << "[" << job << "] serial: " << job->task.serial << " active_workers: " << job->active_workers << " min: " << job->task.min << " extent: " << job->task.extent << " siblings: " << job->siblings << " sibling count: " << job->sibling_count << " min_threads " << job->task.min_threads << " next_sempaphore: " << job->next_semaphore << " threads_reserved: " << job->threads_reserved << " priority: " << job->priority << " parent_job: " << parent_name << "[" << job->parent_job << "]");
     for (int i = 0; i < job->task.num_semaphores; i++) {
         log_message(indent << "    semaphore " << (void *)job->task.semaphores[i].semaphore << " count " << job->task.semaphores[i].count << " val " << *(int *)job->task.semaphores[i].semaphore);
     }
@@ -194,10 +357,279 @@ WEAK void dump_job_state() {
 
 WEAK void worker_thread(void *);
 
+// Quick check of a (possibly null) cancellation token. Does not
+// require the work queue lock.
+WEAK bool token_is_cancelled(halide_cancellation_token_t *token) {
+    if (token == nullptr) {
+        return false;
+    }
+    cancellation_token_impl_t *t = (cancellation_token_impl_t *)token;
+    int32_t cancelled;
+    Synchronization::atomic_load_acquire(&t->cancelled, &cancelled);
+    if (cancelled != 0) {
+        return true;
+    }
+    // An armed deadline cancels the token the first time it is polled
+    // past the deadline. Only polls notice, so an invocation with no
+    // runnable parallel tasks does not time out. May be called with
+    // or without the work queue lock held, so no broadcasts here; the
+    // polling worker is awake and drains the job itself.
+    int64_t deadline;
+    Synchronization::atomic_load_acquire(&t->deadline_ns, &deadline);
+    if (deadline != 0 && (int64_t)halide_current_time_ns(nullptr) > deadline) {
+        int32_t one = 1;
+        Synchronization::atomic_store_release(&t->cancelled, &one);
+        return true;
+    }
+    return false;
+}
+
+// Produce the exit status for a task skipped because its token was
+// cancelled, reporting halide_error_pipeline_cancelled on the first
+// call per cancellation. Must be called without the work queue lock
+// held, as the error handler is user code.
+WEAK int cancelled_status(halide_cancellation_token_t *token, void *user_context) {
+    cancellation_token_impl_t *t = (cancellation_token_impl_t *)token;
+    int32_t one = 1;
+    if (Synchronization::atomic_fetch_add_acquire_release(&t->error_reported, one) == 0) {
+        return halide_error_pipeline_cancelled(user_context);
+    }
+    return halide_error_code_pipeline_cancelled;
+}
+
+// Record an iteration skipped due to cancellation, keeping the
+// minimum across workers. Does not require the work queue lock.
+WEAK void record_skipped_iteration(halide_cancellation_token_t *token, int32_t idx) {
+    if (token == nullptr) {
+        return;
+    }
+    cancellation_token_impl_t *t = (cancellation_token_impl_t *)token;
+    int32_t cur, recorded;
+    Synchronization::atomic_load_acquire(&t->first_skipped, &cur);
+    Synchronization::atomic_load_acquire(&t->skip_recorded, &recorded);
+    while (!recorded || idx < cur) {
+        if (Synchronization::atomic_cas_weak_relacq_relaxed(&t->first_skipped, &cur, &idx)) {
+            int32_t one = 1;
+            Synchronization::atomic_store_release(&t->skip_recorded, &one);
+            return;
+        }
+        // cur now holds the value some other worker recorded.
+        recorded = 1;
+    }
+}
+
+// Look up the cancellation token registered for a user context, if
+// any. Must be called with the work queue lock held.
+WEAK halide_cancellation_token_t *find_cancellation_token_already_locked(void *user_context) {
+    for (int i = 0; i < MAX_CANCELLATION_TOKENS; i++) {
+        if (work_queue.cancellation_tokens[i].token != nullptr &&
+            work_queue.cancellation_tokens[i].user_context == user_context) {
+            return work_queue.cancellation_tokens[i].token;
+        }
+    }
+    return nullptr;
+}
+
+// How many measured invocations to run at the current cap between
+// probes of a neighboring cap, and how many to run before the first
+// probe while a throughput baseline is established.
+#define ADAPTIVE_REPROBE_INTERVAL 32
+#define ADAPTIVE_WARMUP_INVOCATIONS 4
+
+// Find or create the controller state for a top-level parallel loop.
+// Returns nullptr if the table is full, in which case the loop runs
+// uncapped. Must be called with the work queue lock held.
+WEAK adaptive_parallelism_state *find_adaptive_state_already_locked(halide_task_t fn) {
+    adaptive_parallelism_state *free_entry = nullptr;
+    for (int i = 0; i < MAX_ADAPTIVE_PIPELINES; i++) {
+        adaptive_parallelism_state *s = &work_queue.adaptive_states[i];
+        if (s->fn == fn) {
+            return s;
+        }
+        if (s->fn == nullptr && free_entry == nullptr) {
+            free_entry = s;
+        }
+    }
+    if (free_entry) {
+        int threads = work_queue.desired_threads_working;
+        if (threads <= 0) {
+            threads = default_desired_num_threads();
+        }
+        free_entry->fn = fn;
+        free_entry->cap = clamp_num_threads(threads);
+        // Oversubscription is the common failure mode for memory-bound
+        // pipelines, so probe downwards first.
+        free_entry->direction = -1;
+        free_entry->countdown = ADAPTIVE_WARMUP_INVOCATIONS;
+        free_entry->best_rate = 0;
+    }
+    return free_entry;
+}
+
+// Pick the worker cap for one invocation of the loop s belongs to:
+// the current cap, or a neighboring cap when it is time to probe.
+// Must be called with the work queue lock held.
+WEAK int adaptive_choose_cap_already_locked(adaptive_parallelism_state *s) {
+    if (s->countdown > 0) {
+        return s->cap;
+    }
+    // Take steps proportional to the current cap so convergence from
+    // a large pool takes logarithmically many probes, settling to
+    // single-step refinement near the optimum.
+    int step = s->cap / 4;
+    if (step < 1) {
+        step = 1;
+    }
+    int probe = clamp_num_threads(s->cap + s->direction * step);
+    if (work_queue.desired_threads_working > 0 &&
+        probe > work_queue.desired_threads_working) {
+        probe = work_queue.desired_threads_working;
+    }
+    if (probe == s->cap) {
+        // Already at the edge in this direction; turn around at the
+        // next probe instead.
+        s->direction = -s->direction;
+        s->countdown = ADAPTIVE_REPROBE_INTERVAL;
+        return s->cap;
+    }
+    return probe;
+}
+
+// Feed one invocation's timing back into the controller. used_cap is
+// the cap the invocation ran at. Must be called with the work queue
+// lock held.
+WEAK void adaptive_record_already_locked(adaptive_parallelism_state *s,
+                                         int used_cap, int extent, int64_t elapsed_ns) {
+    if (elapsed_ns <= 0) {
+        return;
+    }
+    int64_t rate = ((int64_t)extent * 1000000000) / elapsed_ns;
+    if (used_cap == s->cap) {
+        // Track drift in throughput at the operating point, so a
+        // machine-load change eventually makes a probe look good
+        // again.
+        s->best_rate = (s->best_rate == 0) ? rate : (s->best_rate * 7 + rate) / 8;
+        if (s->countdown > 0) {
+            s->countdown--;
+        }
+    } else if (rate > s->best_rate + (s->best_rate >> 4)) {
+        // The probe won by a clear margin (~6%, to reject timing
+        // noise). Adopt it and keep moving the same direction soon.
+        s->cap = used_cap;
+        s->best_rate = rate;
+        s->countdown = 2;
+    } else {
+        // The probe didn't pay off. Try the other direction at the
+        // next re-probe.
+        s->direction = -s->direction;
+        s->countdown = ADAPTIVE_REPROBE_INTERVAL;
+    }
+}
+
+// Run one iteration out of a published chunk. Does not require the
+// work queue lock.
+WEAK int run_stolen_iteration(work_stealing_slot *slot, int idx) {
+    int result;
+    if (token_is_cancelled(slot->cancellation_token)) {
+        record_skipped_iteration(slot->cancellation_token, idx);
+        result = cancelled_status(slot->cancellation_token, slot->user_context);
+    } else if (slot->task_fn) {
+        result = halide_do_task(slot->user_context, slot->task_fn,
+                                idx, slot->closure);
+    } else {
+        result = halide_do_loop_task(slot->user_context, slot->loop_task_fn,
+                                     idx, 1, slot->closure, slot->job);
+    }
+    if (result != 0) {
+        Synchronization::atomic_store_release(&slot->chunk_exit_status, &result);
+    }
+    int one = 1;
+    Synchronization::atomic_fetch_add_acquire_release(&slot->completed, one);
+    return result;
+}
+
+// Attempt to steal and run a single iteration from some other worker's
+// published chunk. Called without the work queue lock held. Returns
+// true if an iteration was run.
+WEAK bool try_steal_iteration() {
+    // The high water mark is read racily, but it only ever grows, and
+    // a stale value just means a freshly-acquired slot is not scanned
+    // until the next attempt.
+    int limit = work_queue.steal_slots_high_water;
+    for (int i = 0; i < limit; i++) {
+        work_stealing_slot *slot = &work_queue.steal_slots[i];
+        int r;
+        Synchronization::atomic_load_acquire(&slot->remaining, &r);
+        while (r > 0) {
+            // In guided mode take half of what's left (rounded up), so
+            // repeated visits by idle workers carve the chunk into
+            // exponentially smaller pieces; otherwise take a single
+            // iteration. The mode is read racily, like the high water
+            // mark above; a stale value only mis-sizes one claim.
+            int grab = 1;
+            if (work_queue.use_work_stealing == halide_work_stealing_guided) {
+                grab = r - r / 2;
+            }
+            int desired = r - grab;
+            if (Synchronization::atomic_cas_weak_relacq_relaxed(&slot->remaining, &r, &desired)) {
+                // A successful claim means the chunk cannot complete
+                // until we bump the completed count below, so the slot
+                // fields are stable while we use them.
+                int first = slot->min + (slot->extent - r);
+                for (int j = 0; j < grab; j++) {
+                    if (run_stolen_iteration(slot, first + j) != 0) {
+                        // Count the rest of the claim as done without
+                        // running it, mirroring the owner's drain of
+                        // unclaimed iterations on error.
+                        int rest = grab - 1 - j;
+                        if (rest > 0) {
+                            Synchronization::atomic_fetch_add_acquire_release(&slot->completed, rest);
+                        }
+                        break;
+                    }
+                }
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Push a job onto the job stack, keeping the stack sorted by
+// descending priority so that the scan in
+// worker_thread_already_locked considers high-priority work first.
+// Among jobs of equal priority the newest goes on top, which preserves
+// the original LIFO behavior when priorities are not in use.
+WEAK void push_job_already_locked(work *job) {
+    work **prev_ptr = &work_queue.jobs;
+    while (*prev_ptr && (*prev_ptr)->priority > job->priority) {
+        prev_ptr = &(*prev_ptr)->next_job;
+    }
+    job->next_job = *prev_ptr;
+    *prev_ptr = job;
+}
+
 WEAK void worker_thread_already_locked(work *owned_job) {
     int spin_count = 0;
     const int max_spin_count = 40;
 
+    // Claim a work stealing slot to publish chunks of data-parallel
+    // iterations into. If none is free we just fall back to claiming
+    // one iteration per trip through the lock.
+    int steal_slot = -1;
+    if (work_queue.use_work_stealing) {
+        for (int i = 0; i < MAX_THREADS; i++) {
+            if (!work_queue.steal_slots[i].owner_active) {
+                work_queue.steal_slots[i].owner_active = true;
+                steal_slot = i;
+                if (i >= work_queue.steal_slots_high_water) {
+                    work_queue.steal_slots_high_water = i + 1;
+                }
+                break;
+            }
+        }
+    }
+
     while (owned_job ? owned_job->running() : !work_queue.shutdown) {
         work *job = work_queue.jobs;
         work **prev_ptr = &work_queue.jobs;
@@ -220,12 +652,29 @@ WEAK void worker_thread_already_locked(work *owned_job) {
                 // termination than to optimize this path.
                 halide_cond_broadcast(&work_queue.wake_owners);
                 continue;
+            } else if (token_is_cancelled(owned_job->cancellation_token)) {
+                record_skipped_iteration(owned_job->cancellation_token, owned_job->task.min);
+                // The invocation this job belongs to was cancelled.
+                // Record it as the exit status so the error teardown
+                // path above drains the job. This is also what
+                // terminates jobs whose remaining tasks are blocked on
+                // semaphores that will now never be released.
+                halide_mutex_unlock(&work_queue.mutex);
+                int status = cancelled_status(owned_job->cancellation_token, owned_job->user_context);
+                halide_mutex_lock(&work_queue.mutex);
+                if (owned_job->exit_status == 0) {
+                    owned_job->exit_status = status;
+                }
+                continue;
             }
         }
 
         dump_job_state();
 
-        // Find a job to run, prefering things near the top of the stack.
+        // Find a job to run, prefering things near the top of the
+        // stack. The stack is kept sorted by descending priority, so
+        // this also prefers high-priority jobs, falling back to
+        // lower-priority ones only when nothing above is runnable.
         while (job) {
             print_job(job, "", "Considering job ");
             // Only schedule tasks with enough free worker threads
@@ -257,7 +706,8 @@ WEAK void worker_thread_already_locked(work *owned_job) {
             if (!can_use_this_thread_stack) {
                 log_message("Cannot run job " << job->task.name << " on this thread.");
             }
-            bool can_add_worker = (!job->task.serial || (job->active_workers == 0));
+            bool can_add_worker = (!job->task.serial || (job->active_workers == 0)) &&
+                                  (job->max_workers == 0 || job->active_workers < job->max_workers);
             if (!can_add_worker) {
                 log_message("Cannot add worker to job " << job->task.name);
             }
@@ -274,7 +724,19 @@ WEAK void worker_thread_already_locked(work *owned_job) {
         }
 
         if (!job) {
-            // There is no runnable job. Go to sleep.
+            // There is no runnable job on the queue, but another
+            // worker may have published stealable iterations. Try to
+            // take one before going to sleep.
+            if (work_queue.use_work_stealing) {
+                halide_mutex_unlock(&work_queue.mutex);
+                bool stole = try_steal_iteration();
+                halide_mutex_lock(&work_queue.mutex);
+                if (stole) {
+                    spin_count = 0;
+                    continue;
+                }
+            }
+            // Go to sleep.
             if (owned_job) {
                 if (spin_count++ < max_spin_count) {
                     // Give the workers a chance to finish up before sleeping
@@ -336,6 +798,11 @@ WEAK void worker_thread_already_locked(work *owned_job) {
             int total_iters = 0;
             int iters = 1;
             while (result == 0) {
+                if (token_is_cancelled(job->cancellation_token)) {
+                    record_skipped_iteration(job->cancellation_token, job->task.min);
+                    result = cancelled_status(job->cancellation_token, job->user_context);
+                    break;
+                }
                 // Claim as many iterations as possible
                 while ((job->task.extent - total_iters) > iters &&
                        job->make_runnable()) {
@@ -361,32 +828,123 @@ WEAK void worker_thread_already_locked(work *owned_job) {
             if (result != 0) {
                 job->task.extent = 0;  // Force job to be finished.
             } else if (job->task.extent > 0) {
-                job->next_job = work_queue.jobs;
-                work_queue.jobs = job;
+                push_job_already_locked(job);
             }
         } else {
-            // Claim a task from it.
-            work myjob = *job;
-            job->task.min++;
-            job->task.extent--;
-
-            // If there were no more tasks pending for this job, remove it
-            // from the stack.
-            if (job->task.extent == 0) {
-                *prev_ptr = job->next_job;
+            // Decide whether to claim a chunk of iterations and
+            // publish the remainder for stealing. Only safe for jobs
+            // that don't acquire semaphores per iteration and that
+            // promise not to block (min_threads == 0), which covers
+            // the dense par-for case work stealing is aimed at.
+            // Don't publish chunks from jobs with an adaptive worker
+            // cap: thieves run iterations without joining the job, so
+            // stealing would let workers beyond the cap contribute
+            // and corrupt the controller's measurements.
+            int chunk = 0;
+            if (steal_slot >= 0 &&
+                job->task.num_semaphores == 0 &&
+                job->task.min_threads == 0 &&
+                job->max_workers == 0) {
+                chunk = job->task.extent / (work_queue.threads_created + 1);
+                if (chunk < 2) {
+                    // Not worth publishing a single iteration.
+                    chunk = 0;
+                }
             }
 
-            // Release the lock and do the task.
-            halide_mutex_unlock(&work_queue.mutex);
-            if (myjob.task_fn) {
-                result = halide_do_task(myjob.user_context, myjob.task_fn,
-                                        myjob.task.min, myjob.task.closure);
+            if (chunk > 0) {
+                work_stealing_slot *slot = &work_queue.steal_slots[steal_slot];
+                slot->job = job;
+                slot->task_fn = job->task_fn;
+                slot->loop_task_fn = job->task.fn;
+                slot->user_context = job->user_context;
+                slot->closure = job->task.closure;
+                slot->min = job->task.min;
+                slot->extent = chunk;
+                slot->chunk_exit_status = 0;
+                slot->completed = 0;
+                slot->cancellation_token = job->cancellation_token;
+                job->task.min += chunk;
+                job->task.extent -= chunk;
+
+                // If there were no more tasks pending for this job,
+                // remove it from the stack.
+                if (job->task.extent == 0) {
+                    *prev_ptr = job->next_job;
+                }
+
+                halide_mutex_unlock(&work_queue.mutex);
+
+                // Publish the chunk. This store is what makes the
+                // fields above visible to thieves.
+                Synchronization::atomic_store_release(&slot->remaining, &chunk);
+
+                // Claim and run iterations until the chunk is drained
+                // or an error occurs.
+                int r;
+                Synchronization::atomic_load_acquire(&slot->remaining, &r);
+                while (r > 0 && result == 0) {
+                    int desired = r - 1;
+                    if (Synchronization::atomic_cas_weak_relacq_relaxed(&slot->remaining, &r, &desired)) {
+                        result = run_stolen_iteration(slot, slot->min + (slot->extent - r));
+                        Synchronization::atomic_load_acquire(&slot->remaining, &r);
+                    }
+                }
+
+                // Wait for any stolen iterations to finish. If an
+                // error occurred, drain the unclaimed iterations
+                // without running them so completion is still reached.
+                while (true) {
+                    int done;
+                    Synchronization::atomic_load_acquire(&slot->completed, &done);
+                    if (done == slot->extent) {
+                        break;
+                    }
+                    int status;
+                    Synchronization::atomic_load_acquire(&slot->chunk_exit_status, &status);
+                    if (status != 0) {
+                        Synchronization::atomic_load_acquire(&slot->remaining, &r);
+                        while (r > 0) {
+                            int zero = 0;
+                            if (Synchronization::atomic_cas_weak_relacq_relaxed(&slot->remaining, &r, &zero)) {
+                                Synchronization::atomic_fetch_add_acquire_release(&slot->completed, r);
+                                break;
+                            }
+                        }
+                    }
+                    halide_thread_yield();
+                }
+                // All claims are complete, so this read is stable.
+                result = slot->chunk_exit_status;
+
+                halide_mutex_lock(&work_queue.mutex);
             } else {
-                result = halide_do_loop_task(myjob.user_context, myjob.task.fn,
-                                             myjob.task.min, 1,
-                                             myjob.task.closure, job);
+                // Claim a task from it.
+                work myjob = *job;
+                job->task.min++;
+                job->task.extent--;
+
+                // If there were no more tasks pending for this job, remove it
+                // from the stack.
+                if (job->task.extent == 0) {
+                    *prev_ptr = job->next_job;
+                }
+
+                // Release the lock and do the task.
+                halide_mutex_unlock(&work_queue.mutex);
+                if (token_is_cancelled(myjob.cancellation_token)) {
+                    record_skipped_iteration(myjob.cancellation_token, myjob.task.min);
+                    result = cancelled_status(myjob.cancellation_token, myjob.user_context);
+                } else if (myjob.task_fn) {
+                    result = halide_do_task(myjob.user_context, myjob.task_fn,
+                                            myjob.task.min, myjob.task.closure);
+                } else {
+                    result = halide_do_loop_task(myjob.user_context, myjob.task.fn,
+                                                 myjob.task.min, 1,
+                                                 myjob.task.closure, job);
+                }
+                halide_mutex_lock(&work_queue.mutex);
             }
-            halide_mutex_lock(&work_queue.mutex);
         }
 
         if (result != 0) {
@@ -428,10 +986,24 @@ WEAK void worker_thread_already_locked(work *owned_job) {
             halide_cond_broadcast(&work_queue.wake_owners);
         }
     }
+
+    if (steal_slot >= 0) {
+        work_queue.steal_slots[steal_slot].owner_active = false;
+    }
 }
 
 WEAK void worker_thread(void *arg) {
     halide_mutex_lock(&work_queue.mutex);
+    // Pin freshly-spawned pool workers according to the affinity
+    // policy. bind_worker_thread is defined by the platform-specific
+    // code that includes this file.
+    if (work_queue.thread_affinity_policy != halide_thread_affinity_policy_none) {
+        int worker_id = work_queue.workers_started++;
+        int policy = work_queue.thread_affinity_policy;
+        halide_mutex_unlock(&work_queue.mutex);
+        bind_worker_thread(worker_id, policy);
+        halide_mutex_lock(&work_queue.mutex);
+    }
     worker_thread_already_locked((work *)arg);
     halide_mutex_unlock(&work_queue.mutex);
 }
@@ -523,15 +1095,30 @@ WEAK void enqueue_work_already_locked(int num_jobs, work *jobs, work *task_paren
         }
     }
 
-    // Push the jobs onto the stack.
+    // Nested jobs poll the same cancellation token as their parent;
+    // top-level jobs look one up by their user context.
+    halide_cancellation_token_t *cancellation_token =
+        task_parent ? task_parent->cancellation_token : find_cancellation_token_already_locked(jobs[0].user_context);
+
+    // Push the jobs onto the stack in priority order. Nested jobs run
+    // at their parent's priority; top-level jobs take the current
+    // default, so a caller can bracket a pipeline invocation with
+    // halide_set_default_task_priority to give all of its tasks one
+    // priority.
     for (int i = num_jobs - 1; i >= 0; i--) {
-        // We could bubble it downwards based on some heuristics, but
-        // it's not strictly necessary to do so.
-        jobs[i].next_job = work_queue.jobs;
         jobs[i].siblings = &jobs[0];
         jobs[i].sibling_count = num_jobs;
         jobs[i].threads_reserved = 0;
-        work_queue.jobs = jobs + i;
+        jobs[i].priority = task_parent ? task_parent->priority : work_queue.default_task_priority;
+        jobs[i].cancellation_token = cancellation_token;
+        if (task_parent) {
+            // Nested jobs run under their parent's adaptive worker
+            // cap, unless they may block: the deadlock avoidance
+            // logic assumes nothing but thread availability limits
+            // who may join a job with a min_threads requirement.
+            jobs[i].max_workers = (jobs[i].task.min_threads == 0) ? task_parent->max_workers : 0;
+        }
+        push_job_already_locked(jobs + i);
     }
 
     bool nested_parallelism =
@@ -603,6 +1190,23 @@ WEAK int halide_default_do_par_for(void *user_context, halide_task_t f,
         return 0;
     }
 
+    // For loops with very few iterations, waking a worker costs more
+    // than the work: run on the calling thread instead of enqueuing.
+    // Serial execution is always a legal schedule for a parallel
+    // loop, and nested parallel loops inside f still enqueue
+    // normally.
+    int inline_threshold;
+    Synchronization::atomic_load_relaxed(&parallel_inline_threshold, &inline_threshold);
+    if (size <= inline_threshold) {
+        for (int i = 0; i < size; i++) {
+            int result = halide_do_task(user_context, f, min + i, closure);
+            if (result != 0) {
+                return result;
+            }
+        }
+        return 0;
+    }
+
     work job;
     job.task.fn = nullptr;
     job.task.min = min;
@@ -622,9 +1226,26 @@ WEAK int halide_default_do_par_for(void *user_context, halide_task_t f,
     job.siblings = &job;  // guarantees no other job points to the same siblings.
     job.sibling_count = 0;
     job.parent_job = nullptr;
+    job.max_workers = 0;
     halide_mutex_lock(&work_queue.mutex);
+    adaptive_parallelism_state *adapt = nullptr;
+    int64_t start_time = 0;
+    if (work_queue.use_adaptive_parallelism) {
+        adapt = find_adaptive_state_already_locked(f);
+        if (adapt) {
+            job.max_workers = adaptive_choose_cap_already_locked(adapt);
+            start_time = (int64_t)halide_current_time_ns(nullptr);
+        }
+    }
     enqueue_work_already_locked(1, &job, nullptr);
     worker_thread_already_locked(&job);
+    if (adapt && job.exit_status == 0) {
+        // Concurrent invocations sharing the machine make each other
+        // look slow; that's just noise the margin in the controller
+        // has to reject.
+        int64_t elapsed = (int64_t)halide_current_time_ns(nullptr) - start_time;
+        adaptive_record_already_locked(adapt, job.max_workers, size, elapsed);
+    }
     halide_mutex_unlock(&work_queue.mutex);
     return job.exit_status;
 }
@@ -648,6 +1269,9 @@ WEAK int halide_default_do_parallel_tasks(void *user_context, int num_tasks,
         jobs[i].next_semaphore = 0;
         jobs[i].owner_is_sleeping = false;
         jobs[i].parent_job = (work *)task_parent;
+        // Top-level parallel tasks are not adaptively capped; nested
+        // ones inherit their parent's cap when enqueued.
+        jobs[i].max_workers = 0;
     }
 
     if (num_tasks == 0) {
@@ -669,6 +1293,17 @@ WEAK int halide_default_do_parallel_tasks(void *user_context, int num_tasks,
     return exit_status;
 }
 
+WEAK int halide_set_parallel_inline_threshold(int n) {
+    if (n < 0) {
+        halide_error(nullptr, "halide_set_parallel_inline_threshold: must be >= 0.");
+    }
+    int old;
+    Synchronization::atomic_load_relaxed(&parallel_inline_threshold, &old);
+    while (!Synchronization::atomic_cas_weak_relacq_relaxed(&parallel_inline_threshold, &old, &n)) {
+    }
+    return old;
+}
+
 WEAK int halide_set_num_threads(int n) {
     if (n < 0) {
         halide_error(nullptr, "halide_set_num_threads: must be >= 0.");
@@ -686,6 +1321,135 @@ WEAK int halide_set_num_threads(int n) {
     return old;
 }
 
+WEAK int halide_set_adaptive_parallelism(int enable) {
+    halide_mutex_lock(&work_queue.mutex);
+    int old = work_queue.use_adaptive_parallelism;
+    work_queue.use_adaptive_parallelism = enable;
+    if (enable && !old) {
+        // Start the controllers fresh: machine load may have changed
+        // since they last ran.
+        memset(work_queue.adaptive_states, 0, sizeof(work_queue.adaptive_states));
+    }
+    halide_mutex_unlock(&work_queue.mutex);
+    return old;
+}
+
+WEAK int halide_set_thread_affinity_policy(int policy) {
+    halide_mutex_lock(&work_queue.mutex);
+    int old = work_queue.thread_affinity_policy;
+    work_queue.thread_affinity_policy = policy;
+    halide_mutex_unlock(&work_queue.mutex);
+    return old;
+}
+
+WEAK int halide_cancellation_token_init(halide_cancellation_token_t *token) {
+    cancellation_token_impl_t *t = (cancellation_token_impl_t *)token;
+    int32_t zero = 0;
+    int64_t zero64 = 0;
+    Synchronization::atomic_store_release(&t->error_reported, &zero);
+    Synchronization::atomic_store_release(&t->deadline_ns, &zero64);
+    Synchronization::atomic_store_release(&t->skip_recorded, &zero);
+    Synchronization::atomic_store_release(&t->first_skipped, &zero);
+    Synchronization::atomic_store_release(&t->cancelled, &zero);
+    return 0;
+}
+
+WEAK int halide_set_deadline(halide_cancellation_token_t *token, int64_t budget_ns) {
+    cancellation_token_impl_t *t = (cancellation_token_impl_t *)token;
+    int64_t deadline = 0;
+    if (budget_ns > 0) {
+        deadline = (int64_t)halide_current_time_ns(nullptr) + budget_ns;
+    }
+    Synchronization::atomic_store_release(&t->deadline_ns, &deadline);
+    return 0;
+}
+
+WEAK bool halide_deadline_progress(halide_cancellation_token_t *token, int *first_skipped) {
+    cancellation_token_impl_t *t = (cancellation_token_impl_t *)token;
+    int32_t recorded;
+    Synchronization::atomic_load_acquire(&t->skip_recorded, &recorded);
+    if (recorded == 0) {
+        return false;
+    }
+    int32_t value;
+    Synchronization::atomic_load_acquire(&t->first_skipped, &value);
+    *first_skipped = value;
+    return true;
+}
+
+WEAK void halide_cancel(halide_cancellation_token_t *token) {
+    cancellation_token_impl_t *t = (cancellation_token_impl_t *)token;
+    int32_t one = 1;
+    Synchronization::atomic_store_release(&t->cancelled, &one);
+    // Wake all sleeping threads so the cancellation is noticed
+    // promptly, in particular owners whose remaining tasks are blocked
+    // on semaphores.
+    halide_mutex_lock(&work_queue.mutex);
+    halide_cond_broadcast(&work_queue.wake_owners);
+    halide_cond_broadcast(&work_queue.wake_a_team);
+    halide_cond_broadcast(&work_queue.wake_b_team);
+    halide_mutex_unlock(&work_queue.mutex);
+}
+
+WEAK bool halide_cancellation_token_cancelled(halide_cancellation_token_t *token) {
+    return token_is_cancelled(token);
+}
+
+WEAK int halide_set_cancellation_token(void *user_context, halide_cancellation_token_t *token) {
+    int result = 0;
+    halide_mutex_lock(&work_queue.mutex);
+    // Reuse an existing association for this user context, else claim
+    // a free entry.
+    int idx = -1;
+    for (int i = 0; i < MAX_CANCELLATION_TOKENS; i++) {
+        if (work_queue.cancellation_tokens[i].token != nullptr &&
+            work_queue.cancellation_tokens[i].user_context == user_context) {
+            idx = i;
+            break;
+        }
+    }
+    if (idx < 0 && token != nullptr) {
+        for (int i = 0; i < MAX_CANCELLATION_TOKENS; i++) {
+            if (work_queue.cancellation_tokens[i].token == nullptr) {
+                idx = i;
+                break;
+            }
+        }
+    }
+    if (idx >= 0) {
+        work_queue.cancellation_tokens[idx].user_context = user_context;
+        work_queue.cancellation_tokens[idx].token = token;
+    } else if (token != nullptr) {
+        result = halide_error_code_generic_error;
+    }
+    halide_mutex_unlock(&work_queue.mutex);
+    return result;
+}
+
+WEAK int halide_set_default_task_priority(int priority) {
+    halide_mutex_lock(&work_queue.mutex);
+    int old = work_queue.default_task_priority;
+    work_queue.default_task_priority = priority;
+    halide_mutex_unlock(&work_queue.mutex);
+    return old;
+}
+
+WEAK int halide_set_work_stealing(int enable) {
+    int mode = enable;
+    if (mode < halide_work_stealing_off) {
+        mode = halide_work_stealing_off;
+    } else if (mode > halide_work_stealing_guided) {
+        mode = halide_work_stealing_guided;
+    }
+    // Take the lock for the same reason halide_set_num_threads does:
+    // workers read this flag while holding it.
+    halide_mutex_lock(&work_queue.mutex);
+    int old = work_queue.use_work_stealing;
+    work_queue.use_work_stealing = mode;
+    halide_mutex_unlock(&work_queue.mutex);
+    return old;
+}
+
 WEAK void halide_shutdown_thread_pool() {
     if (work_queue.initialized) {
         // Wake everyone up and tell them the party's over and it's time
@@ -129,6 +129,19 @@ public:
         return packet;
     }
 
+    // Acquire and return a packet's worth of space in the trace
+    // buffer, waiting for the background flusher thread to drain the
+    // buffer if it is full. Only usable in the buffered tracing mode
+    // below, in which writers never touch the trace file themselves.
+    ALWAYS_INLINE halide_trace_packet_t *acquire_packet_buffered(void *user_context, uint32_t size) {
+        halide_trace_packet_t *packet = nullptr;
+        while (!(packet = try_acquire_packet(user_context, size))) {
+            // The buffer is full. The flusher thread will drain it soon.
+            halide_thread_yield();
+        }
+        return packet;
+    }
+
     // Release a packet, allowing it to be written out with flush
     ALWAYS_INLINE void release_packet(halide_trace_packet_t *) {
         // Need a memory barrier to guarantee all the writes are done.
@@ -136,6 +149,25 @@ public:
         lock.release_shared();
     }
 
+    // Wait for all writers to finish with their packets, and copy the
+    // contents of the buffer into dst without writing them to a
+    // file. Returns the number of bytes copied. Writers are only
+    // stalled for the duration of a memcpy, rather than a write
+    // syscall, which is the point of the buffered tracing mode.
+    ALWAYS_INLINE uint32_t drain(void *user_context, uint8_t *dst) {
+        lock.acquire_exclusive();
+        uint32_t bytes = 0;
+        if (cursor) {
+            cursor -= overage;
+            memcpy(dst, buf, cursor);
+            bytes = cursor;
+            cursor = 0;
+            overage = 0;
+        }
+        lock.release_exclusive();
+        return bytes;
+    }
+
     ALWAYS_INLINE void init() {
         cursor = 0;
         overage = 0;
@@ -151,6 +183,98 @@ WEAK ScopedSpinLock::AtomicFlag halide_trace_file_lock = 0;
 WEAK bool halide_trace_file_initialized = false;
 WEAK void *halide_trace_file_internally_opened = nullptr;
 
+// A buffered tracing mode, enabled by setting HL_TRACE_BUFFERED in the
+// environment alongside HL_TRACE_FILE. Each thread writes packets to
+// one of several trace buffers, picked by hashing its stack address,
+// so distinct threads almost always write to distinct buffers and
+// never serialize on the write syscall. A background thread
+// periodically drains every buffer, merges the packets back into id
+// order, and writes them to the trace file in bulk. The output is the
+// same packet format the default mode produces, so existing consumers
+// like HalideTraceViz are unaffected.
+const static int num_trace_shards = 8;  // must be a power of two
+
+WEAK TraceBuffer *halide_trace_shards = nullptr;
+WEAK uint8_t *halide_trace_flush_scratch = nullptr;
+WEAK halide_thread *halide_trace_flusher_thread = nullptr;
+WEAK volatile bool halide_trace_flusher_stop = false;
+WEAK ScopedSpinLock::AtomicFlag halide_trace_flusher_lock = 0;
+
+// Pick the trace buffer the current thread should write to. Distinct
+// threads run on distinct stacks, so hashing the address of a stack
+// variable assigns each thread a stable shard. A collision merely
+// costs some shared-lock contention; it doesn't affect correctness.
+ALWAYS_INLINE int trace_shard_index() {
+    int x;
+    uintptr_t p = (uintptr_t)&x;
+    return (int)((p >> 12) ^ (p >> 20)) & (num_trace_shards - 1);
+}
+
+// Drain all trace buffers, merge the packets by id, and write them to
+// the trace file in a single syscall. Called periodically by the
+// flusher thread, and directly at the end of a pipeline so the file
+// is complete once the pipeline returns.
+WEAK void halide_trace_flush_buffered(void *user_context, int fd) {
+    // Only one flush pass may run at a time, so that passes don't
+    // interleave their output.
+    ScopedSpinLock lock(&halide_trace_flusher_lock);
+
+    // Drain each shard into the first half of the scratch space,
+    // remembering the range of bytes each one produced.
+    uint8_t *scratch = halide_trace_flush_scratch;
+    uint8_t *merged = scratch + num_trace_shards * buffer_size;
+    uint32_t shard_begin[num_trace_shards], shard_end[num_trace_shards];
+    uint32_t total = 0;
+    for (int i = 0; i < num_trace_shards; i++) {
+        shard_begin[i] = total;
+        total += halide_trace_shards[i].drain(user_context, scratch + total);
+        shard_end[i] = total;
+    }
+    if (total == 0) {
+        return;
+    }
+
+    // Each shard holds its packets in increasing id order (up to the
+    // benign race between id assignment and buffer acquisition that
+    // the unbuffered mode has too), so a k-way merge restores global
+    // id order.
+    uint32_t merged_bytes = 0;
+    while (merged_bytes < total) {
+        int min_shard = -1;
+        int32_t min_id = 0;
+        for (int i = 0; i < num_trace_shards; i++) {
+            if (shard_begin[i] < shard_end[i]) {
+                const halide_trace_packet_t *p = (const halide_trace_packet_t *)(scratch + shard_begin[i]);
+                if (min_shard < 0 || p->id < min_id) {
+                    min_shard = i;
+                    min_id = p->id;
+                }
+            }
+        }
+        const halide_trace_packet_t *p = (const halide_trace_packet_t *)(scratch + shard_begin[min_shard]);
+        memcpy(merged + merged_bytes, p, p->size);
+        merged_bytes += p->size;
+        shard_begin[min_shard] += p->size;
+    }
+
+    bool success = (merged_bytes == (uint32_t)write(fd, merged, merged_bytes));
+    halide_assert(user_context, success && "Could not write to trace file");
+}
+
+WEAK void trace_flusher_thread(void *) {
+    int fd = halide_trace_file;
+    while (true) {
+        // Check the stop flag before draining, so that anything
+        // written before the flag was set gets a final flush.
+        bool stop = halide_trace_flusher_stop;
+        halide_trace_flush_buffered(nullptr, fd);
+        if (stop) {
+            return;
+        }
+        halide_sleep_ms(nullptr, 1);
+    }
+}
+
 }  // namespace Internal
 }  // namespace Runtime
 }  // namespace Halide
@@ -175,7 +299,13 @@ WEAK int32_t halide_default_trace(void *user_context, const halide_trace_event_t
         uint32_t total_size = (total_size_without_padding + 3) & ~3;
 
         // Claim some space to write to in the trace buffer
-        halide_trace_packet_t *packet = halide_trace_buffer->acquire_packet(user_context, fd, total_size);
+        halide_trace_packet_t *packet;
+        if (halide_trace_shards) {
+            TraceBuffer *shard = halide_trace_shards + trace_shard_index();
+            packet = shard->acquire_packet_buffered(user_context, total_size);
+        } else {
+            packet = halide_trace_buffer->acquire_packet(user_context, fd, total_size);
+        }
 
         if (total_size > 4096) {
             print(nullptr) << total_size << "\n";
@@ -199,12 +329,20 @@ WEAK int32_t halide_default_trace(void *user_context, const halide_trace_event_t
         memcpy((void *)packet->trace_tag(), e->trace_tag ? e->trace_tag : "", trace_tag_bytes);
 
         // Release it
-        halide_trace_buffer->release_packet(packet);
+        if (halide_trace_shards) {
+            (halide_trace_shards + trace_shard_index())->release_packet(packet);
+        } else {
+            halide_trace_buffer->release_packet(packet);
+        }
 
         // We should also flush the trace buffer if we hit an event
         // that might be the end of the trace.
         if (e->event == halide_trace_end_pipeline) {
-            halide_trace_buffer->flush(user_context, fd);
+            if (halide_trace_shards) {
+                halide_trace_flush_buffered(user_context, fd);
+            } else {
+                halide_trace_buffer->flush(user_context, fd);
+            }
         }
 
     } else {
@@ -353,7 +491,19 @@ WEAK int halide_get_trace_file(void *user_context) {
             halide_assert(user_context, file && "Failed to open trace file\n");
             halide_set_trace_file(fileno(file));
             halide_trace_file_internally_opened = file;
-            if (!halide_trace_buffer) {
+            if (getenv("HL_TRACE_BUFFERED")) {
+                if (!halide_trace_shards) {
+                    halide_trace_shards = (TraceBuffer *)malloc(num_trace_shards * sizeof(TraceBuffer));
+                    for (int i = 0; i < num_trace_shards; i++) {
+                        halide_trace_shards[i].init();
+                    }
+                    // Scratch for a flush pass: one half to drain the
+                    // shards into, one half to merge them into.
+                    halide_trace_flush_scratch = (uint8_t *)malloc(2 * num_trace_shards * buffer_size);
+                    halide_trace_flusher_stop = false;
+                    halide_trace_flusher_thread = halide_spawn_thread(trace_flusher_thread, nullptr);
+                }
+            } else if (!halide_trace_buffer) {
                 halide_trace_buffer = (TraceBuffer *)malloc(sizeof(TraceBuffer));
                 halide_trace_buffer->init();
             }
@@ -369,6 +519,13 @@ WEAK int32_t halide_trace(void *user_context, const halide_trace_event_t *e) {
 }
 
 WEAK int halide_shutdown_trace() {
+    if (halide_trace_flusher_thread) {
+        // Stop the flusher thread. It does one final drain of the
+        // trace buffers on its way out.
+        halide_trace_flusher_stop = true;
+        halide_join_thread(halide_trace_flusher_thread);
+        halide_trace_flusher_thread = nullptr;
+    }
     if (halide_trace_file_internally_opened) {
         int ret = fclose(halide_trace_file_internally_opened);
         halide_trace_file = 0;
@@ -377,6 +534,12 @@ WEAK int halide_shutdown_trace() {
         if (halide_trace_buffer) {
             free(halide_trace_buffer);
         }
+        if (halide_trace_shards) {
+            free(halide_trace_shards);
+            halide_trace_shards = nullptr;
+            free(halide_trace_flush_scratch);
+            halide_trace_flush_scratch = nullptr;
+        }
         return ret;
     } else {
         return 0;
@@ -131,6 +131,12 @@ struct thread_parker {
 };
 
 }  // namespace Synchronization
+
+// Worker pinning is not implemented on this platform; the affinity
+// policy set via halide_set_thread_affinity_policy is ignored.
+WEAK void bind_worker_thread(int worker_id, int policy) {
+}
+
 }  // namespace Internal
 }  // namespace Runtime
 }  // namespace Halide
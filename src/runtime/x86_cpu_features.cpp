@@ -29,6 +29,7 @@ WEAK CpuFeatures halide_get_cpu_features() {
     features.set_known(halide_target_feature_avx512_skylake);
     features.set_known(halide_target_feature_avx512_cannonlake);
     features.set_known(halide_target_feature_avx512_sapphirerapids);
+    features.set_known(halide_target_feature_avx512_fp16);
 
     int32_t info[4];
     cpuid(info, 1);
@@ -66,6 +67,7 @@ WEAK CpuFeatures halide_get_cpu_features() {
         const uint32_t avx512ifma = 1U << 21;
         const uint32_t avx512vnni = 1U << 11;  // vnni result in ecx
         const uint32_t avx512bf16 = 1U << 5;   // bf16 result in eax, cpuid(eax=7, ecx=1)
+        const uint32_t avx512fp16 = 1U << 23;  // fp16 result in edx
         const uint32_t avx512 = avx512f | avx512cd;
         const uint32_t avx512_knl = avx512 | avx512pf | avx512er;
         const uint32_t avx512_skylake = avx512 | avx512vl | avx512bw | avx512dq;
@@ -80,6 +82,10 @@ WEAK CpuFeatures halide_get_cpu_features() {
             }
             if ((info2[1] & avx512_skylake) == avx512_skylake) {
                 features.set_available(halide_target_feature_avx512_skylake);
+                if ((info2[2] & avx512vnni) == avx512vnni) {
+                    // Cascade Lake and onwards
+                    features.set_available(halide_target_feature_avx512_vnni);
+                }
             }
             if ((info2[1] & avx512_cannonlake) == avx512_cannonlake) {
                 features.set_available(halide_target_feature_avx512_cannonlake);
@@ -90,6 +96,9 @@ WEAK CpuFeatures halide_get_cpu_features() {
                     (info3[0] & avx512bf16) == avx512bf16) {
                     features.set_available(halide_target_feature_avx512_sapphirerapids);
                 }
+                if ((info2[3] & avx512fp16) == avx512fp16) {
+                    features.set_available(halide_target_feature_avx512_fp16);
+                }
             }
         }
     }
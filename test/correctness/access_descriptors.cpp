@@ -0,0 +1,53 @@
+#include "Halide.h"
+#include "halide_test_dirs.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+using namespace Halide;
+
+int main(int argc, char **argv) {
+    Func f("f"), g("g");
+    Var x("x"), y("y");
+
+    f(x, y) = x + y;
+    g(x, y) = f(x, y) * 2;
+
+    f.compute_root();
+    g.bound(x, 0, 64).bound(y, 0, 16);
+    g.output_buffer().dim(0).set_stride(1).dim(1).set_stride(64);
+
+    std::string result_file = Internal::get_test_tmp_dir() + "access_descriptors.c";
+
+    Internal::ensure_no_file_exists(result_file);
+
+    g.compile_to_access_descriptors(result_file, g.infer_arguments(), "descriptor_test");
+
+    Internal::assert_file_exists(result_file);
+
+    std::ifstream in(result_file);
+    std::stringstream contents;
+    contents << in.rdbuf();
+    std::string table = contents.str();
+
+    auto expect = [&](const std::string &substr) {
+        if (table.find(substr) == std::string::npos) {
+            printf("Did not find \"%s\" in the generated descriptor table:\n%s\n",
+                   substr.c_str(), table.c_str());
+            exit(-1);
+        }
+    };
+
+    expect("descriptor_test_access_descriptors[]");
+    expect("descriptor_test_access_descriptor_count");
+    // f is computed over the bounded output region, so its store and
+    // g's load of it should both be fully constant: int32 elements,
+    // dense rows of 64, 16 rows with a stride of one row in bytes.
+    expect("\"f\"");
+    expect("\"g\"");
+    expect("{4, 256}, {64, 16}");
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,49 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+
+int main(int argc, char **argv) {
+    const int W = 64, H = 48;
+
+    Buffer<float> input(W, H);
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            input(x, y) = (x * 13 + y * 7) % 31 * 0.1f;
+        }
+    }
+
+    Var x("x"), y("y");
+    Func clamped = BoundaryConditions::repeat_edge(input);
+    Func blur("blur");
+    blur(x, y) = clamped(x - 1, y) + 2 * clamped(x, y) + clamped(x + 1, y);
+
+    RDom r(0, W, 0, H);
+    Func loss("loss");
+    loss() = 0.f;
+    loss() += blur(r.x, r.y) * blur(r.x, r.y);
+
+    // Realize the gradient with respect to the input twice: once with
+    // the default scheduling of the generated adjoints, once with the
+    // tuned derivative schedule. The results must match.
+    Derivative d = propagate_adjoints(loss);
+    Func d_input = d(input);
+
+    Buffer<float> reference = d_input.realize({W, H});
+
+    d.default_schedule({d_input});
+    Buffer<float> scheduled = d_input.realize({W, H});
+
+    for (int iy = 0; iy < H; iy++) {
+        for (int ix = 0; ix < W; ix++) {
+            if (fabs(scheduled(ix, iy) - reference(ix, iy)) > 1e-4f) {
+                printf("scheduled(%d, %d) = %f instead of %f\n",
+                       ix, iy, scheduled(ix, iy), reference(ix, iy));
+                return -1;
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,95 @@
+#include "Halide.h"
+
+using namespace Halide;
+
+int main(int argc, char **argv) {
+    Target target = get_jit_target_from_environment();
+    if (target.arch == Target::WebAssembly) {
+        printf("[SKIP] WebAssembly does not support async() yet.\n");
+        return 0;
+    }
+    target = target.with_feature(Target::AsyncRoot);
+
+    // A diamond of compute_root stages. With async_root the two
+    // middle branches become independent tasks in the DAG instead of
+    // running sequentially in realization order.
+    {
+        Func input("input"), left("left"), right("right"), output("output");
+        Var x, y;
+
+        input(x, y) = x + y;
+        left(x, y) = input(x, y) * 2;
+        right(x, y) = input(x, y) + 7;
+        output(x, y) = left(x, y) + right(x, y);
+
+        input.compute_root();
+        left.compute_root();
+        right.compute_root();
+
+        Buffer<int> out = output.realize({64, 64}, target);
+
+        out.for_each_element([&](int x, int y) {
+            int correct = (x + y) * 2 + (x + y) + 7;
+            if (out(x, y) != correct) {
+                printf("out(%d, %d) = %d instead of %d\n",
+                       x, y, out(x, y), correct);
+                exit(-1);
+            }
+        });
+    }
+
+    // A deeper chain with update definitions and a parallel stage, to
+    // make sure dependent stages still run in order.
+    {
+        Func a("a"), b("b"), c("c"), d("d");
+        Var x, y;
+
+        a(x, y) = x * y;
+        b(x, y) = a(x, y) + 1;
+        b(x, y) += a(x, y);
+        c(x, y) = a(x, y) * 3;
+        d(x, y) = b(x, y) + c(x, y);
+
+        a.compute_root();
+        b.compute_root();
+        c.compute_root().parallel(y);
+
+        Buffer<int> out = d.realize({32, 32}, target);
+
+        out.for_each_element([&](int x, int y) {
+            int correct = (x * y + 1 + x * y) + x * y * 3;
+            if (out(x, y) != correct) {
+                printf("out(%d, %d) = %d instead of %d\n",
+                       x, y, out(x, y), correct);
+                exit(-1);
+            }
+        });
+    }
+
+    // Explicitly-async stages and async_root should compose.
+    {
+        Func f("f"), g("g"), h("h");
+        Var x;
+
+        f(x) = x;
+        g(x) = f(x) + f(x + 1);
+        h(x) = g(x) - f(x);
+
+        f.compute_root().async();
+        g.compute_root();
+
+        Buffer<int> out = h.realize({128}, target);
+
+        out.for_each_element([&](int x) {
+            int correct = x + x + 1;
+            if (out(x) != correct) {
+                printf("out(%d) = %d instead of %d\n",
+                       x, out(x), correct);
+                exit(-1);
+            }
+        });
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,65 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+
+int main(int argc, char **argv) {
+    Param<int32_t> offset(10);
+    ImageParam in(Int(32), 1);
+
+    Var x("x");
+    Func f("f");
+    f(x) = in(x) + offset;
+
+    Buffer<int> in1(16), in2(16);
+    for (int i = 0; i < 16; i++) {
+        in1(i) = i;
+        in2(i) = 2 * i;
+    }
+    in.set(in1);
+
+    Buffer<int> out1(16), out2(16);
+
+    Pipeline p(f);
+    Target t = get_jit_target_from_environment();
+    Pipeline::BoundCall call = p.bind(out1, t);
+
+    call.run();
+    for (int i = 0; i < 16; i++) {
+        int correct = i + 10;
+        if (out1(i) != correct) {
+            printf("out1(%d) = %d instead of %d\n", i, out1(i), correct);
+            return -1;
+        }
+    }
+
+    // Scalar params poke through with no rebinding.
+    offset.set(20);
+    call.run();
+    for (int i = 0; i < 16; i++) {
+        int correct = i + 20;
+        if (out1(i) != correct) {
+            printf("out1(%d) = %d instead of %d\n", i, out1(i), correct);
+            return -1;
+        }
+    }
+
+    // Buffers are repointed explicitly.
+    call.set_input(in, in2);
+    call.set_output(0, out2);
+    call.run();
+    for (int i = 0; i < 16; i++) {
+        int correct = 2 * i + 20;
+        if (out2(i) != correct) {
+            printf("out2(%d) = %d instead of %d\n", i, out2(i), correct);
+            return -1;
+        }
+        if (out1(i) != i + 20) {
+            printf("out1(%d) was clobbered: %d\n", i, out1(i));
+            return -1;
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,33 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+
+int main(int argc, char **argv) {
+    const int W = 512, H = 512;
+
+    // Allocate an output with its pages touched up front, then check
+    // the buffer behaves like any other host allocation.
+    Runtime::Buffer<float> pre_faulted((float *)nullptr, W, H);
+    pre_faulted.allocate(nullptr, nullptr, true);
+
+    Func f("f");
+    Var x("x"), y("y");
+    f(x, y) = cast<float>(x + y);
+
+    Buffer<float> out(std::move(pre_faulted));
+    f.realize(out);
+
+    for (int iy = 0; iy < H; iy++) {
+        for (int ix = 0; ix < W; ix++) {
+            if (out(ix, iy) != (float)(ix + iy)) {
+                printf("out(%d, %d) = %f instead of %d\n",
+                       ix, iy, out(ix, iy), ix + iy);
+                return -1;
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
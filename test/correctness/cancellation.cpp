@@ -0,0 +1,92 @@
+#include "Halide.h"
+#include <atomic>
+#include <stdio.h>
+#include <thread>
+
+using namespace Halide;
+
+#ifdef _WIN32
+#define DLLEXPORT __declspec(dllexport)
+#else
+#define DLLEXPORT
+#endif
+
+std::atomic<bool> entered{false};
+std::atomic<bool> released{false};
+
+// Blocks the tasks that start before the cancellation, so the test
+// can cancel a realization that is reliably mid-flight.
+extern "C" DLLEXPORT int block_until_released(int x) {
+    entered = true;
+    while (!released) {
+        std::this_thread::yield();
+    }
+    return x;
+}
+HalideExtern_1(int, block_until_released, int);
+
+std::atomic<bool> error_occurred{false};
+
+void my_error_handler(void *ctx, const char *msg) {
+    printf("Expected: %s\n", msg);
+    error_occurred = true;
+}
+
+int main(int argc, char **argv) {
+    Var x("x"), y("y");
+    Func f("f");
+    f(x, y) = block_until_released(x + y);
+    f.parallel(y);
+
+    Pipeline p(f);
+    p.set_error_handler(&my_error_handler);
+
+    CancellationToken token;
+    Buffer<int> out(64, 64);
+
+    // Cancel the realization from another thread once it is running.
+    std::thread canceller([&]() {
+        while (!entered) {
+            std::this_thread::yield();
+        }
+        token.cancel();
+        released = true;
+    });
+
+    p.realize(out, Target(), ParamMap::empty_map(), &token);
+    canceller.join();
+
+    if (!token.cancelled()) {
+        printf("The token was supposed to be cancelled\n");
+        return -1;
+    }
+
+    if (!error_occurred) {
+        printf("There was supposed to be an error\n");
+        return -1;
+    }
+
+    // After resetting the token, the same pipeline should run to
+    // completion and produce correct output.
+    error_occurred = false;
+    token.reset();
+    p.realize(out, Target(), ParamMap::empty_map(), &token);
+
+    if (error_occurred) {
+        printf("There was not supposed to be an error\n");
+        return -1;
+    }
+
+    for (int yy = 0; yy < out.height(); yy++) {
+        for (int xx = 0; xx < out.width(); xx++) {
+            if (out(xx, yy) != xx + yy) {
+                printf("out(%d, %d) = %d instead of %d\n",
+                       xx, yy, out(xx, yy), xx + yy);
+                return -1;
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
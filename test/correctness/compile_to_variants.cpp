@@ -0,0 +1,90 @@
+#include "Halide.h"
+#include "halide_test_dirs.h"
+
+#include <cstdio>
+
+using namespace Halide;
+
+std::string get_fname(const std::string &base) {
+    return Internal::get_test_tmp_dir() + "halide_test_correctness_compile_to_variants_" + base;
+}
+
+VariantModuleFactory make_factory(Param<float> factor) {
+    return [factor](const std::string &name, const std::string &variant, const Target &target) -> Module {
+        Func f("f");
+        Var x, y, xi, yi;
+        f(x, y) = (x + y) * factor;
+        if (variant == "latency") {
+            // Small strips, all cores.
+            f.parallel(y).vectorize(x, 8);
+        } else {
+            // Big tiles, serial: many instances run in parallel.
+            f.tile(x, y, xi, yi, 64, 64).vectorize(xi, 8);
+        }
+        return f.compile_to_module(f.infer_arguments(), name, target);
+    };
+}
+
+void test_compile_to_object_files(Param<float> factor) {
+    std::string fname = get_fname("c1");
+    const char *o = get_host_target().os == Target::Windows ? ".obj" : ".o";
+
+    std::vector<std::string> variants = {"latency", "throughput"};
+
+    std::vector<std::string> files;
+    files.push_back(fname + ".h");
+    files.push_back(fname + "_runtime" + o);
+    files.push_back(fname + "_wrapper" + o);
+    for (const auto &v : variants) {
+        files.push_back(fname + "-" + v + o);
+    }
+
+    for (const auto &f : files) {
+        Internal::ensure_no_file_exists(f);
+    }
+
+    std::map<Output, std::string> outputs = {
+        {Output::object, fname + o},
+        {Output::c_header, fname + ".h"},
+    };
+    compile_variants(fname, outputs, get_host_target(), variants, make_factory(factor));
+
+    for (const auto &f : files) {
+        Internal::assert_file_exists(f);
+    }
+}
+
+void test_compile_to_static_library(Param<float> factor) {
+    std::string fname = get_fname("c2");
+    const char *a = get_host_target().os == Target::Windows ? ".lib" : ".a";
+
+    std::vector<std::string> variants = {"latency", "throughput"};
+
+    std::vector<std::string> files;
+    files.push_back(fname + ".h");
+    files.push_back(fname + a);
+
+    for (const auto &f : files) {
+        Internal::ensure_no_file_exists(f);
+    }
+
+    std::map<Output, std::string> outputs = {
+        {Output::static_library, fname + a},
+        {Output::c_header, fname + ".h"},
+    };
+    compile_variants(fname, outputs, get_host_target(), variants, make_factory(factor));
+
+    for (const auto &f : files) {
+        Internal::assert_file_exists(f);
+    }
+}
+
+int main(int argc, char **argv) {
+    Param<float> factor("factor");
+
+    test_compile_to_object_files(factor);
+    test_compile_to_static_library(factor);
+
+    printf("Success!\n");
+    return 0;
+}
@@ -1723,6 +1723,66 @@ int update_stage_rfactor_test() {
     return 0;
 }
 
+int update_stage_mismatched_reduction_test() {
+    const int size = 128;
+    const int r_size = 96;
+    const int base = 31;
+
+    Buffer<int> in(size, size);
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            in(x, y) = x * 3 + y;
+        }
+    }
+
+    Buffer<int> f_im(size, size), g_im(size);
+
+    {
+        Var x("x"), y("y");
+        Func f("f"), g("g");
+
+        // Two independent per-channel style traversals of the same
+        // input: a pure stage and a reduction with a shorter extent.
+        f(x, y) = in(x, y) * 2;
+
+        RDom r(0, r_size, "r");
+        g(x) = 0;
+        g(x) += in(x, r) * base;
+
+        f.compute_root();
+        g.compute_root();
+
+        // Fuse the reduction loop over r with f's pure loop over
+        // y. The dims are matched positionally; the fused loop runs
+        // over the union of the two extents with each stage guarded
+        // to its own range.
+        g.update().compute_with(f, y);
+
+        Pipeline p({f, g});
+        p.realize({f_im, g_im});
+    }
+
+    auto f_func = [in](int x, int y) {
+        return in(x, y) * 2;
+    };
+    if (check_image(f_im, f_func)) {
+        return -1;
+    }
+
+    for (int x = 0; x < size; x++) {
+        int correct = 0;
+        for (int r = 0; r < r_size; r++) {
+            correct += in(x, r) * base;
+        }
+        if (g_im(x) != correct) {
+            printf("g_im(%d) = %d instead of %d\n", x, g_im(x), correct);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
 int vectorize_inlined_test() {
     const int f_size = 128;
     const int g_size = 256;
@@ -2142,6 +2202,11 @@ int main(int argc, char **argv) {
         return -1;
     }
 
+    printf("Running update stage mismatched reduction test\n");
+    if (update_stage_mismatched_reduction_test() != 0) {
+        return -1;
+    }
+
     printf("Running vectorize inlined test\n");
     if (vectorize_inlined_test() != 0) {
         return -1;
@@ -0,0 +1,97 @@
+#include "Halide.h"
+#include <chrono>
+#include <stdio.h>
+#include <thread>
+
+using namespace Halide;
+
+#ifdef _WIN32
+#define DLLEXPORT __declspec(dllexport)
+#else
+#define DLLEXPORT
+#endif
+
+// Makes each parallel task slow enough that a small time budget
+// reliably expires while the realization is mid-flight.
+extern "C" DLLEXPORT int sleep_a_bit(int x) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    return x;
+}
+HalideExtern_1(int, sleep_a_bit, int);
+
+std::atomic<bool> error_occurred{false};
+
+void my_error_handler(void *ctx, const char *msg) {
+    printf("Expected: %s\n", msg);
+    error_occurred = true;
+}
+
+int main(int argc, char **argv) {
+    Var x("x"), y("y");
+    Func f("f");
+    f(x, y) = sleep_a_bit(x + y);
+    f.parallel(y);
+
+    Pipeline p(f);
+    p.set_error_handler(&my_error_handler);
+
+    CancellationToken token;
+    Buffer<int> out(16, 64);
+    out.fill(-1);
+
+    // Give the realization far less time than it needs, so it stops
+    // early at a task boundary instead of running to completion.
+    token.set_deadline(1000 * 1000);  // 1ms
+    p.realize(out, Target(), ParamMap::empty_map(), &token);
+
+    if (!error_occurred) {
+        printf("The deadline was supposed to expire\n");
+        return -1;
+    }
+
+    int first_skipped = -1;
+    if (!token.deadline_progress(&first_skipped)) {
+        printf("Some iterations were supposed to be skipped\n");
+        return -1;
+    }
+    if (first_skipped < 0 || first_skipped >= out.height()) {
+        printf("first_skipped = %d is outside the parallel loop\n", first_skipped);
+        return -1;
+    }
+
+    // Every row before the first skipped one completed.
+    for (int yy = 0; yy < first_skipped; yy++) {
+        for (int xx = 0; xx < out.width(); xx++) {
+            if (out(xx, yy) != xx + yy) {
+                printf("out(%d, %d) = %d instead of %d\n",
+                       xx, yy, out(xx, yy), xx + yy);
+                return -1;
+            }
+        }
+    }
+
+    // With the deadline removed and the token reset, the same
+    // pipeline runs to completion.
+    error_occurred = false;
+    token.set_deadline(0);
+    token.reset();
+    p.realize(out, Target(), ParamMap::empty_map(), &token);
+
+    if (error_occurred) {
+        printf("There was not supposed to be an error\n");
+        return -1;
+    }
+
+    for (int yy = 0; yy < out.height(); yy++) {
+        for (int xx = 0; xx < out.width(); xx++) {
+            if (out(xx, yy) != xx + yy) {
+                printf("out(%d, %d) = %d instead of %d\n",
+                       xx, yy, out(xx, yy), xx + yy);
+                return -1;
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,72 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+using namespace Halide::Internal;
+
+namespace {
+
+// Run the false-sharing analysis on the fully lowered pipeline and
+// record any findings against the intermediate "f".
+class CheckFalseSharing : public IRMutator {
+public:
+    using IRMutator::mutate;
+
+    Stmt mutate(const Stmt &s) override {
+        for (const FalseSharingWarning &w : find_false_sharing(s)) {
+            if (w.buffer == "f") {
+                findings++;
+            }
+        }
+        return s;
+    }
+
+    int findings = 0;
+};
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    Var x("x"), y("y");
+
+    // A narrow intermediate computed in parallel over rows: each row
+    // is 16 bytes, so four threads contend on each cache line.
+    {
+        Func f("f"), g("g");
+        f(x, y) = x + y;
+        g(x, y) = f(x, y) * 2;
+        f.compute_root().parallel(y);
+        g.bound(x, 0, 4).bound(y, 0, 64);
+
+        CheckFalseSharing *checker = new CheckFalseSharing;
+        g.add_custom_lowering_pass(checker);
+        g.realize({4, 64});
+
+        if (checker->findings == 0) {
+            printf("The narrow parallel stores were not flagged as false sharing\n");
+            return 1;
+        }
+    }
+
+    // Wide rows cover many cache lines each, so there is nothing to
+    // report.
+    {
+        Func f("f"), g("g");
+        f(x, y) = x + y;
+        g(x, y) = f(x, y) * 2;
+        f.compute_root().parallel(y);
+        g.bound(x, 0, 256).bound(y, 0, 64);
+
+        CheckFalseSharing *checker = new CheckFalseSharing;
+        g.add_custom_lowering_pass(checker);
+        g.realize({256, 64});
+
+        if (checker->findings != 0) {
+            printf("The wide parallel stores were wrongly flagged as false sharing\n");
+            return 1;
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,98 @@
+#include "Halide.h"
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <stdio.h>
+#include <type_traits>
+
+using namespace Halide;
+
+// Use std::mt19937 instead of rand() to ensure consistent behavior on all systems.
+std::mt19937 rng(0);
+
+// Reference division with Halide's round-towards-negative-infinity semantics.
+template<typename T>
+T reference_divide(T num, int64_t den) {
+    int64_t n = num;
+    int64_t q = n / den;
+    if ((n % den != 0) && ((n < 0) != (den < 0))) {
+        q--;
+    }
+    return (T)q;
+}
+
+template<typename T>
+bool test() {
+    typedef typename std::make_unsigned<T>::type UT;
+
+    const int w = 1024;
+    Buffer<T> input(w);
+    for (int x = 0; x < w; x++) {
+        input(x) = (T)rng();
+    }
+
+    Param<UT> divisor;
+    Var x;
+    Func div, mod;
+    div(x) = fast_integer_divide_invariant(input(x), divisor);
+    mod(x) = fast_integer_modulo_invariant(input(x), divisor);
+    div.vectorize(x, 8);
+    mod.vectorize(x, 8);
+    div.compile_jit();
+    mod.compile_jit();
+
+    Buffer<T> div_out(w), mod_out(w);
+
+    // Divisors are restricted to the positive range of the numerator
+    // type, which covers the loop-invariant strides and extents this
+    // is intended for. Division by zero is unspecified, so start at one.
+    const uint64_t max_divisor =
+        std::is_signed<T>::value ? (uint64_t)std::numeric_limits<T>::max() : (uint64_t)std::numeric_limits<UT>::max();
+
+    std::vector<UT> divisors = {1, 2, 3, 4, 5, 7, 9, 16, 100, (UT)max_divisor, (UT)(max_divisor - 1)};
+    for (int i = 0; i < 100; i++) {
+        uint64_t d = ((uint64_t)rng() % max_divisor) + 1;
+        divisors.push_back((UT)d);
+    }
+
+    for (UT d : divisors) {
+        divisor.set(d);
+        div.realize(div_out);
+        mod.realize(mod_out);
+        for (int x = 0; x < w; x++) {
+            T correct_div = reference_divide(input(x), (int64_t)d);
+            T correct_mod = (T)(input(x) - correct_div * (T)d);
+            if (div_out(x) != correct_div) {
+                printf("div(%lld, %llu) = %lld instead of %lld\n",
+                       (long long)input(x), (unsigned long long)d,
+                       (long long)div_out(x), (long long)correct_div);
+                return false;
+            }
+            if (mod_out(x) != correct_mod) {
+                printf("mod(%lld, %llu) = %lld instead of %lld\n",
+                       (long long)input(x), (unsigned long long)d,
+                       (long long)mod_out(x), (long long)correct_mod);
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+int main(int argc, char **argv) {
+    bool success = true;
+    success &= test<uint8_t>();
+    success &= test<int8_t>();
+    success &= test<uint16_t>();
+    success &= test<int16_t>();
+    success &= test<uint32_t>();
+    success &= test<int32_t>();
+
+    if (!success) {
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
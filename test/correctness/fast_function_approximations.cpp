@@ -0,0 +1,87 @@
+#include "Halide.h"
+
+#include <functional>
+
+using namespace Halide;
+
+namespace {
+
+constexpr float ulp = 5.9604644775390625e-8f;  // 2^-24
+
+struct TestCase {
+    const char *name;
+    // Sample range, and whether the error bound is relative or absolute.
+    float lo, hi;
+    bool relative;
+    // Requested tolerances in ulps (0 = default precision), and the
+    // bound the result must actually meet. The default precision must
+    // meet the most accurate approximation's documented bound.
+    int tolerance[3];
+    int bound[3];
+    std::function<Expr(Expr, ApproximationPrecision)> build;
+    std::function<double(double)> ref;
+};
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    TestCase cases[] = {
+        {"fast_exp", -10.f, 10.f, true, {0, 500, 13000}, {50, 500, 13000},
+         [](Expr e, ApproximationPrecision p) { return fast_exp(e, p); },
+         [](double x) { return std::exp(x); }},
+        {"fast_log", 0.01f, 100.f, false, {0, 1250, 8500}, {16, 1250, 8500},
+         [](Expr e, ApproximationPrecision p) { return fast_log(e, p); },
+         [](double x) { return std::log(x); }},
+        {"fast_sin", -10.f, 10.f, false, {0, 16, 500}, {16, 16, 500},
+         [](Expr e, ApproximationPrecision p) { return fast_sin(e, p); },
+         [](double x) { return std::sin(x); }},
+        {"fast_cos", -10.f, 10.f, false, {0, 16, 500}, {16, 16, 500},
+         [](Expr e, ApproximationPrecision p) { return fast_cos(e, p); },
+         [](double x) { return std::cos(x); }},
+        {"fast_tanh", -10.f, 10.f, false, {0, 500, 13000}, {16, 500, 13000},
+         [](Expr e, ApproximationPrecision p) { return fast_tanh(e, p); },
+         [](double x) { return std::tanh(x); }},
+        {"fast_erf", -4.f, 4.f, false, {0, 750, 13000}, {23, 750, 13000},
+         [](Expr e, ApproximationPrecision p) { return fast_erf(e, p); },
+         [](double x) { return std::erf(x); }},
+    };
+
+    const int n = 100000;
+    for (const TestCase &c : cases) {
+        for (int t = 0; t < 3; t++) {
+            ApproximationPrecision precision{c.tolerance[t]};
+
+            Func f;
+            Var x;
+            Expr arg = c.lo + (c.hi - c.lo) * (x / (float)n);
+            f(x) = c.build(arg, precision);
+            f.vectorize(x, 8);
+            Buffer<float> result = f.realize({n + 1});
+
+            float max_err = 0.f;
+            float worst_arg = 0.f;
+            for (int i = 0; i <= n; i++) {
+                float in = c.lo + (c.hi - c.lo) * (i / (float)n);
+                double ref = c.ref(in);
+                float err = (float)std::abs((double)result(i) - ref);
+                if (c.relative) {
+                    err /= (float)std::abs(ref);
+                }
+                if (err > max_err) {
+                    max_err = err;
+                    worst_arg = in;
+                }
+            }
+            if (max_err > c.bound[t] * ulp) {
+                fprintf(stderr,
+                        "%s with tolerance %d ulps: error at %.6f is %.3g, "
+                        "more than the promised %d ulps\n",
+                        c.name, c.tolerance[t], worst_arg, max_err, c.bound[t]);
+                return 1;
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+
+int main(int argc, char **argv) {
+    const int W = 1024;
+
+    Buffer<uint8_t> input(W);
+    for (int x = 0; x < W; x++) {
+        input(x) = (uint8_t)(x * 17 + 3);
+    }
+
+    Var x("x"), i("i");
+
+    // A gamma-ish curve defined algorithmically over a 256-entry
+    // constant domain. This should be evaluated at compile time and
+    // embedded in the object as a static buffer.
+    Func lut("lut");
+    lut(i) = cast<uint8_t>(clamp((i * i) / 255, 0, 255));
+    lut.compute_root();
+
+    Func f("f");
+    f(x) = lut(cast<int>(input(x)));
+
+    Buffer<uint8_t> result = f.realize({W});
+    for (int x = 0; x < W; x++) {
+        int v = input(x);
+        uint8_t correct = (uint8_t)std::min(std::max((v * v) / 255, 0), 255);
+        if (result(x) != correct) {
+            printf("result(%d) = %d instead of %d\n", x, result(x), correct);
+            return -1;
+        }
+    }
+
+    // The LUT should have become an embedded buffer rather than a
+    // runtime-filled allocation.
+    {
+        ImageParam in(UInt(8), 1);
+        Func g("g");
+        g(x) = lut(cast<int>(in(x)));
+        Module m = g.compile_to_module({in}, "g");
+        if (m.buffers().size() != 1) {
+            printf("Expected 1 embedded buffer, got %d\n", (int)m.buffers().size());
+            return -1;
+        }
+    }
+
+    // A LUT that depends on a runtime parameter can't be evaluated at
+    // compile time, and must still be filled at runtime.
+    {
+        ImageParam in(UInt(8), 1);
+        Param<int> gain("gain");
+        Func lut2("lut2"), g("g");
+        lut2(i) = cast<uint8_t>(clamp((i * gain) / 255, 0, 255));
+        lut2.compute_root();
+        g(x) = lut2(cast<int>(in(x)));
+        Module m = g.compile_to_module({in, gain}, "g");
+        if (!m.buffers().empty()) {
+            printf("Expected no embedded buffers, got %d\n", (int)m.buffers().size());
+            return -1;
+        }
+
+        gain.set(2);
+        in.set(input);
+        Buffer<uint8_t> result2 = g.realize({W});
+        for (int x = 0; x < W; x++) {
+            int v = input(x);
+            uint8_t correct = (uint8_t)std::min(std::max((v * 2) / 255, 0), 255);
+            if (result2(x) != correct) {
+                printf("result2(%d) = %d instead of %d\n", x, result2(x), correct);
+                return -1;
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include "Halide.h"
+
+using namespace Halide;
+
+int main(int argc, char **argv) {
+    Target target = get_jit_target_from_environment();
+    if (!target.has_gpu_feature()) {
+        printf("[SKIP] No GPU target enabled.\n");
+        return 0;
+    }
+
+    const int size = 256;
+
+    Var x, y, xo, yo, xi, yi;
+
+    // Two pointwise stages tiled over the same grid of blocks fuse
+    // into one kernel. The results must be unchanged.
+    {
+        Func f, g;
+        f(x, y) = x * 3 + y * 7;
+        g(x, y) = f(x, y) * 2;
+
+        f.compute_root().gpu_tile(x, y, xo, yo, xi, yi, 16, 16).fuse_gpu_stages();
+        g.gpu_tile(x, y, xo, yo, xi, yi, 16, 16);
+
+        Buffer<int> out = g.realize({size, size});
+        for (int iy = 0; iy < size; iy++) {
+            for (int ix = 0; ix < size; ix++) {
+                int correct = (ix * 3 + iy * 7) * 2;
+                if (out(ix, iy) != correct) {
+                    printf("out(%d, %d) = %d instead of %d\n",
+                           ix, iy, out(ix, iy), correct);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    // With mismatched block shapes the directive is quietly ignored,
+    // and the two stages launch separately as usual.
+    {
+        Func f, g;
+        f(x, y) = x + y;
+        g(x, y) = f(x, y) + 1;
+
+        f.compute_root().gpu_tile(x, y, xo, yo, xi, yi, 8, 8).fuse_gpu_stages();
+        g.gpu_tile(x, y, xo, yo, xi, yi, 16, 16);
+
+        Buffer<int> out = g.realize({size, size});
+        for (int iy = 0; iy < size; iy++) {
+            for (int ix = 0; ix < size; ix++) {
+                int correct = ix + iy + 1;
+                if (out(ix, iy) != correct) {
+                    printf("out(%d, %d) = %d instead of %d\n",
+                           ix, iy, out(ix, iy), correct);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,45 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+
+int main(int argc, char **argv) {
+    if (!get_jit_target_from_environment().has_gpu_feature()) {
+        printf("[SKIP] No GPU target enabled.\n");
+        return 0;
+    }
+
+    // Stage 32x32 float tiles into shared memory and read them back
+    // transposed. 32 floats is exactly one trip around the shared
+    // memory banks, so this is the worst case that the bank-conflict
+    // padding in StorageFlattening rewrites. The padding is supposed
+    // to be invisible, so we just check the result is still correct.
+    Func in("in"), out("out");
+    Var x, y, xo, yo, xi, yi;
+
+    in(x, y) = cast<float>(x * 3 + y * 7);
+    out(x, y) = in(y, x) + 1.0f;
+
+    out.tile(x, y, xo, yo, xi, yi, 32, 32)
+        .gpu_blocks(xo, yo)
+        .gpu_threads(xi, yi);
+    in.compute_at(out, xo)
+        .store_in(MemoryType::GPUShared)
+        .gpu_threads(x, y);
+
+    Buffer<float> output = out.realize({256, 256});
+
+    for (int y = 0; y < 256; y++) {
+        for (int x = 0; x < 256; x++) {
+            float correct = y * 3 + x * 7 + 1.0f;
+            if (output(x, y) != correct) {
+                printf("output(%d, %d) = %f instead of %f\n",
+                       x, y, output(x, y), correct);
+                return -1;
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,57 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+
+int main(int argc, char **argv) {
+    Target target = get_jit_target_from_environment();
+    if (!target.has_feature(Target::CUDA)) {
+        printf("[SKIP] CUDA not enabled\n");
+        return 0;
+    }
+    if (target.get_cuda_capability_lower_bound() < 70) {
+        printf("[SKIP] tensor cores require cuda_capability_70 or greater\n");
+        return 0;
+    }
+
+    const int N = 64;
+
+    Buffer<float16_t> A(N, N), B(N, N);
+    for (int y = 0; y < N; y++) {
+        for (int x = 0; x < N; x++) {
+            A(x, y) = (float16_t)((float)(((x + 3) * (y + 7)) % 13) - 6.0f);
+            B(x, y) = (float16_t)((float)(((x + 5) * (y + 11)) % 17) - 8.0f);
+        }
+    }
+
+    Func matmul("matmul");
+    Var x, y, xi, yi;
+    RDom r(0, N);
+    matmul(x, y) = 0.0f;
+    matmul(x, y) += cast<float>(A(r, y)) * cast<float>(B(x, r));
+
+    RVar ri;
+    matmul.gpu_tile(x, y, xi, yi, 16, 16);
+    matmul.update()
+        .gpu_tensor_core(x, y, r, xi, yi, ri)
+        .gpu_blocks(x, y);
+
+    Buffer<float> out = matmul.realize({N, N});
+
+    for (int yy = 0; yy < N; yy++) {
+        for (int xx = 0; xx < N; xx++) {
+            float correct = 0.0f;
+            for (int k = 0; k < N; k++) {
+                correct += (float)A(k, yy) * (float)B(xx, k);
+            }
+            if (out(xx, yy) != correct) {
+                printf("out(%d, %d) = %f instead of %f\n",
+                       xx, yy, out(xx, yy), correct);
+                return 1;
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -85,6 +85,12 @@ void test_copy(Buffer<float> a, Buffer<float> b) {
     auto a_planar = a_interleaved.copy_to_planar();
     assert(a_planar.stride(0) == 1);
     check_equal(a, a_planar);
+
+    // Check the parallel variants of fill and copy_from
+    a.fill(1.0f, 4);
+    assert(a.all_equal(1.0f));
+    a.copy_from(b, 4);
+    check_equal(a_window, b_window);
 }
 
 int main(int argc, char **argv) {
@@ -0,0 +1,57 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+
+int check(Buffer<int> &out) {
+    for (int y = 0; y < out.height(); y++) {
+        for (int x = 0; x < out.width(); x++) {
+            int correct = x + y;
+            if (out(x, y) != correct) {
+                printf("out(%d, %d) = %d instead of %d\n", x, y, out(x, y), correct);
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    Func f("f");
+    Var x("x"), y("y");
+    f(x, y) = x + y;
+
+    Pipeline p(f);
+    p.set_incremental_lowering(true);
+
+    // First compile populates the lowered module cache.
+    Buffer<int> out1 = p.realize({32, 32});
+    if (check(out1) != 0) {
+        return -1;
+    }
+
+    // Recompiling with an unchanged schedule should hit the cache.
+    p.invalidate_cache();
+    Buffer<int> out2 = p.realize({32, 32});
+    if (check(out2) != 0) {
+        return -1;
+    }
+
+    // A schedule change must miss the cache and produce fresh code.
+    f.vectorize(x, 8);
+    p.invalidate_cache();
+    Buffer<int> out3 = p.realize({32, 32});
+    if (check(out3) != 0) {
+        return -1;
+    }
+
+    // ...and revisiting the changed schedule should hit again.
+    p.invalidate_cache();
+    Buffer<int> out4 = p.realize({32, 32});
+    if (check(out4) != 0) {
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
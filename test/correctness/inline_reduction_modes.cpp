@@ -0,0 +1,98 @@
+#include "Halide.h"
+#include <cmath>
+#include <stdio.h>
+
+using namespace Halide;
+
+int main(int argc, char **argv) {
+    const int N = 10000;
+
+    // Alternate a value too large for a float to absorb small
+    // addends with a stream of small addends, so a naive serial
+    // float sum visibly loses precision.
+    Buffer<float> data(N);
+    double reference = 0.0;
+    for (int i = 0; i < N; i++) {
+        data(i) = (i % 2 == 0) ? 1e8f : 1.0f;
+        reference += (double)data(i);
+    }
+
+    RDom r(0, N);
+
+    Func serial, pairwise, compensated;
+    serial() = sum(r, data(r));
+    pairwise() = sum(r, data(r), Reduction::Pairwise);
+    compensated() = sum(r, data(r), Reduction::Compensated);
+
+    Buffer<float> serial_result = serial.realize();
+    Buffer<float> pairwise_result = pairwise.realize();
+    Buffer<float> compensated_result = compensated.realize();
+    double serial_err = std::abs((double)serial_result() - reference);
+    double pairwise_err = std::abs((double)pairwise_result() - reference);
+    double compensated_err = std::abs((double)compensated_result() - reference);
+
+    // Compensated summation should recover the small addends the
+    // naive order drops entirely.
+    if (compensated_err > 64.0) {
+        printf("Compensated sum error too large: %f\n", compensated_err);
+        return 1;
+    }
+    if (compensated_err > serial_err) {
+        printf("Compensated sum (error %f) should not be worse than serial sum (error %f)\n",
+               compensated_err, serial_err);
+        return 1;
+    }
+
+    // Pairwise summation should also beat (or at worst match) the
+    // serial order on this input.
+    if (pairwise_err > serial_err) {
+        printf("Pairwise sum (error %f) should not be worse than serial sum (error %f)\n",
+               pairwise_err, serial_err);
+        return 1;
+    }
+
+    // On benign data all three modes should agree exactly: each
+    // partial sum stays well within the range where float addition
+    // of small integers is exact.
+    Buffer<float> ones(N);
+    ones.fill(1.0f);
+
+    Func serial_ones, pairwise_ones, compensated_ones;
+    serial_ones() = sum(r, ones(r));
+    pairwise_ones() = sum(r, ones(r), Reduction::Pairwise);
+    compensated_ones() = sum(r, ones(r), Reduction::Compensated);
+
+    float expected = (float)N;
+    Buffer<float> serial_ones_result = serial_ones.realize();
+    Buffer<float> pairwise_ones_result = pairwise_ones.realize();
+    Buffer<float> compensated_ones_result = compensated_ones.realize();
+    if (serial_ones_result() != expected ||
+        pairwise_ones_result() != expected ||
+        compensated_ones_result() != expected) {
+        printf("Sum of %d ones was not exactly %f in all modes\n", N, expected);
+        return 1;
+    }
+
+    // Pairwise mode should also work with free variables, multiple
+    // reduction dimensions, and non-float types.
+    Var x;
+    Func g;
+    RDom r2(0, 13, 0, 7);
+    g(x) = sum(r2, cast<int32_t>(x + r2.x + r2.y), Reduction::Pairwise);
+    Buffer<int32_t> result = g.realize({10});
+    for (int i = 0; i < 10; i++) {
+        int32_t correct = 0;
+        for (int ry = 0; ry < 7; ry++) {
+            for (int rx = 0; rx < 13; rx++) {
+                correct += i + rx + ry;
+            }
+        }
+        if (result(i) != correct) {
+            printf("result(%d) = %d instead of %d\n", i, result(i), correct);
+            return 1;
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,70 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+
+int check(Buffer<int> out) {
+    for (int y = 0; y < out.height(); y++) {
+        for (int x = 0; x < out.width(); x++) {
+            int correct = (x + y) * 2 + 1;
+            if (out(x, y) != correct) {
+                printf("out(%d, %d) = %d instead of %d\n", x, y, out(x, y), correct);
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    Var x, y;
+    Func g, f;
+    g(x, y) = (x + y) * 2;
+    f(x, y) = g(x, y) + 1;
+    g.compute_root();
+
+    // Bound the output so the intermediate's allocation is static.
+    f.bound(x, 0, 128).bound(y, 0, 128);
+
+    Pipeline p(f);
+
+    // The intermediate has static bounds, so the footprint should be
+    // computable and at least as large as g's data.
+    uint64_t footprint = p.infer_intermediate_footprint();
+    const uint64_t min_expected = 128 * 128 * sizeof(int);
+    if (footprint < min_expected) {
+        printf("infer_intermediate_footprint returned %llu; expected at least %llu\n",
+               (unsigned long long)footprint, (unsigned long long)min_expected);
+        return 1;
+    }
+
+    std::vector<uint8_t> arena(footprint);
+    p.set_jit_workspace(arena.data(), arena.size());
+
+    // Repeated realizations should reuse the workspace and stay correct.
+    for (int i = 0; i < 3; i++) {
+        Buffer<int> out = p.realize({128, 128});
+        if (check(out)) {
+            return 1;
+        }
+    }
+
+    if (Pipeline::jit_workspace_peak() < min_expected) {
+        printf("jit_workspace_peak is %llu; expected at least %llu\n",
+               (unsigned long long)Pipeline::jit_workspace_peak(),
+               (unsigned long long)min_expected);
+        return 1;
+    }
+
+    // An undersized workspace must fall back to the system allocator,
+    // not produce wrong results.
+    std::vector<uint8_t> tiny(256);
+    p.set_jit_workspace(tiny.data(), tiny.size());
+    Buffer<int> out = p.realize({128, 128});
+    if (check(out)) {
+        return 1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
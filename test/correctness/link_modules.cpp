@@ -0,0 +1,50 @@
+#include "Halide.h"
+#include "halide_test_dirs.h"
+
+#include <cstdio>
+
+using namespace Halide;
+
+int main(int argc, char **argv) {
+    Target target = get_target_from_environment();
+    Var x("x");
+
+    // A small callee pipeline, compiled with internal linkage so the
+    // optimizer is free to inline it into its caller and drop the
+    // standalone definition.
+    Func callee("small_callee");
+    callee(x) = cast<int32_t>(x * 2);
+    Module callee_module =
+        callee.pipeline().compile_to_module({}, "small_callee", target,
+                                            LinkageType::Internal);
+
+    // A caller that reaches the callee through a define_extern
+    // boundary, the way composed microkernel pipelines call each
+    // other.
+    Func wrapper("wrapper"), caller("caller");
+    wrapper.define_extern("small_callee", {}, Int(32), 1);
+    caller(x) = wrapper(x) + 1;
+    wrapper.compute_root();
+    Module caller_module =
+        caller.pipeline().compile_to_module({}, "caller", target);
+
+    Module linked = link_modules("linked", {callee_module, caller_module});
+
+    if (linked.functions().size() !=
+        callee_module.functions().size() + caller_module.functions().size()) {
+        printf("Linked module has %d functions instead of %d\n",
+               (int)linked.functions().size(),
+               (int)(callee_module.functions().size() + caller_module.functions().size()));
+        return -1;
+    }
+
+    // The linked module should compile to a single object, with the
+    // callee visible to the caller's optimization.
+    std::string object_file = Internal::get_test_tmp_dir() + "link_modules.o";
+    Internal::ensure_no_file_exists(object_file);
+    linked.compile({{Output::object, object_file}});
+    Internal::assert_file_exists(object_file);
+
+    printf("Success!\n");
+    return 0;
+}
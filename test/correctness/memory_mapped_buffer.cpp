@@ -0,0 +1,65 @@
+#include "Halide.h"
+#include "halide_test_dirs.h"
+
+#include <cassert>
+#include <cstdio>
+
+using namespace Halide;
+
+int main(int argc, char **argv) {
+#ifdef _WIN32
+    printf("[SKIP] Skipping test on Windows, as it requires mmap.\n");
+    return 0;
+#else
+    const int width = 100, height = 60;
+    const uint64_t header_bytes = 8;
+
+    // Write a raw file: a small header followed by densely-packed
+    // int32 data in row-major order.
+    std::string filename = Internal::get_test_tmp_dir() + "memory_mapped_buffer.bin";
+    Internal::ensure_no_file_exists(filename);
+    {
+        FILE *f = fopen(filename.c_str(), "wb");
+        assert(f);
+        int32_t header[2] = {width, height};
+        fwrite(header, sizeof(int32_t), 2, f);
+        for (int iy = 0; iy < height; iy++) {
+            for (int ix = 0; ix < width; ix++) {
+                int32_t v = ix * 5 + iy * 3;
+                fwrite(&v, sizeof(int32_t), 1, f);
+            }
+        }
+        fclose(f);
+    }
+
+    // Map the data section of the file instead of reading it into an
+    // allocation, and feed it to a pipeline as an input.
+    Buffer<int32_t> input(
+        Runtime::Buffer<int32_t>::make_memory_mapped(
+            filename.c_str(), {width, height},
+            Runtime::FileMappingHint::Sequential, header_bytes),
+        "input");
+
+    ImageParam in(Int(32), 2, "in");
+    in.set(input);
+
+    Func f("f");
+    Var x("x"), y("y");
+    f(x, y) = in(x, y) * 2 + 1;
+
+    Buffer<int32_t> out = f.realize({width, height});
+    for (int iy = 0; iy < height; iy++) {
+        for (int ix = 0; ix < width; ix++) {
+            int correct = (ix * 5 + iy * 3) * 2 + 1;
+            if (out(ix, iy) != correct) {
+                printf("out(%d, %d) = %d instead of %d\n",
+                       ix, iy, out(ix, iy), correct);
+                return 1;
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+#endif
+}
@@ -0,0 +1,53 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+
+int main(int argc, char **argv) {
+    Target target = get_jit_target_from_environment();
+    if (!target.has_feature(Target::Metal)) {
+        printf("[SKIP] Metal not enabled\n");
+        return 0;
+    }
+
+    const int N = 64;
+
+    Buffer<float> A(N, N), B(N, N);
+    for (int y = 0; y < N; y++) {
+        for (int x = 0; x < N; x++) {
+            A(x, y) = (float)(((x + 3) * (y + 7)) % 13) - 6.0f;
+            B(x, y) = (float)(((x + 5) * (y + 11)) % 17) - 8.0f;
+        }
+    }
+
+    Func matmul("matmul");
+    Var x, y, xi, yi;
+    RDom r(0, N);
+    matmul(x, y) = 0.0f;
+    matmul(x, y) += A(r, y) * B(x, r);
+
+    RVar ri;
+    matmul.gpu_tile(x, y, xi, yi, 8, 8);
+    matmul.update()
+        .metal_simdgroup_tile(x, y, r, xi, yi, ri)
+        .gpu_blocks(x, y);
+
+    Buffer<float> out = matmul.realize({N, N});
+
+    for (int yy = 0; yy < N; yy++) {
+        for (int xx = 0; xx < N; xx++) {
+            float correct = 0.0f;
+            for (int k = 0; k < N; k++) {
+                correct += A(k, yy) * B(xx, k);
+            }
+            if (out(xx, yy) != correct) {
+                printf("out(%d, %d) = %f instead of %f\n",
+                       xx, yy, out(xx, yy), correct);
+                return 1;
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,60 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+
+int main(int argc, char **argv) {
+    const int W = 256;
+
+    // Two 4-bit values packed per byte, low nibble first.
+    Buffer<uint8_t> packed(W / 2);
+    for (int i = 0; i < W / 2; i++) {
+        packed(i) = (uint8_t)(((i * 7 + 3) & 0x0f) | ((i * 13 + 5) << 4));
+    }
+
+    Var x("x");
+
+    // Unsigned unpack: nibbles are zero-extended.
+    {
+        Func unpacked("unpacked_u4");
+        unpacked(x) = select((x % 2) == 0,
+                             extract_low_nibble(packed(x / 2)),
+                             extract_high_nibble(packed(x / 2)));
+        unpacked.vectorize(x, 16);
+        Buffer<uint8_t> result = unpacked.realize({W});
+        for (int i = 0; i < W; i++) {
+            uint8_t byte = packed(i / 2);
+            uint8_t correct = (i % 2) == 0 ? (byte & 0x0f) : (byte >> 4);
+            if (result(i) != correct) {
+                printf("unsigned result(%d) = %d instead of %d\n",
+                       i, result(i), correct);
+                return 1;
+            }
+        }
+    }
+
+    // Signed unpack: nibbles are sign-extended, so values in [-8, 7]
+    // round-trip.
+    {
+        Func unpacked("unpacked_i4");
+        Expr byte = cast<int8_t>(packed(x / 2));
+        unpacked(x) = select((x % 2) == 0,
+                             extract_low_nibble(byte),
+                             extract_high_nibble(byte));
+        unpacked.vectorize(x, 16);
+        Buffer<int8_t> result = unpacked.realize({W});
+        for (int i = 0; i < W; i++) {
+            uint8_t byte = packed(i / 2);
+            int nibble = (i % 2) == 0 ? (byte & 0x0f) : (byte >> 4);
+            int correct = nibble >= 8 ? nibble - 16 : nibble;
+            if (result(i) != correct) {
+                printf("signed result(%d) = %d instead of %d\n",
+                       i, result(i), correct);
+                return 1;
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,128 @@
+#include "Halide.h"
+#include <random>
+#include <stdio.h>
+#include <vector>
+
+using namespace Halide;
+
+int scalar_sum_test() {
+    const int size = 1 << 16;
+
+    Buffer<int> in(size);
+    // Use std::mt19937 instead of rand() to ensure consistent behavior
+    // on all systems.
+    std::mt19937 rng(0);
+    uint64_t reference = 0;
+    for (int i = 0; i < size; i++) {
+        in(i) = rng() % 1000;
+        reference += in(i);
+    }
+
+    Func f("f");
+    Var u("u");
+    RDom r(0, size);
+    f() = cast<uint64_t>(0);
+    f() += cast<uint64_t>(in(r));
+
+    // A constant task count much larger than the arity of the combine
+    // tree, so the partial results get merged with a tree of parallel
+    // reductions.
+    f.update().parallel_reduce(r, u, 64);
+
+    Buffer<uint64_t> out = f.realize();
+    if (out() != reference) {
+        printf("Scalar sum was %llu instead of %llu\n",
+               (unsigned long long)out(), (unsigned long long)reference);
+        return -1;
+    }
+    return 0;
+}
+
+int histogram_test() {
+    const int w = 500, h = 300;
+
+    Buffer<uint8_t> in(w, h);
+    std::mt19937 rng(0);
+    int reference[256];
+    for (int i = 0; i < 256; i++) {
+        reference[i] = 0;
+    }
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            in(x, y) = rng() & 0xff;
+            reference[in(x, y)] += 1;
+        }
+    }
+
+    Func hist("hist");
+    Var x("x"), u("u");
+    RDom r(0, w, 0, h);
+    hist(x) = 0;
+    hist(clamp(cast<int>(in(r.x, r.y)), 0, 255)) += 1;
+
+    // Each task gets its own 256-bucket histogram, padded out to cache
+    // lines so the tasks don't falsely share buckets.
+    hist.update().parallel_reduce(r.y, u, 16);
+
+    Buffer<int> out = hist.realize({256});
+    for (int i = 0; i < 256; i++) {
+        if (out(i) != reference[i]) {
+            printf("Histogram bucket %d was %d instead of %d\n",
+                   i, out(i), reference[i]);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int dynamic_task_count_test() {
+    const int w = 100, h = 1000;
+
+    Buffer<int> in(w, h);
+    std::mt19937 rng(0);
+    std::vector<int> reference(w, 0);
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            in(x, y) = rng() % 1000;
+            reference[x] += in(x, y);
+        }
+    }
+
+    Func f("f");
+    Var x("x"), u("u");
+    RDom r(0, h);
+    f(x) = 0;
+    f(x) += in(x, r);
+
+    // A task count that isn't known until runtime. The partial results
+    // are still computed in parallel, but merged with a single serial
+    // loop rather than a tree.
+    Param<int> num_tasks;
+    f.update().parallel_reduce(r, u, num_tasks);
+
+    num_tasks.set(7);
+    Buffer<int> out = f.realize({w});
+    for (int i = 0; i < w; i++) {
+        if (out(i) != reference[i]) {
+            printf("Column sum %d was %d instead of %d\n",
+                   i, out(i), reference[i]);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (scalar_sum_test() != 0) {
+        return -1;
+    }
+    if (histogram_test() != 0) {
+        return -1;
+    }
+    if (dynamic_task_count_test() != 0) {
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
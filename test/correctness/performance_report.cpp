@@ -0,0 +1,34 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+
+int main(int argc, char **argv) {
+    {
+        // A pipeline with a reasonable mix of stages: a stencil chain
+        // reading from an ImageParam, and a histogram with an update
+        // definition.
+        ImageParam in(Float(32), 2);
+        Func blur_x("blur_x"), blur_y("blur_y"), hist("hist");
+        Var x("x"), y("y");
+        RDom r(0, 1024, 0, 1024, "r");
+
+        blur_x(x, y) = (in(x, y) + in(x + 1, y) + in(x + 2, y)) / 3.0f;
+        blur_y(x, y) = (blur_x(x, y) + blur_x(x, y + 1) + blur_x(x, y + 2)) / 3.0f;
+
+        hist(x) = 0;
+        hist(clamp(cast<int>(blur_y(r.x, r.y) * 255.0f), 0, 255)) += 1;
+
+        in.set_estimates({{0, 1026}, {0, 1026}});
+        blur_y.set_estimate(x, 0, 1024).set_estimate(y, 0, 1024);
+        hist.set_estimate(x, 0, 256);
+
+        Pipeline p({blur_y, hist});
+        p.print_performance_report();
+
+        // With a last-level cache far smaller than the working sets.
+        p.print_performance_report(MachineParams(16, 1024, 40));
+    }
+    printf("Success!\n");
+    return 0;
+}
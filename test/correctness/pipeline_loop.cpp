@@ -0,0 +1,81 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+
+int main(int argc, char **argv) {
+    {
+        // A producer computed inside the consumer's loop, so the loop
+        // body has a produce and a consume statement to rotate into
+        // two pipeline stages.
+        Func f("f"), g("g");
+        Var x("x");
+
+        f(x) = x * x;
+        g(x) = f(x) + f(x + 1);
+
+        f.compute_at(g, x);
+        g.pipeline_loop(x, 2);
+
+        Buffer<int> out = g.realize({100});
+        for (int i = 0; i < out.width(); i++) {
+            int correct = i * i + (i + 1) * (i + 1);
+            if (out(i) != correct) {
+                printf("out(%d) = %d instead of %d\n", i, out(i), correct);
+                return -1;
+            }
+        }
+    }
+
+    {
+        // Two producers make three top-level statements. Also check
+        // that rotating an inner loop of a 2D schedule is harmless.
+        Func f("f"), h("h"), g("g");
+        Var x("x"), y("y");
+
+        f(x, y) = x + y;
+        h(x, y) = x * y;
+        g(x, y) = f(x, y) + h(x + 1, y);
+
+        f.compute_at(g, x);
+        h.compute_at(g, x);
+        g.pipeline_loop(x, 3);
+
+        Buffer<int> out = g.realize({64, 64});
+        for (int yy = 0; yy < out.height(); yy++) {
+            for (int xx = 0; xx < out.width(); xx++) {
+                int correct = (xx + yy) + (xx + 1) * yy;
+                if (out(xx, yy) != correct) {
+                    printf("out(%d, %d) = %d instead of %d\n",
+                           xx, yy, out(xx, yy), correct);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    {
+        // More stages requested than the body has statements; the
+        // extra stages should just be dropped.
+        Func f("f"), g("g");
+        Var x("x");
+
+        f(x) = 3 * x;
+        g(x) = f(x) + 1;
+
+        f.compute_at(g, x);
+        g.pipeline_loop(x, 4);
+
+        Buffer<int> out = g.realize({50});
+        for (int i = 0; i < out.width(); i++) {
+            int correct = 3 * i + 1;
+            if (out(i) != correct) {
+                printf("out(%d) = %d instead of %d\n", i, out(i), correct);
+                return -1;
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,95 @@
+#include "Halide.h"
+
+using namespace Halide;
+
+int main(int argc, char **argv) {
+    const int size = 1000;
+
+    Var x, y;
+
+    Buffer<uint8_t> input(size, size);
+    for (int iy = 0; iy < size; iy++) {
+        for (int ix = 0; ix < size; ix++) {
+            input(ix, iy) = (uint8_t)(ix * 7 + iy * 13);
+        }
+    }
+
+    auto at = [&](int ix, int iy) {
+        ix = std::max(std::min(ix, size - 1), 0);
+        return input(ix, iy);
+    };
+
+    // A hand-written boundary condition. The interior is handled by
+    // loop partitioning; the edge loops exercise the clamped-load
+    // rewrite on targets with masked loads, and the plain gather
+    // elsewhere. Either way the results must agree with a scalar
+    // reference.
+    {
+        Func f;
+        f(x, y) = cast<uint16_t>(input(clamp(x - 1, 0, size - 1), y)) +
+                  cast<uint16_t>(input(clamp(x + 2, 0, size - 1), y));
+        f.vectorize(x, 16, TailStrategy::GuardWithIf);
+
+        Buffer<uint16_t> out = f.realize({size, size});
+        for (int iy = 0; iy < size; iy++) {
+            for (int ix = 0; ix < size; ix++) {
+                uint16_t correct = (uint16_t)(at(ix - 1, iy) + at(ix + 2, iy));
+                if (out(ix, iy) != correct) {
+                    printf("out(%d, %d) = %d instead of %d\n",
+                           ix, iy, out(ix, iy), correct);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    // A clamp whose bounds cross (empty range). Every lane reads the
+    // same degenerate location; the rewrite must preserve that.
+    {
+        Func f;
+        f(x) = input(clamp(x, 20, 10), 0);
+        f.vectorize(x, 8);
+
+        Buffer<uint8_t> out = f.realize({64});
+        for (int ix = 0; ix < 64; ix++) {
+            int idx = std::max(std::min(ix, 10), 20);
+            if (out(ix) != input(idx, 0)) {
+                printf("out(%d) = %d instead of %d\n", ix, out(ix), input(idx, 0));
+                return -1;
+            }
+        }
+    }
+
+    // An interior crop: the realized region never engages either
+    // clamp, and the input is sized to cover only the region bounds
+    // inference asks for. The rewrite must not dereference the clamp
+    // bounds themselves, which lie well outside the allocation here.
+    {
+        const int min = 200, extent = 41;
+        Buffer<uint8_t> small(extent + 3);
+        small.set_min(min - 1);
+        for (int ix = min - 1; ix < min + extent + 2; ix++) {
+            small(ix) = (uint8_t)(ix * 5 + 1);
+        }
+
+        Func f;
+        f(x) = cast<uint16_t>(small(clamp(x - 1, 0, size - 1))) +
+               cast<uint16_t>(small(clamp(x + 2, 0, size - 1)));
+        f.vectorize(x, 16, TailStrategy::GuardWithIf);
+
+        Buffer<uint16_t> out(extent);
+        out.set_min(min);
+        f.realize(out);
+        for (int ix = min; ix < min + extent; ix++) {
+            uint16_t correct = (uint16_t)((uint8_t)((ix - 1) * 5 + 1) +
+                                          (uint8_t)((ix + 2) * 5 + 1));
+            if (out(ix) != correct) {
+                printf("out(%d) = %d instead of %d\n", ix, out(ix), correct);
+                return -1;
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -79,7 +79,7 @@ int test1(const Target &t) {
     CollectPrefetches collect;
     m.functions()[0].body.accept(&collect);
 
-    vector<vector<Expr>> expected = {{Variable::make(Handle(), f.name()), 0, 1, get_stride(t, 4)}};
+    vector<vector<Expr>> expected = {{Variable::make(Handle(), f.name()), 0, 0, 3, 1, get_stride(t, 4)}};
     if (!check(expected, collect.prefetches)) {
         return -1;
     }
@@ -103,7 +103,7 @@ int test2(const Target &t) {
     CollectPrefetches collect;
     m.functions()[0].body.accept(&collect);
 
-    vector<vector<Expr>> expected = {{Variable::make(Handle(), f.name()), 0, 1, get_stride(t, 4)}};
+    vector<vector<Expr>> expected = {{Variable::make(Handle(), f.name()), 0, 0, 3, 1, get_stride(t, 4)}};
     if (!check(expected, collect.prefetches)) {
         return -1;
     }
@@ -127,7 +127,7 @@ int test3(const Target &t) {
     CollectPrefetches collect;
     m.functions()[0].body.accept(&collect);
 
-    vector<vector<Expr>> expected = {{Variable::make(Handle(), f.name()), 0, 1, get_stride(t, 4)}};
+    vector<vector<Expr>> expected = {{Variable::make(Handle(), f.name()), 0, 0, 3, 1, get_stride(t, 4)}};
     if (!check(expected, collect.prefetches)) {
         return -1;
     }
@@ -159,6 +159,119 @@ int test4(const Target &t) {
     return 0;
 }
 
+class CountDistanceCalls : public IRVisitor {
+private:
+    using IRVisitor::visit;
+
+    void visit(const Call *op) override {
+        if (op->name == "halide_prefetch_distance") {
+            count++;
+        }
+        IRVisitor::visit(op);
+    }
+
+public:
+    int count = 0;
+};
+
+int test5(const Target &t) {
+    Func f("f"), g("g");
+    Var x("x");
+
+    f(x) = x;
+    g(x) = f(x) + f(x + 1);
+
+    f.compute_root();
+    g.prefetch_adaptive(f, x, 4);
+
+    // The prefetch distance should be fetched from the runtime rather
+    // than baked into the loop body.
+    Module m = g.compile_to_module({});
+    CountDistanceCalls count_calls;
+    m.functions()[0].body.accept(&count_calls);
+    if (count_calls.count == 0) {
+        std::cout << "Expected a call to halide_prefetch_distance\n";
+        return -1;
+    }
+
+    // And the pipeline should still compute the right thing when run.
+    Buffer<int> out = g.realize({128});
+    for (int i = 0; i < out.width(); i++) {
+        int correct = 2 * i + 1;
+        if (out(i) != correct) {
+            std::cout << "out(" << i << ") = " << out(i)
+                      << " instead of " << correct << "\n";
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int test6(const Target &t) {
+    // A 2D prefetch of a multi-byte type with a strided innermost
+    // access, to exercise the strided lowering in SplitPrefetch.
+    ImageParam in(Int(32), 2);
+    Func g("g");
+    Var x("x"), y("y");
+
+    g(x, y) = in(2 * x, y) + in(2 * x + 1, y);
+    g.prefetch(in, y, 1);
+
+    Buffer<int> input(64, 32);
+    for (int iy = 0; iy < input.height(); iy++) {
+        for (int ix = 0; ix < input.width(); ix++) {
+            input(ix, iy) = ix * 3 + iy * 7;
+        }
+    }
+    in.set(input);
+
+    Buffer<int> out = g.realize({32, 32});
+    for (int iy = 0; iy < out.height(); iy++) {
+        for (int ix = 0; ix < out.width(); ix++) {
+            int correct = input(2 * ix, iy) + input(2 * ix + 1, iy);
+            if (out(ix, iy) != correct) {
+                std::cout << "out(" << ix << ", " << iy << ") = " << out(ix, iy)
+                          << " instead of " << correct << "\n";
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+int test7(const Target &t) {
+    Func f("f"), g("g");
+    Var x("x");
+
+    f(x) = x;
+    g(x) = f(0);
+
+    f.compute_root();
+    g.prefetch(f, x, 8, PrefetchBoundStrategy::GuardWithIf,
+               PrefetchLocality::NTA, /* for_write */ true);
+
+    // The read/write and locality hints should be carried through to the
+    // prefetch intrinsic args (rw = 1, locality = 0 for non-temporal).
+    Module m = g.compile_to_module({});
+    CollectPrefetches collect;
+    m.functions()[0].body.accept(&collect);
+
+    vector<vector<Expr>> expected = {{Variable::make(Handle(), f.name()), 0, 1, 0, 1, get_stride(t, 4)}};
+    if (!check(expected, collect.prefetches)) {
+        return -1;
+    }
+
+    // And the pipeline should still compute the right thing when run.
+    Buffer<int> out = g.realize({128});
+    for (int i = 0; i < out.width(); i++) {
+        if (out(i) != 0) {
+            std::cout << "out(" << i << ") = " << out(i) << " instead of 0\n";
+            return -1;
+        }
+    }
+    return 0;
+}
+
 }  // anonymous namespace
 
 int main(int argc, char **argv) {
@@ -180,6 +293,18 @@ int main(int argc, char **argv) {
     if (test4(t) != 0) {
         return -1;
     }
+    printf("Running prefetch test5\n");
+    if (test5(t) != 0) {
+        return -1;
+    }
+    printf("Running prefetch test6\n");
+    if (test6(t) != 0) {
+        return -1;
+    }
+    printf("Running prefetch test7\n");
+    if (test7(t) != 0) {
+        return -1;
+    }
 
     printf("Success!\n");
     return 0;
@@ -0,0 +1,62 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+
+int main(int argc, char **argv) {
+    // A parallel histogram with an associative atomic update. The
+    // privatization lowering should turn the contended atomic adds into
+    // per-task private copies plus a merge; either way the counts must
+    // come out exact.
+    const int W = 1024, H = 512, bins = 256;
+
+    Buffer<uint8_t> in(W, H);
+    std::vector<int> reference(bins, 0);
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            in(x, y) = (uint8_t)((x * 7 + y * 13) % bins);
+            reference[in(x, y)]++;
+        }
+    }
+
+    Func hist("hist");
+    Var x;
+    RDom r(0, W, 0, H);
+    hist(x) = 0;
+    hist(clamp(cast<int>(in(r.x, r.y)), 0, bins - 1)) += 1;
+    hist.update().atomic().parallel(r.y);
+
+    Buffer<int> out = hist.realize({bins});
+    for (int i = 0; i < bins; i++) {
+        if (out(i) != reference[i]) {
+            printf("out(%d) = %d instead of %d\n", i, out(i), reference[i]);
+            return 1;
+        }
+    }
+
+    // A min-reduction through the same path
+    Func lowest("lowest");
+    lowest(x) = 255;
+    lowest(clamp(cast<int>(in(r.x, r.y)) % 16, 0, 15)) =
+        min(lowest(clamp(cast<int>(in(r.x, r.y)) % 16, 0, 15)), cast<int>(in(r.x, r.y)));
+    lowest.update().atomic().parallel(r.y);
+
+    std::vector<int> reference_min(16, 255);
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            int bin = in(x, y) % 16;
+            reference_min[bin] = std::min(reference_min[bin], (int)in(x, y));
+        }
+    }
+
+    Buffer<int> out_min = lowest.realize({16});
+    for (int i = 0; i < 16; i++) {
+        if (out_min(i) != reference_min[i]) {
+            printf("out_min(%d) = %d instead of %d\n", i, out_min(i), reference_min[i]);
+            return 1;
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
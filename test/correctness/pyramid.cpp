@@ -0,0 +1,105 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+
+namespace {
+
+// Reference implementation of the pyramid's [1 3 3 1]/8 downsampling.
+float input_val(int x, int y) {
+    return (float)((x * 5 + y * 3) % 13) - 6.0f;
+}
+
+float level_val(int j, int x, int y);
+
+float downx_val(int j, int x, int y) {
+    return (level_val(j, 2 * x - 1, y) +
+            3 * (level_val(j, 2 * x, y) + level_val(j, 2 * x + 1, y)) +
+            level_val(j, 2 * x + 2, y)) /
+           8;
+}
+
+float level_val(int j, int x, int y) {
+    if (j == 0) {
+        return input_val(x, y);
+    }
+    return (downx_val(j - 1, x, 2 * y - 1) +
+            3 * (downx_val(j - 1, x, 2 * y) + downx_val(j - 1, x, 2 * y + 1)) +
+            downx_val(j - 1, x, 2 * y + 2)) /
+           8;
+}
+
+int check_level(Buffer<float> &out, int j) {
+    for (int y = 0; y < out.height(); y++) {
+        for (int x = 0; x < out.width(); x++) {
+            float correct = level_val(j, x, y);
+            if (fabs(out(x, y) - correct) > 1e-4f) {
+                printf("level %d out(%d, %d) = %f instead of %f\n",
+                       j, x, y, out(x, y), correct);
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    Var x("x"), y("y");
+    Func in("in");
+    in(x, y) = cast<float>((x * 5 + y * 3) % 13) - 6.0f;
+
+    // Unscheduled: each level should match the reference stencil.
+    {
+        Pyramid pyr(in, 3);
+        for (int j = 1; j < pyr.levels(); j++) {
+            Buffer<float> out = pyr[j].realize({32 >> j, 32 >> j});
+            if (check_level(out, j) != 0) {
+                return -1;
+            }
+        }
+    }
+
+    // The fused CPU preset should produce the same coarsest level.
+    {
+        Pyramid pyr(in, 3);
+        pyr.schedule_cpu(4, 8);
+        Buffer<float> out = pyr[2].realize({8, 8});
+        if (check_level(out, 2) != 0) {
+            return -1;
+        }
+    }
+
+    // The GPU preset, when a GPU is available.
+    if (get_jit_target_from_environment().has_gpu_feature()) {
+        Pyramid pyr(in, 3);
+        pyr.schedule_gpu();
+        Buffer<float> out = pyr[2].realize({8, 8});
+        if (check_level(out, 2) != 0) {
+            return -1;
+        }
+    }
+
+    // Upsampling should be the inverse resampling: bilinear interpolation.
+    {
+        Func up = Pyramid::upsample(in);
+        Buffer<float> out = up.realize({16, 16});
+        for (int iy = 0; iy < out.height(); iy++) {
+            for (int ix = 0; ix < out.width(); ix++) {
+                float wx = ((ix % 2) * 2 + 1) / 4.0f;
+                float wy = ((iy % 2) * 2 + 1) / 4.0f;
+                float x0 = input_val(ix / 2, iy / 2) * (1 - wx) + input_val((ix + 1) / 2, iy / 2) * wx;
+                float x1 = input_val(ix / 2, (iy + 1) / 2) * (1 - wx) + input_val((ix + 1) / 2, (iy + 1) / 2) * wx;
+                float correct = x0 * (1 - wy) + x1 * wy;
+                if (fabs(out(ix, iy) - correct) > 1e-4f) {
+                    printf("up(%d, %d) = %f instead of %f\n", ix, iy, out(ix, iy), correct);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
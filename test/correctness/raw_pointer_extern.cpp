@@ -0,0 +1,61 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+
+#ifdef _WIN32
+#define DLLEXPORT __declspec(dllexport)
+#else
+#define DLLEXPORT
+#endif
+
+// With the raw-pointer extern ABI the stage receives, for each buffer,
+// a host pointer pre-resolved to the min of the required region
+// followed by an extent and stride per dimension, instead of a
+// halide_buffer_t. There is no bounds query mode; the proxy expression
+// passed to raw_pointer_extern covers that.
+extern "C" DLLEXPORT int raw_plus_one(const uint16_t *src,
+                                      int src_extent_x, int src_stride_x,
+                                      int src_extent_y, int src_stride_y,
+                                      uint16_t *dst,
+                                      int dst_extent_x, int dst_stride_x,
+                                      int dst_extent_y, int dst_stride_y) {
+    assert(src_extent_x >= dst_extent_x && src_extent_y >= dst_extent_y);
+    for (int y = 0; y < dst_extent_y; y++) {
+        for (int x = 0; x < dst_extent_x; x++) {
+            dst[y * dst_stride_y + x * dst_stride_x] =
+                (uint16_t)(src[y * src_stride_y + x * src_stride_x] + 1);
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    Var x("x"), y("y");
+
+    Func source("source");
+    source(x, y) = cast<uint16_t>(x * 3 + y * 7);
+    source.compute_root();
+
+    Func f("f");
+    f.define_extern("raw_plus_one", {source}, UInt(16), {x, y});
+    // The proxy expression tells bounds inference which region of the
+    // input each output region requires.
+    f.raw_pointer_extern(source(x, y));
+
+    Buffer<uint16_t> result = f.realize({128, 64});
+
+    for (int yy = 0; yy < result.height(); yy++) {
+        for (int xx = 0; xx < result.width(); xx++) {
+            uint16_t correct = (uint16_t)(xx * 3 + yy * 7 + 1);
+            if (result(xx, yy) != correct) {
+                printf("result(%d, %d) = %d instead of %d\n",
+                       xx, yy, result(xx, yy), correct);
+                return -1;
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
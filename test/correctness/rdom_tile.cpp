@@ -0,0 +1,67 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+
+bool check(int size, int factor) {
+    Buffer<uint8_t> in(size);
+    for (int i = 0; i < size; i++) {
+        in(i) = (uint8_t)(i * 7 + 3);
+    }
+
+    const int out_size = 16;
+    Var x("x");
+
+    // An order-sensitive reduction (a Horner-style polynomial), so a
+    // tiling bug that reorders, drops, or repeats iterations changes
+    // the result.
+
+    // Reference: the untiled schedule.
+    Func ref("ref");
+    RDom r1(0, size, "r1");
+    ref(x) = cast<uint32_t>(0);
+    ref(x) = ref(x) * 3 + in(r1) + cast<uint32_t>(x);
+    Buffer<uint32_t> ref_out = ref.realize({out_size});
+
+    // The same reduction with the RDom tiled, and the update
+    // scheduled further through the usual Stage interface.
+    Func f("f");
+    RDom r2(0, size, "r2");
+    RVar ro("ro"), ri("ri");
+    r2.tile(r2.x, ro, ri, factor);
+    f(x) = cast<uint32_t>(0);
+    f(x) = f(x) * 3 + in(r2) + cast<uint32_t>(x);
+    f.update().vectorize(x, 8);
+    Buffer<uint32_t> out = f.realize({out_size});
+
+    for (int i = 0; i < out_size; i++) {
+        if (out(i) != ref_out(i)) {
+            printf("out(%d) = %u instead of %u for extent %d tiled by %d\n",
+                   i, out(i), ref_out(i), size, factor);
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    bool success = true;
+
+    // The factor divides the extent exactly.
+    success &= check(64, 16);
+
+    // A partial tail block, which must be guarded, not over-iterated.
+    success &= check(100, 16);
+
+    // Degenerate cases: a factor larger than the whole extent, and a
+    // factor of one.
+    success &= check(10, 16);
+    success &= check(37, 1);
+
+    if (!success) {
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,70 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+
+int main(int argc, char **argv) {
+    Param<int32_t> offset(7);
+
+    Var x("x");
+    Func f("f");
+    f(x) = x + offset;
+
+    Pipeline p(f);
+    Target t = get_jit_target_from_environment();
+
+    {
+        // Realize a batch of small outputs using the bound value of
+        // the param for every element.
+        std::vector<Realization> batch;
+        std::vector<Buffer<int>> results;
+        for (int i = 0; i < 10; i++) {
+            results.emplace_back(16);
+            batch.emplace_back(results.back());
+        }
+
+        p.realize_batch(batch, t);
+
+        for (int i = 0; i < 10; i++) {
+            for (int j = 0; j < 16; j++) {
+                int correct = j + 7;
+                if (results[i](j) != correct) {
+                    printf("results[%d](%d) = %d instead of %d\n",
+                           i, j, results[i](j), correct);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    {
+        // Vary the param across the batch with one ParamMap per
+        // element.
+        std::vector<Realization> batch;
+        std::vector<Buffer<int>> results;
+        std::vector<ParamMap> params;
+        for (int i = 0; i < 10; i++) {
+            results.emplace_back(16);
+            batch.emplace_back(results.back());
+            ParamMap pm;
+            pm.set(offset, 100 * i);
+            params.push_back(pm);
+        }
+
+        p.realize_batch(batch, t, params);
+
+        for (int i = 0; i < 10; i++) {
+            for (int j = 0; j < 16; j++) {
+                int correct = j + 100 * i;
+                if (results[i](j) != correct) {
+                    printf("results[%d](%d) = %d instead of %d\n",
+                           i, j, results[i](j), correct);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
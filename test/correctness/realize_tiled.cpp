@@ -0,0 +1,64 @@
+#include "Halide.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace Halide;
+
+int main(int argc, char **argv) {
+    Param<int32_t> offset(7);
+
+    Var x("x"), y("y");
+    Func g("g");
+    g(x, y) = x * 3 + y + offset;
+    g.parallel(y);
+
+    Pipeline p(g);
+    Target t = get_jit_target_from_environment();
+
+    // Realize a 100x80 output in 32x16 tiles, so the grid is ragged
+    // at both upper edges, and assemble the tiles back into a single
+    // image to check coverage and values. Consecutive sink calls
+    // never run concurrently, so the sink needs no locking.
+    const int width = 100, height = 80;
+    Buffer<int> assembled(width, height);
+    assembled.fill(-1);
+    int tiles = 0;
+
+    p.realize_tiled(
+        {width, height}, {32, 16},
+        [&](const Realization &r) {
+            Buffer<int> tile = r[0];
+            tiles++;
+            if (tile.width() > 32 || tile.height() > 16) {
+                printf("Tile at (%d, %d) is %dx%d; expected at most 32x16\n",
+                       tile.dim(0).min(), tile.dim(1).min(),
+                       tile.width(), tile.height());
+                exit(1);
+            }
+            // The tile's coordinates are in its mins.
+            tile.for_each_element([&](int ix, int iy) {
+                assembled(ix, iy) = tile(ix, iy);
+            });
+        },
+        t);
+
+    int correct_tiles = ((width + 31) / 32) * ((height + 15) / 16);
+    if (tiles != correct_tiles) {
+        printf("Sink saw %d tiles instead of %d\n", tiles, correct_tiles);
+        return 1;
+    }
+
+    for (int iy = 0; iy < height; iy++) {
+        for (int ix = 0; ix < width; ix++) {
+            int correct = ix * 3 + iy + 7;
+            if (assembled(ix, iy) != correct) {
+                printf("assembled(%d, %d) = %d instead of %d\n",
+                       ix, iy, assembled(ix, iy), correct);
+                return 1;
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
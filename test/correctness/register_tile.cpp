@@ -0,0 +1,73 @@
+#include "Halide.h"
+
+using namespace Halide;
+
+int main(int argc, char **argv) {
+    // Awkward sizes to exercise the tile tails.
+    const int M = 61, N = 38, K = 45;
+
+    Buffer<float> A(K, M), B(N, K);
+    A.for_each_element([&](int x, int y) {
+        A(x, y) = (float)(x + 2 * y + 1) / (x + y + 1);
+    });
+    B.for_each_element([&](int x, int y) {
+        B(x, y) = (float)(3 * x - y) / (x + 2 * y + 1);
+    });
+
+    // A matrix multiply with an 8x6 register tile on the update
+    // stage. The reduction loop should end up between the unrolled
+    // outer-product body and the loops over tiles.
+    {
+        Func C("C");
+        Var x("x"), y("y"), xi("xi"), yi("yi");
+        RDom r(0, K);
+
+        C(x, y) = 0.0f;
+        C(x, y) += A(r, y) * B(x, r);
+
+        C.update().register_tile(x, y, xi, yi, 8, 6, TailStrategy::GuardWithIf);
+
+        Buffer<float> out = C.realize({N, M});
+
+        for (int y = 0; y < M; y++) {
+            for (int x = 0; x < N; x++) {
+                float correct = 0.0f;
+                for (int k = 0; k < K; k++) {
+                    correct += A(k, y) * B(x, k);
+                }
+                // The register tile reassociates nothing, but be
+                // tolerant of fma contraction.
+                float err = std::abs(out(x, y) - correct);
+                float tolerance = 1e-4f * std::abs(correct);
+                if (err > tolerance + 1e-5f) {
+                    printf("out(%d, %d) = %f instead of %f\n",
+                           x, y, out(x, y), correct);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    // register_tile on a pure definition is just tile + vectorize +
+    // unroll.
+    {
+        Func f("f");
+        Var x("x"), y("y"), xi("xi"), yi("yi");
+
+        f(x, y) = x * 3 + y * 5;
+        f.register_tile(x, y, xi, yi, 8, 4, TailStrategy::GuardWithIf);
+
+        Buffer<int> out = f.realize({37, 21});
+        out.for_each_element([&](int x, int y) {
+            int correct = x * 3 + y * 5;
+            if (out(x, y) != correct) {
+                printf("out(%d, %d) = %d instead of %d\n",
+                       x, y, out(x, y), correct);
+                exit(-1);
+            }
+        });
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,80 @@
+#include "Halide.h"
+
+using namespace Halide;
+
+int check(Buffer<int> out, Buffer<int> input) {
+    for (int y = 0; y < out.height(); y++) {
+        for (int x = 0; x < out.width(); x++) {
+            int correct = input(x, y) + 7;
+            if (out(x, y) != correct) {
+                printf("out(%d, %d) = %d instead of %d\n",
+                       x, y, out(x, y), correct);
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    const int size = 67;  // Deliberately not a round number
+
+    Buffer<int> input(size, size);
+    input.for_each_element([&](int x, int y) {
+        input(x, y) = x * 3 + y * 113;
+    });
+
+    Var x, y;
+
+    // A staging copy of the whole input: both sides are dense and
+    // identically laid out, so the copy loops collapse into one
+    // memcpy. The result must be the same as if the loops had run.
+    {
+        Func f, g, h;
+        f(x, y) = input(x, y) + 7;
+        g(x, y) = f(x, y);
+        h(x, y) = g(x, y);
+        f.compute_root();
+        g.compute_root();
+        Buffer<int> out = h.realize({size, size});
+        if (check(out, input) != 0) {
+            return -1;
+        }
+    }
+
+    // Realizing a copy into a cropped view leaves a gap between the
+    // rows of the destination, so only each row is a single copy.
+    {
+        Func g;
+        g(x, y) = input(x, y) + 7;
+        Buffer<int> padded(size + 31, size);
+        Buffer<int> out = padded.cropped(0, 0, size);
+        g.realize(out);
+        if (check(out, input) != 0) {
+            return -1;
+        }
+    }
+
+    // A shifted copy: the indices differ by a constant offset, but
+    // both still advance one element per iteration.
+    {
+        Func f, g;
+        f(x, y) = input(x, y) + 7;
+        g(x, y) = f(x + 3, y);
+        f.compute_root();
+        Buffer<int> out = g.realize({size - 3, size});
+        for (int iy = 0; iy < out.height(); iy++) {
+            for (int ix = 0; ix < out.width(); ix++) {
+                int correct = input(ix + 3, iy) + 7;
+                if (out(ix, iy) != correct) {
+                    printf("out(%d, %d) = %d instead of %d\n",
+                           ix, iy, out(ix, iy), correct);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -56,6 +56,55 @@ int simple_rfactor_test(bool compile_module) {
     return 0;
 }
 
+int storage_scheduled_rfactor_test(bool compile_module) {
+    Func f("f"), g("g");
+    Var x("x"), y("y");
+
+    f(x, y) = x + y;
+    f.compute_root();
+
+    g(x, y) = 40;
+    RDom r(10, 20, 30, 40);
+    g(r.x, r.y) = max(g(r.x, r.y) + f(r.x, r.y), g(r.x, r.y));
+
+    // The intermediate inherits g's storage order with u appended
+    // outermost by default, but it accepts the full storage scheduling
+    // language like any other Func. Put the vectorized partial-result
+    // dimension innermost and align it to the vector width.
+    Var u("u");
+    Func intm = g.update(0).rfactor(r.y, u);
+    intm.compute_root()
+        .reorder_storage(u, x, y)
+        .align_storage(u, 8)
+        .vectorize(u, 8);
+    intm.update(0).vectorize(r.x, 2);
+
+    if (compile_module) {
+        // Check the call graphs.
+        Module m = g.compile_to_module({g.infer_arguments()});
+        CheckCalls checker;
+        m.functions().front().body.accept(&checker);
+
+        CallGraphs expected = {
+            {g.name(), {intm.name(), g.name()}},
+            {intm.name(), {f.name(), intm.name()}},
+            {f.name(), {}},
+        };
+        if (check_call_graphs(checker.calls, expected) != 0) {
+            return -1;
+        }
+    } else {
+        Buffer<int> im = g.realize({80, 80});
+        auto func = [](int x, int y, int z) {
+            return (10 <= x && x <= 29) && (30 <= y && y <= 69) ? std::max(40 + x + y, 40) : 40;
+        };
+        if (check_image(im, func)) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
 int reorder_split_rfactor_test(bool compile_module) {
     Func f("f"), g("g");
     Var x("x"), y("y");
@@ -1044,6 +1093,16 @@ int main(int argc, char **argv) {
         return -1;
     }
 
+    printf("Running storage scheduled rfactor test\n");
+    printf("    checking call graphs...\n");
+    if (storage_scheduled_rfactor_test(true) != 0) {
+        return -1;
+    }
+    printf("    checking output img correctness...\n");
+    if (storage_scheduled_rfactor_test(false) != 0) {
+        return -1;
+    }
+
     printf("Running reorder split rfactor test\n");
     printf("    checking call graphs...\n");
     if (reorder_split_rfactor_test(true) != 0) {
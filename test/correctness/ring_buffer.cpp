@@ -0,0 +1,100 @@
+#include "Halide.h"
+
+using namespace Halide;
+
+#ifdef _WIN32
+#define DLLEXPORT __declspec(dllexport)
+#else
+#define DLLEXPORT
+#endif
+
+extern "C" DLLEXPORT int jittery(int x) {
+    // Burn a variable amount of time so the producer and consumer
+    // drift in and out of sync.
+    float f = 3.0f;
+    for (int i = 0; i < ((x % 7) << 8); i++) {
+        f = sqrtf(sinf(cosf(f)));
+    }
+    if (f < 0) return 3;
+    return x;
+}
+HalideExtern_1(int, jittery, int);
+
+int main(int argc, char **argv) {
+    if (get_jit_target_from_environment().arch == Target::WebAssembly) {
+        printf("[SKIP] WebAssembly does not support async() yet.\n");
+        return 0;
+    }
+
+    // A producer that computes scanlines at a jittery rate, running
+    // ahead of the consumer through a four-deep ring buffer.
+    {
+        Func producer, consumer;
+        Var x, y;
+
+        producer(x, y) = jittery(x + y);
+        consumer(x, y) = jittery(producer(x, y) * 2);
+        consumer.compute_root();
+        producer.store_root().compute_at(consumer, y).async().ring_buffer(4);
+
+        Buffer<int> out = consumer.realize({64, 64});
+
+        out.for_each_element([&](int x, int y) {
+            int correct = 2 * (x + y);
+            if (out(x, y) != correct) {
+                printf("out(%d, %d) = %d instead of %d\n",
+                       x, y, out(x, y), correct);
+                exit(-1);
+            }
+        });
+    }
+
+    // A non-monotonic access pattern, so storage folding can't shrink
+    // the allocation and the ring buffer rotates copies of the full
+    // realization.
+    {
+        Func producer, consumer;
+        Var x, y;
+
+        producer(x, y) = jittery(x * y);
+        consumer(x, y) = producer(x, y ^ 1) + 1;
+        consumer.compute_root();
+        producer.store_root().compute_at(consumer, y).async().ring_buffer(3);
+
+        Buffer<int> out = consumer.realize({32, 32});
+
+        out.for_each_element([&](int x, int y) {
+            int correct = x * (y ^ 1) + 1;
+            if (out(x, y) != correct) {
+                printf("out(%d, %d) = %d instead of %d\n",
+                       x, y, out(x, y), correct);
+                exit(-1);
+            }
+        });
+    }
+
+    // A ring buffer deeper than the loop it rotates over.
+    {
+        Func producer, consumer;
+        Var x, y;
+
+        producer(x, y) = x - y;
+        consumer(x, y) = producer(x, y) * 3;
+        consumer.compute_root();
+        producer.store_root().compute_at(consumer, y).async().ring_buffer(8);
+
+        Buffer<int> out = consumer.realize({16, 4});
+
+        out.for_each_element([&](int x, int y) {
+            int correct = (x - y) * 3;
+            if (out(x, y) != correct) {
+                printf("out(%d, %d) = %d instead of %d\n",
+                       x, y, out(x, y), correct);
+                exit(-1);
+            }
+        });
+    }
+
+    printf("Success!\n");
+    return 0;
+}
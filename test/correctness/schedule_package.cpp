@@ -0,0 +1,88 @@
+#include "Halide.h"
+#include "halide_test_dirs.h"
+
+#include <cstdio>
+
+using namespace Halide;
+
+namespace {
+
+// The same two-stage algorithm, built fresh each time so the two
+// copies share nothing but their structure.
+Pipeline make_pipeline(Var x, Var y, Func &producer_out, Func &consumer_out) {
+    Func producer("producer"), consumer("consumer");
+    producer(x, y) = x * 3 + y;
+    consumer(x, y) = producer(x, y) + producer(x + 1, y) + producer(x, y + 1);
+    producer_out = producer;
+    consumer_out = consumer;
+    return Pipeline(consumer);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    std::string filename = Internal::get_test_tmp_dir() + "schedule_package.hlsched";
+    Internal::ensure_no_file_exists(filename);
+
+    Var x("x"), y("y"), xi("xi"), yi("yi");
+
+    // Schedule one copy by hand, as an autotuner would, and save the
+    // result along with some measured numbers.
+    Func producer, consumer;
+    Pipeline tuned = make_pipeline(x, y, producer, consumer);
+    consumer.tile(x, y, xi, yi, 16, 8).vectorize(xi, 8);
+    producer.compute_at(consumer, x).vectorize(x, 8, TailStrategy::GuardWithIf);
+
+    save_schedule(tuned, filename, Target("x86-64-linux-avx2"), {{"time_ms", 1.25}});
+    Internal::assert_file_exists(filename);
+
+    // Apply it to an unscheduled copy of the same algorithm.
+    Func producer2, consumer2;
+    Pipeline fresh = make_pipeline(x, y, producer2, consumer2);
+    Target tuned_for;
+    std::map<std::string, double> metrics = apply_schedule(fresh, filename, &tuned_for);
+
+    if (metrics.size() != 1 || metrics["time_ms"] != 1.25) {
+        printf("Metrics did not round-trip\n");
+        return 1;
+    }
+    if (tuned_for != Target("x86-64-linux-avx2")) {
+        printf("Target did not round-trip: got %s\n", tuned_for.to_string().c_str());
+        return 1;
+    }
+
+    // The applied schedule should match the hand-written one: same
+    // splits and same loop nest on every stage.
+    Func pairs[2][2] = {{consumer, consumer2}, {producer, producer2}};
+    for (int i = 0; i < 2; i++) {
+        const Internal::StageSchedule &a = pairs[i][0].function().definition().schedule();
+        const Internal::StageSchedule &b = pairs[i][1].function().definition().schedule();
+        if (a.splits().size() != b.splits().size() || a.dims().size() != b.dims().size()) {
+            printf("Applied schedule for %s has a different shape than the saved one\n",
+                   pairs[i][0].name().c_str());
+            return 1;
+        }
+        for (size_t j = 0; j < a.dims().size(); j++) {
+            if (a.dims()[j].var != b.dims()[j].var ||
+                a.dims()[j].for_type != b.dims()[j].for_type) {
+                printf("Dim %d of %s did not round-trip\n", (int)j, pairs[i][0].name().c_str());
+                return 1;
+            }
+        }
+    }
+
+    // And both should still compute the same thing.
+    Buffer<int> want = tuned.realize({64, 48});
+    Buffer<int> got = fresh.realize({64, 48});
+    for (int iy = 0; iy < want.height(); iy++) {
+        for (int ix = 0; ix < want.width(); ix++) {
+            if (want(ix, iy) != got(ix, iy)) {
+                printf("got(%d, %d) = %d instead of %d\n", ix, iy, got(ix, iy), want(ix, iy));
+                return 1;
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
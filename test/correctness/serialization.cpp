@@ -0,0 +1,78 @@
+#include "Halide.h"
+#include "halide_test_dirs.h"
+
+#include <cstdio>
+
+using namespace Halide;
+
+int main(int argc, char **argv) {
+    std::string filename = Internal::get_test_tmp_dir() + "serialization_pipeline.hlpipe";
+    Internal::ensure_no_file_exists(filename);
+
+    // A pipeline exercising an image param, a scalar param, an update
+    // definition with a predicated RDom, a specialization, and a few
+    // scheduling directives.
+    ImageParam input(Int(32), 2, "input");
+    Param<int> offset("offset");
+    Func blur("blur"), hist("hist");
+    Var x("x"), y("y"), xi("xi"), yi("yi");
+    RDom r(0, 32, 0, 32, "r");
+    r.where(r.x != r.y);
+
+    blur(x, y) = (input(x, y) + input(x + 1, y) + input(x, y + 1) + offset) / 3;
+    hist(x) = 0;
+    hist(blur(r.x, r.y) % 16) += 1;
+
+    blur.compute_root().tile(x, y, xi, yi, 8, 8).vectorize(xi, 4);
+    blur.specialize(offset > 0);
+    hist.compute_root();
+    hist.bound(x, 0, 16);
+
+    Pipeline p({blur, hist});
+
+    serialize_pipeline(p, filename);
+    Internal::assert_file_exists(filename);
+
+    std::map<std::string, Internal::Parameter> params;
+    Pipeline q = deserialize_pipeline(filename, params);
+
+    if (params.count("input") == 0 || params.count("offset") == 0) {
+        printf("Deserialized pipeline is missing its input parameters\n");
+        return 1;
+    }
+
+    // Bind the same inputs to both pipelines and compare the results.
+    Buffer<int> in(33, 33);
+    in.for_each_element([&](int ix, int iy) {
+        in(ix, iy) = ix * 7 + iy * 3;
+    });
+    input.set(in);
+    offset.set(5);
+    params["input"].set_buffer(in);
+    params["offset"].set_scalar<int>(5);
+
+    Buffer<int> blur_before(32, 32), hist_before(16);
+    Buffer<int> blur_after(32, 32), hist_after(16);
+    p.realize({blur_before, hist_before});
+    q.realize({blur_after, hist_after});
+
+    for (int iy = 0; iy < 32; iy++) {
+        for (int ix = 0; ix < 32; ix++) {
+            if (blur_before(ix, iy) != blur_after(ix, iy)) {
+                printf("blur(%d, %d) = %d instead of %d after round-trip\n",
+                       ix, iy, blur_after(ix, iy), blur_before(ix, iy));
+                return 1;
+            }
+        }
+    }
+    for (int ix = 0; ix < 16; ix++) {
+        if (hist_before(ix) != hist_after(ix)) {
+            printf("hist(%d) = %d instead of %d after round-trip\n",
+                   ix, hist_after(ix), hist_before(ix));
+            return 1;
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
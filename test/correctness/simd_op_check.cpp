@@ -519,6 +519,13 @@ public:
                 check("vdpbf16ps*zmm", 16, sum(f32(in_bf16(2 * x + r)) * in_bf16(2 * x + r + 32)));
                 check("vdpbf16ps*ymm", 8, sum(f32(in_bf16(2 * x + r)) * in_bf16(2 * x + r + 32)));
                 check("vdpbf16ps*xmm", 4, sum(f32(in_bf16(2 * x + r)) * in_bf16(2 * x + r + 32)));
+            }
+        }
+        if (use_avx512 && (target.has_feature(Target::AVX512_VNNI) ||
+                           target.has_feature(Target::AVX512_SapphireRapids))) {
+            {
+                // 16 bit, 2 element dot product
+                RDom r(0, 2);
                 check("vpdpwssd*zmm", 16, sum(i32(in_i16(2 * x + r)) * in_i16(2 * x + r + 32)));
                 check("vpdpwssd*ymm", 8, sum(i32(in_i16(2 * x + r)) * in_i16(2 * x + r + 32)));
                 check("vpdpwssd*xmm", 4, sum(i32(in_i16(2 * x + r)) * in_i16(2 * x + r + 32)));
@@ -1111,6 +1118,19 @@ public:
                         }
                     }
                 }
+
+                // BFDOT/BFCVTN
+                if (!arm32 && target.has_feature(Target::ARMBf16)) {
+                    for (int v : {4, 8}) {
+                        check("bfcvtn", v, cast(BFloat(16), f32_1));
+                    }
+                    for (int f : {2, 4}) {
+                        RDom r(0, f);
+                        for (int v : {2, 4}) {
+                            check("bfdot", v, sum(f32(in_bf16(f * x + r)) * in_bf16(f * x + r + 32)));
+                        }
+                    }
+                }
             }
             // VPOP     X       F, D    Pop from Stack
             // VPUSH    X       F, D    Push to Stack
@@ -1753,13 +1773,6 @@ public:
                 check("i32x4.mul", 4 * w, i32_1 * i32_2);
                 check("i64x2.mul", 2 * w, i64_1 * i64_2);
 
-                // Integer dot product (16 -> 32)
-                // TODO(https://github.com/halide/Halide/issues/5130): NOT BEING GENERATED AT TRUNK
-                // {
-                //     RDom r(0, 4);
-                //     check("i32x4.dot_i16x8_s", 2 * w, sum(i32(in_i16(x * 4 + r)) * in_i16(x * 4 + r + 32)));
-                // }
-
                 // Integer negation
                 check("i8x16.neg", 16 * w, -i8_1);
                 check("i16x8.neg", 8 * w, -i16_1);
@@ -1810,6 +1823,12 @@ public:
                         // The u16->i32 op uses the unsigned variant
                         check("i32x4.extadd_pairwise_i16x8_u", 8 * w, sum_(i32(in_u16(f * x + r))));
                     }
+
+                    // Integer dot product (16 -> 32)
+                    for (int f : {2, 4}) {
+                        RDom r(0, f);
+                        check("i32x4.dot_i16x8_s", 4 * w, sum(i32(in_i16(f * x + r)) * in_i16(f * x + r + 32)));
+                    }
                 }
 
                 // Saturating integer addition
@@ -2248,6 +2267,13 @@ int main(int argc, char **argv) {
 
     bool success = test.test_all();
 
+    // Opt-in throughput scorecard, for diffing instruction selection
+    // quality across LLVM upgrades. Not run by default: timing is
+    // meaningless on loaded CI machines.
+    if (getenv("HL_SIMD_OP_CHECK_BENCHMARK")) {
+        success &= test.benchmark_all();
+    }
+
     // Compile a runtime for this target, for use in the static test.
     compile_standalone_runtime(test.output_directory + "simd_op_check_runtime.o", test.target);
 
@@ -4,7 +4,9 @@
 #include "Halide.h"
 #include "halide_test_dirs.h"
 
+#include <chrono>
 #include <fstream>
+#include <limits>
 
 namespace Halide {
 struct TestResult {
@@ -12,6 +14,14 @@ struct TestResult {
     std::string error_msg;
 };
 
+struct BenchmarkResult {
+    std::string op;
+    std::string name;
+    int vector_width;
+    double vector_ns_per_element;
+    double scalar_ns_per_element;
+};
+
 struct Task {
     std::string op;
     std::string name;
@@ -167,9 +177,14 @@ public:
         return wildcard_match("*" + p + "*", str);
     }
 
-    TestResult check_one(const std::string &op, const std::string &name, int vector_width, Expr e) {
-        std::ostringstream error_msg;
+    // The vectorized Func that uses a checked pattern, and a scalar
+    // version of the same computation to compare against.
+    struct TestFuncs {
+        Func vec;
+        Func scalar;
+    };
 
+    TestFuncs build_test_funcs(const std::string &name, int vector_width, const Expr &e) {
         class HasInlineReduction : public Internal::IRVisitor {
             using Internal::IRVisitor::visit;
             void visit(const Internal::Call *op) override {
@@ -219,6 +234,16 @@ public:
                 .vectorize(xi);
         }
 
+        return {f, f_scalar};
+    }
+
+    TestResult check_one(const std::string &op, const std::string &name, int vector_width, Expr e) {
+        std::ostringstream error_msg;
+
+        TestFuncs funcs = build_test_funcs(name, vector_width, e);
+        Func f = funcs.vec;
+        Func f_scalar = funcs.scalar;
+
         // The output to the pipeline is the maximum absolute difference as a double.
         RDom r_check(0, W, 0, H);
         Halide::Func error("error_" + name);
@@ -235,30 +260,7 @@ public:
                                     .without_feature(Target::NoBoundsQuery);
 
             error.infer_input_bounds({}, run_target);
-            // Fill the inputs with noise
-            for (auto p : image_params) {
-                Halide::Buffer<> buf = p.get();
-                if (!buf.defined()) continue;
-                assert(buf.data());
-                Type t = buf.type();
-                // For floats/doubles, we only use values that aren't
-                // subject to rounding error that may differ between
-                // vectorized and non-vectorized versions
-                if (t == Float(32)) {
-                    buf.as<float>().for_each_value([&](float &f) { f = (rng() & 0xfff) / 8.0f - 0xff; });
-                } else if (t == Float(64)) {
-                    buf.as<double>().for_each_value([&](double &f) { f = (rng() & 0xfff) / 8.0 - 0xff; });
-                } else {
-                    // Random bits is fine
-                    for (uint32_t *ptr = (uint32_t *)buf.data();
-                         ptr != (uint32_t *)buf.data() + buf.size_in_bytes() / 4;
-                         ptr++) {
-                        // Never use the top four bits, to avoid
-                        // signed integer overflow.
-                        *ptr = ((uint32_t)rng()) & 0x0fffffff;
-                    }
-                }
-            }
+            fill_inputs_with_noise();
             Realization r = error.realize();
             double e = Buffer<double>(r[0])();
             // Use a very loose tolerance for floating point tests. The
@@ -287,6 +289,111 @@ public:
         return {op, error_msg.str()};
     }
 
+    void fill_inputs_with_noise() {
+        for (auto p : image_params) {
+            Halide::Buffer<> buf = p.get();
+            if (!buf.defined()) continue;
+            assert(buf.data());
+            Type t = buf.type();
+            // For floats/doubles, we only use values that aren't
+            // subject to rounding error that may differ between
+            // vectorized and non-vectorized versions
+            if (t == Float(32)) {
+                buf.as<float>().for_each_value([&](float &f) { f = (rng() & 0xfff) / 8.0f - 0xff; });
+            } else if (t == Float(64)) {
+                buf.as<double>().for_each_value([&](double &f) { f = (rng() & 0xfff) / 8.0 - 0xff; });
+            } else {
+                // Random bits is fine
+                for (uint32_t *ptr = (uint32_t *)buf.data();
+                     ptr != (uint32_t *)buf.data() + buf.size_in_bytes() / 4;
+                     ptr++) {
+                    // Never use the top four bits, to avoid
+                    // signed integer overflow.
+                    *ptr = ((uint32_t)rng()) & 0x0fffffff;
+                }
+            }
+        }
+    }
+
+    // Time repeated realizations into an existing output, reporting
+    // the best sample in nanoseconds per realization.
+    double time_realization(Func f, Realization &r, const Target &t) {
+        constexpr int samples = 5;
+        constexpr int iterations = 10;
+        double best = std::numeric_limits<double>::infinity();
+        for (int s = 0; s < samples; s++) {
+            auto t1 = std::chrono::steady_clock::now();
+            for (int i = 0; i < iterations; i++) {
+                f.realize(r, t);
+            }
+            auto t2 = std::chrono::steady_clock::now();
+            best = std::min(best, std::chrono::duration<double, std::nano>(t2 - t1).count() / iterations);
+        }
+        return best;
+    }
+
+    virtual BenchmarkResult benchmark_one(const Task &task) {
+        TestFuncs funcs = build_test_funcs(task.name, task.vector_width, task.expr);
+
+        setup_images();
+        Target run_target = target
+                                .without_feature(Target::NoRuntime)
+                                .without_feature(Target::NoAsserts)
+                                .without_feature(Target::NoBoundsQuery);
+
+        funcs.vec.infer_input_bounds({W, H}, run_target);
+        fill_inputs_with_noise();
+
+        Realization r_vec = funcs.vec.realize({W, H}, run_target);
+        Realization r_scalar = funcs.scalar.realize({W, H}, run_target);
+
+        double elements = (double)W * H;
+        return {task.op, task.name, task.vector_width,
+                time_realization(funcs.vec, r_vec, run_target) / elements,
+                time_realization(funcs.scalar, r_scalar, run_target) / elements};
+    }
+
+    // Time every checked pattern and write a machine-readable
+    // scorecard (one JSON object per line) to the output directory.
+    // The actionable signal when upgrading LLVM is the per-element
+    // speedup of the vectorized loop over the scalar one, diffed
+    // against the scorecard from the previous toolchain: a selection
+    // regression shows up as a speedup collapsing towards 1. The
+    // theoretical peak speedup is the vector width, so
+    // speedup / vector_width approximates lane utilization without
+    // needing to know the clock rate.
+    virtual bool benchmark_all() {
+        if (tasks.empty()) {
+            add_tests();
+        }
+        if (!can_run_code()) {
+            std::cout << "[SKIP] Cannot run code for target=" << target.to_string() << "; no benchmarks.
+";
+            return true;
+        }
+        std::string scorecard_path = output_directory + "simd_op_check_scorecard.json";
+        std::ofstream scorecard(scorecard_path);
+        // Benchmarks run serially: parallel timing runs would contend
+        // for the cores being measured.
+        for (const Task &task : tasks) {
+            BenchmarkResult r = benchmark_one(task);
+            double speedup = r.scalar_ns_per_element / r.vector_ns_per_element;
+            scorecard << "{\"target\": \"" << target.to_string() << "\""
+                      << ", \"op\": \"" << r.op << "\""
+                      << ", \"name\": \"" << r.name << "\""
+                      << ", \"vector_width\": " << r.vector_width
+                      << ", \"vector_ns_per_element\": " << r.vector_ns_per_element
+                      << ", \"scalar_ns_per_element\": " << r.scalar_ns_per_element
+                      << ", \"speedup\": " << speedup
+                      << ", \"peak_speedup\": " << r.vector_width
+                      << "}\n";
+            std::cout << r.op << " speedup: " << speedup
+                      << " (peak " << r.vector_width << ")\n";
+        }
+        std::cout << "Wrote " << scorecard_path << "\n";
+        return !scorecard.fail();
+    }
+
     void check(std::string op, int vector_width, Expr e) {
         // Make a name for the test by uniquing then sanitizing the op name
         std::string name = "op_" + op;
@@ -316,7 +423,9 @@ public:
     }
     virtual bool test_all() {
         /* First add some tests based on the target */
-        add_tests();
+        if (tasks.empty()) {
+            add_tests();
+        }
         Internal::ThreadPool<TestResult> pool(num_threads);
         std::vector<std::future<TestResult>> futures;
         for (const Task &task : tasks) {
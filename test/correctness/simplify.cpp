@@ -2257,6 +2257,23 @@ int main(int argc, char **argv) {
     // Check a bounds-related fuzz tester failure found in issue https://github.com/halide/Halide/issues/3764
     check(Let::make("b", 105, 336 / max(cast<int32_t>(cast<int16_t>(Variable::make(Int(32), "b"))), 38) + 29), 32);
 
+    {
+        // Simplifying a statement stamps it as already-canonical so
+        // that repeat passes can skip it. A skipped subtree must
+        // still keep the lets it references alive, even though the
+        // simplifier never observes the uses inside it.
+        Expr v = Variable::make(Int(32), "stamped_var");
+        Stmt body = simplify(Evaluate::make(v + y));
+        Stmt s = simplify(LetStmt::make("stamped_var", 5, body));
+        if (stmt_uses_var(s, "stamped_var") && !s.as<LetStmt>()) {
+            std::cerr
+                << "Simplification dropped a let referenced by an "
+                << "already-simplified subtree:\n"
+                << s << "\n";
+            abort();
+        }
+    }
+
     printf("Success!\n");
 
     return 0;
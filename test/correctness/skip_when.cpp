@@ -0,0 +1,95 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+
+int test_masked_tiles(int w, int h, int tw, int th) {
+    Var x("x"), y("y"), xo("xo"), yo("yo"), xi("xi"), yi("yi");
+
+    Buffer<int> in(w, h);
+    for (int iy = 0; iy < h; iy++) {
+        for (int ix = 0; ix < w; ix++) {
+            in(ix, iy) = ix * 5 + iy * 3;
+        }
+    }
+
+    // A per-tile activity mask. Only tiles with a nonzero entry should
+    // be computed.
+    int tiles_x = (w + tw - 1) / tw;
+    int tiles_y = (h + th - 1) / th;
+    Buffer<uint8_t> mask(tiles_x, tiles_y);
+    for (int ty = 0; ty < tiles_y; ty++) {
+        for (int tx = 0; tx < tiles_x; tx++) {
+            mask(tx, ty) = ((tx + ty) % 3 == 0) ? 1 : 0;
+        }
+    }
+    ImageParam mask_param(UInt(8), 2, "mask");
+    mask_param.set(mask);
+
+    Func f("f");
+    f(x, y) = 0;
+    f(x, y) += in(x, y);
+    f.update()
+        .tile(x, y, xo, yo, xi, yi, tw, th)
+        .skip_when(mask_param(xo, yo) == 0)
+        .vectorize(xi)
+        .parallel(yo);
+
+    Buffer<int> out = f.realize({w, h});
+    for (int iy = 0; iy < h; iy++) {
+        for (int ix = 0; ix < w; ix++) {
+            bool active = mask(ix / tw, iy / th) != 0;
+            int correct = active ? in(ix, iy) : 0;
+            if (out(ix, iy) != correct) {
+                printf("out(%d, %d) = %d instead of %d for size %dx%d tiled %dx%d\n",
+                       ix, iy, out(ix, iy), correct, w, h, tw, th);
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+int test_scalar_condition() {
+    Var x("x"), xo("xo"), xi("xi");
+    Param<int> skip;
+
+    Func g("g");
+    g(x) = x;
+    g(x) += 1000;
+    g.update().split(x, xo, xi, 16).skip_when(skip != 0);
+
+    // A condition that references no loop variables should hoist all
+    // the way out of the loop nest and skip the whole stage.
+    for (int s : {0, 1}) {
+        skip.set(s);
+        Buffer<int> out = g.realize({100});
+        for (int i = 0; i < out.width(); i++) {
+            int correct = s ? i : i + 1000;
+            if (out(i) != correct) {
+                printf("out(%d) = %d instead of %d with skip = %d\n",
+                       i, out(i), correct, s);
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    // Whole tiles.
+    if (test_masked_tiles(64, 64, 8, 8) != 0) {
+        return -1;
+    }
+    // Partial tiles at the edges.
+    if (test_masked_tiles(100, 60, 16, 8) != 0) {
+        return -1;
+    }
+
+    if (test_scalar_condition() != 0) {
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,69 @@
+#include "Halide.h"
+using namespace Halide;
+
+void *my_malloc(void *user_context, size_t x) {
+    printf("There was not supposed to be a heap allocation\n");
+    exit(-1);
+    return nullptr;
+}
+
+void my_free(void *user_context, void *ptr) {
+}
+
+bool errored = false;
+void my_error(void *user_context, const char *msg) {
+    errored = true;
+    char expected[] = "Total allocation for buffer f is ";
+    if (strncmp(expected, msg, sizeof(expected) - 1)) {
+        printf("Unexpected error: '%s'\n", msg);
+        exit(-1);
+    }
+}
+
+int main(int argc, char **argv) {
+    if (get_jit_target_from_environment().arch == Target::WebAssembly) {
+        printf("[SKIP] WebAssembly JIT does not support set_custom_allocator().\n");
+        return 0;
+    }
+
+    Func f("f"), g("g");
+    Var x("x"), xo, xi;
+
+    Param<int> p;
+
+    f(x) = x;
+    g(x) = f(x);
+    g.split(x, xo, xi, p);
+
+    // We need p elements of f per split of g, so f's size isn't
+    // knowable at compile time. Giving it an explicit stack budget
+    // means it can still go on the stack, with a runtime check that
+    // the budget is respected.
+    f.compute_at(g, xo).store_in(MemoryType::Stack, 16 * sizeof(int));
+
+    // Check there's no malloc when the allocation fits the budget
+    g.set_custom_allocator(&my_malloc, &my_free);
+    p.set(5);
+    Buffer<int> result = g.realize({20});
+    for (int i = 0; i < result.width(); i++) {
+        if (result(i) != i) {
+            printf("result(%d) = %d instead of %d\n", i, result(i), i);
+            return -1;
+        }
+    }
+    g.set_custom_allocator(nullptr, nullptr);
+
+    // Check there was an assertion failure of the appropriate type
+    // when the budget is exceeded
+    g.set_error_handler(&my_error);
+    p.set(20);
+    g.realize({20});
+
+    if (!errored) {
+        printf("There was supposed to be an error\n");
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
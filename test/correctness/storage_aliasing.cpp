@@ -0,0 +1,73 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+using namespace Halide::Internal;
+
+namespace {
+
+// Record the allocations that survive lowering. In the pipeline below
+// the first stage is dead before the third is written, so the third
+// should have been folded into the first stage's allocation.
+class FindAllocations : public IRMutator {
+    using IRMutator::visit;
+
+    Stmt visit(const Allocate *op) override {
+        if (Internal::starts_with(op->name, "stage_")) {
+            names.insert(op->name);
+        }
+        return IRMutator::visit(op);
+    }
+
+public:
+    std::set<std::string> names;
+};
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    Var x("x"), y("y");
+
+    // A chain of root-scheduled stages. The early free of stage_1
+    // lands after stage_2 is computed, so stage_3's live range is
+    // disjoint from stage_1's and the two can share storage.
+    Func f1("stage_1"), f2("stage_2"), f3("stage_3"), out("out");
+    f1(x, y) = x + y;
+    f2(x, y) = f1(x, y) + f1(x + 1, y);
+    f3(x, y) = f2(x, y) + f2(x, y + 1);
+    out(x, y) = f3(x, y) * 2;
+
+    f1.compute_root();
+    f2.compute_root();
+    f3.compute_root();
+
+    FindAllocations *finder = new FindAllocations;
+    out.add_custom_lowering_pass(finder);
+
+    Buffer<int> result = out.realize({32, 32});
+
+    if (finder->names.count("stage_3")) {
+        printf("stage_3 still has its own allocation; it should share stage_1's\n");
+        return 1;
+    }
+    if (!finder->names.count("stage_1")) {
+        printf("The shared allocation for stage_1 is missing\n");
+        return 1;
+    }
+
+    for (int iy = 0; iy < 32; iy++) {
+        for (int ix = 0; ix < 32; ix++) {
+            int correct = ((ix + iy) + (ix + 1 + iy) +
+                           (ix + iy + 1) + (ix + 1 + iy + 1)) *
+                          2;
+            if (result(ix, iy) != correct) {
+                printf("result(%d, %d) = %d instead of %d\n",
+                       ix, iy, result(ix, iy), correct);
+                return 1;
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,74 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+
+int check(Buffer<int> out, int channels) {
+    for (int y = 0; y < out.height(); y++) {
+        for (int x = 0; x < out.width(); x++) {
+            for (int c = 0; c < channels; c++) {
+                int correct = 2 * (x + 10 * y + 100 * c);
+                if (out(x, y, c) != correct) {
+                    printf("out(%d, %d, %d) = %d instead of %d\n",
+                           x, y, c, out(x, y, c), correct);
+                    return 1;
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    // Store an RGB producer in AoSoA form: tiles of 8 x-values per
+    // channel, with the channels interleaved between tiles.
+    {
+        Var x, y, c;
+        Func f, g;
+        f(x, y, c) = x + 10 * y + 100 * c;
+        g(x, y, c) = f(x, y, c) * 2;
+
+        f.compute_root().reorder_storage(x, c, y).store_interleaved(c, 8);
+        g.vectorize(x, 8);
+
+        // A width that is a whole number of tiles.
+        if (check(g.realize({32, 8, 3}), 3)) {
+            return 1;
+        }
+    }
+
+    // A width that isn't a multiple of the tile size, accessed with a
+    // stencil in x, so loads straddle tile boundaries.
+    {
+        Var x, y, c;
+        Func f, g;
+        f(x, y, c) = x + 10 * y + 100 * c;
+        g(x, y, c) = (f(x, y, c) + f(x + 1, y, c) + f(x + 3, y, c)) - (f(x + 1, y, c) + f(x + 3, y, c)) + f(x, y, c);
+
+        f.compute_root().reorder_storage(x, c, y).store_interleaved(c, 8);
+
+        if (check(g.realize({29, 5, 3}), 3)) {
+            return 1;
+        }
+    }
+
+    // Interleaving a producer computed within the consumer's loop
+    // nest, so the realization is sized by what's needed, not by the
+    // output.
+    {
+        Var x, y, c;
+        Func f, g;
+        f(x, y, c) = x + 10 * y + 100 * c;
+        g(x, y, c) = f(x, y, c) * 2;
+
+        f.compute_at(g, y).reorder_storage(x, c, y).store_interleaved(c, 4);
+        g.vectorize(x, 4);
+
+        if (check(g.realize({30, 7, 3}), 3)) {
+            return 1;
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
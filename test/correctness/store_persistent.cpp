@@ -0,0 +1,90 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+
+#ifdef _WIN32
+#define DLLEXPORT __declspec(dllexport)
+#else
+#define DLLEXPORT
+#endif
+
+int call_count = 0;
+
+extern "C" DLLEXPORT int count_calls(int x) {
+    call_count++;
+    return x;
+}
+HalideExtern_1(int, count_calls, int);
+
+int main(int argc, char **argv) {
+    const int W = 32;
+
+    Var x("x"), t("t");
+
+    // State indexed by absolute frame number. Each "frame" realizes a
+    // window of frames [n, n + 3]; consecutive windows overlap in
+    // three slices, which should be restored instead of recomputed.
+    Func state("state"), out("out");
+    state(x, t) = count_calls(x * 100 + t);
+    state.compute_root().store_persistent();
+    out(x, t) = state(x, t) * 2;
+
+    auto check = [&](Buffer<int> &buf, int t_min) {
+        for (int it = 0; it < buf.dim(1).extent(); it++) {
+            for (int ix = 0; ix < W; ix++) {
+                int correct = (ix * 100 + t_min + it) * 2;
+                if (buf(ix, t_min + it) != correct) {
+                    printf("buf(%d, %d) = %d instead of %d\n",
+                           ix, t_min + it, buf(ix, t_min + it), correct);
+                    exit(-1);
+                }
+            }
+        }
+    };
+
+    Buffer<int> frame0(W, 4);
+    out.realize(frame0);
+    check(frame0, 0);
+    if (call_count != W * 4) {
+        printf("First frame made %d calls instead of %d\n", call_count, W * 4);
+        return -1;
+    }
+
+    // Slide the window forward by one frame: only the new slice
+    // should be computed.
+    call_count = 0;
+    Buffer<int> frame1(W, 4);
+    frame1.set_min(0, 1);
+    out.realize(frame1);
+    check(frame1, 1);
+    if (call_count != W) {
+        printf("Second frame made %d calls instead of %d\n", call_count, W);
+        return -1;
+    }
+
+    // A request starting below the retained region cannot reuse it.
+    call_count = 0;
+    Buffer<int> frame2(W, 4);
+    out.realize(frame2);
+    check(frame2, 0);
+    if (call_count != W * 4) {
+        printf("Rewound frame made %d calls instead of %d\n", call_count, W * 4);
+        return -1;
+    }
+
+    // Clearing the retained state forces a full recompute even for a
+    // matching request.
+    Internal::JITSharedRuntime::persistent_state_clear(nullptr);
+    call_count = 0;
+    Buffer<int> frame3(W, 4);
+    out.realize(frame3);
+    check(frame3, 0);
+    if (call_count != W * 4) {
+        printf("Post-clear frame made %d calls instead of %d\n", call_count, W * 4);
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,51 @@
+#include "Halide.h"
+
+using namespace Halide;
+
+int main(int argc, char **argv) {
+    const int size = 1000;
+
+    Var x, y;
+
+    // A pure producer: every value is written exactly once, so its
+    // stores become streaming stores. The results must be unchanged.
+    {
+        Func f, g;
+        f(x, y) = x * 3 + y * 7;
+        g(x, y) = f(x, y) + f(x + 1, y);
+        f.compute_root().store_streaming().vectorize(x, 8, TailStrategy::GuardWithIf);
+        g.store_streaming().vectorize(x, 8, TailStrategy::GuardWithIf);
+
+        Buffer<int> out = g.realize({size, size});
+        for (int iy = 0; iy < size; iy++) {
+            for (int ix = 0; ix < size; ix++) {
+                int correct = (ix * 3 + iy * 7) + ((ix + 1) * 3 + iy * 7);
+                if (out(ix, iy) != correct) {
+                    printf("out(%d, %d) = %d instead of %d\n",
+                           ix, iy, out(ix, iy), correct);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    // A Func with an update re-reads its own buffer, so the directive
+    // must quietly fall back to normal stores.
+    {
+        Func f;
+        f(x) = x;
+        f(x) += 1;
+        f.compute_root().store_streaming();
+
+        Buffer<int> out = f.realize({size});
+        for (int ix = 0; ix < size; ix++) {
+            if (out(ix) != ix + 1) {
+                printf("out(%d) = %d instead of %d\n", ix, out(ix), ix + 1);
+                return -1;
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -206,6 +206,30 @@ int main(int argc, char **argv) {
         return -1;
     }
 
+    // The x86 multitarget tiers should run from most to least capable,
+    // end with the base target, and skip tiers the base already covers.
+    std::vector<Target> tiers = get_x86_multitarget_tiers(Target("x86-64-linux"));
+    if (tiers.size() != 5 ||
+        !tiers[0].has_feature(Target::AVX512_SapphireRapids) ||
+        !tiers[1].has_feature(Target::AVX512_Skylake) ||
+        tiers[1].has_feature(Target::AVX512_Cannonlake) ||
+        !tiers[2].has_feature(Target::AVX2) ||
+        tiers[2].has_feature(Target::AVX512) ||
+        !tiers[3].has_feature(Target::SSE41) ||
+        tiers[3].has_feature(Target::AVX) ||
+        tiers.back() != Target("x86-64-linux")) {
+        printf("get_x86_multitarget_tiers failure\n");
+        return -1;
+    }
+    tiers = get_x86_multitarget_tiers(Target("x86-64-linux-sse41-avx-avx2-f16c-fma"));
+    if (tiers.size() != 3 ||
+        !tiers[0].has_feature(Target::AVX512_SapphireRapids) ||
+        !tiers[1].has_feature(Target::AVX512_Skylake) ||
+        tiers.back() != Target("x86-64-linux-sse41-avx-avx2-f16c-fma")) {
+        printf("get_x86_multitarget_tiers failure for avx2 base\n");
+        return -1;
+    }
+
     printf("Success!\n");
     return 0;
 }
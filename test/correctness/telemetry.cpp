@@ -0,0 +1,68 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+using namespace Halide::Internal;
+
+namespace {
+
+// Check that lowering with the telemetry feature brackets the
+// pipeline with a timestamp pair and tracks heap allocations.
+class CheckTelemetryCalls : public IRMutator {
+    using IRMutator::visit;
+
+    Expr visit(const Call *op) override {
+        if (op->name == "halide_telemetry_pipeline_start") {
+            found_start = true;
+        } else if (op->name == "halide_telemetry_pipeline_end") {
+            found_end = true;
+        } else if (op->name == "halide_telemetry_track_allocation") {
+            found_track = true;
+        }
+        return IRMutator::visit(op);
+    }
+
+public:
+    bool found_start = false, found_end = false, found_track = false;
+};
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    Var x("x"), y("y");
+
+    Func f("f"), g("g");
+    f(x, y) = x + y;
+    g(x, y) = f(x, y) * 2;
+
+    // Make f's allocation too large for the stack, so it is tracked.
+    f.compute_root();
+
+    CheckTelemetryCalls *checker = new CheckTelemetryCalls;
+    g.add_custom_lowering_pass(checker);
+
+    Target t = get_jit_target_from_environment().with_feature(Target::Telemetry);
+    Buffer<int> result = g.realize({1000, 1000}, t);
+
+    if (!checker->found_start || !checker->found_end) {
+        printf("The pipeline was not bracketed with telemetry timestamps\n");
+        return 1;
+    }
+    if (!checker->found_track) {
+        printf("The heap allocation was not tracked\n");
+        return 1;
+    }
+
+    for (int iy = 0; iy < 1000; iy++) {
+        for (int ix = 0; ix < 1000; ix++) {
+            if (result(ix, iy) != (ix + iy) * 2) {
+                printf("result(%d, %d) = %d instead of %d\n",
+                       ix, iy, result(ix, iy), (ix + iy) * 2);
+                return 1;
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
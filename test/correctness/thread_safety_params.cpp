@@ -0,0 +1,47 @@
+#include "Halide.h"
+#include <stdio.h>
+#include <thread>
+
+using namespace Halide;
+
+int main(int argc, char **argv) {
+    // Wasm JIT is substantially slower than others,
+    // so do fewer iterations to avoid timing out.
+    const bool is_wasm = get_jit_target_from_environment().arch == Target::WebAssembly;
+
+    // Hammer the per-call paths that many threads hit at once: Param
+    // construction/destruction (the object instance registry) and
+    // fetching the shared JIT runtime on each fresh compile. This test
+    // is intended to be run in a thread-sanitizer.
+
+    const int total_iters = is_wasm ? 256 : 1024;
+    constexpr int num_threads = 8;
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_threads; i++) {
+        threads.emplace_back([=] {
+            for (int i = 0; i < (total_iters / num_threads); i++) {
+                Param<int> p;
+                p.set(i);
+                Func f;
+                Var x;
+                f(x) = x + p;
+                Buffer<int> out = f.realize({16});
+                for (int j = 0; j < out.width(); j++) {
+                    if (out(j) != j + i) {
+                        fprintf(stderr, "out(%d) = %d instead of %d\n", j, out(j), j + i);
+                        exit(-1);
+                    }
+                }
+            }
+        });
+    }
+
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    printf("Success!\n");
+
+    return 0;
+}
@@ -0,0 +1,88 @@
+#include "Halide.h"
+#include "halide_test_dirs.h"
+
+#include <fstream>
+#include <set>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+using namespace Halide;
+
+int main(int argc, char **argv) {
+#ifdef _WIN32
+    printf("[SKIP] Windows does not have a working setenv\n");
+    return 0;
+#else
+    // Trace a parallel pipeline to a file using the buffered tracing
+    // mode, then check that the resulting packet stream is well-formed.
+    std::string trace_file = Internal::get_test_tmp_dir() + "tracing_buffered.trace";
+    Internal::ensure_no_file_exists(trace_file);
+
+    setenv("HL_TRACE_FILE", trace_file.c_str(), 1);
+    setenv("HL_TRACE_BUFFERED", "1", 1);
+
+    const int W = 64, H = 64;
+
+    Func f("f"), g("g");
+    Var x, y;
+    f(x, y) = x + y;
+    g(x, y) = f(x, y) + 1;
+
+    f.compute_root().parallel(y).trace_stores();
+    g.parallel(y).trace_stores();
+
+    g.realize({W, H});
+
+    // The end-of-pipeline event forces a full flush, so the file is
+    // complete once realize returns.
+    Internal::assert_file_exists(trace_file);
+    std::ifstream file(trace_file, std::ios::binary);
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)),
+                              std::istreambuf_iterator<char>());
+    file.close();
+
+    std::vector<const halide_trace_packet_t *> packets;
+    size_t off = 0;
+    while (off < data.size()) {
+        const halide_trace_packet_t *p = (const halide_trace_packet_t *)(data.data() + off);
+        assert(p->size >= sizeof(halide_trace_packet_t) &&
+               off + p->size <= data.size());
+        packets.push_back(p);
+        off += p->size;
+    }
+
+    assert(!packets.empty());
+    assert(packets.front()->event == halide_trace_begin_pipeline);
+    assert(packets.back()->event == halide_trace_end_pipeline);
+
+    // Every packet should have a fresh id, and refer to a parent that
+    // appeared earlier in the stream, despite the stores coming from
+    // many threads at once.
+    std::set<int32_t> ids;
+    int f_stores = 0, g_stores = 0;
+    for (const halide_trace_packet_t *p : packets) {
+        assert(ids.count(p->id) == 0);
+        if (p->event != halide_trace_begin_pipeline) {
+            assert(ids.count(p->parent_id) == 1);
+        }
+        ids.insert(p->id);
+        if (p->event == halide_trace_store) {
+            if (!strcmp(p->func(), "f")) {
+                f_stores++;
+            } else if (!strcmp(p->func(), "g")) {
+                g_stores++;
+            }
+        }
+    }
+
+    if (f_stores != W * H || g_stores != W * H) {
+        printf("Trace contained %d stores to f and %d stores to g instead of %d each\n",
+               f_stores, g_stores, W * H);
+        return 1;
+    }
+
+    printf("Success!\n");
+    return 0;
+#endif
+}
@@ -0,0 +1,79 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+using namespace Halide::Internal;
+
+namespace {
+
+// Verify that the strided loads of the transposed input were rewritten
+// into dense loads plus shuffles.
+class CheckTransposed : public IRMutator {
+    using IRMutator::visit;
+
+    Expr visit(const Load *op) override {
+        if (op->name == "input") {
+            if (const Ramp *ramp = op->index.as<Ramp>()) {
+                if (!is_const_one(ramp->stride)) {
+                    std::cerr << "Found a strided load of the input: " << Expr(op) << "\n";
+                    exit(1);
+                }
+            }
+        }
+        return IRMutator::visit(op);
+    }
+
+    Expr visit(const Shuffle *op) override {
+        if (op->vectors.size() == 8) {
+            found_transpose = true;
+        }
+        return IRMutator::visit(op);
+    }
+
+public:
+    bool found_transpose = false;
+};
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    const int size = 64;
+
+    ImageParam in(Int(32), 2, "input");
+    Var x("x"), y("y"), xi("xi"), yi("yi");
+
+    Func out("out");
+    out(x, y) = in(y, x);
+    out.transpose_tile(x, y, xi, yi, 8);
+
+    CheckTransposed *checker = new CheckTransposed;
+    out.add_custom_lowering_pass(checker);
+
+    Buffer<int> input(size, size);
+    for (int iy = 0; iy < size; iy++) {
+        for (int ix = 0; ix < size; ix++) {
+            input(ix, iy) = ix + iy * size;
+        }
+    }
+    in.set(input);
+
+    Buffer<int> result = out.realize({size, size});
+
+    if (!checker->found_transpose) {
+        printf("The strided loads were not rewritten into a shuffle transpose\n");
+        return 1;
+    }
+
+    for (int iy = 0; iy < size; iy++) {
+        for (int ix = 0; ix < size; ix++) {
+            if (result(ix, iy) != input(iy, ix)) {
+                printf("result(%d, %d) = %d instead of %d\n",
+                       ix, iy, result(ix, iy), input(iy, ix));
+                return 1;
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,71 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+
+int check(Buffer<int> out, int offset) {
+    for (int x = 0; x < out.width(); x++) {
+        int correct = 2 * x + offset;
+        if (out(x) != correct) {
+            printf("out(%d) = %d instead of %d\n", x, out(x), correct);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    Param<int> offset;
+    ImageParam input(Int(32), 1);
+
+    Var x;
+    Func g;
+    g(x) = input(x) * 2 + offset;
+
+    Buffer<int> in(64);
+    for (int i = 0; i < 64; i++) {
+        in(i) = i;
+    }
+    input.set(in);
+    offset.set(3);
+
+    Pipeline p(g);
+
+    Buffer<int> out(64);
+
+    // First call validates through the full checks.
+    p.trusted_realize(out);
+    if (check(out, 3)) {
+        return 1;
+    }
+
+    // Same shapes and values again: takes the unchecked fast path.
+    out.fill(0);
+    p.trusted_realize(out);
+    if (check(out, 3)) {
+        return 1;
+    }
+
+    // Changing a scalar parameter changes the signature, so this
+    // re-validates, then runs trusted again.
+    offset.set(7);
+    p.trusted_realize(out);
+    if (check(out, 7)) {
+        return 1;
+    }
+    out.fill(0);
+    p.trusted_realize(out);
+    if (check(out, 7)) {
+        return 1;
+    }
+
+    // A different output shape is a different signature.
+    Buffer<int> small(16);
+    p.trusted_realize(small);
+    if (check(small, 7)) {
+        return 1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,52 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+
+int main(int argc, char **argv) {
+    const int W = 130, H = 97;
+
+    Buffer<uint16_t> input(W + 2, H + 2);
+    for (int y = 0; y < input.height(); y++) {
+        for (int x = 0; x < input.width(); x++) {
+            input(x, y) = (uint16_t)(x * 3 + y * 5);
+        }
+    }
+
+    Var x("x"), y("y");
+
+    // A vertical stencil: adjacent rows share two of their three
+    // input taps, so jamming pairs of rows should reuse those loads.
+    Func f("f");
+    f(x, y) = cast<uint16_t>(input(x, y) + 2 * input(x, y + 1) + input(x, y + 2));
+    f.unroll_and_jam(y, 2);
+
+    Buffer<uint16_t> result = f.realize({W, H});
+
+    // The same thing vectorized, with an odd extent in y so the tail
+    // strategy gets exercised too.
+    Func g("g");
+    g(x, y) = cast<uint16_t>(input(x, y) + 2 * input(x, y + 1) + input(x, y + 2));
+    g.vectorize(x, 8).unroll_and_jam(y, 2);
+
+    Buffer<uint16_t> result2 = g.realize({W, H});
+
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            uint16_t correct = (uint16_t)(input(x, y) + 2 * input(x, y + 1) + input(x, y + 2));
+            if (result(x, y) != correct) {
+                printf("result(%d, %d) = %d instead of %d\n",
+                       x, y, result(x, y), correct);
+                return -1;
+            }
+            if (result2(x, y) != correct) {
+                printf("result2(%d, %d) = %d instead of %d\n",
+                       x, y, result2(x, y), correct);
+                return -1;
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,95 @@
+#include "Halide.h"
+
+using namespace Halide;
+
+int main(int argc, char **argv) {
+    // A pure definition with an extent that doesn't divide the vector
+    // width. With TailStrategy::Predicate there is no scalar cleanup
+    // loop; the guard becomes a predicate on the loads and stores
+    // (masked vector ops on architectures that support them,
+    // scalarized loads and stores otherwise).
+    {
+        Func f;
+        Var x, y;
+        f(x, y) = x * 3 + y * 7;
+
+        f.vectorize(x, 8, TailStrategy::Predicate);
+
+        Buffer<int> out = f.realize({37, 5});
+        out.for_each_element([&](int x, int y) {
+            int correct = x * 3 + y * 7;
+            if (out(x, y) != correct) {
+                printf("out(%d, %d) = %d instead of %d\n",
+                       x, y, out(x, y), correct);
+                exit(-1);
+            }
+        });
+    }
+
+    // Reading from an input of the same odd size. RoundUp would have
+    // constrained the input to be a multiple of the vector width;
+    // Predicate must not touch anything beyond it.
+    {
+        Buffer<int> in(37);
+        for (int i = 0; i < in.width(); i++) {
+            in(i) = i * i;
+        }
+
+        Func g;
+        Var x;
+        g(x) = in(x) * 2 + 1;
+        g.vectorize(x, 8, TailStrategy::Predicate);
+
+        Buffer<int> out = g.realize({37});
+        for (int i = 0; i < out.width(); i++) {
+            int correct = i * i * 2 + 1;
+            if (out(i) != correct) {
+                printf("out(%d) = %d instead of %d\n", i, out(i), correct);
+                return -1;
+            }
+        }
+    }
+
+    // Predicate is legal on update definitions, where ShiftInwards
+    // isn't and RoundUp would recompute values.
+    {
+        Func h;
+        Var x;
+        h(x) = x;
+        h(x) = h(x) * 2 + 3;
+        h.update().vectorize(x, 8, TailStrategy::Predicate);
+
+        Buffer<int> out = h.realize({37});
+        for (int i = 0; i < out.width(); i++) {
+            int correct = i * 2 + 3;
+            if (out(i) != correct) {
+                printf("out(%d) = %d instead of %d\n", i, out(i), correct);
+                return -1;
+            }
+        }
+    }
+
+    // Predicate is also legal for splitting RVars, which must not
+    // evaluate beyond their original extent.
+    {
+        Func h;
+        Var x;
+        RVar ro, ri;
+        h(x) = x;
+        RDom r(0, 37);
+        h(r) = h(r) * 2;
+        h.update().split(r, ro, ri, 8, TailStrategy::Predicate);
+
+        Buffer<int> out = h.realize({40});
+        for (int i = 0; i < out.width(); i++) {
+            int correct = i < 37 ? i * 2 : i;
+            if (out(i) != correct) {
+                printf("out(%d) = %d instead of %d\n", i, out(i), correct);
+                return -1;
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
@@ -0,0 +1,66 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+
+int main(int argc, char **argv) {
+    Target target = get_jit_target_from_environment();
+    if (!target.has_feature(Target::CUDA)) {
+        printf("[SKIP] CUDA not enabled\n");
+        return 0;
+    }
+
+    const int W = 256, H = 128;
+
+    Buffer<float> in(W, H);
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            in(x, y) = (float)(((x + 3) * (y + 7)) % 31) - 15.0f;
+        }
+    }
+
+    Var x;
+    RDom r(0, W);
+    RVar ri;
+
+    Func sums("sums");
+    sums(x) = 0.0f;
+    sums(x) += in(r, x);
+    sums.gpu_blocks(x);
+    sums.update()
+        .warp_reduce(r, ri)
+        .gpu_blocks(x);
+
+    Func maxes("maxes");
+    maxes(x) = in(0, x);
+    maxes(x) = max(maxes(x), in(r, x));
+    maxes.gpu_blocks(x);
+    maxes.update()
+        .warp_reduce(r, ri)
+        .gpu_blocks(x);
+
+    Buffer<float> sums_out = sums.realize({H});
+    Buffer<float> maxes_out = maxes.realize({H});
+
+    for (int y = 0; y < H; y++) {
+        float correct_sum = 0.0f;
+        float correct_max = in(0, y);
+        for (int k = 0; k < W; k++) {
+            correct_sum += in(k, y);
+            correct_max = std::max(correct_max, (float)in(k, y));
+        }
+        if (sums_out(y) != correct_sum) {
+            printf("sums(%d) = %f instead of %f\n",
+                   y, sums_out(y), correct_sum);
+            return 1;
+        }
+        if (maxes_out(y) != correct_max) {
+            printf("maxes(%d) = %f instead of %f\n",
+                   y, maxes_out(y), correct_max);
+            return 1;
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
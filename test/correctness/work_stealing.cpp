@@ -0,0 +1,116 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+
+namespace {
+
+// A fine-grained parallel loop, the case work stealing exists for.
+bool fine_grained() {
+    Var x, y;
+    Func f;
+    f(x, y) = x * 3 + y;
+
+    f.parallel(y);
+
+    Buffer<int> im = f.realize({128, 128});
+
+    for (int y = 0; y < 128; y++) {
+        for (int x = 0; x < 128; x++) {
+            if (im(x, y) != x * 3 + y) {
+                printf("im(%d, %d) = %d instead of %d\n", x, y, im(x, y), x * 3 + y);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Nested parallelism, so stolen iterations themselves enqueue work.
+bool nested() {
+    Var x, y, z;
+    Func f;
+
+    f(x, y, z) = x * y + z + 1;
+
+    f.parallel(x);
+    f.parallel(y);
+    f.parallel(z);
+
+    Buffer<int> im = f.realize({32, 32, 32});
+
+    for (int z = 0; z < 32; z++) {
+        for (int y = 0; y < 32; y++) {
+            for (int x = 0; x < 32; x++) {
+                if (im(x, y, z) != x * y + z + 1) {
+                    printf("im(%d, %d, %d) = %d instead of %d\n",
+                           x, y, z, im(x, y, z), x * y + z + 1);
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// A parallel producer computed inside a parallel consumer loop.
+bool nested_producer() {
+    Var x, y;
+    Func f, g;
+
+    f(x, y) = x + y;
+    g(x, y) = f(x, y) + f(x, y + 1);
+
+    g.parallel(y);
+    f.compute_at(g, y).parallel(x);
+
+    Buffer<int> im = g.realize({64, 64});
+
+    for (int y = 0; y < 64; y++) {
+        for (int x = 0; x < 64; x++) {
+            int correct = (x + y) + (x + y + 1);
+            if (im(x, y) != correct) {
+                printf("im(%d, %d) = %d instead of %d\n", x, y, im(x, y), correct);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool run_cases() {
+    return fine_grained() && nested() && nested_producer();
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    // Run the same pipelines with stealing off and in both stealing
+    // modes, and make sure the results don't change.
+    const int modes[] = {halide_work_stealing_off,
+                         halide_work_stealing_single,
+                         halide_work_stealing_guided};
+    for (int mode : modes) {
+        Internal::JITSharedRuntime::set_work_stealing(mode);
+        if (!run_cases()) {
+            printf("Failed with work stealing mode %d\n", mode);
+            return -1;
+        }
+    }
+
+    // Flipping the mode between invocations should also be safe.
+    int old = Internal::JITSharedRuntime::set_work_stealing(halide_work_stealing_guided);
+    if (old != halide_work_stealing_guided) {
+        printf("set_work_stealing returned %d instead of the previous mode %d\n",
+               old, halide_work_stealing_guided);
+        return -1;
+    }
+    Internal::JITSharedRuntime::set_work_stealing(halide_work_stealing_off);
+    if (!run_cases()) {
+        printf("Failed after disabling work stealing\n");
+        return -1;
+    }
+
+    printf("Success!\n");
+    return 0;
+}
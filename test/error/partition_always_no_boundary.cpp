@@ -0,0 +1,21 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+
+int main(int argc, char **argv) {
+    Var x;
+
+    Func f;
+    f(x) = x * 2;
+
+    // There are no boundary conditions here, so there's nothing for
+    // loop partitioning to simplify.
+    f.partition(x, Partition::Always);
+
+    // Should result in an error
+    Buffer<int> out = f.realize({64});
+
+    printf("Success!\n");
+    return 0;
+}
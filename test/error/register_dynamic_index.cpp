@@ -0,0 +1,25 @@
+#include "Halide.h"
+#include <stdio.h>
+
+using namespace Halide;
+
+int main(int argc, char **argv) {
+    Var x("x"), r("r");
+    Func f("f"), g("g");
+
+    f(x) = x;
+    RDom rd(0, 10);
+    f(x) += rd;
+    g(x) = f(x);
+
+    // The loops over the accumulator are not unrolled, so its
+    // accesses are at non-constant indices and it cannot be promoted
+    // to registers.
+    f.compute_at(g, x).store_in(MemoryType::Register).bound_extent(x, 4);
+    g.split(x, x, r, 4);
+
+    g.realize({16});
+
+    printf("Success!\n");
+    return 0;
+}
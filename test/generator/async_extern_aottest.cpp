@@ -0,0 +1,69 @@
+#include <atomic>
+#include <chrono>
+#include <stdio.h>
+#include <thread>
+
+#include "HalideBuffer.h"
+#include "HalideRuntime.h"
+
+#include "async_extern.h"
+
+using namespace Halide::Runtime;
+
+// Set once the extern stage's background work has actually filled the
+// output, so we can check the consumer didn't run early.
+std::atomic<bool> work_done{false};
+
+extern "C" int async_extern_source(halide_buffer_t *out, halide_semaphore_t *completion) {
+    if (out->is_bounds_query()) {
+        // Bounds queries are always synchronous and get a null
+        // completion semaphore.
+        assert(completion == nullptr);
+        return 0;
+    }
+
+    assert(completion != nullptr);
+
+    // Initiate the work on another thread and return immediately. The
+    // consumer waits on the completion semaphore via the task system,
+    // without occupying a worker thread.
+    Buffer<int32_t> out_buf(*out);
+    std::thread([=]() mutable {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        out_buf.for_each_element([&](int x, int y) {
+            out_buf(x, y) = x + y;
+        });
+        work_done = true;
+        halide_semaphore_release(completion, 1);
+    }).detach();
+
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    Buffer<int32_t> out(64, 64);
+
+    int result = async_extern(out);
+    if (result != 0) {
+        printf("Pipeline returned non-zero: %d\n", result);
+        return 1;
+    }
+
+    if (!work_done) {
+        printf("Consumer ran before the extern stage finished its work\n");
+        return 1;
+    }
+
+    for (int y = 0; y < out.height(); y++) {
+        for (int x = 0; x < out.width(); x++) {
+            int correct = (x + y) * 2 + 1;
+            if (out(x, y) != correct) {
+                printf("out(%d, %d) = %d instead of %d\n", x, y, out(x, y), correct);
+                return 1;
+            }
+        }
+    }
+
+    printf("Success!\n");
+    return 0;
+}
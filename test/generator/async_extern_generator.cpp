@@ -0,0 +1,25 @@
+#include "Halide.h"
+
+using namespace Halide;
+
+class AsyncExtern : public Generator<AsyncExtern> {
+public:
+    // An extern stage that follows the asynchronous extern protocol: it
+    // may return after merely initiating its work, and signals a
+    // completion semaphore once the output is actually written.
+
+    Output<Func> output{"output", Int(32), 2};
+
+    void generate() {
+        Func source{"source"};
+        source.define_extern("async_extern_source", {}, Int(32), 2);
+        source.async_extern();
+
+        Var x, y;
+        output(x, y) = source(x, y) * 2 + 1;
+
+        source.compute_root().async();
+    }
+};
+
+HALIDE_REGISTER_GENERATOR(AsyncExtern, async_extern)
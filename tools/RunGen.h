@@ -5,6 +5,7 @@
 
 #include <cstdio>
 #include <cstdlib>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <map>
@@ -895,6 +896,128 @@ struct ArgData {
     }
 };
 
+// A prepared, reusable invocation of an AOT filter. The filter
+// metadata is resolved once, at construction: argument names are
+// mapped to argv slots and argument kinds are checked when bound
+// rather than on every call, so a steady-state invocation is just
+// pointer swaps plus the call itself. Useful when embedding RunGen
+// for benchmarking at high call rates, where the per-call parsing
+// and validation that RunGen::run does would dominate.
+class PreparedCall {
+public:
+    using ArgvCall = int (*)(void **);
+
+    PreparedCall(ArgvCall halide_argv_call,
+                 const struct halide_filter_metadata_t *halide_metadata)
+        : halide_argv_call(halide_argv_call), md(halide_metadata),
+          argv((size_t)halide_metadata->num_arguments, nullptr) {
+        if (md->version != halide_filter_metadata_t::VERSION) {
+            fail() << "Unexpected metadata version " << md->version;
+        }
+        for (size_t i = 0; i < (size_t)md->num_arguments; ++i) {
+            slots[md->arguments[i].name] = (int)i;
+        }
+    }
+
+    /** The argv slot for the named argument, or -1 if there is no
+     * such argument. Useful for callers that want to rebind by index
+     * in their hot loop. */
+    int slot(const std::string &name) const {
+        auto it = slots.find(name);
+        return it == slots.end() ? -1 : it->second;
+    }
+
+    /** Bind a buffer argument by name. The pointer is captured, not
+     * copied, so the caller can mutate the buffer contents between
+     * calls; rebinding is just a pointer swap. */
+    PreparedCall &bind(const std::string &name, halide_buffer_t *buf) {
+        const halide_filter_argument_t &a = arg_for(name);
+        if (a.kind != halide_argument_kind_input_buffer &&
+            a.kind != halide_argument_kind_output_buffer) {
+            fail() << "Argument is not a buffer: " << name;
+        }
+        argv[slots[name]] = buf;
+        return *this;
+    }
+
+    /** Bind a scalar argument by name. As with buffers, the pointer
+     * is captured, so the caller can change the value between calls. */
+    PreparedCall &bind(const std::string &name, const halide_scalar_value_t *scalar) {
+        const halide_filter_argument_t &a = arg_for(name);
+        if (a.kind != halide_argument_kind_input_scalar) {
+            fail() << "Argument is not an input scalar: " << name;
+        }
+        argv[slots[name]] = const_cast<halide_scalar_value_t *>(scalar);
+        return *this;
+    }
+
+    /** Rebind a slot directly, with no name lookup or kind check.
+     * The slot index comes from slot(). */
+    void rebind(int slot, void *arg) {
+        argv[(size_t)slot] = arg;
+    }
+
+    /** Invoke the filter once. All arguments must be bound. */
+    int call() {
+        check_all_bound();
+        return halide_argv_call(argv.data());
+    }
+
+    /** Invoke the filter `iterations` times, appending each call's
+     * wall time in seconds to *times_per_call (if non-null), so
+     * per-call latency distributions can be collected rather than
+     * just a best-case time. Stops at the first nonzero result. Uses
+     * the same clock as the benchmarking support in
+     * halide_benchmark.h. As with any wall-clock timing of GPU
+     * pipelines, time to synchronize with the device is not
+     * included unless the pipeline itself syncs. */
+    int call_batch(int iterations, std::vector<double> *times_per_call = nullptr) {
+        check_all_bound();
+        if (times_per_call) {
+            times_per_call->reserve(times_per_call->size() + iterations);
+        }
+        for (int i = 0; i < iterations; i++) {
+            auto start = Halide::Tools::benchmark_now();
+            int result = halide_argv_call(argv.data());
+            auto end = Halide::Tools::benchmark_now();
+            if (result != 0) {
+                return result;
+            }
+            if (times_per_call) {
+                times_per_call->push_back(Halide::Tools::benchmark_duration_seconds(start, end));
+            }
+        }
+        return 0;
+    }
+
+private:
+    const halide_filter_argument_t &arg_for(const std::string &name) {
+        auto it = slots.find(name);
+        if (it == slots.end()) {
+            fail() << "Unknown argument: " << name;
+        }
+        return md->arguments[it->second];
+    }
+
+    void check_all_bound() {
+        if (all_bound) {
+            return;
+        }
+        for (size_t i = 0; i < argv.size(); i++) {
+            if (argv[i] == nullptr) {
+                fail() << "Argument is not bound: " << md->arguments[i].name;
+            }
+        }
+        all_bound = true;
+    }
+
+    ArgvCall halide_argv_call;
+    const struct halide_filter_metadata_t *md;
+    std::vector<void *> argv;
+    std::map<std::string, int> slots;
+    bool all_bound = false;
+};
+
 class RunGen {
 public:
     using ArgvCall = int (*)(void **);
@@ -1223,6 +1346,20 @@ public:
         return bytes_out;
     }
 
+    uint64_t bytes_in() const {
+        uint64_t bytes_in = 0;
+        for (const auto &arg_pair : args) {
+            const auto &arg = arg_pair.second;
+            switch (arg.metadata->kind) {
+            case halide_argument_kind_input_buffer: {
+                bytes_in += arg.buffer_value.number_of_elements() * arg.buffer_value.type().bytes();
+                break;
+            }
+            }
+        }
+        return bytes_in;
+    }
+
     // Run a bounds-query call with the given args, and return the shapes
     // to which we are constrained.
     std::vector<Shape> run_bounds_query() const {
@@ -1280,7 +1417,8 @@ public:
         }
     }
 
-    void run_for_benchmark(double benchmark_min_time) {
+    void run_for_benchmark(double benchmark_min_time,
+                           const std::string &benchmark_json = "") {
         std::vector<void *> filter_argv = build_filter_argv();
 
         const auto benchmark_inner = [this, &filter_argv]() {
@@ -1312,6 +1450,30 @@ public:
                   << md->name << "  THROUGHPUT_MPIX_PER_SEC  " << (megapixels_out() / result.wall_time) << "\n"
                   << md->name << "  HALIDE_TARGET            " << md->target << "\n";
         }
+
+        if (!benchmark_json.empty()) {
+            // Emit a machine-readable record of this run, for
+            // automated performance tracking. The bandwidth reported
+            // is the input bytes read plus the output bytes written
+            // per iteration over the best wall time; intermediate
+            // traffic isn't visible from here.
+            const double bandwidth_gbyte_per_sec =
+                (double)(bytes_in() + bytes_out()) / result.wall_time / 1e9;
+            std::ofstream f(benchmark_json);
+            if (!f) {
+                fail() << "Unable to open file for writing: " << benchmark_json;
+            }
+            f << "{\n"
+              << "  \"name\": \"" << md->name << "\",\n"
+              << "  \"target\": \"" << md->target << "\",\n"
+              << "  \"best_time_msec_per_iter\": " << result.wall_time * 1000.0 << ",\n"
+              << "  \"throughput_mpix_per_sec\": " << (megapixels_out() / result.wall_time) << ",\n"
+              << "  \"bandwidth_gbyte_per_sec\": " << bandwidth_gbyte_per_sec << ",\n"
+              << "  \"samples\": " << result.samples << ",\n"
+              << "  \"iterations\": " << result.iterations << ",\n"
+              << "  \"accuracy\": " << result.accuracy << "\n"
+              << "}\n";
+        }
     }
 
     struct Output {
@@ -139,6 +139,11 @@ Flags:
         Override the default minimum desired benchmarking time; ignored if
         --benchmarks is not also specified.
 
+    --benchmark_json=FILENAME:
+        Write the benchmark results to the given file as a JSON object
+        (name, target, best time, throughput, bandwidth), in addition to
+        the usual output; ignored if --benchmarks is not also specified.
+
     --track_memory:
         Override Halide memory allocator to track high-water mark of memory
         allocation during run; note that this may slow down execution, so
@@ -381,6 +386,7 @@ int main(int argc, char **argv) {
     std::string default_input_buffers;
     std::string default_input_scalars;
     std::string benchmarks_flag_value;
+    std::string benchmark_json;
     for (int i = 1; i < argc; ++i) {
         if (argv[i][0] == '-') {
             const char *p = argv[i] + 1;  // skip -
@@ -441,6 +447,11 @@ int main(int argc, char **argv) {
                 if (!parse_scalar(flag_value, &benchmark_min_time)) {
                     fail() << "Invalid value for flag: " << flag_name;
                 }
+            } else if (flag_name == "benchmark_json") {
+                benchmark_json = flag_value;
+                if (benchmark_json.empty()) {
+                    fail() << "--benchmark_json requires a filename";
+                }
             } else if (flag_name == "default_input_buffers") {
                 default_input_buffers = flag_value;
                 if (default_input_buffers.empty()) {
@@ -519,7 +530,7 @@ int main(int argc, char **argv) {
         if (benchmarks_flag_value != "all") {
             fail() << "The only valid value for --benchmarks is 'all'";
         }
-        r.run_for_benchmark(benchmark_min_time);
+        r.run_for_benchmark(benchmark_min_time, benchmark_json);
     } else {
         r.run_for_output();
     }
@@ -4,8 +4,23 @@
 #include <algorithm>
 #include <cassert>
 #include <chrono>
+#include <cmath>
 #include <functional>
 #include <limits>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 #if defined(__EMSCRIPTEN__)
 #include <emscripten.h>
@@ -64,6 +79,110 @@ inline double benchmark_duration_seconds(double start, double end) {
 
 #endif
 
+// A raw cycle-count-style clock for the precision benchmark mode below.
+// On x86 this reads the TSC, fenced so that it can't drift past the
+// work being timed; on AArch64 (clang) it reads the virtual counter
+// after an ISB. Elsewhere it falls back to steady_clock nanoseconds.
+// All paths avoid inline assembly by using compiler intrinsics.
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+inline uint64_t benchmark_ticks_now() {
+    // lfence orders rdtsc with respect to surrounding loads without
+    // the heavy serialization cost of cpuid.
+    _mm_lfence();
+    uint64_t t = __rdtsc();
+    _mm_lfence();
+    return t;
+}
+#elif defined(__aarch64__) && defined(__clang__)
+inline uint64_t benchmark_ticks_now() {
+    __builtin_arm_isb(0xf);
+    // Lowers to a read of CNTVCT_EL0.
+    return __builtin_readcyclecounter();
+}
+#else
+inline uint64_t benchmark_ticks_now() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+#endif
+
+// Ticks-per-second for benchmark_ticks_now(), calibrated once against
+// the wall clock. The TSC and the ARM virtual counter tick at a fixed
+// rate independent of the current CPU frequency on all hardware we
+// care about, so a single calibration is sufficient.
+inline double benchmark_ticks_per_second() {
+    static const double ticks_per_second = []() {
+        auto c0 = benchmark_now();
+        uint64_t t0 = benchmark_ticks_now();
+        while (benchmark_duration_seconds(c0, benchmark_now()) < 0.01) {
+            // Spin; sleeping here could migrate us or drop the clock.
+        }
+        uint64_t t1 = benchmark_ticks_now();
+        auto c1 = benchmark_now();
+        return (double)(t1 - t0) / benchmark_duration_seconds(c0, c1);
+    }();
+    return ticks_per_second;
+}
+
+// The fastest observed back-to-back pair of timer reads. Subtracting
+// this from every measurement removes the constant part of the timing
+// overhead itself.
+inline uint64_t benchmark_timer_overhead_ticks() {
+    static const uint64_t overhead_ticks = []() {
+        uint64_t best = std::numeric_limits<uint64_t>::max();
+        for (int i = 0; i < 1000; i++) {
+            uint64_t t0 = benchmark_ticks_now();
+            uint64_t t1 = benchmark_ticks_now();
+            best = std::min(best, t1 - t0);
+        }
+        return best;
+    }();
+    return overhead_ticks;
+}
+
+// Pin the calling thread to the given logical core so that the
+// benchmark isn't migrated mid-measurement. Currently implemented for
+// Linux only; returns false (and does nothing) elsewhere.
+inline bool benchmark_pin_thread(int core) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)core;
+    return false;
+#endif
+}
+
+// Run op untimed before measurement begins. This warms caches and
+// branch predictors, and gives the frequency governor time to ramp
+// the core up to its steady benchmarking frequency. Returns early
+// once per-op times settle (two consecutive runs agreeing to within
+// 10%, after a minimum of 5ms), or after max_seconds, whichever
+// comes first.
+inline void benchmark_warmup(const std::function<void()> &op, double max_seconds) {
+    if (max_seconds <= 0) {
+        return;
+    }
+    constexpr double min_seconds = 0.005;
+    auto start = benchmark_now();
+    double prev = std::numeric_limits<double>::infinity();
+    do {
+        auto t0 = benchmark_now();
+        op();
+        auto t1 = benchmark_now();
+        double t = benchmark_duration_seconds(t0, t1);
+        if (benchmark_duration_seconds(start, t1) >= min_seconds &&
+            t > prev * 0.9 && t < prev * 1.1) {
+            // The clock has settled.
+            break;
+        }
+        prev = t;
+    } while (benchmark_duration_seconds(start, benchmark_now()) < max_seconds);
+}
+
 // Benchmark the operation 'op'. The number of iterations refers to
 // how many times the operation is run for each time measurement, the
 // result is the minimum over a number of samples runs. The result is the
@@ -127,6 +246,24 @@ struct BenchmarkConfig {
     // this. Controls accuracy. The closer to zero this gets the more
     // reliable the answer, but the longer it may take to run.
     double accuracy{0.03};
+
+    // Use the precision measurement mode: time with a fenced cycle
+    // counter instead of std::chrono, subtract the measured timer
+    // overhead, and report the median of per-batch minima along with a
+    // confidence interval. Slower to converge than the default mode,
+    // but stable enough to gate on small (<2%) regressions.
+    bool precision{false};
+
+    // If non-negative, pin the benchmarking thread to this logical
+    // core before measuring (Linux only; ignored elsewhere). Applies
+    // in both the default and precision modes.
+    int pin_core{-1};
+
+    // Maximum time (in seconds) to spend running the op untimed
+    // before measurement begins, to warm caches and let the CPU
+    // frequency settle. Warm-up ends early once per-op times
+    // stabilize; see benchmark_warmup above. Set to zero to disable.
+    double warmup_time{0.025};
 };
 
 struct BenchmarkResult {
@@ -145,14 +282,105 @@ struct BenchmarkResult {
 
     // Measured accuracy between the best and third-best result.
     // Will be <= config.accuracy unless max_time is exceeded.
+    // In precision mode, this is confidence_interval / wall_time.
     double accuracy;
 
+    // Half-width of a ~95% confidence interval on wall_time (seconds).
+    // Only filled in by the precision mode; zero otherwise.
+    double confidence_interval{0};
+
     operator double() const {
         return wall_time;
     }
 };
 
+// The precision measurement mode. Times batches of iterations with the
+// fenced cycle counter, subtracts the measured timer overhead, and
+// reports the median of per-batch minima: the min discards transient
+// interference within a batch, and the median discards whole batches
+// perturbed by systematic effects like thermal throttling. The
+// confidence interval on the median is derived from the interquartile
+// range of the batch minima.
+inline BenchmarkResult benchmark_precision(const std::function<void()> &op, const BenchmarkConfig &config) {
+    BenchmarkResult result{0, 0, 0};
+
+    const double min_time = std::max(10 * 1e-6, config.min_time);
+    const double max_time = std::max(config.min_time, config.max_time);
+    const double ticks_per_second = benchmark_ticks_per_second();
+    const uint64_t overhead = benchmark_timer_overhead_ticks();
+
+    auto time_unit_seconds = [&](uint64_t iters) {
+        uint64_t t0 = benchmark_ticks_now();
+        for (uint64_t j = 0; j < iters; j++) {
+            op();
+        }
+        uint64_t t1 = benchmark_ticks_now();
+        uint64_t ticks = (t1 - t0 > overhead) ? (t1 - t0 - overhead) : 0;
+        return (double)ticks / ticks_per_second;
+    };
+
+    // Grow the number of iterations per timed unit until a unit is long
+    // enough to dwarf the timer overhead and its quantization. This
+    // also serves as warm-up.
+    uint64_t iters_per_unit = 1;
+    for (;;) {
+        double unit_seconds = time_unit_seconds(iters_per_unit);
+        result.iterations += iters_per_unit;
+        if ((unit_seconds * ticks_per_second >= (double)overhead * 100 &&
+             unit_seconds >= min_time / 64) ||
+            iters_per_unit >= kBenchmarkMaxIterations) {
+            break;
+        }
+        iters_per_unit *= 2;
+    }
+
+    constexpr int kUnitsPerBatch = 8;
+    constexpr int kMinBatches = 15;
+    constexpr int kMaxBatches = 129;
+    std::vector<double> batch_mins;
+    double total_time = 0;
+    while ((int)batch_mins.size() < kMaxBatches) {
+        double best = std::numeric_limits<double>::infinity();
+        for (int u = 0; u < kUnitsPerBatch; u++) {
+            double unit_seconds = time_unit_seconds(iters_per_unit);
+            best = std::min(best, unit_seconds / iters_per_unit);
+            result.iterations += iters_per_unit;
+            total_time += unit_seconds;
+        }
+        result.samples++;
+        batch_mins.push_back(best);
+        if ((int)batch_mins.size() >= kMinBatches && total_time >= min_time) {
+            break;
+        }
+        if ((int)batch_mins.size() >= 3 && total_time >= max_time) {
+            break;
+        }
+    }
+
+    std::sort(batch_mins.begin(), batch_mins.end());
+    const size_t n = batch_mins.size();
+    const double median = (n & 1) ?
+                              batch_mins[n / 2] :
+                              (batch_mins[n / 2 - 1] + batch_mins[n / 2]) / 2;
+    // Standard notch-style interval on a median: 1.58 * IQR / sqrt(n).
+    const double iqr = batch_mins[(3 * n) / 4] - batch_mins[n / 4];
+    const double ci = 1.58 * iqr / std::sqrt((double)n);
+
+    result.wall_time = median;
+    result.confidence_interval = ci;
+    result.accuracy = (median > 0) ? ci / median : 0;
+    return result;
+}
+
 inline BenchmarkResult benchmark(const std::function<void()> &op, const BenchmarkConfig &config = {}) {
+    if (config.pin_core >= 0) {
+        benchmark_pin_thread(config.pin_core);
+    }
+    benchmark_warmup(op, config.warmup_time);
+    if (config.precision) {
+        return benchmark_precision(op, config);
+    }
+
     BenchmarkResult result{0, 0, 0};
 
     const double min_time = std::max(10 * 1e-6, config.min_time);
@@ -11,10 +11,12 @@
 #include <cstddef>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <functional>
 #include <map>
 #include <set>
 #include <string>
+#include <thread>
 #include <vector>
 
 #ifndef HALIDE_NO_PNG
@@ -607,6 +609,56 @@ inline std::string get_lowercase_extension(const std::string &path) {
     return to_lowercase(path.substr(last_dot + 1));
 }
 
+// The number of threads used for the embarrassingly-parallel parts of
+// decode, encode, and pixel-format conversion. Overridable with the
+// HL_IMAGE_IO_THREADS environment variable; set it to 1 to force
+// everything back to single-threaded.
+inline int image_io_threads() {
+    static const int threads = []() {
+        if (const char *s = getenv("HL_IMAGE_IO_THREADS")) {
+            const int n = atoi(s);
+            if (n > 0) {
+                return n;
+            }
+        }
+        const int n = (int)std::thread::hardware_concurrency();
+        return n > 0 ? n : 1;
+    }();
+    return threads;
+}
+
+// Run task(begin, end) over a partition of [begin, end) into contiguous
+// chunks, one per thread. grain is the smallest chunk worth handing to
+// its own thread; ranges at or below it just run on the calling thread.
+template<typename Task>
+void parallel_for_chunked(int64_t begin, int64_t end, int64_t grain, Task &&task) {
+    const int64_t extent = end - begin;
+    const int64_t chunks = std::min<int64_t>(image_io_threads(),
+                                             std::max<int64_t>(1, extent / std::max<int64_t>(1, grain)));
+    if (chunks <= 1) {
+        if (extent > 0) {
+            task(begin, end);
+        }
+        return;
+    }
+    std::vector<std::thread> workers;
+    workers.reserve((size_t)chunks - 1);
+    int64_t chunk_begin = begin;
+    for (int64_t i = 0; i < chunks; i++) {
+        const int64_t chunk_end = chunk_begin + (extent / chunks) + (i < (extent % chunks) ? 1 : 0);
+        if (i == chunks - 1) {
+            // Run the last chunk on the calling thread.
+            task(chunk_begin, chunk_end);
+        } else {
+            workers.emplace_back([&task, chunk_begin, chunk_end]() { task(chunk_begin, chunk_end); });
+        }
+        chunk_begin = chunk_end;
+    }
+    for (auto &w : workers) {
+        w.join();
+    }
+}
+
 template<typename ElemType>
 ElemType read_big_endian(const uint8_t *src);
 
@@ -805,13 +857,24 @@ bool load_png(const std::string &filename, ImageType *im) {
                              Internal::read_big_endian_row<uint8_t, ImageType> :
                              Internal::read_big_endian_row<uint16_t, ImageType>;
 
-    std::vector<uint8_t> row(png_get_rowbytes(png_ptr, info_ptr));
-    const int ymin = im->dim(1).min();
-    const int ymax = im->dim(1).max();
-    for (int y = ymin; y <= ymax; ++y) {
-        png_read_row(png_ptr, row.data(), nullptr);
-        copy_to_image(row.data(), y, im);
+    // The decode itself is serialized by libpng (each row's filter
+    // depends on the previous row), but the big-endian-to-buffer
+    // conversion isn't, so read the whole image first and convert the
+    // rows in parallel.
+    const size_t row_bytes = png_get_rowbytes(png_ptr, info_ptr);
+    std::vector<uint8_t> data(row_bytes * height);
+    std::vector<png_bytep> row_pointers(height);
+    for (int i = 0; i < height; i++) {
+        row_pointers[i] = data.data() + i * row_bytes;
     }
+    png_read_image(png_ptr, row_pointers.data());
+
+    const int ymin = im->dim(1).min();
+    Internal::parallel_for_chunked(0, height, 64, [&](int64_t begin, int64_t end) {
+        for (int64_t y = begin; y < end; y++) {
+            copy_to_image(data.data() + y * row_bytes, ymin + (int)y, im);
+        }
+    });
 
     png_destroy_read_struct(&png_ptr, &info_ptr, nullptr);
 
@@ -886,13 +949,23 @@ bool save_png(ImageType &im, const std::string &filename) {
                                Internal::write_big_endian_row<uint8_t, ImageType> :
                                Internal::write_big_endian_row<uint16_t, ImageType>;
 
-    std::vector<uint8_t> row(png_get_rowbytes(png_ptr, info_ptr));
+    // Convert all the rows to big-endian in parallel, then hand the
+    // whole image to libpng (whose filtering and compression are
+    // inherently serial).
+    const size_t row_bytes = png_get_rowbytes(png_ptr, info_ptr);
+    std::vector<uint8_t> data(row_bytes * height);
     const int ymin = im.dim(1).min();
-    const int ymax = im.dim(1).max();
-    for (int y = ymin; y <= ymax; ++y) {
-        copy_from_image(im, y, row.data());
-        png_write_row(png_ptr, row.data());
+    Internal::parallel_for_chunked(0, height, 64, [&](int64_t begin, int64_t end) {
+        for (int64_t y = begin; y < end; y++) {
+            copy_from_image(im, ymin + (int)y, data.data() + y * row_bytes);
+        }
+    });
+
+    std::vector<png_bytep> row_pointers(height);
+    for (int i = 0; i < height; i++) {
+        row_pointers[i] = data.data() + i * row_bytes;
     }
+    png_write_image(png_ptr, row_pointers.data());
     png_write_end(png_ptr, nullptr);
     png_destroy_write_struct(&png_ptr, &info_ptr);
 
@@ -959,15 +1032,20 @@ bool load_pnm(const std::string &filename, int channels, ImageType *im) {
                              Internal::read_big_endian_row<uint8_t, ImageType> :
                              Internal::read_big_endian_row<uint16_t, ImageType>;
 
-    std::vector<uint8_t> row(width * channels * (bit_depth / 8));
+    // Slurp the whole payload in one read, then convert the rows to
+    // host byte order in parallel.
+    const size_t row_bytes = (size_t)width * channels * (bit_depth / 8);
+    std::vector<uint8_t> data(row_bytes * height);
+    if (!check(f.read_vector(&data), "Could not read data")) {
+        return false;
+    }
+
     const int ymin = im->dim(1).min();
-    const int ymax = im->dim(1).max();
-    for (int y = ymin; y <= ymax; ++y) {
-        if (!check(f.read_vector(&row), "Could not read data")) {
-            return false;
+    Internal::parallel_for_chunked(0, height, 64, [&](int64_t begin, int64_t end) {
+        for (int64_t y = begin; y < end; y++) {
+            copy_to_image(data.data() + y * row_bytes, ymin + (int)y, im);
         }
-        copy_to_image(row.data(), y, im);
-    }
+    });
 
     return true;
 }
@@ -998,14 +1076,18 @@ bool save_pnm(ImageType &im, const int channels, const std::string &filename) {
                                Internal::write_big_endian_row<uint8_t, ImageType> :
                                Internal::write_big_endian_row<uint16_t, ImageType>;
 
-    std::vector<uint8_t> row(width * channels * (bit_depth / 8));
+    // Convert the rows to big-endian in parallel, then write the whole
+    // payload in one go.
+    const size_t row_bytes = (size_t)width * channels * (bit_depth / 8);
+    std::vector<uint8_t> data(row_bytes * height);
     const int ymin = im.dim(1).min();
-    const int ymax = im.dim(1).max();
-    for (int y = ymin; y <= ymax; ++y) {
-        copy_from_image(im, y, row.data());
-        if (!check(f.write_vector(row), "Could not write data")) {
-            return false;
+    Internal::parallel_for_chunked(0, height, 64, [&](int64_t begin, int64_t end) {
+        for (int64_t y = begin; y < end; y++) {
+            copy_from_image(im, ymin + (int)y, data.data() + y * row_bytes);
         }
+    });
+    if (!check(f.write_vector(data), "Could not write data")) {
+        return false;
     }
 
     return true;
@@ -1680,6 +1762,240 @@ bool save_mat(ImageType &im, const std::string &filename) {
     return true;
 }
 
+// ".npy" is the NumPy array format, version 1.0, documented here:
+// https://numpy.org/doc/stable/reference/generated/numpy.lib.format.html
+// Like .mat and .tmp it stores a raw, densely-packed payload after a
+// short header, so loading and saving it is a single bulk copy with no
+// per-sample conversion -- a good choice for benchmark loops where
+// speed matters more than compression or portability.
+
+inline std::string halide_type_to_npy_descr(const halide_type_t &t) {
+    char code;
+    switch (t.code) {
+    case halide_type_int:
+        code = 'i';
+        break;
+    case halide_type_uint:
+        code = 'u';
+        break;
+    case halide_type_float:
+        code = 'f';
+        break;
+    default:
+        return "";
+    }
+    if (t.bits < 8 || (t.code == halide_type_float && t.bits < 32)) {
+        // bool, float16 and bfloat16 are not supported.
+        return "";
+    }
+    const int bytes = t.bits / 8;
+    std::string descr = (bytes == 1) ? "|" : "<";
+    descr += code;
+    descr += std::to_string(bytes);
+    return descr;
+}
+
+inline halide_type_t npy_descr_to_halide_type(const std::string &descr) {
+    const halide_type_t bad(halide_type_int, 0);
+    if (descr.size() < 3 || (descr[0] != '<' && descr[0] != '|')) {
+        // Only little-endian (or byte-order-free) payloads are supported.
+        return bad;
+    }
+    halide_type_code_t code;
+    switch (descr[1]) {
+    case 'i':
+        code = halide_type_int;
+        break;
+    case 'u':
+        code = halide_type_uint;
+        break;
+    case 'f':
+        code = halide_type_float;
+        break;
+    default:
+        return bad;
+    }
+    const int bytes = atoi(descr.c_str() + 2);
+    if (bytes != 1 && bytes != 2 && bytes != 4 && bytes != 8) {
+        return bad;
+    }
+    if (code == halide_type_float && bytes < 4) {
+        return bad;
+    }
+    return halide_type_t(code, bytes * 8);
+}
+
+template<typename ImageType, CheckFunc check = CheckReturn>
+bool load_npy(const std::string &filename, ImageType *im) {
+    static_assert(!ImageType::has_static_halide_type, "");
+
+    FileOpener f(filename, "rb");
+    if (!check(f.f != nullptr, "File could not be opened for reading")) {
+        return false;
+    }
+
+    uint8_t magic[8];
+    if (!check(f.read_array(magic), "Could not read .npy header")) {
+        return false;
+    }
+    const uint8_t expected[6] = {0x93, 'N', 'U', 'M', 'P', 'Y'};
+    if (!check(memcmp(magic, expected, 6) == 0, "File is not recognized as a .npy file")) {
+        return false;
+    }
+    if (!check(magic[6] == 1, "Only version 1.x .npy files are supported")) {
+        return false;
+    }
+
+    uint8_t len_bytes[2];
+    if (!check(f.read_array(len_bytes), "Could not read .npy header")) {
+        return false;
+    }
+    const uint16_t header_len = (uint16_t)(len_bytes[0] | (len_bytes[1] << 8));
+    std::string header(header_len, 0);
+    if (!check(f.read_bytes(&header[0], header_len), "Could not read .npy header")) {
+        return false;
+    }
+
+    const size_t descr_key = header.find("'descr':");
+    const size_t order_key = header.find("'fortran_order':");
+    const size_t shape_key = header.find("'shape':");
+    if (!check(descr_key != std::string::npos &&
+                   order_key != std::string::npos &&
+                   shape_key != std::string::npos,
+               "Could not parse this .npy file: bad header")) {
+        return false;
+    }
+
+    const size_t descr_open = header.find('\'', descr_key + 8);
+    const size_t descr_close = (descr_open == std::string::npos) ?
+                                   std::string::npos :
+                                   header.find('\'', descr_open + 1);
+    if (!check(descr_close != std::string::npos, "Could not parse this .npy file: bad descr")) {
+        return false;
+    }
+    const halide_type_t type =
+        npy_descr_to_halide_type(header.substr(descr_open + 1, descr_close - descr_open - 1));
+    if (!check(type.bits != 0, "Could not parse this .npy file: unsupported descr")) {
+        return false;
+    }
+
+    const size_t order_end = std::min(header.find(',', order_key), header.size());
+    const bool fortran_order =
+        header.substr(order_key, order_end - order_key).find("True") != std::string::npos;
+
+    const size_t paren_open = header.find('(', shape_key);
+    const size_t paren_close = (paren_open == std::string::npos) ?
+                                   std::string::npos :
+                                   header.find(')', paren_open);
+    if (!check(paren_close != std::string::npos, "Could not parse this .npy file: bad shape")) {
+        return false;
+    }
+    std::vector<int> extents;
+    for (size_t pos = paren_open + 1; pos < paren_close;) {
+        if (!isdigit(header[pos])) {
+            pos++;
+            continue;
+        }
+        int v = 0;
+        while (pos < paren_close && isdigit(header[pos])) {
+            v = v * 10 + (header[pos] - '0');
+            pos++;
+        }
+        extents.push_back(v);
+    }
+    if (!fortran_order) {
+        // NumPy's C order lists the slowest-varying dimension first;
+        // our dimension 0 is the fastest-varying.
+        std::reverse(extents.begin(), extents.end());
+    }
+
+    *im = ImageType(type, extents);
+
+    // This should never fail unless the default Buffer<> constructor behavior changes.
+    if (!check(buffer_is_compact_planar(*im), "load_npy() requires compact planar images")) {
+        return false;
+    }
+
+    if (!check(f.read_bytes(im->begin(), im->size_in_bytes()), "Could not read .npy payload")) {
+        return false;
+    }
+
+    im->set_host_dirty();
+    return true;
+}
+
+inline const std::set<FormatInfo> &query_npy() {
+    // NPY files can have any number of dimensions, including zero.
+    // Our support arbitrarily stops at 16 dimensions.
+    static std::set<FormatInfo> info = []() {
+        std::set<FormatInfo> s;
+        for (int i = 0; i <= 16; i++) {
+            s.insert({halide_type_t(halide_type_float, 32), i});
+            s.insert({halide_type_t(halide_type_float, 64), i});
+            s.insert({halide_type_t(halide_type_uint, 8), i});
+            s.insert({halide_type_t(halide_type_int, 8), i});
+            s.insert({halide_type_t(halide_type_uint, 16), i});
+            s.insert({halide_type_t(halide_type_int, 16), i});
+            s.insert({halide_type_t(halide_type_uint, 32), i});
+            s.insert({halide_type_t(halide_type_int, 32), i});
+            s.insert({halide_type_t(halide_type_uint, 64), i});
+            s.insert({halide_type_t(halide_type_int, 64), i});
+        }
+        return s;
+    }();
+    return info;
+}
+
+template<typename ImageType, CheckFunc check = CheckReturn>
+bool save_npy(ImageType &im, const std::string &filename) {
+    static_assert(!ImageType::has_static_halide_type, "");
+
+    im.copy_to_host();
+
+    const std::string descr = halide_type_to_npy_descr(im.type());
+    if (!check(!descr.empty(), "Unsupported type for .npy file")) {
+        return false;
+    }
+
+    std::string dict = "{'descr': '" + descr + "', 'fortran_order': False, 'shape': (";
+    for (int d = im.dimensions() - 1; d >= 0; d--) {
+        dict += std::to_string(im.dim(d).extent());
+        if (d > 0) {
+            dict += ", ";
+        }
+    }
+    if (im.dimensions() == 1) {
+        dict += ",";
+    }
+    dict += "), }";
+
+    // Pad the header with spaces so the payload starts at a multiple
+    // of 64 bytes, which makes it friendly to alignment-sensitive
+    // consumers (including mmap-based ones).
+    const size_t unpadded = 10 + dict.size() + 1;
+    dict.append(((unpadded + 63) & ~(size_t)63) - unpadded, ' ');
+    dict += '\n';
+    if (!check((dict.size() >> 16) == 0, "Too many dimensions to save as .npy")) {
+        return false;
+    }
+
+    FileOpener f(filename, "wb");
+    if (!check(f.f != nullptr, "File could not be opened for writing")) {
+        return false;
+    }
+
+    const uint8_t magic[8] = {0x93, 'N', 'U', 'M', 'P', 'Y', 1, 0};
+    const uint8_t len_bytes[2] = {(uint8_t)(dict.size() & 0xff), (uint8_t)(dict.size() >> 8)};
+    if (!check(f.write_array(magic) &&
+                   f.write_array(len_bytes) &&
+                   f.write_bytes(dict.data(), dict.size()),
+               "Could not write .npy header")) {
+        return false;
+    }
+
+    return write_planar_payload<ImageType, check>(im, f);
+}
+
 template<typename ImageType, Internal::CheckFunc check = Internal::CheckReturn>
 bool load_tiff(const std::string &filename, ImageType *im) {
     static_assert(!ImageType::has_static_halide_type, "");
@@ -1992,6 +2308,7 @@ bool find_imageio(const std::string &filename, ImageIO<ImageType, check> *result
         {"ppm", {load_ppm<ImageType, check>, save_ppm<ConstImageType, check>, query_ppm}},
         {"tmp", {load_tmp<ImageType, check>, save_tmp<ConstImageType, check>, query_tmp}},
         {"mat", {load_mat<ImageType, check>, save_mat<ConstImageType, check>, query_mat}},
+        {"npy", {load_npy<ImageType, check>, save_npy<ConstImageType, check>, query_npy}},
         {"tiff", {load_tiff<ImageType, check>, save_tiff<ConstImageType, check>, query_tiff}},
     };
     std::string ext = Internal::get_lowercase_extension(filename);
@@ -2067,7 +2384,34 @@ struct ImageTypeConversion {
         const auto converter = [](DstElemType &dst_elem, SrcElemType src_elem) {
             dst_elem = Internal::convert<DstElemType>(src_elem);
         };
-        dst.for_each_value(converter, src);
+        if (Internal::buffer_is_compact_planar(src) && Internal::buffer_is_compact_planar(dst)) {
+            // Both sides are dense with the same memory nesting order
+            // (make_with_shape_of preserves it), so this is just a flat
+            // loop over contiguous memory: easy for the compiler to
+            // vectorize, and easy to split across threads.
+            const SrcElemType *src_data = src.data();
+            DstElemType *dst_data = dst.data();
+            Internal::parallel_for_chunked(
+                0, (int64_t)src.number_of_elements(), 1 << 16,
+                [&](int64_t begin, int64_t end) {
+                    for (int64_t i = begin; i < end; i++) {
+                        dst_data[i] = Internal::convert<DstElemType>(src_data[i]);
+                    }
+                });
+        } else if (src.dimensions() > 0) {
+            // Oddly-strided images: parallelize across strips of the
+            // outermost dimension.
+            const int d = src.dimensions() - 1;
+            Internal::parallel_for_chunked(
+                src.dim(d).min(), src.dim(d).min() + src.dim(d).extent(), 1,
+                [&](int64_t begin, int64_t end) {
+                    auto src_strip = src.cropped(d, (int)begin, (int)(end - begin));
+                    auto dst_strip = dst.cropped(d, (int)begin, (int)(end - begin));
+                    dst_strip.for_each_value(converter, src_strip);
+                });
+        } else {
+            dst.for_each_value(converter, src);
+        }
         dst.set_host_dirty();
 
         return dst;